@@ -88,6 +88,7 @@ struct timer
 
 static struct timer g_periodic_timer;
 static struct net_driver_s g_sim_dev;
+static struct netdev_napi_s g_sim_napi;
 
 /****************************************************************************
  * Private Functions
@@ -160,17 +161,17 @@ static int sim_txpoll(struct net_driver_s *dev)
   return 0;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-void netdriver_loop(void)
+static int sim_rxpoll(struct net_driver_s *dev)
 {
- struct eth_hdr_s *eth;
+  struct eth_hdr_s *eth;
 
   /* netdev_read will return 0 on a timeout event and >0 on a data received event */
 
   g_sim_dev.d_len = netdev_read((unsigned char*)g_sim_dev.d_buf, CONFIG_NET_ETH_MTU);
+  if (g_sim_dev.d_len == 0)
+    {
+      return 0;
+    }
 
   /* Disable preemption through to the following so that it behaves a little more
    * like an interrupt (otherwise, the following logic gets pre-empted an behaves
@@ -178,139 +179,161 @@ void netdriver_loop(void)
    */
 
   sched_lock();
-  if (g_sim_dev.d_len > 0)
-    {
-      /* Data received event.  Check for valid Ethernet header with destination == our
-       * MAC address
-       */
 
-      eth = BUF;
-      if (g_sim_dev.d_len > ETH_HDRLEN &&
-          up_comparemac(eth->dest, &g_sim_dev.d_mac) == 0)
-        {
+  /* Data received event.  Check for valid Ethernet header with destination == our
+   * MAC address
+   */
+
+  eth = BUF;
+  if (g_sim_dev.d_len > ETH_HDRLEN &&
+      up_comparemac(eth->dest, &g_sim_dev.d_mac) == 0)
+    {
 #ifdef CONFIG_NET_PKT
-          /* When packet sockets are enabled, feed the frame into the packet
-           * tap.
-           */
+      /* When packet sockets are enabled, feed the frame into the packet
+       * tap.
+       */
 
-          pkt_input(&g_sim_dev);
+      pkt_input(&g_sim_dev);
 #endif
 
-          /* We only accept IP packets of the configured type and ARP packets */
+      /* We only accept IP packets of the configured type and ARP packets */
 
 #ifdef CONFIG_NET_IPv4
-          if (eth->type == HTONS(ETHTYPE_IP))
-            {
-              nllvdbg("IPv4 frame\n");
+      if (eth->type == HTONS(ETHTYPE_IP))
+        {
+          nllvdbg("IPv4 frame\n");
 
-              /* Handle ARP on input then give the IPv4 packet to the network
-               * layer
-               */
+          /* Handle ARP on input then give the IPv4 packet to the network
+           * layer
+           */
 
-              arp_ipin(&g_sim_dev);
-              ipv4_input(&g_sim_dev);
+          arp_ipin(&g_sim_dev);
+          ipv4_input(&g_sim_dev);
 
-             /* If the above function invocation resulted in data that
-              * should be sent out on the network, the global variable
-              * d_len is set to a value > 0.
-              */
+         /* If the above function invocation resulted in data that
+          * should be sent out on the network, the global variable
+          * d_len is set to a value > 0.
+          */
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  /* Update the Ethernet header with the correct MAC address */
+          if (g_sim_dev.d_len > 0)
+            {
+              /* Update the Ethernet header with the correct MAC address */
 
 #ifdef CONFIG_NET_IPv6
-                  if (IFF_IS_IPv4(g_sim_dev.d_flags))
+              if (IFF_IS_IPv4(g_sim_dev.d_flags))
 #endif
-                    {
-                      arp_out(&g_sim_dev);
-                    }
+                {
+                  arp_out(&g_sim_dev);
+                }
 #ifdef CONFIG_NET_IPv6
-                  else
-                    {
-                      neighbor_out(&g_sim_dev);
-                    }
+              else
+                {
+                  neighbor_out(&g_sim_dev);
+                }
 #endif
 
-                  /* And send the packet */
+              /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-          else
+        }
+      else
 #endif
 #ifdef CONFIG_NET_IPv6
-          if (eth->type == HTONS(ETHTYPE_IP6))
-            {
-              nllvdbg("Iv6 frame\n");
+      if (eth->type == HTONS(ETHTYPE_IP6))
+        {
+          nllvdbg("Iv6 frame\n");
 
-              /* Give the IPv6 packet to the network layer */
+          /* Give the IPv6 packet to the network layer */
 
-              ipv6_input(&g_sim_dev);
+          ipv6_input(&g_sim_dev);
 
-             /* If the above function invocation resulted in data that
-              * should be sent out on the network, the global variable
-              * d_len is set to a value > 0.
-              */
+         /* If the above function invocation resulted in data that
+          * should be sent out on the network, the global variable
+          * d_len is set to a value > 0.
+          */
 
-              if (g_sim_dev.d_len > 0)
-               {
-                  /* Update the Ethernet header with the correct MAC address */
+          if (g_sim_dev.d_len > 0)
+           {
+              /* Update the Ethernet header with the correct MAC address */
 
 #ifdef CONFIG_NET_IPv4
-                  if (IFF_IS_IPv4(g_sim_dev.d_flags))
-                    {
-                      arp_out(&g_sim_dev);
-                    }
-                  else
+              if (IFF_IS_IPv4(g_sim_dev.d_flags))
+                {
+                  arp_out(&g_sim_dev);
+                }
+              else
 #endif
 #ifdef CONFIG_NET_IPv6
-                    {
-                      neighbor_out(&g_sim_dev);
-                    }
+                {
+                  neighbor_out(&g_sim_dev);
+                }
 #endif
 
-                  /* And send the packet */
+              /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-          else
+        }
+      else
 #endif
 #ifdef CONFIG_NET_ARP
-          if (eth->type == htons(ETHTYPE_ARP))
-            {
-              arp_arpin(&g_sim_dev);
+      if (eth->type == htons(ETHTYPE_ARP))
+        {
+          arp_arpin(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+          if (g_sim_dev.d_len > 0)
+            {
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-#endif
         }
+#endif
     }
 
-  /* Otherwise, it must be a timeout event */
+  sched_unlock();
+  return 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-  else if (timer_expired(&g_periodic_timer))
+void netdriver_loop(void)
+{
+  /* Receive packets up to the receive budget.  Under a heavy load, this
+   * returns to the idle loop after the budget has been used up so that
+   * timer processing is not starved.
+   */
+
+  netdev_napi_begin(&g_sim_napi);
+  (void)netdev_napi_poll(&g_sim_dev, &g_sim_napi, sim_rxpoll);
+  (void)netdev_napi_complete(&g_sim_napi);
+
+  /* Check for the periodic timer event, even if packets are still being
+   * received.
+   */
+
+  if (timer_expired(&g_periodic_timer))
     {
+      sched_lock();
       timer_reset(&g_periodic_timer);
       devif_timer(&g_sim_dev, sim_txpoll, 1);
+      sched_unlock();
     }
-  sched_unlock();
 }
 
+
 int netdriver_init(void)
 {
   /* Internal initalization */
 
   timer_set(&g_periodic_timer, 500);
+  netdev_napi_initialize(&g_sim_napi, CONFIG_NETDEV_NAPI_BUDGET);
   netdev_init();
 
   /* Register the device with the OS so that socket IOCTLs can be performed */
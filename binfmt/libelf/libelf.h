@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <elf32.h>
 
 #include <nuttx/arch.h>
@@ -137,6 +138,20 @@ int elf_findsection(FAR struct elf_loadinfo_s *loadinfo,
 
 int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_hasrelocs
+ *
+ * Description:
+ *   Check if the module has any relocations that apply to an allocated
+ *   section.  A module without them is pre-linked.
+ *
+ * Returned Value:
+ *   True if there are relocations to be performed.
+ *
+ ****************************************************************************/
+
+bool elf_hasrelocs(FAR struct elf_loadinfo_s *loadinfo);
+
 /****************************************************************************
  * Name: elf_readsym
  *
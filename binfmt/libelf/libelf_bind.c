@@ -46,6 +46,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -67,6 +68,14 @@
 #  define CONFIG_ELF_BUFFERSIZE 128
 #endif
 
+#ifndef CONFIG_ELF_RELOCATION_BUFFERCOUNT
+#  define CONFIG_ELF_RELOCATION_BUFFERCOUNT 32
+#endif
+
+#ifndef MIN
+#  define MIN(x,y) ((x) < (y) ? (x) : (y))
+#endif
+
 #ifdef CONFIG_ELF_DUMPBUFFER
 # define elf_dumpbuffer(m,b,n) bvdbgdumpbuffer(m,b,n)
 #else
@@ -86,34 +95,37 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: elf_readrel
+ * Name: elf_readrels
  *
  * Description:
- *   Read the ELF32_Rel structure into memory.
+ *   Read 'nrels' consecutive ELF32_Rel structures into memory beginning
+ *   with the relocation at 'index'.
  *
  ****************************************************************************/
 
-static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
-                              FAR const Elf32_Shdr *relsec,
-                              int index, FAR Elf32_Rel *rel)
+static inline int elf_readrels(FAR struct elf_loadinfo_s *loadinfo,
+                               FAR const Elf32_Shdr *relsec,
+                               int index, FAR Elf32_Rel *rels, int nrels)
 {
   off_t offset;
 
-  /* Verify that the symbol table index lies within symbol table */
+  /* Verify that the relocation entries lie within relocation table */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  if (index < 0 || nrels < 1 ||
+      index + nrels > (relsec->sh_size / sizeof(Elf32_Rel)))
     {
-      bdbg("Bad relocation symbol index: %d\n", index);
+      bdbg("Bad relocation index: %d+%d\n", index, nrels);
       return -EINVAL;
     }
 
-  /* Get the file offset to the symbol table entry */
+  /* Get the file offset to the first relocation entry */
 
   offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
 
-  /* And, finally, read the symbol table entry into memory */
+  /* And, finally, read the relocation entries into memory */
 
-  return elf_read(loadinfo, (FAR uint8_t*)rel, sizeof(Elf32_Rel), offset);
+  return elf_read(loadinfo, (FAR uint8_t*)rels, sizeof(Elf32_Rel) * nrels,
+                  offset);
 }
 
 /****************************************************************************
@@ -134,38 +146,67 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
+  FAR Elf32_Rel  *rels;
+  FAR Elf32_Rel  *rel;
   Elf32_Sym       sym;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
   int             symidx;
-  int             ret;
+  int             nrels;
+  int             nbuffered;
+  int             ret = OK;
   int             i;
 
+  /* Relocation entries are read from the file in blocks of up to
+   * CONFIG_ELF_RELOCATION_BUFFERCOUNT entries rather than one at a time.
+   */
+
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  if (nrels < 1)
+    {
+      return OK;
+    }
+
+  nbuffered = MIN(nrels, CONFIG_ELF_RELOCATION_BUFFERCOUNT);
+  rels = (FAR Elf32_Rel *)kmm_malloc(nbuffered * sizeof(Elf32_Rel));
+  if (!rels)
+    {
+      bdbg("Section %d: Failed to allocate relocation buffer\n", relidx);
+      return -ENOMEM;
+    }
+
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  for (i = 0; i < nrels; i++)
     {
       psym = &sym;
 
-      /* Read the relocation entry into memory */
+      /* Read the next block of relocation entries into memory if we have
+       * used all of the buffered entries.
+       */
 
-      ret = elf_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if ((i % nbuffered) == 0)
         {
-          bdbg("Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          ret = elf_readrels(loadinfo, relsec, i, rels,
+                             MIN(nbuffered, nrels - i));
+          if (ret < 0)
+            {
+              bdbg("Section %d reloc %d: Failed to read relocation entries: %d\n",
+                   relidx, i, ret);
+              break;
+            }
         }
 
+      rel = &rels[i % nbuffered];
+
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
+      symidx = ELF32_R_SYM(rel->r_info);
 
       /* Read the symbol table entry into memory */
 
@@ -174,7 +215,7 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
         {
           bdbg("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
                relidx, i, symidx, ret);
-          return ret;
+          break;
         }
 
       /* Get the value of the symbol (in sym.st_value) */
@@ -202,32 +243,34 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
             {
               bdbg("Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
                   relidx, i, symidx, ret);
-              return ret;
+              break;
             }
         }
 
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           bdbg("Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
-          return -EINVAL;
+               relidx, i, rel->r_offset, dstsec->sh_size);
+          ret = -EINVAL;
+          break;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           bdbg("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
-          return ret;
+          break;
         }
     }
 
-  return OK;
+  kmm_free(rels);
+  return ret;
 }
 
 static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
@@ -260,26 +303,39 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
 #ifdef CONFIG_ARCH_ADDRENV
   int status;
 #endif
-  int ret;
+  int ret = OK;
   int i;
 
-  /* Find the symbol and string tables */
+  /* A pre-linked module has already been relocated and its relocation
+   * sections removed.  There is nothing to bind and such a module need not
+   * even have a symbol table.  elf_load() has already verified that it is
+   * running at the address that it was linked for.
+   */
 
-  ret = elf_findsymtab(loadinfo);
-  if (ret < 0)
+  if (elf_hasrelocs(loadinfo))
     {
-      return ret;
-    }
+      /* Find the symbol and string tables */
 
-  /* Allocate an I/O buffer.  This buffer is used by elf_symname() to
-   * accumulate the variable length symbol name.
-   */
+      ret = elf_findsymtab(loadinfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
-  ret = elf_allocbuffer(loadinfo);
-  if (ret < 0)
+      /* Allocate an I/O buffer.  This buffer is used by elf_symname() to
+       * accumulate the variable length symbol name.
+       */
+
+      ret = elf_allocbuffer(loadinfo);
+      if (ret < 0)
+        {
+          bdbg("elf_allocbuffer failed: %d\n", ret);
+          return -ENOMEM;
+        }
+    }
+  else
     {
-      bdbg("elf_allocbuffer failed: %d\n", ret);
-      return -ENOMEM;
+      bvdbg("No relocations: Module is pre-linked\n");
     }
 
 #ifdef CONFIG_ARCH_ADDRENV
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -140,6 +141,10 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
  *   Read the section data into memory. Section addresses in the shdr[] are
  *   updated to point to the corresponding position in the memory.
  *
+ *   A pre-linked module (one with no relocations) cannot be moved.  Its
+ *   sections must either have a zero link address (position independent
+ *   code) or be loaded at exactly the address that they were linked for.
+ *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
  *   failure.
@@ -151,9 +156,26 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
   FAR uint8_t *text;
   FAR uint8_t *data;
   FAR uint8_t **pptr;
+  FAR uint8_t **rdregion; /* Region (text or data) of the pending read */
+  FAR uint8_t *rdbuffer;  /* Start of the pending read in memory */
+  size_t rdsize;          /* Size of the pending read */
+  off_t rdoffset;         /* File offset of the pending read */
+  bool prelinked;
   int ret;
   int i;
 
+  /* Sections that are adjacent both in the file and in memory are read
+   * with a single elf_read() call.  'rdregion', 'rdbuffer', 'rdsize', and
+   * 'rdoffset' describe the read that has been accumulated so far.
+   */
+
+  rdregion = NULL;
+  rdbuffer = NULL;
+  rdsize   = 0;
+  rdoffset = 0;
+
+  prelinked = !elf_hasrelocs(loadinfo);
+
   /* Read each section into memory that is marked SHF_ALLOC + SHT_NOBITS */
 
   bvdbg("Loaded sections:\n");
@@ -191,25 +213,73 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
 
       if (shdr->sh_type != SHT_NOBITS)
         {
-          /* Read the section data from sh_offset to the memory region */
+          /* Can this section be added to the pending read?  It can if it
+           * goes into the same region and the gap before it in memory (the
+           * alignment padding) matches the gap before it in the file.
+           */
 
-          ret = elf_read(loadinfo, *pptr, shdr->sh_size, shdr->sh_offset);
-          if (ret < 0)
+          if (rdsize > 0 && pptr == rdregion &&
+              shdr->sh_offset == rdoffset + (*pptr - rdbuffer))
             {
-              bdbg("ERROR: Failed to read section %d: %d\n", i, ret);
-              return ret;
+              rdsize = (*pptr - rdbuffer) + shdr->sh_size;
+            }
+          else
+            {
+              /* No.. Read the pending data and start a new read */
+
+              if (rdsize > 0)
+                {
+                  ret = elf_read(loadinfo, rdbuffer, rdsize, rdoffset);
+                  if (ret < 0)
+                    {
+                      bdbg("ERROR: Failed to read sections before %d: %d\n",
+                           i, ret);
+                      return ret;
+                    }
+                }
+
+              rdregion = pptr;
+              rdbuffer = *pptr;
+              rdsize   = shdr->sh_size;
+              rdoffset = shdr->sh_offset;
             }
         }
 
       /* If there is no data in an allocated section, then the allocated
-       * section must be cleared.
+       * section must be cleared.  A later section must not be merged with
+       * the pending read across the cleared region.
        */
 
       else
         {
+          if (rdsize > 0)
+            {
+              ret = elf_read(loadinfo, rdbuffer, rdsize, rdoffset);
+              if (ret < 0)
+                {
+                  bdbg("ERROR: Failed to read sections before %d: %d\n",
+                       i, ret);
+                  return ret;
+                }
+
+              rdsize = 0;
+            }
+
           memset(*pptr, 0, shdr->sh_size);
         }
 
+      /* Nothing will fix up a pre-linked section that is not at its link
+       * address.
+       */
+
+      if (prelinked && shdr->sh_addr != 0 &&
+          shdr->sh_addr != (uintptr_t)*pptr)
+        {
+          bdbg("ERROR: Section %d linked at %08lx but loaded at %08lx\n",
+               i, (unsigned long)shdr->sh_addr, (unsigned long)*pptr);
+          return -ENOEXEC;
+        }
+
       /* Update sh_addr to point to copy in memory */
 
       bvdbg("%d. %08lx->%08lx\n", i,
@@ -222,6 +292,18 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
       *pptr += ELF_ALIGNUP(shdr->sh_size);
     }
 
+  /* Read any remaining section data */
+
+  if (rdsize > 0)
+    {
+      ret = elf_read(loadinfo, rdbuffer, rdsize, rdoffset);
+      if (ret < 0)
+        {
+          bdbg("ERROR: Failed to read sections: %d\n", ret);
+          return ret;
+        }
+    }
+
   return OK;
 }
 
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -283,3 +284,31 @@ int elf_findsection(FAR struct elf_loadinfo_s *loadinfo,
 
   return -ENOENT;
 }
+
+/****************************************************************************
+ * Name: elf_hasrelocs
+ *
+ * Description:
+ *   Return true if the module has any relocation section that applies to
+ *   an allocated section.
+ *
+ ****************************************************************************/
+
+bool elf_hasrelocs(FAR struct elf_loadinfo_s *loadinfo)
+{
+  int i;
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf32_Shdr *shdr = &loadinfo->shdr[i];
+
+      if ((shdr->sh_type == SHT_REL || shdr->sh_type == SHT_RELA) &&
+          shdr->sh_info < loadinfo->ehdr.e_shnum &&
+          (loadinfo->shdr[shdr->sh_info].sh_flags & SHF_ALLOC) != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
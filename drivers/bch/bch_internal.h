@@ -55,21 +55,49 @@
 #define bchlib_semgive(d) sem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
 
+/* Number of sectors held in the sector cache */
+
+#ifndef CONFIG_BCH_NCACHE
+#  define CONFIG_BCH_NCACHE 1
+#endif
+
+/* Read-ahead fills the whole cache and is pointless with only one sector */
+
+#if CONFIG_BCH_NCACHE < 2
+#  undef CONFIG_BCH_READAHEAD
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One sector in the sector cache */
+
+struct bch_sector_s
+{
+  size_t   sector;     /* The sector in the buffer ((size_t)-1 if none) */
+  uint32_t lastuse;    /* Value of the access counter when last used */
+  bool     dirty;      /* Data has been written to the buffer */
+  FAR uint8_t *buffer; /* One sector buffer */
+};
+
 struct bchlib_s
 {
   struct inode *inode; /* I-node of the block driver */
   sem_t    sem;        /* For atomic accesses to this structure */
   size_t   nsectors;   /* Number of sectors supported by the device */
-  size_t   sector;     /* The current sector in the buffer */
+#ifdef CONFIG_BCH_READAHEAD
+  size_t   nextsector; /* The sector following the last sector read */
+#endif
+  uint32_t usecount;   /* Cache access counter (for LRU replacement) */
   uint16_t sectsize;   /* The size of one sector on the device */
   uint8_t  refs;       /* Number of references */
-  bool  dirty;         /* Data has been written to the buffer */
   bool  readonly;      /* true:  Only read operations are supported */
-  FAR uint8_t *buffer; /* One sector buffer */
+  FAR uint8_t *buffer; /* CONFIG_BCH_NCACHE contiguous sector buffers */
+
+  /* The sector cache */
+
+  struct bch_sector_s cache[CONFIG_BCH_NCACHE];
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t   key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];   /* Encryption key */
@@ -95,8 +123,13 @@ EXTERN const struct file_operations bch_fops;
  ****************************************************************************/
 
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_flushcache(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                              FAR struct bch_sector_s **cached);
+EXTERN int  bchlib_newsector(FAR struct bchlib_s *bch, size_t sector,
+                             FAR struct bch_sector_s **cached);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
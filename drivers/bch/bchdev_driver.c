@@ -149,7 +149,7 @@ static int bch_close(FAR struct file *filep)
   /* Flush any dirty pages remaining in the cache */
 
   bchlib_semtake(bch);
-  (void)bchlib_flushsector(bch);
+  (void)bchlib_flushcache(bch);
 
   /* Decrement the reference count (I don't use bchlib_decref() because I
    * want the entire close operation to be atomic wrt other driver operations.
@@ -88,16 +88,17 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch,
+                      FAR struct bch_sector_s *cached, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  uint32_t *buffer = (uint32_t*)bch->buffer;
+  uint32_t *buffer = (uint32_t*)cached->buffer;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
     {
       uint32_t T[4];
-      uint32_t X[4] = {bch->sector, 0, 0, i};
+      uint32_t X[4] = {cached->sector, 0, 0, i};
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
                  AES_MODE_ECB, CYPHER_ENCRYPT);
@@ -115,21 +116,18 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bchlib_flushentry
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the contents of one cached sector (if dirty)
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bchlib_flushentry(FAR struct bchlib_s *bch,
+                             FAR struct bch_sector_s *cached)
 {
   FAR struct inode *inode;
   ssize_t ret = OK;
@@ -138,22 +136,22 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
    * media.
    */
 
-  if (bch->dirty)
+  if (cached->dirty)
     {
       inode = bch->inode;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, cached, CYPHER_ENCRYPT);
 #endif
 
       /* Write the sector to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode, cached->buffer, cached->sector, 1);
       if (ret < 0)
         {
-          fdbg("Write failed: %d\n");
+          fdbg("Write failed: %d\n", ret);
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -161,50 +159,286 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, cached, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
 
-      bch->dirty = false;
+      cached->dirty = false;
     }
 
   return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_findsector
+ *
+ * Description:
+ *   Return the cache entry holding 'sector' or NULL if it is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct bch_sector_s *bchlib_findsector(FAR struct bchlib_s *bch,
+                                                  size_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NCACHE; i++)
+    {
+      if (bch->cache[i].sector == sector)
+        {
+          return &bch->cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bchlib_victim
+ *
+ * Description:
+ *   Select a cache entry to be re-used:  An unused entry if there is one,
+ *   otherwise the least recently used entry, which is flushed if dirty.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+static FAR struct bch_sector_s *bchlib_victim(FAR struct bchlib_s *bch)
+{
+  FAR struct bch_sector_s *victim = &bch->cache[0];
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NCACHE; i++)
+    {
+      if (bch->cache[i].sector == (size_t)-1)
+        {
+          return &bch->cache[i];
+        }
+
+      if ((int32_t)(bch->cache[i].lastuse - victim->lastuse) < 0)
+        {
+          victim = &bch->cache[i];
+        }
+    }
+
+  (void)bchlib_flushentry(bch, victim);
+  victim->sector = (size_t)-1;
+  return victim;
+}
+
+/****************************************************************************
+ * Name: bchlib_readahead
+ *
+ * Description:
+ *   Flush the whole cache and re-fill it with the sectors beginning at
+ *   'sector' using a single read from the block driver.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_READAHEAD
+static int bchlib_readahead(FAR struct bchlib_s *bch, size_t sector)
+{
+  FAR struct inode *inode = bch->inode;
+  size_t nsectors;
+  ssize_t ret;
+  int i;
+
+  nsectors = bch->nsectors - sector;
+  if (nsectors > CONFIG_BCH_NCACHE)
+    {
+      nsectors = CONFIG_BCH_NCACHE;
+    }
+
+  (void)bchlib_flushcache(bch);
+  for (i = 0; i < CONFIG_BCH_NCACHE; i++)
+    {
+      bch->cache[i].sector = (size_t)-1;
+    }
+
+  /* The sector buffers are contiguous in the order of the cache entries */
+
+  ret = inode->u.i_bops->read(inode, bch->buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      fdbg("Read failed: %d\n", ret);
+      return (int)ret;
+    }
+
+  for (i = 0; i < nsectors; i++)
+    {
+      bch->cache[i].sector  = sector + i;
+      bch->cache[i].lastuse = bch->usecount;
+#if defined(CONFIG_BCH_ENCRYPTION)
+      bch_cypher(bch, &bch->cache[i], CYPHER_DECRYPT);
+#endif
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_flushcache
+ *
+ * Description:
+ *   Flush the current contents of the sector cache (if dirty)
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushcache(FAR struct bchlib_s *bch)
+{
+  int ret = OK;
+  int tmp;
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NCACHE; i++)
+    {
+      tmp = bchlib_flushentry(bch, &bch->cache[i]);
+      if (tmp < 0 && ret == OK)
+        {
+          ret = tmp;
+        }
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that the sector is in the cache, reading it from the media
+ *   if necessary, and return the cache entry that holds it.  If the
+ *   sector immediately follows the last sector read, the cache is re-
+ *   filled with as many following sectors as it will hold.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                      FAR struct bch_sector_s **cached)
 {
+  FAR struct bch_sector_s *entry;
   FAR struct inode *inode;
   ssize_t ret = OK;
+#ifdef CONFIG_BCH_READAHEAD
+  bool sequential;
+
+  sequential      = (sector == bch->nextsector);
+  bch->nextsector = sector + 1;
+#endif
+
+  bch->usecount++;
 
-  if (bch->sector != sector)
+  entry = bchlib_findsector(bch, sector);
+  if (!entry)
     {
-      inode = bch->inode;
+#ifdef CONFIG_BCH_READAHEAD
+      if (sequential)
+        {
+          ret = bchlib_readahead(bch, sector);
+          if (ret < 0)
+            {
+              return (int)ret;
+            }
+
+          *cached = &bch->cache[0];
+          return OK;
+        }
+#endif
 
-      (void)bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+      inode = bch->inode;
+      entry = bchlib_victim(bch);
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      ret = inode->u.i_bops->read(inode, entry->buffer, sector, 1);
       if (ret < 0)
         {
-          fdbg("Read failed: %d\n");
+          fdbg("Read failed: %d\n", ret);
+          return (int)ret;
         }
-      bch->sector = sector;
+
+      entry->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, entry, CYPHER_DECRYPT);
 #endif
     }
-  return (int)ret;
+
+  entry->lastuse = bch->usecount;
+  *cached = entry;
+  return OK;
 }
 
+/****************************************************************************
+ * Name: bchlib_newsector
+ *
+ * Description:
+ *   Return a cache entry for a sector that will be completely overwritten.
+ *   The sector is not read from the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_newsector(FAR struct bchlib_s *bch, size_t sector,
+                     FAR struct bch_sector_s **cached)
+{
+  FAR struct bch_sector_s *entry;
+
+  bch->usecount++;
+
+  entry = bchlib_findsector(bch, sector);
+  if (!entry)
+    {
+      entry = bchlib_victim(bch);
+      entry->sector = sector;
+    }
+
+  entry->lastuse = bch->usecount;
+  *cached = entry;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Discard any cached copies of the sectors in the range.  This is
+ *   necessary when the sectors are written directly to the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NCACHE; i++)
+    {
+      if (bch->cache[i].sector != (size_t)-1 &&
+          bch->cache[i].sector >= sector &&
+          bch->cache[i].sector < sector + nsectors)
+        {
+          bch->cache[i].sector = (size_t)-1;
+          bch->cache[i].dirty  = false;
+        }
+    }
+}
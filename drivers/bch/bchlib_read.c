@@ -82,7 +82,10 @@
 ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  FAR struct bch_sector_s *cached;
+#if !defined(CONFIG_BCH_ENCRYPTION)
   size_t   nsectors;
+#endif
   size_t   sector;
   uint16_t sectoffset;
   size_t   nbytes;
@@ -113,9 +116,13 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
   bytesread = 0;
   if (sectoffset > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cached);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector to the user buffer */
 
@@ -128,7 +135,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, &cached->buffer[sectoffset], nbytes);
 
       /* Adjust pointers and counts */
 
@@ -144,8 +151,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       len       -= nbytes;
     }
 
+#if !defined(CONFIG_BCH_ENCRYPTION)
   /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
+   * into the user buffer with a single request.  The cache is written
+   * through by bchlib_write(), so it never holds newer data for these
+   * sectors.  (Encrypted sectors must be decrypted in the sector cache.)
    */
 
   if (len >= bch->sectsize )
@@ -160,7 +170,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
                                        sector, nsectors);
       if (ret < 0)
         {
-          fdbg("Read failed: %d\n");
+          fdbg("Read failed: %d\n", ret);
           return ret;
         }
 
@@ -170,6 +180,10 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       nbytes     = nsectors * bch->sectsize;
       bytesread += nbytes;
 
+#ifdef CONFIG_BCH_READAHEAD
+      bch->nextsector = sector;
+#endif
+
       if (sector >= bch->nsectors)
         {
           return bytesread;
@@ -178,22 +192,39 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       buffer    += nbytes;
       len       -= nbytes;
     }
+#endif
 
-  /* Then read any partial final sector */
+  /* Then read any remaining sectors through the sector cache.  Unless
+   * encryption is enabled, this is only the partial final sector.
+   */
 
-  if (len > 0)
+  while (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cached);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      nbytes = len > bch->sectsize ? bch->sectsize : len;
+      memcpy(buffer, cached->buffer, nbytes);
 
-      /* Adjust counts */
+      /* Adjust pointers and counts */
+
+      sector++;
+      bytesread += nbytes;
+
+      if (sector >= bch->nsectors)
+        {
+          break;
+        }
 
-      bytesread += len;
+      buffer    += nbytes;
+      len       -= nbytes;
     }
 
   return bytesread;
@@ -88,6 +88,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   FAR struct bchlib_s *bch;
   struct geometry geo;
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -137,12 +138,15 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   sem_init(&bch->sem, 0, 1);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+#ifdef CONFIG_BCH_READAHEAD
+  bch->nextsector = (size_t)-1;
+#endif
 
-  /* Allocate the sector I/O buffer */
+  /* Allocate the sector I/O buffers */
 
-  bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
+  bch->buffer = (FAR uint8_t *)
+    kmm_malloc(CONFIG_BCH_NCACHE * (size_t)bch->sectsize);
   if (!bch->buffer)
     {
       fdbg("Failed to allocate sector buffer\n");
@@ -150,6 +154,14 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
       goto errout_with_bch;
     }
 
+  /* Initialize the (empty) sector cache */
+
+  for (i = 0; i < CONFIG_BCH_NCACHE; i++)
+    {
+      bch->cache[i].sector = (size_t)-1;
+      bch->cache[i].buffer = &bch->buffer[i * bch->sectsize];
+    }
+
   *handle = bch;
   return OK;
 
@@ -83,7 +83,10 @@
 ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  FAR struct bch_sector_s *cached;
+#if !defined(CONFIG_BCH_ENCRYPTION)
   size_t   nsectors;
+#endif
   size_t   sector;
   uint16_t sectoffset;
   size_t   nbytes;
@@ -112,9 +115,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
   byteswritten = 0;
   if (sectoffset > 0)
     {
-      /* Read the full sector into the sector buffer */
+      /* Read the full sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cached);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector from the user buffer */
 
@@ -127,25 +134,27 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(&cached->buffer[sectoffset], buffer, nbytes);
+      cached->dirty = true;
 
       /* Adjust pointers and counts */
 
       sector++;
+      byteswritten = nbytes;
 
       if (sector >= bch->nsectors)
         {
-          return nbytes;
+          goto flush;
         }
 
-      byteswritten  = nbytes;
       buffer       += nbytes;
       len          -= nbytes;
     }
 
+#if !defined(CONFIG_BCH_ENCRYPTION)
   /* Then write all of the full sectors following the partial sector
-   * directly from the user buffer.
+   * directly from the user buffer.  (Encrypted sectors must be encrypted
+   * in the sector cache.)
    */
 
   if (len >= bch->sectsize )
@@ -156,6 +165,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
           nsectors = bch->nsectors - sector;
         }
 
+      /* Any cached copies of these sectors are about to become stale */
+
+      bchlib_invalidate(bch, sector, nsectors);
+
       /* Write the contiguous sectors */
 
       ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
@@ -174,34 +187,63 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
       if (sector >= bch->nsectors)
         {
-          return byteswritten;
+          goto flush;
         }
 
       buffer    += nbytes;
       len       -= nbytes;
     }
+#endif
 
-  /* Then write any partial final sector */
+  /* Then write any remaining sectors through the sector cache.  Unless
+   * encryption is enabled, this is only the partial final sector.
+   */
 
-  if (len > 0)
+  while (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Get the sector into the sector cache.  There is no need to read a
+       * sector that will be completely overwritten.
+       */
 
-      bchlib_readsector(bch, sector);
+      if (len >= bch->sectsize)
+        {
+          nbytes = bch->sectsize;
+          ret    = bchlib_newsector(bch, sector, &cached);
+        }
+      else
+        {
+          nbytes = len;
+          ret    = bchlib_readsector(bch, sector, &cached);
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(cached->buffer, buffer, nbytes);
+      cached->dirty = true;
+
+      /* Adjust pointers and counts */
+
+      sector++;
+      byteswritten += nbytes;
 
-      /* Adjust counts */
+      if (sector >= bch->nsectors)
+        {
+          break;
+        }
 
-      byteswritten += len;
+      buffer       += nbytes;
+      len          -= nbytes;
     }
 
   /* Finally, flush any cached writes to the device as well */
 
-  ret = bchlib_flushsector(bch);
+flush:
+  ret = bchlib_flushcache(bch);
   if (ret < 0)
     {
       fdbg("Flush failed: %d\n", ret);
@@ -210,4 +252,3 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
   return byteswritten;
 }
-
@@ -49,6 +49,8 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <semaphore.h>
+
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -63,10 +65,67 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+#ifdef CONFIG_FTL_LOG
+#  ifndef CONFIG_FTL_LOG_SPARE
+#    define CONFIG_FTL_LOG_SPARE 4
+#  endif
+
+#  ifndef CONFIG_FTL_LOG_WLTHRESHOLD
+#    define CONFIG_FTL_LOG_WLTHRESHOLD 64
+#  endif
+
+/* Each erase block begins with summary pages that hold a header followed
+ * by the logical sector number of each data page in the erase block.
+ */
+
+#  define FTL_LOG_MAGIC      0x4c544621  /* "!FTL" */
+#  define FTL_LOG_HDRSIZE    sizeof(struct ftl_loghdr_s)
+#  define FTL_LOG_UNMAPPED   0xffffffff
+#  define FTL_LOG_NOBLOCK    0xffffffff
+
+/* Free erase blocks required before a new erase block is opened for user
+ * data.  The last free erase block receives the valid pages of the erase
+ * block that is being reclaimed.
+ */
+
+#  define FTL_LOG_MINFREE    2
+
+#  define ftl_log_semgive(d) sem_post(&(d)->exclsem)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_LOG
+/* Header at the beginning of each erase block in the log */
+
+struct ftl_loghdr_s
+{
+  uint32_t magic;                /* FTL_LOG_MAGIC */
+  uint32_t ec;                   /* Erase count */
+  uint32_t seq;                  /* Sequence number within the log */
+  uint32_t reserved;
+};
+
+/* RAM state of one erase block */
+
+enum ftl_ebstate_e
+{
+  FTL_EB_FREE = 0,               /* Holds no valid data */
+  FTL_EB_USED,                   /* Closed, holds valid data */
+  FTL_EB_OPEN                    /* The head of the log */
+};
+
+struct ftl_eblock_s
+{
+  uint32_t ec;                   /* Erase count */
+  uint32_t seq;                  /* Sequence number when opened */
+  uint16_t valid;                /* Number of valid data pages */
+  uint8_t  state;                /* See enum ftl_ebstate_e */
+};
+#endif
+
 struct ftl_struct_s
 {
   FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
@@ -75,7 +134,23 @@ struct ftl_struct_s
   struct rwbuffer_s     rwb;     /* Read-ahead/write buffer support */
 #endif
   uint16_t              blkper;  /* R/W blocks per erase block */
-#ifdef CONFIG_FS_WRITABLE
+#ifdef CONFIG_FTL_LOG
+  sem_t                 exclsem;   /* Exclusive access to the log */
+  uint16_t              nsumm;     /* Summary pages per erase block */
+  uint16_t              ndata;     /* Data pages per erase block */
+  uint16_t              nextpage;  /* Next data page in the open block */
+  bool                  ingc;      /* Garbage collection in progress */
+  uint32_t              nsectors;  /* Number of logical sectors */
+  uint32_t              nfree;     /* Number of free erase blocks */
+  uint32_t              seq;       /* Next erase block sequence number */
+  uint32_t              openblk;   /* Erase block at the head of the log */
+  FAR uint32_t         *map;       /* Logical to physical page map */
+  FAR struct ftl_eblock_s *eblocks; /* State of each erase block */
+  FAR uint8_t          *summary;   /* Summary pages of the open block */
+  FAR uint8_t          *gcsummary; /* Summary pages of a reclaimed block */
+  FAR uint8_t          *pagebuf;   /* One page for copying */
+  struct ftl_stats_s    stats;     /* Write amplification statistics */
+#elif defined(CONFIG_FS_WRITABLE)
   FAR uint8_t          *eblock;  /* One, in-memory erase block */
 #endif
 };
@@ -147,6 +222,808 @@ static int ftl_close(FAR struct inode *inode)
   return OK;
 }
 
+/****************************************************************************
+ * Name: ftl_log_semtake
+ *
+ * Description: Get exclusive access to the log-structured FTL state
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static void ftl_log_semtake(FAR struct ftl_struct_s *dev)
+{
+  while (sem_wait(&dev->exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      ASSERT(errno == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_sumwrite
+ *
+ * Description:
+ *   Write the summary pages of the open erase block that hold the entries
+ *   for data pages first through first+count-1.  The summary pages are
+ *   programmed again as entries are added;  only erased bits change.
+ *
+ ****************************************************************************/
+
+static int ftl_log_sumwrite(FAR struct ftl_struct_s *dev, unsigned int first,
+                            unsigned int count)
+{
+  off_t  base = (off_t)dev->openblk * dev->blkper;
+  size_t start;
+  size_t end;
+  ssize_t nxfrd;
+
+  start = FTL_LOG_HDRSIZE + first * sizeof(uint32_t);
+  end   = FTL_LOG_HDRSIZE + (first + count) * sizeof(uint32_t);
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+  /* Write only the new entries if the FLASH supports byte writes */
+
+  if (dev->mtd->write != NULL)
+    {
+      nxfrd = MTD_WRITE(dev->mtd, base * dev->geo.blocksize + start,
+                        end - start, dev->summary + start);
+      if (nxfrd != end - start)
+        {
+          fdbg("Write summary of erase block %d failed: %d\n",
+               dev->openblk, nxfrd);
+          return -EIO;
+        }
+
+      dev->stats.nsummary++;
+      return OK;
+    }
+#endif
+
+  /* Otherwise, write the summary pages that hold the new entries */
+
+  start = start / dev->geo.blocksize;
+  end   = (end + dev->geo.blocksize - 1) / dev->geo.blocksize;
+
+  nxfrd = MTD_BWRITE(dev->mtd, base + start, end - start,
+                     dev->summary + start * dev->geo.blocksize);
+  if (nxfrd != end - start)
+    {
+      fdbg("Write summary of erase block %d failed: %d\n",
+           dev->openblk, nxfrd);
+      return -EIO;
+    }
+
+  dev->stats.nsummary += end - start;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_openblock
+ *
+ * Description:
+ *   Erase the free erase block with the lowest erase count and make it the
+ *   head of the log.
+ *
+ ****************************************************************************/
+
+static int ftl_log_openblock(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_loghdr_s *hdr;
+  FAR struct ftl_eblock_s *eb;
+  uint32_t best = FTL_LOG_NOBLOCK;
+  uint32_t i;
+  int ret;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      eb = &dev->eblocks[i];
+      if (eb->state == FTL_EB_FREE &&
+          (best == FTL_LOG_NOBLOCK || eb->ec < dev->eblocks[best].ec))
+        {
+          best = i;
+        }
+    }
+
+  if (best == FTL_LOG_NOBLOCK)
+    {
+      fdbg("No free erase block\n");
+      return -ENOSPC;
+    }
+
+  /* Free erase blocks are erased only when they are reused */
+
+  ret = MTD_ERASE(dev->mtd, best, 1);
+  if (ret < 0)
+    {
+      fdbg("Erase block=%d failed: %d\n", best, ret);
+      return ret;
+    }
+
+  dev->stats.nerased++;
+
+  /* Close the previous head of the log */
+
+  if (dev->openblk != FTL_LOG_NOBLOCK)
+    {
+      dev->eblocks[dev->openblk].state = FTL_EB_USED;
+    }
+
+  eb         = &dev->eblocks[best];
+  eb->ec++;
+  eb->seq    = dev->seq++;
+  eb->valid  = 0;
+  eb->state  = FTL_EB_OPEN;
+  dev->nfree--;
+
+  dev->openblk  = best;
+  dev->nextpage = 0;
+
+  /* Write the header into the first summary page */
+
+  memset(dev->summary, 0xff, dev->nsumm * dev->geo.blocksize);
+
+  hdr        = (FAR struct ftl_loghdr_s *)dev->summary;
+  hdr->magic = FTL_LOG_MAGIC;
+  hdr->ec    = eb->ec;
+  hdr->seq   = eb->seq;
+
+  ret = MTD_BWRITE(dev->mtd, (off_t)best * dev->blkper, 1, dev->summary);
+  if (ret != 1)
+    {
+      fdbg("Write header of erase block %d failed: %d\n", best, ret);
+      return -EIO;
+    }
+
+  dev->stats.nsummary++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_program
+ *
+ * Description:
+ *   Append consecutive logical sectors to the head of the log, update the
+ *   map, and invalidate the previous copies of the sectors.
+ *
+ ****************************************************************************/
+
+static int ftl_log_reclaim(FAR struct ftl_struct_s *dev);
+
+static ssize_t ftl_log_program(FAR struct ftl_struct_s *dev,
+                               FAR const uint8_t *buffer, uint32_t sector,
+                               size_t nsectors)
+{
+  FAR uint32_t *entries = (FAR uint32_t *)(dev->summary + FTL_LOG_HDRSIZE);
+  uint32_t phys;
+  uint32_t old;
+  size_t remaining = nsectors;
+  size_t run;
+  size_t i;
+  ssize_t nxfrd;
+  int ret;
+
+  while (remaining > 0)
+    {
+      /* Open a new erase block if the head of the log is full.  The last
+       * free erase blocks are reserved for garbage collection.
+       */
+
+      if (dev->openblk == FTL_LOG_NOBLOCK || dev->nextpage >= dev->ndata)
+        {
+          if (!dev->ingc)
+            {
+              ret = ftl_log_reclaim(dev);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          ret = ftl_log_openblock(dev);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      /* Write as many sectors as fit into the open erase block */
+
+      run = dev->ndata - dev->nextpage;
+      if (run > remaining)
+        {
+          run = remaining;
+        }
+
+      phys  = dev->openblk * dev->blkper + dev->nsumm + dev->nextpage;
+      nxfrd = MTD_BWRITE(dev->mtd, phys, run, buffer);
+      if (nxfrd != run)
+        {
+          fdbg("Write %d blocks at block %d failed: %d\n", run, phys, nxfrd);
+          return -EIO;
+        }
+
+      /* Then update the map and record the sectors in the summary */
+
+      for (i = 0; i < run; i++)
+        {
+          old = dev->map[sector + i];
+          if (old != FTL_LOG_UNMAPPED)
+            {
+              DEBUGASSERT(dev->eblocks[old / dev->blkper].valid > 0);
+              dev->eblocks[old / dev->blkper].valid--;
+            }
+
+          dev->map[sector + i] = phys + i;
+          entries[dev->nextpage + i] = sector + i;
+        }
+
+      dev->eblocks[dev->openblk].valid += run;
+
+      ret = ftl_log_sumwrite(dev, dev->nextpage, run);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      dev->nextpage += run;
+      dev->stats.nprogrammed += run;
+      buffer    += run * dev->geo.blocksize;
+      sector    += run;
+      remaining -= run;
+    }
+
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: ftl_log_collect
+ *
+ * Description:
+ *   Copy the valid pages of one erase block to the head of the log and
+ *   return the erase block to the free pool.
+ *
+ ****************************************************************************/
+
+static int ftl_log_collect(FAR struct ftl_struct_s *dev, uint32_t victim)
+{
+  FAR uint32_t *entries = (FAR uint32_t *)(dev->gcsummary + FTL_LOG_HDRSIZE);
+  FAR struct ftl_eblock_s *eb = &dev->eblocks[victim];
+  uint32_t base = victim * dev->blkper + dev->nsumm;
+  uint32_t sector;
+  ssize_t nxfrd;
+  unsigned int i;
+
+  fvdbg("Reclaim erase block %d: valid=%d ec=%d\n", victim, eb->valid,
+        eb->ec);
+
+  nxfrd = MTD_BREAD(dev->mtd, (off_t)victim * dev->blkper, dev->nsumm,
+                    dev->gcsummary);
+  if (nxfrd != dev->nsumm)
+    {
+      fdbg("Read summary of erase block %d failed: %d\n", victim, nxfrd);
+      return -EIO;
+    }
+
+  for (i = 0; i < dev->ndata && eb->valid > 0; i++)
+    {
+      sector = entries[i];
+      if (sector >= dev->nsectors || dev->map[sector] != base + i)
+        {
+          continue;
+        }
+
+      nxfrd = MTD_BREAD(dev->mtd, base + i, 1, dev->pagebuf);
+      if (nxfrd != 1)
+        {
+          fdbg("Read block %d failed: %d\n", base + i, nxfrd);
+          return -EIO;
+        }
+
+      nxfrd = ftl_log_program(dev, dev->pagebuf, sector, 1);
+      if (nxfrd < 0)
+        {
+          return nxfrd;
+        }
+
+      dev->stats.ncopied++;
+    }
+
+  DEBUGASSERT(eb->valid == 0);
+  eb->state = FTL_EB_FREE;
+  dev->nfree++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_reclaim
+ *
+ * Description:
+ *   Collect garbage until enough free erase blocks are available to open
+ *   a new erase block.  Normally, the erase block with the fewest valid
+ *   pages is collected.  But if the erase counts of the erase blocks in use
+ *   differ by more than CONFIG_FTL_LOG_WLTHRESHOLD, the least worn erase
+ *   block is collected first so that its static data moves and the erase
+ *   block is reused.
+ *
+ ****************************************************************************/
+
+static int ftl_log_reclaim(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_eblock_s *eb;
+  uint32_t victim;
+  uint32_t coldest;
+  uint32_t maxec;
+  uint32_t i;
+  bool wearlevel = true;
+  int ret = OK;
+
+  dev->ingc = true;
+  while (dev->nfree < FTL_LOG_MINFREE)
+    {
+      victim  = FTL_LOG_NOBLOCK;
+      coldest = FTL_LOG_NOBLOCK;
+      maxec   = 0;
+
+      for (i = 0; i < dev->geo.neraseblocks; i++)
+        {
+          eb = &dev->eblocks[i];
+          if (eb->ec > maxec)
+            {
+              maxec = eb->ec;
+            }
+
+          if (eb->state != FTL_EB_USED)
+            {
+              continue;
+            }
+
+          if (victim == FTL_LOG_NOBLOCK ||
+              eb->valid < dev->eblocks[victim].valid ||
+              (eb->valid == dev->eblocks[victim].valid &&
+               eb->ec < dev->eblocks[victim].ec))
+            {
+              victim = i;
+            }
+
+          if (coldest == FTL_LOG_NOBLOCK ||
+              eb->ec < dev->eblocks[coldest].ec)
+            {
+              coldest = i;
+            }
+        }
+
+      /* Move static data at most once per reclaim so that progress is
+       * always made.
+       */
+
+      if (wearlevel && coldest != FTL_LOG_NOBLOCK &&
+          maxec - dev->eblocks[coldest].ec > CONFIG_FTL_LOG_WLTHRESHOLD)
+        {
+          victim = coldest;
+        }
+      else if (victim == FTL_LOG_NOBLOCK ||
+               dev->eblocks[victim].valid >= dev->ndata)
+        {
+          fdbg("No erase block to reclaim\n");
+          ret = -ENOSPC;
+          break;
+        }
+
+      wearlevel = false;
+
+      ret = ftl_log_collect(dev, victim);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  dev->ingc = false;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_isnewer
+ *
+ * Description:
+ *   Return true if physical page 'a' holds a newer copy of a sector than
+ *   physical page 'b'.
+ *
+ ****************************************************************************/
+
+static bool ftl_log_isnewer(FAR struct ftl_struct_s *dev, uint32_t a,
+                            uint32_t b)
+{
+  uint32_t seqa = dev->eblocks[a / dev->blkper].seq;
+  uint32_t seqb = dev->eblocks[b / dev->blkper].seq;
+
+  return seqa != seqb ? (int32_t)(seqa - seqb) > 0 : a > b;
+}
+
+/****************************************************************************
+ * Name: ftl_log_iserased
+ *
+ * Description:
+ *   Return true if the pages first through the last data page of an erase
+ *   block are still erased.
+ *
+ ****************************************************************************/
+
+static bool ftl_log_iserased(FAR struct ftl_struct_s *dev, uint32_t block,
+                             unsigned int first)
+{
+  uint32_t base = block * dev->blkper + dev->nsumm;
+  unsigned int i;
+  unsigned int j;
+
+  for (i = first; i < dev->ndata; i++)
+    {
+      if (MTD_BREAD(dev->mtd, base + i, 1, dev->pagebuf) != 1)
+        {
+          return false;
+        }
+
+      for (j = 0; j < dev->geo.blocksize; j++)
+        {
+          if (dev->pagebuf[j] != 0xff)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ftl_log_mount
+ *
+ * Description:
+ *   Rebuild the logical-to-physical map and the erase block state from the
+ *   summary pages.  Where a sector was written more than once, the copy in
+ *   the erase block with the highest sequence number (and the highest page
+ *   in that erase block) is current.  Erase blocks without a valid header
+ *   are free.
+ *
+ ****************************************************************************/
+
+static int ftl_log_mount(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_loghdr_s *hdr = (FAR struct ftl_loghdr_s *)dev->gcsummary;
+  FAR uint32_t *entries = (FAR uint32_t *)(dev->gcsummary + FTL_LOG_HDRSIZE);
+  FAR struct ftl_eblock_s *eb;
+  uint32_t newest = FTL_LOG_NOBLOCK;
+  uint32_t nknown = 0;
+  uint32_t ecsum  = 0;
+  uint32_t sector;
+  uint32_t phys;
+  uint32_t i;
+  unsigned int j;
+  ssize_t nxfrd;
+
+  memset(dev->map, 0xff, dev->nsectors * sizeof(uint32_t));
+  dev->seq   = 0;
+  dev->nfree = 0;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      eb = &dev->eblocks[i];
+      memset(eb, 0, sizeof(struct ftl_eblock_s));
+
+      nxfrd = MTD_BREAD(dev->mtd, (off_t)i * dev->blkper, dev->nsumm,
+                        dev->gcsummary);
+      if (nxfrd != dev->nsumm)
+        {
+          fdbg("Read summary of erase block %d failed: %d\n", i, nxfrd);
+          return -EIO;
+        }
+
+      if (hdr->magic != FTL_LOG_MAGIC)
+        {
+          /* Never used (or the erase was interrupted) */
+
+          eb->state = FTL_EB_FREE;
+          eb->ec    = FTL_LOG_NOBLOCK;
+          dev->nfree++;
+          continue;
+        }
+
+      eb->ec    = hdr->ec;
+      eb->seq   = hdr->seq;
+      eb->state = FTL_EB_USED;
+      ecsum    += hdr->ec;
+      nknown++;
+
+      if ((int32_t)(hdr->seq + 1 - dev->seq) > 0)
+        {
+          dev->seq = hdr->seq + 1;
+          newest   = i;
+        }
+
+      /* Keep the newest copy of each sector recorded in the summary */
+
+      for (j = 0; j < dev->ndata; j++)
+        {
+          sector = entries[j];
+          if (sector >= dev->nsectors)
+            {
+              continue;
+            }
+
+          phys = i * dev->blkper + dev->nsumm + j;
+          if (dev->map[sector] == FTL_LOG_UNMAPPED ||
+              ftl_log_isnewer(dev, phys, dev->map[sector]))
+            {
+              dev->map[sector] = phys;
+            }
+        }
+    }
+
+  /* Count the valid pages in each erase block */
+
+  for (sector = 0; sector < dev->nsectors; sector++)
+    {
+      if (dev->map[sector] != FTL_LOG_UNMAPPED)
+        {
+          dev->eblocks[dev->map[sector] / dev->blkper].valid++;
+        }
+    }
+
+  /* Erase blocks that hold no valid pages are free.  Erase blocks whose
+   * erase count was lost are assumed to have the average erase count.
+   */
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      eb = &dev->eblocks[i];
+      if (eb->state == FTL_EB_USED && eb->valid == 0 && i != newest)
+        {
+          eb->state = FTL_EB_FREE;
+          dev->nfree++;
+        }
+      else if (eb->ec == FTL_LOG_NOBLOCK)
+        {
+          eb->ec = nknown > 0 ? ecsum / nknown : 0;
+        }
+    }
+
+  /* Continue to fill the newest erase block if its unused pages are still
+   * erased.  Otherwise, a new erase block is opened by the next write.
+   */
+
+  dev->openblk  = FTL_LOG_NOBLOCK;
+  dev->nextpage = dev->ndata;
+
+  if (newest != FTL_LOG_NOBLOCK)
+    {
+      nxfrd = MTD_BREAD(dev->mtd, (off_t)newest * dev->blkper, dev->nsumm,
+                        dev->summary);
+      if (nxfrd != dev->nsumm)
+        {
+          return -EIO;
+        }
+
+      entries = (FAR uint32_t *)(dev->summary + FTL_LOG_HDRSIZE);
+      for (j = 0; j < dev->ndata && entries[j] != FTL_LOG_UNMAPPED; j++);
+
+      if (j < dev->ndata && ftl_log_iserased(dev, newest, j))
+        {
+          dev->eblocks[newest].state = FTL_EB_OPEN;
+          dev->openblk  = newest;
+          dev->nextpage = j;
+        }
+      else if (dev->eblocks[newest].valid == 0)
+        {
+          dev->eblocks[newest].state = FTL_EB_FREE;
+          dev->nfree++;
+        }
+    }
+
+  fvdbg("sectors: %d free erase blocks: %d open: %d/%d\n",
+        dev->nsectors, dev->nfree, dev->openblk, dev->nextpage);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_read
+ *
+ * Description:
+ *   Read logical sectors through the map.  Sectors that were never written
+ *   read as erased.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_read(FAR struct ftl_struct_s *dev,
+                            FAR uint8_t *buffer, off_t startblock,
+                            size_t nblocks)
+{
+  uint32_t phys;
+  size_t remaining = nblocks;
+  size_t run;
+  ssize_t nxfrd;
+
+  if (startblock < 0 || startblock + nblocks > dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  ftl_log_semtake(dev);
+  while (remaining > 0)
+    {
+      phys = dev->map[startblock];
+
+      /* Read physically consecutive sectors with one transfer */
+
+      for (run = 1;
+           run < remaining && phys != FTL_LOG_UNMAPPED &&
+           dev->map[startblock + run] == phys + run;
+           run++);
+
+      if (phys == FTL_LOG_UNMAPPED)
+        {
+          memset(buffer, 0xff, dev->geo.blocksize);
+        }
+      else
+        {
+          nxfrd = MTD_BREAD(dev->mtd, phys, run, buffer);
+          if (nxfrd != run)
+            {
+              fdbg("Read %d blocks starting at block %d failed: %d\n",
+                   run, phys, nxfrd);
+              ftl_log_semgive(dev);
+              return -EIO;
+            }
+        }
+
+      startblock += run;
+      remaining  -= run;
+      buffer     += run * dev->geo.blocksize;
+    }
+
+  ftl_log_semgive(dev);
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_log_write
+ *
+ * Description:
+ *   Write logical sectors by appending them to the log
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_write(FAR struct ftl_struct_s *dev,
+                             FAR const uint8_t *buffer, off_t startblock,
+                             size_t nblocks)
+{
+  ssize_t ret;
+
+  if (startblock < 0 || startblock + nblocks > dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  ftl_log_semtake(dev);
+  ret = ftl_log_program(dev, buffer, startblock, nblocks);
+  if (ret > 0)
+    {
+      dev->stats.nwritten += ret;
+    }
+
+  ftl_log_semgive(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_uninitialize
+ *
+ * Description:
+ *   Free the memory allocated by ftl_log_initialize()
+ *
+ ****************************************************************************/
+
+static void ftl_log_uninitialize(FAR struct ftl_struct_s *dev)
+{
+  if (dev->map)
+    {
+      kmm_free(dev->map);
+    }
+
+  if (dev->eblocks)
+    {
+      kmm_free(dev->eblocks);
+    }
+
+  if (dev->summary)
+    {
+      kmm_free(dev->summary);
+    }
+
+  if (dev->gcsummary)
+    {
+      kmm_free(dev->gcsummary);
+    }
+
+  if (dev->pagebuf)
+    {
+      kmm_free(dev->pagebuf);
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Size the log, allocate the map and rebuild it from the FLASH
+ *
+ ****************************************************************************/
+
+static int ftl_log_initialize(FAR struct ftl_struct_s *dev)
+{
+  uint32_t nused;
+  int ret;
+
+  /* Find the number of summary pages needed to hold the header and one
+   * entry for each remaining page of the erase block.
+   */
+
+  for (dev->nsumm = 1;
+       dev->nsumm < dev->blkper &&
+       (uint32_t)dev->nsumm * dev->geo.blocksize <
+         FTL_LOG_HDRSIZE + (dev->blkper - dev->nsumm) * sizeof(uint32_t);
+       dev->nsumm++);
+
+  if (dev->nsumm >= dev->blkper ||
+      dev->geo.neraseblocks <= CONFIG_FTL_LOG_SPARE)
+    {
+      fdbg("Geometry not supported\n");
+      return -EINVAL;
+    }
+
+  dev->ndata    = dev->blkper - dev->nsumm;
+  nused         = dev->geo.neraseblocks - CONFIG_FTL_LOG_SPARE;
+  dev->nsectors = nused * dev->ndata;
+
+  dev->map       = (FAR uint32_t *)
+                   kmm_malloc(dev->nsectors * sizeof(uint32_t));
+  dev->eblocks   = (FAR struct ftl_eblock_s *)
+                   kmm_malloc(dev->geo.neraseblocks *
+                              sizeof(struct ftl_eblock_s));
+  dev->summary   = (FAR uint8_t *)
+                   kmm_malloc(dev->nsumm * dev->geo.blocksize);
+  dev->gcsummary = (FAR uint8_t *)
+                   kmm_malloc(dev->nsumm * dev->geo.blocksize);
+  dev->pagebuf   = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+
+  if (!dev->map || !dev->eblocks || !dev->summary || !dev->gcsummary ||
+      !dev->pagebuf)
+    {
+      fdbg("Failed to allocate the map\n");
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  memset(&dev->stats, 0, sizeof(struct ftl_stats_s));
+  sem_init(&dev->exclsem, 0, 1);
+  dev->ingc = false;
+
+  ret = ftl_log_mount(dev);
+  if (ret >= 0)
+    {
+      return OK;
+    }
+
+  sem_destroy(&dev->exclsem);
+
+errout:
+  ftl_log_uninitialize(dev);
+  return ret;
+}
+#endif /* CONFIG_FTL_LOG */
+
 /****************************************************************************
  * Name: ftl_reload
  *
@@ -158,8 +1035,15 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
                           off_t startblock, size_t nblocks)
 {
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+#ifndef CONFIG_FTL_LOG
   ssize_t nread;
+#endif
 
+#ifdef CONFIG_FTL_LOG
+  /* Read the sectors through the logical-to-physical map */
+
+  return ftl_log_read(dev, buffer, startblock, nblocks);
+#else
   /* Read the full erase block into the buffer */
 
   nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
@@ -170,6 +1054,7 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
     }
 
   return nread;
+#endif
 }
 
 /****************************************************************************
@@ -203,7 +1088,20 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_FS_WRITABLE
+#if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_LOG)
+static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
+                         off_t startblock, size_t nblocks)
+{
+  struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+
+  /* Append the sectors to the log.  There is no read-modify-write of the
+   * erase block.
+   */
+
+  return ftl_log_write(dev, buffer, startblock, nblocks);
+}
+
+#elif defined(CONFIG_FS_WRITABLE)
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                          off_t startblock, size_t nblocks)
 {
@@ -422,7 +1320,11 @@ static int ftl_geometry(FAR struct inode *inode, struct geometry *geometry)
 #else
       geometry->geo_writeenabled  = false;
 #endif
+#ifdef CONFIG_FTL_LOG
+      geometry->geo_nsectors      = dev->nsectors;
+#else
       geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#endif
       geometry->geo_sectorsize    = dev->geo.blocksize;
 
       fvdbg("available: true mediachanged: false writeenabled: %s\n",
@@ -453,7 +1355,7 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
   /* Only one block driver ioctl command is supported by this driver (and
    * that command is just passed on to the MTD driver in a slightly
-   * different form).
+   * different form).  The log-structured FTL also reports its statistics.
    */
 
   if (cmd == BIOC_XIPBASE)
@@ -476,6 +1378,63 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       cmd = MTDIOC_XIPBASE;
     }
 
+#ifdef CONFIG_FTL_LOG
+  else if (cmd == BIOC_FTLSTATS)
+    {
+      /* Return the write amplification statistics of the log */
+
+      FAR struct ftl_stats_s *stats =
+        (FAR struct ftl_stats_s *)((uintptr_t)arg);
+      uint32_t i;
+
+      if (stats == NULL)
+        {
+          return -EINVAL;
+        }
+
+      dev = (struct ftl_struct_s *)inode->i_private;
+      ftl_log_semtake(dev);
+
+      dev->stats.minec = UINT32_MAX;
+      dev->stats.maxec = 0;
+      for (i = 0; i < dev->geo.neraseblocks; i++)
+        {
+          if (dev->eblocks[i].ec < dev->stats.minec)
+            {
+              dev->stats.minec = dev->eblocks[i].ec;
+            }
+
+          if (dev->eblocks[i].ec > dev->stats.maxec)
+            {
+              dev->stats.maxec = dev->eblocks[i].ec;
+            }
+        }
+
+      memcpy(stats, &dev->stats, sizeof(struct ftl_stats_s));
+      ftl_log_semgive(dev);
+      return OK;
+    }
+#endif
+
+#if defined(FTL_HAVE_RWBUFFER) && defined(CONFIG_DRVR_RWBSTATS)
+  else if (cmd == BIOC_RWBSTATS)
+    {
+      /* Return the statistics of the read-ahead/write buffer */
+
+      FAR struct rwb_stats_s *stats =
+        (FAR struct rwb_stats_s *)((uintptr_t)arg);
+
+      if (stats == NULL)
+        {
+          return -EINVAL;
+        }
+
+      dev = (struct ftl_struct_s *)inode->i_private;
+      rwb_getstats(&dev->rwb, stats);
+      return OK;
+    }
+#endif
+
   /* No other block driver ioctl commmands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -545,9 +1504,25 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
           return ret;
         }
 
+      /* Get the number of R/W blocks per erase block */
+
+      dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
+      DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
+
+#ifdef CONFIG_FTL_LOG
+      /* Allocate the logical-to-physical map and rebuild it from FLASH */
+
+      ret = ftl_log_initialize(dev);
+      if (ret < 0)
+        {
+          fdbg("Failed to mount the log: %d\n", ret);
+          kmm_free(dev);
+          return ret;
+        }
+
+#elif defined(CONFIG_FS_WRITABLE)
       /* Allocate one, in-memory erase block buffer */
 
-#ifdef CONFIG_FS_WRITABLE
       dev->eblock  = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
       if (!dev->eblock)
         {
@@ -557,16 +1532,15 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
         }
 #endif
 
-      /* Get the number of R/W blocks per erase block */
-
-      dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
-      DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
-
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize   = dev->geo.blocksize;
+#ifdef CONFIG_FTL_LOG
+      dev->rwb.nblocks     = dev->nsectors;
+#else
       dev->rwb.nblocks     = dev->geo.neraseblocks * dev->blkper;
+#endif
       dev->rwb.dev         = (FAR void *)dev;
 
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
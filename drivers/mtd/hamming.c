@@ -52,38 +52,77 @@
 
 #include <nuttx/mtd/hamming.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Masks that select the bytes at odd offsets (1 and 3) and at offsets 2 and
+ * 3 of a 32-bit word read from the data buffer.
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define HAMMING_ODDBYTES    0x00ff00ff
+#  define HAMMING_HIGHBYTES   0x0000ffff
+#else
+#  define HAMMING_ODDBYTES    0xff00ff00
+#  define HAMMING_HIGHBYTES   0xffff0000
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Number of bits set to '1' in each byte value.  Bit 0 is the parity of the
+ * byte.
+ */
+
+static const uint8_t g_bitsinbyte[256] =
+{
+  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+  1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+  1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+  1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+  2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+  3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+  3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+  4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8
+};
+
+/* Spreads the 4 bits of a nibble to the even bit positions of a byte:
+ * b3 b2 b1 b0 -> 0 b3 0 b2 0 b1 0 b0
+ */
+
+static const uint8_t g_spreadnibble[16] =
+{
+  0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+  0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: hamming_bitsinbyte
+ * Name: hamming_parity32
  *
  * Description:
- *   Counts the number of bits set to '1' in the given byte.
- *
- * Input Parameters:
- *   bytes - The byte to use.
- *
- * Returned Values:
- *   Returns the number of bits set to '1' in the given byte.
+ *   Returns the parity of a 32-bit word.
  *
  ****************************************************************************/
 
-static unsigned int hamming_bitsinbyte(uint8_t byte)
+static inline uint8_t hamming_parity32(uint32_t word)
 {
-  unsigned int count = 0;
-
-  while (byte != 0)
-    {
-      if ((byte & 1) != 0)
-        {
-          count++;
-        }
-      byte >>= 1;
-    }
-
-  return count;
+  word ^= word >> 16;
+  word ^= word >> 8;
+  return g_bitsinbyte[word & 0xff] & 1;
 }
 
 /****************************************************************************
@@ -100,165 +139,206 @@ static unsigned int hamming_bitsinbyte(uint8_t byte)
  *
  ****************************************************************************/
 
-static uint8_t hamming_bitsincode256(FAR uint8_t *code)
+static inline uint8_t hamming_bitsincode256(FAR uint8_t *code)
 {
-  return hamming_bitsinbyte(code[0]) +
-         hamming_bitsinbyte(code[1]) +
-         hamming_bitsinbyte(code[2]);
+  return g_bitsinbyte[code[0]] + g_bitsinbyte[code[1]] +
+         g_bitsinbyte[code[2]];
 }
 
 /****************************************************************************
- * Name: hamming_compute256
+ * Name: hamming_lines256
  *
  * Description:
- *   Calculates the 22-bit hamming code for a 256-bytes block of data.
+ *   Calculates the column sum and the odd line parities of a 256-bytes
+ *   block of data.
+ *
+ *   Parity groups are formed by forcing a particular index bit to 0 (even)
+ *   or 1 (odd).  Example on one byte:
+ *
+ *   bits (dec)  7   6   5   4   3   2   1   0
+ *        (bin) 111 110 101 100 011 010 001 000
+ *                              '---'---'---'----------.
+ *                                                     |
+ *   groups P4' ooooooooooooooo eeeeeeeeeeeeeee P4     |
+ *          P2' ooooooo eeeeeee ooooooo eeeeeee P2     |
+ *          P1' ooo eee ooo eee ooo eee ooo eee P1     |
+ *                                                     |
+ *   We can see that:                                  |
+ *    - P4  -> bit 2 of index is 0 --------------------'
+ *    - P4' -> bit 2 of index is 1.
+ *    - P2  -> bit 1 of index if 0.
+ *    - etc...
+ *
+ *   The same holds for the bytes of the block:  A byte with odd parity has
+ *   an impact on all odd line parities Px' where the log2(x)nth bit of its
+ *   index is 1, and on all even line parities Px where that bit is 0.  So
+ *   the odd line parities, P128' P64' P32' P16' P8' P4' P2' P1', are the
+ *   xor of the indices of all bytes with odd parity.  The even line
+ *   parities are the same value, inverted if the number of such bytes is
+ *   odd, i.e., if the column sum has odd parity.
+ *
+ *   When the data is word aligned, the block is processed as 64 32-bit
+ *   words:  Bits 7-2 of the byte index are the index of the word, and the
+ *   parity of each of P128'..P4' is the parity of the xor of all words
+ *   whose index has the corresponding bit set.  P2' and P1' are found from
+ *   the xor of all of the words.
  *
  * Input Parameters:
- *   data - Data buffer to calculate code
- *   code - Pointer to a buffer where the code should be stored
+ *   data    - Data buffer to calculate code
+ *   oddline - Location to return the odd line parities
  *
  * Returned Values:
- *   None
+ *   The column sum, i.e., the xor of all bytes of the block.
  *
  ****************************************************************************/
 
-static void hamming_compute256(FAR const uint8_t *data, FAR uint8_t *code)
+static uint8_t hamming_lines256(FAR const uint8_t *data,
+                                FAR uint8_t *oddline)
 {
-  uint8_t colsum = 0;
-  uint8_t evenline = 0;
-  uint8_t oddline = 0;
-  uint8_t evencol = 0;
-  uint8_t oddcol = 0;
+  uint8_t line = 0;
+  uint8_t colsum;
   int i;
 
-  /* Xor all bytes together to get the column sum;
-   * At the same time, calculate the even and odd line codes
-   */
-
-  for (i = 0; i < 256; i++)
+  if (((uintptr_t)data & 3) == 0)
     {
-      colsum ^= data[i];
+      FAR const uint32_t *words = (FAR const uint32_t *)data;
+      uint32_t total = 0;
+      uint32_t acc[6];
 
-      /* If the xor sum of the byte is 0, then this byte has no incidence on
-       * the computed code; so check if the sum is 1.
-       */
-
-      if ((hamming_bitsinbyte(data[i]) & 1) == 1)
+      for (i = 0; i < 6; i++)
         {
-          /* Parity groups are formed by forcing a particular index bit to 0
-           * (even) or 1 (odd).
-           * Example on one byte:
-           *
-           * bits (dec)  7   6   5   4   3   2   1   0
-           *      (bin) 111 110 101 100 011 010 001 000
-           *                            '---'---'---'----------.
-           *                                                   |
-           * groups P4' ooooooooooooooo eeeeeeeeeeeeeee P4     |
-           *        P2' ooooooo eeeeeee ooooooo eeeeeee P2     |
-           *        P1' ooo eee ooo eee ooo eee ooo eee P1     |
-           *                                                   |
-           * We can see that:                                  |
-           *  - P4  -> bit 2 of index is 0 --------------------'
-           *  - P4' -> bit 2 of index is 1.
-           *  - P2  -> bit 1 of index if 0.
-           *  - etc...
-           * We deduce that a bit position has an impact on all even Px if
-           * the log2(x)nth bit of its index is 0
-           *     ex: log2(4) = 2, bit2 of the index must be 0 (-> 0 1 2 3)
-           * and on all odd Px' if the log2(x)nth bit of its index is 1
-           *     ex: log2(2) = 1, bit1 of the index must be 1 (-> 0 1 4 5)
-           *
-           * As such, we calculate all the possible Px and Px' values at the
-           * same time in two variables, evenline and oddline, such as
-           *     evenline bits: P128  P64  P32  P16  P8  P4  P2  P1
-           *     oddline  bits: P128' P64' P32' P16' P8' P4' P2' P1'
-           */
-
-          evenline ^= (255 - i);
-          oddline ^= i;
+          acc[i] = 0;
         }
-    }
 
-  /* At this point, we have the line parities, and the column sum. First, We
-   * must caculate the parity group values on the column sum.
-   */
+      /* Take 4 words (16 bytes) at a time.  Within the group, the words at
+       * odd indices contribute to P4' and the last two to P8'.
+       */
 
-  for (i = 0; i < 8; i++)
-    {
-      if (colsum & 1)
+      for (i = 0; i < 16; i++)
         {
-          evencol ^= (7 - i);
-          oddcol ^= i;
-        }
+          uint32_t w1 = words[1];
+          uint32_t w2 = words[2];
+          uint32_t w3 = words[3];
+          uint32_t group;
 
-      colsum >>= 1;
-    }
+          group   = words[0] ^ w1 ^ w2 ^ w3;
+          acc[0] ^= w1 ^ w3;
+          acc[1] ^= w2 ^ w3;
 
-  /* Now, we must interleave the parity values, to obtain the following layout:
-   * Code[0] = Line1
-   * Code[1] = Line2
-   * Code[2] = Column
-   * Line = Px' Px P(x-1)- P(x-1) ...
-   * Column = P4' P4 P2' P2 P1' P1 PadBit PadBit
-   */
+          /* Bits 3-0 of the group index are bits 7-4 of the byte index */
 
-  code[0] = 0;
-  code[1] = 0;
-  code[2] = 0;
+          total  ^= group;
+          if ((i & 1) != 0)
+            {
+              acc[2] ^= group;
+            }
 
-  for (i = 0; i < 4; i++)
-    {
-      code[0] <<= 2;
-      code[1] <<= 2;
-      code[2] <<= 2;
+          if ((i & 2) != 0)
+            {
+              acc[3] ^= group;
+            }
 
-      /* Line 1 */
+          if ((i & 4) != 0)
+            {
+              acc[4] ^= group;
+            }
 
-      if ((oddline & 0x80) != 0)
-        {
-          code[0] |= 2;
-        }
+          if ((i & 8) != 0)
+            {
+              acc[5] ^= group;
+            }
 
-      if ((evenline & 0x80) != 0)
-        {
-          code[0] |= 1;
+          words += 4;
         }
 
-      /* Line 2 */
-
-      if ((oddline & 0x08) != 0)
+      for (i = 5; i >= 0; i--)
         {
-          code[1] |= 2;
+          line = (line << 1) | hamming_parity32(acc[i]);
         }
 
-      if ((evenline & 0x08) != 0)
+      line   = (line << 2) |
+               (hamming_parity32(total & HAMMING_HIGHBYTES) << 1) |
+                hamming_parity32(total & HAMMING_ODDBYTES);
+      colsum = (uint8_t)(total ^ (total >> 8) ^ (total >> 16) ^
+                         (total >> 24));
+    }
+  else
+    {
+      /* Unaligned data, take one byte at a time */
+
+      colsum = 0;
+      for (i = 0; i < 256; i++)
         {
-          code[1] |= 1;
+          colsum ^= data[i];
+          if ((g_bitsinbyte[data[i]] & 1) != 0)
+            {
+              line ^= i;
+            }
         }
+    }
 
-      /* Column */
+  *oddline = line;
+  return colsum;
+}
 
-      if ((oddcol & 0x04) != 0)
-        {
-          code[2] |= 2;
-        }
+/****************************************************************************
+ * Name: hamming_compute256
+ *
+ * Description:
+ *   Calculates the 22-bit hamming code for a 256-bytes block of data.
+ *
+ * Input Parameters:
+ *   data - Data buffer to calculate code
+ *   code - Pointer to a buffer where the code should be stored
+ *
+ * Returned Values:
+ *   None
+ *
+ ****************************************************************************/
 
-      if ((evencol & 0x04) != 0)
-        {
-          code[2] |= 1;
-        }
+static void hamming_compute256(FAR const uint8_t *data, FAR uint8_t *code)
+{
+  uint8_t colsum;
+  uint8_t evenline;
+  uint8_t oddline;
+  uint8_t evencol;
+  uint8_t oddcol;
+  uint8_t invert;
+
+  /* Get the column sum and the line parities */
+
+  colsum   = hamming_lines256(data, &oddline);
+  invert   = (g_bitsinbyte[colsum] & 1) != 0 ? 0xff : 0x00;
+  evenline = oddline ^ invert;
+
+  /* Calculate the parity group values on the column sum in the same way:
+   * The odd column parities P4' P2' P1' are the parities of the bits of
+   * the column sum with bit 2, 1, or 0 of the bit index set.
+   */
 
-      oddline <<= 1;
-      evenline <<= 1;
-      oddcol <<= 1;
-      evencol <<= 1;
-    }
+  oddcol   = (g_bitsinbyte[colsum & 0xf0] & 1) << 2 |
+             (g_bitsinbyte[colsum & 0xcc] & 1) << 1 |
+             (g_bitsinbyte[colsum & 0xaa] & 1);
+  evencol  = oddcol ^ (invert & 7);
 
-  /* Invert codes (linux compatibility) */
+  /* Now, we must interleave the parity values, to obtain the following
+   * layout:
+   *
+   * Code[0] = Line1
+   * Code[1] = Line2
+   * Code[2] = Column
+   * Line = Px' Px P(x-1)- P(x-1) ...
+   * Column = P4' P4 P2' P2 P1' P1 PadBit PadBit
+   *
+   * Then invert the codes (linux compatibility).
+   */
 
-  code[0] = (~(uint32_t)code[0]);
-  code[1] = (~(uint32_t)code[1]);
-  code[2] = (~(uint32_t)code[2]);
+  code[0] = ~(g_spreadnibble[oddline >> 4] << 1 |
+              g_spreadnibble[evenline >> 4]);
+  code[1] = ~(g_spreadnibble[oddline & 15] << 1 |
+              g_spreadnibble[evenline & 15]);
+  code[2] = ~((g_spreadnibble[oddcol] << 1 |
+               g_spreadnibble[evencol]) << 2);
 }
 
 /****************************************************************************
@@ -418,8 +498,8 @@ void hamming_compute256x(FAR const uint8_t *data, size_t size, uint8_t *code)
 int hamming_verify256x(FAR uint8_t *data, size_t size, FAR const uint8_t *code)
 {
   ssize_t remaining = (ssize_t)size;
-  int result = HAMMING_SUCCESS;
-  int ret;
+  int result;
+  int ret = HAMMING_SUCCESS;
 
   DEBUGASSERT((size & 0xff) == 0);
 
@@ -85,10 +85,26 @@
 
 #define MTD_ERASED_FLAGS  CONFIG_MTD_CONFIG_ERASEDVALUE
 
+/* The index table grows by this number of entries at a time */
+
+#define MTDCONFIG_INDEX_INCR  16
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_MTD_CONFIG_INDEX
+/* One active config item in the RAM index */
+
+struct mtdconfig_index_s
+{
+  uint16_t     id;            /* ID of the config data item */
+  uint8_t      instance;      /* Instance of the item */
+  uint16_t     len;           /* Length of the data block */
+  off_t        offset;        /* Offset of the entry header */
+};
+#endif
+
 struct mtdconfig_struct_s
 {
   FAR struct mtd_dev_s *mtd;  /* Contained MTD interface */
@@ -99,6 +115,14 @@ struct mtdconfig_struct_s
   size_t       neraseblocks;  /* Number of erase blocks available */
   off_t        readoff;       /* Read offset (for hexdump) */
   FAR uint8_t *buffer;        /* Temp block read buffer */
+#ifdef CONFIG_MTD_CONFIG_INDEX
+  bool         formatted;     /* The partition has a format signature */
+  uint16_t     endblock;      /* First erase block not used for entries */
+  uint16_t     nindex;        /* Number of items in the index */
+  uint16_t     maxindex;      /* Allocated size of the index */
+  FAR struct mtdconfig_index_s *index; /* Active items sorted by id/instance */
+  FAR off_t   *freeoff;       /* First free offset in each erase block */
+#endif
 };
 
 struct mtdconfig_header_s
@@ -328,6 +352,7 @@ errout:
  *
  ****************************************************************************/
 
+#ifndef CONFIG_MTD_CONFIG_INDEX
 static int  mtdconfig_findfirstentry(FAR struct mtdconfig_struct_s *dev,
                                      FAR struct mtdconfig_header_s *phdr)
 {
@@ -409,6 +434,7 @@ static int  mtdconfig_findfirstentry(FAR struct mtdconfig_struct_s *dev,
 
   return offset;
 }
+#endif
 
 /****************************************************************************
  * Name: mtdconfig_findnextentry
@@ -420,6 +446,7 @@ static int  mtdconfig_findfirstentry(FAR struct mtdconfig_struct_s *dev,
  *
  ****************************************************************************/
 
+#ifndef CONFIG_MTD_CONFIG_INDEX
 static int  mtdconfig_findnextentry(FAR struct mtdconfig_struct_s *dev,
                                     off_t offset,
                                     FAR struct mtdconfig_header_s *phdr,
@@ -533,6 +560,7 @@ read_next:
 
   return offset;
 }
+#endif
 
 /****************************************************************************
  * Name: mtdconfig_ramconsolidate
@@ -899,6 +927,586 @@ errout:
 }
 #endif /* CONFIG_MTD_CONFIG_RAM_CONSOLIDATE */
 
+/****************************************************************************
+ * Name: mtdconfig_searchindex
+ *
+ *    Binary search of the RAM index.
+ *
+ * Returns:
+ *     The position of the item in the index or, if it is not in the
+ *     index, the position where it would be inserted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_CONFIG_INDEX
+static int mtdconfig_searchindex(FAR struct mtdconfig_struct_s *dev,
+                                 uint16_t id, uint8_t instance)
+{
+  uint32_t key = ((uint32_t)id << 8) | instance;
+  uint32_t midkey;
+  int low = 0;
+  int high = dev->nindex;
+  int mid;
+
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      midkey = ((uint32_t)dev->index[mid].id << 8) |
+               dev->index[mid].instance;
+
+      if (midkey < key)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return low;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_foundindex
+ *
+ *    Test if the item at position 'pos' of the index is the requested one.
+ *
+ ****************************************************************************/
+
+static bool mtdconfig_foundindex(FAR struct mtdconfig_struct_s *dev,
+                                 int pos, uint16_t id, uint8_t instance)
+{
+  return pos < dev->nindex && dev->index[pos].id == id &&
+         dev->index[pos].instance == instance;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_addindex
+ *
+ *    Insert an item into the RAM index at position 'pos'.
+ *
+ ****************************************************************************/
+
+static int mtdconfig_addindex(FAR struct mtdconfig_struct_s *dev, int pos,
+                              FAR struct mtdconfig_header_s *phdr,
+                              off_t offset)
+{
+  FAR struct mtdconfig_index_s *index;
+
+  if (dev->nindex >= dev->maxindex)
+    {
+      index = (FAR struct mtdconfig_index_s *)
+        kmm_realloc(dev->index, (dev->maxindex + MTDCONFIG_INDEX_INCR) *
+                    sizeof(struct mtdconfig_index_s));
+      if (index == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      dev->index     = index;
+      dev->maxindex += MTDCONFIG_INDEX_INCR;
+    }
+
+  memmove(&dev->index[pos + 1], &dev->index[pos],
+          (dev->nindex - pos) * sizeof(struct mtdconfig_index_s));
+
+  dev->index[pos].id       = phdr->id;
+  dev->index[pos].instance = phdr->instance;
+  dev->index[pos].len      = phdr->len;
+  dev->index[pos].offset   = offset;
+  dev->nindex++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_rmindex
+ *
+ *    Remove the item at position 'pos' from the RAM index.
+ *
+ ****************************************************************************/
+
+static void mtdconfig_rmindex(FAR struct mtdconfig_struct_s *dev, int pos)
+{
+  dev->nindex--;
+  memmove(&dev->index[pos], &dev->index[pos + 1],
+          (dev->nindex - pos) * sizeof(struct mtdconfig_index_s));
+}
+
+/****************************************************************************
+ * Name: mtdconfig_useentry
+ *
+ *    Update the free offset of an erase block after an entry of 'len'
+ *    data bytes has been placed at 'offset'.  As in
+ *    mtdconfig_findnextentry, a block with no room for another header is
+ *    full.
+ *
+ ****************************************************************************/
+
+static void mtdconfig_useentry(FAR struct mtdconfig_struct_s *dev,
+                               FAR off_t *freeoff, off_t offset,
+                               uint16_t len)
+{
+  uint16_t block = offset / dev->erasesize;
+
+  offset += sizeof(struct mtdconfig_header_s) + len;
+  if ((block + 1) * dev->erasesize - offset <=
+      sizeof(struct mtdconfig_header_s))
+    {
+      offset = 0;
+    }
+
+  freeoff[block] = offset;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_allocentry
+ *
+ *    Find space for an entry with 'len' data bytes in the first erase
+ *    block that has enough free space at its end.
+ *
+ * Returns:
+ *     offset of the new entry or zero if there is no space.
+ *
+ ****************************************************************************/
+
+static off_t mtdconfig_allocentry(FAR struct mtdconfig_struct_s *dev,
+                                  FAR off_t *freeoff, uint16_t len)
+{
+  uint16_t block;
+
+  for (block = 0; block < dev->endblock; block++)
+    {
+      if (freeoff[block] > 0 &&
+          (block + 1) * dev->erasesize - freeoff[block] >=
+          sizeof(struct mtdconfig_header_s) + len)
+        {
+          return freeoff[block];
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_buildindex
+ *
+ *    Scan all entry headers on the device and build the RAM index of the
+ *    active items and the free offset of each erase block.
+ *
+ ****************************************************************************/
+
+static int mtdconfig_buildindex(FAR struct mtdconfig_struct_s *dev)
+{
+  struct mtdconfig_header_s hdr;
+  uint8_t  sig[CONFIGDATA_BLOCK_HDR_SIZE];
+  uint16_t block;
+  off_t    offset;
+  off_t    end;
+  int      pos;
+  int      ret;
+
+  dev->nindex    = 0;
+  dev->formatted = false;
+  memset(dev->freeoff, 0, dev->neraseblocks * sizeof(off_t));
+
+#ifdef CONFIG_MTD_CONFIG_RAM_CONSOLIDATE
+  dev->endblock = dev->neraseblocks;
+#else
+  if (dev->neraseblocks == 1)
+    {
+      dev->endblock = 1;
+    }
+  else
+    {
+      dev->endblock = dev->neraseblocks - 1;
+    }
+#endif
+
+  /* Read the signature bytes */
+
+  ret = mtdconfig_readbytes(dev, 0, sig, sizeof(sig));
+  if (ret != OK || sig[0] != 'C' || sig[1] != 'D' ||
+      sig[2] != CONFIGDATA_FORMAT_VERSION)
+    {
+      /* Config Data partition not formatted. */
+
+      return OK;
+    }
+
+  dev->formatted = true;
+
+  for (block = 0; block < dev->endblock; block++)
+    {
+      offset = block * dev->erasesize + CONFIGDATA_BLOCK_HDR_SIZE;
+      end    = (block + 1) * dev->erasesize;
+
+      while (offset < end && end - offset > sizeof(hdr))
+        {
+          ret = mtdconfig_readbytes(dev, offset, (uint8_t *)&hdr,
+                                    sizeof(hdr));
+          if (ret != OK)
+            {
+              return ret;
+            }
+
+          if (hdr.flags == MTD_ERASED_FLAGS)
+            {
+              if (hdr.id == MTD_ERASED_ID)
+                {
+                  /* End of the entries in this erase block */
+
+                  dev->freeoff[block] = offset;
+                  break;
+                }
+
+              /* An active entry.  If there are duplicates, the first one
+               * is used (as by mtdconfig_findentry).
+               */
+
+              pos = mtdconfig_searchindex(dev, hdr.id, hdr.instance);
+              if (!mtdconfig_foundindex(dev, pos, hdr.id, hdr.instance))
+                {
+                  ret = mtdconfig_addindex(dev, pos, &hdr, offset);
+                  if (ret < 0)
+                    {
+                      return ret;
+                    }
+                }
+            }
+
+          offset += sizeof(hdr) + hdr.len;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_reclaim
+ *
+ *    Consolidate the released entries and rebuild the RAM index.
+ *
+ ****************************************************************************/
+
+static int mtdconfig_reclaim(FAR struct mtdconfig_struct_s *dev)
+{
+#ifndef CONFIG_MTD_CONFIG_RAM_CONSOLIDATE
+  if (dev->neraseblocks > 1)
+    {
+      mtdconfig_consolidate(dev);
+    }
+  else
+#endif
+    {
+      mtdconfig_ramconsolidate(dev);
+    }
+
+  return mtdconfig_buildindex(dev);
+}
+
+/****************************************************************************
+ * Name: mtdconfig_format
+ *
+ *    Erase the partition, write a format signature and rebuild the RAM
+ *    index.
+ *
+ ****************************************************************************/
+
+static int mtdconfig_format(FAR struct mtdconfig_struct_s *dev)
+{
+  uint8_t sig[CONFIGDATA_BLOCK_HDR_SIZE];
+  int ret;
+
+  ret = MTD_IOCTL(dev->mtd, MTDIOC_BULKERASE, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sig[0] = 'C';
+  sig[1] = 'D';
+  sig[2] = CONFIGDATA_FORMAT_VERSION;
+  mtdconfig_writebytes(dev, 0, sig, sizeof(sig));
+
+  ret = mtdconfig_buildindex(dev);
+  if (ret == OK && !dev->formatted)
+    {
+      ret = -ENOSYS;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_writeentry
+ *
+ *    Release any existing entry for the item and, unless the new length is
+ *    zero, write a new entry.  The RAM index is updated accordingly.
+ *
+ * Returns:
+ *     OK on success, -ENOSPC if there is no free space for the new entry.
+ *
+ ****************************************************************************/
+
+static int mtdconfig_writeentry(FAR struct mtdconfig_struct_s *dev,
+                                FAR struct config_data_s *pdata)
+{
+  struct mtdconfig_header_s hdr;
+  off_t offset;
+  int   bytes;
+  int   pos;
+
+  /* If the item is already in the database, we must mark it as obsolete
+   * before creating a new entry.
+   */
+
+  pos = mtdconfig_searchindex(dev, pdata->id, pdata->instance);
+  if (mtdconfig_foundindex(dev, pos, pdata->id, pdata->instance))
+    {
+      hdr.flags = (uint8_t)~MTD_ERASED_FLAGS;
+      mtdconfig_writebytes(dev, dev->index[pos].offset, &hdr.flags,
+                           sizeof(hdr.flags));
+      mtdconfig_rmindex(dev, pos);
+    }
+
+  /* Test if the new length is zero.  If it is, then we are deleting the
+   * entry.
+   */
+
+  if (pdata->len == 0)
+    {
+      return OK;
+    }
+
+  offset = mtdconfig_allocentry(dev, dev->freeoff, pdata->len);
+  if (offset == 0)
+    {
+      return -ENOSPC;
+    }
+
+  /* Save the data at this entry.  The space is used even if the write
+   * fails.
+   */
+
+  hdr.id       = pdata->id;
+  hdr.instance = pdata->instance;
+  hdr.len      = pdata->len;
+  hdr.flags    = MTD_ERASED_FLAGS;
+
+  mtdconfig_useentry(dev, dev->freeoff, offset, hdr.len);
+  mtdconfig_writebytes(dev, offset, (uint8_t *)&hdr, sizeof(hdr));
+  bytes = mtdconfig_writebytes(dev, offset + sizeof(hdr), pdata->configdata,
+                               pdata->len);
+  if (bytes != pdata->len)
+    {
+      /* Error writing data! */
+
+      hdr.flags = (uint8_t)~MTD_ERASED_FLAGS;
+      mtdconfig_writebytes(dev, offset, &hdr.flags, sizeof(hdr.flags));
+      return -EIO;
+    }
+
+  return mtdconfig_addindex(dev, pos, &hdr, offset);
+}
+
+/****************************************************************************
+ * Name: mtdconfig_reserve
+ *
+ *    Test if all of the non-empty items fit into the free space, without
+ *    writing anything.
+ *
+ ****************************************************************************/
+
+static int mtdconfig_reserve(FAR struct mtdconfig_struct_s *dev,
+                             FAR struct config_data_s *items, size_t nitems)
+{
+  FAR off_t *freeoff;
+  off_t offset;
+  size_t i;
+  int ret = OK;
+
+  freeoff = (FAR off_t *)kmm_malloc(dev->neraseblocks * sizeof(off_t));
+  if (freeoff == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(freeoff, dev->freeoff, dev->neraseblocks * sizeof(off_t));
+
+  for (i = 0; i < nitems; i++)
+    {
+      if (items[i].len > 0)
+        {
+          offset = mtdconfig_allocentry(dev, freeoff, items[i].len);
+          if (offset == 0)
+            {
+              ret = -ENOSPC;
+              break;
+            }
+
+          mtdconfig_useentry(dev, freeoff, offset, items[i].len);
+        }
+    }
+
+  kmm_free(freeoff);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_setconfig
+ ****************************************************************************/
+
+static int mtdconfig_setconfig(FAR struct mtdconfig_struct_s *dev,
+                               FAR struct config_data_s *pdata)
+{
+  int ret;
+
+  if (!dev->formatted)
+    {
+      /* Try to format the config partition */
+
+      ret = mtdconfig_format(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = mtdconfig_writeentry(dev, pdata);
+  if (ret == -ENOSPC)
+    {
+      /* No free entries left on device!  The old entry, if any, has been
+       * released so that it is also reclaimed.
+       */
+
+      ret = mtdconfig_reclaim(dev);
+      if (ret == OK)
+        {
+          ret = mtdconfig_writeentry(dev, pdata);
+        }
+    }
+
+  return ret == -ENOSPC ? -ENOMEM : ret;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_setconfigs
+ ****************************************************************************/
+
+static int mtdconfig_setconfigs(FAR struct mtdconfig_struct_s *dev,
+                                FAR struct config_batch_s *batch)
+{
+  size_t i;
+  int ret;
+
+  if (!dev->formatted)
+    {
+      /* Try to format the config partition */
+
+      ret = mtdconfig_format(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Make sure that all of the items fit before writing anything.
+   * Consolidate at most once.
+   */
+
+  ret = mtdconfig_reserve(dev, batch->items, batch->nitems);
+  if (ret == -ENOSPC)
+    {
+      ret = mtdconfig_reclaim(dev);
+      if (ret == OK)
+        {
+          ret = mtdconfig_reserve(dev, batch->items, batch->nitems);
+        }
+    }
+
+  if (ret < 0)
+    {
+      return ret == -ENOSPC ? -ENOMEM : ret;
+    }
+
+  /* Then write all of the items in one pass */
+
+  for (i = 0; i < batch->nitems; i++)
+    {
+      ret = mtdconfig_writeentry(dev, &batch->items[i]);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_getconfig
+ ****************************************************************************/
+
+static int mtdconfig_getconfig(FAR struct mtdconfig_struct_s *dev,
+                               FAR struct config_data_s *pdata)
+{
+  off_t bytes_to_read;
+  int   pos;
+  int   ret;
+
+  pos = mtdconfig_searchindex(dev, pdata->id, pdata->instance);
+  if (!mtdconfig_foundindex(dev, pos, pdata->id, pdata->instance))
+    {
+      return -ENOSYS;
+    }
+
+  /* Entry found.  Read the data */
+
+  bytes_to_read = dev->index[pos].len;
+  if (bytes_to_read > pdata->len)
+    {
+      bytes_to_read = pdata->len;
+    }
+
+  ret = mtdconfig_readbytes(dev, dev->index[pos].offset +
+                            sizeof(struct mtdconfig_header_s),
+                            pdata->configdata, bytes_to_read);
+  return ret != OK ? -EIO : OK;
+}
+
+/****************************************************************************
+ * Name: mtdconfig_freeindex
+ *
+ *    Free the RAM index and the temp block buffer.
+ *
+ ****************************************************************************/
+
+static void mtdconfig_freeindex(FAR struct mtdconfig_struct_s *dev)
+{
+  if (dev->index != NULL)
+    {
+      kmm_free(dev->index);
+    }
+
+  if (dev->freeoff != NULL)
+    {
+      kmm_free(dev->freeoff);
+    }
+
+  if (dev->buffer != NULL)
+    {
+      kmm_free(dev->buffer);
+    }
+
+  dev->index    = NULL;
+  dev->freeoff  = NULL;
+  dev->buffer   = NULL;
+  dev->nindex   = 0;
+  dev->maxindex = 0;
+}
+#endif /* CONFIG_MTD_CONFIG_INDEX */
+
 /****************************************************************************
  * Name: mtdconfig_open
  ****************************************************************************/
@@ -920,6 +1528,32 @@ static int  mtdconfig_open(FAR struct file *filep)
 
   dev->readoff = 0;
 
+#ifdef CONFIG_MTD_CONFIG_INDEX
+  /* Allocate a temp block buffer and build the RAM index.  Both are kept
+   * until the device is closed.
+   */
+
+  dev->buffer  = (FAR uint8_t *)kmm_malloc(dev->blocksize);
+  dev->freeoff = (FAR off_t *)kmm_malloc(dev->neraseblocks * sizeof(off_t));
+  if (dev->buffer == NULL || dev->freeoff == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_index;
+    }
+
+  ret = mtdconfig_buildindex(dev);
+  if (ret < 0)
+    {
+      goto errout_with_index;
+    }
+
+  return OK;
+
+errout_with_index:
+  mtdconfig_freeindex(dev);
+  sem_post(&dev->exclsem);
+#endif
+
 errout:
   return ret;
 }
@@ -933,6 +1567,10 @@ static int  mtdconfig_close(FAR struct file *filep)
   FAR struct inode *inode = filep->f_inode;
   FAR struct mtdconfig_struct_s *dev = inode->i_private;
 
+#ifdef CONFIG_MTD_CONFIG_INDEX
+  mtdconfig_freeindex(dev);
+#endif
+
   /* Release exclusive access to the device */
 
   sem_post(&dev->exclsem);
@@ -966,6 +1604,7 @@ static ssize_t mtdconfig_read(FAR struct file *filep, FAR char *buffer,
  * Name: mtdconfig_findentry
  ****************************************************************************/
 
+#ifndef CONFIG_MTD_CONFIG_INDEX
 static int mtdconfig_findentry(FAR struct mtdconfig_struct_s *dev,
                                off_t offset,
                                FAR struct config_data_s *pdata,
@@ -1266,6 +1905,7 @@ errout:
   kmm_free(dev->buffer);
   return ret;
 }
+#endif /* !CONFIG_MTD_CONFIG_INDEX */
 
 /****************************************************************************
  * Name: mtdconfig_ioctl
@@ -1277,6 +1917,10 @@ static int mtdconfig_ioctl(FAR struct file *filep, int cmd,
   FAR struct inode *inode = filep->f_inode;
   FAR struct mtdconfig_struct_s *dev = inode->i_private;
   FAR struct config_data_s *pdata;
+  FAR struct config_batch_s *batch;
+#ifndef CONFIG_MTD_CONFIG_INDEX
+  size_t i;
+#endif
   int   ret = -ENOSYS;
 
   switch (cmd)
@@ -1296,6 +1940,21 @@ static int mtdconfig_ioctl(FAR struct file *filep, int cmd,
         pdata = (FAR struct config_data_s *)arg;
         ret = mtdconfig_getconfig(dev, pdata);
         break;
+
+      case CFGDIOC_SETCONFIGS:
+
+        /* Set several config items */
+
+        batch = (FAR struct config_batch_s *)arg;
+#ifdef CONFIG_MTD_CONFIG_INDEX
+        ret = mtdconfig_setconfigs(dev, batch);
+#else
+        for (i = 0, ret = OK; i < batch->nitems && ret == OK; i++)
+          {
+            ret = mtdconfig_setconfig(dev, &batch->items[i]);
+          }
+#endif
+        break;
     }
 
   return ret;
@@ -1340,7 +1999,7 @@ int mtdconfig_register(FAR struct mtd_dev_s *mtd)
   struct mtdconfig_struct_s *dev;
   struct mtd_geometry_s geo;      /* Device geometry */
 
-  dev = (struct mtdconfig_struct_s *)kmm_malloc(sizeof(struct mtdconfig_struct_s));
+  dev = (struct mtdconfig_struct_s *)kmm_zalloc(sizeof(struct mtdconfig_struct_s));
   if (dev)
     {
       /* Initialize the mtdconfig device structure */
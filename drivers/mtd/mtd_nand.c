@@ -63,6 +63,7 @@
 #include <nuttx/mtd/nand_scheme.h>
 #include <nuttx/mtd/nand_model.h>
 #include <nuttx/mtd/nand_ecc.h>
+#include <nuttx/mtd/nand_bch.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -969,6 +970,58 @@ FAR struct mtd_dev_s *nand_initialize(FAR struct nand_raw_s *raw)
 
   sem_init(&nand->exclsem, 0, 1);
 
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  /* The BCH ECC does not fit in the spare area placement schemes of the
+   * NAND models.  Build a scheme that places it at the end of the spare
+   * area.
+   */
+
+  if (raw->ecctype == NANDECC_SWECC)
+    {
+      FAR struct nand_model_s *model = &raw->model;
+      unsigned int pagesize = nandmodel_getpagesize(model);
+
+      ret = nandbch_initialize();
+      if (ret >= 0)
+        {
+          ret = -EINVAL;
+          if ((pagesize % NANDBCH_STEPSIZE) == 0)
+            {
+              ret = nandscheme_buildbch(&nand->scheme, model->scheme,
+                                        nandmodel_getsparesize(model),
+                                        nandbch_eccsize(pagesize));
+            }
+        }
+
+      if (ret < 0)
+        {
+          fdbg("ERROR: No BCH ECC for page size %u: %d\n", pagesize, ret);
+          sem_destroy(&nand->exclsem);
+          kmm_free(nand);
+          return NULL;
+        }
+
+      model->scheme = &nand->scheme;
+    }
+#endif
+
+#ifdef CONFIG_MTD_NAND_ECCTEST
+  /* Test the software ECC on a RAM model of the device */
+
+  if (raw->ecctype == NANDECC_SWECC)
+    {
+      ret = nandecc_test(&raw->model);
+      if (ret < 0)
+        {
+          fdbg("ERROR: NAND ECC test failed: %d\n", ret);
+        }
+      else
+        {
+          fvdbg("NAND ECC test OK\n");
+        }
+    }
+#endif
+
   /* Scan the device for bad blocks */
 
   (void)nand_devscan(nand);
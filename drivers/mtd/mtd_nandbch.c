@@ -0,0 +1,691 @@
+/****************************************************************************
+ * drivers/mtd/mtd_nandbch.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/mtd/nand_config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mtd/nand_bch.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* GF(2^13) is generated by the primitive polynomial x^13 + x^4 + x^3 + x + 1.
+ * Its multiplicative group has BCH_N elements.
+ */
+
+#define BCH_POLY        0x201b
+#define BCH_N           ((1 << NANDBCH_M) - 1)
+
+/* Remainders of the division by the generator polynomial are kept in an
+ * array of BCH_NWORDS 32-bit words.  The coefficient of x^(ECCBITS-1) is in
+ * bit 31 of the first word, followed by the lower order coefficients.  The
+ * unused bits at the end of the last word are always zero.
+ */
+
+#define BCH_NWORDS      ((NANDBCH_ECCBITS + 31) / 32)
+
+/* Number of bits in one codeword:  The data of one step followed by the
+ * ECC.  The first data bit is the coefficient of the highest order.
+ */
+
+#define BCH_CODEBITS    (8 * NANDBCH_STEPSIZE + NANDBCH_ECCBITS)
+
+/* Mask of the ECC bits in the last byte of the code */
+
+#define BCH_LASTMASK    ((uint8_t)(0xff << (8 * NANDBCH_ECCBYTES - \
+                                            NANDBCH_ECCBITS)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nandbch_s
+{
+  FAR uint16_t *alphato;           /* alpha^i, i = 0..BCH_N-1 */
+  FAR uint16_t *indexof;           /* log(x), x = 1..BCH_N */
+  FAR uint32_t *enctab;            /* Remainders of v(x) * x^ECCBITS */
+  uint32_t genpoly[BCH_NWORDS];    /* Generator less its x^ECCBITS term */
+  uint8_t erased[NANDBCH_ECCBYTES];  /* Code of an erased step xor'ed 0xff */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct nandbch_s g_nandbch;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandbch_mul
+ *
+ * Description:
+ *   Multiply a field element by alpha^e
+ *
+ ****************************************************************************/
+
+static inline uint16_t nandbch_mul(uint16_t a, unsigned int e)
+{
+  if (a == 0)
+    {
+      return 0;
+    }
+
+  return g_nandbch.alphato[(g_nandbch.indexof[a] + e) % BCH_N];
+}
+
+/****************************************************************************
+ * Name: nandbch_shiftbit
+ *
+ * Description:
+ *   Shift one message bit into the remainder.  This is only used to build
+ *   the tables.
+ *
+ ****************************************************************************/
+
+static void nandbch_shiftbit(FAR uint32_t *rem, unsigned int bit)
+{
+  unsigned int feedback = (rem[0] >> 31) ^ bit;
+  int i;
+
+  for (i = 0; i < BCH_NWORDS - 1; i++)
+    {
+      rem[i] = (rem[i] << 1) | (rem[i + 1] >> 31);
+    }
+
+  rem[BCH_NWORDS - 1] <<= 1;
+
+  if (feedback != 0)
+    {
+      for (i = 0; i < BCH_NWORDS; i++)
+        {
+          rem[i] ^= g_nandbch.genpoly[i];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nandbch_encode
+ *
+ * Description:
+ *   Shift a block of message bytes into the remainder, one byte at a time:
+ *   The top 8 bits of the remainder xor'ed with the message byte select the
+ *   remainder of that byte value times x^ECCBITS, which is added to the
+ *   remaining bits of the remainder shifted up by 8.
+ *
+ ****************************************************************************/
+
+static void nandbch_encode(FAR const uint8_t *data, size_t size,
+                           FAR uint32_t *rem)
+{
+  FAR const uint32_t *tab;
+  int i;
+
+  while (size-- > 0)
+    {
+      tab = &g_nandbch.enctab[((rem[0] >> 24) ^ *data++) * BCH_NWORDS];
+
+      for (i = 0; i < BCH_NWORDS - 1; i++)
+        {
+          rem[i] = ((rem[i] << 8) | (rem[i + 1] >> 24)) ^ tab[i];
+        }
+
+      rem[BCH_NWORDS - 1] = (rem[BCH_NWORDS - 1] << 8) ^ tab[i];
+    }
+}
+
+/****************************************************************************
+ * Name: nandbch_step
+ *
+ * Description:
+ *   Return the remainder of one step of data
+ *
+ ****************************************************************************/
+
+static void nandbch_step(FAR const uint8_t *data, FAR uint32_t *rem)
+{
+  memset(rem, 0, BCH_NWORDS * sizeof(uint32_t));
+  nandbch_encode(data, NANDBCH_STEPSIZE, rem);
+}
+
+/****************************************************************************
+ * Name: nandbch_pack
+ *
+ * Description:
+ *   Convert a remainder to the ECC bytes written to FLASH.  The code is
+ *   xor'ed with the code of an erased step (and with 0xff) so that erased
+ *   pages verify without errors.
+ *
+ ****************************************************************************/
+
+static void nandbch_pack(FAR const uint32_t *rem, FAR uint8_t *code)
+{
+  int i;
+
+  for (i = 0; i < NANDBCH_ECCBYTES; i++)
+    {
+      code[i] = (uint8_t)(rem[i >> 2] >> (24 - 8 * (i & 3))) ^
+                g_nandbch.erased[i];
+    }
+}
+
+/****************************************************************************
+ * Name: nandbch_unpack
+ *
+ * Description:
+ *   Convert the ECC bytes read from FLASH back to a remainder.  This is the
+ *   inverse of nandbch_pack().
+ *
+ ****************************************************************************/
+
+static void nandbch_unpack(FAR const uint8_t *code, FAR uint32_t *rem)
+{
+  uint8_t byte;
+  int i;
+
+  memset(rem, 0, BCH_NWORDS * sizeof(uint32_t));
+
+  for (i = 0; i < NANDBCH_ECCBYTES; i++)
+    {
+      byte = code[i] ^ g_nandbch.erased[i];
+      if (i == NANDBCH_ECCBYTES - 1)
+        {
+          byte &= BCH_LASTMASK;
+        }
+
+      rem[i >> 2] |= (uint32_t)byte << (24 - 8 * (i & 3));
+    }
+}
+
+/****************************************************************************
+ * Name: nandbch_correct
+ *
+ * Description:
+ *   Verify and correct one step of data.
+ *
+ *   The remainder of the received data plus the received ECC is the
+ *   remainder of the error polynomial e(x).  Since the generator has the
+ *   roots alpha^1..alpha^2T, the syndromes S(i) = e(alpha^i) are found
+ *   from that remainder alone.  The error locator polynomial is found from
+ *   the syndromes with the Berlekamp-Massey algorithm and its roots, the
+ *   inverse of the error locations, are found by a Chien search.
+ *
+ * Returned Values:
+ *   The number of bit errors corrected or -EBADMSG.
+ *
+ ****************************************************************************/
+
+static int nandbch_correct(FAR uint8_t *data, FAR const uint8_t *code)
+{
+  FAR const uint16_t *alphato = g_nandbch.alphato;
+  FAR const uint16_t *indexof = g_nandbch.indexof;
+  uint32_t rem[BCH_NWORDS];
+  uint32_t ecc[BCH_NWORDS];
+  uint32_t diff;
+  uint16_t syn[2 * NANDBCH_T + 1];
+  uint16_t lambda[2 * NANDBCH_T + 1];
+  uint16_t prev[2 * NANDBCH_T + 1];
+  uint16_t save[2 * NANDBCH_T + 1];
+  int term[NANDBCH_T + 1];
+  uint16_t loc[NANDBCH_T];
+  uint16_t disc;
+  uint16_t b;
+  uint16_t sum;
+  unsigned int coef;
+  int nroots;
+  int len;
+  int m;
+  int n;
+  int i;
+  int d;
+
+  /* Compute the remainder of the received codeword */
+
+  nandbch_step(data, rem);
+  nandbch_unpack(code, ecc);
+
+  for (diff = 0, i = 0; i < BCH_NWORDS; i++)
+    {
+      rem[i] ^= ecc[i];
+      diff   |= rem[i];
+    }
+
+  if (diff == 0)
+    {
+      return 0;
+    }
+
+  /* Compute the syndromes.  The even syndromes are the squares of the
+   * syndromes of half the index.
+   */
+
+  memset(syn, 0, sizeof(syn));
+
+  for (d = 0; d < NANDBCH_ECCBITS; d++)
+    {
+      n = NANDBCH_ECCBITS - 1 - d;
+      if ((rem[n >> 5] & ((uint32_t)1 << (31 - (n & 31)))) != 0)
+        {
+          for (i = 1; i < 2 * NANDBCH_T; i += 2)
+            {
+              syn[i] ^= alphato[(i * d) % BCH_N];
+            }
+        }
+    }
+
+  for (i = 2; i <= 2 * NANDBCH_T; i += 2)
+    {
+      syn[i] = nandbch_mul(syn[i >> 1], indexof[syn[i >> 1]]);
+    }
+
+  /* Berlekamp-Massey */
+
+  memset(lambda, 0, sizeof(lambda));
+  memset(prev, 0, sizeof(prev));
+  lambda[0] = 1;
+  prev[0]   = 1;
+  len       = 0;
+  m         = 1;
+  b         = 1;
+
+  for (n = 0; n < 2 * NANDBCH_T; n++)
+    {
+      disc = syn[n + 1];
+      for (i = 1; i <= len; i++)
+        {
+          if (lambda[i] != 0)
+            {
+              disc ^= nandbch_mul(syn[n + 1 - i], indexof[lambda[i]]);
+            }
+        }
+
+      if (disc == 0)
+        {
+          m++;
+          continue;
+        }
+
+      /* lambda(x) -= (disc / b) * x^m * prev(x) */
+
+      coef = (indexof[disc] + BCH_N - indexof[b]) % BCH_N;
+      memcpy(save, lambda, sizeof(lambda));
+
+      for (i = m; i <= 2 * NANDBCH_T; i++)
+        {
+          lambda[i] ^= nandbch_mul(prev[i - m], coef);
+        }
+
+      if (2 * len <= n)
+        {
+          len = n + 1 - len;
+          memcpy(prev, save, sizeof(prev));
+          b = disc;
+          m = 1;
+        }
+      else
+        {
+          m++;
+        }
+    }
+
+  if (len > NANDBCH_T)
+    {
+      fdbg("ERROR: Too many bit errors\n");
+      return -EBADMSG;
+    }
+
+  /* Chien search:  Evaluate lambda at alpha^-d for every bit position d of
+   * the codeword.  term[i] is the log of the i-th term at alpha^-d.
+   */
+
+  for (i = 1; i <= len; i++)
+    {
+      term[i] = lambda[i] != 0 ? indexof[lambda[i]] : -1;
+    }
+
+  nroots = 0;
+  for (d = 0; d < BCH_CODEBITS && nroots < len; d++)
+    {
+      sum = 1;
+      for (i = 1; i <= len; i++)
+        {
+          if (term[i] >= 0)
+            {
+              sum     ^= alphato[term[i]];
+              term[i] -= i;
+              if (term[i] < 0)
+                {
+                  term[i] += BCH_N;
+                }
+            }
+        }
+
+      if (sum == 0)
+        {
+          loc[nroots++] = d;
+        }
+    }
+
+  if (nroots != len)
+    {
+      fdbg("ERROR: Uncorrectable bit errors\n");
+      return -EBADMSG;
+    }
+
+  /* Correct the errors in the data.  Errors in the ECC bits need no
+   * correction.
+   */
+
+  for (i = 0; i < nroots; i++)
+    {
+      if (loc[i] >= NANDBCH_ECCBITS)
+        {
+          n = BCH_CODEBITS - 1 - loc[i];
+          fvdbg("Correcting byte %d at bit %d\n", n >> 3, 7 - (n & 7));
+          data[n >> 3] ^= 0x80 >> (n & 7);
+        }
+    }
+
+  return nroots;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandbch_initialize
+ *
+ * Description:
+ *   Allocate and build the Galois field and encoder tables.  This must be
+ *   called before nandbch_compute() or nandbch_verify() is used.  Calling
+ *   it again has no effect.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Values:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nandbch_initialize(void)
+{
+  uint16_t genpoly[NANDBCH_ECCBITS + 1];
+  uint32_t rem[BCH_NWORDS];
+  unsigned int root;
+  unsigned int x;
+  int deg;
+  int i;
+  int j;
+
+  if (g_nandbch.enctab != NULL)
+    {
+      return OK;
+    }
+
+  /* Allocate the tables.  The log table shares the allocation with the
+   * exponent table.
+   */
+
+  g_nandbch.alphato = (FAR uint16_t *)
+    kmm_malloc(2 * (BCH_N + 1) * sizeof(uint16_t));
+  g_nandbch.enctab  = (FAR uint32_t *)
+    kmm_malloc(256 * BCH_NWORDS * sizeof(uint32_t));
+
+  if (g_nandbch.alphato == NULL || g_nandbch.enctab == NULL)
+    {
+      fdbg("ERROR: Failed to allocate BCH tables\n");
+
+      if (g_nandbch.alphato != NULL)
+        {
+          kmm_free(g_nandbch.alphato);
+          g_nandbch.alphato = NULL;
+        }
+
+      if (g_nandbch.enctab != NULL)
+        {
+          kmm_free(g_nandbch.enctab);
+          g_nandbch.enctab = NULL;
+        }
+
+      return -ENOMEM;
+    }
+
+  g_nandbch.indexof = &g_nandbch.alphato[BCH_N + 1];
+
+  /* Build the field */
+
+  for (x = 1, i = 0; i < BCH_N; i++)
+    {
+      g_nandbch.alphato[i] = x;
+      g_nandbch.indexof[x] = i;
+
+      x <<= 1;
+      if ((x & (1 << NANDBCH_M)) != 0)
+        {
+          x ^= BCH_POLY;
+        }
+    }
+
+  g_nandbch.alphato[BCH_N] = 1;
+  g_nandbch.indexof[0]     = 0;
+
+  /* The generator polynomial is the product of the minimal polynomials of
+   * alpha^1, alpha^3, ... alpha^(2T-1).  The roots of the minimal
+   * polynomial of alpha^i are alpha^(i * 2^k).
+   */
+
+  memset(genpoly, 0, sizeof(genpoly));
+  genpoly[0] = 1;
+  deg        = 0;
+
+  for (i = 1; i < 2 * NANDBCH_T; i += 2)
+    {
+      root = i;
+      do
+        {
+          /* Multiply by (x + alpha^root) */
+
+          DEBUGASSERT(deg < NANDBCH_ECCBITS);
+
+          genpoly[deg + 1] = genpoly[deg];
+          for (j = deg; j > 0; j--)
+            {
+              genpoly[j] = genpoly[j - 1] ^ nandbch_mul(genpoly[j], root);
+            }
+
+          genpoly[0] = nandbch_mul(genpoly[0], root);
+          deg++;
+
+          root = (2 * root) % BCH_N;
+        }
+      while (root != i);
+    }
+
+  DEBUGASSERT(deg == NANDBCH_ECCBITS);
+
+  memset(g_nandbch.genpoly, 0, sizeof(g_nandbch.genpoly));
+  for (i = 0; i < NANDBCH_ECCBITS; i++)
+    {
+      if (genpoly[i] != 0)
+        {
+          j = NANDBCH_ECCBITS - 1 - i;
+          g_nandbch.genpoly[j >> 5] |= (uint32_t)1 << (31 - (j & 31));
+        }
+    }
+
+  /* Build the table of the remainders of each byte value times
+   * x^ECCBITS.
+   */
+
+  for (i = 0; i < 256; i++)
+    {
+      memset(rem, 0, sizeof(rem));
+      for (j = 7; j >= 0; j--)
+        {
+          nandbch_shiftbit(rem, (i >> j) & 1);
+        }
+
+      memcpy(&g_nandbch.enctab[i * BCH_NWORDS], rem, sizeof(rem));
+    }
+
+  /* Get the code of an erased step */
+
+  memset(rem, 0, sizeof(rem));
+  memset(g_nandbch.erased, 0, NANDBCH_ECCBYTES);
+
+  for (i = 0; i < NANDBCH_STEPSIZE; i++)
+    {
+      uint8_t erased = 0xff;
+      nandbch_encode(&erased, 1, rem);
+    }
+
+  nandbch_pack(rem, g_nandbch.erased);
+  for (i = 0; i < NANDBCH_ECCBYTES; i++)
+    {
+      g_nandbch.erased[i] ^= 0xff;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nandbch_compute
+ *
+ * Description:
+ *   Computes the BCH codes for a data block whose size is multiple of
+ *   NANDBCH_STEPSIZE bytes.  Each step gets its own NANDBCH_ECCBYTES code.
+ *   The codes of an erased (all 0xff) step are all 0xff.
+ *
+ * Input Parameters:
+ *   data - Data to compute code for
+ *   size - Data size in bytes
+ *   code - Codes buffer
+ *
+ * Returned Values:
+ *   None
+ *
+ ****************************************************************************/
+
+void nandbch_compute(FAR const uint8_t *data, size_t size,
+                     FAR uint8_t *code)
+{
+  uint32_t rem[BCH_NWORDS];
+  ssize_t remaining = (ssize_t)size;
+
+  DEBUGASSERT(g_nandbch.enctab != NULL &&
+              (size % NANDBCH_STEPSIZE) == 0);
+
+  /* Loop, computing the BCH code on each step of data */
+
+  while (remaining > 0)
+    {
+      nandbch_step(data, rem);
+      nandbch_pack(rem, code);
+
+      /* Setup for the next step */
+
+      data      += NANDBCH_STEPSIZE;
+      code      += NANDBCH_ECCBYTES;
+      remaining -= NANDBCH_STEPSIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: nandbch_verify
+ *
+ * Description:
+ *   Verifies the BCH codes for a data block whose size is multiple of
+ *   NANDBCH_STEPSIZE bytes and corrects the data if possible.
+ *
+ * Input Parameters:
+ *   data - Data buffer to verify
+ *   size - Size of the data in bytes
+ *   code - Original codes
+ *
+ * Returned Values:
+ *   The number of bit errors that were corrected (zero if the data is
+ *   correct) or -EBADMSG if some step has more errors than can be
+ *   corrected.
+ *
+ ****************************************************************************/
+
+int nandbch_verify(FAR uint8_t *data, size_t size, FAR const uint8_t *code)
+{
+  ssize_t remaining = (ssize_t)size;
+  int corrected = 0;
+  int ret;
+
+  DEBUGASSERT(g_nandbch.enctab != NULL &&
+              (size % NANDBCH_STEPSIZE) == 0);
+
+  /* Loop, verifying each step of data */
+
+  while (remaining > 0)
+    {
+      ret = nandbch_correct(data, code);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      corrected += ret;
+
+      /* Setup for the next step */
+
+      data      += NANDBCH_STEPSIZE;
+      code      += NANDBCH_ECCBYTES;
+      remaining -= NANDBCH_STEPSIZE;
+    }
+
+  return corrected;
+}
@@ -55,6 +55,7 @@
 
 #include <nuttx/mtd/nand.h>
 #include <nuttx/mtd/hamming.h>
+#include <nuttx/mtd/nand_bch.h>
 #include <nuttx/mtd/nand_scheme.h>
 #include <nuttx/mtd/nand_ecc.h>
 
@@ -145,8 +146,13 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
 
   /* Use the ECC data to verify the page */
 
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  ret = nandbch_verify(data, pagesize, raw->ecc);
+  if (ret < 0)
+#else
   ret = hamming_verify256x(data, pagesize, raw->ecc);
   if (ret && (ret != HAMMING_ERROR_SINGLEBIT))
+#endif
     {
       fdbg("ERROR: Block=%d page=%d Unrecoverable error: %d\n",
            block, page, ret);
@@ -202,7 +208,7 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
   pagesize  = nandmodel_getpagesize(model);
   sparesize = nandmodel_getsparesize(model);
 
-  /* Set hamming code set to 0xffff.. to keep existing bytes */
+  /* Set the ECC to 0xffff.. to keep existing bytes */
 
   memset(raw->ecc, 0xff, CONFIG_MTD_NAND_MAXSPAREECCBYTES);
 
@@ -210,9 +216,13 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 
   if (data)
     {
-      /* Compute hamming code on data */
+      /* Compute the ECC on data */
 
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+      nandbch_compute(data, pagesize, raw->ecc);
+#else
       hamming_compute256x(data, pagesize, raw->ecc);
+#endif
     }
 
   /* Store code in spare buffer, either the buffer provided by the caller or
@@ -0,0 +1,1162 @@
+/****************************************************************************
+ * drivers/mtd/mtd_nandecctest.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * The reference Hamming code is the original, bit-by-bit implementation
+ * that was taken from Atmel sample code.  The Atmel sample code has a BSD
+ * compatible license that requires this copyright notice:
+ *
+ *   Copyright (c) 2011, Atmel Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the names NuttX nor Atmel nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/mtd/nand_config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mtd/nand.h>
+#include <nuttx/mtd/nand_raw.h>
+#include <nuttx/mtd/nand_model.h>
+#include <nuttx/mtd/nand_scheme.h>
+#include <nuttx/mtd/nand_ecc.h>
+#include <nuttx/mtd/hamming.h>
+#include <nuttx/mtd/nand_bch.h>
+
+#ifdef CONFIG_MTD_NAND_ECCTEST
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the data protected by one ECC code, size of that code, number of
+ * bits of the code that are checked, and the number of bit errors that can
+ * be corrected in it.
+ */
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+#  define ECCTEST_STEPSIZE  NANDBCH_STEPSIZE
+#  define ECCTEST_ECCBYTES  NANDBCH_ECCBYTES
+#  define ECCTEST_ECCBITS   NANDBCH_ECCBITS
+#  define ECCTEST_T         NANDBCH_T
+
+/* The primitive polynomial of GF(2^13) and its number of non-zero
+ * elements.
+ */
+
+#  define ECCTEST_BCHPOLY   0x201b
+#  define ECCTEST_BCHN      ((1 << NANDBCH_M) - 1)
+#else
+#  define ECCTEST_STEPSIZE  256
+#  define ECCTEST_ECCBYTES  3
+#  define ECCTEST_ECCBITS   24
+#  define ECCTEST_T         1
+#endif
+
+#define ECCTEST_STEPBITS    (8 * ECCTEST_STEPSIZE)
+
+/* Number of pages in the RAM model of the NAND.  The last page is left
+ * erased.
+ */
+
+#define ECCTEST_NPAGES      4
+
+/* Number of times that the pages are encoded to measure the throughput */
+
+#define ECCTEST_LOOPS       4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* RAM model of one block of a NAND device.  The raw NAND interface must
+ * be the first member so that the lower-half methods can recover the
+ * model from it.
+ */
+
+struct ecctest_ram_s
+{
+  struct nand_raw_s raw;       /* Lower-half, raw NAND interface */
+  FAR uint8_t *data;           /* Data areas of the pages */
+  FAR uint8_t *spare;          /* Spare areas of the pages */
+};
+
+struct ecctest_s
+{
+  struct ecctest_ram_s ram;    /* RAM model of the NAND */
+  struct nand_dev_s nand;      /* Upper half used by nandecc_*page() */
+  unsigned int pagesize;       /* Size of the data area of a page */
+  unsigned int sparesize;      /* Size of the spare area of a page */
+  unsigned int eccsize;        /* Number of ECC bytes for one page */
+  uint32_t seed;               /* Random number generator state */
+  int miscorrected;            /* Uncorrectable steps that were 'corrected' */
+  FAR uint8_t *orig;           /* Original contents of the pages */
+  FAR uint8_t *saved;          /* Original spare areas of the pages */
+  FAR uint8_t *work;           /* Page buffer */
+  FAR uint8_t *refwork;        /* Step buffer for the reference code */
+  uint8_t code[CONFIG_MTD_NAND_MAXSPAREECCBYTES];
+  uint8_t refcode[CONFIG_MTD_NAND_MAXSPAREECCBYTES];
+  uint8_t wcode[ECCTEST_ECCBYTES];
+  uint8_t rcode[ECCTEST_ECCBYTES];
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  uint8_t genpoly[ECCTEST_ECCBITS];  /* Generator less its x^ECCBITS term */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ecctest_random
+ *
+ * Description:
+ *   A simple linear congruential generator.  The test must be repeatable,
+ *   so the C library rand() is not used.
+ *
+ ****************************************************************************/
+
+static unsigned int ecctest_random(FAR struct ecctest_s *priv)
+{
+  priv->seed = priv->seed * 1103515245 + 12345;
+  return (unsigned int)(priv->seed >> 8);
+}
+
+/****************************************************************************
+ * Name: ecctest_eraseblock, ecctest_rawread, and ecctest_rawwrite
+ *
+ * Description:
+ *   Lower-half methods of the RAM model of the NAND.  Programming can only
+ *   clear bits, like on the real device.
+ *
+ ****************************************************************************/
+
+static int ecctest_eraseblock(FAR struct nand_raw_s *raw, off_t block)
+{
+  FAR struct ecctest_ram_s *ram = (FAR struct ecctest_ram_s *)raw;
+  FAR struct nand_model_s *model = &raw->model;
+
+  memset(ram->data, 0xff, ECCTEST_NPAGES * nandmodel_getpagesize(model));
+  memset(ram->spare, 0xff, ECCTEST_NPAGES * nandmodel_getsparesize(model));
+  return OK;
+}
+
+static int ecctest_rawread(FAR struct nand_raw_s *raw, off_t block,
+                           unsigned int page, FAR void *data,
+                           FAR void *spare)
+{
+  FAR struct ecctest_ram_s *ram = (FAR struct ecctest_ram_s *)raw;
+  FAR struct nand_model_s *model = &raw->model;
+  unsigned int pagesize = nandmodel_getpagesize(model);
+  unsigned int sparesize = nandmodel_getsparesize(model);
+
+  if (block != 0 || page >= ECCTEST_NPAGES)
+    {
+      return -EINVAL;
+    }
+
+  if (data)
+    {
+      memcpy(data, &ram->data[page * pagesize], pagesize);
+    }
+
+  if (spare)
+    {
+      memcpy(spare, &ram->spare[page * sparesize], sparesize);
+    }
+
+  return OK;
+}
+
+static int ecctest_rawwrite(FAR struct nand_raw_s *raw, off_t block,
+                            unsigned int page, FAR const void *data,
+                            FAR const void *spare)
+{
+  FAR struct ecctest_ram_s *ram = (FAR struct ecctest_ram_s *)raw;
+  FAR struct nand_model_s *model = &raw->model;
+  unsigned int pagesize = nandmodel_getpagesize(model);
+  unsigned int sparesize = nandmodel_getsparesize(model);
+  FAR const uint8_t *src;
+  FAR uint8_t *dest;
+  unsigned int i;
+
+  if (block != 0 || page >= ECCTEST_NPAGES)
+    {
+      return -EINVAL;
+    }
+
+  if (data)
+    {
+      src  = (FAR const uint8_t *)data;
+      dest = &ram->data[page * pagesize];
+
+      for (i = 0; i < pagesize; i++)
+        {
+          dest[i] &= src[i];
+        }
+    }
+
+  if (spare)
+    {
+      src  = (FAR const uint8_t *)spare;
+      dest = &ram->spare[page * sparesize];
+
+      for (i = 0; i < sparesize; i++)
+        {
+          dest[i] &= src[i];
+        }
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+/****************************************************************************
+ * Name: ecctest_gfmul
+ *
+ * Description:
+ *   Multiply two elements of GF(2^13) bit by bit, without the log and
+ *   exponent tables used by the BCH driver.
+ *
+ ****************************************************************************/
+
+static uint16_t ecctest_gfmul(uint16_t a, uint16_t b)
+{
+  uint16_t prod = 0;
+
+  while (b != 0)
+    {
+      if ((b & 1) != 0)
+        {
+          prod ^= a;
+        }
+
+      b >>= 1;
+      a <<= 1;
+      if ((a & (1 << NANDBCH_M)) != 0)
+        {
+          a ^= ECCTEST_BCHPOLY;
+        }
+    }
+
+  return prod;
+}
+
+/****************************************************************************
+ * Name: ecctest_refinit
+ *
+ * Description:
+ *   Find the generator polynomial of the BCH code:  The product of
+ *   (x + alpha^i) for all i that are conjugates of 1, 3, ... 2T-1.
+ *
+ ****************************************************************************/
+
+static int ecctest_refinit(FAR struct ecctest_s *priv)
+{
+  uint16_t poly[ECCTEST_ECCBITS + 1];
+  uint16_t alpha;
+  unsigned int root;
+  int deg;
+  int i;
+  int j;
+
+  memset(poly, 0, sizeof(poly));
+  poly[0] = 1;
+  deg     = 0;
+
+  for (i = 1; i < 2 * ECCTEST_T; i += 2)
+    {
+      for (alpha = 1, j = 0; j < i; j++)
+        {
+          alpha = ecctest_gfmul(alpha, 2);
+        }
+
+      root = i;
+      do
+        {
+          if (deg >= ECCTEST_ECCBITS)
+            {
+              return -EINVAL;
+            }
+
+          poly[deg + 1] = poly[deg];
+          for (j = deg; j > 0; j--)
+            {
+              poly[j] = poly[j - 1] ^ ecctest_gfmul(poly[j], alpha);
+            }
+
+          poly[0] = ecctest_gfmul(poly[0], alpha);
+          deg++;
+
+          /* The next conjugate is the square */
+
+          alpha = ecctest_gfmul(alpha, alpha);
+          root  = (2 * root) % ECCTEST_BCHN;
+        }
+      while (root != i);
+    }
+
+  if (deg != ECCTEST_ECCBITS)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < ECCTEST_ECCBITS; i++)
+    {
+      if (poly[i] > 1)
+        {
+          return -EINVAL;
+        }
+
+      priv->genpoly[i] = (uint8_t)poly[i];
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ecctest_refstep
+ *
+ * Description:
+ *   Compute the BCH code of one step with a bit-serial LFSR.  The code on
+ *   FLASH is the remainder of the data xor'ed with the remainder of an
+ *   erased step, inverted.  Since the remainder is linear, that is the
+ *   inverted remainder of the inverted data.
+ *
+ ****************************************************************************/
+
+static void ecctest_refstep(FAR struct ecctest_s *priv,
+                            FAR const uint8_t *data, FAR uint8_t *code)
+{
+  uint8_t rem[ECCTEST_ECCBITS];
+  uint8_t feedback;
+  uint8_t byte;
+  int bit;
+  int i;
+  int j;
+
+  memset(rem, 0, sizeof(rem));
+
+  for (i = 0; i < ECCTEST_STEPSIZE; i++)
+    {
+      byte = ~data[i];
+      for (bit = 7; bit >= 0; bit--)
+        {
+          feedback = rem[ECCTEST_ECCBITS - 1] ^ ((byte >> bit) & 1);
+          for (j = ECCTEST_ECCBITS - 1; j > 0; j--)
+            {
+              rem[j] = rem[j - 1] ^ (feedback & priv->genpoly[j]);
+            }
+
+          rem[0] = feedback & priv->genpoly[0];
+        }
+    }
+
+  /* The coefficient of x^(ECCBITS-1) is the MS bit of the first byte */
+
+  memset(code, 0xff, ECCTEST_ECCBYTES);
+  for (i = 0; i < ECCTEST_ECCBITS; i++)
+    {
+      if (rem[ECCTEST_ECCBITS - 1 - i] != 0)
+        {
+          code[i >> 3] ^= 0x80 >> (i & 7);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ecctest_refverify
+ *
+ * Description:
+ *   Return the status that nandbch_verify() must report for one step with
+ *   nerr bit errors.
+ *
+ ****************************************************************************/
+
+static int ecctest_refverify(FAR uint8_t *data, FAR const uint8_t *code,
+                             int nerr)
+{
+  return nerr <= ECCTEST_T ? nerr : -EBADMSG;
+}
+
+/****************************************************************************
+ * Name: ecctest_verify
+ *
+ * Description:
+ *   Verify one step with the BCH driver.
+ *
+ ****************************************************************************/
+
+static inline int ecctest_verify(FAR uint8_t *data, FAR const uint8_t *code)
+{
+  return nandbch_verify(data, ECCTEST_STEPSIZE, code);
+}
+
+/****************************************************************************
+ * Name: ecctest_compute
+ *
+ * Description:
+ *   Compute the codes of a page with the BCH driver.
+ *
+ ****************************************************************************/
+
+static inline void ecctest_compute(FAR const uint8_t *data, size_t size,
+                                   FAR uint8_t *code)
+{
+  nandbch_compute(data, size, code);
+}
+
+/****************************************************************************
+ * Name: ecctest_correctable
+ *
+ * Description:
+ *   True if the status reports a step that was corrected.
+ *
+ ****************************************************************************/
+
+#define ecctest_correctable(s) ((s) >= 0)
+
+#else /* CONFIG_MTD_NAND_SWECC_BCH */
+
+/****************************************************************************
+ * Name: ecctest_bitsinbyte
+ *
+ * Description:
+ *   Counts the number of bits set to '1' in the given byte.
+ *
+ ****************************************************************************/
+
+static unsigned int ecctest_bitsinbyte(uint8_t byte)
+{
+  unsigned int count = 0;
+
+  while (byte != 0)
+    {
+      if ((byte & 1) != 0)
+        {
+          count++;
+        }
+
+      byte >>= 1;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: ecctest_bitsincode256
+ *
+ * Description:
+ *   Counts the number of bits set to '1' in the given hamming code.
+ *
+ ****************************************************************************/
+
+static uint8_t ecctest_bitsincode256(FAR uint8_t *code)
+{
+  return ecctest_bitsinbyte(code[0]) +
+         ecctest_bitsinbyte(code[1]) +
+         ecctest_bitsinbyte(code[2]);
+}
+
+/****************************************************************************
+ * Name: ecctest_refinit
+ *
+ * Description:
+ *   The reference Hamming code needs no initialization.
+ *
+ ****************************************************************************/
+
+static inline int ecctest_refinit(FAR struct ecctest_s *priv)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ecctest_refstep
+ *
+ * Description:
+ *   Calculates the 22-bit hamming code for a 256-bytes block of data one
+ *   byte and one bit at a time.  This is the original implementation of
+ *   hamming_compute256().
+ *
+ ****************************************************************************/
+
+static void ecctest_refstep(FAR struct ecctest_s *priv,
+                            FAR const uint8_t *data, FAR uint8_t *code)
+{
+  uint8_t colsum = 0;
+  uint8_t evenline = 0;
+  uint8_t oddline = 0;
+  uint8_t evencol = 0;
+  uint8_t oddcol = 0;
+  int i;
+
+  /* Xor all bytes together to get the column sum;  At the same time,
+   * calculate the even and odd line codes.
+   */
+
+  for (i = 0; i < 256; i++)
+    {
+      colsum ^= data[i];
+
+      if ((ecctest_bitsinbyte(data[i]) & 1) == 1)
+        {
+          evenline ^= (255 - i);
+          oddline ^= i;
+        }
+    }
+
+  /* Calculate the parity group values on the column sum */
+
+  for (i = 0; i < 8; i++)
+    {
+      if (colsum & 1)
+        {
+          evencol ^= (7 - i);
+          oddcol ^= i;
+        }
+
+      colsum >>= 1;
+    }
+
+  /* Interleave the parity values */
+
+  code[0] = 0;
+  code[1] = 0;
+  code[2] = 0;
+
+  for (i = 0; i < 4; i++)
+    {
+      code[0] <<= 2;
+      code[1] <<= 2;
+      code[2] <<= 2;
+
+      /* Line 1 */
+
+      if ((oddline & 0x80) != 0)
+        {
+          code[0] |= 2;
+        }
+
+      if ((evenline & 0x80) != 0)
+        {
+          code[0] |= 1;
+        }
+
+      /* Line 2 */
+
+      if ((oddline & 0x08) != 0)
+        {
+          code[1] |= 2;
+        }
+
+      if ((evenline & 0x08) != 0)
+        {
+          code[1] |= 1;
+        }
+
+      /* Column */
+
+      if ((oddcol & 0x04) != 0)
+        {
+          code[2] |= 2;
+        }
+
+      if ((evencol & 0x04) != 0)
+        {
+          code[2] |= 1;
+        }
+
+      oddline <<= 1;
+      evenline <<= 1;
+      oddcol <<= 1;
+      evencol <<= 1;
+    }
+
+  /* Invert codes (linux compatibility) */
+
+  code[0] = (~(uint32_t)code[0]);
+  code[1] = (~(uint32_t)code[1]);
+  code[2] = (~(uint32_t)code[2]);
+}
+
+/****************************************************************************
+ * Name: ecctest_refverify
+ *
+ * Description:
+ *   Verifies and corrects a 256-bytes block of data using the given 22-bits
+ *   hamming code.  This is the original implementation of
+ *   hamming_verify256().
+ *
+ ****************************************************************************/
+
+static int ecctest_refverify(FAR uint8_t *data, FAR const uint8_t *original,
+                             int nerr)
+{
+  uint8_t computed[3];
+  uint8_t correction[3];
+
+  ecctest_refstep(NULL, data, computed);
+
+  /* Xor both codes together */
+
+  correction[0] = computed[0] ^ original[0];
+  correction[1] = computed[1] ^ original[1];
+  correction[2] = computed[2] ^ original[2];
+
+  /* If all bytes are 0, there is no error */
+
+  if ((correction[0] == 0) && (correction[1] == 0) && (correction[2] == 0))
+    {
+      return 0;
+    }
+
+  /* If there is a single bit error, there are 11 bits set to 1 */
+
+  if (ecctest_bitsincode256(correction) == 11)
+    {
+      uint8_t byte;
+      uint8_t bit;
+
+      /* Get byte and bit indexes */
+
+      byte  =  correction[0]       & 0x80;
+      byte |= (correction[0] << 1) & 0x40;
+      byte |= (correction[0] << 2) & 0x20;
+      byte |= (correction[0] << 3) & 0x10;
+
+      byte |= (correction[1] >> 4) & 0x08;
+      byte |= (correction[1] >> 3) & 0x04;
+      byte |= (correction[1] >> 2) & 0x02;
+      byte |= (correction[1] >> 1) & 0x01;
+
+      bit   = (correction[2] >> 5) & 0x04;
+      bit  |= (correction[2] >> 4) & 0x02;
+      bit  |= (correction[2] >> 3) & 0x01;
+
+      /* Correct bit */
+
+      data[byte] ^= (1 << bit);
+      return HAMMING_ERROR_SINGLEBIT;
+    }
+
+  /* Check if ECC has been corrupted */
+
+  if (ecctest_bitsincode256(correction) == 1)
+    {
+      return HAMMING_ERROR_ECC;
+    }
+
+  /* Otherwise, there are multiple bit errors */
+
+  return HAMMING_ERROR_MULTIPLEBITS;
+}
+
+/****************************************************************************
+ * Name: ecctest_verify
+ *
+ * Description:
+ *   Verify one step with the Hamming driver.
+ *
+ ****************************************************************************/
+
+static inline int ecctest_verify(FAR uint8_t *data, FAR const uint8_t *code)
+{
+  return hamming_verify256x(data, ECCTEST_STEPSIZE, code);
+}
+
+/****************************************************************************
+ * Name: ecctest_compute
+ *
+ * Description:
+ *   Compute the codes of a page with the Hamming driver.
+ *
+ ****************************************************************************/
+
+static inline void ecctest_compute(FAR const uint8_t *data, size_t size,
+                                   FAR uint8_t *code)
+{
+  hamming_compute256x(data, size, code);
+}
+
+/****************************************************************************
+ * Name: ecctest_correctable
+ *
+ * Description:
+ *   True if the status reports a step whose data is correct or was
+ *   corrected.
+ *
+ ****************************************************************************/
+
+#define ecctest_correctable(s) ((s) != HAMMING_ERROR_MULTIPLEBITS)
+
+#endif /* CONFIG_MTD_NAND_SWECC_BCH */
+
+/****************************************************************************
+ * Name: ecctest_refcompute
+ *
+ * Description:
+ *   Compute the codes of a page with the reference code.
+ *
+ ****************************************************************************/
+
+static void ecctest_refcompute(FAR struct ecctest_s *priv,
+                               FAR const uint8_t *data, size_t size,
+                               FAR uint8_t *code)
+{
+  for (; size > 0; size -= ECCTEST_STEPSIZE)
+    {
+      ecctest_refstep(priv, data, code);
+      data += ECCTEST_STEPSIZE;
+      code += ECCTEST_ECCBYTES;
+    }
+}
+
+/****************************************************************************
+ * Name: ecctest_flipbits
+ *
+ * Description:
+ *   Invert nerr different, randomly selected bits of one step of data and
+ *   of the first ncodebits bits of its code.  The code may be NULL if
+ *   ncodebits is zero.
+ *
+ ****************************************************************************/
+
+static void ecctest_flipbits(FAR struct ecctest_s *priv, FAR uint8_t *data,
+                             FAR uint8_t *code, unsigned int ncodebits,
+                             int nerr)
+{
+  unsigned int bits[ECCTEST_T + 1];
+  unsigned int bit;
+  int i;
+  int j;
+
+  DEBUGASSERT(nerr <= ECCTEST_T + 1);
+
+  for (i = 0; i < nerr; i++)
+    {
+      do
+        {
+          bit = ecctest_random(priv) % (ECCTEST_STEPBITS + ncodebits);
+          for (j = 0; j < i; j++)
+            {
+              if (bits[j] == bit)
+                {
+                  break;
+                }
+            }
+        }
+      while (j < i);
+
+      bits[i] = bit;
+      if (bit < ECCTEST_STEPBITS)
+        {
+          data[bit >> 3] ^= 0x80 >> (bit & 7);
+        }
+      else
+        {
+          bit -= ECCTEST_STEPBITS;
+          code[bit >> 3] ^= 0x80 >> (bit & 7);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ecctest_steps
+ *
+ * Description:
+ *   Inject 0 to T+1 bit errors in the data and code of each step of a page
+ *   and check that the driver reports the same status as the reference
+ *   code and that correctable errors are corrected.
+ *
+ ****************************************************************************/
+
+static int ecctest_steps(FAR struct ecctest_s *priv, unsigned int page)
+{
+  FAR const uint8_t *orig = &priv->orig[page * priv->pagesize];
+  FAR const uint8_t *code;
+  unsigned int offset;
+  int expected;
+  int nerr;
+  int ret;
+
+  for (offset = 0; offset < priv->pagesize; offset += ECCTEST_STEPSIZE)
+    {
+      code = &priv->refcode[(offset / ECCTEST_STEPSIZE) * ECCTEST_ECCBYTES];
+
+      for (nerr = 0; nerr <= ECCTEST_T + 1; nerr++)
+        {
+          memcpy(priv->work, &orig[offset], ECCTEST_STEPSIZE);
+          memcpy(priv->wcode, code, ECCTEST_ECCBYTES);
+
+          ecctest_flipbits(priv, priv->work, priv->wcode, ECCTEST_ECCBITS,
+                           nerr);
+
+          memcpy(priv->refwork, priv->work, ECCTEST_STEPSIZE);
+          memcpy(priv->rcode, priv->wcode, ECCTEST_ECCBYTES);
+
+          ret      = ecctest_verify(priv->work, priv->wcode);
+          expected = ecctest_refverify(priv->refwork, priv->rcode, nerr);
+
+          if (ret != expected)
+            {
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+              /* More than T errors may look like a correctable error
+               * pattern of another codeword.
+               */
+
+              if (nerr > ECCTEST_T && ret >= 0)
+                {
+                  priv->miscorrected++;
+                  continue;
+                }
+#endif
+
+              fdbg("ERROR: Page %u offset %u: %d errors, status %d not %d\n",
+                   page, offset, nerr, ret, expected);
+              return -EIO;
+            }
+
+          if (nerr <= ECCTEST_T && ecctest_correctable(ret) &&
+              memcmp(priv->work, &orig[offset], ECCTEST_STEPSIZE) != 0)
+            {
+              fdbg("ERROR: Page %u offset %u: %d errors not corrected\n",
+                   page, offset, nerr);
+              return -EIO;
+            }
+
+#ifndef CONFIG_MTD_NAND_SWECC_BCH
+          if (memcmp(priv->work, priv->refwork, ECCTEST_STEPSIZE) != 0)
+            {
+              fdbg("ERROR: Page %u offset %u: %d errors, data differs\n",
+                   page, offset, nerr);
+              return -EIO;
+            }
+#endif
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ecctest_readpages
+ *
+ * Description:
+ *   Inject 1 to T bit errors in the data of each step of a page in the RAM
+ *   model and check that nandecc_readpage() returns the original data.
+ *   Then inject T+1 errors in one step and check that the read fails.
+ *
+ ****************************************************************************/
+
+static int ecctest_readpages(FAR struct ecctest_s *priv, unsigned int page)
+{
+  FAR const uint8_t *orig = &priv->orig[page * priv->pagesize];
+  FAR uint8_t *data = &priv->ram.data[page * priv->pagesize];
+  unsigned int offset;
+  int nerr;
+  int ret;
+
+  for (nerr = 0; nerr <= ECCTEST_T + 1; nerr++)
+    {
+      if (nerr <= ECCTEST_T)
+        {
+          for (offset = 0; offset < priv->pagesize;
+               offset += ECCTEST_STEPSIZE)
+            {
+              ecctest_flipbits(priv, &data[offset], NULL, 0, nerr);
+            }
+        }
+      else
+        {
+          offset = (ecctest_random(priv) % (priv->pagesize /
+                                            ECCTEST_STEPSIZE)) *
+                   ECCTEST_STEPSIZE;
+          ecctest_flipbits(priv, &data[offset], NULL, 0, nerr);
+        }
+
+      ret = nandecc_readpage(&priv->nand, 0, page, priv->work, NULL);
+
+      /* Restore the page */
+
+      memcpy(data, orig, priv->pagesize);
+
+      if (nerr <= ECCTEST_T)
+        {
+          if (ret < 0 || memcmp(priv->work, orig, priv->pagesize) != 0)
+            {
+              fdbg("ERROR: Page %u: %d errors per step not corrected: %d\n",
+                   page, nerr, ret);
+              return -EIO;
+            }
+        }
+      else if (ret >= 0)
+        {
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+          priv->miscorrected++;
+#else
+          fdbg("ERROR: Page %u: %d errors not detected\n", page, nerr);
+          return -EIO;
+#endif
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ecctest_throughput
+ *
+ * Description:
+ *   Report the time needed to encode the pages with the driver and with the
+ *   reference code.
+ *
+ ****************************************************************************/
+
+static void ecctest_throughput(FAR struct ecctest_s *priv)
+{
+  uint32_t start;
+  uint32_t elapsed;
+  uint32_t refelapsed;
+  unsigned int page;
+  int i;
+
+  start = clock_systimer();
+  for (i = 0; i < ECCTEST_LOOPS; i++)
+    {
+      for (page = 0; page < ECCTEST_NPAGES; page++)
+        {
+          ecctest_compute(&priv->orig[page * priv->pagesize],
+                          priv->pagesize, priv->code);
+        }
+    }
+
+  elapsed = clock_systimer() - start;
+
+  start = clock_systimer();
+  for (i = 0; i < ECCTEST_LOOPS; i++)
+    {
+      for (page = 0; page < ECCTEST_NPAGES; page++)
+        {
+          ecctest_refcompute(priv, &priv->orig[page * priv->pagesize],
+                             priv->pagesize, priv->refcode);
+        }
+    }
+
+  refelapsed = clock_systimer() - start;
+
+  fvdbg("Encoded %u bytes in %lu ticks (reference %lu ticks)\n",
+        ECCTEST_LOOPS * ECCTEST_NPAGES * priv->pagesize,
+        (unsigned long)elapsed, (unsigned long)refelapsed);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandecc_test
+ *
+ * Description:
+ *   Test the software ECC on a RAM model of a NAND device with the page
+ *   size, spare size, and spare area scheme of the given model.  Random
+ *   pages are written with nandecc_writepage() and their ECC is compared
+ *   with that of a bit-by-bit reference implementation.  Correctable and
+ *   uncorrectable bit errors are then injected into each step, and the
+ *   status of the driver is compared with that of the reference.
+ *
+ * Input parameters:
+ *   model - The NAND model
+ *
+ * Returned value.
+ *   OK is returned if the test passes; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nandecc_test(FAR const struct nand_model_s *model)
+{
+  FAR const struct nand_scheme_s *scheme;
+  FAR struct ecctest_s *priv;
+  FAR uint8_t *buffer;
+  unsigned int pagesize;
+  unsigned int sparesize;
+  unsigned int page;
+  unsigned int i;
+  int ret;
+
+  pagesize  = nandmodel_getpagesize(model);
+  sparesize = nandmodel_getsparesize(model);
+  scheme    = nandmodel_getscheme(model);
+
+  if (pagesize == 0 || (pagesize % ECCTEST_STEPSIZE) != 0 ||
+      scheme == NULL || scheme->eccsize <
+      (pagesize / ECCTEST_STEPSIZE) * ECCTEST_ECCBYTES)
+    {
+      fdbg("ERROR: No ECC test for page size %u\n", pagesize);
+      return -EINVAL;
+    }
+
+  /* Allocate the test state, the RAM model, and the buffers */
+
+  priv = (FAR struct ecctest_s *)
+    kmm_zalloc(sizeof(struct ecctest_s) +
+               ECCTEST_NPAGES * (2 * pagesize + 2 * sparesize) +
+               pagesize + ECCTEST_STEPSIZE);
+  if (priv == NULL)
+    {
+      fdbg("ERROR: Failed to allocate the ECC test buffers\n");
+      return -ENOMEM;
+    }
+
+  buffer          = (FAR uint8_t *)&priv[1];
+  priv->ram.data  = buffer;
+  buffer         += ECCTEST_NPAGES * pagesize;
+  priv->ram.spare = buffer;
+  buffer         += ECCTEST_NPAGES * sparesize;
+  priv->orig      = buffer;
+  buffer         += ECCTEST_NPAGES * pagesize;
+  priv->saved     = buffer;
+  buffer         += ECCTEST_NPAGES * sparesize;
+  priv->work      = buffer;
+  buffer         += pagesize;
+  priv->refwork   = buffer;
+
+  memcpy(&priv->ram.raw.model, model, sizeof(struct nand_model_s));
+  priv->ram.raw.ecctype    = NANDECC_SWECC;
+  priv->ram.raw.eraseblock = ecctest_eraseblock;
+  priv->ram.raw.rawread    = ecctest_rawread;
+  priv->ram.raw.rawwrite   = ecctest_rawwrite;
+  priv->nand.raw           = &priv->ram.raw;
+
+  priv->pagesize  = pagesize;
+  priv->sparesize = sparesize;
+  priv->eccsize   = (pagesize / ECCTEST_STEPSIZE) * ECCTEST_ECCBYTES;
+  priv->seed      = 0x5eed;
+
+  ret = ecctest_refinit(priv);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to initialize the reference code: %d\n", ret);
+      goto errout;
+    }
+
+  /* Write random pages.  The last page stays erased but is written too, as
+   * the upper half does when a page of 0xff's is written.
+   */
+
+  for (i = 0; i < ECCTEST_NPAGES * pagesize; i++)
+    {
+      priv->orig[i] = (uint8_t)ecctest_random(priv);
+    }
+
+  memset(&priv->orig[(ECCTEST_NPAGES - 1) * pagesize], 0xff, pagesize);
+
+  (void)NAND_ERASEBLOCK(&priv->ram.raw, 0);
+  for (page = 0; page < ECCTEST_NPAGES; page++)
+    {
+      ret = nandecc_writepage(&priv->nand, 0, page,
+                              &priv->orig[page * pagesize], NULL);
+      if (ret < 0)
+        {
+          fdbg("ERROR: Failed to write page %u: %d\n", page, ret);
+          goto errout;
+        }
+    }
+
+  memcpy(priv->saved, priv->ram.spare, ECCTEST_NPAGES * sparesize);
+
+  for (page = 0; page < ECCTEST_NPAGES; page++)
+    {
+      /* The ECC on FLASH must be bit-identical to the reference */
+
+      nandscheme_readecc(scheme, &priv->ram.spare[page * sparesize],
+                         priv->code);
+      ecctest_refcompute(priv, &priv->orig[page * pagesize], pagesize,
+                         priv->refcode);
+
+      if (memcmp(priv->code, priv->refcode, priv->eccsize) != 0)
+        {
+          fdbg("ERROR: Page %u: ECC differs from the reference\n", page);
+          ret = -EIO;
+          goto errout;
+        }
+
+      ret = ecctest_steps(priv, page);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      ret = ecctest_readpages(priv, page);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      /* The spare area must not have been modified */
+
+      if (memcmp(priv->ram.spare, priv->saved,
+                 ECCTEST_NPAGES * sparesize) != 0)
+        {
+          fdbg("ERROR: Page %u: Spare area modified\n", page);
+          ret = -EIO;
+          goto errout;
+        }
+    }
+
+  if (priv->miscorrected > 0)
+    {
+      fvdbg("%d steps with %d errors were miscorrected\n",
+            priv->miscorrected, ECCTEST_T + 1);
+    }
+
+  ecctest_throughput(priv);
+  ret = OK;
+
+errout:
+  kmm_free(priv);
+  return ret;
+}
+
+#endif /* CONFIG_MTD_NAND_ECCTEST */
@@ -382,3 +382,68 @@ int nandscheme_build4086(FAR struct nand_scheme_s *scheme,
 
   return OK;
 };
+
+/****************************************************************************
+ * Name: nandscheme_buildbch
+ *
+ * Description:
+ *   Build a scheme instance for the software BCH ECC.  The ECC bytes are
+ *   placed at the end of the spare area.  The bad block marker of the base
+ *   scheme is retained (along with the following byte if the marker is at
+ *   position 0) and all of the remaining bytes are extra bytes.
+ *
+ * Input Parameters:
+ *   scheme    Pointer to the nand_scheme_s instance to build.
+ *   base      The scheme of the NAND model.  May be NULL.
+ *   sparesize Size of spare area.
+ *   eccsize   Number of ECC bytes needed for one page.
+ *
+ * Returned Values:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nandscheme_buildbch(FAR struct nand_scheme_s *scheme,
+                        FAR const struct nand_scheme_s *base,
+                        unsigned int sparesize, unsigned int eccsize)
+{
+  unsigned int eccoffset;
+  unsigned int reserved;
+  unsigned int pos;
+  unsigned int i;
+
+  scheme->bbpos = base != NULL ? base->bbpos : 0;
+  reserved      = scheme->bbpos == 0 ? 2 : scheme->bbpos + 1;
+
+  if (sparesize > CONFIG_MTD_NAND_MAXPAGESPARESIZE ||
+      eccsize > CONFIG_MTD_NAND_MAXSPAREECCBYTES ||
+      eccsize + reserved > sparesize)
+    {
+      return -E2BIG;
+    }
+
+  /* The ECC bytes are at the end of the spare area */
+
+  eccoffset       = sparesize - eccsize;
+  scheme->eccsize = eccsize;
+
+  for (i = 0; i < eccsize; i++)
+    {
+      scheme->eccbytepos[i] = eccoffset + i;
+    }
+
+  /* Then everything before the ECC except the bad block marker */
+
+  for (i = 0, pos = 0;
+       pos < eccoffset && i < CONFIG_MTD_NAND_MAXSPAREEXTRABYTES;
+       pos++)
+    {
+      if (pos != scheme->bbpos && (scheme->bbpos != 0 || pos != 1))
+        {
+          scheme->xbytepos[i++] = pos;
+        }
+    }
+
+  scheme->nxbytes = i;
+  return OK;
+}
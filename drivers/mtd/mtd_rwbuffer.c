@@ -303,6 +303,23 @@ static int mtd_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_DRVR_RWBSTATS
+      case BIOC_RWBSTATS:
+        {
+          /* Return the statistics of the read-ahead/write buffer */
+
+          FAR struct rwb_stats_s *stats =
+            (FAR struct rwb_stats_s *)((uintptr_t)arg);
+
+          if (stats)
+            {
+              rwb_getstats(&priv->rwb, stats);
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
       case MTDIOC_XIPBASE:
       default:
         ret = -ENOTTY; /* Bad command */
@@ -49,6 +49,8 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#include <semaphore.h>
+#include <assert.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -56,6 +58,8 @@
 #include <crc16.h>
 #include <crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -132,7 +136,7 @@
 #define offsetof(type, member) ( (size_t) &( ( (type *) 0)->member))
 #endif
 
-#define SMART_MAX_ALLOCS        6
+#define SMART_MAX_ALLOCS        7
 //#define CONFIG_MTD_SMART_PACK_COUNTS
 
 #ifndef CONFIG_MTD_SMART_ALLOC_DEBUG
@@ -140,6 +144,58 @@
 #define smart_free(d, p)        kmm_free(p)
 #endif
 
+/* Checkpoint of the sector map.  The checkpoint header is in the first MTD
+ * block of a checkpoint slot, the checkpoint data begins in the second.
+ */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+#  ifndef CONFIG_MTD_SMART_CHECKPOINT_INTERVAL
+#    define CONFIG_MTD_SMART_CHECKPOINT_INTERVAL 256
+#  endif
+#  ifndef CONFIG_MTD_SMART_CHECKPOINT_LOGSIZE
+#    define CONFIG_MTD_SMART_CHECKPOINT_LOGSIZE 256
+#  endif
+
+#  define SMART_CKPT_SIG1           'S'
+#  define SMART_CKPT_SIG2           'C'
+#  define SMART_CKPT_SIG3           'K'
+#  define SMART_CKPT_SIG4           'P'
+#  define SMART_CKPT_VERSION        1
+#  define SMART_CKPT_STATE_VALID    0x5a
+#  define SMART_CKPT_STATE_INVALID  (CONFIG_SMARTFS_ERASEDSTATE ^ 0xff)
+
+#  define SMART_CKPT_REC_ERASE      1  /* An erase block was erased */
+#  define SMART_CKPT_REC_FREE       2  /* A logical sector was freed */
+
+/* Number of erased sector headers that may precede a written sector when
+ * the sectors written after a checkpoint are scanned.  With CRC enabled,
+ * sectors may be written in a different order than they were allocated.
+ */
+
+#  ifdef CONFIG_MTD_SMART_ENABLE_CRC
+#    define SMART_CKPT_LOOKAHEAD    4
+#  else
+#    define SMART_CKPT_LOOKAHEAD    0
+#  endif
+#endif
+
+/* Background garbage collection */
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#  ifndef CONFIG_MTD_SMART_BGGC_WATERMARK
+#    define CONFIG_MTD_SMART_BGGC_WATERMARK 2
+#  endif
+#  ifndef CONFIG_MTD_SMART_BGGC_DELAY
+#    define CONFIG_MTD_SMART_BGGC_DELAY 50
+#  endif
+
+#  define SMART_BGGC_DELAY  MSEC2TICK(CONFIG_MTD_SMART_BGGC_DELAY)
+#  define smart_semgive(d)  sem_post(&(d)->exclsem)
+#else
+#  define smart_semtake(d)
+#  define smart_semgive(d)
+#endif
+
 #define SMART_WEAR_FULL_RELOCATE_THRESHOLD  8
 #define SMART_WEAR_REORG_THRESHOLD          14
 #define SMART_WEAR_MIN_LEVEL                5
@@ -211,6 +267,31 @@ struct smart_allocsector_s
 };
 #endif
 
+/* Checkpoint header and log record definitions */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+struct smart_ckpt_header_s
+{
+  uint8_t               magic[4];         /* "SCKP" */
+  uint8_t               state;            /* Valid or invalidated */
+  uint8_t               version;          /* Checkpoint format version */
+  uint16_t              sectorsize;       /* Sector size on device */
+  uint16_t              totalsectors;     /* Total number of sectors */
+  uint16_t              neraseblocks;     /* Number of managed erase blocks */
+  uint16_t              freesectors;      /* Total number of free sectors */
+  uint16_t              releasesectors;   /* Total number of released sectors */
+  uint32_t              seq;              /* Checkpoint sequence number */
+  uint32_t              crc;              /* CRC-32 of the checkpoint data */
+};
+
+struct smart_ckpt_record_s
+{
+  uint8_t               type;             /* SMART_CKPT_REC_* */
+  uint8_t               reserved;         /* Not erased, marks a valid record */
+  uint8_t               value[2];         /* Erase block or logical sector */
+};
+#endif
+
 struct smart_struct_s
 {
   FAR struct mtd_dev_s *mtd;              /* Contained MTD interface */
@@ -265,6 +346,21 @@ struct smart_struct_s
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  sem_t                 exclsem;          /* Serializes foreground and GC work */
+  struct work_s         gcwork;           /* Background GC work */
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  bool                  ckptvalid;        /* The current checkpoint is valid */
+  uint8_t               ckptslot;         /* Slot of the current checkpoint */
+  uint16_t              ckptblocks;       /* Erase blocks per checkpoint slot */
+  uint16_t              ckptwrites;       /* Allocations since the checkpoint */
+  uint32_t              ckptseq;          /* Sequence number of the checkpoint */
+  uint32_t              ckptlogoffset;    /* Offset of the log in a slot */
+  uint32_t              ckptlogpos;       /* Number of records in the log */
+  uint32_t              ckptlogsize;      /* Capacity of the log */
+  FAR uint8_t          *ckptbuf;          /* MTD block buffer for checkpoints */
+#endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
@@ -377,12 +473,19 @@ static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int smart_read_wearstatus(FAR struct smart_struct_s *dev);
+#ifdef CONFIG_MTD_SMART_BGGC
+static int smart_write_wearstatus(struct smart_struct_s *dev);
+#endif
 static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t block);
 #endif
 
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
     uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_ckpt_invalidate(FAR struct smart_struct_s *dev);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -431,6 +534,28 @@ static int smart_close(FAR struct inode *inode)
   return OK;
 }
 
+/****************************************************************************
+ * Name: smart_semtake
+ *
+ * Description: Get exclusive access to the device.  Foreground requests
+ *              and the background garbage collection are serialized.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_semtake(FAR struct smart_struct_s *dev)
+{
+  while (sem_wait(&dev->exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      ASSERT(errno == EINTR);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_malloc
  *
@@ -533,11 +658,11 @@ static void smart_set_count(FAR struct smart_struct_s *dev, FAR uint8_t* pCount,
         {
           if (count == 16)
             {
-              pCount[(dev->geo.neraseblocks >> 1) + (block>>3)] |= 1 << (block & 0x07);
+              pCount[(dev->neraseblocks >> 1) + (block>>3)] |= 1 << (block & 0x07);
             }
           else
             {
-              pCount[(dev->geo.neraseblocks >> 1) + (block>>3)] &= ~(1 << (block & 0x07));
+              pCount[(dev->neraseblocks >> 1) + (block>>3)] &= ~(1 << (block & 0x07));
             }
         }
     }
@@ -581,7 +706,7 @@ static uint8_t smart_get_count(FAR struct smart_struct_s *dev,
 
       if (dev->sectorsPerBlk == 16)
         {
-          if (pCount[(dev->geo.neraseblocks >> 1) + (block>>3)] & (1 << (block & 0x07)))
+          if (pCount[(dev->neraseblocks >> 1) + (block>>3)] & (1 << (block & 0x07)))
             {
               count |= 0x10;
             }
@@ -762,6 +887,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   struct smart_struct_s *dev;
+  ssize_t ret;
 
   fvdbg("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -771,7 +897,11 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  smart_semtake(dev);
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_semgive(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -808,7 +938,9 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  /* Get exclusive access to the device */
+
+  smart_semtake(dev);
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -824,6 +956,12 @@ static ssize_t smart_write(FAR struct inode *inode,
   mtdblockcount = nsectors * dev->mtdBlksPerSector;
   mtdBlksPerErase = dev->mtdBlksPerSector * dev->sectorsPerBlk;
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Raw writes bypass the sector map, so the checkpoint is no longer valid */
+
+  smart_ckpt_invalidate(dev);
+#endif
+
   fvdbg("mtdsector: %d mtdnsectors: %d\n", mtdstartblock, mtdblockcount);
 
   /* Start at first block to be written */
@@ -847,9 +985,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               fdbg("Erase block=%d failed: %d\n", eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
+              smart_semgive(dev);
               return ret;
             }
         }
@@ -876,9 +1012,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           fdbg("Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
+          smart_semgive(dev);
           return -EIO;
         }
 
@@ -890,6 +1024,7 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdBlksPerErase;
     }
 
+  smart_semgive(dev);
   return nsectors;
 }
 #endif /* CONFIG_FS_WRITABLE */
@@ -930,7 +1065,7 @@ static int smart_geometry(FAR struct inode *inode, struct geometry *geometry)
           erasesize = 262144;
         }
 
-      geometry->geo_nsectors      = dev->geo.neraseblocks * erasesize /
+      geometry->geo_nsectors      = dev->neraseblocks * erasesize /
                                      dev->sectorsize;
       geometry->geo_sectorsize    = dev->sectorsize;
 
@@ -1017,6 +1152,39 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
   dev->blockerases = 0;
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Reserve two checkpoint slots at the end of the device.  Each holds the
+   * checkpoint header, the sector map with the release and free counts,
+   * the first free sector of each erase block and the log.
+   */
+
+  dev->ckptblocks = 0;
+  dev->ckptvalid = false;
+  dev->ckptslot = 0;
+  dev->ckptseq = 0;
+  dev->ckptlogpos = 0;
+
+  if (dev->erasesize != 0)
+    {
+      totalsectors = dev->neraseblocks * dev->sectorsPerBlk;
+      allocsize = totalsectors * sizeof(uint16_t) + dev->neraseblocks * 3;
+      allocsize = (allocsize + dev->geo.blocksize - 1) / dev->geo.blocksize *
+                  dev->geo.blocksize;
+      allocsize += dev->geo.blocksize + CONFIG_MTD_SMART_CHECKPOINT_LOGSIZE *
+                   sizeof(struct smart_ckpt_record_s);
+
+      dev->ckptblocks = (allocsize + dev->erasesize - 1) / dev->erasesize;
+      if (4 * dev->ckptblocks >= dev->neraseblocks)
+        {
+          /* Too small a device to spare the checkpoint slots */
+
+          dev->ckptblocks = 0;
+        }
+
+      dev->neraseblocks -= 2 * dev->ckptblocks;
+    }
+#endif
+
   /* Release any existing rwbuffer and sMap */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
@@ -1043,6 +1211,14 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       dev->rwbuffer = NULL;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  if (dev->ckptbuf != NULL)
+    {
+      smart_free(dev, dev->ckptbuf);
+      dev->ckptbuf = NULL;
+    }
+#endif
+
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   if (dev->wearstatus != NULL)
     {
@@ -1196,6 +1372,30 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       goto errexit;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Allocate the checkpoint buffer and locate the checkpoint log */
+
+  if (dev->ckptblocks > 0)
+    {
+      dev->ckptbuf = (FAR uint8_t *) smart_malloc(dev, dev->geo.blocksize,
+                                                  "Checkpoint buffer");
+      if (!dev->ckptbuf)
+        {
+          fdbg("Error allocating SMART checkpoint buffer\n");
+          goto errexit;
+        }
+
+      allocsize = dev->totalsectors * sizeof(uint16_t) +
+                  dev->neraseblocks * 3;
+      dev->ckptlogoffset = dev->geo.blocksize +
+                           (allocsize + dev->geo.blocksize - 1) /
+                           dev->geo.blocksize * dev->geo.blocksize;
+      dev->ckptlogsize = (dev->ckptblocks * dev->erasesize -
+                          dev->ckptlogoffset) /
+                         sizeof(struct smart_ckpt_record_s);
+    }
+#endif
+
   return OK;
 
   /* On error for any allocation, we jump here and free anything that had
@@ -1235,6 +1435,13 @@ errexit:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  if (dev->ckptbuf)
+    {
+      smart_free(dev, dev->ckptbuf);
+    }
+#endif
+
   kmm_free(dev);
   return -ENOMEM;
 }
@@ -1446,7 +1653,7 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
         {
           /* Now scan across each erase block */
 
-          for (block = 0; block < dev->geo.neraseblocks; block++)
+          for (block = 0; block < dev->neraseblocks; block++)
             {
               /* Calculate the read address for this sector */
 
@@ -1625,7 +1832,7 @@ static void smart_find_wear_minmax(FAR struct smart_struct_s *dev)
 
   /* Loop through all erase blocks and find min / max level */
 
-  for (x = 0; x < dev->geo.neraseblocks; x++)
+  for (x = 0; x < dev->neraseblocks; x++)
     {
       /* Find wear level of the minimum worn block */
 
@@ -1646,7 +1853,7 @@ static void smart_find_wear_minmax(FAR struct smart_struct_s *dev)
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   /* Also adjust the erase counts */
   level = 255;
-  for (x = 0; x < dev->geo.neraseblocks; x++)
+  for (x = 0; x < dev->neraseblocks; x++)
     {
       if (dev->erasecounts[x] < level)
         {
@@ -1656,7 +1863,7 @@ static void smart_find_wear_minmax(FAR struct smart_struct_s *dev)
 
   if (level != 0)
     {
-      for (x = 0; x < dev->geo.neraseblocks; x++)
+      for (x = 0; x < dev->neraseblocks; x++)
         {
           dev->erasecounts[x] -= level;
         }
@@ -1755,466 +1962,1307 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev, uint16_t block,
 #endif
 
 /****************************************************************************
- * Name: smart_scan
+ * Name: smart_checkformat
  *
- * Description: Performs a scan of the MTD device searching for format
- *              information and fills in logical sector mapping, freesector
- *              count, etc.
+ * Description: Validates the format signature in the physical sector that
+ *              holds logical sector zero and, if it is valid, sets up the
+ *              format information of the volume.
  *
  ****************************************************************************/
 
-static int smart_scan(FAR struct smart_struct_s *dev)
+static int smart_checkformat(FAR struct smart_struct_s *dev, uint16_t sector)
 {
-  int       sector;
-  int       ret;
-  uint16_t  totalsectors;
-  uint16_t  sectorsize, prerelease;
-  uint16_t  logicalsector;
-  uint16_t  loser;
   uint32_t  readaddress;
-  uint32_t  offset;
-  uint16_t  seq1;
-  uint16_t  seq2;
-  struct    smart_sect_header_s header;
-#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
-  int       dupsector;
-  uint16_t  duplogsector;
-#endif
+  int       ret;
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   int       x;
   char      devname[22];
   FAR struct smart_multiroot_device_s *rootdirdev;
 #endif
 
-  fvdbg("Entry\n");
-
-  /* Find the sector size on the volume by reading headers from
-   * sectors of decreasing size.  On a formatted volume, the sector
-   * size is saved in the header status byte of seach sector, so
-   * by starting with the largest supported sector size and
-   * decreasing from there, we will be sure to find data that is
-   * a header and not sector data.
-   */
-
-  sectorsize = 0xFFFF;
-  offset = 16384;
+  /* Read the sector data */
 
-  while (sectorsize == 0xFFFF)
+  readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+  ret = MTD_READ(dev->mtd, readaddress, 32, (FAR uint8_t*) dev->rwbuffer);
+  if (ret != 32)
     {
-      readaddress = 0;
-
-      while (readaddress < dev->erasesize * dev->geo.neraseblocks)
-        {
-          /* Read the next sector from the device */
-
-          ret = MTD_READ(dev->mtd, 0, sizeof(struct smart_sect_header_s),
-                         (FAR uint8_t *) &header);
-          if (ret != sizeof(struct smart_sect_header_s))
-            {
-              goto err_out;
-            }
-
-          if (header.status != CONFIG_SMARTFS_ERASEDSTATE)
-            {
-              sectorsize = (header.status & SMART_STATUS_SIZEBITS) << 7;
-              break;
-            }
+      fdbg("Error reading physical sector %d.\n", sector);
+      return -EIO;
+    }
 
-          readaddress += offset;
-        }
+  /* Validate the format signature */
 
-      offset >>= 1;
-      if (offset < 256 && sectorsize == 0xFFFF)
-        {
-          sectorsize = CONFIG_MTD_SMART_SECTOR_SIZE;
-        }
-    }
+  if (dev->rwbuffer[SMART_FMT_POS1] != SMART_FMT_SIG1 ||
+      dev->rwbuffer[SMART_FMT_POS2] != SMART_FMT_SIG2 ||
+      dev->rwbuffer[SMART_FMT_POS3] != SMART_FMT_SIG3 ||
+      dev->rwbuffer[SMART_FMT_POS4] != SMART_FMT_SIG4)
+   {
+     /* Invalid signature on a sector claiming to be sector 0!
+      * What should we do?  Release it?*/
 
-  /* Now set the sectorsize and other sectorsize derived variables */
+     return -EINVAL;
+   }
 
-  ret = smart_setsectorsize(dev, sectorsize);
-  if (ret != OK)
-    {
-      goto err_out;
-    }
+  /* Mark the volume as formatted and set the sector size */
 
-  /* Initialize the device variables */
+  dev->formatstatus = SMART_FMT_STAT_FORMATTED;
+  dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
+  dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
 
-  totalsectors = dev->totalsectors;
-  dev->formatstatus = SMART_FMT_STAT_NOFMT;
-  dev->freesectors = dev->availSectPerBlk * dev->geo.neraseblocks;
-  dev->releasesectors = 0;
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
 
-  /* Initialize the freecount and releasecount arrays */
+  /* If rootdirentries is greater than 1, then we need to register
+   * additional block devices.
+   */
 
-  for (sector = 0; sector < dev->neraseblocks; sector++)
+  for (x = 1; x < dev->rootdirentries; x++)
     {
-      if (sector == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+      if (dev->partname[0] != '\0')
         {
-          prerelease = 2;
+          snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d",
+                  dev->minor, dev->partname, x+1);
         }
       else
         {
-          prerelease = 0;
+          snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor,
+                   x + 1);
         }
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-      smart_set_count(dev, dev->freecount, sector, dev->availSectPerBlk - prerelease);
-      smart_set_count(dev, dev->releasecount, sector, prerelease);
-#else
-      dev->freecount[sector] = dev->availSectPerBlk - prerelease;
-      dev->releasecount[sector] = prerelease;
-#endif
-    }
+      /* Inode private data is a reference to a struct containing
+       * the SMART device structure and the root directory number.
+       */
 
-  /* Initialize the sector map */
+      rootdirdev = (struct smart_multiroot_device_s*) smart_malloc(dev,
+                        sizeof(*rootdirdev), "Root Dir");
+      if (rootdirdev == NULL)
+        {
+          fdbg("Memory alloc failed\n");
+          return -ENOMEM;
+        }
 
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-  for (sector = 0; sector < totalsectors; sector++)
-    {
-      dev->sMap[sector] = -1;
-    }
-#else
-  /* Clear all logical sector used bits */
+      /* Populate the rootdirdev */
 
-  memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
-#endif
+      rootdirdev->dev = dev;
+      rootdirdev->rootdirnum = x;
+      ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
 
-  /* Now scan the MTD device */
+      /* Inode private data is a reference to the SMART device structure */
 
-  for (sector = 0; sector < totalsectors; sector++)
-    {
-      fvdbg("Scan sector %d\n", sector);
+      ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
+    }
+#endif
 
-      /* Calculate the read address for this sector */
+  return OK;
+}
 
-      readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+/****************************************************************************
+ * Name: smart_scan_sector
+ *
+ * Description: Adds one physical sector to the logical sector mapping and
+ *              the freesector and releasesector counts, given the header
+ *              that was read from the sector.
+ *
+ ****************************************************************************/
 
-      /* Read the header for this sector */
+static int smart_scan_sector(FAR struct smart_struct_s *dev, uint16_t sector,
+                             FAR struct smart_sect_header_s *header)
+{
+  int       ret;
+  uint16_t  logicalsector;
+  uint16_t  loser;
+  uint32_t  readaddress;
+  uint32_t  offset;
+  uint16_t  seq1;
+  uint16_t  seq2;
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  int       dupsector;
+  uint16_t  duplogsector;
+#endif
 
-      ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
-                     (FAR uint8_t *) &header);
-      if (ret != sizeof(struct smart_sect_header_s))
-        {
-          goto err_out;
-        }
+  readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
 
-      /* Get the logical sector number for this physical sector */
+  /* Get the logical sector number for this physical sector */
 
-      logicalsector = *((FAR uint16_t *) header.logicalsector);
+  logicalsector = *((FAR uint16_t *) header->logicalsector);
 #if CONFIG_SMARTFS_ERASEDSTATE == 0x00
-      if (logicalsector == 0)
-        {
-          logicalsector = -1;
-        }
+  if (logicalsector == 0)
+    {
+      logicalsector = -1;
+    }
 #endif
 
-      /* Test if this sector has been committed */
+  /* Test if this sector has been committed */
 
-      if ((header.status & SMART_STATUS_COMMITTED) ==
-              (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
-        {
-          continue;
-        }
+  if ((header->status & SMART_STATUS_COMMITTED) ==
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
+    {
+      return OK;
+    }
 
-      /* This block is commited, therefore not free.  Update the
-       * erase block's freecount.
-       */
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* A sector that is still mapped by the checkpoint was counted there */
+
+  if (logicalsector < dev->totalsectors &&
+      dev->sMap[logicalsector] == sector)
+    {
+      return OK;
+    }
+#endif
+
+  /* This block is commited, therefore not free.  Update the
+   * erase block's freecount.
+   */
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-      smart_add_count(dev, dev->freecount, sector / dev->sectorsPerBlk, -1);
+  smart_add_count(dev, dev->freecount, sector / dev->sectorsPerBlk, -1);
 #else
-      dev->freecount[sector / dev->sectorsPerBlk]--;
+  dev->freecount[sector / dev->sectorsPerBlk]--;
 #endif
-      dev->freesectors--;
+  dev->freesectors--;
 
-      /* Test if this sector has been release and if it has,
-       * update the erase block's releasecount.
-       */
+  /* Test if this sector has been release and if it has,
+   * update the erase block's releasecount.
+   */
 
-      if ((header.status & SMART_STATUS_RELEASED) !=
-              (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
-        {
-          /* Keep track of the total number of released sectors and
-           * released sectors per erase block.
-           */
+  if ((header->status & SMART_STATUS_RELEASED) !=
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+    {
+      /* Keep track of the total number of released sectors and
+       * released sectors per erase block.
+       */
 
-          dev->releasesectors++;
+      dev->releasesectors++;
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-          smart_add_count(dev, dev->releasecount, sector / dev->sectorsPerBlk, 1);
+      smart_add_count(dev, dev->releasecount, sector / dev->sectorsPerBlk, 1);
 #else
-          dev->releasecount[sector / dev->sectorsPerBlk]++;
+      dev->releasecount[sector / dev->sectorsPerBlk]++;
 #endif
-          continue;
-        }
+      return OK;
+    }
 
-      if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
-        {
-          continue;
-        }
+  if ((header->status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
+    {
+      return OK;
+    }
+
+  /* Validate the logical sector number is in bounds */
+
+  if (logicalsector >= dev->totalsectors)
+    {
+      /* Error in logical sector read from the MTD device */
+
+      fdbg("Invalid logical sector %d at physical %d.\n",
+           logicalsector, sector);
+      return OK;
+    }
 
-      /* Validate the logical sector number is in bounds */
+  /* If this is logical sector zero, then read in the signature
+   * information to validate the format signature.
+   */
 
-      if (logicalsector >= totalsectors)
+  if (logicalsector == 0)
+    {
+      ret = smart_checkformat(dev, sector);
+      if (ret == -EINVAL)
         {
-          /* Error in logical sector read from the MTD device */
+          return OK;
+        }
+      else if (ret < 0)
+        {
+          return ret;
+        }
+    }
 
-          fdbg("Invalid logical sector %d at physical %d.\n",
-               logicalsector, sector);
-          continue;
+  /* Test for duplicate logical sectors on the device */
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  if (dev->sMap[logicalsector] != 0xFFFF)
+#else
+  if (dev->sBitMap[logicalsector >> 3] & (1 << (logicalsector & 0x07)))
+#endif
+    {
+      /* Uh-oh, we found more than 1 physical sector claiming to be
+       * the same logical sector.  Use the sequence number information
+       * to resolve who wins.
+       */
+
+#if SMART_STATUS_VERSION == 1
+      if (header->status & SMART_STATUS_CRC)
+        {
+          seq2 = header->seq;
+        }
+      else
+        {
+          seq2 = *((FAR uint16_t *) &header->seq);
         }
+#else
+      seq2 = header->seq;
+#endif
 
-      /* If this is logical sector zero, then read in the signature
-       * information to validate the format signature.
+      /* We must re-read the 1st physical sector to get it's seq number */
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+      readaddress = dev->sMap[logicalsector]  * dev->mtdBlksPerSector * dev->geo.blocksize;
+#else
+      /* For minimize RAM, we have to rescan to find the 1st sector claiming to
+       * be this logical sector.
        */
 
-      if (logicalsector == 0)
+      for (dupsector = 0; dupsector < sector; dupsector++)
         {
-          /* Read the sector data */
+          /* Calculate the read address for this sector */
+
+          readaddress = dupsector * dev->mtdBlksPerSector * dev->geo.blocksize;
 
-          ret = MTD_READ(dev->mtd, readaddress, 32,
-                         (FAR uint8_t*) dev->rwbuffer);
-          if (ret != 32)
+          /* Read the header for this sector */
+
+          ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+                         (FAR uint8_t *) header);
+          if (ret != sizeof(struct smart_sect_header_s))
             {
-              fdbg("Error reading physical sector %d.\n", sector);
-              goto err_out;
+              return ret < 0 ? ret : -EIO;
             }
 
-          /* Validate the format signature */
+          /* Get the logical sector number for this physical sector */
 
-          if (dev->rwbuffer[SMART_FMT_POS1] != SMART_FMT_SIG1 ||
-              dev->rwbuffer[SMART_FMT_POS2] != SMART_FMT_SIG2 ||
-              dev->rwbuffer[SMART_FMT_POS3] != SMART_FMT_SIG3 ||
-              dev->rwbuffer[SMART_FMT_POS4] != SMART_FMT_SIG4)
-           {
-             /* Invalid signature on a sector claiming to be sector 0!
-              * What should we do?  Release it?*/
+          duplogsector = *((FAR uint16_t *) header->logicalsector);
+#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
+          if (duplogsector == 0)
+            {
+              duplogsector = -1;
+            }
+#endif
 
-             continue;
-           }
+          /* Test if this sector has been committed */
 
-          /* Mark the volume as formatted and set the sector size */
+          if ((header->status & SMART_STATUS_COMMITTED) ==
+                  (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
+            {
+              continue;
+            }
 
-          dev->formatstatus = SMART_FMT_STAT_FORMATTED;
-          dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
-          dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
+          /* Test if this sector has been release and skip it if it has */
 
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-          dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
+          if ((header->status & SMART_STATUS_RELEASED) !=
+                  (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+            {
+              continue;
+            }
 
-          /* If rootdirentries is greater than 1, then we need to register
-           * additional block devices.
-           */
+          if ((header->status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
+            {
+              continue;
+            }
+
+          /* Now compare if this logical sector matches the current sector */
 
-          for (x = 1; x < dev->rootdirentries; x++)
+          if (duplogsector == logicalsector)
             {
-              if (dev->partname[0] != '\0')
-                {
-                  snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d",
-                          dev->minor, dev->partname, x+1);
-                }
-              else
-                {
-                  snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor,
-                           x + 1);
-                }
+              break;
+            }
+        }
+#endif
 
-              /* Inode private data is a reference to a struct containing
-               * the SMART device structure and the root directory number.
-               */
+      ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+              (FAR uint8_t *) header);
+      if (ret != sizeof(struct smart_sect_header_s))
+        {
+          return ret < 0 ? ret : -EIO;
+        }
 
-              rootdirdev = (struct smart_multiroot_device_s*) smart_malloc(dev,
-                                sizeof(*rootdirdev), "Root Dir");
-              if (rootdirdev == NULL)
-                {
-                  fdbg("Memory alloc failed\n");
-                  ret = -ENOMEM;
-                  goto err_out;
-                }
+#if SMART_STATUS_VERSION == 1
+      if (header->status & SMART_STATUS_CRC)
+        {
+          seq1 = header->seq;
+        }
+      else
+        {
+          seq1 = *((FAR uint16_t *) &header->seq);
+        }
+#else
+      seq1 = header->seq;
+#endif
 
-              /* Populate the rootdirdev */
+      /* Now determine who wins */
 
-              rootdirdev->dev = dev;
-              rootdirdev->rootdirnum = x;
-              ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      if ((header->status & SMART_STATUS_RELEASED) !=
+              (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+        {
+          /* The sector mapped by the checkpoint has been released since
+           * the checkpoint was written.  It is no longer counted as in use.
+           */
 
-              /* Inode private data is a reference to the SMART device structure */
+          loser = dev->sMap[logicalsector];
+          dev->sMap[logicalsector] = sector;
+          dev->releasesectors++;
+          dev->releasecount[loser / dev->sectorsPerBlk]++;
+          return OK;
+        }
+#endif
 
-              ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
-            }
+      if ((seq1 > 0xFFF0 && seq2 < 10) || seq2 > seq1)
+        {
+          /* Seq 2 is the winner ... bigger or it wrapped */
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+          loser = dev->sMap[logicalsector];
+          dev->sMap[logicalsector] = sector;
+#else
+          loser = dupsector;
+#endif
+        }
+      else
+        {
+          /* We keep the original mapping and seq2 is the loser */
+
+          loser = sector;
+        }
+
+      /* Now release the loser sector */
+
+      readaddress = loser  * dev->mtdBlksPerSector * dev->geo.blocksize;
+      ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+              (FAR uint8_t *) header);
+      if (ret != sizeof(struct smart_sect_header_s))
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+      header->status &= ~SMART_STATUS_RELEASED;
+#else
+      header->status |= SMART_STATUS_RELEASED;
 #endif
+      offset = readaddress + offsetof(struct smart_sect_header_s, status);
+      ret = smart_bytewrite(dev, offset, 1, &header->status);
+      if (ret < 0)
+        {
+          fdbg("Error %d releasing duplicate sector\n", -ret);
+          return ret;
         }
 
-      /* Test for duplicate logical sectors on the device */
+      /* The loser was counted as in use */
+
+      dev->releasesectors++;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      smart_add_count(dev, dev->releasecount, loser / dev->sectorsPerBlk, 1);
+#else
+      dev->releasecount[loser / dev->sectorsPerBlk]++;
+#endif
+
+      if (loser == sector)
+        {
+          return OK;
+        }
+    }
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-      if (dev->sMap[logicalsector] != 0xFFFF)
+  /* Update the logical to physical sector map */
+
+  dev->sMap[logicalsector] = sector;
 #else
-      if (dev->sBitMap[logicalsector >> 3] & (1 << (logicalsector & 0x07)))
+  /* Mark the logical sector as used in the bitmap */
+  dev->sBitMap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
+
+  if (logicalsector < SMART_FIRST_ALLOC_SECTOR)
+    {
+      smart_add_sector_to_cache(dev, logicalsector, sector, __LINE__ );
+    }
+#endif
+
+  return OK;
+}
+
+
+/****************************************************************************
+ * Name: smart_ckpt_offset
+ *
+ * Description: Returns the byte offset of a checkpoint slot on the device.
+ *              The two checkpoint slots follow the erase blocks that are
+ *              managed by SMART.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static inline uint32_t smart_ckpt_offset(FAR struct smart_struct_s *dev,
+                                         uint8_t slot)
+{
+  return (dev->neraseblocks + slot * dev->ckptblocks) * dev->erasesize;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_program
+ *
+ * Description: Programs a few bytes of a checkpoint slot that do not cross
+ *              an MTD block boundary.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_program(FAR struct smart_struct_s *dev,
+                              uint32_t offset, size_t nbytes,
+                              FAR const uint8_t *buffer)
+{
+  uint32_t  block;
+  ssize_t   ret;
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+  /* Check if the underlying MTD device supports write */
+
+  if (dev->mtd->write != NULL)
+    {
+      ret = dev->mtd->write(dev->mtd, offset, nbytes, buffer);
+      return ret == nbytes ? OK : -EIO;
+    }
 #endif
+
+  /* Perform block-based read-modify-write.  The checkpoint buffer is used
+   * so that the contents of the sector read/write buffer are preserved.
+   */
+
+  block = offset / dev->geo.blocksize;
+  ret = MTD_BREAD(dev->mtd, block, 1, dev->ckptbuf);
+  if (ret != 1)
+    {
+      return -EIO;
+    }
+
+  memcpy(&dev->ckptbuf[offset - block * dev->geo.blocksize], buffer, nbytes);
+
+  ret = MTD_BWRITE(dev->mtd, block, 1, dev->ckptbuf);
+  return ret == 1 ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_invalidate
+ *
+ * Description: Marks the current checkpoint as invalid.  This is done when
+ *              a change to the volume cannot be recorded in the checkpoint
+ *              log.  The next mount then performs a full scan unless a new
+ *              checkpoint is written first.
+ *
+ ****************************************************************************/
+
+static void smart_ckpt_invalidate(FAR struct smart_struct_s *dev)
+{
+  uint8_t   state = SMART_CKPT_STATE_INVALID;
+
+  if (dev->ckptvalid)
+    {
+      dev->ckptvalid = false;
+      smart_ckpt_program(dev, smart_ckpt_offset(dev, dev->ckptslot) +
+                         offsetof(struct smart_ckpt_header_s, state),
+                         1, &state);
+    }
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_log
+ *
+ * Description: Appends a record to the log that follows the current
+ *              checkpoint.  Erase blocks erased and logical sectors freed
+ *              after the checkpoint cannot be found by scanning the sectors
+ *              written after it, so they are logged before the operation
+ *              is performed on the FLASH.
+ *
+ ****************************************************************************/
+
+static void smart_ckpt_log(FAR struct smart_struct_s *dev, uint8_t type,
+                           uint16_t value)
+{
+  struct smart_ckpt_record_s record;
+  uint32_t  offset;
+
+  if (!dev->ckptvalid)
+    {
+      return;
+    }
+
+  if (dev->ckptlogpos >= dev->ckptlogsize)
+    {
+      /* The log is full.  A new checkpoint is written on the next poll. */
+
+      smart_ckpt_invalidate(dev);
+      return;
+    }
+
+  record.type     = type;
+  record.reserved = (uint8_t)~CONFIG_SMARTFS_ERASEDSTATE;
+  record.value[0] = value & 0xff;
+  record.value[1] = value >> 8;
+
+  offset = smart_ckpt_offset(dev, dev->ckptslot) + dev->ckptlogoffset +
+           dev->ckptlogpos * sizeof(struct smart_ckpt_record_s);
+
+  if (smart_ckpt_program(dev, offset, sizeof(struct smart_ckpt_record_s),
+                         (FAR const uint8_t *)&record) != OK)
+    {
+      smart_ckpt_invalidate(dev);
+      return;
+    }
+
+  dev->ckptlogpos++;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_firstfree
+ *
+ * Description: Returns the index of the first free sector in an erase
+ *              block.  Sectors are allocated in order from the beginning of
+ *              an erase block, so only the sectors from this index on may be
+ *              written after the checkpoint.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static uint8_t smart_ckpt_firstfree(FAR struct smart_struct_s *dev,
+                                    uint16_t block)
+{
+  int       used;
+
+  used = dev->availSectPerBlk - dev->freecount[block];
+  if (block == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+    {
+      used -= 2;
+    }
+
+  return used < 0 ? 0 : used;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_stream
+ *
+ * Description: Adds data to the checkpoint being written.  Data is staged
+ *              in the checkpoint buffer and written one MTD block at a time.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_stream(FAR struct smart_struct_s *dev,
+                             FAR uint32_t *pos, FAR const uint8_t *data,
+                             size_t len, bool flush)
+{
+  size_t    index;
+  size_t    nbytes;
+
+  while (len > 0 || (flush && *pos % dev->geo.blocksize != 0))
+    {
+      index = *pos % dev->geo.blocksize;
+      if (len > 0)
         {
-          /* Uh-oh, we found more than 1 physical sector claiming to be
-           * the same logical sector.  Use the sequence number information
-           * to resolve who wins.
-           */
+          nbytes = dev->geo.blocksize - index;
+          if (nbytes > len)
+            {
+              nbytes = len;
+            }
+
+          memcpy(&dev->ckptbuf[index], data, nbytes);
+          data += nbytes;
+          len  -= nbytes;
+        }
+      else
+        {
+          /* Pad the last block with the erased state */
+
+          nbytes = dev->geo.blocksize - index;
+          memset(&dev->ckptbuf[index], CONFIG_SMARTFS_ERASEDSTATE, nbytes);
+        }
+
+      *pos += nbytes;
+      if (*pos % dev->geo.blocksize == 0)
+        {
+          if (MTD_BWRITE(dev->mtd, *pos / dev->geo.blocksize - 1, 1,
+                         dev->ckptbuf) != 1)
+            {
+              return -EIO;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_write
+ *
+ * Description: Writes a checkpoint of the logical to physical sector map
+ *              and the free and release counts into the checkpoint slot
+ *              that is not in use, then invalidates the previous checkpoint.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_write(FAR struct smart_struct_s *dev)
+{
+  FAR struct smart_ckpt_header_s *hdr;
+  uint32_t  mapsize;
+  uint32_t  base;
+  uint32_t  pos;
+  uint32_t  crc;
+  uint16_t  block;
+  uint8_t   firstfree;
+  uint8_t   slot;
+  int       ret;
+
+  slot = dev->ckptslot ^ 1;
+  base = smart_ckpt_offset(dev, slot);
+
+  ret = MTD_ERASE(dev->mtd, base / dev->erasesize, dev->ckptblocks);
+  if (ret < 0)
+    {
+      fdbg("Error %d erasing checkpoint slot %d\n", -ret, slot);
+      return ret;
+    }
+
+  /* Write the map and the release and free counts (which follow the map in
+   * memory), then the first free sector of each erase block.
+   */
+
+  mapsize = dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1);
+  pos     = base + dev->geo.blocksize;
+
+  crc = crc32part((FAR const uint8_t *)dev->sMap, mapsize, 0);
+  ret = smart_ckpt_stream(dev, &pos, (FAR const uint8_t *)dev->sMap,
+                          mapsize, false);
+
+  for (block = 0; block < dev->neraseblocks && ret == OK; block++)
+    {
+      firstfree = smart_ckpt_firstfree(dev, block);
+      crc = crc32part(&firstfree, 1, crc);
+      ret = smart_ckpt_stream(dev, &pos, &firstfree, 1, false);
+    }
+
+  if (ret == OK)
+    {
+      ret = smart_ckpt_stream(dev, &pos, NULL, 0, true);
+    }
+
+  if (ret < 0)
+    {
+      fdbg("Error %d writing checkpoint\n", -ret);
+      return ret;
+    }
+
+  /* Writing the header commits the checkpoint */
+
+  memset(dev->ckptbuf, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+  hdr = (FAR struct smart_ckpt_header_s *)dev->ckptbuf;
+  hdr->magic[0]       = SMART_CKPT_SIG1;
+  hdr->magic[1]       = SMART_CKPT_SIG2;
+  hdr->magic[2]       = SMART_CKPT_SIG3;
+  hdr->magic[3]       = SMART_CKPT_SIG4;
+  hdr->state          = SMART_CKPT_STATE_VALID;
+  hdr->version        = SMART_CKPT_VERSION;
+  hdr->sectorsize     = dev->sectorsize;
+  hdr->totalsectors   = dev->totalsectors;
+  hdr->neraseblocks   = dev->neraseblocks;
+  hdr->freesectors    = dev->freesectors;
+  hdr->releasesectors = dev->releasesectors;
+  hdr->seq            = dev->ckptseq + 1;
+  hdr->crc            = crc;
+
+  if (MTD_BWRITE(dev->mtd, base / dev->geo.blocksize, 1, dev->ckptbuf) != 1)
+    {
+      fdbg("Error writing checkpoint header\n");
+      return -EIO;
+    }
+
+  /* Now the previous checkpoint is stale.  Mark it invalid even if it was
+   * not loaded;  it may still be marked valid on the FLASH.
+   */
+
+  dev->ckptvalid = true;
+  smart_ckpt_invalidate(dev);
+
+  dev->ckptslot   = slot;
+  dev->ckptseq++;
+  dev->ckptvalid  = true;
+  dev->ckptlogpos = 0;
+  dev->ckptwrites = 0;
+
+  fvdbg("Checkpoint %d written to slot %d\n", dev->ckptseq, slot);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_poll
+ *
+ * Description: Writes a new checkpoint if there is none or if the mount
+ *              time scan or the log after the current checkpoint have grown
+ *              too large.
+ *
+ ****************************************************************************/
+
+static void smart_ckpt_poll(FAR struct smart_struct_s *dev)
+{
+  if (dev->ckptblocks == 0 || dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return;
+    }
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+  /* Wait until the temporary allocations have been written.  Otherwise
+   * sectors that are allocated but still erased could not be told apart
+   * from free sectors when the checkpoint is loaded.
+   */
+
+  if (dev->allocsector != NULL)
+    {
+      return;
+    }
+#endif
+
+  if (!dev->ckptvalid ||
+      dev->ckptwrites >= CONFIG_MTD_SMART_CHECKPOINT_INTERVAL ||
+      dev->ckptlogpos >= (dev->ckptlogsize >> 1))
+    {
+      smart_ckpt_write(dev);
+    }
+}
+#endif /* CONFIG_FS_WRITABLE */
+
+/****************************************************************************
+ * Name: smart_ckpt_iserased
+ *
+ * Description: Returns true if a sector header has never been written.
+ *
+ ****************************************************************************/
+
+static bool smart_ckpt_iserased(FAR const struct smart_sect_header_s *header)
+{
+  FAR const uint8_t *ptr = (FAR const uint8_t *)header;
+  int       x;
+
+  for (x = 0; x < sizeof(struct smart_sect_header_s); x++)
+    {
+      if (ptr[x] != CONFIG_SMARTFS_ERASEDSTATE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_replay
+ *
+ * Description: Applies one record of the checkpoint log to the map and the
+ *              free and release counts loaded from the checkpoint.  The
+ *              records that follow it are needed to tell if the FLASH may
+ *              still be updated for a freed sector.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_replay(FAR struct smart_struct_s *dev,
+                             FAR const struct smart_ckpt_record_s *log,
+                             size_t index, size_t nrecords,
+                             FAR uint8_t *firstfree)
+{
+  struct    smart_sect_header_s header;
+  uint32_t  readaddress;
+  uint16_t  value;
+  uint16_t  physsector;
+  uint16_t  block;
+  uint16_t  sector;
+  uint8_t   prerelease;
+  int       ret;
+
+  value = log[index].value[0] | (log[index].value[1] << 8);
+  if (log[index].type == SMART_CKPT_REC_ERASE && value < dev->neraseblocks)
+    {
+      /* The erase block was erased:  Forget its sectors and scan all of it */
+
+      for (sector = 0; sector < dev->totalsectors; sector++)
+        {
+          if (dev->sMap[sector] != 0xFFFF &&
+              dev->sMap[sector] / dev->sectorsPerBlk == value)
+            {
+              dev->sMap[sector] = 0xFFFF;
+            }
+        }
+
+      if (value == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+        {
+          prerelease = 2;
+        }
+      else
+        {
+          prerelease = 0;
+        }
+
+      dev->freesectors += dev->availSectPerBlk - prerelease -
+                          dev->freecount[value];
+      dev->releasesectors -= dev->releasecount[value] - prerelease;
+      dev->releasecount[value] = prerelease;
+      dev->freecount[value] = dev->availSectPerBlk - prerelease;
+      firstfree[value] = 0;
+    }
+  else if (log[index].type == SMART_CKPT_REC_FREE &&
+           value < dev->totalsectors)
+    {
+      /* The logical sector was freed */
+
+      physsector = dev->sMap[value];
+      if (physsector == 0xFFFF)
+        {
+          return OK;
+        }
+
+      block = physsector / dev->sectorsPerBlk;
+      dev->sMap[value] = 0xFFFF;
+      dev->releasesectors++;
+      dev->releasecount[block]++;
+
+      /* The release may not have reached the FLASH.  The sector can only be
+       * updated if its erase block was not erased (and reused) since.
+       */
+
+      for (index++; index < nrecords; index++)
+        {
+          if (log[index].type == SMART_CKPT_REC_ERASE &&
+              (log[index].value[0] | (log[index].value[1] << 8)) == block)
+            {
+              return OK;
+            }
+        }
+
+      readaddress = physsector * dev->mtdBlksPerSector * dev->geo.blocksize;
+      ret = MTD_READ(dev->mtd, readaddress,
+                     sizeof(struct smart_sect_header_s),
+                     (FAR uint8_t *)&header);
+      if (ret != sizeof(struct smart_sect_header_s))
+        {
+          return -EIO;
+        }
+
+      if (*((FAR uint16_t *)header.logicalsector) == value &&
+          (header.status & SMART_STATUS_RELEASED) ==
+              (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+        {
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+          header.status &= ~SMART_STATUS_RELEASED;
+#else
+          header.status |= SMART_STATUS_RELEASED;
+#endif
+          ret = smart_bytewrite(dev, readaddress +
+                                offsetof(struct smart_sect_header_s, status),
+                                1, &header.status);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_load
+ *
+ * Description: Loads the sector map and the free and release counts from
+ *              the latest valid checkpoint, applies the checkpoint log and
+ *              scans only the sectors that were free when the checkpoint
+ *              was written.  Returns a negated errno value if there is no
+ *              usable checkpoint; a full scan is needed then.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_load(FAR struct smart_struct_s *dev)
+{
+  struct    smart_ckpt_header_s hdr[2];
+  struct    smart_sect_header_s header;
+  FAR struct smart_ckpt_record_s *log;
+  FAR uint8_t *firstfree;
+  uint32_t  mapsize;
+  uint32_t  base;
+  uint32_t  readaddress;
+  uint16_t  block;
+  uint16_t  sector;
+  uint16_t  nfree;
+  size_t    nrecords;
+  size_t    x;
+  uint8_t   valid = 0;
+  int       slot = -1;
+  int       ret;
+
+  dev->ckptvalid = false;
+  if (dev->ckptblocks == 0)
+    {
+      return -ENOENT;
+    }
+
+  /* Find the newest valid checkpoint header */
+
+  for (x = 0; x < 2; x++)
+    {
+      ret = MTD_READ(dev->mtd, smart_ckpt_offset(dev, x),
+                     sizeof(struct smart_ckpt_header_s),
+                     (FAR uint8_t *)&hdr[x]);
+      if (ret != sizeof(struct smart_ckpt_header_s) ||
+          hdr[x].magic[0] != SMART_CKPT_SIG1 ||
+          hdr[x].magic[1] != SMART_CKPT_SIG2 ||
+          hdr[x].magic[2] != SMART_CKPT_SIG3 ||
+          hdr[x].magic[3] != SMART_CKPT_SIG4)
+        {
+          continue;
+        }
+
+      /* New checkpoints must be numbered after any on the device */
+
+      if ((int32_t)(hdr[x].seq - dev->ckptseq) > 0)
+        {
+          dev->ckptseq = hdr[x].seq;
+        }
+
+      if (hdr[x].state != SMART_CKPT_STATE_VALID)
+        {
+          continue;
+        }
+
+      valid |= 1 << x;
+      if (hdr[x].version != SMART_CKPT_VERSION ||
+          hdr[x].sectorsize != dev->sectorsize ||
+          hdr[x].totalsectors != dev->totalsectors ||
+          hdr[x].neraseblocks != dev->neraseblocks)
+        {
+          continue;
+        }
+
+      if (slot < 0 || (int32_t)(hdr[x].seq - hdr[slot].seq) > 0)
+        {
+          slot = x;
+        }
+    }
+
+  if (slot < 0)
+    {
+      ret = -ENOENT;
+      goto errout_with_invalidate;
+    }
+
+  firstfree = (FAR uint8_t *)kmm_malloc(dev->neraseblocks);
+  if (firstfree == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_invalidate;
+    }
+
+  /* Read the map and the counts and verify the CRC */
+
+  base    = smart_ckpt_offset(dev, slot);
+  mapsize = dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1);
+
+  ret = MTD_READ(dev->mtd, base + dev->geo.blocksize, mapsize,
+                 (FAR uint8_t *)dev->sMap);
+  if (ret == mapsize)
+    {
+      ret = MTD_READ(dev->mtd, base + dev->geo.blocksize + mapsize,
+                     dev->neraseblocks, firstfree);
+    }
+
+  if (ret != dev->neraseblocks ||
+      crc32part(firstfree, dev->neraseblocks,
+                crc32part((FAR const uint8_t *)dev->sMap, mapsize, 0)) !=
+      hdr[slot].crc)
+    {
+      fdbg("Checkpoint %d is corrupt\n", hdr[slot].seq);
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  dev->freesectors    = hdr[slot].freesectors;
+  dev->releasesectors = hdr[slot].releasesectors;
+
+  /* Read the log and apply the records in the order they were written */
+
+  log = (FAR struct smart_ckpt_record_s *)
+    kmm_malloc(dev->ckptlogsize * sizeof(struct smart_ckpt_record_s));
+  if (log == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = MTD_READ(dev->mtd, base + dev->ckptlogoffset,
+                 dev->ckptlogsize * sizeof(struct smart_ckpt_record_s),
+                 (FAR uint8_t *)log);
+  if (ret != dev->ckptlogsize * sizeof(struct smart_ckpt_record_s))
+    {
+      kmm_free(log);
+      ret = -EIO;
+      goto errout;
+    }
+
+  for (nrecords = 0; nrecords < dev->ckptlogsize; nrecords++)
+    {
+      if (log[nrecords].type == CONFIG_SMARTFS_ERASEDSTATE)
+        {
+          break;
+        }
+    }
+
+  for (x = 0; x < nrecords; x++)
+    {
+      ret = smart_ckpt_replay(dev, log, x, nrecords, firstfree);
+      if (ret < 0)
+        {
+          kmm_free(log);
+          goto errout;
+        }
+    }
+
+  kmm_free(log);
+  dev->ckptlogpos = nrecords;
+
+  /* Scan the sectors that were free when the checkpoint was written up to
+   * the first sector that is still erased.
+   */
+
+  for (block = 0; block < dev->neraseblocks; block++)
+    {
+      nfree = 0;
+      for (x = firstfree[block]; x < dev->availSectPerBlk; x++)
+        {
+          sector = block * dev->sectorsPerBlk + x;
+          if (sector >= dev->totalsectors)
+            {
+              break;
+            }
+
+          readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+          ret = MTD_READ(dev->mtd, readaddress,
+                         sizeof(struct smart_sect_header_s),
+                         (FAR uint8_t *)&header);
+          if (ret != sizeof(struct smart_sect_header_s))
+            {
+              ret = -EIO;
+              goto errout;
+            }
+
+          if (smart_ckpt_iserased(&header))
+            {
+              if (++nfree > SMART_CKPT_LOOKAHEAD)
+                {
+                  break;
+                }
+
+              continue;
+            }
+
+          nfree = 0;
+          ret = smart_scan_sector(dev, sector, &header);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+        }
+    }
+
+  kmm_free(firstfree);
+
+  /* Check the format sector if it was not written after the checkpoint */
+
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED && dev->sMap[0] != 0xFFFF)
+    {
+      ret = smart_checkformat(dev, dev->sMap[0]);
+      if (ret < 0 && ret != -EINVAL)
+        {
+          goto errout_with_invalidate;
+        }
+    }
+
+  dev->ckptslot   = slot;
+  dev->ckptvalid  = true;
+  dev->ckptwrites = 0;
+
+  fvdbg("Loaded checkpoint %d: %d log records\n", dev->ckptseq,
+        dev->ckptlogpos);
+  return OK;
+
+errout:
+  kmm_free(firstfree);
+
+errout_with_invalidate:
+
+  /* Changes made after the full scan are not logged, so a checkpoint that
+   * could not be used must not be found by a later mount.
+   */
+
+  for (x = 0; x < 2; x++)
+    {
+      if ((valid & (1 << x)) != 0)
+        {
+          dev->ckptslot  = x;
+          dev->ckptvalid = true;
+          smart_ckpt_invalidate(dev);
+        }
+    }
+
+  return ret;
+}
+#endif /* CONFIG_MTD_SMART_CHECKPOINT */
+
+/****************************************************************************
+ * Name: smart_scan
+ *
+ * Description: Performs a scan of the MTD device searching for format
+ *              information and fills in logical sector mapping, freesector
+ *              count, etc.
+ *
+ ****************************************************************************/
+
+static int smart_scan(FAR struct smart_struct_s *dev)
+{
+  int       sector;
+  int       ret;
+  uint16_t  totalsectors;
+  uint16_t  sectorsize, prerelease;
+  uint32_t  readaddress;
+  uint32_t  offset;
+  struct    smart_sect_header_s header;
+
+  fvdbg("Entry\n");
+
+  /* Find the sector size on the volume by reading headers from
+   * sectors of decreasing size.  On a formatted volume, the sector
+   * size is saved in the header status byte of seach sector, so
+   * by starting with the largest supported sector size and
+   * decreasing from there, we will be sure to find data that is
+   * a header and not sector data.
+   */
+
+  sectorsize = 0xFFFF;
+  offset = 16384;
+
+  while (sectorsize == 0xFFFF)
+    {
+      readaddress = 0;
 
+      while (readaddress < dev->erasesize * dev->geo.neraseblocks)
+        {
+          /* Read the next sector from the device */
 
-#if SMART_STATUS_VERSION == 1
-          if (header.status & SMART_STATUS_CRC)
+          ret = MTD_READ(dev->mtd, 0, sizeof(struct smart_sect_header_s),
+                         (FAR uint8_t *) &header);
+          if (ret != sizeof(struct smart_sect_header_s))
             {
-              seq2 = header.seq;
+              goto err_out;
             }
-          else
+
+          if (header.status != CONFIG_SMARTFS_ERASEDSTATE)
             {
-              seq2 = *((FAR uint16_t *) &header.seq);
+              sectorsize = (header.status & SMART_STATUS_SIZEBITS) << 7;
+              break;
             }
-#else
-          seq2 = header.seq;
-#endif
-
-          /* We must re-read the 1st physical sector to get it's seq number */
 
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-          readaddress = dev->sMap[logicalsector]  * dev->mtdBlksPerSector * dev->geo.blocksize;
-#else
-          /* For minimize RAM, we have to rescan to find the 1st sector claiming to
-           * be this logical sector.
-           */
+          readaddress += offset;
+        }
 
-          for (dupsector = 0; dupsector < sector; dupsector++)
-            {
-              /* Calculate the read address for this sector */
+      offset >>= 1;
+      if (offset < 256 && sectorsize == 0xFFFF)
+        {
+          sectorsize = CONFIG_MTD_SMART_SECTOR_SIZE;
+        }
+    }
 
-              readaddress = dupsector * dev->mtdBlksPerSector * dev->geo.blocksize;
+  /* Now set the sectorsize and other sectorsize derived variables */
 
-              /* Read the header for this sector */
+  ret = smart_setsectorsize(dev, sectorsize);
+  if (ret != OK)
+    {
+      goto err_out;
+    }
 
-              ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
-                             (FAR uint8_t *) &header);
-              if (ret != sizeof(struct smart_sect_header_s))
-                {
-                  goto err_out;
-                }
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Load the sector map from the last checkpoint if there is one.  Only the
+   * sectors written after the checkpoint need to be scanned then.
+   */
 
-              /* Get the logical sector number for this physical sector */
+  dev->formatstatus = SMART_FMT_STAT_NOFMT;
+  ret = smart_ckpt_load(dev);
+  if (ret == OK)
+    {
+      goto scan_done;
+    }
 
-              duplogsector = *((FAR uint16_t *) header.logicalsector);
-#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
-              if (duplogsector == 0)
-                {
-                  duplogsector = -1;
-                }
+  fvdbg("No checkpoint: %d\n", ret);
 #endif
 
-              /* Test if this sector has been committed */
-
-              if ((header.status & SMART_STATUS_COMMITTED) ==
-                      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
-                {
-                  continue;
-                }
-
-              /* Test if this sector has been release and skip it if it has */
-
-              if ((header.status & SMART_STATUS_RELEASED) !=
-                      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
-                {
-                  continue;
-                }
-
-              if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
-                {
-                  continue;
-                }
+  /* Initialize the device variables */
 
-              /* Now compare if this logical sector matches the current sector */
+  totalsectors = dev->totalsectors;
+  dev->formatstatus = SMART_FMT_STAT_NOFMT;
+  dev->freesectors = dev->availSectPerBlk * dev->neraseblocks;
+  dev->releasesectors = 0;
 
-              if (duplogsector == logicalsector)
-                {
-                  break;
-                }
-            }
-#endif
+  /* Initialize the freecount and releasecount arrays */
 
-          ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
-                  (FAR uint8_t *) &header);
-          if (ret != sizeof(struct smart_sect_header_s))
-            {
-              goto err_out;
-            }
+  for (sector = 0; sector < dev->neraseblocks; sector++)
+    {
+      if (sector == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+        {
+          prerelease = 2;
+        }
+      else
+        {
+          prerelease = 0;
+        }
 
-#if SMART_STATUS_VERSION == 1
-          if (header.status & SMART_STATUS_CRC)
-            {
-              seq1 = header.seq;
-            }
-          else
-            {
-              seq1 = *((FAR uint16_t *) &header.seq);
-            }
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      smart_set_count(dev, dev->freecount, sector, dev->availSectPerBlk - prerelease);
+      smart_set_count(dev, dev->releasecount, sector, prerelease);
 #else
-          seq1 = header.seq;
+      dev->freecount[sector] = dev->availSectPerBlk - prerelease;
+      dev->releasecount[sector] = prerelease;
 #endif
+    }
 
-          /* Now determine who wins */
-
-          if ((seq1 > 0xFFF0 && seq2 < 10) || seq2 > seq1)
-            {
-              /* Seq 2 is the winner ... bigger or it wrapped */
+  /* Initialize the sector map */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-              loser = dev->sMap[logicalsector];
-              dev->sMap[logicalsector] = sector;
+  for (sector = 0; sector < totalsectors; sector++)
+    {
+      dev->sMap[sector] = -1;
+    }
 #else
-              loser = dupsector;
+  /* Clear all logical sector used bits */
+
+  memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
 #endif
-            }
-          else
-            {
-              /* We keep the original mapping and seq2 is the loser */
 
-              loser = sector;
-            }
+  /* Now scan the MTD device */
 
-          /* Now release the loser sector */
+  for (sector = 0; sector < totalsectors; sector++)
+    {
+      fvdbg("Scan sector %d\n", sector);
 
-          readaddress = loser  * dev->mtdBlksPerSector * dev->geo.blocksize;
-          ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
-                  (FAR uint8_t *) &header);
-          if (ret != sizeof(struct smart_sect_header_s))
-            {
-              goto err_out;
-            }
+      /* Calculate the read address for this sector */
 
-#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
-          header.status &= ~SMART_STATUS_RELEASED;
-#else
-          header.status |= SMART_STATUS_RELEASED;
-#endif
-          offset = readaddress + offsetof(struct smart_sect_header_s, status);
-          ret = smart_bytewrite(dev, offset, 1, &header.status);
-          if (ret < 0)
-            {
-              fdbg("Error %d releasing duplicate sector\n", -ret);
-              goto err_out;
-            }
-        }
+      readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
 
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-      /* Update the logical to physical sector map */
+      /* Read the header for this sector */
 
-      dev->sMap[logicalsector] = sector;
-#else
-      /* Mark the logical sector as used in the bitmap */
-      dev->sBitMap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
+      ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+                     (FAR uint8_t *) &header);
+      if (ret != sizeof(struct smart_sect_header_s))
+        {
+          goto err_out;
+        }
+
+      /* Add the sector to the map and the counts */
 
-      if (logicalsector < SMART_FIRST_ALLOC_SECTOR)
+      ret = smart_scan_sector(dev, sector, &header);
+      if (ret < 0)
         {
-          smart_add_sector_to_cache(dev, logicalsector, sector, __LINE__ );
+          goto err_out;
         }
-#endif
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+scan_done:
+#endif
+
 #if defined (CONFIG_MTD_SMART_WEAR_LEVEL) && (SMART_STATUS_VERSION == 1)
 #ifdef CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT
 
@@ -2418,6 +3466,9 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
       dev->unusedsectors += freecount;
       dev->blockerases++;
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      smart_ckpt_log(dev, SMART_CKPT_REC_ERASE, block);
 #endif
       MTD_ERASE(dev->mtd, block, 1);
 
@@ -2438,7 +3489,7 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
        * physical sector if this is the last erase block on the device.
        */
 
-      if (block == dev->geo.neraseblocks - 1 && dev->totalsectors == 65534)
+      if (block == dev->neraseblocks - 1 && dev->totalsectors == 65534)
         {
           prerelease = 2;
         }
@@ -2529,9 +3580,9 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
        */
 
       freecount = dev->sectorsPerBlk + 1;
-      minblock = dev->geo.neraseblocks;
+      minblock = dev->neraseblocks;
       mincount = 0;
-      for (x = 0; x < dev->geo.neraseblocks; x++)
+      for (x = 0; x < dev->neraseblocks; x++)
         {
           if (smart_get_wear_level(dev, x) == dev->minwearlevel)
             {
@@ -2828,6 +3879,12 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
       return ret;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint slots were erased too */
+
+  dev->ckptvalid = false;
+#endif
+
   /* Now construct a logical sector zero header to write to the device. */
 
   sectorheader = (FAR struct smart_sect_header_s *) dev->rwbuffer;
@@ -2916,7 +3973,7 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
     }
 
   dev->formatstatus = SMART_FMT_STAT_UNKNOWN;
-  dev->freesectors = dev->availSectPerBlk * dev->geo.neraseblocks - 1;
+  dev->freesectors = dev->availSectPerBlk * dev->neraseblocks - 1;
   dev->releasesectors = 0;
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   dev->uneven_wearcount = 0;
@@ -3279,6 +4336,9 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 
   /* Now erase the erase block */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_ckpt_log(dev, SMART_CKPT_REC_ERASE, block);
+#endif
   MTD_ERASE(dev->mtd, block, 1);
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   dev->unusedsectors += freecount;
@@ -3574,6 +4634,9 @@ retry:
         {
           physicalsector = x;
           dev->lastallocblock = allocblock;
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+          dev->ckptwrites++;
+#endif
           break;
         }
     }
@@ -3719,6 +4782,137 @@ errout:
 }
 #endif /* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_bggc_needed
+ *
+ * Description:  Returns true if the free sectors are below the background
+ *               garbage collection watermark and there are released sectors
+ *               that can be reclaimed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static bool smart_bggc_needed(FAR struct smart_struct_s *dev)
+{
+  uint32_t  watermark;
+
+  watermark = dev->sectorsPerBlk + 4 +
+              CONFIG_MTD_SMART_BGGC_WATERMARK * dev->availSectPerBlk;
+
+  return dev->formatstatus == SMART_FMT_STAT_FORMATTED &&
+         dev->freesectors < watermark && dev->releasesectors > 0;
+}
+
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Performs one step of background garbage collection:  The
+ *               erase block with the most released sectors is relocated.
+ *               The step is skipped if a foreground request holds the
+ *               device, and the worker yields between steps.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  uint16_t  collectblock;
+  uint16_t  releasemax;
+  uint16_t  count;
+  bool      again;
+  int       x;
+
+  /* Foreground requests have priority.  Try again later if one is active */
+
+  if (sem_trywait(&dev->exclsem) < 0)
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                 SMART_BGGC_DELAY);
+      return;
+    }
+
+  if (smart_bggc_needed(dev))
+    {
+      /* Find the block with the most released sectors */
+
+      collectblock = 0xFFFF;
+      releasemax = 0;
+      for (x = 0; x < dev->neraseblocks; x++)
+        {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+          /* Don't collect blocks that have been worn completely */
+
+          if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+            {
+              continue;
+            }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+          count = smart_get_count(dev, dev->releasecount, x);
+#else
+          count = dev->releasecount[x];
+#endif
+          if (count > releasemax)
+            {
+              releasemax = count;
+              collectblock = x;
+            }
+        }
+
+      if (collectblock != 0xFFFF)
+        {
+          fvdbg("Background collecting block %d, released=%d\n",
+                collectblock, releasemax);
+
+          if (smart_relocate_block(dev, collectblock) < 0)
+            {
+              fdbg("Failed to collect block %d\n", collectblock);
+              collectblock = 0xFFFF;
+            }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+          if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+            {
+              smart_write_wearstatus(dev);
+            }
+#endif
+        }
+
+      again = collectblock != 0xFFFF && smart_bggc_needed(dev);
+    }
+  else
+    {
+      again = false;
+    }
+
+  smart_semgive(dev);
+
+  if (again)
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                 SMART_BGGC_DELAY);
+    }
+}
+
+/****************************************************************************
+ * Name: smart_bggc_schedule
+ *
+ * Description:  Schedules background garbage collection if it is needed
+ *               and not already pending.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_schedule(FAR struct smart_struct_s *dev)
+{
+  if (work_available(&dev->gcwork) && smart_bggc_needed(dev))
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                 SMART_BGGC_DELAY);
+    }
+}
+#endif /* CONFIG_MTD_SMART_BGGC */
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -3738,7 +4932,7 @@ static int smart_write_wearstatus(struct smart_struct_s *dev)
   uint8_t   buffer[8], write_buffer = 0;
 
   sector = 0;
-  remaining = dev->geo.neraseblocks >> 1;
+  remaining = dev->neraseblocks >> 1;
   memset(buffer, 0xFF, sizeof(buffer));
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
@@ -3791,7 +4985,7 @@ static int smart_write_wearstatus(struct smart_struct_s *dev)
       req.logsector = sector;
       req.offset = SMARTFS_FMT_WEAR_POS;
       req.count = towrite;
-      req.buffer = &dev->wearstatus[(dev->geo.neraseblocks >> SMART_WEAR_BIT_DIVIDE) -
+      req.buffer = &dev->wearstatus[(dev->neraseblocks >> SMART_WEAR_BIT_DIVIDE) -
                     remaining];
 
       /* Write the sector */
@@ -3888,7 +5082,7 @@ static inline int smart_read_wearstatus(FAR struct smart_struct_s *dev)
 
   /* Read all wear level bits from the flash */
 
-  remaining = dev->geo.neraseblocks >> 1;
+  remaining = dev->neraseblocks >> 1;
   while (remaining)
     {
       /* Calculate number of bytes to read from this sector */
@@ -3904,7 +5098,7 @@ static inline int smart_read_wearstatus(FAR struct smart_struct_s *dev)
       req.logsector = sector;
       req.offset = SMARTFS_FMT_WEAR_POS;
       req.count = toread;
-      req.buffer = &dev->wearstatus[(dev->geo.neraseblocks >> SMART_WEAR_BIT_DIVIDE) -
+      req.buffer = &dev->wearstatus[(dev->neraseblocks >> SMART_WEAR_BIT_DIVIDE) -
                     remaining];
 
       /* Read the sector */
@@ -3941,7 +5135,7 @@ static inline int smart_read_wearstatus(FAR struct smart_struct_s *dev)
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   /* Set the erase counts equal to the wear levels */
 
-  for (sector = 0; sector < dev->geo.neraseblocks; sector++)
+  for (sector = 0; sector < dev->neraseblocks; sector++)
     {
       dev->erasecounts[sector] = smart_get_wear_level(dev, sector);
     }
@@ -4130,7 +5324,7 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
 
       offset = dev->minwearlevel;
       fvdbg("Reducing wear level bits by %d\n", offset);
-      for (x = 0; x < dev->geo.neraseblocks; x++)
+      for (x = 0; x < dev->neraseblocks; x++)
         {
           smart_set_wear_level(dev, x, smart_get_wear_level(dev, x) - offset);
         }
@@ -4924,6 +6118,14 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev,
       goto errout;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Record the release in the checkpoint log first.  It cannot be found
+   * by scanning the sectors written after the checkpoint.
+   */
+
+  smart_ckpt_log(dev, SMART_CKPT_REC_FREE, logicalsector);
+#endif
+
   /* Mark the sector as released */
 
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
@@ -4996,6 +6198,10 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+  /* Get exclusive access to the device */
+
+  smart_semtake(dev);
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5012,7 +6218,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           fdbg("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5052,6 +6259,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       /* Allocate a logical sector for the upper layer file system */
 
       ret = smart_allocsector(dev, arg);
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      smart_ckpt_poll(dev);
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+      smart_bggc_schedule(dev);
+#endif
       goto ok_out;
 
     case BIOC_FREESECT:
@@ -5059,6 +6272,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       /* Free the specified logical sector */
 
       ret = smart_freesector(dev, arg);
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      smart_ckpt_poll(dev);
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+      smart_bggc_schedule(dev);
+#endif
       goto ok_out;
 
     case BIOC_WRITESECT:
@@ -5076,6 +6295,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
         }
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      smart_ckpt_poll(dev);
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+      smart_bggc_schedule(dev);
+#endif
       goto ok_out;
 #endif /* CONFIG_FS_WRITABLE */
 
@@ -5104,7 +6329,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
-      procfs_data->neraseblocks = dev->geo.neraseblocks;
+      procfs_data->neraseblocks = dev->neraseblocks;
       procfs_data->erasecounts = dev->erasecounts;
 #endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
@@ -5147,6 +6372,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+  smart_semgive(dev);
   return ret;
 }
 
@@ -5232,6 +6458,13 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #endif
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
       dev->allocsector = NULL;
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      dev->ckptbuf = NULL;
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+      sem_init(&dev->exclsem, 0, 1);
+      memset(&dev->gcwork, 0, sizeof(struct work_s));
 #endif
       dev->sectorsize = 0;
       ret = smart_setsectorsize(dev, CONFIG_MTD_SMART_SECTOR_SIZE);
@@ -5255,7 +6488,7 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
         }
 
       dev->totalsectors = (uint16_t) totalsectors;
-      dev->freesectors = (uint16_t) dev->availSectPerBlk * dev->geo.neraseblocks;
+      dev->freesectors = (uint16_t) dev->availSectPerBlk * dev->neraseblocks;
       dev->lastallocblock = 0;
       dev->debuglevel = 0;
 
@@ -5349,6 +6582,9 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_free(dev, dev->ckptbuf);
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   if (rootdirdev)
     {
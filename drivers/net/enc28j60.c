@@ -87,6 +87,7 @@
  *   devices that will be supported.
  * CONFIG_ENC28J60_STATS - Collect network statistics
  * CONFIG_ENC28J60_HALFDUPPLEX - Default is full duplex
+ * CONFIG_ENC28J60_BUDGET - Max. number of RX packets per poll
  */
 
 /* The ENC28J60 spec says that it supports SPI mode 0,0 only: "The
@@ -108,6 +109,14 @@
 #  define CONFIG_ENC28J60_NINTERFACES 1
 #endif
 
+/* CONFIG_ENC28J60_BUDGET is the maximum number of packets received each
+ * time that the interrupt worker runs.  See netdev_napi_poll().
+ */
+
+#ifndef CONFIG_ENC28J60_BUDGET
+#  define CONFIG_ENC28J60_BUDGET CONFIG_NETDEV_NAPI_BUDGET
+#endif
+
 /* CONFIG_NET_ETH_MTU must always be defined */
 
 #if !defined(CONFIG_NET_ETH_MTU) && (CONFIG_NET_ETH_MTU <= MAX_FRAMELEN)
@@ -120,6 +129,18 @@
 #  error "Worker thread support is required (CONFIG_SCHED_WORKQUEUE)"
 #endif
 
+/* Interrupts are handled on the high priority work queue.  When the
+ * receive budget is used up, polling continues on the low priority work
+ * queue (if there is one) so that a flood of received packets does not
+ * starve other work and higher priority tasks.
+ */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define ENCWORK_POLL LPWORK
+#else
+#  define ENCWORK_POLL HPWORK
+#endif
+
 /* CONFIG_ENC28J60_DUMPPACKET will dump the contents of each packet to the console. */
 
 #ifdef CONFIG_ENC28J60_DUMPPACKET
@@ -249,6 +270,11 @@ struct enc_driver_s
   struct work_s         irqwork;       /* Interrupt continuation work queue support */
   struct work_s         towork;        /* Tx timeout work queue support */
   struct work_s         pollwork;      /* Poll timeout work queue support */
+  struct work_s         txwork;        /* TX availability work queue support */
+
+  /* Budgeted receive polling */
+
+  struct netdev_napi_s  napi;          /* RX budget, mode and counts */
 
   /* This is the contained SPI driver intstance */
 
@@ -332,6 +358,7 @@ static void enc_txerif(FAR struct enc_driver_s *priv);
 static void enc_rxerif(FAR struct enc_driver_s *priv);
 static void enc_rxdispatch(FAR struct enc_driver_s *priv);
 static void enc_pktif(FAR struct enc_driver_s *priv);
+static int  enc_rxpoll(FAR struct net_driver_s *dev);
 static void enc_irqworker(FAR void *arg);
 static int  enc_interrupt(int irq, FAR void *context);
 
@@ -341,6 +368,7 @@ static void enc_toworker(FAR void *arg);
 static void enc_txtimeout(int argc, uint32_t arg, ...);
 static void enc_pollworker(FAR void *arg);
 static void enc_polltimer(int argc, uint32_t arg, ...);
+static void enc_txavailworker(FAR void *arg);
 
 /* NuttX callback functions */
 
@@ -1189,7 +1217,7 @@ static int enc_transmit(FAR struct enc_driver_s *priv)
  *   OK on success; a negated errno on failure
  *
  * Assumptions:
- *   Interrupts are enabled but the caller holds the uIP lock.
+ *   The caller holds the device lock, the SPI bus and the stack lock.
  *
  ****************************************************************************/
 
@@ -1282,12 +1310,14 @@ static void enc_linkstatus(FAR struct enc_driver_s *priv)
  *   None
  *
  * Assumptions:
- *   Interrupts are enabled but the caller holds the uIP lock.
+ *   The caller holds the device lock and the SPI bus.
  *
  ****************************************************************************/
 
 static void enc_txif(FAR struct enc_driver_s *priv)
 {
+  net_lock_t state;
+
   /* Update statistics */
 
 #ifdef CONFIG_ENC28J60_STATS
@@ -1308,7 +1338,9 @@ static void enc_txif(FAR struct enc_driver_s *priv)
 
   /* Then poll uIP for new XMIT data */
 
+  state = net_lock();
   (void)devif_poll(&priv->dev, enc_txpoll);
+  net_unlock(state);
 }
 
 /****************************************************************************
@@ -1395,7 +1427,7 @@ static void enc_rxerif(FAR struct enc_driver_s *priv)
  *   None
  *
  * Assumptions:
- *   Interrupts are enabled but the caller holds the uIP lock.
+ *   The caller holds the device lock, the SPI bus and the stack lock.
  *
  ****************************************************************************/
 
@@ -1521,12 +1553,13 @@ static void enc_rxdispatch(FAR struct enc_driver_s *priv)
  *   None
  *
  * Assumptions:
- *   Interrupts are enabled but the caller holds the uIP lock.
+ *   The caller holds the device lock and the SPI bus.
  *
  ****************************************************************************/
 
 static void enc_pktif(FAR struct enc_driver_s *priv)
 {
+  net_lock_t state;
   uint8_t  rsv[6];
   uint16_t pktlen;
   uint16_t rxstat;
@@ -1603,9 +1636,11 @@ static void enc_pktif(FAR struct enc_driver_s *priv)
       enc_rdbuffer(priv, priv->dev.d_buf, priv->dev.d_len);
       enc_dumppacket("Received Packet", priv->dev.d_buf, priv->dev.d_len);
 
-      /* Dispatch the packet to uIP */
+      /* Dispatch the packet to uIP.  Only this step needs the stack lock. */
 
+      state = net_lock();
       enc_rxdispatch(priv);
+      net_unlock(state);
     }
 
   /* Move the RX read pointer to the start of the next received packet.
@@ -1620,12 +1655,58 @@ static void enc_pktif(FAR struct enc_driver_s *priv)
   enc_bfsgreg(priv, ENC_ECON2, ECON2_PKTDEC);
 }
 
+/****************************************************************************
+ * Function: enc_rxpoll
+ *
+ * Description:
+ *   Receive one packet, if there is one, under the receive budget of
+ *   netdev_napi_poll().
+ *
+ * Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   1 if a packet was received; 0 if the receive buffer is empty
+ *
+ * Assumptions:
+ *   The caller holds the device lock and the SPI bus.
+ *
+ ****************************************************************************/
+
+static int enc_rxpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)dev->d_private;
+  uint8_t pktcnt;
+
+  pktcnt = enc_rdbreg(priv, ENC_EPKTCNT);
+  if (pktcnt == 0)
+    {
+      return 0;
+    }
+
+  nllvdbg("EPKTCNT: %02x\n", pktcnt);
+
+#ifdef CONFIG_ENC28J60_STATS
+  if (pktcnt > priv->stats.maxpktcnt)
+    {
+      priv->stats.maxpktcnt = pktcnt;
+    }
+#endif
+
+  /* Handle packet receipt */
+
+  enc_pktif(priv);
+  return 1;
+}
+
 /****************************************************************************
  * Function: enc_irqworker
  *
  * Description:
  *   Perform interrupt handling logic outside of the interrupt handler (on
- *   the work queue thread).
+ *   the work queue thread).  If more packets were received than the
+ *   receive budget allows, the GPIO interrupt is left disabled and the
+ *   worker is re-queued to poll for the remaining packets.
  *
  * Parameters:
  *   arg     - The reference to the driver structure (case to void*)
@@ -1645,11 +1726,25 @@ static void enc_irqworker(FAR void *arg)
 
   DEBUGASSERT(priv);
 
-  /* Get exclusive access to both uIP and the SPI bus. */
+  /* Get exclusive access to the device and the SPI bus.  The stack lock is
+   * taken only while received packets are processed and while polling for
+   * TX data.
+   */
 
-  lock = net_lock();
+  lock = netdev_lock(&priv->dev);
   enc_lock(priv);
 
+  /* The interface may have been taken down while we were polling */
+
+  if (priv->ifstate != ENCSTATE_UP)
+    {
+      goto errout;
+    }
+
+  /* Start a new poll with a full receive budget */
+
+  netdev_napi_begin(&priv->napi);
+
   /* Disable further interrupts by clearing the global interrupt enable bit.
    * "After an interrupt occurs, the host controller should clear the global
    * enable bit for the interrupt pin before servicing the interrupt. Clearing
@@ -1661,12 +1756,14 @@ static void enc_irqworker(FAR void *arg)
 
   enc_bfcgreg(priv, ENC_EIE, EIE_INTIE);
 
-  /* Loop until all interrupts have been processed (EIR==0).  Note that
-   * there is no infinite loop check... if there are always pending interrupts,
-   * we are just broken.
+  /* Loop until all interrupts have been processed (EIR==0) or until the
+   * receive budget has been used up.  Note that there is no other infinite
+   * loop check... if there are always pending interrupts, we are just
+   * broken.
    */
 
-  while ((eir = enc_rdgreg(priv, ENC_EIR) & EIR_ALLINTS) != 0)
+  while (!netdev_napi_exhausted(&priv->napi) &&
+         (eir = enc_rdgreg(priv, ENC_EIR) & EIR_ALLINTS) != 0)
     {
       /* Handle interrupts according to interrupt register register bit
        * settings.
@@ -1785,25 +1882,11 @@ static void enc_irqworker(FAR void *arg)
        * be cleared.
        */
 
-      /* Ignore PKTIF because is unreliable. Use EPKTCNT instead */
-      /* if ((eir & EIR_PKTIF) != 0) */
-        {
-          uint8_t pktcnt = enc_rdbreg(priv, ENC_EPKTCNT);
-          if (pktcnt > 0)
-            {
-              nllvdbg("EPKTCNT: %02x\n", pktcnt);
-
-#ifdef CONFIG_ENC28J60_STATS
-              if (pktcnt > priv->stats.maxpktcnt)
-                {
-                  priv->stats.maxpktcnt = pktcnt;
-                }
-#endif
-              /* Handle packet receipt */
+      /* Ignore PKTIF because is unreliable. Use EPKTCNT instead.  Receive
+       * as many packets as are pending, up to the remaining budget.
+       */
 
-              enc_pktif(priv);
-            }
-        }
+      (void)netdev_napi_poll(&priv->dev, &priv->napi, enc_rxpoll);
 
       /* RXERIF: The Receive Error Interrupt Flag (RXERIF) is used to
        * indicate a receive buffer overflow condition. Alternately, this
@@ -1832,18 +1915,31 @@ static void enc_irqworker(FAR void *arg)
         }
     }
 
-  /* Enable GPIO interrupts */
+  /* If the receive budget was used up, then more packets are probably
+   * waiting.  Leave interrupts disabled and poll again later.
+   */
+
+  if (netdev_napi_complete(&priv->napi))
+    {
+      (void)work_queue(ENCWORK_POLL, &priv->irqwork, enc_irqworker,
+                       (FAR void *)priv, 0);
+    }
+  else
+    {
+      /* Enable GPIO interrupts */
 
-  priv->lower->enable(priv->lower);
+      priv->lower->enable(priv->lower);
 
-  /* Enable Ethernet interrupts */
+      /* Enable Ethernet interrupts */
 
-  enc_bfsgreg(priv, ENC_EIE, EIE_INTIE);
+      enc_bfsgreg(priv, ENC_EIE, EIE_INTIE);
+    }
 
-  /* Release lock on the SPI bus and uIP */
+errout:
+  /* Release lock on the SPI bus and the device */
 
   enc_unlock(priv);
-  net_unlock(lock);
+  netdev_unlock(&priv->dev, lock);
 }
 
 /****************************************************************************
@@ -1906,14 +2002,15 @@ static void enc_toworker(FAR void *arg)
 {
   FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)arg;
   net_lock_t lock;
+  net_lock_t state;
   int ret;
 
   nlldbg("Tx timeout\n");
   DEBUGASSERT(priv);
 
-  /* Get exclusive access to uIP */
+  /* Get exclusive access to the device */
 
-  lock = net_lock();
+  lock = netdev_lock(&priv->dev);
 
   /* Increment statistics and dump debug info */
 
@@ -1933,11 +2030,15 @@ static void enc_toworker(FAR void *arg)
 
   /* Then poll uIP for new XMIT data */
 
+  enc_lock(priv);
+  state = net_lock();
   (void)devif_poll(&priv->dev, enc_txpoll);
+  net_unlock(state);
+  enc_unlock(priv);
 
-  /* Release lock on uIP */
+  /* Release lock on the device */
 
-  net_unlock(lock);
+  netdev_unlock(&priv->dev, lock);
 }
 
 /****************************************************************************
@@ -2002,12 +2103,13 @@ static void enc_pollworker(FAR void *arg)
 {
   FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)arg;
   net_lock_t lock;
+  net_lock_t state;
 
   DEBUGASSERT(priv);
 
-  /* Get exclusive access to both uIP and the SPI bus. */
+  /* Get exclusive access to both the device and the SPI bus. */
 
-  lock = net_lock();
+  lock = netdev_lock(&priv->dev);
   enc_lock(priv);
 
   /* Verify that the hardware is ready to send another packet.  The driver
@@ -2023,13 +2125,15 @@ static void enc_pollworker(FAR void *arg)
        * in progress, we will missing TCP time state updates?
        */
 
+      state = net_lock();
       (void)devif_timer(&priv->dev, enc_txpoll, ENC_POLLHSEC);
+      net_unlock(state);
     }
 
-  /* Release lock on the SPI bus and uIP */
+  /* Release lock on the SPI bus and the device */
 
   enc_unlock(priv);
-  net_unlock(lock);
+  netdev_unlock(&priv->dev, lock);
 
   /* Setup the watchdog poll timer again */
 
@@ -2096,14 +2200,16 @@ static void enc_polltimer(int argc, uint32_t arg, ...)
 static int enc_ifup(struct net_driver_s *dev)
 {
   FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)dev->d_private;
+  net_lock_t lock;
   int ret;
 
   nlldbg("Bringing up: %d.%d.%d.%d\n",
          dev->d_ipaddr & 0xff, (dev->d_ipaddr >> 8) & 0xff,
         (dev->d_ipaddr >> 16) & 0xff, dev->d_ipaddr >> 24 );
 
-  /* Lock the SPI bus so that we have exclusive access */
+  /* Lock the device and the SPI bus so that we have exclusive access */
 
+  lock = netdev_lock(dev);
   enc_lock(priv);
 
   /* Initialize Ethernet interface, set the MAC address, and make sure that
@@ -2129,6 +2235,10 @@ static int enc_ifup(struct net_driver_s *dev)
 
       enc_bfsgreg(priv, ENC_ECON1, ECON1_RXEN);
 
+      /* Start in interrupt mode */
+
+      netdev_napi_initialize(&priv->napi, CONFIG_ENC28J60_BUDGET);
+
       /* Set and activate a timer process */
 
       (void)wd_start(priv->txpoll, ENC_WDDELAY, enc_polltimer, 1, (uint32_t)priv);
@@ -2141,9 +2251,10 @@ static int enc_ifup(struct net_driver_s *dev)
       priv->lower->enable(priv->lower);
     }
 
-  /* Un-lock the SPI bus */
+  /* Un-lock the SPI bus and the device */
 
   enc_unlock(priv);
+  netdev_unlock(dev, lock);
   return ret;
 }
 
@@ -2167,14 +2278,16 @@ static int enc_ifdown(struct net_driver_s *dev)
 {
   FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)dev->d_private;
   irqstate_t flags;
+  net_lock_t lock;
   int ret;
 
   nlldbg("Taking down: %d.%d.%d.%d\n",
          dev->d_ipaddr & 0xff, (dev->d_ipaddr >> 8) & 0xff,
          (dev->d_ipaddr >> 16) & 0xff, dev->d_ipaddr >> 24 );
 
-  /* Lock the SPI bus so that we have exclusive access */
+  /* Lock the device and the SPI bus so that we have exclusive access */
 
+  lock = netdev_lock(dev);
   enc_lock(priv);
 
   /* Disable the Ethernet interrupt */
@@ -2182,6 +2295,13 @@ static int enc_ifdown(struct net_driver_s *dev)
   flags = irqsave();
   priv->lower->disable(priv->lower);
 
+  /* If we were polling for received packets, cancel the next poll */
+
+  if (priv->napi.nn_polling)
+    {
+      (void)work_cancel(ENCWORK_POLL, &priv->irqwork);
+    }
+
   /* Cancel the TX poll timer and TX timeout timers */
 
   wd_cancel(priv->txpoll);
@@ -2195,43 +2315,42 @@ static int enc_ifdown(struct net_driver_s *dev)
   priv->ifstate = ENCSTATE_DOWN;
   irqrestore(flags);
 
-  /* Un-lock the SPI bus */
+  /* Un-lock the SPI bus and the device */
 
   enc_unlock(priv);
+  netdev_unlock(dev, lock);
   return ret;
 }
 
 /****************************************************************************
- * Function: enc_txavail
+ * Function: enc_txavailworker
  *
  * Description:
- *   Driver callback invoked when new TX data is available.  This is a
- *   stimulus perform an out-of-cycle poll and, thereby, reduce the TX
- *   latency.
+ *   Perform an out-of-cycle poll on the worker thread.
  *
  * Parameters:
- *   dev  - Reference to the NuttX driver state structure
+ *   arg  - Reference to the driver state structure (cast to void*)
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   Called in normal user mode
  *
  ****************************************************************************/
 
-static int enc_txavail(struct net_driver_s *dev)
+static void enc_txavailworker(FAR void *arg)
 {
-  FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)dev->d_private;
-  irqstate_t flags;
+  FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)arg;
+  net_lock_t lock;
+  net_lock_t state;
 
-  /* Lock the SPI bus so that we have exclusive access */
+  /* Get exclusive access to both the device and the SPI bus. */
 
+  lock = netdev_lock(&priv->dev);
   enc_lock(priv);
 
   /* Ignore the notification if the interface is not yet up */
 
-  flags = irqsave();
   if (priv->ifstate == ENCSTATE_UP)
     {
       /* Check if the hardware is ready to send another packet.  The driver
@@ -2244,14 +2363,53 @@ static int enc_txavail(struct net_driver_s *dev)
         {
           /* The interface is up and TX is idle; poll uIP for new XMIT data */
 
+          state = net_lock();
           (void)devif_poll(&priv->dev, enc_txpoll);
+          net_unlock(state);
         }
     }
 
-  /* Un-lock the SPI bus */
+  /* Un-lock the SPI bus and the device */
 
-  irqrestore(flags);
   enc_unlock(priv);
+  netdev_unlock(&priv->dev, lock);
+}
+
+/****************************************************************************
+ * Function: enc_txavail
+ *
+ * Description:
+ *   Driver callback invoked when new TX data is available.  This is a
+ *   stimulus perform an out-of-cycle poll and, thereby, reduce the TX
+ *   latency.
+ *
+ * Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the stack lock held.  The poll is deferred to the worker
+ *   thread because the device lock and the SPI bus must be taken before
+ *   the stack lock.
+ *
+ ****************************************************************************/
+
+static int enc_txavail(struct net_driver_s *dev)
+{
+  FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)dev->d_private;
+
+  /* Ignore the notification if the interface is not yet up or if a poll
+   * is already pending.
+   */
+
+  if (priv->ifstate == ENCSTATE_UP && work_available(&priv->txwork))
+    {
+      (void)work_queue(HPWORK, &priv->txwork, enc_txavailworker,
+                       (FAR void *)priv, 0);
+    }
+
   return OK;
 }
 
@@ -2276,19 +2434,14 @@ static int enc_txavail(struct net_driver_s *dev)
 #ifdef CONFIG_NET_IGMP
 static int enc_addmac(struct net_driver_s *dev, FAR const uint8_t *mac)
 {
-  FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)dev->d_private;
-
-  /* Lock the SPI bus so that we have exclusive access */
-
-  enc_lock(priv);
-
-  /* Add the MAC address to the hardware multicast routing table */
+  /* Add the MAC address to the hardware multicast routing table.  This is
+   * called with the stack lock held so the hardware update must be
+   * deferred to the worker thread:  The SPI bus is always locked before
+   * the stack lock.
+   */
 
 #warning "Multicast MAC support not implemented"
 
-  /* Un-lock the SPI bus */
-
-  enc_unlock(priv);
   return OK;
 }
 #endif
@@ -2314,19 +2467,14 @@ static int enc_addmac(struct net_driver_s *dev, FAR const uint8_t *mac)
 #ifdef CONFIG_NET_IGMP
 static int enc_rmmac(struct net_driver_s *dev, FAR const uint8_t *mac)
 {
-  FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)dev->d_private;
-
-  /* Lock the SPI bus so that we have exclusive access */
-
-  enc_lock(priv);
-
-  /* Add the MAC address to the hardware multicast routing table */
+  /* Remove the MAC address from the hardware multicast routing table.
+   * This is called with the stack lock held so the hardware update must be
+   * deferred to the worker thread:  The SPI bus is always locked before
+   * the stack lock.
+   */
 
 #warning "Multicast MAC support not implemented"
 
-  /* Un-lock the SPI bus */
-
-  enc_unlock(priv);
   return OK;
 }
 #endif
@@ -2726,6 +2874,19 @@ int enc_stats(unsigned int devno, struct enc_stats_s *stats)
   flags = irqsave();
   memcpy(stats, &priv->stats, sizeof(struct enc_stats_s));
   memset(&priv->stats, 0, sizeof(struct enc_stats_s));
+
+  /* Add the counts of the budgeted receive polling logic */
+
+  stats->maxburst   = priv->napi.nn_maxburst;
+  stats->rxints     = priv->napi.nn_interrupts;
+  stats->rxpolls    = priv->napi.nn_polls;
+  stats->rxswitches = priv->napi.nn_switches;
+
+  priv->napi.nn_maxburst   = 0;
+  priv->napi.nn_interrupts = 0;
+  priv->napi.nn_polls      = 0;
+  priv->napi.nn_packets    = 0;
+  priv->napi.nn_switches   = 0;
   irqrestore(flags);
   return OK;
 }
@@ -50,6 +50,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/rwbuffer.h>
@@ -70,6 +71,14 @@
 #  define CONFIG_DRVR_WRDELAY 350
 #endif
 
+/* Statistics ***************************************************************/
+
+#ifdef CONFIG_DRVR_RWBSTATS
+#  define rwb_addstat(r,f,n) ((r)->stats.f += (n))
+#else
+#  define rwb_addstat(r,f,n)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -142,46 +151,112 @@ static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
 {
   /* We assume that the caller holds the wrsem */
 
-  rwb->wrnblocks       = 0;
-  rwb->wrblockstart    = (off_t)-1;
-  rwb->wrexpectedblock = (off_t)-1;
+  rwb->wrnblocks = 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrsearch
+ *
+ * Description:
+ *   The write buffer holds blocks in ascending order of block number, not
+ *   necessarily contiguous.  Return the index of the first buffer slot
+ *   that holds a block greater than or equal to 'block' (wrnblocks if there
+ *   is none).
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static unsigned int rwb_wrsearch(FAR struct rwbuffer_s *rwb, off_t block)
+{
+  unsigned int low  = 0;
+  unsigned int high = rwb->wrnblocks;
+  unsigned int mid;
+
+  /* Blocks are usually written in sequence so check the end first */
+
+  if (high == 0 || rwb->wrblocks[high - 1] < block)
+    {
+      return high;
+    }
+
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      if (rwb->wrblocks[mid] < block)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return low;
 }
 #endif
 
 /****************************************************************************
  * Name: rwb_wrflush
  *
+ * Description:
+ *   Write the contents of the write buffer to the media.  Because the
+ *   buffered blocks are kept sorted, each run of consecutive blocks is
+ *   contiguous in the buffer and is written with a single call to the
+ *   flush callout, no matter in which order the blocks were written.
+ *
  * Assumptions:
  *   The caller holds the wrsem semaphore.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrflush(struct rwbuffer_s *rwb)
+static int rwb_wrflush(struct rwbuffer_s *rwb)
 {
+  FAR uint8_t *buffer;
+  unsigned int nblocks;
+  unsigned int i;
+  int result = OK;
   int ret;
 
-  fvdbg("Timeout!\n");
-
-  if (rwb->wrnblocks > 0)
+  for (i = 0; i < rwb->wrnblocks; i += nblocks)
     {
+      /* Find the end of this run of blocks */
+
+      nblocks = 1;
+      while (i + nblocks < rwb->wrnblocks &&
+             rwb->wrblocks[i + nblocks] == rwb->wrblocks[i] + nblocks)
+        {
+          nblocks++;
+        }
+
+      buffer = &rwb->wrbuffer[i * rwb->blocksize];
+
       fvdbg("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
-      (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+            (long)rwb->wrblocks[i], nblocks, buffer);
 
-      /* Flush cache.  On success, the flush method will return the number
-       * of blocks written.  Anything other than the number requested is
-       * an error.
+      /* Flush the run.  On success, the flush method will return the
+       * number of blocks written.  Anything other than the number requested
+       * is an error.
        */
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-      if (ret != rwb->wrnblocks)
+      ret = rwb->wrflush(rwb->dev, buffer, rwb->wrblocks[i], nblocks);
+      if (ret != nblocks)
         {
           fdbg("ERROR: Error flushing write buffer: %d\n", ret);
+          result = ret < 0 ? ret : -EIO;
         }
 
-      rwb_resetwrbuffer(rwb);
+      rwb_addstat(rwb, wrflushes, 1);
+      rwb_addstat(rwb, wrflushed, nblocks);
     }
 
+  rwb_resetwrbuffer(rwb);
+  return result;
 }
 #endif
 
@@ -189,6 +264,7 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
  * Name: rwb_wrtimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrtimeout(FAR void *arg)
 {
   /* The following assumes that the size of a pointer is 4-bytes or less */
@@ -196,41 +272,55 @@ static void rwb_wrtimeout(FAR void *arg)
   FAR struct rwbuffer_s *rwb = (struct rwbuffer_s *)arg;
   DEBUGASSERT(rwb != NULL);
 
+  fvdbg("Timeout!\n");
+
   /* If a timeout elapses with with write buffer activity, this watchdog
    * handler function will be evoked on the thread of execution of the
    * worker thread.
    */
 
   rwb_semtake(&rwb->wrsem);
-  rwb_wrflush(rwb);
+  if (rwb->wrnblocks > 0)
+    {
+      rwb_addstat(rwb, wrtimeout, 1);
+      (void)rwb_wrflush(rwb);
+    }
+
   rwb_semgive(&rwb->wrsem);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_wrstarttimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 {
-  /* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds. CLK_TCK
-   * provides the clock tick of the system (frequency in Hz).
-   */
+  /* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds */
 
-  int ticks = (CONFIG_DRVR_WRDELAY + CLK_TCK/2) / CLK_TCK;
+  int ticks = MSEC2TICK(CONFIG_DRVR_WRDELAY);
   (void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb, ticks);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_wrcanceltimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 {
   (void)work_cancel(LPWORK, &rwb->work);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_writebuffer
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -238,53 +328,83 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, uint32_t nblocks,
                                FAR const uint8_t *wrbuffer)
 {
+  FAR uint8_t *dest;
+  unsigned int index;
+  unsigned int nnew;
+  unsigned int nmove;
+  off_t block;
   int ret;
 
   /* Write writebuffer Logic */
 
   rwb_wrcanceltimeout(rwb);
 
-  /* First: Should we flush out our cache? We would do that if (1) we already
-   * buffering blocks and the next block writing is not in the same sequence,
-   * or (2) the number of blocks would exceed our allocated buffer capacity
+  /* Blocks that are already in the write buffer are simply overwritten.
+   * How many blocks are new?
    */
 
-  if (((startblock != rwb->wrexpectedblock) && (rwb->wrnblocks)) ||
-      ((rwb->wrnblocks + nblocks) > rwb->wrmaxblocks))
+  nnew  = nblocks;
+  index = rwb_wrsearch(rwb, startblock);
+
+  while (index < rwb->wrnblocks &&
+         rwb->wrblocks[index] < startblock + nblocks)
     {
-      fvdbg("writebuffer miss, expected: %08x, given: %08x\n",
-            rwb->wrexpectedblock, startblock);
+      nnew--;
+      index++;
+    }
+
+  /* Should we flush out our cache?  We need to do that only if the new
+   * blocks would exceed our allocated buffer capacity.  Writes that are not
+   * in sequence just start a new run of blocks in the buffer.
+   */
 
-      /* Flush the write buffer */
+  if (rwb->wrnblocks + nnew > rwb->wrmaxblocks)
+    {
+      fvdbg("writebuffer full, flushing %d blocks\n", rwb->wrnblocks);
+      rwb_addstat(rwb, wrfull, 1);
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
+      ret = rwb_wrflush(rwb);
       if (ret < 0)
         {
           fdbg("ERROR: Error writing multiple from cache: %d\n", -ret);
           return ret;
         }
-
-      rwb_resetwrbuffer(rwb);
     }
 
-  /* writebuffer is empty? Then initialize it */
+  /* Add data to cache, keeping the blocks in ascending order */
 
-  if (rwb->wrnblocks == 0)
+  for (block = startblock; block < startblock + nblocks; block++)
     {
-      fvdbg("Fresh cache starting at block: 0x%08x\n", startblock);
-      rwb->wrblockstart = startblock;
-    }
+      index = rwb_wrsearch(rwb, block);
+      dest  = &rwb->wrbuffer[index * rwb->blocksize];
 
-  /* Add data to cache */
+      if (index < rwb->wrnblocks && rwb->wrblocks[index] == block)
+        {
+          /* The block is already buffered.  Overwrite it. */
 
-  fvdbg("writebuffer: copying %d bytes from %p to %p\n",
-        nblocks * rwb->blocksize, wrbuffer,
-        &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-  memcpy(&rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize],
-         wrbuffer, nblocks * rwb->blocksize);
+          rwb_addstat(rwb, wrcoalesced, rwb->blocksize);
+        }
+      else
+        {
+          /* Make room for the block if it goes before other blocks */
 
-  rwb->wrnblocks      += nblocks;
-  rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
+          nmove = rwb->wrnblocks - index;
+          if (nmove > 0)
+            {
+              memmove(dest + rwb->blocksize, dest, nmove * rwb->blocksize);
+              memmove(&rwb->wrblocks[index + 1], &rwb->wrblocks[index],
+                      nmove * sizeof(off_t));
+            }
+
+          rwb->wrblocks[index] = block;
+          rwb->wrnblocks++;
+        }
+
+      memcpy(dest, wrbuffer, rwb->blocksize);
+      wrbuffer += rwb->blocksize;
+    }
+
+  rwb_addstat(rwb, wrblocks, nblocks);
   rwb_wrstarttimeout(rwb);
   return nblocks;
 }
@@ -340,10 +460,17 @@ rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
 
 /****************************************************************************
  * Name: rwb_rhreload
+ *
+ * Description:
+ *   Reload the read-ahead buffer starting at 'startblock'.  At least
+ *   'minblocks' are loaded (if the buffer and the media are large enough)
+ *   or more if the current read-ahead depth is greater.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
+static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock,
+                        size_t minblocks)
 {
   off_t  endblock;
   size_t nblocks;
@@ -356,11 +483,17 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
       return -ESPIPE;
     }
 
-  /* Get the block number +1 of the last block that will fit in the
+  /* Get the block number +1 of the last block that will be loaded in the
    * read-ahead buffer
    */
 
-  endblock = startblock + rwb->rhmaxblocks;
+  nblocks = rwb->rhdepth > minblocks ? rwb->rhdepth : minblocks;
+  if (nblocks > rwb->rhmaxblocks)
+    {
+      nblocks = rwb->rhmaxblocks;
+    }
+
+  endblock = startblock + nblocks;
 
   /* Make sure that we don't read past the end of the device */
 
@@ -385,6 +518,9 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
       rwb->rhnblocks    = nblocks;
       rwb->rhblockstart = startblock;
 
+      rwb_addstat(rwb, rhreloads, 1);
+      rwb_addstat(rwb, rhblocks, nblocks);
+
       /* The return value is not the number of blocks we asked to be loaded. */
 
       return nblocks;
@@ -406,127 +542,42 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
-  int ret;
+  unsigned int first;
+  unsigned int last;
+  unsigned int nkeep;
 
   if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
     {
-      off_t wrbend;
-      off_t invend;
-
       fvdbg("startblock=%d blockcount=%p\n", startblock, blockcount);
 
       rwb_semtake(&rwb->wrsem);
 
-      /* Now there are five cases:
-       *
-       * 1. We invalidate nothing
-       */
+      /* Find the range of buffer slots holding invalidated blocks */
 
-      wrbend = rwb->wrblockstart + rwb->wrnblocks;
-      invend = startblock + blockcount;
+      first = rwb_wrsearch(rwb, startblock);
+      last  = rwb_wrsearch(rwb, startblock + blockcount);
 
-      if (rwb->wrblockstart > invend || wrbend < startblock)
-        {
-          ret = OK;
-        }
-
-      /* 2. We invalidate the entire write buffer. */
+      /* Then discard those blocks, moving the blocks after them down */
 
-      else if (rwb->wrblockstart >= startblock && wrbend <= invend)
+      if (last > first)
         {
-          rwb->wrnblocks = 0;
-          ret = OK;
-        }
-
-      /* We are going to invalidate a subset of the write buffer.  Three
-       * more cases to consider:
-       *
-       * 2. We invalidate a portion in the middle of the write buffer
-       */
-
-      else if (rwb->wrblockstart < startblock && wrbend > invend)
-        {
-          uint8_t *src;
-          off_t    block;
-          off_t    offset;
-          size_t   nblocks;
-
-          /* Write the blocks at the end of the media to hardware */
-
-          nblocks = wrbend - invend;
-          block   = invend;
-          offset  = block - rwb->wrblockstart;
-          src     = rwb->wrbuffer + offset * rwb->blocksize;
-
-          ret = rwb->wrflush(rwb->dev, src, block, nblocks);
-          if (ret < 0)
+          nkeep = rwb->wrnblocks - last;
+          if (nkeep > 0)
             {
-              fdbg("ERROR: wrflush failed: %d\n", ret);
+              memmove(&rwb->wrbuffer[first * rwb->blocksize],
+                      &rwb->wrbuffer[last * rwb->blocksize],
+                      nkeep * rwb->blocksize);
+              memmove(&rwb->wrblocks[first], &rwb->wrblocks[last],
+                      nkeep * sizeof(off_t));
             }
 
-          /* Keep the blocks at the beginning of the buffer up the
-           * start of the invalidated region.
-           */
-          else
-            {
-              rwb->wrnblocks = startblock - rwb->wrblockstart;
-              ret = OK;
-            }
-        }
-
-      /* 3. We invalidate a portion at the end of the write buffer */
-
-      else if (wrbend > startblock && wrbend <= invend)
-        {
-          rwb->wrnblocks = wrbend - startblock;
-          ret = OK;
-        }
-
-      /* 4. We invalidate a portion at the beginning of the write buffer */
-
-      else /* if (rwb->wrblockstart >= startblock && wrbend > invend) */
-        {
-          uint8_t *src;
-          size_t   ninval;
-          size_t   nkeep;
-
-          DEBUGASSERT(rwb->wrblockstart >= startblock && wrbend > invend);
-
-          /* Copy the data from the uninvalidated region to the beginning
-           * of the write buffer.
-           *
-           * First calculate the source and destination of the transfer.
-           */
-
-          ninval = invend - rwb->wrblockstart;
-          src    = rwb->wrbuffer + ninval * rwb->blocksize;
-
-          /* Calculate the number of blocks we are keeping.  We keep
-           * the ones that we don't invalidate.
-           */
-
-          nkeep  = rwb->wrnblocks - ninval;
-
-          /* Then move the data that we are keeping to the beginning
-           * the write buffer.
-           */
-
-          memcpy(rwb->wrbuffer, src, nkeep * rwb->blocksize);
-
-          /* Update the block info.  The first block is now the one just
-           * after the invalidation region and the number buffered blocks
-           * is the number that we kept.
-           */
-
-          rwb->wrblockstart = invend;
-          rwb->wrnblocks    = nkeep;
-          ret = OK;
+          rwb->wrnblocks -= last - first;
         }
 
       rwb_semgive(&rwb->wrsem);
     }
 
-  return ret;
+  return OK;
 }
 #endif
 
@@ -542,7 +593,7 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
 int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
-  int ret;
+  int ret = OK;
 
   if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0)
     {
@@ -594,7 +645,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 
       else if (rhbend > startblock && rhbend <= invend)
         {
-          rwb->rhnblocks = rhbend - startblock;
+          rwb->rhnblocks = startblock - rwb->rhblockstart;
           ret = OK;
         }
 
@@ -622,6 +673,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
 /****************************************************************************
  * Name: rwb_initialize
  ****************************************************************************/
@@ -642,11 +694,15 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
   DEBUGASSERT(rwb->wrflush!= NULL);
   rwb->wrbuffer = NULL;
+  rwb->wrblocks = NULL;
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   DEBUGASSERT(rwb->rhreload != NULL);
   rwb->rhbuffer = NULL;
 #endif
+#ifdef CONFIG_DRVR_RWBSTATS
+  memset(&rwb->stats, 0, sizeof(struct rwb_stats_s));
+#endif
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   if (rwb->wrmaxblocks > 0)
@@ -661,18 +717,22 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       rwb_resetwrbuffer(rwb);
 
-      /* Allocate the write buffer */
+      /* Allocate the write buffer and the list of blocks that it holds */
 
-      rwb->wrbuffer = NULL;
-      if (rwb->wrmaxblocks > 0)
+      allocsize     = rwb->wrmaxblocks * rwb->blocksize;
+      rwb->wrbuffer = kmm_malloc(allocsize);
+      if (!rwb->wrbuffer)
         {
-          allocsize     = rwb->wrmaxblocks * rwb->blocksize;
-          rwb->wrbuffer = kmm_malloc(allocsize);
-          if (!rwb->wrbuffer)
-            {
-              fdbg("Write buffer kmm_malloc(%d) failed\n", allocsize);
-              return -ENOMEM;
-            }
+          fdbg("Write buffer kmm_malloc(%d) failed\n", allocsize);
+          return -ENOMEM;
+        }
+
+      rwb->wrblocks = (FAR off_t *)kmm_malloc(rwb->wrmaxblocks *
+                                              sizeof(off_t));
+      if (!rwb->wrblocks)
+        {
+          fdbg("Write block list kmm_malloc failed\n");
+          return -ENOMEM;
         }
 
       fvdbg("Write buffer size: %d bytes\n", allocsize);
@@ -688,22 +748,23 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       sem_init(&rwb->rhsem, 0, 1);
 
-      /* Initialize read-ahead buffer parameters */
+      /* Initialize read-ahead buffer parameters.  Read-ahead starts with
+       * the size of the first read and grows as sequential reads are
+       * detected.
+       */
 
       rwb_resetrhbuffer(rwb);
+      rwb->rhdepth     = 1;
+      rwb->rhnextblock = (off_t)-1;
 
       /* Allocate the read-ahead buffer */
 
-      rwb->rhbuffer = NULL;
-      if (rwb->rhmaxblocks > 0)
+      allocsize     = rwb->rhmaxblocks * rwb->blocksize;
+      rwb->rhbuffer = kmm_malloc(allocsize);
+      if (!rwb->rhbuffer)
         {
-          allocsize     = rwb->rhmaxblocks * rwb->blocksize;
-          rwb->rhbuffer = kmm_malloc(allocsize);
-          if (!rwb->rhbuffer)
-            {
-              fdbg("Read-ahead buffer kmm_malloc(%d) failed\n", allocsize);
-              return -ENOMEM;
-            }
+          fdbg("Read-ahead buffer kmm_malloc(%d) failed\n", allocsize);
+          return -ENOMEM;
         }
 
       fvdbg("Read-ahead buffer size: %d bytes\n", allocsize);
@@ -728,6 +789,11 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
         {
           kmm_free(rwb->wrbuffer);
         }
+
+      if (rwb->wrblocks)
+        {
+          kmm_free(rwb->wrblocks);
+        }
     }
 #endif
 
@@ -747,11 +813,18 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
  * Name: rwb_read
  ****************************************************************************/
 
-int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
-             FAR uint8_t *rdbuffer)
+ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
+                 size_t nblocks, FAR uint8_t *rdbuffer)
 {
-  uint32_t remaining;
-  int ret = OK;
+#ifdef CONFIG_DRVR_READAHEAD
+  bool reloaded;
+  size_t remaining;
+  size_t depth;
+#endif
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  unsigned int index;
+#endif
+  ssize_t ret = OK;
 
   fvdbg("startblock=%ld nblocks=%ld rdbuffer=%p\n",
         (long)startblock, (long)nblocks, rdbuffer);
@@ -765,27 +838,55 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
 
   if (rwb->wrmaxblocks > 0)
     {
-      /* If the write buffer overlaps the block(s) requested, then flush the
-       * write buffer.
+      /* If any of the block(s) requested are in the write buffer, then
+       * flush the write buffer.
        */
 
       rwb_semtake(&rwb->wrsem);
-      if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks))
+      index = rwb_wrsearch(rwb, startblock);
+      if (index < rwb->wrnblocks &&
+          rwb->wrblocks[index] < startblock + nblocks)
         {
-          rwb_wrflush(rwb);
+          rwb_addstat(rwb, wrread, 1);
+          ret = rwb_wrflush(rwb);
         }
 
       rwb_semgive(&rwb->wrsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
 #endif
 
 #ifdef CONFIG_DRVR_READAHEAD
   if (rwb->rhmaxblocks > 0)
     {
+      rwb_semtake(&rwb->rhsem);
+
+      /* Adapt the read-ahead depth to the access pattern.  Each read that
+       * continues where the last one ended doubles the amount read ahead
+       * (up to the size of the read-ahead buffer).  Any other read only
+       * reads what was asked for so that random accesses do not waste
+       * time transferring blocks that will never be used.
+       */
+
+      if (startblock == rwb->rhnextblock)
+        {
+          depth = rwb->rhdepth > nblocks ? rwb->rhdepth : nblocks;
+          depth <<= 1;
+        }
+      else
+        {
+          depth = nblocks > 0 ? nblocks : 1;
+        }
+
+      rwb->rhdepth     = depth < rwb->rhmaxblocks ? depth : rwb->rhmaxblocks;
+      rwb->rhnextblock = startblock + nblocks;
+
       /* Loop until we have read all of the requested blocks */
 
-      rwb_semtake(&rwb->rhsem);
-      for (remaining = nblocks; remaining > 0;)
+      for (reloaded = false, remaining = nblocks; remaining > 0;)
         {
           /* Is there anything in the read-ahead buffer? */
 
@@ -809,6 +910,15 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
                   rwb_bufferread(rwb, startblock, rdblocks, &rdbuffer);
                   startblock += rdblocks;
                   remaining  -= rdblocks;
+
+                  if (reloaded)
+                    {
+                      rwb_addstat(rwb, rhmisses, rdblocks);
+                    }
+                  else
+                    {
+                      rwb_addstat(rwb, rhhits, rdblocks);
+                    }
                 }
             }
 
@@ -818,12 +928,16 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
 
           if (remaining > 0)
             {
-              ret = rwb_rhreload(rwb, startblock);
+              ret = rwb_rhreload(rwb, startblock, remaining);
               if (ret < 0)
                 {
-                  fdbg("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
+                  fdbg("ERROR: Failed to fill the read-ahead buffer: %d\n",
+                       (int)ret);
+                  rwb_semgive(&rwb->rhsem);
                   return ret;
                 }
+
+              reloaded = true;
             }
         }
 
@@ -836,7 +950,7 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
       ret = nblocks;
     }
   else
-#else
+#endif
     {
       /* No read-ahead buffering, (re)load the data directly into
        * the user buffer.
@@ -844,7 +958,6 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
 
       ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, nblocks);
     }
-#endif
 
   return ret;
 }
@@ -853,10 +966,10 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
  * Name: rwb_write
  ****************************************************************************/
 
-int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
-              size_t nblocks, FAR const uint8_t *wrbuffer)
+ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
+                  size_t nblocks, FAR const uint8_t *wrbuffer)
 {
-  int ret = OK;
+  ssize_t ret = OK;
 
 #ifdef CONFIG_DRVR_READAHEAD
   if (rwb->rhmaxblocks > 0)
@@ -882,34 +995,39 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
     {
       fvdbg("startblock=%d wrbuffer=%p\n", startblock, wrbuffer);
 
+      rwb_semtake(&rwb->wrsem);
+
       /* Use the block cache unless the buffer size is bigger than block cache */
 
       if (nblocks > rwb->wrmaxblocks)
         {
           /* First flush the cache */
 
-          rwb_semtake(&rwb->wrsem);
-          rwb_wrflush(rwb);
-          rwb_semgive(&rwb->wrsem);
+          rwb_addstat(rwb, wrlarge, 1);
+          ret = rwb_wrflush(rwb);
 
           /* Then transfer the data directly to the media */
 
-          ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+          if (ret >= 0)
+            {
+              ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+            }
         }
       else
         {
-          /* Buffer the data in the write buffer */
+          /* Buffer the data in the write buffer.  On success, this returns
+           * the number of blocks that we were requested to write.  This is
+           * for compatibility with the normal return of a block driver
+           * write method
+           */
 
           ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
         }
 
-      /* On success, return the number of blocks that we were requested to
-       * write.  This is for compatibility with the normal return of a block
-       * driver write method
-       */
+      rwb_semgive(&rwb->wrsem);
     }
   else
-#else
+#endif
     {
       /* No write buffer.. just pass the write operation through via the
        * flush callback.
@@ -918,10 +1036,50 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
       ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
     }
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: rwb_getstats
+ *
+ * Description:
+ *   Return a snapshot of the buffering statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_RWBSTATS
+void rwb_getstats(FAR struct rwbuffer_s *rwb,
+                  FAR struct rwb_stats_s *stats)
+{
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  if (rwb->wrmaxblocks > 0)
+    {
+      rwb_semtake(&rwb->wrsem);
+    }
+#endif
+#ifdef CONFIG_DRVR_READAHEAD
+  if (rwb->rhmaxblocks > 0)
+    {
+      rwb_semtake(&rwb->rhsem);
+    }
 #endif
 
-  return ret;
+  memcpy(stats, &rwb->stats, sizeof(struct rwb_stats_s));
+
+#ifdef CONFIG_DRVR_READAHEAD
+  if (rwb->rhmaxblocks > 0)
+    {
+      rwb_semgive(&rwb->rhsem);
+    }
+#endif
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  if (rwb->wrmaxblocks > 0)
+    {
+      rwb_semgive(&rwb->wrsem);
+    }
+#endif
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_readbytes
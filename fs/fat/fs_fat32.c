@@ -1965,6 +1965,17 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_DIRHASH
+  fat_dirhash_release(fs);
+#endif
+
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap)
+    {
+      kmm_free(fs->fs_freemap);
+    }
+#endif
+
   sem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
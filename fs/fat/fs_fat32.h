@@ -713,6 +713,43 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_FAT_DIRHASH
+/* The names in a recently used directory are kept in a hash table.  Each
+ * name is represented only by a 16-bit hash of the name and by the number
+ * of the directory entry (counting from the beginning of the directory)
+ * where the name begins.  That is the short file name entry or the "last"
+ * long file name entry.  A lookup reads only the directory entries of the
+ * names with a matching hash; all other names cannot match.
+ */
+
+#define FAT_DIRHASH_NIL    0xffff  /* End of list / no such entry */
+
+struct fat_dirhashent_s
+{
+  uint16_t de_hash;                /* Hash of the name */
+  uint16_t de_next;                /* Next in bucket (or free) list */
+  uint16_t de_number;              /* Directory entry number of the name */
+};
+
+struct fat_dirhash_s
+{
+  uint32_t dh_cluster;             /* First cluster (0=FAT12/16 root dir) */
+  uint32_t dh_lastuse;             /* For least recently used selection */
+  uint32_t dh_freeno;              /* No free entry precedes this one */
+  FAR uint32_t *dh_clusters;       /* The cluster chain of the directory */
+  FAR uint16_t *dh_buckets;        /* Heads of the hash bucket lists */
+  FAR struct fat_dirhashent_s *dh_entries;
+  uint16_t dh_nclusters;           /* Number of clusters in dh_clusters[] */
+  uint16_t dh_nbuckets;            /* Number of buckets (a power of two) */
+  uint16_t dh_maxentries;          /* Allocated size of dh_entries[] */
+  uint16_t dh_nentries;            /* Number of dh_entries[] ever used */
+  uint16_t dh_nnames;              /* Number of names in the hash */
+  uint16_t dh_free;                /* List of unused dh_entries[] */
+  bool     dh_inuse;               /* true: This hash describes a directory */
+  bool     dh_toobig;              /* true: Too many names, search linearly */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -747,6 +784,15 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#ifdef CONFIG_FAT_DIRHASH
+  uint32_t fs_dirhashclock;        /* Directory hash access count */
+  struct fat_dirhash_s fs_dirhash[CONFIG_FAT_DIRHASH_NDIRS];
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+  uint8_t *fs_freemap;             /* Bit set: cluster is allocated */
+  uint32_t fs_freemapscan;         /* fs_freemap is valid below this */
+  uint32_t fs_freemapfree;         /* Free clusters below freemapscan */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -920,6 +966,33 @@ EXTERN int    fat_dirtruncate(struct fat_mountpt_s *fs, struct fat_dirinfo_s *di
 EXTERN int    fat_dircreate(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo);
 EXTERN int    fat_remove(struct fat_mountpt_s *fs, const char *relpath, bool directory);
 
+#ifdef CONFIG_FAT_DIRHASH
+/* Directory name hash */
+
+EXTERN uint16_t fat_dirhash_name(const uint8_t *name, int len, bool lfn);
+EXTERN struct fat_dirhash_s *fat_dirhash_find(struct fat_mountpt_s *fs,
+                                              uint32_t cluster);
+EXTERN struct fat_dirhash_s *fat_dirhash_alloc(struct fat_mountpt_s *fs,
+                                               uint32_t cluster);
+EXTERN void   fat_dirhash_discard(struct fat_dirhash_s *dh);
+EXTERN void   fat_dirhash_drop(struct fat_mountpt_s *fs, uint32_t cluster);
+EXTERN void   fat_dirhash_release(struct fat_mountpt_s *fs);
+EXTERN int    fat_dirhash_addcluster(struct fat_mountpt_s *fs,
+                                     struct fat_dirhash_s *dh,
+                                     uint32_t cluster);
+EXTERN int    fat_dirhash_add(struct fat_dirhash_s *dh, uint16_t hash,
+                              uint16_t number);
+EXTERN int    fat_dirhash_number(struct fat_mountpt_s *fs,
+                                 struct fat_dirhash_s *dh, off_t sector,
+                                 uint16_t offset);
+EXTERN void   fat_dirhash_position(struct fat_mountpt_s *fs,
+                                   struct fat_dirhash_s *dh, uint16_t number,
+                                   struct fs_fatdir_s *dir);
+EXTERN void   fat_dirhash_freed(struct fat_mountpt_s *fs, off_t sector,
+                                uint16_t offset, off_t lfnsector,
+                                uint16_t lfnoffset);
+#endif
+
 /* Mountpoint and file buffer cache (for partial sector accesses) */
 
 EXTERN int    fat_fscacheflush(struct fat_mountpt_s *fs);
@@ -124,14 +124,28 @@ static inline int fat_uniquealias(struct fat_mountpt_s *fs,
 static int fat_path2dirname(const char **path, struct fat_dirinfo_s *dirinfo,
                             char *terminator);
 static int fat_findsfnentry(struct fat_mountpt_s *fs,
-                            struct fat_dirinfo_s *dirinfo);
+                            struct fat_dirinfo_s *dirinfo, bool anchored);
 #ifdef CONFIG_FAT_LFN
 static bool fat_cmplfnchunk(uint8_t *chunk, const uint8_t *substr, int nchunk);
 static bool fat_cmplfname(const uint8_t *direntry, const uint8_t *substr);
 static inline int fat_findlfnentry(struct fat_mountpt_s *fs,
-                                   struct fat_dirinfo_s *dirinfo);
+                                   struct fat_dirinfo_s *dirinfo,
+                                   bool anchored);
 
 #endif
+#ifdef CONFIG_FAT_DIRHASH
+#ifdef CONFIG_FAT_LFN
+static int fat_dirhash_getchunk(const uint8_t *direntry, uint8_t *dest);
+#endif
+static int fat_dirhash_build(struct fat_mountpt_s *fs,
+                             struct fat_dirhash_s *dh);
+static struct fat_dirhash_s *fat_dirhash_get(struct fat_mountpt_s *fs,
+                                             uint32_t cluster);
+static int fat_dirhash_lookup(struct fat_mountpt_s *fs,
+                              struct fat_dirinfo_s *dirinfo, bool lfn);
+static void fat_dirhash_insert(struct fat_mountpt_s *fs,
+                               struct fat_dirinfo_s *dirinfo);
+#endif
 static inline int fat_allocatesfnentry(struct fat_mountpt_s *fs,
                                        struct fat_dirinfo_s *dirinfo);
 #ifdef CONFIG_FAT_LFN
@@ -790,6 +804,9 @@ static inline int fat_findalias(struct fat_mountpt_s *fs,
                                 struct fat_dirinfo_s *dirinfo)
 {
   struct fat_dirinfo_s tmpinfo;
+#ifdef CONFIG_FAT_DIRHASH
+  int ret;
+#endif
 
   /* Save the current directory info. */
 
@@ -799,13 +816,32 @@ static inline int fat_findalias(struct fat_mountpt_s *fs,
    * with the first entry.
    */
 
-  tmpinfo.dir.fd_startcluster = tmpinfo.dir.fd_currcluster;
-  tmpinfo.dir.fd_currsector   = tmpinfo.fd_seq.ds_startsector;
+  tmpinfo.dir.fd_currcluster  = tmpinfo.dir.fd_startcluster;
+  if (tmpinfo.dir.fd_startcluster)
+    {
+      tmpinfo.dir.fd_currsector = fat_cluster2sector(fs,
+                                    tmpinfo.dir.fd_startcluster);
+    }
+  else
+    {
+      tmpinfo.dir.fd_currsector = fs->fs_rootbase;
+    }
+
   tmpinfo.dir.fd_index        = 0;
 
+#ifdef CONFIG_FAT_DIRHASH
+  /* Look up the alias in the directory hash (if there is one) */
+
+  ret = fat_dirhash_lookup(fs, &tmpinfo, false);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Search for the single short file name directory entry in this directory */
 
-  return fat_findsfnentry(fs, &tmpinfo);
+  return fat_findsfnentry(fs, &tmpinfo, false);
 }
 #endif
 
@@ -964,12 +1000,13 @@ static int fat_path2dirname(const char **path, struct fat_dirinfo_s *dirinfo,
  * Name: fat_findsfnentry
  *
  * Desciption: Find a short file name directory entry.  Returns OK if the
- *  directory exists; -ENOENT if it does not.
+ *  directory exists; -ENOENT if it does not.  If 'anchored' is true, only
+ *  the current directory entry is examined.
  *
  ****************************************************************************/
 
 static int fat_findsfnentry(struct fat_mountpt_s *fs,
-                            struct fat_dirinfo_s *dirinfo)
+                            struct fat_dirinfo_s *dirinfo, bool anchored)
 {
   uint16_t diroffset;
   uint8_t *direntry;
@@ -1040,7 +1077,7 @@ static int fat_findsfnentry(struct fat_mountpt_s *fs,
 
       /* No... get the next directory index and try again */
 
-      if (fat_nextdirentry(fs, &dirinfo->dir) != OK)
+      if (anchored || fat_nextdirentry(fs, &dirinfo->dir) != OK)
         {
           return -ENOENT;
         }
@@ -1158,7 +1195,9 @@ static bool fat_cmplfname(const uint8_t *direntry, const uint8_t *substr)
 /****************************************************************************
  * Name: fat_findlfnentry
  *
- * Desciption: Find a sequence of long file name directory entries.
+ * Desciption: Find a sequence of long file name directory entries.  If
+ *   'anchored' is true, the sequence must begin at the current directory
+ *   entry.
  *
  * NOTE: As a side effect, this function returns with the sector containing
  *   the short file name directory entry in the cache.
@@ -1167,7 +1206,8 @@ static bool fat_cmplfname(const uint8_t *direntry, const uint8_t *substr)
 
 #ifdef CONFIG_FAT_LFN
 static inline int fat_findlfnentry(struct fat_mountpt_s *fs,
-                                   struct fat_dirinfo_s *dirinfo)
+                                   struct fat_dirinfo_s *dirinfo,
+                                   bool anchored)
 {
   uint16_t diroffset;
   uint8_t *direntry;
@@ -1347,6 +1387,11 @@ static inline int fat_findlfnentry(struct fat_mountpt_s *fs,
                * seriously corrupted.
                */
 
+              if (anchored)
+                {
+                  return -ENOENT;
+                }
+
               seqno = lastseq;
               continue;
             }
@@ -1366,10 +1411,13 @@ static inline int fat_findlfnentry(struct fat_mountpt_s *fs,
           seqno = lastseq;
         }
 
-      /* Continue at the next directory entry */
+      /* Continue at the next directory entry.  An anchored search fails
+       * if the sequence was restarted.
+       */
 
 next_entry:
-      if (fat_nextdirentry(fs, &dirinfo->dir) != OK)
+      if ((anchored && seqno == lastseq) ||
+          fat_nextdirentry(fs, &dirinfo->dir) != OK)
         {
           return -ENOENT;
         }
@@ -2059,10 +2107,20 @@ static int fat_putlfname(struct fat_mountpt_s *fs,
   dirinfo->dir.fd_index       = dirinfo->fd_seq.ds_lfnoffset / DIR_SIZE;
 
   /* ds_lfnoffset is the offset in the sector. However fd_index is used as
-   * index for the entire cluster. We need to add that offset
+   * index for the entire cluster (or the entire FAT12/16 root directory).
+   * We need to add that offset
    */
 
-  startsector                 = fat_cluster2sector(fs, dirinfo->dir.fd_currcluster);
+  if (dirinfo->dir.fd_currcluster)
+    {
+      startsector             = fat_cluster2sector(fs,
+                                  dirinfo->dir.fd_currcluster);
+    }
+  else
+    {
+      startsector             = fs->fs_rootbase;
+    }
+
   dirinfo->dir.fd_index      += (dirinfo->dir.fd_currsector - startsector) * DIRSEC_NDIRS(fs);
 
   /* Make sure that the alias is unique in this directory */
@@ -2241,6 +2299,481 @@ static int fat_putsfdirentry(struct fat_mountpt_s *fs,
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_dirhash_getchunk
+ *
+ * Desciption:  Get the (ASCII) characters of one long file name entry.
+ *   Returns the number of characters before the first NUL character, or
+ *   LDIR_MAXLFNCHARS if there is no NUL character.  Only the lower byte
+ *   of each unicode character is compared by fat_cmplfnchunk() and so
+ *   only the lower byte is returned.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FAT_DIRHASH) && defined(CONFIG_FAT_LFN)
+static int fat_dirhash_getchunk(const uint8_t *direntry, uint8_t *dest)
+{
+  static const uint8_t offsets[LDIR_MAXLFNCHARS] =
+  {
+    LDIR_WCHAR1_5,      LDIR_WCHAR1_5 + 2,   LDIR_WCHAR1_5 + 4,
+    LDIR_WCHAR1_5 + 6,  LDIR_WCHAR1_5 + 8,   LDIR_WCHAR6_11,
+    LDIR_WCHAR6_11 + 2, LDIR_WCHAR6_11 + 4,  LDIR_WCHAR6_11 + 6,
+    LDIR_WCHAR6_11 + 8, LDIR_WCHAR6_11 + 10, LDIR_WCHAR12_13,
+    LDIR_WCHAR12_13 + 2
+  };
+
+  int i;
+
+  for (i = 0; i < LDIR_MAXLFNCHARS; i++)
+    {
+      dest[i] = direntry[offsets[i]];
+      if (dest[i] == '\0')
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_dirhash_build
+ *
+ * Desciption:  Read the directory described by the newly allocated hash and
+ *   add all of its names.  Each file or directory is added by its short
+ *   file name and, if it has one, by its long file name.  Names are added
+ *   only if fat_findsfnentry() or fat_findlfnentry() would find them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_DIRHASH
+static int fat_dirhash_build(struct fat_mountpt_s *fs,
+                             struct fat_dirhash_s *dh)
+{
+  struct fs_fatdir_s dir;
+  uint8_t *direntry;
+  off_t    cluster;
+  uint32_t freeno = UINT32_MAX;
+  uint16_t number;
+#ifdef CONFIG_FAT_LFN
+  uint8_t  lfname[LDIR_MAXLFNS * LDIR_MAXLFNCHARS];
+  uint16_t lfnnumber = 0;
+  uint8_t  checksum  = 0;
+  uint8_t  seqno;
+  uint8_t  nextseq   = 0;
+  bool     lfnfound  = false;
+  int      lfnlen    = 0;
+  int      nchars;
+#endif
+  int      ret;
+
+  /* Get the cluster chain of the directory.  The FAT12/16 root directory is
+   * a fixed number of sectors.
+   */
+
+  if (dh->dh_cluster == 0)
+    {
+      if (fs->fs_rootentcnt >= FAT_DIRHASH_NIL)
+        {
+          return -EFBIG;
+        }
+    }
+  else
+    {
+      cluster = dh->dh_cluster;
+      while (cluster >= 2 && cluster < fs->fs_nclusters)
+        {
+          ret = fat_dirhash_addcluster(fs, dh, cluster);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          cluster = fat_getcluster(fs, cluster);
+          if (cluster < 0)
+            {
+              return cluster;
+            }
+        }
+
+      if (dh->dh_nclusters == 0)
+        {
+          return -EINVAL;
+        }
+    }
+
+  /* Then read every directory entry up to the end of the directory */
+
+  fat_dirhash_position(fs, dh, 0, &dir);
+  for (number = 0; ; number++)
+    {
+      ret = fat_fscacheread(fs, dir.fd_currsector);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      direntry = &fs->fs_buffer[DIRSEC_BYTENDX(fs, dir.fd_index)];
+
+      /* Free entries.  Remember the first one; allocations will begin
+       * there.
+       */
+
+      if (direntry[DIR_NAME] == DIR0_ALLEMPTY ||
+          direntry[DIR_NAME] == DIR0_EMPTY)
+        {
+          if (freeno == UINT32_MAX)
+            {
+              freeno = number;
+            }
+
+          if (direntry[DIR_NAME] == DIR0_ALLEMPTY)
+            {
+              break;
+            }
+
+#ifdef CONFIG_FAT_LFN
+          nextseq  = 0;
+          lfnfound = false;
+#endif
+        }
+
+#ifdef CONFIG_FAT_LFN
+      /* Long file name entries */
+
+      else if (LDIR_GETATTRIBUTES(direntry) == LDDIR_LFNATTR)
+        {
+          lfnfound = false;
+          seqno    = LDIR_GETSEQ(direntry);
+
+          if ((seqno & LDIR0_LAST) != 0)
+            {
+              /* The "last" entry begins a new sequence */
+
+              nextseq = seqno & LDIR0_SEQ_MASK;
+              if (nextseq < 1 || nextseq > LDIR_MAXLFNS)
+                {
+                  nextseq = 0;
+                  goto next_entry;
+                }
+
+              checksum  = LDIR_GETCHECKSUM(direntry);
+              lfnnumber = number;
+
+              nchars = fat_dirhash_getchunk(direntry,
+                         &lfname[(nextseq - 1) * LDIR_MAXLFNCHARS]);
+              lfnlen = (nextseq - 1) * LDIR_MAXLFNCHARS + nchars;
+
+              /* fat_findlfnentry() would expect fewer entries for a name
+               * that ends in the previous entry.
+               */
+
+              if (nchars == 0 || lfnlen > LDIR_MAXFNAME)
+                {
+                  nextseq = 0;
+                  goto next_entry;
+                }
+            }
+          else if (nextseq == 0 || seqno != nextseq ||
+                   LDIR_GETCHECKSUM(direntry) != checksum)
+            {
+              nextseq = 0;
+              goto next_entry;
+            }
+          else
+            {
+              /* All characters of the preceding entries must be present */
+
+              nchars = fat_dirhash_getchunk(direntry,
+                         &lfname[(nextseq - 1) * LDIR_MAXLFNCHARS]);
+              if (nchars < LDIR_MAXLFNCHARS)
+                {
+                  nextseq = 0;
+                  goto next_entry;
+                }
+            }
+
+          /* The short file name entry follows the first LFN entry */
+
+          if (--nextseq == 0)
+            {
+              lfnfound = true;
+            }
+        }
+#endif
+
+      /* Short file name entries */
+
+      else
+        {
+#ifdef CONFIG_FAT_LFN
+          if (lfnfound && fat_lfnchecksum(&direntry[DIR_NAME]) == checksum)
+            {
+              ret = fat_dirhash_add(dh,
+                                    fat_dirhash_name(lfname, lfnlen, true),
+                                    lfnnumber);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          nextseq  = 0;
+          lfnfound = false;
+#endif
+
+          if (!(DIR_GETATTRIBUTES(direntry) & FATATTR_VOLUMEID))
+            {
+              ret = fat_dirhash_add(dh,
+                                    fat_dirhash_name(&direntry[DIR_NAME],
+                                                     DIR_MAXFNAME, false),
+                                    number);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+        }
+
+#ifdef CONFIG_FAT_LFN
+next_entry:
+#endif
+      if (fat_nextdirentry(fs, &dir) != OK)
+        {
+          /* The end of the directory.  Any free entries will be in a new
+           * cluster.
+           */
+
+          number++;
+          break;
+        }
+    }
+
+  dh->dh_freeno = freeno != UINT32_MAX ? freeno : number;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_dirhash_get
+ *
+ * Desciption:  Return the hash of the directory that begins at 'cluster',
+ *   building a new hash if necessary.  Returns NULL if the directory is
+ *   not (and cannot be) hashed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_DIRHASH
+static struct fat_dirhash_s *fat_dirhash_get(struct fat_mountpt_s *fs,
+                                             uint32_t cluster)
+{
+  struct fat_dirhash_s *dh;
+  int ret;
+
+  dh = fat_dirhash_find(fs, cluster);
+  if (dh)
+    {
+      return dh->dh_toobig ? NULL : dh;
+    }
+
+  dh = fat_dirhash_alloc(fs, cluster);
+  if (!dh)
+    {
+      return NULL;
+    }
+
+  ret = fat_dirhash_build(fs, dh);
+  if (ret < 0)
+    {
+      fat_dirhash_discard(dh);
+
+      /* Remember directories that are too large so that they are not
+       * read again on the next access.
+       */
+
+      if (ret == -EFBIG)
+        {
+          dh->dh_cluster = cluster;
+          dh->dh_lastuse = ++fs->fs_dirhashclock;
+          dh->dh_inuse   = true;
+          dh->dh_toobig  = true;
+        }
+
+      fdbg("Directory not hashed: %d\n", ret);
+      return NULL;
+    }
+
+  return dh;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_dirhash_lookup
+ *
+ * Desciption:  Find a short file name (lfn == false) or long file name
+ *   directory entry using the directory hash.  dirinfo->dir must refer to
+ *   the first interesting entry of the directory.  Returns -ENOSYS if the
+ *   directory is not hashed; otherwise the result is the same as from
+ *   fat_findsfnentry() or fat_findlfnentry().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_DIRHASH
+static int fat_dirhash_lookup(struct fat_mountpt_s *fs,
+                              struct fat_dirinfo_s *dirinfo, bool lfn)
+{
+  struct fat_dirhash_s *dh;
+  struct fat_dirhashent_s *de;
+  struct fs_fatdir_s dir;
+  uint16_t hash;
+  uint16_t ndx;
+  int ret;
+
+  dh = fat_dirhash_get(fs, dirinfo->dir.fd_startcluster);
+  if (!dh)
+    {
+      return -ENOSYS;
+    }
+
+#ifdef CONFIG_FAT_LFN
+  if (lfn)
+    {
+      hash = fat_dirhash_name(dirinfo->fd_lfname,
+                              strlen((char *)dirinfo->fd_lfname), true);
+    }
+  else
+#endif
+    {
+      hash = fat_dirhash_name(dirinfo->fd_name, DIR_MAXFNAME, false);
+    }
+
+  /* Examine only the directory entries with a matching hash.  Entries
+   * before the starting entry (the '.' and '..' entries) are not
+   * searched.
+   */
+
+  memcpy(&dir, &dirinfo->dir, sizeof(struct fs_fatdir_s));
+  for (ndx = dh->dh_buckets[hash & (dh->dh_nbuckets - 1)];
+       ndx != FAT_DIRHASH_NIL;
+       ndx = de->de_next)
+    {
+      de = &dh->dh_entries[ndx];
+      if (de->de_hash != hash || de->de_number < dir.fd_index)
+        {
+          continue;
+        }
+
+      fat_dirhash_position(fs, dh, de->de_number, &dirinfo->dir);
+
+#ifdef CONFIG_FAT_LFN
+      if (lfn)
+        {
+          ret = fat_findlfnentry(fs, dirinfo, true);
+        }
+      else
+#endif
+        {
+          ret = fat_findsfnentry(fs, dirinfo, true);
+        }
+
+      if (ret != -ENOENT)
+        {
+#ifdef CONFIG_FAT_LFN
+          dirinfo->fd_seq.ds_startsector = dir.fd_currsector;
+#endif
+          return ret;
+        }
+    }
+
+  /* The name is not in the directory */
+
+  memcpy(&dirinfo->dir, &dir, sizeof(struct fs_fatdir_s));
+  return -ENOENT;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_dirhash_insert
+ *
+ * Desciption:  Add the name(s) of a newly written directory entry to the
+ *   directory hash (if the directory is hashed).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_DIRHASH
+static void fat_dirhash_insert(struct fat_mountpt_s *fs,
+                               struct fat_dirinfo_s *dirinfo)
+{
+  struct fat_dirhash_s *dh;
+  int number;
+  int lfnnumber;
+  int ret;
+
+  dh = fat_dirhash_find(fs, dirinfo->dir.fd_startcluster);
+  if (!dh || dh->dh_toobig)
+    {
+      return;
+    }
+
+  number = fat_dirhash_number(fs, dh, dirinfo->fd_seq.ds_sector,
+                              dirinfo->fd_seq.ds_offset);
+  if (number < 0)
+    {
+      ret = number;
+      goto errout;
+    }
+
+  ret = fat_dirhash_add(dh, fat_dirhash_name(dirinfo->fd_name,
+                                             DIR_MAXFNAME, false),
+                        number);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  lfnnumber = number;
+#ifdef CONFIG_FAT_LFN
+  if (dirinfo->fd_lfname[0] != '\0')
+    {
+      lfnnumber = fat_dirhash_number(fs, dh, dirinfo->fd_seq.ds_lfnsector,
+                                     dirinfo->fd_seq.ds_lfnoffset);
+      if (lfnnumber < 0)
+        {
+          ret = lfnnumber;
+          goto errout;
+        }
+
+      ret = fat_dirhash_add(dh, fat_dirhash_name(dirinfo->fd_lfname,
+                              strlen((char *)dirinfo->fd_lfname), true),
+                            lfnnumber);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+#endif
+
+  /* Advance the first free entry past the new entries if it was one of
+   * them.
+   */
+
+  if (dh->dh_freeno >= lfnnumber && dh->dh_freeno <= number)
+    {
+      dh->dh_freeno = number + 1;
+    }
+
+  return;
+
+errout:
+
+  /* The hash no longer describes the directory */
+
+  fdbg("Directory hash discarded: %d\n", ret);
+  fat_dirhash_discard(dh);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -2343,14 +2876,26 @@ int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
            * in the cache.
            */
 
-          ret = fat_findlfnentry(fs, dirinfo);
+#ifdef CONFIG_FAT_DIRHASH
+          ret = fat_dirhash_lookup(fs, dirinfo, true);
+          if (ret == -ENOSYS)
+#endif
+            {
+              ret = fat_findlfnentry(fs, dirinfo, false);
+            }
         }
       else
 #endif
         {
           /* No.. Search for the single short file name directory entry */
 
-          ret = fat_findsfnentry(fs, dirinfo);
+#ifdef CONFIG_FAT_DIRHASH
+          ret = fat_dirhash_lookup(fs, dirinfo, false);
+          if (ret == -ENOSYS)
+#endif
+            {
+              ret = fat_findsfnentry(fs, dirinfo, false);
+            }
         }
 
       /* Did we find the directory entries? */
@@ -2427,6 +2972,9 @@ int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
 int fat_allocatedirentry(struct fat_mountpt_s *fs,
                          struct fat_dirinfo_s *dirinfo)
 {
+#ifdef CONFIG_FAT_DIRHASH
+  struct fat_dirhash_s *dh;
+#endif
   int32_t  cluster;
   int32_t  prevcluster;
   off_t    sector;
@@ -2463,6 +3011,18 @@ int fat_allocatedirentry(struct fat_mountpt_s *fs,
 
       dirinfo->dir.fd_index = 0;
 
+#ifdef CONFIG_FAT_DIRHASH
+      /* If the directory is hashed, skip over the entries that are known
+       * to be in use.
+       */
+
+      dh = fat_dirhash_get(fs, dirinfo->dir.fd_startcluster);
+      if (dh)
+        {
+          fat_dirhash_position(fs, dh, dh->dh_freeno, &dirinfo->dir);
+        }
+#endif
+
       /* Is this a path segment a long or a short file.  Was a long file
        * name parsed?
        */
@@ -2547,6 +3107,19 @@ int fat_allocatedirentry(struct fat_mountpt_s *fs,
           sector++;
         }
 
+#ifdef CONFIG_FAT_DIRHASH
+      /* Add the new cluster to the directory hash */
+
+      dh = fat_dirhash_find(fs, dirinfo->dir.fd_startcluster);
+      if (dh && !dh->dh_toobig &&
+          (dh->dh_clusters[dh->dh_nclusters - 1] !=
+           dirinfo->dir.fd_currcluster ||
+           fat_dirhash_addcluster(fs, dh, cluster) < 0))
+        {
+          fat_dirhash_discard(dh);
+        }
+#endif
+
       /* Start the search again */
 
       cluster = prevcluster;
@@ -2572,6 +3145,13 @@ int fat_freedirentry(struct fat_mountpt_s *fs, struct fat_dirseq_s *seq)
   off_t    startsector;
   int      ret;
 
+#ifdef CONFIG_FAT_DIRHASH
+  /* Remove the names from the directory hash */
+
+  fat_dirhash_freed(fs, seq->ds_sector, seq->ds_offset,
+                    seq->ds_lfnsector, seq->ds_lfnoffset);
+#endif
+
   /* Set it to the cluster containing the "last" LFN entry (that appears
    * first on the media).
    */
@@ -2581,10 +3161,18 @@ int fat_freedirentry(struct fat_mountpt_s *fs, struct fat_dirseq_s *seq)
   dir.fd_index       = seq->ds_lfnoffset / DIR_SIZE;
 
   /* Remember that ds_lfnoffset is the offset in the sector and not the
-   * cluster.
+   * cluster (or the FAT12/16 root directory).
    */
 
-  startsector        = fat_cluster2sector(fs, dir.fd_currcluster);
+  if (dir.fd_currcluster)
+    {
+      startsector    = fat_cluster2sector(fs, dir.fd_currcluster);
+    }
+  else
+    {
+      startsector    = fs->fs_rootbase;
+    }
+
   dir.fd_index      += (dir.fd_currsector - startsector) * DIRSEC_NDIRS(fs);
 
   /* Free all of the directory entries used for the sequence of long file name
@@ -2636,6 +3224,13 @@ int fat_freedirentry(struct fat_mountpt_s *fs, struct fat_dirseq_s *seq)
   uint8_t *direntry;
   int      ret;
 
+#ifdef CONFIG_FAT_DIRHASH
+  /* Remove the name from the directory hash */
+
+  fat_dirhash_freed(fs, seq->ds_sector, seq->ds_offset,
+                    seq->ds_sector, seq->ds_offset);
+#endif
+
   /* Free the single short file name entry.
    *
    * Make sure that the sector containing the directory entry is in the
@@ -2713,8 +3308,11 @@ int fat_dirname2path(struct fat_mountpt_s *fs, struct fs_dirent_s *dir)
 
 int fat_dirnamewrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo)
 {
-#ifdef CONFIG_FAT_LFN
+#if defined(CONFIG_FAT_LFN) || defined(CONFIG_FAT_DIRHASH)
   int ret;
+#endif
+
+#ifdef CONFIG_FAT_LFN
 
   /* Is this a long file name? */
 
@@ -2737,7 +3335,17 @@ int fat_dirnamewrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo)
    */
 #endif
 
+#ifdef CONFIG_FAT_DIRHASH
+  ret = fat_putsfname(fs, dirinfo);
+  if (ret == OK)
+    {
+      fat_dirhash_insert(fs, dirinfo);
+    }
+
+  return ret;
+#else
   return fat_putsfname(fs, dirinfo);
+#endif
 }
 
 /****************************************************************************
@@ -2757,8 +3365,11 @@ int fat_dirnamewrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo)
 int fat_dirwrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
                  uint8_t attributes, uint32_t fattime)
 {
-#ifdef CONFIG_FAT_LFN
+#if defined(CONFIG_FAT_LFN) || defined(CONFIG_FAT_DIRHASH)
   int ret;
+#endif
+
+#ifdef CONFIG_FAT_LFN
 
   /* Does this directory entry have a long file name? */
 
@@ -2783,7 +3394,17 @@ int fat_dirwrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
 
   /* Put the short file name entry data */
 
+#ifdef CONFIG_FAT_DIRHASH
+  ret = fat_putsfdirentry(fs, dirinfo, attributes, fattime);
+  if (ret == OK)
+    {
+      fat_dirhash_insert(fs, dirinfo);
+    }
+
+  return ret;
+#else
   return fat_putsfdirentry(fs, dirinfo, attributes, fattime);
+#endif
 }
 
 /****************************************************************************
@@ -0,0 +1,598 @@
+/****************************************************************************
+ * fs/fat/fs_fat32dirhash.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/fat.h>
+
+#include "inode/inode.h"
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_DIRHASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initial sizes of the hash tables.  They grow as names are added. */
+
+#define FAT_DIRHASH_INITBUCKETS  16
+#define FAT_DIRHASH_INITENTRIES  32
+#define FAT_DIRHASH_MAXBUCKETS   32768
+
+/* Clusters are added to dh_clusters[] this many at a time */
+
+#define FAT_DIRHASH_CLUSTERINCR  8
+
+/* Directory entries per cluster */
+
+#define FAT_DIRHASH_CLUSNDIRS(f) (DIRSEC_NDIRS(f) * (f)->fs_fatsecperclus)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_dirhash_link
+ *
+ * Description:
+ *   Add entry 'ndx' to the head of its bucket list
+ *
+ ****************************************************************************/
+
+static void fat_dirhash_link(FAR struct fat_dirhash_s *dh, uint16_t ndx)
+{
+  FAR struct fat_dirhashent_s *de = &dh->dh_entries[ndx];
+  uint16_t bucket = de->de_hash & (dh->dh_nbuckets - 1);
+
+  de->de_next            = dh->dh_buckets[bucket];
+  dh->dh_buckets[bucket] = ndx;
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_rehash
+ *
+ * Description:
+ *   Re-distribute the names over a larger number of buckets.  If the new
+ *   bucket array cannot be allocated, the old one is simply retained.
+ *
+ ****************************************************************************/
+
+static void fat_dirhash_rehash(FAR struct fat_dirhash_s *dh,
+                               uint16_t nbuckets)
+{
+  FAR uint16_t *oldbuckets = dh->dh_buckets;
+  uint16_t oldnbuckets = dh->dh_nbuckets;
+  uint16_t ndx;
+  uint16_t next;
+  int i;
+
+  dh->dh_buckets = (FAR uint16_t *)kmm_malloc(nbuckets * sizeof(uint16_t));
+  if (!dh->dh_buckets)
+    {
+      dh->dh_buckets = oldbuckets;
+      return;
+    }
+
+  memset(dh->dh_buckets, 0xff, nbuckets * sizeof(uint16_t));
+  dh->dh_nbuckets = nbuckets;
+
+  for (i = 0; i < oldnbuckets; i++)
+    {
+      for (ndx = oldbuckets[i]; ndx != FAT_DIRHASH_NIL; ndx = next)
+        {
+          next = dh->dh_entries[ndx].de_next;
+          fat_dirhash_link(dh, ndx);
+        }
+    }
+
+  kmm_free(oldbuckets);
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_remove
+ *
+ * Description:
+ *   Remove the name that begins at directory entry 'number'
+ *
+ ****************************************************************************/
+
+static void fat_dirhash_remove(FAR struct fat_dirhash_s *dh, uint16_t number)
+{
+  FAR uint16_t *prev;
+  uint16_t ndx;
+  int i;
+
+  for (i = 0; i < dh->dh_nbuckets; i++)
+    {
+      for (prev = &dh->dh_buckets[i]; *prev != FAT_DIRHASH_NIL; )
+        {
+          ndx = *prev;
+          if (dh->dh_entries[ndx].de_number == number)
+            {
+              *prev                       = dh->dh_entries[ndx].de_next;
+              dh->dh_entries[ndx].de_next = dh->dh_free;
+              dh->dh_free                 = ndx;
+              dh->dh_nnames--;
+            }
+          else
+            {
+              prev = &dh->dh_entries[ndx].de_next;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_dirhash_name
+ *
+ * Description:
+ *   Return the 16-bit hash of a short (11 byte) or long file name.  Short
+ *   and long names are hashed differently so that a short name and a long
+ *   name with the same bytes do not collide.
+ *
+ ****************************************************************************/
+
+uint16_t fat_dirhash_name(FAR const uint8_t *name, int len, bool lfn)
+{
+  uint32_t hash = lfn ? 0x050c5d1f : 2166136261u;
+
+  /* 32-bit FNV-1a, folded to 16 bits */
+
+  while (len-- > 0)
+    {
+      hash ^= *name++;
+      hash *= 16777619;
+    }
+
+  return (uint16_t)((hash >> 16) ^ hash);
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_find
+ *
+ * Description:
+ *   Return the hash of the directory that begins at 'cluster' or NULL if
+ *   that directory is not hashed.
+ *
+ ****************************************************************************/
+
+FAR struct fat_dirhash_s *fat_dirhash_find(FAR struct fat_mountpt_s *fs,
+                                           uint32_t cluster)
+{
+  FAR struct fat_dirhash_s *dh;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_DIRHASH_NDIRS; i++)
+    {
+      dh = &fs->fs_dirhash[i];
+      if (dh->dh_inuse && dh->dh_cluster == cluster)
+        {
+          dh->dh_lastuse = ++fs->fs_dirhashclock;
+          return dh;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_alloc
+ *
+ * Description:
+ *   Allocate an empty hash for the directory that begins at 'cluster',
+ *   discarding the least recently used hash if necessary.  Returns NULL if
+ *   memory could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct fat_dirhash_s *fat_dirhash_alloc(FAR struct fat_mountpt_s *fs,
+                                            uint32_t cluster)
+{
+  FAR struct fat_dirhash_s *dh = &fs->fs_dirhash[0];
+  int i;
+
+  for (i = 1; i < CONFIG_FAT_DIRHASH_NDIRS && dh->dh_inuse; i++)
+    {
+      if (!fs->fs_dirhash[i].dh_inuse ||
+          (int32_t)(fs->fs_dirhash[i].dh_lastuse - dh->dh_lastuse) < 0)
+        {
+          dh = &fs->fs_dirhash[i];
+        }
+    }
+
+  fat_dirhash_discard(dh);
+
+  dh->dh_buckets = (FAR uint16_t *)
+    kmm_malloc(FAT_DIRHASH_INITBUCKETS * sizeof(uint16_t));
+  if (!dh->dh_buckets)
+    {
+      return NULL;
+    }
+
+  memset(dh->dh_buckets, 0xff, FAT_DIRHASH_INITBUCKETS * sizeof(uint16_t));
+  dh->dh_nbuckets = FAT_DIRHASH_INITBUCKETS;
+  dh->dh_free     = FAT_DIRHASH_NIL;
+  dh->dh_cluster  = cluster;
+  dh->dh_lastuse  = ++fs->fs_dirhashclock;
+  dh->dh_inuse    = true;
+  return dh;
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_discard
+ *
+ * Description:
+ *   Free all memory used by the hash and mark it unused
+ *
+ ****************************************************************************/
+
+void fat_dirhash_discard(FAR struct fat_dirhash_s *dh)
+{
+  if (dh->dh_clusters)
+    {
+      kmm_free(dh->dh_clusters);
+    }
+
+  if (dh->dh_buckets)
+    {
+      kmm_free(dh->dh_buckets);
+    }
+
+  if (dh->dh_entries)
+    {
+      kmm_free(dh->dh_entries);
+    }
+
+  memset(dh, 0, sizeof(struct fat_dirhash_s));
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_drop
+ *
+ * Description:
+ *   Discard the hash of the directory that begins at 'cluster' (if any).
+ *   This is called when the cluster chain is freed.
+ *
+ ****************************************************************************/
+
+void fat_dirhash_drop(FAR struct fat_mountpt_s *fs, uint32_t cluster)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_DIRHASH_NDIRS; i++)
+    {
+      if (fs->fs_dirhash[i].dh_inuse &&
+          fs->fs_dirhash[i].dh_cluster == cluster)
+        {
+          fat_dirhash_discard(&fs->fs_dirhash[i]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_release
+ *
+ * Description:
+ *   Discard all directory hashes of the volume
+ *
+ ****************************************************************************/
+
+void fat_dirhash_release(FAR struct fat_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_DIRHASH_NDIRS; i++)
+    {
+      fat_dirhash_discard(&fs->fs_dirhash[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_addcluster
+ *
+ * Description:
+ *   Append a cluster to the cluster chain of the hashed directory.
+ *   Directories with FAT_DIRHASH_NIL or more entries are not hashed.
+ *
+ ****************************************************************************/
+
+int fat_dirhash_addcluster(FAR struct fat_mountpt_s *fs,
+                           FAR struct fat_dirhash_s *dh, uint32_t cluster)
+{
+  FAR uint32_t *clusters;
+
+  if ((uint32_t)(dh->dh_nclusters + 1) * FAT_DIRHASH_CLUSNDIRS(fs) >=
+      FAT_DIRHASH_NIL)
+    {
+      return -EFBIG;
+    }
+
+  if ((dh->dh_nclusters % FAT_DIRHASH_CLUSTERINCR) == 0)
+    {
+      clusters = (FAR uint32_t *)
+        kmm_realloc(dh->dh_clusters,
+                    (dh->dh_nclusters + FAT_DIRHASH_CLUSTERINCR) *
+                    sizeof(uint32_t));
+      if (!clusters)
+        {
+          return -ENOMEM;
+        }
+
+      dh->dh_clusters = clusters;
+    }
+
+  dh->dh_clusters[dh->dh_nclusters++] = cluster;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_add
+ *
+ * Description:
+ *   Add a name with the given hash that begins at directory entry 'number'.
+ *   Returns -EFBIG if the directory has too many names to be hashed.
+ *
+ ****************************************************************************/
+
+int fat_dirhash_add(FAR struct fat_dirhash_s *dh, uint16_t hash,
+                    uint16_t number)
+{
+  FAR struct fat_dirhashent_s *entries;
+  uint16_t maxentries;
+  uint16_t ndx;
+
+  if (dh->dh_nnames >= CONFIG_FAT_DIRHASH_MAXENTRIES)
+    {
+      return -EFBIG;
+    }
+
+  if (dh->dh_free != FAT_DIRHASH_NIL)
+    {
+      ndx         = dh->dh_free;
+      dh->dh_free = dh->dh_entries[ndx].de_next;
+    }
+  else
+    {
+      if (dh->dh_nentries >= dh->dh_maxentries)
+        {
+          maxentries = dh->dh_maxentries ? 2 * dh->dh_maxentries :
+                       FAT_DIRHASH_INITENTRIES;
+          if (maxentries > CONFIG_FAT_DIRHASH_MAXENTRIES)
+            {
+              maxentries = CONFIG_FAT_DIRHASH_MAXENTRIES;
+            }
+
+          entries = (FAR struct fat_dirhashent_s *)
+            kmm_realloc(dh->dh_entries,
+                        maxentries * sizeof(struct fat_dirhashent_s));
+          if (!entries)
+            {
+              return -ENOMEM;
+            }
+
+          dh->dh_entries    = entries;
+          dh->dh_maxentries = maxentries;
+        }
+
+      ndx = dh->dh_nentries++;
+    }
+
+  dh->dh_entries[ndx].de_hash   = hash;
+  dh->dh_entries[ndx].de_number = number;
+  fat_dirhash_link(dh, ndx);
+  dh->dh_nnames++;
+
+  /* Keep the average bucket list short */
+
+  if (dh->dh_nnames > 2 * dh->dh_nbuckets &&
+      dh->dh_nbuckets < FAT_DIRHASH_MAXBUCKETS)
+    {
+      fat_dirhash_rehash(dh, 2 * dh->dh_nbuckets);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_number
+ *
+ * Description:
+ *   Return the number of the directory entry at 'offset' in 'sector' in the
+ *   hashed directory or -ENOENT if the sector is not a part of the
+ *   directory.
+ *
+ ****************************************************************************/
+
+int fat_dirhash_number(FAR struct fat_mountpt_s *fs,
+                       FAR struct fat_dirhash_s *dh, off_t sector,
+                       uint16_t offset)
+{
+  uint32_t cluster;
+  off_t    clussector;
+  int      i;
+
+  if (dh->dh_cluster == 0)
+    {
+      /* The fixed size FAT12/16 root directory */
+
+      if (sector < fs->fs_rootbase ||
+          (sector - fs->fs_rootbase) * DIRSEC_NDIRS(fs) >= fs->fs_rootentcnt)
+        {
+          return -ENOENT;
+        }
+
+      return (sector - fs->fs_rootbase) * DIRSEC_NDIRS(fs) +
+             offset / DIR_SIZE;
+    }
+
+  if (sector < fs->fs_database)
+    {
+      return -ENOENT;
+    }
+
+  cluster    = (sector - fs->fs_database) / fs->fs_fatsecperclus + 2;
+  clussector = fat_cluster2sector(fs, cluster);
+
+  for (i = 0; i < dh->dh_nclusters; i++)
+    {
+      if (dh->dh_clusters[i] == cluster)
+        {
+          return i * FAT_DIRHASH_CLUSNDIRS(fs) +
+                 (sector - clussector) * DIRSEC_NDIRS(fs) +
+                 offset / DIR_SIZE;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_position
+ *
+ * Description:
+ *   Position 'dir' at directory entry 'number' of the hashed directory.  A
+ *   number beyond the end of the directory selects the last entry.
+ *
+ ****************************************************************************/
+
+void fat_dirhash_position(FAR struct fat_mountpt_s *fs,
+                          FAR struct fat_dirhash_s *dh, uint16_t number,
+                          FAR struct fs_fatdir_s *dir)
+{
+  uint32_t cluster;
+  uint16_t ndx;
+
+  if (dh->dh_cluster == 0)
+    {
+      if (number >= fs->fs_rootentcnt)
+        {
+          number = fs->fs_rootentcnt - 1;
+        }
+
+      dir->fd_currcluster = 0;
+      dir->fd_currsector  = fs->fs_rootbase + number / DIRSEC_NDIRS(fs);
+      dir->fd_index       = number;
+    }
+  else
+    {
+      if (number >= dh->dh_nclusters * FAT_DIRHASH_CLUSNDIRS(fs))
+        {
+          number = dh->dh_nclusters * FAT_DIRHASH_CLUSNDIRS(fs) - 1;
+        }
+
+      cluster             = dh->dh_clusters[number /
+                                            FAT_DIRHASH_CLUSNDIRS(fs)];
+      ndx                 = number % FAT_DIRHASH_CLUSNDIRS(fs);
+      dir->fd_currcluster = cluster;
+      dir->fd_currsector  = fat_cluster2sector(fs, cluster) +
+                            ndx / DIRSEC_NDIRS(fs);
+      dir->fd_index       = ndx;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_dirhash_freed
+ *
+ * Description:
+ *   Called when the directory entries of a name are freed.  'sector' and
+ *   'offset' describe the short file name entry; 'lfnsector' and
+ *   'lfnoffset' the first entry of the name (the "last" long file name
+ *   entry or, again, the short file name entry).
+ *
+ ****************************************************************************/
+
+void fat_dirhash_freed(FAR struct fat_mountpt_s *fs, off_t sector,
+                       uint16_t offset, off_t lfnsector, uint16_t lfnoffset)
+{
+  FAR struct fat_dirhash_s *dh;
+  int number;
+  int lfnnumber;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_DIRHASH_NDIRS; i++)
+    {
+      dh = &fs->fs_dirhash[i];
+      if (!dh->dh_inuse || dh->dh_toobig)
+        {
+          continue;
+        }
+
+      number = fat_dirhash_number(fs, dh, sector, offset);
+      if (number < 0)
+        {
+          continue;
+        }
+
+      lfnnumber = fat_dirhash_number(fs, dh, lfnsector, lfnoffset);
+      if (lfnnumber < 0 || lfnnumber > number)
+        {
+          /* Should not happen.  Just forget about the directory. */
+
+          fat_dirhash_discard(dh);
+          continue;
+        }
+
+      fat_dirhash_remove(dh, number);
+      if (lfnnumber != number)
+        {
+          fat_dirhash_remove(dh, lfnnumber);
+        }
+
+      if (lfnnumber < dh->dh_freeno)
+        {
+          dh->dh_freeno = lfnnumber;
+        }
+    }
+}
+
+#endif /* CONFIG_FAT_DIRHASH */
@@ -286,6 +286,138 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_freemapscan
+ *
+ * Description:
+ *   Read the FAT entries of the clusters below 'limit' that are not yet
+ *   described by the free cluster bitmap.  When the whole FAT has been
+ *   read, the number of free clusters is known exactly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static int fat_freemapscan(struct fat_mountpt_s *fs, uint32_t limit)
+{
+  uint32_t cluster;
+  off_t    nextcluster;
+
+  if (limit > fs->fs_nclusters)
+    {
+      limit = fs->fs_nclusters;
+    }
+
+  if (fs->fs_freemapscan >= limit)
+    {
+      return OK;
+    }
+
+  for (cluster = fs->fs_freemapscan; cluster < limit; cluster++)
+    {
+      nextcluster = fat_getcluster(fs, cluster);
+      if (nextcluster < 0)
+        {
+          return nextcluster;
+        }
+      else if (nextcluster == 0)
+        {
+          fs->fs_freemapfree++;
+        }
+      else
+        {
+          fs->fs_freemap[cluster >> 3] |= 1 << (cluster & 7);
+        }
+
+      fs->fs_freemapscan = cluster + 1;
+    }
+
+  /* Correct the FSINFO free cluster count when the whole FAT is known */
+
+  if (fs->fs_freemapscan >= fs->fs_nclusters &&
+      fs->fs_fsifreecount != fs->fs_freemapfree)
+    {
+      fs->fs_fsifreecount = fs->fs_freemapfree;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapfind
+ *
+ * Description:
+ *   Find a free cluster in the free cluster bitmap, reading more of the FAT
+ *   as necessary.  The search begins after 'startcluster' and wraps around
+ *   to cluster 2.  For a new chain, the search first looks for 8 aligned
+ *   free clusters in the part of the bitmap that is already known so that
+ *   the file can grow without fragmentation.
+ *
+ * Return:
+ *   <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static int32_t fat_freemapfind(struct fat_mountpt_s *fs,
+                               uint32_t startcluster, bool newchain)
+{
+  uint32_t nbytes = fs->fs_freemapscan >> 3;
+  uint32_t cluster;
+  uint32_t count;
+  uint32_t ndx;
+  int      ret;
+
+  if (newchain && nbytes > 0)
+    {
+      ndx = (startcluster >> 3) % nbytes;
+      for (count = 0; count < nbytes; count++)
+        {
+          if (fs->fs_freemap[ndx] == 0)
+            {
+              return ndx << 3;
+            }
+
+          if (++ndx >= nbytes)
+            {
+              ndx = 0;
+            }
+        }
+    }
+
+  cluster = startcluster;
+  for (count = 2; count < fs->fs_nclusters; count++)
+    {
+      /* Examine the next cluster, wrapping to the first cluster */
+
+      if (++cluster >= fs->fs_nclusters)
+        {
+          cluster = 2;
+        }
+
+      if (cluster >= fs->fs_freemapscan)
+        {
+          ret = fat_freemapscan(fs, cluster + 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      if ((fs->fs_freemap[cluster >> 3] & (1 << (cluster & 7))) == 0)
+        {
+          return cluster;
+        }
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -662,6 +794,23 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       }
   }
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Allocate the free cluster bitmap.  Clusters 0 and 1 do not exist.  The
+   * rest of the bitmap is filled in from the FAT when it is needed.
+   */
+
+  if ((fs->fs_nclusters + 7) / 8 <= CONFIG_FAT_FREEMAP_MAXSIZE)
+    {
+      fs->fs_freemap = (uint8_t *)kmm_zalloc((fs->fs_nclusters + 7) / 8);
+      if (fs->fs_freemap)
+        {
+          fs->fs_freemap[0]  = 0x03;
+          fs->fs_freemapscan = 2;
+          fs->fs_freemapfree = 0;
+        }
+    }
+#endif
+
   /* We did it! */
 
   fdbg("FAT%d:\n", fs->fs_type == 0 ? 12 : fs->fs_type == 1  ? 16 : 32);
@@ -1111,6 +1260,29 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+
+#ifdef CONFIG_FAT_FREEMAP
+      /* Keep the free cluster bitmap up to date */
+
+      if (fs->fs_freemap && clusterno >= 2 &&
+          clusterno < fs->fs_freemapscan)
+        {
+          uint8_t mask = 1 << (clusterno & 7);
+
+          if (nextcluster == 0 && (fs->fs_freemap[clusterno >> 3] & mask))
+            {
+              fs->fs_freemap[clusterno >> 3] &= ~mask;
+              fs->fs_freemapfree++;
+            }
+          else if (nextcluster != 0 &&
+                   !(fs->fs_freemap[clusterno >> 3] & mask))
+            {
+              fs->fs_freemap[clusterno >> 3] |= mask;
+              fs->fs_freemapfree--;
+            }
+        }
+#endif
+
       return OK;
     }
 
@@ -1130,6 +1302,15 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
   int32_t nextcluster;
   int    ret;
 
+#ifdef CONFIG_FAT_DIRHASH
+  /* If this is a hashed directory, then the hash is no longer valid */
+
+  if (cluster >= 2)
+    {
+      fat_dirhash_drop(fs, cluster);
+    }
+#endif
+
   /* Loop while there are clusters in the chain */
 
   while (cluster >= 2 && cluster < fs->fs_nclusters)
@@ -1233,61 +1414,78 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
+#ifdef CONFIG_FAT_FREEMAP
+  /* Find the next free cluster in the free cluster bitmap */
 
-  newcluster = startcluster;
-  for (;;)
+  if (fs->fs_freemap)
     {
-      /* Examine the next cluster in the FAT */
+      ret = fat_freemapfind(fs, startcluster, cluster == 0);
+      if (ret <= 0)
+        {
+          return ret;
+        }
 
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters)
+      newcluster = ret;
+    }
+  else
+#endif
+    {
+      /* Loop until (1) we discover that there are not free clusters
+       * (return 0), an errors occurs (return -errno), or (3) we find
+       * the next cluster (return the new cluster number).
+       */
+
+      newcluster = startcluster;
+      for (;;)
         {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
+          /* Examine the next cluster in the FAT */
 
-          newcluster = 2;
-          if (newcluster > startcluster)
+          newcluster++;
+          if (newcluster >= fs->fs_nclusters)
             {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
+              /* If we hit the end of the available clusters, then
+               * wrap back to the beginning because we might have
+               * started at a non-optimal place.  But don't continue
+               * past the start cluster.
                */
 
-              return 0;
+              newcluster = 2;
+              if (newcluster > startcluster)
+                {
+                  /* We are back past the starting cluster, then there
+                   * is no free cluster.
+                   */
+
+                  return 0;
+                }
             }
-        }
 
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
+          /* We have a candidate cluster.  Check if the cluster number is
+           * mapped to a group of sectors.
+           */
 
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
+          startsector = fat_getcluster(fs, newcluster);
+          if (startsector == 0)
+            {
+              /* Found have found a free cluster break out */
 
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
+              break;
+            }
+          else if (startsector < 0)
+            {
+              /* Some error occurred, return the error number */
 
-          return startsector;
-        }
+              return startsector;
+            }
 
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
+          /* We wrap all the back to the starting cluster?  If so, then
+           * there are no free clusters.
+           */
 
-      if (newcluster == startcluster)
-        {
-          return 0;
+          if (newcluster == startcluster)
+            {
+              return 0;
+            }
         }
     }
 
@@ -1776,6 +1974,24 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
       return OK;
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Reading the rest of the FAT into the free cluster bitmap will also
+   * correct fs_fsifreecount.
+   */
+
+  if (fs->fs_freemap)
+    {
+      int ret = fat_freemapscan(fs, fs->fs_nclusters);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      *pfreeclusters = fs->fs_freemapfree;
+      return OK;
+    }
+#endif
+
   /* Otherwise, we will have to count the number of free clusters */
 
   nfreeclusters = 0;
@@ -1820,12 +2036,9 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
                   return ret;
                 }
 
-              /* Reset the offset to the next FAT entry.
-               * Increment the sector number to read next time around.
-               */
+              /* Reset the offset to the next FAT entry */
 
               offset = 0;
-              fatsector++;
             }
 
           /* FAT16 and FAT32 differ only on the size of each cluster start
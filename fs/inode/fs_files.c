@@ -298,6 +298,70 @@ errout:
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: file_close_detached
+ *
+ * Description:
+ *   Close a file structure that is not a member of any task's list of open
+ *   files, such as one that was opened by file_dup2() in order to pass it
+ *   to another task.
+ *
+ ****************************************************************************/
+
+int file_close_detached(FAR struct file *filep)
+{
+  DEBUGASSERT(filep != NULL);
+  return _files_close(filep);
+}
+
+/****************************************************************************
+ * Name: file_attach
+ *
+ * Description:
+ *   Move an open file structure that is not a member of any task's list of
+ *   open files into the list of the current task.  The file structure is
+ *   cleared, so that the open file now belongs only to the returned file
+ *   descriptor.
+ *
+ * Returned Value:
+ *   The new file descriptor (>= minfd) on success; -EMFILE if there are no
+ *   free file descriptors.
+ *
+ ****************************************************************************/
+
+int file_attach(FAR struct file *filep, int minfd)
+{
+  FAR struct filelist *list;
+  int i;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+
+  list = sched_getfiles();
+  DEBUGASSERT(list);
+
+  _files_semtake(list);
+  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+    {
+      if (!list->fl_files[i].f_inode)
+        {
+          list->fl_files[i].f_oflags = filep->f_oflags;
+          list->fl_files[i].f_pos    = filep->f_pos;
+          list->fl_files[i].f_inode  = filep->f_inode;
+          list->fl_files[i].f_priv   = filep->f_priv;
+          _files_semgive(list);
+
+          filep->f_oflags = 0;
+          filep->f_pos    = 0;
+          filep->f_inode  = NULL;
+          filep->f_priv   = NULL;
+          return i;
+        }
+    }
+
+  _files_semgive(list);
+  return -EMFILE;
+}
+
 /****************************************************************************
  * Name: files_allocate
  *
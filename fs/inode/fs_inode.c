@@ -39,8 +39,10 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <assert.h>
 #include <semaphore.h>
+#include <sched.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
@@ -63,13 +65,22 @@
  * removed.  In that case umount() hold the inode semaphore, but the block
  * driver may callback to unregister_blockdriver() after the un-mount,
  * requiring the seamphore again.
+ *
+ * Most accesses to the tree are lookups that do not modify it.  Those may
+ * take the tree for reading so that concurrent lookups do not serialize.
+ * Readers take 'sem' only long enough to register themselves, so a writer
+ * that holds 'sem' while waiting for the readers to drain also blocks any
+ * new readers.
  */
 
 struct inode_sem_s
 {
-  sem_t   sem;     /* The semaphore */
-  pid_t   holder;  /* The current holder of the semaphore */
-  int16_t count;   /* Number of counts held */
+  sem_t   sem;      /* The semaphore */
+  sem_t   rdone;    /* Posted when the last reader leaves */
+  pid_t   holder;   /* The current holder of the semaphore */
+  int16_t count;    /* Number of counts held */
+  int16_t nreaders; /* Number of readers in the tree */
+  bool    wwait;    /* A writer is waiting on rdone */
 };
 
 /****************************************************************************
@@ -88,6 +99,26 @@ FAR struct inode *g_root_inode = NULL;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: _inode_semwait
+ *
+ * Description:
+ *   Wait on a semaphore, ignoring interruptions by signals.
+ *
+ ****************************************************************************/
+
+static void _inode_semwait(FAR sem_t *sem)
+{
+  while (sem_wait(sem) != 0)
+    {
+      /* The only case that an error should occr here is if
+       * the wait was awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+}
+
 /****************************************************************************
  * Name: _inode_compare
  *
@@ -185,8 +216,11 @@ void inode_initialize(void)
    */
 
   (void)sem_init(&g_inode_sem.sem, 0, 1);
-  g_inode_sem.holder = NO_HOLDER;
-  g_inode_sem.count  = 0;
+  (void)sem_init(&g_inode_sem.rdone, 0, 0);
+  g_inode_sem.holder   = NO_HOLDER;
+  g_inode_sem.count    = 0;
+  g_inode_sem.nreaders = 0;
+  g_inode_sem.wwait    = false;
 
   /* Initialize files array (if it is used) */
 
@@ -225,15 +259,21 @@ void inode_semtake(void)
 
   else
     {
-      while (sem_wait(&g_inode_sem.sem) != 0)
-        {
-          /* The only case that an error should occr here is if
-           * the wait was awakened by a signal.
-           */
+      _inode_semwait(&g_inode_sem.sem);
 
-          ASSERT(get_errno() == EINTR);
+      /* Holding the semaphore keeps new readers out.  Wait for any readers
+       * already in the tree to leave.
+       */
+
+      sched_lock();
+      while (g_inode_sem.nreaders > 0)
+        {
+          g_inode_sem.wwait = true;
+          _inode_semwait(&g_inode_sem.rdone);
         }
 
+      sched_unlock();
+
       /* No we hold the semaphore */
 
       g_inode_sem.holder = me;
@@ -272,6 +312,76 @@ void inode_semgive(void)
     }
 }
 
+/****************************************************************************
+ * Name: inode_rdsemtake
+ *
+ * Description:
+ *   Get shared, read-only access to the in-memory inode tree (g_inode_sem).
+ *
+ ****************************************************************************/
+
+void inode_rdsemtake(void)
+{
+  /* Do we already hold the semaphore exclusively? */
+
+  if (getpid() == g_inode_sem.holder)
+    {
+      /* Yes... just increment the count */
+
+      g_inode_sem.count++;
+      DEBUGASSERT(g_inode_sem.count > 0);
+    }
+
+  /* Wait until there is no writer, then register as a reader */
+
+  else
+    {
+      _inode_semwait(&g_inode_sem.sem);
+
+      sched_lock();
+      g_inode_sem.nreaders++;
+      DEBUGASSERT(g_inode_sem.nreaders > 0);
+      sched_unlock();
+
+      sem_post(&g_inode_sem.sem);
+    }
+}
+
+/****************************************************************************
+ * Name: inode_rdsemgive
+ *
+ * Description:
+ *   Relinquish access obtained with inode_rdsemtake().
+ *
+ ****************************************************************************/
+
+void inode_rdsemgive(void)
+{
+  /* A reader cannot become the holder while it is in the tree, so if we are
+   * the holder then the access was taken as a nested exclusive access.
+   */
+
+  if (getpid() == g_inode_sem.holder)
+    {
+      inode_semgive();
+    }
+  else
+    {
+      sched_lock();
+      DEBUGASSERT(g_inode_sem.nreaders > 0);
+
+      /* Wake up the writer if this was the last reader */
+
+      if (--g_inode_sem.nreaders == 0 && g_inode_sem.wwait)
+        {
+          g_inode_sem.wwait = false;
+          sem_post(&g_inode_sem.rdone);
+        }
+
+      sched_unlock();
+    }
+}
+
 /****************************************************************************
  * Name: inode_search
  *
@@ -296,7 +406,32 @@ FAR struct inode *inode_search(FAR const char **path,
 
   while (node)
     {
-      int result = _inode_compare(name, node);
+      bool cached = false;
+      int result;
+
+      /* If the caller does not need the left peer, then the inode lookup
+       * cache may be able to resolve this path segment without walking the
+       * list of peers.  We must be at the first peer at this level of the
+       * tree for the cache to be valid.
+       */
+
+      if (peer == NULL && left == NULL &&
+          inode_cache_lookup(above, name, &node))
+        {
+          if (node == NULL)
+            {
+              /* A negative entry:  There is no such segment */
+
+              break;
+            }
+
+          cached = true;
+          result = 0;
+        }
+      else
+        {
+          result = _inode_compare(name, node);
+        }
 
       /* Case 1:  The name is less than the name of the node.
        * Since the names are ordered, these means that there
@@ -306,6 +441,11 @@ FAR struct inode *inode_search(FAR const char **path,
 
       if (result < 0)
         {
+          if (peer == NULL)
+            {
+              inode_cache_add(above, name, NULL);
+            }
+
           node = NULL;
           break;
         }
@@ -319,12 +459,22 @@ FAR struct inode *inode_search(FAR const char **path,
         {
           left = node;
           node = node->i_peer;
+
+          if (node == NULL && peer == NULL)
+            {
+              inode_cache_add(above, name, NULL);
+            }
         }
 
       /* The names match */
 
       else
         {
+          if (peer == NULL && !cached)
+            {
+              inode_cache_add(above, name, node);
+            }
+
           /* Now there are three more possibilities:
            *   (1) This is the node that we are looking for or,
            *   (2) The node we are looking for is "below" this one.
@@ -0,0 +1,261 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FS_INODE_CACHE_SIZE
+#  define CONFIG_FS_INODE_CACHE_SIZE 32
+#endif
+
+#ifndef CONFIG_FS_INODE_CACHE_NAMELEN
+#  define CONFIG_FS_INODE_CACHE_NAMELEN 15
+#endif
+
+#if CONFIG_FS_INODE_CACHE_NAMELEN > 255
+#  error CONFIG_FS_INODE_CACHE_NAMELEN is too large
+#endif
+
+/* FNV-1a hash parameters */
+
+#define INODE_HASH_BASIS 2166136261u
+#define INODE_HASH_PRIME 16777619u
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached path segment lookup.  An entry is valid only if its generation
+ * number matches the current cache generation.  A NULL node pointer records
+ * that 'name' does not exist beneath 'parent' (a negative entry).
+ */
+
+struct inode_centry_s
+{
+  FAR struct inode *parent;                   /* Parent (NULL for top level) */
+  FAR struct inode *node;                     /* Child or NULL if no match */
+  uint32_t gen;                               /* Generation of the entry */
+  uint8_t  namelen;                           /* Length of the segment name */
+  char     name[CONFIG_FS_INODE_CACHE_NAMELEN]; /* Segment name (no NUL) */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_centry_s g_inode_cache[CONFIG_FS_INODE_CACHE_SIZE];
+
+/* Current cache generation.  Entries in .bss have generation zero and so
+ * are initially invalid.
+ */
+
+static uint32_t g_inode_cachegen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Return the cache index for the path segment 'name' beneath 'parent' and
+ *   the length of that segment.  Returns a length of zero if the segment
+ *   cannot be cached.
+ *
+ ****************************************************************************/
+
+static unsigned int inode_cache_hash(FAR struct inode *parent,
+                                     FAR const char *name,
+                                     FAR unsigned int *namelen)
+{
+  uintptr_t key = (uintptr_t)parent;
+  uint32_t hash = INODE_HASH_BASIS;
+  unsigned int len;
+
+  for (len = 0; name[len] != '\0' && name[len] != '/'; len++)
+    {
+      if (len >= CONFIG_FS_INODE_CACHE_NAMELEN)
+        {
+          *namelen = 0;
+          return 0;
+        }
+
+      hash ^= (uint8_t)name[len];
+      hash *= INODE_HASH_PRIME;
+    }
+
+  /* Fold in the parent address.  The low bits are always zero. */
+
+  hash ^= (uint32_t)(key >> 2);
+  hash *= INODE_HASH_PRIME;
+
+  *namelen = len;
+  return hash % CONFIG_FS_INODE_CACHE_SIZE;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the path segment beginning at 'name' beneath 'parent' in the
+ *   inode cache.  On a hit, the cached inode (which may be NULL for a
+ *   negative entry) is returned in 'node'.
+ *
+ * Returned Value:
+ *   true on a cache hit; false if the segment must be looked up in the tree.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore for reading or writing.
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode **node)
+{
+  FAR struct inode_centry_s *entry;
+  unsigned int namelen;
+  unsigned int ndx;
+  bool hit = false;
+
+  ndx = inode_cache_hash(parent, name, &namelen);
+  if (namelen > 0)
+    {
+      /* Readers may run concurrently so the entry could be replaced while we
+       * look at it.
+       */
+
+      sched_lock();
+      entry = &g_inode_cache[ndx];
+      if (entry->gen == g_inode_cachegen && entry->parent == parent &&
+          entry->namelen == namelen &&
+          memcmp(entry->name, name, namelen) == 0)
+        {
+          *node = entry->node;
+          hit   = true;
+        }
+
+      sched_unlock();
+    }
+
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Record the result of looking up the path segment beginning at 'name'
+ *   beneath 'parent'.  'node' is NULL if there is no such segment.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore for reading or writing.
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR struct inode *parent, FAR const char *name,
+                     FAR struct inode *node)
+{
+  FAR struct inode_centry_s *entry;
+  unsigned int namelen;
+  unsigned int ndx;
+
+  ndx = inode_cache_hash(parent, name, &namelen);
+  if (namelen > 0)
+    {
+      sched_lock();
+      entry          = &g_inode_cache[ndx];
+      entry->parent  = parent;
+      entry->node    = node;
+      entry->gen     = g_inode_cachegen;
+      entry->namelen = namelen;
+      memcpy(entry->name, name, namelen);
+      sched_unlock();
+    }
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Discard all cached lookups.  This must be called whenever the shape of
+ *   the inode tree changes.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore for writing.
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  sched_lock();
+  if (++g_inode_cachegen == 0)
+    {
+      /* The generation number wrapped; old entries could now appear to be
+       * valid.
+       */
+
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_cachegen = 1;
+    }
+
+  sched_unlock();
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
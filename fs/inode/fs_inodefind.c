@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <sched.h>
 #include <errno.h>
 #include <nuttx/fs/fs.h>
 
@@ -83,17 +84,21 @@ FAR struct inode *inode_find(FAR const char *path, FAR const char **relpath)
     }
 
   /* Find the node matching the path.  If found, increment the count of
-   * references on the node.
+   * references on the node.  A lookup does not modify the tree so only
+   * shared access is needed.  Other readers may be incrementing the same
+   * reference count, however.
    */
 
-  inode_semtake();
+  inode_rdsemtake();
   node = inode_search(&path, (FAR struct inode**)NULL, (FAR struct inode**)NULL, relpath);
   if (node)
     {
+      sched_lock();
       node->i_crefs++;
+      sched_unlock();
     }
 
-  inode_semgive();
+  inode_rdsemgive();
   return node;
 }
 
@@ -124,6 +124,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+
+      /* Cached lookups may refer to the unlinked subtree */
+
+      inode_cache_invalidate();
     }
 
   return node;
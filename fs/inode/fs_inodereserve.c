@@ -135,6 +135,10 @@ static void inode_insert(FAR struct inode *node,
       node->i_peer = g_root_inode;
       g_root_inode = node;
     }
+
+  /* Cached lookups (in particular, negative entries) may now be wrong */
+
+  inode_cache_invalidate();
 }
 
 /****************************************************************************
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <dirent.h>
 
 #include <nuttx/fs/fs.h>
@@ -160,6 +161,30 @@ void inode_semtake(void);
 
 void inode_semgive(void);
 
+/****************************************************************************
+ * Name: inode_rdsemtake
+ *
+ * Description:
+ *   Get shared, read-only access to the in-memory inode tree.  Any number of
+ *   readers may hold the tree concurrently but readers exclude writers.  A
+ *   task that already holds exclusive access simply nests.  The inode tree
+ *   must not be modified (and inode_semtake() must not be called) while
+ *   shared access is held.
+ *
+ ****************************************************************************/
+
+void inode_rdsemtake(void);
+
+/****************************************************************************
+ * Name: inode_rdsemgive
+ *
+ * Description:
+ *   Relinquish access obtained with inode_rdsemtake().
+ *
+ ****************************************************************************/
+
+void inode_rdsemgive(void);
+
 /****************************************************************************
  * Name: inode_search
  *
@@ -198,6 +223,54 @@ void inode_free(FAR struct inode *node);
 
 const char *inode_nextname(FAR const char *name);
 
+/* fs_inodecache.c **********************************************************/
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the path segment beginning at 'name' beneath 'parent' in the
+ *   inode cache.  On a hit, the cached inode (which may be NULL for a
+ *   negative entry) is returned in 'node'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode **node);
+#else
+#  define inode_cache_lookup(p,n,i) (false)
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Record the result of looking up the path segment beginning at 'name'
+ *   beneath 'parent'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+void inode_cache_add(FAR struct inode *parent, FAR const char *name,
+                     FAR struct inode *node);
+#else
+#  define inode_cache_add(p,n,i)
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Discard all cached lookups after the inode tree has changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+void inode_cache_invalidate(void);
+#else
+#  define inode_cache_invalidate()
+#endif
+
 /* fs_inodereserver.c *******************************************************/
 /****************************************************************************
  * Name: inode_reserve
@@ -141,9 +141,9 @@ static int automount_findinode(FAR const char *path)
 
   DEBUGASSERT(path && path[0] == '/');
 
-  /* Get exclusive access to the in-memory inode tree. */
+  /* Get shared access to the in-memory inode tree. */
 
-  inode_semtake();
+  inode_rdsemtake();
 
   /* Find the inode */
 
@@ -174,9 +174,9 @@ static int automount_findinode(FAR const char *path)
       ret = -ENOTDIR;
     }
 
-  /* Relinquish our exclusive access to the inode try and return the result */
+  /* Relinquish our access to the inode try and return the result */
 
-  inode_semgive();
+  inode_rdsemgive();
   return ret;
 }
 
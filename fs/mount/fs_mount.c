@@ -377,6 +377,10 @@ int mount(FAR const char *source, FAR const char *target,
   mountpt_inode->i_mode    = mode;
 #endif
   mountpt_inode->i_private = fshandle;
+
+  /* The mountpoint now absorbs all lookups beneath it */
+
+  inode_cache_invalidate();
   inode_semgive();
 
  /* We can release our reference to the blkdrver_inode, if the filesystem
@@ -127,6 +127,8 @@ EXTERN int  nfs_fsinfo(FAR struct nfsmount *nmp);
 EXTERN int nfs_request(struct nfsmount *nmp, int procnum,
                 FAR void *request, size_t reqlen,
                 FAR void *response, size_t resplen);
+EXTERN int  nfs_requestv(FAR struct nfsmount *nmp, int procnum,
+              FAR struct rpc_slot *slots, int nslots);
 EXTERN int  nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
               FAR struct file_handle *fhandle,
               FAR struct nfs_fattr *obj_attributes,
@@ -141,6 +143,24 @@ EXTERN int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
 EXTERN void nfs_attrupdate(FAR struct nfsnode *np,
               FAR struct nfs_fattr *attributes);
 
+#ifdef CONFIG_NFS_ATTRCACHE
+EXTERN int  nfs_attrcache_find(FAR struct nfsmount *nmp,
+              FAR struct file_handle *fhandle, FAR const char *filename,
+              FAR struct nfs_fattr *obj_attributes);
+EXTERN void nfs_attrcache_add(FAR struct nfsmount *nmp,
+              FAR const struct file_handle *dirhandle,
+              FAR const char *filename, FAR const nfsfh_t *fhandle,
+              uint32_t fhsize, FAR const struct nfs_fattr *obj_attributes);
+EXTERN void nfs_attrcache_remove(FAR struct nfsmount *nmp,
+              FAR const struct file_handle *dirhandle,
+              FAR const char *filename);
+EXTERN void nfs_attrcache_invalidate(FAR struct nfsmount *nmp,
+              FAR const nfsfh_t *fhandle, uint32_t fhsize);
+#else
+#  define nfs_attrcache_remove(n,d,f)
+#  define nfs_attrcache_invalidate(n,h,s)
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,265 @@
+/****************************************************************************
+ * fs/nfs/nfs_attrcache.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "rpc.h"
+#include "nfs.h"
+#include "nfs_proto.h"
+#include "nfs_mount.h"
+
+#ifdef CONFIG_NFS_ATTRCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NFS_ATTRCACHE_TICKS SEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEO)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nfs_attrcache_match
+ *
+ * Description:
+ *   Return the entry for the name in the directory, or NULL if there is
+ *   none.  Entries that have expired are released.
+ *
+ ****************************************************************************/
+
+static FAR struct nfs_acentry *
+nfs_attrcache_match(FAR struct nfsmount *nmp,
+                    FAR const struct file_handle *dirhandle,
+                    FAR const char *filename)
+{
+  FAR struct nfs_acentry *entry;
+  uint32_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      entry = &nmp->nm_attrcache[i];
+      if (!entry->ac_inuse)
+        {
+          continue;
+        }
+
+      if (now - entry->ac_time >= NFS_ATTRCACHE_TICKS)
+        {
+          entry->ac_inuse = false;
+          continue;
+        }
+
+      if (entry->ac_dirfhsize == dirhandle->length &&
+          strcmp(entry->ac_name, filename) == 0 &&
+          memcmp(&entry->ac_dirfh, &dirhandle->handle,
+                 dirhandle->length) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nfs_attrcache_find
+ *
+ * Description:
+ *   Look up a name in the cache of LOOKUP results.  On entry, fhandle is
+ *   the handle of the directory that contains the name.  If the name is
+ *   found, fhandle is replaced by the handle of the named object and its
+ *   attributes are returned in obj_attributes (if not NULL).
+ *
+ * Returned Value:
+ *   Zero on success; ENOENT if the name is not in the cache.
+ *
+ ****************************************************************************/
+
+int nfs_attrcache_find(FAR struct nfsmount *nmp,
+                       FAR struct file_handle *fhandle,
+                       FAR const char *filename,
+                       FAR struct nfs_fattr *obj_attributes)
+{
+  FAR struct nfs_acentry *entry;
+
+  entry = nfs_attrcache_match(nmp, fhandle, filename);
+  if (entry == NULL)
+    {
+      return ENOENT;
+    }
+
+  fhandle->length = entry->ac_fhsize;
+  memcpy(&fhandle->handle, &entry->ac_fh, entry->ac_fhsize);
+
+  if (obj_attributes)
+    {
+      memcpy(obj_attributes, &entry->ac_fattr, sizeof(struct nfs_fattr));
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_add
+ *
+ * Description:
+ *   Remember the file handle and attributes of the object called filename
+ *   in the directory dirhandle.  An entry that has expired or else the
+ *   oldest entry is replaced.
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_add(FAR struct nfsmount *nmp,
+                       FAR const struct file_handle *dirhandle,
+                       FAR const char *filename, FAR const nfsfh_t *fhandle,
+                       uint32_t fhsize,
+                       FAR const struct nfs_fattr *obj_attributes)
+{
+  FAR struct nfs_acentry *entry;
+  FAR struct nfs_acentry *oldest;
+  uint32_t now = clock_systimer();
+  int i;
+
+  if (strlen(filename) > NAME_MAX || fhsize > NFSX_V3FHMAX)
+    {
+      return;
+    }
+
+  entry = nfs_attrcache_match(nmp, dirhandle, filename);
+  if (entry == NULL)
+    {
+      oldest = &nmp->nm_attrcache[0];
+      for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+        {
+          entry = &nmp->nm_attrcache[i];
+          if (!entry->ac_inuse)
+            {
+              break;
+            }
+
+          if (now - entry->ac_time > now - oldest->ac_time)
+            {
+              oldest = entry;
+            }
+        }
+
+      if (i >= CONFIG_NFS_ATTRCACHE_NENTRIES)
+        {
+          entry = oldest;
+        }
+    }
+
+  entry->ac_time      = now;
+  entry->ac_inuse     = true;
+  entry->ac_dirfhsize = dirhandle->length;
+  entry->ac_fhsize    = fhsize;
+
+  memcpy(&entry->ac_dirfh, &dirhandle->handle, dirhandle->length);
+  memcpy(&entry->ac_fh, fhandle, fhsize);
+  memcpy(&entry->ac_fattr, obj_attributes, sizeof(struct nfs_fattr));
+  strcpy(entry->ac_name, filename);
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_remove
+ *
+ * Description:
+ *   Forget the object called filename in the directory dirhandle.  This is
+ *   called when the object is removed or renamed.
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_remove(FAR struct nfsmount *nmp,
+                          FAR const struct file_handle *dirhandle,
+                          FAR const char *filename)
+{
+  FAR struct nfs_acentry *entry;
+
+  entry = nfs_attrcache_match(nmp, dirhandle, filename);
+  if (entry != NULL)
+    {
+      entry->ac_inuse = false;
+    }
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_invalidate
+ *
+ * Description:
+ *   Forget the attributes of the object with the file handle fhandle (under
+ *   any name).  This is called when the object is written or truncated.
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_invalidate(FAR struct nfsmount *nmp,
+                              FAR const nfsfh_t *fhandle, uint32_t fhsize)
+{
+  FAR struct nfs_acentry *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      entry = &nmp->nm_attrcache[i];
+      if (entry->ac_inuse && entry->ac_fhsize == fhsize &&
+          memcmp(&entry->ac_fh, fhandle, fhsize) == 0)
+        {
+          entry->ac_inuse = false;
+        }
+    }
+}
+
+#endif /* CONFIG_NFS_ATTRCACHE */
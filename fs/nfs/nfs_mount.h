@@ -56,10 +56,77 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_NFS_MAXREQUESTS
+#  define CONFIG_NFS_MAXREQUESTS 1
+#endif
+
+/* Replies to RPCs that are in flight at the same time must be held by the
+ * UDP read-ahead buffers until they are received.
+ */
+
+#if CONFIG_NFS_MAXREQUESTS > 1 && !defined(CONFIG_NET_UDP_READAHEAD)
+#  warning CONFIG_NFS_MAXREQUESTS > 1 requires CONFIG_NET_UDP_READAHEAD
+#  undef  CONFIG_NFS_MAXREQUESTS
+#  define CONFIG_NFS_MAXREQUESTS 1
+#endif
+
+#ifdef CONFIG_NFS_ATTRCACHE
+#  ifndef CONFIG_NFS_ATTRCACHE_NENTRIES
+#    define CONFIG_NFS_ATTRCACHE_NENTRIES 16
+#  endif
+#  ifndef CONFIG_NFS_ATTRCACHE_TIMEO
+#    define CONFIG_NFS_ATTRCACHE_TIMEO 3
+#  endif
+#endif
+
+/* I/O buffers.  nm_iobuffer is followed by one buffer for each READ or
+ * WRITE RPC that may be in flight.  If data is retained in those buffers
+ * (read-ahead or write-behind), then the first one must be separate from
+ * nm_iobuffer which is used by all other RPCs.
+ */
+
+#if defined(CONFIG_NFS_READAHEAD) || defined(CONFIG_NFS_WRITEBEHIND)
+#  define NFS_FIRSTDATABUF      1
+#else
+#  define NFS_FIRSTDATABUF      0
+#endif
+
+#define NFS_NIOBUFFERS          (NFS_FIRSTDATABUF + CONFIG_NFS_MAXREQUESTS)
+
+#define nfs_databuffer(nmp,i) \
+  ((FAR uint8_t *)(nmp)->nm_iobuffer + \
+   (NFS_FIRSTDATABUF + (i)) * (nmp)->nm_buflen)
+
+/* What the data buffers hold (nm_cstate) */
+
+#define NFS_CACHE_EMPTY         0 /* Nothing */
+#define NFS_CACHE_READ          1 /* Data read from nm_cnode */
+#define NFS_CACHE_WRITE         2 /* Data written to nm_cnode, not yet sent */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_NFS_ATTRCACHE
+/* The result of one LOOKUP RPC: The file handle and attributes of the
+ * object called ac_name in the directory ac_dirfh.
+ */
+
+struct nfs_acentry
+{
+  uint32_t         ac_time;                   /* When the entry was filled (ticks) */
+  bool             ac_inuse;                  /* True: The entry is valid */
+  uint8_t          ac_dirfhsize;              /* Size of directory file handle */
+  uint8_t          ac_fhsize;                 /* Size of object file handle */
+  nfsfh_t          ac_dirfh;                  /* File handle of the directory */
+  nfsfh_t          ac_fh;                     /* File handle of the object */
+  struct nfs_fattr ac_fattr;                  /* Attributes of the object */
+  char             ac_name[NAME_MAX + 1];     /* Name of the object */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -82,7 +149,35 @@ struct nfsmount
   uint16_t         nm_rsize;                  /* Max size of read RPC */
   uint16_t         nm_wsize;                  /* Max size of write RPC */
   uint16_t         nm_readdirsize;            /* Size of a readdir RPC */
-  uint16_t         nm_buflen;                 /* Size of I/O buffer */
+  uint16_t         nm_buflen;                 /* Size of each I/O buffer */
+
+  /* State of the data buffers used by READ and WRITE RPCs.  The data for
+   * the file offset nm_coffset + n is in buffer n / nm_cchunk, at offset
+   * n % nm_cchunk from the start of the data in that buffer.
+   */
+
+  uint8_t          nm_cstate;                 /* What the buffers hold (NFS_CACHE_*) */
+  uint16_t         nm_cchunk;                 /* Bytes of file data per buffer */
+  uint32_t         nm_clen;                   /* Bytes of file data held */
+  uint64_t         nm_coffset;                /* File offset of the first byte */
+  FAR struct nfsnode *nm_cnode;               /* File that the data belongs to */
+
+#if CONFIG_NFS_MAXREQUESTS > 1
+  /* READ call messages and WRITE reply messages of the RPCs in flight.  A
+   * single RPC uses nm_msgbuffer instead.
+   */
+
+  struct rpc_slot  nm_slots[CONFIG_NFS_MAXREQUESTS];
+  union
+  {
+    struct rpc_call_read   read;
+    struct rpc_reply_write write;
+  } nm_rwmsg[CONFIG_NFS_MAXREQUESTS];
+#endif
+
+#ifdef CONFIG_NFS_ATTRCACHE
+  struct nfs_acentry nm_attrcache[CONFIG_NFS_ATTRCACHE_NENTRIES];
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.  NOTE
    * that for the case of the write call message, it is the reply message that
@@ -104,6 +199,7 @@ struct nfsmount
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fs;
+    struct rpc_call_commit  commit;
     struct rpc_reply_write  write;
   } nm_msgbuffer;
 
@@ -119,7 +215,8 @@ struct nfsmount
 };
 
 /* The size of the nfsmount structure will debug on the size of the allocated I/O
- * buffer.
+ * buffer.  nm_iobuffer is followed by the data buffers so n is
+ * NFS_NIOBUFFERS * nm_buflen.
  */
 
 #define SIZEOF_nfsmount(n) (sizeof(struct nfsmount) + ((n + 3) & ~3) - sizeof(uint32_t))
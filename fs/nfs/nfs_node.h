@@ -78,6 +78,10 @@ struct nfsnode
   time_t             n_ctime;       /* File creation time (see NOTE) */
   nfsfh_t            n_fhandle;     /* NFS File Handle */
   uint64_t           n_size;        /* Current size of file (see NOTE) */
+#ifdef CONFIG_NFS_READAHEAD
+  uint64_t           n_rdnext;      /* File offset following the last read */
+#endif
+  uint8_t            n_error;       /* Deferred write error (errno) */
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
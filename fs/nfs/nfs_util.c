@@ -131,6 +131,55 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
         }
     }
 }
+
+/****************************************************************************
+ * Name: nfs_checkreply
+ *
+ * Desciption:
+ *   Verify the NFS level of the values returned in an RPC reply.
+ *
+ * Return Value:
+ *   Zero on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_checkreply(FAR void *response)
+{
+  struct nfs_reply_header replyh;
+  int error;
+
+  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
+
+  if (replyh.nfs_status != 0)
+    {
+      if (fxdr_unsigned(uint32_t, replyh.nfs_status) > 32)
+        {
+          error = EOPNOTSUPP;
+        }
+      else
+        {
+          /* NFS_ERRORS are the same as NuttX errno values */
+
+          error = fxdr_unsigned(uint32_t, replyh.nfs_status);
+        }
+
+      return error;
+    }
+
+  if (replyh.rpc_verfi.authtype != 0)
+    {
+      error = fxdr_unsigned(int, replyh.rpc_verfi.authtype);
+      if (error != EAGAIN)
+        {
+          fdbg("ERROR: NFS error %d from server\n", error);
+        }
+
+      return error;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -212,7 +261,6 @@ int nfs_request(struct nfsmount *nmp, int procnum,
                 FAR void *response, size_t resplen)
 {
   struct rpcclnt *clnt = nmp->nm_rpcclnt;
-  struct nfs_reply_header replyh;
   int error;
 
 tryagain:
@@ -224,39 +272,73 @@ tryagain:
       return error;
     }
 
-  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
+  error = nfs_checkreply(response);
+  if (error == EAGAIN)
+    {
+      error = 0;
+      goto tryagain;
+    }
 
-  if (replyh.nfs_status != 0)
+  if (error == OK)
     {
-      if (fxdr_unsigned(uint32_t, replyh.nfs_status) > 32)
-        {
-          error = EOPNOTSUPP;
-        }
-      else
-        {
-          /* NFS_ERRORS are the same as NuttX errno values */
+      fvdbg("NFS_SUCCESS\n");
+    }
 
-          error = fxdr_unsigned(uint32_t, replyh.nfs_status);
-        }
+  return error;
+}
+
+/****************************************************************************
+ * Name: nfs_requestv
+ *
+ * Desciption:
+ *   Perform a batch of NFS requests of the same procedure with all of the
+ *   RPCs outstanding at the same time.  The NFS level status of each reply
+ *   is returned in rs_error of its slot.  Like nfs_request(), a call that
+ *   the server asks to be tried again (EAGAIN) is sent again.
+ *
+ * Return Value:
+ *   Zero if all replies were received; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_requestv(FAR struct nfsmount *nmp, int procnum,
+                 FAR struct rpc_slot *slots, int nslots)
+{
+  int error;
+  int i;
 
+  error = rpcclnt_requestv(nmp->nm_rpcclnt, procnum, NFS_PROG, NFS_VER3,
+                           slots, nslots);
+  if (error != 0)
+    {
+      fdbg("ERROR: rpcclnt_requestv failed: %d\n", error);
       return error;
     }
 
-  if (replyh.rpc_verfi.authtype != 0)
+  for (i = 0; i < nslots; i++)
     {
-      error = fxdr_unsigned(int, replyh.rpc_verfi.authtype);
-
-      if (error == EAGAIN)
+      while (slots[i].rs_error == OK)
         {
-          error = 0;
-          goto tryagain;
-        }
+          slots[i].rs_error = nfs_checkreply(slots[i].rs_response);
+          if (slots[i].rs_error != EAGAIN)
+            {
+              break;
+            }
 
-      fdbg("ERROR: NFS error %d from server\n", error);
-      return error;
+          /* Send this call again by itself.  The replies of the other
+           * calls are already in their own buffers and stay there.
+           */
+
+          error = rpcclnt_requestv(nmp->nm_rpcclnt, procnum, NFS_PROG,
+                                   NFS_VER3, &slots[i], 1);
+          if (error != 0)
+            {
+              fdbg("ERROR: rpcclnt_requestv failed: %d\n", error);
+              return error;
+            }
+        }
     }
 
-  fvdbg("NFS_SUCCESS\n");
   return OK;
 }
 
@@ -280,6 +362,9 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
                FAR struct nfs_fattr *dir_attributes)
 {
   FAR uint32_t *ptr;
+#ifdef CONFIG_NFS_ATTRCACHE
+  struct file_handle dirhandle;
+#endif
   uint32_t value;
   int reqlen;
   int namelen;
@@ -287,6 +372,21 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
 
   DEBUGASSERT(nmp && filename && fhandle);
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Use a recent result of the same LOOKUP, unless the caller also needs
+   * the directory attributes.
+   */
+
+  if (dir_attributes == NULL &&
+      nfs_attrcache_find(nmp, fhandle, filename, obj_attributes) == OK)
+    {
+      return OK;
+    }
+
+  dirhandle.length = fhandle->length;
+  memcpy(&dirhandle.handle, &fhandle->handle, fhandle->length);
+#endif
+
   /* Get the length of the string to be sent */
 
   namelen = strlen(filename);
@@ -365,6 +465,11 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
         {
           memcpy(obj_attributes, ptr, sizeof(struct nfs_fattr));
         }
+
+#ifdef CONFIG_NFS_ATTRCACHE
+      nfs_attrcache_add(nmp, &dirhandle, filename, &fhandle->handle,
+                        fhandle->length, (FAR struct nfs_fattr *)ptr);
+#endif
       ptr += uint32_increment(sizeof(struct nfs_fattr));
     }
 
@@ -103,6 +103,38 @@
 #  error "Length of cookie verify in fs_dirent_s is incorrect"
 #endif
 
+/* The amount of file data in one READ reply.  It is limited by the size of
+ * the I/O buffers.
+ */
+
+#define nfs_rdchunk(nmp) \
+  ((nmp)->nm_rsize < (nmp)->nm_buflen - SIZEOF_rpc_reply_read(0) ? \
+   (nmp)->nm_rsize : (nmp)->nm_buflen - SIZEOF_rpc_reply_read(0))
+
+/* The READ call message and the WRITE reply message of RPC i of a batch.
+ * A single RPC in flight uses nm_msgbuffer.
+ */
+
+#if CONFIG_NFS_MAXREQUESTS > 1
+#  define nfs_rdcallmsg(nmp,i)  (&(nmp)->nm_rwmsg[i].read)
+#  define nfs_wrreplymsg(nmp,i) (&(nmp)->nm_rwmsg[i].write)
+#else
+#  define nfs_rdcallmsg(nmp,i)  (&(nmp)->nm_msgbuffer.read)
+#  define nfs_wrreplymsg(nmp,i) (&(nmp)->nm_msgbuffer.write)
+#endif
+
+/* The offset of the data in a WRITE call message and the amount of data
+ * that fits in one.
+ */
+
+#define nfs_wrdataoffset(np) \
+  (sizeof(struct rpc_call_header) + 6 * sizeof(uint32_t) + \
+   uint32_alignup((np)->n_fhsize))
+
+#define nfs_wrchunk(nmp,np) \
+  ((nmp)->nm_wsize < (nmp)->nm_buflen - nfs_wrdataoffset(np) ? \
+   (nmp)->nm_wsize : (nmp)->nm_buflen - nfs_wrdataoffset(np))
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -119,10 +151,37 @@ struct nfsstats nfsstats;
  * Private Type Definitions
  ****************************************************************************/
 
+/* The outcome of a batch of WRITE RPCs */
+
+struct nfs_wrstate_s
+{
+  int      committed;                 /* Lowest commitment of the writes */
+  bool     verfvalid;                 /* True: verf has been set */
+  bool     verfchanged;               /* True: Not all verifiers were equal */
+  uint8_t  verf[NFSX_V3WRITEVERF];    /* Write verifier of the first reply */
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
+static FAR uint32_t *nfs_rdresult(FAR uint8_t *buffer);
+static int     nfs_readrpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                   uint64_t offset, uint32_t nbytes);
+static size_t  nfs_cacheread(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, uint64_t offset,
+                   FAR char *buffer, size_t buflen);
+static int     nfs_fmtwrite(FAR struct nfsnode *np, FAR uint8_t *buffer,
+                   uint64_t offset, uint32_t len, int stable);
+static int     nfs_wrreply(FAR struct nfsnode *np,
+                   FAR struct rpc_reply_write *reply, uint32_t len,
+                   FAR struct nfs_wrstate_s *state, FAR uint32_t *count);
+static int     nfs_writerpcs(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, int stable,
+                   FAR struct nfs_wrstate_s *state);
+static int     nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                   FAR uint8_t *verf);
+static void    nfs_flush(FAR struct nfsmount *nmp);
 static int     nfs_filecreate(FAR struct nfsmount *nmp, struct nfsnode *np,
                    FAR const char *relpath, mode_t mode);
 static int     nfs_filetruncate(FAR struct nfsmount *nmp, struct nfsnode *np);
@@ -134,6 +193,9 @@ static int     nfs_close(FAR struct file *filep);
 static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
                    size_t buflen);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_sync(FAR struct file *filep);
+#endif
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_opendir(struct inode *mountpt, const char *relpath,
                    struct fs_dirent_s *dir);
@@ -157,41 +219,714 @@ static int     nfs_stat(struct inode *mountpt, const char *relpath,
                    struct stat *buf);
 
 /****************************************************************************
- * Public Data
+ * Public Data
+ ****************************************************************************/
+/* nfs vfs operations. */
+
+const struct mountpt_operations nfs_operations =
+{
+  nfs_open,                     /* open */
+  nfs_close,                    /* close */
+  nfs_read,                     /* read */
+  nfs_write,                    /* write */
+  NULL,                         /* seek */
+  NULL,                         /* ioctl */
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+  nfs_sync,                     /* sync */
+#else
+  NULL,                         /* sync */
+#endif
+  nfs_dup,                      /* dup */
+
+  nfs_opendir,                  /* opendir */
+  NULL,                         /* closedir */
+  nfs_readdir,                  /* readdir */
+  nfs_rewinddir,                /* rewinddir */
+
+  nfs_bind,                     /* bind */
+  nfs_unbind,                   /* unbind */
+  nfs_statfs,                   /* statfs */
+
+  nfs_remove,                   /* unlink */
+  nfs_mkdir,                    /* mkdir */
+  nfs_rmdir,                    /* rmdir */
+  nfs_rename,                   /* rename */
+  nfs_stat                      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nfs_rdresult
+ *
+ * Description:
+ *   Skip over the attributes at the start of the READ reply in buffer.
+ *
+ * Returned Value:
+ *   A pointer to the count of data read.  This is followed by the EOF
+ *   indication, the length of the data and the data itself.
+ *
+ ****************************************************************************/
+
+static FAR uint32_t *nfs_rdresult(FAR uint8_t *buffer)
+{
+  FAR uint32_t *ptr;
+
+  ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)buffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  if (*ptr++ != 0)
+    {
+      /* Yes... just skip over the attributes for now */
+
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  return ptr;
+}
+
+/****************************************************************************
+ * Name: nfs_readrpcs
+ *
+ * Description:
+ *   Read nbytes of a file beginning at offset into the data buffers with
+ *   READ RPCs that are all in flight at the same time (one for each
+ *   buffer).  On success, the buffers hold nm_clen bytes of the file (zero
+ *   at the end of the file).  That stops short of the data requested if
+ *   the server returned less than was requested for one of the buffers.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_readrpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        uint64_t offset, uint32_t nbytes)
+{
+#if CONFIG_NFS_MAXREQUESTS > 1
+  FAR struct rpc_slot *slots = nmp->nm_slots;
+#else
+  struct rpc_slot      slots[1];
+#endif
+  FAR struct rpc_slot *slot;
+  FAR uint32_t        *ptr;
+  uint32_t             chunk;
+  uint32_t             count;
+  uint32_t             readsize;
+  uint32_t             eof;
+  size_t               reqlen;
+  int                  nbufs;
+  int                  error;
+  int                  i;
+
+  nmp->nm_cstate = NFS_CACHE_EMPTY;
+  chunk = nfs_rdchunk(nmp);
+  nbufs = (nbytes + chunk - 1) / chunk;
+
+  DEBUGASSERT(nbufs > 0 && nbufs <= CONFIG_NFS_MAXREQUESTS);
+
+  /* Format one READ call message for each buffer */
+
+  for (i = 0; i < nbufs; i++)
+    {
+      ptr     = (FAR uint32_t *)&nfs_rdcallmsg(nmp, i)->read;
+      reqlen  = 0;
+
+      /* Copy the variable length, file handle */
+
+      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+      reqlen += sizeof(uint32_t);
+
+      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+      reqlen += uint32_alignup(np->n_fhsize);
+      ptr    += uint32_increment(np->n_fhsize);
+
+      /* Copy the file offset and the read size */
+
+      txdr_hyper(offset + (uint64_t)i * chunk, ptr);
+      ptr    += 2;
+      reqlen += 2*sizeof(uint32_t);
+
+      count   = nbytes - i * chunk;
+      if (count > chunk)
+        {
+          count = chunk;
+        }
+
+      *ptr    = txdr_unsigned(count);
+      reqlen += sizeof(uint32_t);
+
+      slot              = &slots[i];
+      slot->rs_request  = nfs_rdcallmsg(nmp, i);
+      slot->rs_reqlen   = reqlen;
+      slot->rs_response = nfs_databuffer(nmp, i);
+      slot->rs_resplen  = nmp->nm_buflen;
+
+      nfs_statistics(NFSPROC_READ);
+    }
+
+  /* Perform the reads */
+
+  fvdbg("Reading %d bytes in %d RPCs\n", nbytes, nbufs);
+  error = nfs_requestv(nmp, NFSPROC_READ, slots, nbufs);
+  if (error)
+    {
+      fdbg("ERROR: nfs_requestv failed: %d\n", error);
+      return error;
+    }
+
+  /* Find the data in the replies.  Stop at the first reply that failed or
+   * that did not return a full piece.
+   */
+
+  nmp->nm_clen = 0;
+  for (i = 0; i < nbufs; i++)
+    {
+      error = slots[i].rs_error;
+      if (error != OK)
+        {
+          fdbg("ERROR: READ failed: %d\n", error);
+          break;
+        }
+
+      /* Skip the attributes and the count of data read */
+
+      ptr = nfs_rdresult(nfs_databuffer(nmp, i));
+      ptr++;
+      eof      = *ptr++;
+      readsize = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+      count = nbytes - i * chunk;
+      if (count > chunk)
+        {
+          count = chunk;
+        }
+
+      if (readsize > count)
+        {
+          fdbg("ERROR: Bad read size: %d\n", readsize);
+          error = EIO;
+          break;
+        }
+
+      nmp->nm_clen += readsize;
+
+      if (eof != 0 || readsize < count)
+        {
+          break;
+        }
+    }
+
+  /* Failures are only reported if no data was received before them.  A
+   * later read will request the rest again.
+   */
+
+  if (error != OK && i == 0)
+    {
+      return error;
+    }
+
+  nmp->nm_cstate  = NFS_CACHE_READ;
+  nmp->nm_cnode   = np;
+  nmp->nm_coffset = offset;
+  nmp->nm_cchunk  = chunk;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_cacheread
+ *
+ * Description:
+ *   Copy file data held in the data buffers (from an earlier READ) into the
+ *   user buffer.  Only the data of one buffer is copied.
+ *
+ * Returned Value:
+ *   The number of bytes copied.  Zero if the data at offset is not held.
+ *
+ ****************************************************************************/
+
+static size_t nfs_cacheread(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np, uint64_t offset,
+                            FAR char *buffer, size_t buflen)
+{
+  FAR uint8_t *data;
+  uint32_t relative;
+  uint32_t index;
+  uint32_t within;
+  size_t   nbytes;
+
+  if (nmp->nm_cstate != NFS_CACHE_READ || nmp->nm_cnode != np ||
+      offset < nmp->nm_coffset ||
+      offset >= nmp->nm_coffset + nmp->nm_clen)
+    {
+      return 0;
+    }
+
+  relative = offset - nmp->nm_coffset;
+  index    = relative / nmp->nm_cchunk;
+  within   = relative % nmp->nm_cchunk;
+
+  nbytes   = nmp->nm_cchunk - within;
+  if (nbytes > nmp->nm_clen - relative)
+    {
+      nbytes = nmp->nm_clen - relative;
+    }
+
+  if (nbytes > buflen)
+    {
+      nbytes = buflen;
+    }
+
+  /* The data follows the count, the EOF indication and the length */
+
+  data = (FAR uint8_t *)(nfs_rdresult(nfs_databuffer(nmp, index)) + 3);
+  memcpy(buffer, data + within, nbytes);
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: nfs_fmtwrite
+ *
+ * Description:
+ *   Format a WRITE call message in buffer.  The data to be written must
+ *   already be in the buffer at nfs_wrdataoffset().
+ *
+ * Returned Value:
+ *   The size of the call arguments.
+ *
+ ****************************************************************************/
+
+static int nfs_fmtwrite(FAR struct nfsnode *np, FAR uint8_t *buffer,
+                        uint64_t offset, uint32_t len, int stable)
+{
+  FAR uint32_t *ptr;
+  int           reqlen;
+
+  /* Here we need an offset pointer to the write arguments, skipping over
+   * the RPC header.
+   */
+
+  ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)buffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper(offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values and the length of the data */
+
+  *ptr++  = txdr_unsigned(len);
+  *ptr++  = txdr_unsigned(stable);
+  *ptr++  = txdr_unsigned(len);
+  reqlen += 3*sizeof(uint32_t);
+
+  DEBUGASSERT((FAR uint8_t *)ptr - buffer == nfs_wrdataoffset(np));
+  return reqlen + uint32_alignup(len);
+}
+
+/****************************************************************************
+ * Name: nfs_wrreply
+ *
+ * Description:
+ *   Parse the reply to a WRITE RPC of len bytes.  The number of bytes that
+ *   were written is returned in count.  The level of commitment and the
+ *   write verifier are accumulated in state.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_wrreply(FAR struct nfsnode *np,
+                       FAR struct rpc_reply_write *reply, uint32_t len,
+                       FAR struct nfs_wrstate_s *state, FAR uint32_t *count)
+{
+  FAR uint32_t *ptr;
+  uint64_t      size;
+  uint32_t      tmp;
+
+  ptr = (FAR uint32_t *)&reply->write;
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure.  Other
+       * writes of the same batch may not have been performed yet so the
+       * size must not get smaller.
+       */
+
+      size = np->n_size;
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      if (np->n_size < size)
+        {
+          np->n_size = size;
+        }
+
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Get the count of bytes actually written */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp < 1 || tmp > len)
+    {
+      return EIO;
+    }
+
+  *count = tmp;
+
+  /* Determine the lowest committment level obtained by any of the RPCs. */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp < state->committed)
+    {
+      state->committed = tmp;
+    }
+
+  /* All of the replies should carry the same write verifier */
+
+  if (!state->verfvalid)
+    {
+      memcpy(state->verf, ptr, NFSX_V3WRITEVERF);
+      state->verfvalid = true;
+    }
+  else if (memcmp(state->verf, ptr, NFSX_V3WRITEVERF) != 0)
+    {
+      state->verfchanged = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_writerpcs
+ *
+ * Description:
+ *   Write the data held in the data buffers (nm_clen bytes for file offset
+ *   nm_coffset) with WRITE RPCs that are all in flight at the same time.
+ *   If the server writes less than requested, the rest is written with
+ *   further RPCs from nm_iobuffer.  If the write verifier changes between
+ *   UNSTABLE writes, then the data is written again with FILE_SYNC.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_writerpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         int stable, FAR struct nfs_wrstate_s *state)
+{
+#if CONFIG_NFS_MAXREQUESTS > 1
+  FAR struct rpc_slot *slots = nmp->nm_slots;
+#else
+  struct rpc_slot      slots[1];
+#endif
+  FAR struct rpc_slot *slot;
+  FAR uint8_t         *buffer;
+  FAR uint8_t         *iobuffer = (FAR uint8_t *)nmp->nm_iobuffer;
+  uint64_t             offset;
+  uint32_t             dataoffset = nfs_wrdataoffset(np);
+  uint32_t             writesize;
+  uint32_t             count;
+  int                  nbufs;
+  int                  reqlen;
+  int                  error;
+  int                  i;
+
+  state->committed   = NFSV3WRITE_FILESYNC;
+  state->verfvalid   = false;
+  state->verfchanged = false;
+
+  nbufs = (nmp->nm_clen + nmp->nm_cchunk - 1) / nmp->nm_cchunk;
+  DEBUGASSERT(nbufs > 0 && nbufs <= CONFIG_NFS_MAXREQUESTS);
+
+  /* Format one WRITE call message for each buffer */
+
+  for (i = 0; i < nbufs; i++)
+    {
+      writesize = nmp->nm_clen - i * nmp->nm_cchunk;
+      if (writesize > nmp->nm_cchunk)
+        {
+          writesize = nmp->nm_cchunk;
+        }
+
+      buffer = nfs_databuffer(nmp, i);
+      offset = nmp->nm_coffset + (uint64_t)i * nmp->nm_cchunk;
+      reqlen = nfs_fmtwrite(np, buffer, offset, writesize, stable);
+
+      slot              = &slots[i];
+      slot->rs_request  = buffer;
+      slot->rs_reqlen   = reqlen;
+      slot->rs_response = nfs_wrreplymsg(nmp, i);
+      slot->rs_resplen  = sizeof(struct rpc_reply_write);
+
+      nfs_statistics(NFSPROC_WRITE);
+    }
+
+  /* Perform the writes */
+
+  error = nfs_requestv(nmp, NFSPROC_WRITE, slots, nbufs);
+  if (error)
+    {
+      fdbg("ERROR: nfs_requestv failed: %d\n", error);
+      return error;
+    }
+
+  for (i = 0; i < nbufs; i++)
+    {
+      writesize = nmp->nm_clen - i * nmp->nm_cchunk;
+      if (writesize > nmp->nm_cchunk)
+        {
+          writesize = nmp->nm_cchunk;
+        }
+
+      error = slots[i].rs_error;
+      if (error == OK)
+        {
+          error = nfs_wrreply(np, nfs_wrreplymsg(nmp, i), writesize,
+                              state, &count);
+        }
+
+      if (error != OK)
+        {
+          fdbg("ERROR: WRITE failed: %d\n", error);
+          return error;
+        }
+
+      /* If the server wrote less than requested, then write the rest.  The
+       * data is copied to nm_iobuffer so that the buffer is unchanged in
+       * case it has to be written again.  (If nm_iobuffer is the first data
+       * buffer, it is never written again because FILE_SYNC is used).
+       */
+
+      buffer = nfs_databuffer(nmp, i) + dataoffset;
+      offset = nmp->nm_coffset + (uint64_t)i * nmp->nm_cchunk;
+
+      while (count < writesize)
+        {
+          buffer    += count;
+          offset    += count;
+          writesize -= count;
+
+          memmove(iobuffer + dataoffset, buffer, writesize);
+          buffer = iobuffer + dataoffset;
+
+          reqlen = nfs_fmtwrite(np, iobuffer, offset, writesize, stable);
+
+          nfs_statistics(NFSPROC_WRITE);
+          error = nfs_request(nmp, NFSPROC_WRITE,
+                              (FAR void *)iobuffer, reqlen,
+                              (FAR void *)&nmp->nm_msgbuffer.write,
+                              sizeof(struct rpc_reply_write));
+          if (error == OK)
+            {
+              error = nfs_wrreply(np, &nmp->nm_msgbuffer.write, writesize,
+                                  state, &count);
+            }
+
+          if (error != OK)
+            {
+              fdbg("ERROR: WRITE failed: %d\n", error);
+              return error;
+            }
+        }
+    }
+
+  /* The cached attributes of the file are no longer valid */
+
+  nfs_attrcache_invalidate(nmp, &np->n_fhandle, np->n_fhsize);
+
+  /* If the server restarted between the writes, it may have lost some
+   * of the data.  Write all of it again, synchronously.
+   */
+
+  if (state->verfchanged && stable != NFSV3WRITE_FILESYNC)
+    {
+      fdbg("Write verifier changed, writing again\n");
+      return nfs_writerpcs(nmp, np, NFSV3WRITE_FILESYNC, state);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_commit
+ *
+ * Description:
+ *   Commit the data written to the range of the file held in the data
+ *   buffers to stable storage.  The write verifier of the server is
+ *   returned in verf.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                      FAR uint8_t *verf)
+{
+  FAR uint32_t *ptr;
+  uint64_t      size;
+  int           reqlen;
+  int           error;
+
+  /* Create the COMMIT RPC call arguments */
+
+  ptr    = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  reqlen = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset and the count */
+
+  txdr_hyper(nmp->nm_coffset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  *ptr    = txdr_unsigned(nmp->nm_clen);
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the COMMIT RPC */
+
+  nfs_statistics(NFSPROC_COMMIT);
+  error = nfs_request(nmp, NFSPROC_COMMIT,
+                      (FAR void *)&nmp->nm_msgbuffer.commit, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (error != OK)
+    {
+      fdbg("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  /* Skip over file_wcc, updating the file attributes, and return the
+   * verifier.
+   */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_commit *)nmp->nm_iobuffer)->commit;
+
+  if (*ptr++ != 0)
+    {
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  if (*ptr++ != 0)
+    {
+      size = np->n_size;
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      if (np->n_size < size)
+        {
+          np->n_size = size;
+        }
+
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  memcpy(verf, ptr, NFSX_V3WRITEVERF);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_flush
+ *
+ * Description:
+ *   Write the data collected in the data buffers by nfs_write() to the
+ *   server.  Afterward, the buffers are empty.
+ *
+ *   A failure is recorded in n_error of the file that the data belongs to.
+ *   It is reported by the next write(), fsync() or close() of the file.
+ *
  ****************************************************************************/
-/* nfs vfs operations. */
 
-const struct mountpt_operations nfs_operations =
+static void nfs_flush(FAR struct nfsmount *nmp)
 {
-  nfs_open,                     /* open */
-  nfs_close,                    /* close */
-  nfs_read,                     /* read */
-  nfs_write,                    /* write */
-  NULL,                         /* seek */
-  NULL,                         /* ioctl */
+  FAR struct nfsnode  *np = nmp->nm_cnode;
+  struct nfs_wrstate_s state;
+  uint8_t              verf[NFSX_V3WRITEVERF];
+  int                  stable;
+  int                  error;
 
-  NULL,                         /* sync */
-  nfs_dup,                      /* dup */
+  if (nmp->nm_cstate != NFS_CACHE_WRITE)
+    {
+      return;
+    }
 
-  nfs_opendir,                  /* opendir */
-  NULL,                         /* closedir */
-  nfs_readdir,                  /* readdir */
-  nfs_rewinddir,                /* rewinddir */
+  nmp->nm_cstate = NFS_CACHE_EMPTY;
+  if (nmp->nm_clen == 0)
+    {
+      return;
+    }
 
-  nfs_bind,                     /* bind */
-  nfs_unbind,                   /* unbind */
-  nfs_statfs,                   /* statfs */
+  /* Data held back (write-behind) in several buffers is written UNSTABLE
+   * and then committed together; if the server restarted before the
+   * COMMIT, the data is written again.  Otherwise, the data is simply
+   * written synchronously.
+   */
 
-  nfs_remove,                   /* unlink */
-  nfs_mkdir,                    /* mkdir */
-  nfs_rmdir,                    /* rmdir */
-  nfs_rename,                   /* rename */
-  nfs_stat                      /* stat */
-};
+  stable = NFSV3WRITE_FILESYNC;
+#ifdef CONFIG_NFS_WRITEBEHIND
+  if (nmp->nm_clen > nmp->nm_cchunk)
+    {
+      stable = NFSV3WRITE_UNSTABLE;
+    }
+#endif
 
-/****************************************************************************
- * Private Functions
- ****************************************************************************/
+  error = nfs_writerpcs(nmp, np, stable, &state);
+  if (error == OK && state.committed != NFSV3WRITE_FILESYNC)
+    {
+      error = nfs_commit(nmp, np, verf);
+      if (error == OK && memcmp(verf, state.verf, NFSX_V3WRITEVERF) != 0)
+        {
+          fdbg("Write verifier changed, writing again\n");
+          error = nfs_writerpcs(nmp, np, NFSV3WRITE_FILESYNC, &state);
+        }
+    }
+
+  if (error != OK)
+    {
+      fdbg("ERROR: Write-behind failed: %d\n", error);
+      np->n_error = error;
+    }
+}
 
 /****************************************************************************
  * Public Functions
@@ -362,7 +1097,7 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, struct nfsnode *np,
 
       /* Save the attributes in the file data structure */
 
-      tmp = *ptr;  /* handle_follows */
+      tmp = *ptr++;  /* attributes_follow */
       if (!tmp)
         {
           fdbg("WARNING: no file attributes\n");
@@ -372,6 +1107,13 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, struct nfsnode *np,
           /* Initialize the file attributes */
 
           nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+
+#ifdef CONFIG_NFS_ATTRCACHE
+          /* The next lookup of the new file does not need an RPC */
+
+          nfs_attrcache_add(nmp, &fhandle, filename, &np->n_fhandle,
+                            np->n_fhsize, (FAR struct nfs_fattr *)ptr);
+#endif
         }
 
       /* Any following dir_wcc data is ignored for now */
@@ -442,6 +1184,7 @@ static int nfs_filetruncate(FAR struct nfsmount *nmp, struct nfsnode *np)
   /* Indicate that the file now has zero length */
 
   np->n_size = 0;
+  nfs_attrcache_invalidate(nmp, &np->n_fhandle, np->n_fhsize);
   return OK;
 }
 
@@ -589,6 +1332,12 @@ static int nfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
+  /* Data held back for another open of the file must reach the server
+   * before the size of the file is obtained (or the file is truncated).
+   */
+
+  nfs_flush(nmp);
+
   /* Try to open an existing file at that path */
 
   error = nfs_fileopen(nmp, np, relpath, oflags, mode);
@@ -718,6 +1467,17 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+      /* Send any data of the file that is held back in the data buffers.
+       * The buffers must not refer to the file structure afterward.
+       */
+
+      if (nmp->nm_cnode == np)
+        {
+          nfs_flush(nmp);
+          nmp->nm_cstate = NFS_CACHE_EMPTY;
+          nmp->nm_cnode  = NULL;
+        }
+
       /* Assume file structure will not be found.  This should never happen. */
 
       ret = -EINVAL;
@@ -745,10 +1505,12 @@ static int nfs_close(FAR struct file *filep)
                   nmp->nm_head = np->n_next;
                 }
 
-              /* Then deallocate the file structure and return success */
+              /* Then deallocate the file structure and return success (or
+               * the failure of an earlier write).
+               */
 
+              ret = -np->n_error;
               kmm_free(np);
-              ret = OK;
               break;
             }
         }
@@ -762,6 +1524,13 @@ static int nfs_close(FAR struct file *filep)
 /****************************************************************************
  * Name: nfs_read
  *
+ * Description:
+ *   Read from a file.  Several READ RPCs are in flight at the same time
+ *   when more than one buffer of data is requested.  With
+ *   CONFIG_NFS_READAHEAD, sequential reads request the following data of
+ *   the file as well and it is retained in the data buffers for the next
+ *   read.
+ *
  * Returned Value:
  *   The (non-negative) number of bytes read on success; a negated errno
  *   value on failure.
@@ -772,11 +1541,9 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 {
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
-  ssize_t                    readsize;
-  ssize_t                    tmp;
   ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  uint64_t                   remaining;
+  size_t                     nbytes;
   int                        error = 0;
 
   fvdbg("Read %d bytes from offset %d\n", buflen, filep->f_pos);
@@ -802,14 +1569,23 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
       goto errout_with_semaphore;
     }
 
+  /* Data written to the data buffers must be sent before they are reused
+   * (and before it can be read back).
+   */
+
+  nfs_flush(nmp);
+
   /* Get the number of bytes left in the file and truncate read count so that
    * it does not exceed the number of bytes left in the file.
    */
 
-  tmp = np->n_size - filep->f_pos;
-  if (buflen > tmp)
+  if ((uint64_t)filep->f_pos >= np->n_size)
     {
-      buflen = tmp;
+      buflen = 0;
+    }
+  else if (buflen > np->n_size - filep->f_pos)
+    {
+      buflen = np->n_size - filep->f_pos;
       fvdbg("Read size truncated to %d\n", buflen);
     }
 
@@ -817,111 +1593,64 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 
   for (bytesread = 0; bytesread < buflen; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC maximum */
-
-      readsize = buflen;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
+      /* Take what we can from the data read earlier */
 
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
-
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
+      nbytes = nfs_cacheread(nmp, np, filep->f_pos, buffer,
+                             buflen - bytesread);
+      if (nbytes == 0)
         {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t*)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
+          /* Request the rest of the data at once (up to the number of
+           * RPCs that may be in flight).
+           */
 
-      /* Perform the read */
+          remaining = buflen - bytesread;
 
-      fvdbg("Reading %d bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      error = nfs_request(nmp, NFSPROC_READ,
-                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
-                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
-      if (error)
-        {
-          fdbg("ERROR: nfs_request failed: %d\n", error);
-          goto errout_with_semaphore;
-        }
+#ifdef CONFIG_NFS_READAHEAD
+          /* If this read continues the last one, then the file is probably
+           * being read sequentially.  Request data up to the end of the
+           * file.
+           */
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
+          if ((uint64_t)filep->f_pos == np->n_rdnext)
+            {
+              remaining = np->n_size - filep->f_pos;
+            }
+#endif
 
-      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+          if (remaining > CONFIG_NFS_MAXREQUESTS * nfs_rdchunk(nmp))
+            {
+              remaining = CONFIG_NFS_MAXREQUESTS * nfs_rdchunk(nmp);
+            }
 
-      /* Check if attributes are included in the responses */
+          error = nfs_readrpcs(nmp, np, filep->f_pos, remaining);
+          if (error != OK)
+            {
+              goto errout_with_semaphore;
+            }
 
-      tmp = *ptr++;
-      if (*ptr != 0)
-        {
-          /* Yes... just skip over the attributes for now */
+          nbytes = nfs_cacheread(nmp, np, filep->f_pos, buffer,
+                                 buflen - bytesread);
+          if (nbytes == 0)
+            {
+              /* We hit the end of the file */
 
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+              break;
+            }
         }
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
-
       /* Update the read state data */
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
-
-      /* Check if we hit the end of file */
-
-      if (tmp != 0)
-        {
-          break;
-        }
+      filep->f_pos += nbytes;
+      bytesread    += nbytes;
+      buffer       += nbytes;
     }
 
+#ifdef CONFIG_NFS_READAHEAD
+  np->n_rdnext = filep->f_pos;
+#else
+  nmp->nm_cstate = NFS_CACHE_EMPTY;
+#endif
+
   fvdbg("Read %d bytes\n", bytesread);
   nfs_semgive(nmp);
   return bytesread;
@@ -934,6 +1663,12 @@ errout_with_semaphore:
 /****************************************************************************
  * Name: nfs_write
  *
+ * Description:
+ *   Write to a file.  The data is collected in the data buffers and then
+ *   sent with WRITE RPCs that are all in flight at the same time.  With
+ *   CONFIG_NFS_WRITEBEHIND, the data of sequential writes is held back
+ *   until the buffers are full or until the file is closed or synced.
+ *
  * Returned Value:
  *   The (non-negative) number of bytes written on success; a negated errno
  *   value on failure.
@@ -945,14 +1680,11 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
 {
   struct nfsmount       *nmp;
   struct nfsnode        *np;
-  ssize_t                writesize;
-  ssize_t                bufsize;
   ssize_t                byteswritten;
-  size_t                 reqlen;
-  FAR uint32_t          *ptr;
-  uint32_t               tmp;
-  int                    commit = 0;
-  int                    committed = NFSV3WRITE_FILESYNC;
+  uint32_t               dataoffset;
+  uint32_t               index;
+  uint32_t               within;
+  size_t                 nbytes;
   int                    error;
 
   fvdbg("Write %d bytes to offset %d\n", buflen, filep->f_pos);
@@ -986,140 +1718,145 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
-  /* Now loop until we send the entire user buffer */
+  /* Data held back for another file or for another part of this file must
+   * be sent first.  Data read into the buffers is simply discarded.
+   */
 
-  writesize = 0;
-  for (byteswritten = 0; byteswritten < buflen; )
+  if (nmp->nm_cstate == NFS_CACHE_WRITE &&
+      (nmp->nm_cnode != np ||
+       nmp->nm_coffset + nmp->nm_clen != (uint64_t)filep->f_pos))
+    {
+      nfs_flush(nmp);
+    }
+  else if (nmp->nm_cstate == NFS_CACHE_READ)
     {
-      /* Make sure that the attempted write size does not exceed the RPC maximum */
+      nmp->nm_cstate = NFS_CACHE_EMPTY;
+    }
 
-      writesize = buflen;
-      if (writesize > nmp->nm_wsize)
-        {
-          writesize = nmp->nm_wsize;
-        }
+  /* Report the failure of an earlier write */
+
+  if (np->n_error != 0)
+    {
+      error = np->n_error;
+      np->n_error = 0;
+      goto errout_with_semaphore;
+    }
 
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
+  /* Now loop until the entire user buffer is in the data buffers */
 
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
+  dataoffset = nfs_wrdataoffset(np);
+  for (byteswritten = 0; byteswritten < buflen; )
+    {
+      if (nmp->nm_cstate != NFS_CACHE_WRITE)
         {
-          writesize -= (bufsize - nmp->nm_buflen);
+          nmp->nm_cstate  = NFS_CACHE_WRITE;
+          nmp->nm_cnode   = np;
+          nmp->nm_coffset = filep->f_pos;
+          nmp->nm_cchunk  = nfs_wrchunk(nmp, np);
+          nmp->nm_clen    = 0;
         }
 
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
-
-      *ptr++  = txdr_unsigned(buflen);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy a chunk of the user data into the I/O buffer */
-
-      *ptr++  = txdr_unsigned(buflen);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
+      /* Copy as much of the user data as fits into the current buffer */
 
-      /* Perform the write */
+      index  = nmp->nm_clen / nmp->nm_cchunk;
+      within = nmp->nm_clen % nmp->nm_cchunk;
 
-      nfs_statistics(NFSPROC_WRITE);
-      error = nfs_request(nmp, NFSPROC_WRITE,
-                          (FAR void *)nmp->nm_iobuffer, reqlen,
-                          (FAR void *)&nmp->nm_msgbuffer.write, sizeof(struct rpc_reply_write));
-      if (error)
+      nbytes = nmp->nm_cchunk - within;
+      if (nbytes > buflen - byteswritten)
         {
-          fdbg("ERROR: nfs_request failed: %d\n", error);
-          goto errout_with_semaphore;
+          nbytes = buflen - byteswritten;
         }
 
-      /* Get a pointer to the WRITE reply data */
+      memcpy(nfs_databuffer(nmp, index) + dataoffset + within, buffer,
+             nbytes);
 
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+      nmp->nm_clen += nbytes;
+      filep->f_pos += nbytes;
+      byteswritten += nbytes;
+      buffer       += nbytes;
 
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
+      /* Send the data when all of the buffers are full */
 
-      tmp = *ptr++;
-      if (tmp != 0)
+      if (nmp->nm_clen >= CONFIG_NFS_MAXREQUESTS * nmp->nm_cchunk)
         {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
-
-          ptr += uint32_increment(sizeof(struct wcc_attr));
+          nfs_flush(nmp);
+          if (np->n_error != 0)
+            {
+              error = np->n_error;
+              np->n_error = 0;
+              goto errout_with_semaphore;
+            }
         }
+    }
 
-      /* Check if normal file attributes follow */
+#ifndef CONFIG_NFS_WRITEBEHIND
+  /* Send the rest of the data now */
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+  nfs_flush(nmp);
+  if (np->n_error != 0)
+    {
+      error = np->n_error;
+      np->n_error = 0;
+      goto errout_with_semaphore;
+    }
+#endif
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+  if ((uint64_t)filep->f_pos > np->n_size)
+    {
+      np->n_size = filep->f_pos;
+    }
 
-      /* Get the count of bytes actually written */
+  nfs_semgive(nmp);
+  return byteswritten;
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+errout_with_semaphore:
+  nfs_semgive(nmp);
+  return -error;
+}
 
-      if (tmp < 1 || tmp > writesize)
-        {
-           error = EIO;
-           goto errout_with_semaphore;
-        }
+#ifdef CONFIG_NFS_WRITEBEHIND
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Send any data of the file that is held back in the data buffers to the
+ *   server and report the failure of an earlier write.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_sync(FAR struct file *filep)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int                  error;
 
-      writesize = tmp;
+  /* Sanity checks */
 
-      /* Determine the lowest committment level obtained by any of the RPCs. */
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+  /* Recover our private data from the struct file instance */
 
-      /* Update the read state data */
+  nmp = (struct nfsmount*)filep->f_inode->i_private;
+  np  = (struct nfsnode*)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  nfs_semtake(nmp);
+  if (nmp->nm_cnode == np)
+    {
+      nfs_flush(nmp);
     }
 
-  nfs_semgive(nmp);
-  return writesize;
+  error       = np->n_error;
+  np->n_error = 0;
 
-errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
 }
+#endif
 
 /****************************************************************************
  * Name: binfs_dup
@@ -1728,9 +2465,14 @@ static int nfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       buflen = MIN_IPv4_UDP_MSS;
     }
 
+  /* The data buffers follow nm_iobuffer and must be aligned like it */
+
+  buflen &= ~3;
+
   /* Create an instance of the mountpt state structure */
 
-  nmp = (FAR struct nfsmount *)kmm_zalloc(SIZEOF_nfsmount(buflen));
+  nmp = (FAR struct nfsmount *)
+    kmm_zalloc(SIZEOF_nfsmount(buflen * NFS_NIOBUFFERS));
   if (!nmp)
     {
       fdbg("ERROR: Failed to allocate mountpoint structure\n");
@@ -2175,6 +2917,8 @@ static int nfs_remove(struct inode *mountpt, const char *relpath)
                       (FAR void *)&nmp->nm_msgbuffer.removef, reqlen,
                       (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
 
+  nfs_attrcache_remove(nmp, &fhandle, filename);
+
 errout_with_semaphore:
    nfs_semgive(nmp);
    return -error;
@@ -2387,6 +3131,8 @@ static int nfs_rmdir(struct inode *mountpt, const char *relpath)
                           (FAR void *)&nmp->nm_msgbuffer.rmdir, reqlen,
                           (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
 
+  nfs_attrcache_remove(nmp, &fhandle, dirname);
+
 errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
@@ -2504,6 +3250,9 @@ static int nfs_rename(struct inode *mountpt, const char *oldrelpath,
                       (FAR void *)&nmp->nm_msgbuffer.renamef, reqlen,
                       (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
 
+  nfs_attrcache_remove(nmp, &from_handle, from_name);
+  nfs_attrcache_remove(nmp, &to_handle, to_name);
+
 errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
@@ -2549,6 +3298,10 @@ static int nfs_stat(struct inode *mountpt, const char *relpath,
       goto errout_with_semaphore;
     }
 
+  /* Data held back in the data buffers would change the size of a file */
+
+  nfs_flush(nmp);
+
   /* Get the file handle attributes of the requested node */
 
   error = nfs_findnode(nmp, relpath, &fhandle, &obj_attributes, NULL);
@@ -289,6 +289,12 @@ struct rpc_call_write
 };
 #define SIZEOF_rpc_call_write(n) (sizeof(struct rpc_call_header) + SIZEOF_WRITE3args(n))
 
+struct rpc_call_commit
+{
+  struct rpc_call_header ch;
+  struct COMMIT3args commit;
+};
+
 struct rpc_call_remove
 {
   struct rpc_call_header ch;
@@ -398,6 +404,13 @@ struct rpc_reply_read
 };
 #define SIZEOF_rpc_reply_read(n) (sizeof(struct rpc_reply_header) + sizeof(uint32_t) + SIZEOF_READ3resok(n))
 
+struct rpc_reply_commit
+{
+  struct rpc_reply_header rh;
+  uint32_t status;
+  struct COMMIT3resok commit;
+};
+
 struct rpc_reply_remove
 {
   struct rpc_reply_header rh;
@@ -474,6 +487,22 @@ struct  rpcclnt
   uint8_t  rc_retry;          /* Max retries */
 };
 
+/* Describes one of a batch of CALL messages that are sent together by
+ * rpcclnt_requestv().  The replies may arrive in any order; they are
+ * matched to the calls by their transaction IDs.
+ */
+
+struct rpc_slot
+{
+  FAR void *rs_request;       /* CALL message (with space for the header) */
+  FAR void *rs_response;      /* Receives the REPLY message */
+  size_t    rs_reqlen;        /* Size of the call arguments */
+  size_t    rs_resplen;       /* Size of the response buffer */
+  uint32_t  rs_xid;           /* Transaction ID (network order) */
+  int       rs_error;         /* RPC status of the reply (positive errno) */
+  bool      rs_done;          /* True: The reply has been received */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -487,5 +516,7 @@ void rpcclnt_safedisconnect(FAR struct rpcclnt *rpc);
 int  rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog, int version,
                      FAR void *request, size_t reqlen,
                      FAR void *response, size_t resplen);
+int  rpcclnt_requestv(FAR struct rpcclnt *rpc, int procnum, int prog,
+                      int version, FAR struct rpc_slot *slots, int nslots);
 
 #endif /* __FS_NFS_RPC_H */
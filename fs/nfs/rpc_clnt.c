@@ -140,9 +140,9 @@ static struct rpcstats rpcstats;
 static int rpcclnt_send(FAR struct rpcclnt *rpc, int procid, int prog,
                         FAR void *call, int reqlen);
 static int rpcclnt_receive(FAR struct rpcclnt *rpc, struct sockaddr *aname,
-                           int proc, int program, void *reply, size_t resplen);
-static int rpcclnt_reply(FAR struct rpcclnt *rpc, int procid, int prog,
-                         void *reply, size_t resplen);
+                           FAR void *reply, size_t resplen,
+                           FAR size_t *rcvlen);
+static int rpcclnt_checkreply(FAR void *reply);
 static uint32_t rpcclnt_newxid(void);
 static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
                               uint32_t xid, int procid, int prog, int vers);
@@ -192,13 +192,14 @@ static int rpcclnt_send(FAR struct rpcclnt *rpc, int procid, int prog,
  *
  * Description:
  *   Receive a Sun RPC Request/Reply. For SOCK_DGRAM, the work is all done
- *   by psock_recvfrom().
+ *   by psock_recvfrom().  The size of the received message is returned in
+ *   rcvlen.
  *
  ****************************************************************************/
 
 static int rpcclnt_receive(FAR struct rpcclnt *rpc, FAR struct sockaddr *aname,
-                           int proc, int program, FAR void *reply,
-                           size_t resplen)
+                           FAR void *reply, size_t resplen,
+                           FAR size_t *rcvlen)
 {
   ssize_t nbytes;
   int error = 0;
@@ -210,56 +211,71 @@ static int rpcclnt_receive(FAR struct rpcclnt *rpc, FAR struct sockaddr *aname,
       error = get_errno();
       fdbg("ERROR: psock_recvfrom failed: %d\n", error);
     }
+  else
+    {
+      *rcvlen = nbytes;
+    }
 
   return error;
 }
 
 /****************************************************************************
- * Name: rpcclnt_reply
+ * Name: rpcclnt_checkreply
  *
  * Description:
- *   Received the RPC reply on the socket.
+ *   Break down the RPC header of a received reply and check if it is OK.
+ *   (There may still be be NFS layer errors that will be detected by the
+ *   calling logic).
  *
  ****************************************************************************/
 
-static int rpcclnt_reply(FAR struct rpcclnt *rpc, int procid, int prog,
-                         FAR void *reply, size_t resplen)
+static int rpcclnt_checkreply(FAR void *reply)
 {
-  int error;
+  FAR struct rpc_reply_header *replymsg;
+  uint32_t tmp;
 
-  /* Get the next RPC reply from the socket */
+  replymsg = (FAR struct rpc_reply_header *)reply;
 
-  error = rpcclnt_receive(rpc, rpc->rc_name, procid, prog, reply, resplen);
-  if (error != 0)
+  tmp = fxdr_unsigned(uint32_t, replymsg->type);
+  if (tmp == RPC_MSGDENIED)
     {
-      fdbg("ERROR: rpcclnt_receive returned: %d\n", error);
-
-      /* If we failed because of a timeout, then try sending the CALL
-       * message again.
-       */
-
-      if (error == EAGAIN || error == ETIMEDOUT)
+      tmp = fxdr_unsigned(uint32_t, replymsg->status);
+      switch (tmp)
         {
-          rpc->rc_timeout = true;
-       }
-    }
+        case RPC_MISMATCH:
+          fdbg("RPC_MSGDENIED: RPC_MISMATCH error\n");
+          return EOPNOTSUPP;
 
-  /* Get the xid and check that it is an RPC replysvr */
+        case RPC_AUTHERR:
+          fdbg("RPC_MSGDENIED: RPC_AUTHERR error\n");
+          return EACCES;
 
-  else
+        default:
+          return EOPNOTSUPP;
+        }
+    }
+  else if (tmp != RPC_MSGACCEPTED)
     {
-      FAR struct rpc_reply_header *replyheader =
-        (FAR struct rpc_reply_header *)reply;
+      return EOPNOTSUPP;
+    }
 
-      if (replyheader->rp_direction != rpc_reply)
-        {
-          fdbg("ERROR: Different RPC REPLY returned\n");
-          rpc_statistics(rpcinvalid);
-          error = EPROTO;
-        }
+  tmp = fxdr_unsigned(uint32_t, replymsg->status);
+  if (tmp == RPC_SUCCESS)
+    {
+      fvdbg("RPC_SUCCESS\n");
+    }
+  else if (tmp == RPC_PROGMISMATCH)
+    {
+      fdbg("RPC_MSGACCEPTED: RPC_PROGMISMATCH error\n");
+      return EOPNOTSUPP;
+    }
+  else if (tmp > 5)
+    {
+      fdbg("ERROR:  Other RPC type: %d\n", tmp);
+      return EOPNOTSUPP;
     }
 
-  return error;
+  return OK;
 }
 
 /****************************************************************************
@@ -275,9 +291,9 @@ static uint32_t rpcclnt_newxid(void)
   static uint32_t rpcclnt_xid = 0;
   static uint32_t rpcclnt_xid_touched = 0;
 
-  srand(time(NULL));
   if ((rpcclnt_xid == 0) && (rpcclnt_xid_touched == 0))
     {
+      srand(time(NULL));
       rpcclnt_xid = rand();
       rpcclnt_xid_touched = 1;
     }
@@ -682,9 +698,9 @@ bad:
  *
  * Description:
  *   Perform the RPC request.  Logic formats the RPC CALL message and calls
- *   rpcclnt_send to send the RPC CALL message.  It then calls rpcclnt_reply()
- *   to get the response.  It may attempt to re-send the CALL message on
- *   certain errors.
+ *   rpcclnt_send to send the RPC CALL message.  It then waits for the
+ *   reply with the matching transaction ID.  It may attempt to re-send the
+ *   CALL message on certain errors.
  *
  *   On successful receipt, it verifies the RPC level of the returned values.
  *   (There may still be be NFS layer errors that will be deted by calling
@@ -696,110 +712,187 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                     int version, FAR void *request, size_t reqlen,
                     FAR void *response, size_t resplen)
 {
-  struct rpc_reply_header *replymsg;
-  uint32_t tmp;
+  struct rpc_slot slot;
+  int error;
+
+  slot.rs_request  = request;
+  slot.rs_reqlen   = reqlen;
+  slot.rs_response = response;
+  slot.rs_resplen  = resplen;
+
+  error = rpcclnt_requestv(rpc, procnum, prog, version, &slot, 1);
+  if (error == OK)
+    {
+      error = slot.rs_error;
+    }
+
+  return error;
+}
+
+/****************************************************************************
+ * Name: rpcclnt_requestv
+ *
+ * Description:
+ *   Perform a batch of RPC requests of the same procedure.  All of the CALL
+ *   messages are sent before waiting for any reply so that the server can
+ *   work on them at the same time.  Each reply is matched to its call by
+ *   the transaction ID; replies that do not belong to any of the calls
+ *   (such as late replies to earlier, re-sent calls) are discarded.  If no
+ *   reply arrives before the receive timeout, then the calls that are
+ *   still outstanding are sent again with the same transaction IDs.
+ *
+ *   Replies are received in the response buffer of the first outstanding
+ *   call and copied if they belong to a different call.  So each response
+ *   buffer should be large enough to hold any of the replies.
+ *
+ *   The RPC status of each reply is returned in rs_error of its slot.
+ *
+ * Returned Value:
+ *   Zero if a reply was received for every call; a positive errno value if
+ *   the calls could not be sent or the replies timed out.
+ *
+ ****************************************************************************/
+
+int rpcclnt_requestv(FAR struct rpcclnt *rpc, int procnum, int prog,
+                     int version, FAR struct rpc_slot *slots, int nslots)
+{
+  FAR struct rpc_reply_header *replymsg;
+  FAR struct rpc_slot *first;
+  FAR struct rpc_slot *slot;
+  size_t rcvlen;
   uint32_t xid;
+  int npending;
   int retries;
   int error = 0;
+  int i;
 
-  /* Get a new (non-zero) xid */
+  /* Format the RPC CALL messages.  Each gets a new (non-zero) xid */
 
-  xid = rpcclnt_newxid();
-
-  /* Initialize the RPC header fields */
+  for (i = 0; i < nslots; i++)
+    {
+      slot = &slots[i];
+      xid  = rpcclnt_newxid();
 
-  rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
-                    xid, prog, version, procnum);
+      rpcclnt_fmtheader((FAR struct rpc_call_header *)slot->rs_request,
+                        xid, prog, version, procnum);
 
-  /* Get the full size of the message (the size of variable data plus the size of
-   * the messages header).
-   */
-
-  reqlen += sizeof(struct rpc_call_header);
+      slot->rs_xid   = txdr_unsigned(xid);
+      slot->rs_error = 0;
+      slot->rs_done  = false;
+    }
 
-  /* Send the RPC call messsages and receive the RPC response.  A limited
+  /* Send the RPC CALL messsages and receive the RPC responses.  A limited
    * number of re-tries will be attempted, but only for the case of response
    * timeouts.
    */
 
-  retries = 0;
-  do
+  npending = nslots;
+  retries  = 0;
+  rpc->rc_timeout = true;
+
+  while (npending > 0)
     {
-      /* Do the client side RPC. */
+      if (rpc->rc_timeout)
+        {
+          /* (Re-)send every CALL message that is still waiting for a
+           * reply.
+           */
+
+          rpc->rc_timeout = false;
+          for (i = 0; i < nslots; i++)
+            {
+              slot = &slots[i];
+              if (slot->rs_done)
+                {
+                  continue;
+                }
+
+              rpc_statistics(rpcrequests);
+              error = rpcclnt_send(rpc, procnum, prog, slot->rs_request,
+                                   slot->rs_reqlen +
+                                   sizeof(struct rpc_call_header));
+              if (error != OK)
+                {
+                  fdbg("ERROR: rpcclnt_send failed: %d\n", error);
+                  return error;
+                }
+            }
+        }
 
-      rpc_statistics(rpcrequests);
-      rpc->rc_timeout = false;
+      /* Receive the next reply into the buffer of the first call that is
+       * still outstanding.  Replies usually arrive in order so that is
+       * where it belongs.
+       */
 
-      /* Send the RPC CALL message */
+      for (first = slots; first->rs_done; first++);
 
-      error = rpcclnt_send(rpc, procnum, prog, request, reqlen);
+      error = rpcclnt_receive(rpc, rpc->rc_name, first->rs_response,
+                              first->rs_resplen, &rcvlen);
       if (error != OK)
         {
-          fvdbg("ERROR rpcclnt_send failed: %d\n", error);
-        }
+          /* If we failed because of a timeout, then try sending the CALL
+           * messages again.
+           */
 
-      /* Wait for the reply from our send */
+          if ((error == EAGAIN || error == ETIMEDOUT) &&
+              retries++ < rpc->rc_retry)
+            {
+              rpc_statistics(rpcretries);
+              rpc->rc_timeout = true;
+              continue;
+            }
 
-      else
-        {
-          error = rpcclnt_reply(rpc, procnum, prog, response, resplen);
-          if (error != OK)
+          if (error == EAGAIN || error == ETIMEDOUT)
             {
-              fvdbg("ERROR rpcclnt_reply failed: %d\n", error);
+              rpc_statistics(rpctimeouts);
             }
-        }
 
-      retries++;
-    }
-  while (rpc->rc_timeout && retries <= rpc->rc_retry);
+          fdbg("ERROR: RPC failed: %d\n", error);
+          return error;
+        }
 
-  if (error != OK)
-    {
-      fdbg("ERROR: RPC failed: %d\n", error);
-      return error;
-    }
+      /* Check that this is an RPC reply to one of our calls */
 
-  /* Break down the RPC header and check if it is OK */
+      replymsg = (FAR struct rpc_reply_header *)first->rs_response;
+      if (rcvlen < sizeof(struct rpc_reply_header) ||
+          replymsg->rp_direction != rpc_reply)
+        {
+          fdbg("ERROR: Different RPC REPLY returned\n");
+          rpc_statistics(rpcinvalid);
+          continue;
+        }
 
-  replymsg = (FAR struct rpc_reply_header *)response;
+      for (slot = first; slot < &slots[nslots]; slot++)
+        {
+          if (!slot->rs_done && slot->rs_xid == replymsg->rp_xid)
+            {
+              break;
+            }
+        }
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->type);
-  if (tmp == RPC_MSGDENIED)
-    {
-      tmp = fxdr_unsigned(uint32_t, replymsg->status);
-      switch (tmp)
+      if (slot >= &slots[nslots])
         {
-        case RPC_MISMATCH:
-          fdbg("RPC_MSGDENIED: RPC_MISMATCH error\n");
-          return EOPNOTSUPP;
+          fvdbg("Discarding reply with xid %08x\n",
+                fxdr_unsigned(uint32_t, replymsg->rp_xid));
+          rpc_statistics(rpcinvalid);
+          continue;
+        }
 
-        case RPC_AUTHERR:
-          fdbg("RPC_MSGDENIED: RPC_AUTHERR error\n");
-          return EACCES;
+      /* Move the reply to the buffer of the call that it belongs to */
 
-        default:
-          return EOPNOTSUPP;
+      if (slot != first)
+        {
+          if (rcvlen > slot->rs_resplen)
+            {
+              rcvlen = slot->rs_resplen;
+            }
+
+          memcpy(slot->rs_response, first->rs_response, rcvlen);
         }
-    }
-  else if (tmp != RPC_MSGACCEPTED)
-    {
-      return EOPNOTSUPP;
-    }
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->status);
-  if (tmp == RPC_SUCCESS)
-    {
-      fvdbg("RPC_SUCCESS\n");
-    }
-  else if (tmp == RPC_PROGMISMATCH)
-    {
-      fdbg("RPC_MSGACCEPTED: RPC_PROGMISMATCH error\n");
-      return EOPNOTSUPP;
-    }
-  else if (tmp > 5)
-    {
-      fdbg("ERROR:  Other RPC type: %d\n", tmp);
-      return EOPNOTSUPP;
+      slot->rs_error = rpcclnt_checkreply(slot->rs_response);
+      slot->rs_done  = true;
+      npending--;
     }
 
   return OK;
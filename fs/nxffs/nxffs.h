@@ -52,6 +52,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/nxffs.h>
 
+#ifdef CONFIG_NXFFS_BGPACK
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -132,7 +136,9 @@
  *    open flag is not supported.
  * 6. The re-packing process occurs only during a write when the free FLASH
  *    memory at the end of the FLASH is exhausted.  Thus, occasionally, file
- *    writing may take a long time.
+ *    writing may take a long time.  With CONFIG_NXFFS_BGPACK, the volume is
+ *    also packed on the low priority work queue while it is idle, one erase
+ *    block at a time.
  * 7. Another limitation is that there can be only a single NXFFS volume
  *    mounted at any time.  This has to do with the fact that we bind to
  *    an MTD driver (instead of a block driver) and bypass all of the normal
@@ -184,6 +190,17 @@
 
 #define NXFFS_NERASED             128
 
+/* Background packing */
+
+#ifdef CONFIG_NXFFS_BGPACK
+#  ifndef CONFIG_NXFFS_BGPACK_WATERMARK
+#    define CONFIG_NXFFS_BGPACK_WATERMARK 2
+#  endif
+#  ifndef CONFIG_NXFFS_BGPACK_DELAY
+#    define CONFIG_NXFFS_BGPACK_DELAY 500
+#  endif
+#endif
+
 /* Quasi-standard definitions */
 
 #ifndef MIN
@@ -301,6 +318,10 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_BGPACK
+  bool                      packpend;  /* Deleted inodes may need to be packed */
+  struct work_s             packwork;  /* Supports background packing */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -1059,6 +1080,34 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_bgpack
+ *
+ * Description:
+ *   (Re-)start the background packing timer.  If the volume remains idle
+ *   until the timer expires, the low priority worker thread will pack the
+ *   volume if files have been deleted and the free FLASH at the end of the
+ *   volume has fallen below CONFIG_NXFFS_BGPACK_WATERMARK erase blocks.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Values:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the volume exclsem.
+ *
+ * Defined in nxffs_pack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_bgpack(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_bgpack(v)
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
@@ -189,6 +189,12 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   sem_init(&volume->exclsem, 0, 1);
   sem_init(&volume->wrsem, 0, 1);
 
+#ifdef CONFIG_NXFFS_BGPACK
+  /* There may be deleted inodes on the FLASH from before */
+
+  volume->packpend = true;
+#endif
+
   /* Get the volume geometry. (casting to uintptr_t first eliminates
    * complaints on some architectures where the sizeof long is different
    * from the size of a pointer).
@@ -565,6 +571,16 @@ int nxffs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return -ENOSYS;
     }
 
-  return g_volume.ofiles ? -EBUSY : OK;
+  if (g_volume.ofiles)
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* Cancel any pending background packing */
+
+  (void)work_cancel(LPWORK, &g_volume.packwork);
+#endif
+  return OK;
 #endif
 }
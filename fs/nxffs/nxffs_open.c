@@ -1188,6 +1188,10 @@ int nxffs_close(FAR struct file *filep)
       /* Release all resouces held by the open file */
 
       nxffs_freeofile(volume, ofile);
+
+      /* Packing may be possible now that the file is closed */
+
+      nxffs_bgpack(volume);
     }
   else
     {
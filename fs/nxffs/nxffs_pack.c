@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 
 #include "nxffs.h"
 
@@ -86,6 +87,16 @@ struct nxffs_pack_s
   off_t                ioblock;    /* I/O block number */
   off_t                block0;     /* First I/O block number in the erase block */
   uint16_t             iooffset;   /* I/O block offset */
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* These describe the last inode that was completely packed.  They are
+   * used by the background packer to stop at an inode boundary.
+   */
+
+  off_t                packed;     /* Offset to the end of the dest inode */
+  off_t                srclast;    /* Offset to the src inode header */
+  bool                 moved;      /* True: An inode was moved */
+#endif
 };
 
 /****************************************************************************
@@ -952,9 +963,24 @@ static inline int nxffs_packblock(FAR struct nxffs_volume_s *volume,
            * headers.
            */
 
+#ifdef CONFIG_NXFFS_BGPACK
+          /* Remember where the last complete inode ended */
+
+          if (pack->src.entry.hoffset != pack->dest.entry.hoffset)
+            {
+              pack->moved = true;
+            }
+
+          pack->srclast = pack->src.entry.hoffset;
+#endif
+
           nxffs_wrdathdr(volume, pack);
           nxffs_wrinodehdr(volume, pack);
 
+#ifdef CONFIG_NXFFS_BGPACK
+          pack->packed  = nxffs_packtell(volume, pack);
+#endif
+
           /* Find the next valid source inode */
 
           offset = pack->src.blkoffset + pack->src.blklen;
@@ -1247,6 +1273,531 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
   return -ENOSYS;
 }
 
+/****************************************************************************
+ * Name: nxffs_packread
+ *
+ * Description:
+ *   Read I/O blocks from FLASH into the pack buffer.
+ *
+ *   For most FLASH, a read failure indicates a fatal hardware failure.
+ *   But for NAND FLASH, the read failure probably indicates a block with
+ *   uncorrectable bit errors.  In that case, the blocks are read one-at-a-
+ *   time and a block that cannot be read is forced to be an NXFFS bad
+ *   block.
+ *
+ * Input Parameters:
+ *   volume  - The volume to be packed
+ *   block   - The first I/O block to read
+ *   buffer  - The location in the pack buffer to read into
+ *   nblocks - The number of I/O blocks to read
+ *
+ * Returned Values:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+static int nxffs_packread(FAR struct nxffs_volume_s *volume, off_t block,
+                          FAR uint8_t *buffer, int nblocks)
+{
+  int ret;
+
+#ifndef CONFIG_NXFFS_NAND
+  ret = MTD_BREAD(volume->mtd, block, nblocks, buffer);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to read block %d: %d\n", block, -ret);
+      return ret;
+    }
+
+#else
+  int i;
+
+  for (i = 0; i < nblocks; i++, block++, buffer += volume->geo.blocksize)
+    {
+      ret = MTD_BREAD(volume->mtd, block, 1, buffer);
+      if (ret < 0)
+        {
+          /* Force a the block to be an NXFFS bad block */
+
+          fdbg("ERROR: Failed to read block %d: %d\n", block, ret);
+          nxffs_blkinit(volume, buffer, BLOCK_STATE_BAD);
+        }
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_packtail
+ *
+ * Description:
+ *   There are no valid inodes at the end of FLASH.  Recover the space
+ *   used by the deleted inodes there, one erase block at a time:  Reset
+ *   the last erase block that has been written to the erased state
+ *   (preserving the block headers) and move the free FLASH offset back.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed
+ *   pack   - The volume packing state structure.
+ *   offset - The FLASH offset to the end of the last valid inode.
+ *
+ * Returned Values:
+ *   Zero on success; -ENOSPC if there is too little space to recover.
+ *   Otherwise, a negated errno value is returned to indicate the nature
+ *   of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+static int nxffs_packtail(FAR struct nxffs_volume_s *volume,
+                          FAR struct nxffs_pack_s *pack, off_t offset)
+{
+  off_t eblock;
+  off_t block;
+  off_t start;
+  int i;
+  int ret;
+
+  /* Don't wear out the final blocks for a small savings */
+
+  if (offset + CONFIG_NXFFS_TAILTHRESHOLD >= volume->froffset)
+    {
+      return -ENOSPC;
+    }
+
+  /* Get the last erase block that has been written to */
+
+  eblock       = nxffs_getblock(volume, volume->froffset - 1) /
+                 volume->blkper;
+  pack->block0 = eblock * volume->blkper;
+
+  ret = nxffs_packread(volume, pack->block0, volume->pack, volume->blkper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Erase everything in the valid I/O blocks after the offset */
+
+  for (i = 0, block = pack->block0, pack->iobuffer = volume->pack;
+       i < volume->blkper;
+       i++, block++, pack->iobuffer += volume->geo.blocksize)
+    {
+      start = nxffs_getoffset(volume, offset, block);
+      if (start < SIZEOF_NXFFS_BLOCK_HDR)
+        {
+          start = SIZEOF_NXFFS_BLOCK_HDR;
+        }
+
+      if (start < volume->geo.blocksize && nxffs_packvalid(pack))
+        {
+          memset(&pack->iobuffer[start], CONFIG_NXFFS_ERASEDSTATE,
+                 volume->geo.blocksize - start);
+        }
+    }
+
+  ret = MTD_ERASE(volume->mtd, eblock, 1);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to erase block %d [%d]: %d\n",
+           eblock, pack->block0, -ret);
+      return ret;
+    }
+
+  ret = MTD_BWRITE(volume->mtd, pack->block0, volume->blkper, volume->pack);
+  volume->cblock = (off_t)-1;
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to write erase block %d [%d]: %d\n",
+           eblock, pack->block0, -ret);
+      return ret;
+    }
+
+  /* The free FLASH region now begins at the erase block (or at the end of
+   * the last valid inode if that lies within the erase block).
+   */
+
+  start = pack->block0 * volume->geo.blocksize;
+  volume->froffset = offset > start ? offset : start;
+
+  /* If there are no valid inodes, the first inode will be written here */
+
+  if (volume->inoffset > volume->froffset)
+    {
+      volume->inoffset = volume->froffset;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxffs_packstep
+ *
+ * Description:
+ *   Perform one bounded step of packing for the background packer:  Pack
+ *   the inodes starting at the first gap, but stop at the end of the first
+ *   erase block in which an inode is completed.  Normally that is the
+ *   erase block that contains the gap; an inode that is larger than the
+ *   rest of that erase block is carried into the following erase blocks.
+ *
+ *   The original contents of the final erase block after the last complete
+ *   inode are preserved so that the next inode is still intact at its old
+ *   location, and the old copies of the packed inodes are marked as
+ *   deleted.  So the volume is consistent after each step.  The free FLASH
+ *   offset is unchanged; that space is recovered by nxffs_packtail() once
+ *   all of the valid inodes have been packed.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Values:
+ *   Zero if a step was performed and there may be more to pack.  -ENOSPC
+ *   if there is nothing more that can be done in the background.
+ *   Otherwise, a negated errno value is returned to indicate the nature of
+ *   the failure.
+ *
+ * Assumptions:
+ *   The caller holds the volume exclsem and there are no open files.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+static int nxffs_packstep(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_pack_s pack;
+  struct nxffs_entry_s entry;
+  FAR struct nxffs_inode_s *inode;
+  off_t froffset = volume->froffset;
+  off_t iooffset;
+  off_t eblock;
+  off_t block;
+  off_t offset;
+  int i;
+  int ret;
+
+  /* Get the offset to the first valid inode */
+
+  iooffset = nxffs_mediacheck(volume, &pack);
+  if (iooffset == 0)
+    {
+      /* There are no valid inodes.  Everything up to the free FLASH offset
+       * can be recovered.
+       */
+
+      block = 0;
+      ret = nxffs_validblock(volume, &block);
+      if (ret < 0)
+        {
+          return -ENOSPC;
+        }
+
+      return nxffs_packtail(volume, &pack, block * volume->geo.blocksize +
+                                           SIZEOF_NXFFS_BLOCK_HDR);
+    }
+
+  /* Find the first gap between inodes */
+
+  ret = nxffs_startpos(volume, &pack, &iooffset);
+  if (ret < 0)
+    {
+      /* If there are no gaps, then recover the deleted inodes at the end
+       * of FLASH.
+       */
+
+      if (ret == -ENOSPC)
+        {
+          return nxffs_packtail(volume, &pack, iooffset);
+        }
+
+      fdbg("ERROR: Failed to find a packing position: %d\n", -ret);
+      return ret;
+    }
+
+  /* The end of the previous inode may lie exactly at the end of an I/O
+   * block.  Don't pack over the block header of the next block.
+   */
+
+  pack.ioblock  = nxffs_getblock(volume, iooffset);
+  pack.iooffset = nxffs_getoffset(volume, iooffset, pack.ioblock);
+  if (pack.iooffset < SIZEOF_NXFFS_BLOCK_HDR)
+    {
+      pack.iooffset = SIZEOF_NXFFS_BLOCK_HDR;
+      iooffset      = nxffs_packtell(volume, &pack);
+    }
+
+  pack.packed   = iooffset;
+
+  for (eblock = pack.ioblock / volume->blkper;
+       eblock < volume->geo.neraseblocks;
+       eblock++)
+    {
+      pack.block0 = eblock * volume->blkper;
+
+      ret = nxffs_packread(volume, pack.block0, volume->pack,
+                           volume->blkper);
+      if (ret < 0)
+        {
+          goto errout_with_pack;
+        }
+
+      /* Pack inodes into each I/O block of this erase block */
+
+      for (i = 0, block = pack.block0, pack.iobuffer = volume->pack;
+           i < volume->blkper;
+           i++, block++, pack.iobuffer += volume->geo.blocksize)
+        {
+          if (block >= pack.ioblock)
+            {
+              pack.ioblock = block;
+              if (nxffs_packvalid(&pack))
+                {
+                  ret = nxffs_packblock(volume, &pack);
+                  if (ret < 0 && ret != -ENOSPC)
+                    {
+                      fdbg("ERROR: Failed to pack into block %d: %d\n",
+                           block, ret);
+                      goto errout_with_pack;
+                    }
+                }
+
+              if (pack.iooffset < volume->geo.blocksize)
+                {
+                  memset(&pack.iobuffer[pack.iooffset],
+                         CONFIG_NXFFS_ERASEDSTATE,
+                         volume->geo.blocksize - pack.iooffset);
+                }
+
+              pack.iooffset = SIZEOF_NXFFS_BLOCK_HDR;
+
+              /* -ENOSPC means that all valid inodes have been packed */
+
+              if (ret == -ENOSPC)
+                {
+                  break;
+                }
+            }
+        }
+
+      /* Stop at the end of the first erase block in which an inode was
+       * completed.
+       */
+
+      if (pack.srclast != 0)
+        {
+          break;
+        }
+
+      /* Otherwise, the first inode is larger than the rest of the erase
+       * block.  Write the erase block and continue packing that inode into
+       * the next erase block, just as nxffs_pack() does.
+       */
+
+      ret = MTD_ERASE(volume->mtd, eblock, 1);
+      if (ret < 0)
+        {
+          fdbg("ERROR: Failed to erase block %d [%d]: %d\n",
+               eblock, pack.block0, -ret);
+          goto errout_with_pack;
+        }
+
+      ret = MTD_BWRITE(volume->mtd, pack.block0, volume->blkper,
+                       volume->pack);
+      volume->cblock = (off_t)-1;
+      if (ret < 0)
+        {
+          fdbg("ERROR: Failed to write erase block %d [%d]: %d\n",
+               eblock, pack.block0, -ret);
+          goto errout_with_pack;
+        }
+    }
+
+  /* Did anything move?  If not, then the gap was only an artifact of a
+   * bad block and there is nothing to recover.
+   */
+
+  if (!pack.moved)
+    {
+      fvdbg("Nothing to pack in erase block %d\n", eblock);
+      ret = -ENOSPC;
+      goto errout_with_pack;
+    }
+
+  /* Restore the original contents of the erase block after the last
+   * complete inode.  This also discards any part of a following inode
+   * that was packed.
+   */
+
+  block  = nxffs_getblock(volume, pack.packed);
+  offset = nxffs_getoffset(volume, pack.packed, block);
+  pack.iobuffer = volume->pack +
+                  (block - pack.block0) * volume->geo.blocksize;
+
+  if (block < pack.block0 + volume->blkper && offset > 0)
+    {
+      ret = nxffs_rdcache(volume, block);
+      if (ret < 0)
+        {
+          goto errout_with_pack;
+        }
+
+      memcpy(&pack.iobuffer[offset], &volume->cache[offset],
+             volume->geo.blocksize - offset);
+
+      block++;
+      pack.iobuffer += volume->geo.blocksize;
+    }
+
+  if (block < pack.block0 + volume->blkper)
+    {
+      ret = nxffs_packread(volume, block, pack.iobuffer,
+                           pack.block0 + volume->blkper - block);
+      if (ret < 0)
+        {
+          goto errout_with_pack;
+        }
+    }
+
+  /* Now it is safe to erase and re-write the erase block */
+
+  ret = MTD_ERASE(volume->mtd, eblock, 1);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to erase block %d [%d]: %d\n",
+           eblock, pack.block0, -ret);
+      goto errout_with_pack;
+    }
+
+  ret = MTD_BWRITE(volume->mtd, pack.block0, volume->blkper, volume->pack);
+  volume->cblock = (off_t)-1;
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to write erase block %d [%d]: %d\n",
+           eblock, pack.block0, -ret);
+      goto errout_with_pack;
+    }
+
+  /* Then mark the old copies of the packed inodes as deleted.  These are
+   * all of the valid inodes from the end of the packed inodes through the
+   * source of the last packed inode.
+   */
+
+  offset = pack.packed;
+  while (nxffs_nextentry(volume, offset, &entry) == OK)
+    {
+      offset = entry.hoffset;
+      nxffs_freeentry(&entry);
+
+      if (offset > pack.srclast)
+        {
+          break;
+        }
+
+      nxffs_ioseek(volume, offset);
+      ret = nxffs_rdcache(volume, volume->ioblock);
+      if (ret < 0)
+        {
+          goto errout_with_pack;
+        }
+
+      inode = (FAR struct nxffs_inode_s *)&volume->cache[volume->iooffset];
+      inode->state = INODE_STATE_DELETED;
+
+      ret = nxffs_wrcache(volume);
+      if (ret < 0)
+        {
+          goto errout_with_pack;
+        }
+
+      offset += SIZEOF_NXFFS_INODE_HDR;
+    }
+
+  /* The first inode may have been moved to the beginning of the gap */
+
+  if (iooffset < volume->inoffset &&
+      nxffs_nextentry(volume, iooffset, &entry) == OK)
+    {
+      volume->inoffset = entry.hoffset;
+      nxffs_freeentry(&entry);
+    }
+
+  ret = OK;
+
+errout_with_pack:
+  nxffs_freeentry(&pack.src.entry);
+  nxffs_freeentry(&pack.dest.entry);
+  volume->froffset = froffset;
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxffs_bgpack_worker
+ *
+ * Description:
+ *   Pack the volume from the low priority worker thread.  Foreground
+ *   operations have priority:  Nothing is done if the volume is busy or if
+ *   there are open files (packing would also move the inodes out from under
+ *   any open readers).  The next close or unlink will re-start the timer.
+ *
+ *   At most one erase block is packed on each run.  The volume lock is
+ *   released between runs and the work is re-queued while there is more
+ *   to recover.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+static void nxffs_bgpack_worker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  off_t nfree;
+  int ret;
+
+  if (sem_trywait(&volume->exclsem) != OK)
+    {
+      /* Somebody is using the volume.  Try again later */
+
+      (void)work_queue(LPWORK, &volume->packwork, nxffs_bgpack_worker,
+                       volume, MSEC2TICK(CONFIG_NXFFS_BGPACK_DELAY));
+      return;
+    }
+
+  if (volume->ofiles == NULL && volume->packpend)
+    {
+      /* Pack only if the free FLASH at the end of the volume is low */
+
+      nfree = volume->nblocks * volume->geo.blocksize - volume->froffset;
+      if (nfree < CONFIG_NXFFS_BGPACK_WATERMARK * volume->geo.erasesize)
+        {
+          fvdbg("Packing, %ld bytes free\n", (long)nfree);
+
+          ret = nxffs_packstep(volume);
+          if (ret == OK)
+            {
+              /* Let foreground operations run, then do the next step */
+
+              (void)work_queue(LPWORK, &volume->packwork,
+                               nxffs_bgpack_worker, volume, 0);
+            }
+          else if (ret == -ENOSPC)
+            {
+              /* Nothing more can be recovered in the background */
+
+              volume->packpend = false;
+            }
+          else
+            {
+              fdbg("ERROR: Failed to pack the volume: %d\n", -ret);
+            }
+        }
+    }
+
+  sem_post(&volume->exclsem);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1413,49 +1964,19 @@ start_pack:
 
       pack.block0 = eblock * volume->blkper;
 
-#ifndef CONFIG_NXFFS_NAND
       /* Read the erase block into the pack buffer.  We need to do this even
        * if we are overwriting the entire block so that we skip over
        * previously marked bad blocks.
        */
 
-      ret = MTD_BREAD(volume->mtd, pack.block0, volume->blkper, volume->pack);
+      ret = nxffs_packread(volume, pack.block0, volume->pack,
+                           volume->blkper);
       if (ret < 0)
         {
           fdbg("ERROR: Failed to read erase block %d: %d\n", eblock,-ret);
           goto errout_with_pack;
         }
 
-#else
-      /* Read the entire erase block into the pack buffer, one-block-at-a-
-       * time.  We need to do this even if we are overwriting the entire
-       * block so that (1) we skip over previously marked bad blocks, and
-       * (2) we can handle individual block read failures.
-       *
-       * For most FLASH, a read failure indicates a fatal hardware failure.
-       * But for NAND FLASH, the read failure probably indicates a block
-       * with uncorrectable bit errors.
-       */
-
-      /* Read each I/O block */
-
-      for (i = 0, block = pack.block0, pack.iobuffer = volume->pack;
-           i < volume->blkper;
-           i++, block++, pack.iobuffer += volume->geo.blocksize)
-        {
-          /* Read the next block in the erase block */
-
-          ret = MTD_BREAD(volume->mtd, block, 1, pack.iobuffer);
-          if (ret < 0)
-            {
-              /* Force a the block to be an NXFFS bad block */
-
-              fdbg("ERROR: Failed to read block %d: %d\n", block, ret);
-              nxffs_blkinit(volume, pack.iobuffer, BLOCK_STATE_BAD);
-            }
-        }
-#endif
-
       /* Now pack each I/O block */
 
       for (i = 0, block = pack.block0, pack.iobuffer = volume->pack;
@@ -1605,3 +2126,39 @@ errout_with_pack:
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxffs_bgpack
+ *
+ * Description:
+ *   (Re-)start the background packing timer.  If the volume remains idle
+ *   until the timer expires, the low priority worker thread will pack the
+ *   volume if files have been deleted and the free FLASH at the end of the
+ *   volume has fallen below CONFIG_NXFFS_BGPACK_WATERMARK erase blocks.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Values:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the volume exclsem.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_bgpack(FAR struct nxffs_volume_s *volume)
+{
+  if (volume->packpend && volume->ofiles == NULL)
+    {
+      /* Any pending work is cancelled so that packing is deferred until
+       * the volume has been idle for the full delay.
+       */
+
+      (void)work_cancel(LPWORK, &volume->packwork);
+      (void)work_queue(LPWORK, &volume->packwork, nxffs_bgpack_worker,
+                       volume, MSEC2TICK(CONFIG_NXFFS_BGPACK_DELAY));
+    }
+}
+#endif
@@ -145,6 +145,14 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       fdbg("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+#ifdef CONFIG_NXFFS_BGPACK
+  else
+    {
+      /* The deleted inode can now be recovered by packing */
+
+      volume->packpend = true;
+    }
+#endif
 
 errout_with_entry:
   nxffs_freeentry(&entry);
@@ -182,6 +190,10 @@ int nxffs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Then remove the NXFFS inode */
 
   ret = nxffs_rminode(volume, relpath);
+  if (ret == OK)
+    {
+      nxffs_bgpack(volume);
+    }
 
   sem_post(&volume->exclsem);
 errout:
@@ -87,6 +87,11 @@ extern const struct procfs_operations mtd_procfsoperations;
 extern const struct procfs_operations part_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
 
+/* Similarly, these are implemented in net/. */
+
+extern const struct procfs_operations neighbor_procfsoperations;
+extern const struct procfs_operations tcp_procfsoperations;
+
 /* And even worse, this one is specific to the STM32.  The solution to
  * this nasty couple would be to replace this hard-coded, ROM-able
  * operations table with a RAM-base registration table.
@@ -121,6 +126,15 @@ static const struct procfs_entry_s g_procfsentries[] =
   { "mtd",              &mtd_procfsoperations },
 #endif
 
+#if (defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
+  { "net/neighbor",     &neighbor_procfsoperations },
+#endif
+
+#if defined(CONFIG_NET_TCP) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
+  { "net/tcp",          &tcp_procfsoperations },
+#endif
+
 #if defined(CONFIG_MTD_PARTITION) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PARTITIONS)
   { "partitions",       &part_procfsoperations },
 #endif
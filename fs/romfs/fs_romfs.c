@@ -384,6 +384,21 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = bytesleft;
     }
 
+  /* In XIP mode the file data is directly addressable.  Copy it in one
+   * piece rather than a sector at a time through romfs_hwread() and the
+   * file sector buffer.
+   */
+
+  if (rm->rm_xipbase)
+    {
+      memcpy(userbuffer,
+             rm->rm_xipbase + rf->rf_startoffset + filep->f_pos, buflen);
+      filep->f_pos += buflen;
+
+      romfs_semgive(rm);
+      return buflen;
+    }
+
   /* Loop until either (1) all data has been transferred, or (2) an
    * error occurs.
    */
@@ -953,6 +968,18 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       goto errout_with_buffer;
     }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Build the in-RAM directory index.  This is only an optimization:  if
+   * it cannot be built, lookups will walk the file headers instead.
+   */
+
+  ret = romfs_buildindex(rm);
+  if (ret < 0)
+    {
+      fdbg("romfs_buildindex failed: %d\n", ret);
+    }
+#endif
+
   /* Mounted! */
 
   *handle = (void*)rm;
@@ -1043,6 +1070,10 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           kmm_free(rm->rm_buffer);
         }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+      romfs_freeindex(rm);
+#endif
+
       sem_destroy(&rm->rm_sem);
       kmm_free(rm);
       return OK;
@@ -129,6 +129,21 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+/* One entry of the in-RAM directory index.  The index is built once at
+ * mount time and kept sorted by (parent directory, name hash) so that a
+ * path segment can be located with a binary search instead of a walk of
+ * the directory's linked list of file headers.
+ */
+
+struct romfs_dirent_s
+{
+  uint32_t de_dir;                  /* Offset of first entry in parent */
+  uint32_t de_hash;                 /* Hash of the entry name */
+  uint32_t de_offset;               /* Offset of the entry's file header */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -149,6 +164,10 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  uint32_t rm_nindex;               /* Number of entries in rm_index */
+  struct romfs_dirent_s *rm_index;  /* Sorted directory index (may be NULL) */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -208,6 +227,10 @@ EXTERN int  romfs_filecacheread(struct romfs_mountpt_s *rm,
                   struct romfs_file_s *rf, uint32_t sector);
 EXTERN int  romfs_hwconfigure(struct romfs_mountpt_s *rm);
 EXTERN int  romfs_fsconfigure(struct romfs_mountpt_s *rm);
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+EXTERN int  romfs_buildindex(struct romfs_mountpt_s *rm);
+EXTERN void romfs_freeindex(struct romfs_mountpt_s *rm);
+#endif
 EXTERN int  romfs_fileconfigure(struct romfs_mountpt_s *rm,
                   struct romfs_file_s *rf);
 EXTERN int  romfs_checkmount(struct romfs_mountpt_s *rm);
@@ -293,6 +293,207 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_namehash
+ *
+ * Desciption:
+ *   Return the 32-bit FNV-1a hash of a name segment.  The segment need not
+ *   be NUL terminated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+static uint32_t romfs_namehash(const char *name, int namelen)
+{
+  uint32_t hash = 2166136261u;
+
+  while (namelen-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_indexcompare
+ *
+ * Desciption:
+ *   qsort() comparison function that orders directory index entries by
+ *   parent directory, then by name hash.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+static int romfs_indexcompare(const void *a, const void *b)
+{
+  const struct romfs_dirent_s *dea = (const struct romfs_dirent_s *)a;
+  const struct romfs_dirent_s *deb = (const struct romfs_dirent_s *)b;
+
+  if (dea->de_dir != deb->de_dir)
+    {
+      return dea->de_dir < deb->de_dir ? -1 : 1;
+    }
+
+  if (dea->de_hash != deb->de_hash)
+    {
+      return dea->de_hash < deb->de_hash ? -1 : 1;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_indexdir
+ *
+ * Desciption:
+ *   Add every file and directory entry of the directory whose first entry
+ *   is at 'dir' to the (still unsorted) directory index.  'nalloc' holds
+ *   the number of entries allocated in rm_index and 'budget' the number of
+ *   file headers that may still be visited before the image is declared
+ *   corrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+static int romfs_indexdir(struct romfs_mountpt_s *rm, uint32_t dir,
+                          uint32_t *nalloc, uint32_t *budget)
+{
+  struct romfs_dirent_s *de;
+  char name[NAME_MAX+1];
+  uint32_t linkoffset;
+  uint32_t offset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t size;
+  int ret;
+
+  offset = dir;
+  do
+    {
+      /* Guard against cycles in the linked list of a corrupt image */
+
+      if (*budget == 0)
+        {
+          return -EINVAL;
+        }
+
+      (*budget)--;
+
+      ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info,
+                                &size);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Only directories and regular files can be looked up by name */
+
+      if (IS_DIRECTORY(next) || IS_FILE(next))
+        {
+          ret = romfs_parsefilename(rm, offset, name);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          /* Grow the index if it is full */
+
+          if (rm->rm_nindex >= *nalloc)
+            {
+              uint32_t newalloc = *nalloc ? 2 * *nalloc : 32;
+
+              de = (struct romfs_dirent_s *)
+                kmm_realloc(rm->rm_index,
+                            newalloc * sizeof(struct romfs_dirent_s));
+              if (!de)
+                {
+                  return -ENOMEM;
+                }
+
+              rm->rm_index = de;
+              *nalloc      = newalloc;
+            }
+
+          de            = &rm->rm_index[rm->rm_nindex++];
+          de->de_dir    = dir;
+          de->de_hash   = romfs_namehash(name, strlen(name));
+          de->de_offset = offset;
+        }
+
+      offset = next & RFNEXT_OFFSETMASK;
+    }
+  while (offset != 0);
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Desciption:
+ *   This is the romfs_searchdir() logic when a directory index is
+ *   available:  Binary search the index for the (directory, name hash) key,
+ *   then verify the name of each candidate on the media.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+static int romfs_searchindex(struct romfs_mountpt_s *rm,
+                             const char *entryname, int entrylen,
+                             struct romfs_dirinfo_s *dirinfo)
+{
+  const struct romfs_dirent_s *de;
+  uint32_t dir  = dirinfo->rd_dir.fr_firstoffset;
+  uint32_t hash = romfs_namehash(entryname, entrylen);
+  uint32_t lo   = 0;
+  uint32_t hi   = rm->rm_nindex;
+  uint32_t mid;
+
+  /* Find the first entry whose key is not less than (dir, hash) */
+
+  while (lo < hi)
+    {
+      mid = (lo + hi) >> 1;
+      de  = &rm->rm_index[mid];
+
+      if (de->de_dir < dir || (de->de_dir == dir && de->de_hash < hash))
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  /* There is normally exactly one candidate.  There can be more only if
+   * two names in the same directory have the same hash.
+   */
+
+  for (; lo < rm->rm_nindex; lo++)
+    {
+      de = &rm->rm_index[lo];
+      if (de->de_dir != dir || de->de_hash != hash)
+        {
+          break;
+        }
+
+      if (romfs_checkentry(rm, de->de_offset, entryname, entrylen,
+                           dirinfo) == OK)
+        {
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -316,6 +517,15 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
    * the directory have been examined.
    */
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Use the directory index if one was built when the volume was mounted */
+
+  if (rm->rm_index)
+    {
+      return romfs_searchindex(rm, entryname, entrylen, dirinfo);
+    }
+
+#endif
   offset = dirinfo->rd_dir.fr_firstoffset;
   do
     {
@@ -617,6 +827,106 @@ int romfs_fsconfigure(struct romfs_mountpt_s *rm)
   return OK;
 }
 
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Desciption:
+ *   This function is called as part of the ROMFS mount operation after
+ *   romfs_fsconfigure().  It walks the whole directory tree once and builds
+ *   the sorted in-RAM directory index used by romfs_finddirentry().  On
+ *   failure, no index is left behind and lookups fall back to walking the
+ *   file headers on the media.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+int romfs_buildindex(struct romfs_mountpt_s *rm)
+{
+  uint32_t nalloc = 0;
+  uint32_t budget;
+  uint32_t offset;
+  uint32_t next;
+  uint32_t i;
+  int16_t  ndx;
+  int      ret;
+
+  rm->rm_index  = NULL;
+  rm->rm_nindex = 0;
+
+  /* Every file header occupies at least 32 bytes (16 bytes of header and
+   * at least 16 bytes of name), so that bounds the number of headers that
+   * a valid image can contain.
+   */
+
+  budget = rm->rm_volsize / 32 + 1;
+
+  /* Index the root directory.  The index then doubles as the work list:
+   * each real (i.e., not hard-linked) subdirectory found is indexed in
+   * turn, which visits every directory in the tree exactly once.
+   */
+
+  ret = romfs_indexdir(rm, rm->rm_rootoffset, &nalloc, &budget);
+  for (i = 0; ret == OK && i < rm->rm_nindex; i++)
+    {
+      offset = rm->rm_index[i].de_offset;
+      ndx    = romfs_devcacheread(rm, offset);
+      if (ndx < 0)
+        {
+          ret = ndx;
+          break;
+        }
+
+      /* The '.' entry of the root directory is a real directory header
+       * that refers back to the root directory itself.  Don't descend
+       * into that one again.
+       */
+
+      next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+      if (IS_DIRECTORY(next))
+        {
+          offset = romfs_devread32(rm, ndx + ROMFS_FHDR_INFO);
+          if (offset != 0 && offset != rm->rm_index[i].de_dir)
+            {
+              ret = romfs_indexdir(rm, offset, &nalloc, &budget);
+            }
+        }
+    }
+
+  if (ret < 0)
+    {
+      romfs_freeindex(rm);
+      return ret;
+    }
+
+  qsort(rm->rm_index, rm->rm_nindex, sizeof(struct romfs_dirent_s),
+        romfs_indexcompare);
+
+  fvdbg("Indexed %d entries\n", rm->rm_nindex);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_freeindex
+ *
+ * Desciption:
+ *   Release the directory index, if any.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+void romfs_freeindex(struct romfs_mountpt_s *rm)
+{
+  if (rm->rm_index)
+    {
+      kmm_free(rm->rm_index);
+    }
+
+  rm->rm_index  = NULL;
+  rm->rm_nindex = 0;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_fileconfigure
  *
@@ -842,12 +1152,22 @@ int romfs_parsedirentry(struct romfs_mountpt_s *rm, uint32_t offset,
       return ret;
     }
 
+  /* Following the hardlinks may have replaced the cached sector.  Re-read
+   * the sector that holds the real file header.
+   */
+
+  ndx = romfs_devcacheread(rm, *poffset);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
   /* Because everything is chunked and aligned to 16-bit boundaries,
    * we know that most the basic node info fits into the sector.  The
    * associated name may not, however.
    */
 
-   next  = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+  next   = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
   *pnext = (save & RFNEXT_OFFSETMASK) | (next & RFNEXT_ALLMODEMASK);
   *pinfo = romfs_devread32(rm, ndx + ROMFS_FHDR_INFO);
   *psize = romfs_devread32(rm, ndx + ROMFS_FHDR_SIZE);
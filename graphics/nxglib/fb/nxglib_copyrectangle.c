@@ -45,6 +45,7 @@
 #include <nuttx/nx/nxglib.h>
 
 #include "nxglib_bitblit.h"
+#include "nxglib_copyrun.h"
 
 /****************************************************************************
  * Pre-processor Definitions
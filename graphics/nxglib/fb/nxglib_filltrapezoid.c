@@ -46,6 +46,7 @@
 #include <nuttx/nx/nxglib.h>
 
 #include "nxglib_bitblit.h"
+#include "nxglib_fillrun.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -45,6 +45,7 @@
 #include <nuttx/nx/nxglib.h>
 
 #include "nxglib_bitblit.h"
+#include "nxglib_copyrun.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -187,6 +188,21 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
 
   dline = pinfo->fbmem + offset->y * stride + NXGL_SCALEX(offset->x);
 
+#if NXGLIB_BITSPERPIXEL >= 8
+  /* Fast path:  If the rectangle spans the full width of the framebuffer
+   * (as when a full-width window or the whole display is scrolled
+   * vertically), then the source and destination regions are each one
+   * contiguous block of memory and can be moved with a single, overlap-safe
+   * wide copy.
+   */
+
+  if (NXGL_SCALEX(width) == stride && offset->x == rect->pt1.x)
+    {
+      NXGL_MEMMOVE(dline, sline, width * rows);
+      return;
+    }
+#endif
+
   /* Case 1:  Is the destination position above the displayed position?
    * If the destination position is less then then the src address, then the
    * destination is offset to a position below (and or to the left) of the
@@ -194,7 +210,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
    */
 
   if (offset->y < rect->pt1.y ||
-     (offset->y < rect->pt1.y && offset->x <= rect->pt1.x))
+     (offset->y == rect->pt1.y && offset->x <= rect->pt1.x))
     {
       /* Yes.. Copy the rectangle from top down (i.e., adding the stride
        * to move to the next, lower row) */
@@ -206,7 +222,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
           /* Point to the next source/dest row below the current one */
 
@@ -245,7 +261,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
         }
     }
@@ -113,6 +113,24 @@
 
 #endif
 
+/* Wide stores.  Runs of 8-, 16-, 24- and 32-bit pixels are filled and
+ * copied a machine word (32- or 64-bits) at a time once the destination
+ * has been aligned.  NXGL_UNIT_T is the smallest unit that may be stored
+ * at an unaligned address:  One pixel, or one byte for packed 24-bit RGB.
+ */
+
+#define NXGL_WORD_T                uintptr_t
+#define NXGL_WORDSIZE              sizeof(uintptr_t)
+#define NXGL_WORDMASK              (sizeof(uintptr_t) - 1)
+#define NXGL_WORDALIGNED(p)        (((uintptr_t)(p) & NXGL_WORDMASK) == 0)
+#define NXGL_COALIGNED(p1,p2)      ((((uintptr_t)(p1) ^ (uintptr_t)(p2)) & NXGL_WORDMASK) == 0)
+
+#if NXGLIB_BITSPERPIXEL == 24
+#  define NXGL_UNIT_T              uint8_t
+#elif NXGLIB_BITSPERPIXEL >= 8
+#  define NXGL_UNIT_T              NXGL_PIXEL_T
+#endif
+
 #if NXGLIB_BITSPERPIXEL < 8
 
 #  define NXGL_SCALEX(x)           ((x) >> NXGL_PIXELSHIFT)
@@ -141,32 +159,22 @@
        } \
    }
 
+#  define NXGL_MEMMOVE(dest,src,width) NXGL_MEMCPY(dest,src,width)
+
 #elif NXGLIB_BITSPERPIXEL == 24
 
+/* The wide-store kernels are provided by nxglib_fillrun.h and
+ * nxglib_copyrun.h which must be included by the user of these macros.
+ */
+
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr  = (FAR uint8_t*)(dest); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-         *_ptr++ = (value) >> 8; \
-         *_ptr++ = (value) >> 16; \
-       } \
-   }
+   nxgl_fillpacked_24bpp((FAR uint8_t*)(dest), (value), (width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   nxgl_copyrun_wide((dest), (src), NXGL_SCALEX(width))
+
+#  define NXGL_MEMMOVE(dest,src,width) \
+   nxgl_moverun_wide((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -185,28 +193,21 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
+#else /* NXGLIB_BITSPERPIXEL == 8, 16 or 32 */
+
+/* The wide-store kernels are provided by nxglib_fillrun.h and
+ * nxglib_copyrun.h which must be included by the user of these macros.
+ */
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+   NXGL_FUNCNAME(nxgl_fillrun,NXGLIB_SUFFIX)((FAR NXGL_PIXEL_T*)(dest), \
+                                             (value), (width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   nxgl_copyrun_wide((dest), (src), NXGL_SCALEX(width))
+
+#  define NXGL_MEMMOVE(dest,src,width) \
+   nxgl_moverun_wide((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -43,6 +43,9 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 #include <string.h>
+#include <assert.h>
+
+#include "nxglib_bitblit.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -341,6 +344,148 @@ nxgl_copyrun_4bpp(FAR const uint8_t *src, FAR uint8_t *dest,
     }
 }
 #endif
+
+/****************************************************************************
+ * Name: nxgl_copyrun_wide
+ *
+ * Description:
+ *   Copy nbytes of 8-, 16-, 24-, or 32-bit pixel data from src to dest.  If
+ *   the source and destination have the same alignment within a machine
+ *   word, the bulk of the copy is performed one word at a time; otherwise
+ *   the data is copied one NXGL_UNIT_T at a time.  The source and
+ *   destination must not overlap unless dest precedes src.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL >= 8
+static inline void nxgl_copyrun_wide(FAR void *dest, FAR const void *src,
+                                     size_t nbytes)
+{
+  FAR NXGL_UNIT_T *dptr = (FAR NXGL_UNIT_T *)dest;
+  FAR const NXGL_UNIT_T *sptr = (FAR const NXGL_UNIT_T *)src;
+
+  if (NXGL_COALIGNED(dptr, sptr))
+    {
+      FAR NXGL_WORD_T *wdptr;
+      FAR const NXGL_WORD_T *wsptr;
+
+      /* Copy single units until both pointers are word aligned */
+
+      while (nbytes > 0 && !NXGL_WORDALIGNED(dptr))
+        {
+          *dptr++ = *sptr++;
+          nbytes -= sizeof(NXGL_UNIT_T);
+        }
+
+      /* Copy the aligned middle of the run, four words at a time */
+
+      wdptr = (FAR NXGL_WORD_T *)dptr;
+      wsptr = (FAR const NXGL_WORD_T *)sptr;
+
+      while (nbytes >= 4 * NXGL_WORDSIZE)
+        {
+          wdptr[0] = wsptr[0];
+          wdptr[1] = wsptr[1];
+          wdptr[2] = wsptr[2];
+          wdptr[3] = wsptr[3];
+          wdptr   += 4;
+          wsptr   += 4;
+          nbytes  -= 4 * NXGL_WORDSIZE;
+        }
+
+      while (nbytes >= NXGL_WORDSIZE)
+        {
+          *wdptr++ = *wsptr++;
+          nbytes  -= NXGL_WORDSIZE;
+        }
+
+      dptr = (FAR NXGL_UNIT_T *)wdptr;
+      sptr = (FAR const NXGL_UNIT_T *)wsptr;
+    }
+
+  /* Copy whatever remains (or everything if the buffers are not co-aligned) */
+
+  while (nbytes > 0)
+    {
+      *dptr++ = *sptr++;
+      nbytes -= sizeof(NXGL_UNIT_T);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxgl_moverun_wide
+ *
+ * Description:
+ *   Like nxgl_copyrun_wide(), but the source and destination may overlap
+ *   in any way.  If dest follows src within the overlapping region, the
+ *   run is copied from the end backward.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL >= 8
+static inline void nxgl_moverun_wide(FAR void *dest, FAR const void *src,
+                                     size_t nbytes)
+{
+  FAR NXGL_UNIT_T *dptr;
+  FAR const NXGL_UNIT_T *sptr;
+
+  /* Forward copy is safe unless dest lies inside of the source run */
+
+  if ((FAR uint8_t *)dest <= (FAR const uint8_t *)src ||
+      (FAR uint8_t *)dest >= (FAR const uint8_t *)src + nbytes)
+    {
+      nxgl_copyrun_wide(dest, src, nbytes);
+      return;
+    }
+
+  /* Otherwise, copy from the end of the run toward the beginning */
+
+  dptr = (FAR NXGL_UNIT_T *)((FAR uint8_t *)dest + nbytes);
+  sptr = (FAR const NXGL_UNIT_T *)((FAR const uint8_t *)src + nbytes);
+
+  if (NXGL_COALIGNED(dptr, sptr))
+    {
+      FAR NXGL_WORD_T *wdptr;
+      FAR const NXGL_WORD_T *wsptr;
+
+      while (nbytes > 0 && !NXGL_WORDALIGNED(dptr))
+        {
+          *--dptr = *--sptr;
+          nbytes -= sizeof(NXGL_UNIT_T);
+        }
+
+      wdptr = (FAR NXGL_WORD_T *)dptr;
+      wsptr = (FAR const NXGL_WORD_T *)sptr;
+
+      while (nbytes >= 4 * NXGL_WORDSIZE)
+        {
+          wdptr   -= 4;
+          wsptr   -= 4;
+          wdptr[3] = wsptr[3];
+          wdptr[2] = wsptr[2];
+          wdptr[1] = wsptr[1];
+          wdptr[0] = wsptr[0];
+          nbytes  -= 4 * NXGL_WORDSIZE;
+        }
+
+      while (nbytes >= NXGL_WORDSIZE)
+        {
+          *--wdptr = *--wsptr;
+          nbytes  -= NXGL_WORDSIZE;
+        }
+
+      dptr = (FAR NXGL_UNIT_T *)wdptr;
+      sptr = (FAR const NXGL_UNIT_T *)wsptr;
+    }
+
+  while (nbytes > 0)
+    {
+      *--dptr = *--sptr;
+      nbytes -= sizeof(NXGL_UNIT_T);
+    }
+}
+#endif
 #endif /* __GRAPHICS_NXGLIB_NXGLIB_COPYRUN_H */
 
 
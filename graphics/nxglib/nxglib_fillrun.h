@@ -44,6 +44,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "nxglib_bitblit.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -65,7 +67,7 @@
  ****************************************************************************/
 
 #if NXGLIB_BITSPERPIXEL == 2
-static uint8_t g_wide_2bpp[4] = { 0x00, 0x55, 0xaa, 0xff };
+static const uint8_t g_wide_2bpp[4] = { 0x00, 0x55, 0xaa, 0xff };
 #endif
 
 /****************************************************************************
@@ -76,6 +78,64 @@ static uint8_t g_wide_2bpp[4] = { 0x00, 0x55, 0xaa, 0xff };
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxgl_widepixel
+ *
+ * Description:
+ *   Replicate a 32-bit pattern across a full machine word.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL >= 16
+static inline NXGL_WORD_T nxgl_widepixel(uint32_t pattern)
+{
+  NXGL_WORD_T wide = pattern;
+
+  /* Two 16-bit shifts avoid shifting by the full width of a 32-bit word */
+
+  if (NXGL_WORDSIZE > sizeof(uint32_t))
+    {
+      wide |= (wide << 16) << 16;
+    }
+
+  return wide;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxgl_fillwords
+ *
+ * Description:
+ *   Fill an aligned run of machine words with the same value.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL >= 16
+static inline FAR NXGL_WORD_T *nxgl_fillwords(FAR NXGL_WORD_T *wrun,
+                                              NXGL_WORD_T wide,
+                                              size_t nwords)
+{
+  /* Unroll the loop by four to amortize the loop overhead */
+
+  while (nwords >= 4)
+    {
+      wrun[0] = wide;
+      wrun[1] = wide;
+      wrun[2] = wide;
+      wrun[3] = wide;
+      wrun   += 4;
+      nwords -= 4;
+    }
+
+  while (nwords-- > 0)
+    {
+      *wrun++ = wide;
+    }
+
+  return wrun;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -159,35 +219,141 @@ static inline void nxgl_fillrun_8bpp(FAR uint8_t *run, nxgl_mxpixel_t color,
 static inline void nxgl_fillrun_16bpp(FAR uint16_t *run, nxgl_mxpixel_t color,
                                       size_t npixels)
 {
-  /* Fill the run with the color (it is okay to run a fractional byte overy the end */
+  FAR NXGL_WORD_T *wrun;
+  NXGL_WORD_T wide;
+  size_t nwords;
+
+  /* Store single pixels until the run is aligned to a word boundary */
+
+  while (npixels > 0 && !NXGL_WORDALIGNED(run))
+    {
+      *run++ = (uint16_t)color;
+      npixels--;
+    }
+
+  /* Then fill the aligned middle of the run one word at a time */
+
+  wide    = nxgl_widepixel((uint32_t)(uint16_t)color << 16 | (uint16_t)color);
+  nwords  = npixels / (NXGL_WORDSIZE / sizeof(uint16_t));
+  npixels = npixels % (NXGL_WORDSIZE / sizeof(uint16_t));
+  wrun    = nxgl_fillwords((FAR NXGL_WORD_T *)run, wide, nwords);
 
+  /* And finish any pixels left over at the end of the run */
+
+  run = (FAR uint16_t *)wrun;
   while (npixels-- > 0)
     {
       *run++ = (uint16_t)color;
     }
 }
 
-#elif NXGLIB_BITSPERPIXEL == 24
-static inline void nxgl_fillrun_24bpp(FAR uint32_t *run, nxgl_mxpixel_t color, size_t npixels)
+#elif NXGLIB_BITSPERPIXEL == 24 || NXGLIB_BITSPERPIXEL == 32
+static inline void nxgl_fillrun_32bpp(FAR uint32_t *run, nxgl_mxpixel_t color,
+                                      size_t npixels)
 {
-  /* Fill the run with the color (it is okay to run a fractional byte overy the end */
-#warning "Assuming 24-bit color is not packed"
+  FAR NXGL_WORD_T *wrun;
+  size_t nwords;
+
+  /* Store single pixels until the run is aligned to a word boundary */
+
+  while (npixels > 0 && !NXGL_WORDALIGNED(run))
+    {
+      *run++ = (uint32_t)color;
+      npixels--;
+    }
+
+  /* Then fill the aligned middle of the run one word at a time */
+
+  nwords  = npixels / (NXGL_WORDSIZE / sizeof(uint32_t));
+  npixels = npixels % (NXGL_WORDSIZE / sizeof(uint32_t));
+  wrun    = nxgl_fillwords((FAR NXGL_WORD_T *)run,
+                           nxgl_widepixel((uint32_t)color), nwords);
+
+  /* And finish any pixels left over at the end of the run */
+
+  run = (FAR uint32_t *)wrun;
   while (npixels-- > 0)
     {
       *run++ = (uint32_t)color;
     }
 }
 
-#elif NXGLIB_BITSPERPIXEL == 32
-static inline void nxgl_fillrun_32bpp(FAR uint32_t *run, nxgl_mxpixel_t color, size_t npixels)
+#if NXGLIB_BITSPERPIXEL == 24
+static inline void nxgl_fillrun_24bpp(FAR uint32_t *run, nxgl_mxpixel_t color,
+                                      size_t npixels)
 {
   /* Fill the run with the color (it is okay to run a fractional byte overy the end */
+#ifdef CONFIG_NX_LCDDRIVER
+#warning "Assuming 24-bit color is not packed"
+#endif
 
+  nxgl_fillrun_32bpp(run, color, npixels);
+}
+
+/****************************************************************************
+ * Name: nxgl_fillpacked_24bpp
+ *
+ * Description:
+ *   Fill a run of packed, 3-byte RGB pixels (as in framebuffer memory) with
+ *   the specified color.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_fillpacked_24bpp(FAR uint8_t *run, nxgl_mxpixel_t color,
+                                         size_t npixels)
+{
+  FAR uint32_t *wrun;
+  union
+  {
+    uint8_t  b[12];
+    uint32_t w[3];
+  } pattern;
+  int i;
+
+  /* Store single pixels until the run is 32-bit aligned.  Since the pixel
+   * size is odd, this requires at most three pixels.
+   */
+
+  while (npixels > 0 && ((uintptr_t)run & 3) != 0)
+    {
+      *run++ = color;
+      *run++ = color >> 8;
+      *run++ = color >> 16;
+      npixels--;
+    }
+
+  /* Four packed pixels occupy exactly three 32-bit words.  Build that
+   * pattern once in memory order and then store it three words at a time.
+   */
+
+  for (i = 0; i < 12; i += 3)
+    {
+      pattern.b[i]     = color;
+      pattern.b[i + 1] = color >> 8;
+      pattern.b[i + 2] = color >> 16;
+    }
+
+  wrun = (FAR uint32_t *)run;
+  while (npixels >= 4)
+    {
+      wrun[0]  = pattern.w[0];
+      wrun[1]  = pattern.w[1];
+      wrun[2]  = pattern.w[2];
+      wrun    += 3;
+      npixels -= 4;
+    }
+
+  /* And finish any pixels left over at the end of the run */
+
+  run = (FAR uint8_t *)wrun;
   while (npixels-- > 0)
     {
-      *run++ = (uint32_t)color;
+      *run++ = color;
+      *run++ = color >> 8;
+      *run++ = color >> 16;
     }
 }
+#endif
 #else
 #  error "Unsupported value of NXGLIB_BITSPERPIXEL"
 #endif
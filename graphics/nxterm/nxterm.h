@@ -61,10 +61,6 @@
 #define BMFLAGS_NOGLYPH    (1 << 0) /* No glyph available, use space */
 #define BM_ISSPACE(bm)     (((bm)->flags & BMFLAGS_NOGLYPH) != 0)
 
-/* Sizes and maximums */
-
-#define MAX_USECNT         255  /* Limit to range of a uint8_t */
-
 /* Device path formats */
 
 #define NX_DEVNAME_FORMAT  "/dev/nxterm%d"
@@ -111,18 +107,6 @@ struct nxterm_operations_s
                 unsigned int stride);
 };
 
-/* Describes one cached glyph bitmap */
-
-struct nxterm_glyph_s
-{
-  uint8_t code;                        /* Character code */
-  uint8_t height;                      /* Height of this glyph (in rows) */
-  uint8_t width;                       /* Width of this glyph (in pixels) */
-  uint8_t stride;                      /* Width of the glyph row (in bytes) */
-  uint8_t usecnt;                      /* Use count */
-  FAR uint8_t *bitmap;                 /* Allocated bitmap memory */
-};
-
 /* Describes on character on the display */
 
 struct nxterm_bitmap_s
@@ -139,6 +123,7 @@ struct nxterm_state_s
   FAR const struct nxterm_operations_s *ops; /* Window operations */
   FAR void *handle;                         /* The window handle */
   FAR struct nxterm_window_s wndo;           /* Describes the window and font */
+  FCACHE fcache;                            /* Font cache handle */
   NXHANDLE font;                            /* The current font handle */
   sem_t exclsem;                            /* Forces mutually exclusive access */
 #ifdef CONFIG_DEBUG
@@ -151,7 +136,6 @@ struct nxterm_state_s
   uint8_t fheight;                          /* Max height of a font in pixels */
   uint8_t fwidth;                           /* Max width of a font in pixels */
   uint8_t spwidth;                          /* The width of a space */
-  uint8_t maxglyphs;                        /* Size of the glyph[] array */
 
   uint16_t maxchars;                        /* Size of the bm[] array */
   uint16_t nchars;                          /* Number of chars in the bm[] array */
@@ -168,10 +152,6 @@ struct nxterm_state_s
   struct nxterm_bitmap_s cursor;
   struct nxterm_bitmap_s bm[CONFIG_NXTERM_MXCHARS];
 
-  /* Glyph cache data storage */
-
-  struct nxterm_glyph_s  glyph[CONFIG_NXTERM_CACHESIZE];
-
   /* Keyboard input support */
 
 #ifdef CONFIG_NXTERM_NXKBDIN
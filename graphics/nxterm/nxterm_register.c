@@ -107,15 +107,25 @@ FAR struct nxterm_state_s *
   sem_init(&priv->waitsem, 0, 0);
 #endif
 
-  /* Select the font */
+  /* Connect to the font cache for the configured font characteristics.
+   * The cache is shared with any other client using the same font and
+   * colors.
+   */
 
-  priv->font = nxf_getfonthandle(wndo->fontid);
-  if (!priv->font)
+  priv->fcache = nxf_cache_connect(wndo->fontid, wndo->fcolor[0],
+                                   wndo->wcolor[0], CONFIG_NXTERM_BPP,
+                                   CONFIG_NXTERM_CACHESIZE);
+  if (priv->fcache == NULL)
     {
-      gdbg("Failed to get font ID %d: %d\n", wndo->fontid, errno);
+      gdbg("Failed to connect to font cache for font ID %d: %d\n",
+           wndo->fontid, errno);
       goto errout;
     }
 
+  /* Get the handle of the font managed by the font cache */
+
+  priv->font = nxf_cache_getfonthandle(priv->fcache);
+
   FAR const struct nx_font_s *fontset;
 
   /* Get information about the font set being used and save this in the
@@ -131,10 +141,6 @@ FAR struct nxterm_state_s *
 
   priv->maxchars  = CONFIG_NXTERM_MXCHARS;
 
-  /* Set up the font glyph bitmap cache */
-
-  priv->maxglyphs = CONFIG_NXTERM_CACHESIZE;
-
   /* Set the initial display position */
 
   nxterm_home(priv);
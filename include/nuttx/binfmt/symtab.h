@@ -42,10 +42,19 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Parameters of the 32-bit FNV-1a hash used by symtab_hash().  The same hash
+ * is computed by tools/mksymtab.c when the -h option is used.
+ */
+
+#define SYMTAB_HASH_BASIS 2166136261u
+#define SYMTAB_HASH_PRIME 16777619u
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -62,12 +71,18 @@
  *    adding or removing entries from the symbol table (realloc might be
  *    used for that purpose if needed).  The intention is to support only
  *    fixed size arrays completely defined at compilation or link time.
+ *
+ * If CONFIG_SYMTAB_HASHED is selected, each entry also holds the value of
+ * symtab_hash() for its name and the table must be ordered by that value.
  */
 
 struct symtab_s
 {
   FAR const char *sym_name;          /* A pointer to the symbol name string */
   FAR const void *sym_value;         /* The value associated witht the string */
+#ifdef CONFIG_SYMTAB_HASHED
+  uint32_t sym_hash;                 /* symtab_hash(sym_name) */
+#endif
 };
 
 /****************************************************************************
@@ -152,6 +167,37 @@ FAR const struct symtab_s *
 symtab_findorderedbyname(FAR const struct symtab_s *symtab,
                          FAR const char *name, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name as stored in the sym_hash field of a
+ *   hashed symbol table.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.
+ *   This version assumes that table ordered with respect to the precomputed
+ *   sym_hash values (see CONFIG_SYMTAB_HASHED).
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHED
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms);
+#endif
+
 /****************************************************************************
  * Name: symtab_findbyvalue
  *
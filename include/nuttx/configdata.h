@@ -72,10 +72,20 @@
  *   ioctl argument:  Pointer to a config_data_s structure to receive the
  *                    config data.  All fields of the strucure must be
  *                    specified (i.e. id, instance, pointer and len).
+ *
+ * CFGDIOC_SETCONFIGS - Set several Config Data Items
+ *
+ *   ioctl argument:  Pointer to a config_batch_s structure that refers to
+ *                    an array of config_data_s structures, each set as for
+ *                    CFGDIOC_SETCONFIG.  With CONFIG_MTD_CONFIG_INDEX, the
+ *                    free space needed for all items is reserved (if
+ *                    necessary by consolidating once) before any item is
+ *                    written;  if it cannot be found, nothing is changed.
  */
 
 #define CFGDIOC_GETCONFIG  _CFGDIOC(1)
 #define CFGDIOC_SETCONFIG  _CFGDIOC(2)
+#define CFGDIOC_SETCONFIGS _CFGDIOC(3)
 
 /****************************************************************************
  * Public Types
@@ -91,6 +101,14 @@ struct config_data_s
   size_t      len;          /* Length of the config data buffer */
 };
 
+/* This structure is used to set several config data items at once */
+
+struct config_batch_s
+{
+  FAR struct config_data_s *items; /* Array of config data items */
+  size_t      nitems;       /* Number of items in the array */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -529,6 +529,34 @@ void files_releaselist(FAR struct filelist *list);
 int file_dup2(FAR struct file *filep1, FAR struct file *filep2);
 #endif
 
+/****************************************************************************
+ * Name: file_close_detached
+ *
+ * Description:
+ *   Close a file structure that is not a member of any task's list of open
+ *   files, such as one that was opened by file_dup2() in order to pass it
+ *   to another task.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int file_close_detached(FAR struct file *filep);
+#endif
+
+/****************************************************************************
+ * Name: file_attach
+ *
+ * Description:
+ *   Move an open file structure that is not a member of any task's list of
+ *   open files into the list of the current task.  Returns the new file
+ *   descriptor (>= minfd) or -EMFILE.  The file structure is cleared.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int file_attach(FAR struct file *filep, int minfd);
+#endif
+
 /* fs_filedup.c *************************************************************/
 /****************************************************************************
  * Name: fs_dupfd OR dup
@@ -211,6 +211,17 @@
                                            *      the block with specific debug
                                            *      command and data.
                                            * OUT: None.  */
+#define BIOC_FTLSTATS   _BIOC(0x000C)     /* Get log-structured FTL statistics
+                                           * IN:  Pointer to a writable
+                                           *      struct ftl_stats_s.
+                                           * OUT: Write amplification and wear
+                                           *      statistics.  */
+#define BIOC_RWBSTATS   _BIOC(0x000D)     /* Get read-ahead/write buffer
+                                           * statistics
+                                           * IN:  Pointer to a writable
+                                           *      struct rwb_stats_s.
+                                           * OUT: Buffer hit, coalescing and
+                                           *      flush statistics.  */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -141,6 +141,21 @@ struct mtd_byte_write_s
   const uint8_t *buffer;  /* Pointer to the data to write */
 };
 
+/* Statistics of the log-structured FTL returned by BIOC_FTLSTATS.  Write
+ * amplification is (nprogrammed + nsummary) / nwritten.
+ */
+
+struct ftl_stats_s
+{
+  uint32_t nwritten;      /* Sectors written by the client */
+  uint32_t nprogrammed;   /* Data pages programmed, including copies */
+  uint32_t nsummary;      /* Summary pages programmed */
+  uint32_t nerased;       /* Erase blocks erased */
+  uint32_t ncopied;       /* Valid pages copied by garbage collection */
+  uint32_t minec;         /* Lowest erase count of any erase block */
+  uint32_t maxec;         /* Highest erase count of any erase block */
+};
+
 /* This structure defines the interface to a simple memory technology device.
  * It will likely need to be extended in the future to support more complex
  * devices.
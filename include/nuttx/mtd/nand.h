@@ -54,6 +54,7 @@
 
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mtd/nand_raw.h>
+#include <nuttx/mtd/nand_scheme.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -73,6 +74,12 @@ struct nand_dev_s
   struct mtd_dev_s mtd;       /* Externally visible part of the driver */
   FAR struct nand_raw_s *raw; /* Retained reference to the lower half */
   sem_t exclsem;              /* For exclusive access to the NAND FLASH */
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  /* Spare area placement scheme with room for the BCH ECC */
+
+  struct nand_scheme_s scheme;
+#endif
 };
 
 /****************************************************************************
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * include/nuttx/mtd/nand_bch.h
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MTD_NAND_BCH_H
+#define __INCLUDE_NUTTX_MTD_NAND_BCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/mtd/nand_config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The BCH code works over the Galois field GF(2^13) and protects each
+ * 512-byte step of the page data with NANDBCH_ECCBYTES bytes of ECC.  Up to
+ * NANDBCH_T bit errors can be corrected in each step.
+ */
+
+#define NANDBCH_M            13
+#define NANDBCH_STEPSIZE     512
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH8
+#  define NANDBCH_T          8
+#else
+#  define NANDBCH_T          4
+#endif
+
+#define NANDBCH_ECCBITS      (NANDBCH_M * NANDBCH_T)
+#define NANDBCH_ECCBYTES     ((NANDBCH_ECCBITS + 7) / 8)
+
+/* Number of ECC bytes needed for one page of the given size */
+
+#define nandbch_eccsize(p)   (((p) / NANDBCH_STEPSIZE) * NANDBCH_ECCBYTES)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandbch_initialize
+ *
+ * Description:
+ *   Allocate and build the Galois field and encoder tables.  This must be
+ *   called before nandbch_compute() or nandbch_verify() is used.  Calling
+ *   it again has no effect.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Values:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nandbch_initialize(void);
+
+/****************************************************************************
+ * Name: nandbch_compute
+ *
+ * Description:
+ *   Computes the BCH codes for a data block whose size is multiple of
+ *   NANDBCH_STEPSIZE bytes.  Each step gets its own NANDBCH_ECCBYTES code.
+ *   The codes of an erased (all 0xff) step are all 0xff.
+ *
+ * Input Parameters:
+ *   data - Data to compute code for
+ *   size - Data size in bytes
+ *   code - Codes buffer
+ *
+ * Returned Values:
+ *   None
+ *
+ ****************************************************************************/
+
+void nandbch_compute(FAR const uint8_t *data, size_t size,
+                     FAR uint8_t *code);
+
+/****************************************************************************
+ * Name: nandbch_verify
+ *
+ * Description:
+ *   Verifies the BCH codes for a data block whose size is multiple of
+ *   NANDBCH_STEPSIZE bytes and corrects the data if possible.
+ *
+ * Input Parameters:
+ *   data - Data buffer to verify
+ *   size - Size of the data in bytes
+ *   code - Original codes
+ *
+ * Returned Values:
+ *   The number of bit errors that were corrected (zero if the data is
+ *   correct) or -EBADMSG if some step has more errors than can be
+ *   corrected.
+ *
+ ****************************************************************************/
+
+int nandbch_verify(FAR uint8_t *data, size_t size, FAR const uint8_t *code);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_MTD_NAND_SWECC_BCH */
+#endif /* __INCLUDE_NUTTX_MTD_NAND_BCH_H */
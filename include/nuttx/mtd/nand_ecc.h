@@ -51,6 +51,8 @@
 
 #include <stdint.h>
 
+#include <nuttx/mtd/nand_model.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -127,6 +129,30 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
                       unsigned int page,  FAR const void *data,
                       FAR void *spare);
 
+/****************************************************************************
+ * Name: nandecc_test
+ *
+ * Description:
+ *   Test the software ECC on a RAM model of a NAND device with the page
+ *   size, spare size, and spare area scheme of the given model.  Random
+ *   pages are written with nandecc_writepage() and their ECC is compared
+ *   with that of a bit-by-bit reference implementation.  Correctable and
+ *   uncorrectable bit errors are then injected into each step, and the
+ *   status of the driver is compared with that of the reference.
+ *
+ * Input parameters:
+ *   model - The NAND model
+ *
+ * Returned value.
+ *   OK is returned if the test passes; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_ECCTEST
+int nandecc_test(FAR const struct nand_model_s *model);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -313,6 +313,30 @@ void nandscheme_writeextra(FAR const struct nand_scheme_s *scheme,
 int nandscheme_build4086(FAR struct nand_scheme_s *scheme,
                          unsigned int spareSize, unsigned int eccOffset);
 
+/****************************************************************************
+ * Name: nandscheme_buildbch
+ *
+ * Description:
+ *   Build a scheme instance for the software BCH ECC.  The ECC bytes are
+ *   placed at the end of the spare area.  The bad block marker of the base
+ *   scheme is retained (along with the following byte if the marker is at
+ *   position 0) and all of the remaining bytes are extra bytes.
+ *
+ * Input Parameters:
+ *   scheme    Pointer to the nand_scheme_s instance to build.
+ *   base      The scheme of the NAND model.  May be NULL.
+ *   sparesize Size of spare area.
+ *   eccsize   Number of ECC bytes needed for one page.
+ *
+ * Returned Values:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nandscheme_buildbch(FAR struct nand_scheme_s *scheme,
+                        FAR const struct nand_scheme_s *base,
+                        unsigned int sparesize, unsigned int eccsize);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
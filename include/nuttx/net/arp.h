@@ -64,15 +64,6 @@
  * Public Types
  ****************************************************************************/
 
-/* One entry in the ARP table (volatile!) */
-
-struct arp_entry
-{
-  in_addr_t         at_ipaddr;   /* IP address */
-  struct ether_addr at_ethaddr;  /* Hardware address */
-  uint8_t           at_time;
-};
-
 /****************************************************************************
  * Public Data
  ****************************************************************************/
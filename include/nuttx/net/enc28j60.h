@@ -79,6 +79,10 @@ struct enc_stats_s
   uint32_t rxnotok;           /* PKTIF without RXSTAT_OK */
   uint32_t rxpktlen;          /* PKTIF with bad pktlen */
   uint32_t rxerifs;           /* RXERIF error evernts */
+  uint16_t maxburst;          /* Max. number of RX packets per interrupt */
+  uint32_t rxints;            /* RX polls started by an interrupt */
+  uint32_t rxpolls;           /* All RX polls, including interrupts */
+  uint32_t rxswitches;        /* Switches to RX polling mode */
 };
 #endif
 
@@ -83,7 +83,7 @@ enum net_lltype_e
 
 /* This defines a bitmap big enough for one bit for each socket option */
 
-typedef uint16_t sockopt_t;
+typedef uint32_t sockopt_t;
 
 /* This defines the storage size of a timeout value.  This effects only
  * range of supported timeout values.  With an LSB in seciseconds, the
@@ -149,6 +149,28 @@ typedef int (*netdev_callback_t)(FAR struct net_driver_s *dev, void *arg);
 
 typedef uint8_t net_lock_t; /* Not really used */
 
+/* Lock levels.  A thread may take a network lock only if every other
+ * network lock that it holds has a lower level.  Hence a driver takes its
+ * device lock before the stack lock, and the network stack never takes a
+ * device lock.
+ */
+
+#define NET_LOCKLEVEL_DEVICE 1  /* Per-device lock, see netdev_lock() */
+#define NET_LOCKLEVEL_STACK  2  /* The stack lock, see net_lock() */
+
+/* A re-entrant network lock */
+
+struct net_mutex_s
+{
+  sem_t    nm_sem;                      /* Exclusive access to the lock */
+  pid_t    nm_holder;                   /* Thread that holds the lock */
+  uint16_t nm_count;                    /* Re-entrance count of the holder */
+#ifdef CONFIG_NET_LOCK_DEBUG
+  uint8_t  nm_level;                    /* Lock level (NET_LOCKLEVEL_*) */
+  FAR struct net_mutex_s *nm_flink;     /* List of all network locks */
+#endif
+};
+
 #else
 
 /* Enable/disable locking for interrupt based logic:
@@ -234,6 +256,12 @@ void net_initialize(void);
  *   net_lockedwait()    - Like pthread_cond_wait(); releases the semaphore
  *                         momentarily to wait on another semaphore()
  *
+ * Network drivers may also serialize their own work with a per-device
+ * lock (see netdev_lock() in include/nuttx/net/netdev.h) and then need
+ * to hold the stack lock only while the network stack runs.  There are no
+ * per-connection locks:  The stack lock is still the one global lock that
+ * protects all sockets, connections, and protocol state.
+ *
  * Otherwise, interrupt based locking is used:
  *
  *   net_lock()          - Disables interrupts.
@@ -270,6 +298,25 @@ void net_unlock(net_lock_t flags);
 #  define net_unlock(f) irqrestore(f)
 #endif
 
+/****************************************************************************
+ * Function: net_mutex_initialize, net_mutex_destroy, net_mutex_lock and
+ *   net_mutex_unlock
+ *
+ * Description:
+ *   Manage a re-entrant network lock other than the stack lock.  The level
+ *   (NET_LOCKLEVEL_*) determines the order in which locks must be taken;
+ *   with CONFIG_NET_LOCK_DEBUG the order is verified whenever a lock is
+ *   taken.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NOINTS
+void net_mutex_initialize(FAR struct net_mutex_s *mutex, int level);
+void net_mutex_destroy(FAR struct net_mutex_s *mutex);
+net_lock_t net_mutex_lock(FAR struct net_mutex_s *mutex);
+void net_mutex_unlock(FAR struct net_mutex_s *mutex);
+#endif
+
 /****************************************************************************
  * Function: net_timedwait
  *
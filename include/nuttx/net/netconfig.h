@@ -349,12 +349,26 @@
 #  define CONFIG_NET_NACTIVESOCKETS (CONFIG_NET_TCP_CONNS + CONFIG_NET_UDP_CONNS)
 #endif
 
-/* The initial retransmission timeout counted in timer pulses.
+/* The initial retransmission timeout in milliseconds (RFC 6298).  This
+ * is used until the first round-trip time measurement is made.
  *
  * This should not be changed.
  */
 
-#define TCP_RTO 3
+#define TCP_RTO 1000
+
+/* The lower and upper bounds on the retransmission timeout in milliseconds.
+ * RFC 6298 recommends a minimum of one second;  a smaller value recovers
+ * more quickly from loss on a local network.
+ */
+
+#ifndef CONFIG_NET_TCP_RTO_MIN
+#  define CONFIG_NET_TCP_RTO_MIN 200
+#endif
+
+#ifndef CONFIG_NET_TCP_RTO_MAX
+#  define CONFIG_NET_TCP_RTO_MAX 60000
+#endif
 
 /* The maximum number of times a segment should be retransmitted
  * before the connection should be aborted.
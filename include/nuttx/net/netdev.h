@@ -50,6 +50,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <net/if.h>
 
 #include <net/ethernet.h>
@@ -61,11 +62,45 @@
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/net.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Per-device driver locking.  A driver that performs its work on a worker
+ * thread may serialize that work with netdev_lock() and then take the
+ * stack lock (net_lock()) only around the calls into the network stack,
+ * such as devif_input() or devif_poll().  Slow hardware accesses of the
+ * driver then do not hold the stack lock.  The device lock protects only
+ * the driver; all socket and connection state is still protected by the
+ * global stack lock.  The device lock must always be taken before the
+ * stack lock.
+ *
+ * If the network is driven from interrupt level, these simply disable
+ * interrupts like net_lock().
+ */
+
+#ifdef CONFIG_NET_NOINTS
+#  define netdev_lock(d)      net_mutex_lock(&(d)->d_lock)
+#  define netdev_unlock(d,f)  ((void)(f), net_mutex_unlock(&(d)->d_lock))
+#else
+#  define netdev_lock(d)      irqsave()
+#  define netdev_unlock(d,f)  irqrestore(f)
+#endif
+
+/* The default number of packets that a driver may receive per poll when
+ * budgeted receive polling is used.  See netdev_napi_poll().
+ */
+
+#ifndef CONFIG_NETDEV_NAPI_BUDGET
+#  define CONFIG_NETDEV_NAPI_BUDGET 16
+#endif
+
+/* True if the receive budget of the current poll has been used up */
+
+#define netdev_napi_exhausted(n) ((n)->nn_quota == 0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -215,6 +250,12 @@ struct net_driver_s
   FAR struct devif_callback_s *d_conncb;
   FAR struct devif_callback_s *d_devcb;
 
+#ifdef CONFIG_NET_NOINTS
+  /* Serializes the work of the driver.  See netdev_lock() */
+
+  struct net_mutex_s d_lock;
+#endif
+
   /* Driver callbacks */
 
   int (*d_ifup)(FAR struct net_driver_s *dev);
@@ -238,6 +279,40 @@ struct net_driver_s
 
 typedef int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+/* Budgeted receive polling.  A driver normally receives packets in
+ * response to an RX interrupt.  Under a heavy receive load, taking one
+ * interrupt (and scheduling one work item) per packet will consume all of
+ * the CPU.  Instead, the driver may leave its RX interrupt disabled and
+ * poll the hardware for a bounded number of packets (the budget) at a
+ * time.  The driver returns to interrupt mode when a poll finds fewer
+ * packets than the budget.
+ *
+ * All fields are protected by the device lock (see netdev_lock()).
+ */
+
+struct netdev_napi_s
+{
+  uint16_t nn_budget;           /* Max. number of packets per poll */
+  uint16_t nn_quota;            /* Packets remaining in the current poll */
+  uint16_t nn_burst;            /* Packets received since the interrupt */
+  bool     nn_polling;          /* True: Polling, RX interrupt disabled */
+
+  /* Statistics */
+
+  uint16_t nn_maxburst;         /* Max. number of packets per interrupt */
+  uint32_t nn_interrupts;       /* Number of polls started by an interrupt */
+  uint32_t nn_polls;            /* Number of polls, including interrupts */
+  uint32_t nn_packets;          /* Number of packets received */
+  uint32_t nn_switches;         /* Number of switches to polling mode */
+};
+
+/* Receive one packet from the hardware and dispatch it to the network.
+ * Returns a value > 0 if a packet was received, zero if there are no
+ * further packets, or a negated errno value on a failure.
+ */
+
+typedef int (*netdev_rxpoll_t)(FAR struct net_driver_s *dev);
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -417,6 +492,32 @@ void neighbor_out(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Budgeted receive polling
+ *
+ * Call netdev_napi_initialize() once to set the per-poll packet budget and
+ * to clear the statistics.
+ *
+ * Each time that the driver's receive worker runs, either because of an
+ * RX interrupt or because the driver is in polling mode, it calls
+ * netdev_napi_begin(), then calls netdev_napi_poll() one or more times to
+ * receive packets up to the budget, and finally calls
+ * netdev_napi_complete().  If netdev_napi_complete() returns true, the
+ * budget was used up:  The driver should leave its RX interrupt disabled
+ * and schedule the worker to run again.  Otherwise, the driver should
+ * re-enable its RX interrupt.
+ *
+ * These must be called with the device lock held.
+ *
+ ****************************************************************************/
+
+void netdev_napi_initialize(FAR struct netdev_napi_s *napi,
+                            unsigned int budget);
+void netdev_napi_begin(FAR struct netdev_napi_s *napi);
+int netdev_napi_poll(FAR struct net_driver_s *dev,
+                     FAR struct netdev_napi_s *napi, netdev_rxpoll_t rxpoll);
+bool netdev_napi_complete(FAR struct netdev_napi_s *napi);
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -443,6 +443,39 @@ struct nx_fontpackage_s
 #endif
 };
 
+/* An opaque handle to a cache of pre-rendered font glyphs */
+
+typedef FAR void *FCACHE;
+
+/* Describes one glyph that has been converted to the display pixel format
+ * and retained in a font cache.
+ */
+
+struct nxfonts_glyph_s
+{
+  FAR struct nxfonts_glyph_s *flink;   /* Implements a singly linked list */
+  uint8_t code;                        /* Character code */
+  uint8_t height;                      /* Height of this glyph (in rows) */
+  uint8_t width;                       /* Width of this glyph (in pixels) */
+  uint8_t stride;                      /* Width of the glyph row (in bytes) */
+  uint8_t refs;                        /* Number of users holding it */
+  FAR uint8_t bitmap[1];               /* Bitmap memory, actual size varies */
+};
+
+#define SIZEOF_NXFONTS_GLYPH_S(b) (sizeof(struct nxfonts_glyph_s) + (b) - 1)
+
+/* Font cache statistics returned by nxf_cache_getstats() */
+
+struct nxfonts_cachestats_s
+{
+  uint32_t hits;                       /* Glyphs found in the cache */
+  uint32_t misses;                     /* Glyphs that had to be rendered */
+  uint32_t evictions;                  /* Glyphs discarded to make space */
+  uint8_t  nglyphs;                    /* Number of glyphs currently cached */
+  uint8_t  maxglyphs;                  /* Maximum number of cached glyphs */
+  uint8_t  nclients;                   /* Number of clients sharing the cache */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -554,6 +587,135 @@ int nxf_convert_32bpp(FAR uint32_t *dest, uint16_t height,
                       FAR const struct nx_fontbitmap_s *bm,
                       nxgl_mxpixel_t color);
 
+/****************************************************************************
+ * Name: nxf_cache_connect
+ *
+ * Description:
+ *   Create a new font cache for the provided 'fontid' and colors or, if a
+ *   cache with the same font, colors, and pixel depth already exists, just
+ *   add a reference to that cache.  Clients that render text with the same
+ *   font and colors (such as NxTerm windows and NXTK toolbars) thus share
+ *   the same pre-rendered glyphs.
+ *
+ * Input Parameters:
+ *   fontid    - Identifies the font supported by this cache
+ *   fgcolor   - Foreground color
+ *   bgcolor   - Background color
+ *   bpp       - Bits per pixel
+ *   maxglyphs - Maximum number of glyphs permitted in the cache.  If the
+ *               cache already exists, the larger of the two sizes is used.
+ *
+ * Returned Value:
+ *   On success a non-NULL handle is returned that then may be used with
+ *   nxf_cache_getglyph() to obtain rendered font glyphs.  NULL is returned
+ *   on any failure with the errno value set to indicate the nature of the
+ *   failure.
+ *
+ ****************************************************************************/
+
+FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
+                         nxgl_mxpixel_t fgcolor, nxgl_mxpixel_t bgcolor,
+                         int bpp, int maxglyphs);
+
+/****************************************************************************
+ * Name: nxf_cache_disconnect
+ *
+ * Description:
+ *   Decrement the reference count on the font cache and, if the reference
+ *   count goes to zero, free all resources used by the font cache.  The
+ *   font handle is invalid upon return in either case.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by
+ *             nxf_cache_connect();
+ *
+ ****************************************************************************/
+
+void nxf_cache_disconnect(FCACHE fhandle);
+
+/****************************************************************************
+ * Name: nxf_cache_getfonthandle
+ *
+ * Description:
+ *   Return the handle to the font set used by this instance of the font
+ *   cache.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by
+ *             nxf_cache_connect();
+ *
+ * Returned Value:
+ *   The font set handle.  This is the same handle that would be returned
+ *   by nxf_getfonthandle() for the cached font ID.
+ *
+ ****************************************************************************/
+
+NXHANDLE nxf_cache_getfonthandle(FCACHE fhandle);
+
+/****************************************************************************
+ * Name: nxf_cache_getglyph
+ *
+ * Description:
+ *   Find the glyph for the specific character 'ch' in the list of pre-
+ *   rendered fonts in the font cache.  If it is not there, render the glyph
+ *   and add it to the cache, discarding the least recently used glyph if the
+ *   cache is full.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by
+ *             nxf_cache_connect();
+ *   ch      - The character code whose glyph is needed
+ *
+ * Returned Value:
+ *   On success a non-NULL pointer to the rendered glyph in the font cache
+ *   is returned.  NULL is returned if there is no glyph for the character
+ *   code or if the glyph could not be rendered.
+ *
+ *   The glyph is held in the cache and cannot be evicted by other clients
+ *   of the cache until it is released with nxf_cache_putglyph().
+ *
+ ****************************************************************************/
+
+FAR const struct nxfonts_glyph_s *nxf_cache_getglyph(FCACHE fhandle,
+                                                     uint8_t ch);
+
+/****************************************************************************
+ * Name: nxf_cache_putglyph
+ *
+ * Description:
+ *   Release a glyph obtained with nxf_cache_getglyph().  The glyph must not
+ *   be accessed after it has been released.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by
+ *             nxf_cache_connect();
+ *   glyph   - The glyph returned by nxf_cache_getglyph()
+ *
+ ****************************************************************************/
+
+void nxf_cache_putglyph(FCACHE fhandle,
+                        FAR const struct nxfonts_glyph_s *glyph);
+
+/****************************************************************************
+ * Name: nxf_cache_getstats
+ *
+ * Description:
+ *   Return the hit, miss, and eviction counts of the font cache.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by
+ *             nxf_cache_connect();
+ *   stats   - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int nxf_cache_getstats(FCACHE fhandle,
+                       FAR struct nxfonts_cachestats_s *stats);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
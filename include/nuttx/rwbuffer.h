@@ -67,6 +67,28 @@ typedef ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer,
 typedef ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
                               off_t startblock, size_t nblocks);
 
+/* Buffering statistics returned by rwb_getstats() and BIOC_RWBSTATS.  All
+ * block counts are in units of the rwbuffer block size.
+ */
+
+#ifdef CONFIG_DRVR_RWBSTATS
+struct rwb_stats_s
+{
+  uint32_t rhhits;       /* Blocks read from data already in the buffer */
+  uint32_t rhmisses;     /* Blocks read that required a reload */
+  uint32_t rhreloads;    /* Number of read-ahead buffer reloads */
+  uint32_t rhblocks;     /* Blocks loaded into the read-ahead buffer */
+  uint32_t wrblocks;     /* Blocks written into the write buffer */
+  uint32_t wrcoalesced;  /* Bytes overwritten while still buffered */
+  uint32_t wrflushes;    /* Number of calls to the flush callout */
+  uint32_t wrflushed;    /* Blocks written by the flush callout */
+  uint32_t wrfull;       /* Flushes because the write buffer was full */
+  uint32_t wrtimeout;    /* Flushes after CONFIG_DRVR_WRDELAY idle time */
+  uint32_t wrread;       /* Flushes because buffered blocks were read */
+  uint32_t wrlarge;      /* Flushes before a write larger than the buffer */
+};
+#endif
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -139,9 +161,8 @@ struct rwbuffer_s
   sem_t         wrsem;           /* Enforces exclusive access to the write buffer */
   struct work_s work;            /* Delayed work to flush buffer after a delay with no activity */
   uint8_t      *wrbuffer;        /* Allocated write buffer */
+  off_t        *wrblocks;        /* Block in each buffer slot (ascending) */
   uint16_t      wrnblocks;       /* Number of blocks in write buffer */
-  off_t         wrblockstart;    /* First block in write buffer */
-  off_t         wrexpectedblock; /* Next block expected */
 #endif
 
   /* This is the state of the read-ahead buffering */
@@ -150,7 +171,13 @@ struct rwbuffer_s
   sem_t         rhsem;           /* Enforces exclusive access to the write buffer */
   uint8_t      *rhbuffer;        /* Allocated read-ahead buffer */
   uint16_t      rhnblocks;       /* Number of blocks in read-ahead buffer */
+  uint16_t      rhdepth;         /* Number of blocks to read ahead */
   off_t         rhblockstart;    /* First block in read-ahead buffer */
+  off_t         rhnextblock;     /* Block following the last block read */
+#endif
+
+#ifdef CONFIG_DRVR_RWBSTATS
+  struct rwb_stats_s stats;      /* Buffering statistics */
 #endif
 };
 
@@ -202,6 +229,13 @@ int rwb_invalidate(FAR struct rwbuffer_s *rwb,
                    off_t startblock, size_t blockcount);
 #endif
 
+/* Statistics */
+
+#ifdef CONFIG_DRVR_RWBSTATS
+void rwb_getstats(FAR struct rwbuffer_s *rwb,
+                  FAR struct rwb_stats_s *stats);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -116,6 +117,13 @@
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
 
+/* Used only by recvmmsg().  All 16 bits above are already in use, so this
+ * shares the value of the send-only MSG_CONFIRM;  a larger value would not
+ * fit the int flags argument on targets with a 16-bit int.
+ */
+
+#define MSG_WAITFORONE 0x0800 /* Block only for the first message */
+
 /* Socket options */
 
 #define SO_DEBUG        0 /* Enables recording of debugging information (get/set).
@@ -150,11 +158,19 @@
 #define SO_SNDTIMEO    15 /* Sets the timeout value specifying the amount of time that an
                            * output function blocks because flow control prevents data from
                            * being sent(get/set). arg: struct timeval */
+#define SO_REUSEPORT   16 /* Allow several sockets to bind to the same address and
+                           * port.  Incoming datagrams are spread over the sockets
+                           * (get/set). arg: pointer to integer containing a
+                           * boolean value */
 
 /* Protocol levels supported by get/setsockopt(): */
 
 #define SOL_SOCKET     0  /* Only socket-level options supported */
 
+/* Types of socket-level control messages (ancillary data) */
+
+#define SCM_RIGHTS     1  /* Pass open file descriptors. data: array of int */
+
 /* Values for the 'how' argument of shutdown() */
 
 #define SHUT_RD        1  /* Bit 0: Disables further receive operations */
@@ -197,6 +213,68 @@ struct sockaddr
   char        sa_data[14];     /* 14-bytes of address data */
 };
 
+/* Describes one message for sendmsg(), recvmsg(), recvmmsg() and
+ * sendmmsg().  Ancillary data is supported only by sendmsg() and recvmsg()
+ * and only on sockets that implement it.  recvmmsg() and sendmmsg()
+ * ignore msg_control and msg_controllen.
+ */
+
+struct msghdr
+{
+  FAR void *msg_name;          /* Optional address */
+  socklen_t msg_namelen;       /* Size of address */
+  FAR struct iovec *msg_iov;   /* Scatter/gather array */
+  int msg_iovlen;              /* Number of elements in msg_iov */
+  FAR void *msg_control;       /* Ancillary data */
+  socklen_t msg_controllen;    /* Ancillary data buffer length */
+  int msg_flags;               /* Flags on received message */
+};
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;       /* Message header */
+  unsigned int  msg_len;       /* Number of bytes transferred */
+};
+
+/* Header of one control message in the msg_control buffer of a message.
+ * The data of the control message follows the aligned header.
+ */
+
+struct cmsghdr
+{
+  socklen_t cmsg_len;          /* Length including the header */
+  int cmsg_level;              /* Originating protocol (e.g. SOL_SOCKET) */
+  int cmsg_type;               /* Protocol-specific type (e.g. SCM_RIGHTS) */
+};
+
+/* Access to the control messages of a message */
+
+#define CMSG_ALIGN(len) \
+  (((len) + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1))
+
+#define CMSG_DATA(cmsg) \
+  ((FAR unsigned char *)(cmsg) + CMSG_ALIGN(sizeof(struct cmsghdr)))
+
+#define CMSG_SPACE(len) \
+  (CMSG_ALIGN(sizeof(struct cmsghdr)) + CMSG_ALIGN(len))
+
+#define CMSG_LEN(len) \
+  (CMSG_ALIGN(sizeof(struct cmsghdr)) + (len))
+
+#define CMSG_FIRSTHDR(mhdr) \
+  ((mhdr)->msg_controllen >= sizeof(struct cmsghdr) ? \
+   (FAR struct cmsghdr *)(mhdr)->msg_control : (FAR struct cmsghdr *)NULL)
+
+/* A header whose cmsg_len does not even cover itself ends the walk */
+
+#define CMSG_NXTHDR(mhdr, cmsg) \
+  ((cmsg)->cmsg_len < sizeof(struct cmsghdr) || \
+   (FAR char *)(cmsg) + CMSG_ALIGN((cmsg)->cmsg_len) + \
+   sizeof(struct cmsghdr) > \
+   (FAR char *)(mhdr)->msg_control + (mhdr)->msg_controllen ? \
+   (FAR struct cmsghdr *)NULL : \
+   (FAR struct cmsghdr *)((FAR char *)(cmsg) + CMSG_ALIGN((cmsg)->cmsg_len)))
+
 /* Used with the SO_LINGER socket option */
 
 struct linger
@@ -233,6 +311,15 @@ ssize_t recv(int sockfd, FAR void *buf, size_t len, int flags);
 ssize_t recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
                  FAR struct sockaddr *from, FAR socklen_t *fromlen);
 
+ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags);
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
+
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 int shutdown(int sockfd, int how);
 
 int setsockopt(int sockfd, int level, int option,
@@ -432,7 +432,11 @@
 #  define SYS_sendto                   (__SYS_network+8)
 #  define SYS_setsockopt               (__SYS_network+9)
 #  define SYS_socket                   (__SYS_network+10)
-#  define SYS_nnetsocket               (__SYS_network+11)
+#  define SYS_recvmmsg                 (__SYS_network+11)
+#  define SYS_sendmmsg                 (__SYS_network+12)
+#  define SYS_recvmsg                  (__SYS_network+13)
+#  define SYS_sendmsg                  (__SYS_network+14)
+#  define SYS_nnetsocket               (__SYS_network+15)
 #else
 #  define SYS_nnetsocket               __SYS_network
 #endif
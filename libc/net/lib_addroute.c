@@ -82,6 +82,7 @@ int addroute(int sockfd, FAR struct sockaddr_storage *target,
   entry.rt_target  = target;  /* Target address */
   entry.rt_netmask = netmask; /* Network mask defining the sub-net */
   entry.rt_router  = router;  /* Router address associated with the hop */
+  entry.rt_metric  = 0;       /* Preference among routes to the sub-net */
 
   /* Then perform the ioctl */
 
@@ -0,0 +1,717 @@
+/****************************************************************************
+ * libnx/nxfonts/nxfonts_cache.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT}
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING}
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nx/nxfonts.h>
+
+#include "nxcontext.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This describes a rendering function */
+
+typedef CODE int (*nxf_renderer_t)(FAR uint8_t *dest, uint16_t height,
+                                   uint16_t width, uint16_t stride,
+                                   FAR const struct nx_fontbitmap_s *bm,
+                                   nxgl_mxpixel_t color);
+
+/* This structure defines one font cache.  The glyphs are retained in a
+ * singly linked list ordered from the most recently used (head) to the
+ * least recently used (tail).
+ */
+
+struct nxfonts_fcache_s
+{
+  FAR struct nxfonts_fcache_s *flink;  /* Supports a singly linked list */
+  NXHANDLE font;                       /* Font handle associated with fontid */
+  sem_t fsem;                          /* Serializes access to the font cache */
+  uint16_t fclients;                   /* Number of connected clients */
+  uint8_t maxglyphs;                   /* Maximum number of cached glyphs */
+  uint8_t nglyphs;                     /* Current number of cached glyphs */
+  uint8_t bpp;                         /* Bits per pixel */
+  enum nx_fontid_e fontid;             /* ID of font in this cache */
+  nxgl_mxpixel_t fgcolor;              /* Foreground color */
+  nxgl_mxpixel_t bgcolor;              /* Background color */
+  nxf_renderer_t renderer;             /* Font renderer */
+  uint32_t hits;                       /* Number of cache hits */
+  uint32_t misses;                     /* Number of cache misses */
+  uint32_t evictions;                  /* Number of glyphs discarded */
+
+  /* Head of the list of cached glyphs (most recently used first) */
+
+  FAR struct nxfonts_glyph_s *head;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Head of a list of font caches */
+
+static FAR struct nxfonts_fcache_s *g_fcaches;
+static sem_t g_cachesem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxf_list_lock and nxf_list_unlock
+ *
+ * Description:
+ *   Get/relinquish exclusive access to the font cache list
+ *
+ ****************************************************************************/
+
+static void nxf_list_lock(void)
+{
+  /* Get exclusive access to the font cache */
+
+  while (sem_wait(&g_cachesem) < 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+}
+
+#define nxf_list_unlock() (sem_post(&g_cachesem))
+
+/****************************************************************************
+ * Name: nxf_cache_lock and nxf_cache_unlock
+ *
+ * Description:
+ *   Get/relinquish exclusive access to one font cache
+ *
+ ****************************************************************************/
+
+static void nxf_cache_lock(FAR struct nxfonts_fcache_s *priv)
+{
+  while (sem_wait(&priv->fsem) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+}
+
+#define nxf_cache_unlock(p) (sem_post(&(p)->fsem))
+
+/****************************************************************************
+ * Name: nxf_getrenderer
+ *
+ * Description:
+ *   Select the font renderer for the pixel depth.  Packed 24-bit pixels are
+ *   not yet supported by the renderers.
+ *
+ ****************************************************************************/
+
+static nxf_renderer_t nxf_getrenderer(int bpp)
+{
+  switch (bpp)
+    {
+#ifndef CONFIG_NX_DISABLE_1BPP
+      case 1:
+        return (nxf_renderer_t)nxf_convert_1bpp;
+#endif
+#ifndef CONFIG_NX_DISABLE_2BPP
+      case 2:
+        return (nxf_renderer_t)nxf_convert_2bpp;
+#endif
+#ifndef CONFIG_NX_DISABLE_4BPP
+      case 4:
+        return (nxf_renderer_t)nxf_convert_4bpp;
+#endif
+#ifndef CONFIG_NX_DISABLE_8BPP
+      case 8:
+        return (nxf_renderer_t)nxf_convert_8bpp;
+#endif
+#ifndef CONFIG_NX_DISABLE_16BPP
+      case 16:
+        return (nxf_renderer_t)nxf_convert_16bpp;
+#endif
+#ifndef CONFIG_NX_DISABLE_32BPP
+      case 32:
+        return (nxf_renderer_t)nxf_convert_32bpp;
+#endif
+      default:
+        return NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: nxf_fillglyph
+ *
+ * Description:
+ *   Initialize the glyph memory to the background color.
+ *
+ ****************************************************************************/
+
+static void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
+                          FAR struct nxfonts_glyph_s *glyph)
+{
+  int row;
+  int col;
+
+  if (priv->bpp < 8)
+    {
+      uint8_t pixel = (uint8_t)priv->bgcolor;
+
+      /* Pack 1-bit pixels into a 2-bits */
+
+      if (priv->bpp == 1)
+        {
+          pixel &= 0x01;
+          pixel  = (pixel) << 1 | pixel;
+        }
+
+      /* Pack 2-bit pixels into a nibble */
+
+      if (priv->bpp < 4)
+        {
+          pixel &= 0x03;
+          pixel  = (pixel) << 2 | pixel;
+        }
+
+      /* Pack 4-bit nibbles into a byte */
+
+      pixel &= 0x0f;
+      pixel  = (pixel) << 4 | pixel;
+
+      memset(glyph->bitmap, pixel, glyph->stride * glyph->height);
+    }
+  else if (priv->bpp == 8)
+    {
+      memset(glyph->bitmap, (uint8_t)priv->bgcolor,
+             glyph->stride * glyph->height);
+    }
+  else if (priv->bpp == 16)
+    {
+      FAR uint16_t *ptr = (FAR uint16_t *)glyph->bitmap;
+
+      for (row = 0; row < glyph->height; row++)
+        {
+          for (col = 0; col < glyph->width; col++)
+            {
+              *ptr++ = (uint16_t)priv->bgcolor;
+            }
+        }
+    }
+  else /* if (priv->bpp == 32) */
+    {
+      FAR uint32_t *ptr = (FAR uint32_t *)glyph->bitmap;
+
+      for (row = 0; row < glyph->height; row++)
+        {
+          for (col = 0; col < glyph->width; col++)
+            {
+              *ptr++ = (uint32_t)priv->bgcolor;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxf_renderglyph
+ *
+ * Description:
+ *   Allocate memory for a new glyph and render the font bitmap into it.
+ *
+ ****************************************************************************/
+
+static FAR struct nxfonts_glyph_s *
+nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
+                FAR const struct nx_fontbitmap_s *fbm, uint8_t ch)
+{
+  FAR struct nxfonts_glyph_s *glyph;
+  uint8_t height;
+  uint8_t width;
+  uint8_t stride;
+  int bmsize;
+  int ret;
+
+  /* Get the dimensions of the glyph and the physical width of the glyph in
+   * bytes.
+   */
+
+  width  = fbm->metric.width + fbm->metric.xoffset;
+  height = fbm->metric.height + fbm->metric.yoffset;
+  stride = (width * priv->bpp + 7) >> 3;
+
+  /* Allocate the glyph with memory to hold the bitmap and its offsets */
+
+  bmsize = stride * height;
+  glyph  = (FAR struct nxfonts_glyph_s *)
+    lib_malloc(SIZEOF_NXFONTS_GLYPH_S(bmsize));
+
+  if (glyph != NULL)
+    {
+      glyph->flink  = NULL;
+      glyph->code   = ch;
+      glyph->height = height;
+      glyph->width  = width;
+      glyph->stride = stride;
+      glyph->refs   = 0;
+
+      /* Initialize the glyph memory to the background color and then
+       * render the glyph into the allocated memory.
+       */
+
+      nxf_fillglyph(priv, glyph);
+
+      ret = priv->renderer(glyph->bitmap, glyph->height, glyph->width,
+                           glyph->stride, fbm, priv->fgcolor);
+      if (ret < 0)
+        {
+          /* Actually, the renderer never returns a failure */
+
+          gdbg("ERROR: nxf_renderglyph: Renderer failed\n");
+          lib_free(glyph);
+          glyph = NULL;
+        }
+    }
+
+  return glyph;
+}
+
+/****************************************************************************
+ * Name: nxf_evictglyph
+ *
+ * Description:
+ *   Remove and free the least recently used glyph that is not currently
+ *   held by a client of the cache.  Returns false if every cached glyph is
+ *   in use.
+ *
+ ****************************************************************************/
+
+static bool nxf_evictglyph(FAR struct nxfonts_fcache_s *priv)
+{
+  FAR struct nxfonts_glyph_s *glyph;
+  FAR struct nxfonts_glyph_s *prev;
+  FAR struct nxfonts_glyph_s *victim;
+  FAR struct nxfonts_glyph_s *vprev;
+
+  /* Find the last (least recently used) glyph that is not in use */
+
+  for (prev = NULL, victim = NULL, vprev = NULL, glyph = priv->head;
+       glyph != NULL;
+       prev = glyph, glyph = glyph->flink)
+    {
+      if (glyph->refs == 0)
+        {
+          victim = glyph;
+          vprev  = prev;
+        }
+    }
+
+  if (victim == NULL)
+    {
+      return false;
+    }
+
+  if (vprev != NULL)
+    {
+      vprev->flink = victim->flink;
+    }
+  else
+    {
+      priv->head = victim->flink;
+    }
+
+  lib_free(victim);
+  priv->nglyphs--;
+  priv->evictions++;
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxf_findcache
+ *
+ * Description:
+ *   Find a font cache tht matches the font charcteristics.  The caller must
+ *   hold the cache list lock.
+ *
+ ****************************************************************************/
+
+static FAR struct nxfonts_fcache_s *
+nxf_findcache(enum nx_fontid_e fontid, nxgl_mxpixel_t fgcolor,
+              nxgl_mxpixel_t bgcolor, int bpp)
+{
+  FAR struct nxfonts_fcache_s *fcache;
+
+  for (fcache = g_fcaches; fcache != NULL; fcache = fcache->flink)
+    {
+      if (fcache->fontid == fontid && fcache->fgcolor == fgcolor &&
+          fcache->bgcolor == bgcolor && fcache->bpp == bpp)
+        {
+          return fcache;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxf_cache_connect
+ *
+ * Description:
+ *   Create a new font cache for the provided 'fontid' and colors or, if a
+ *   cache with the same font, colors, and pixel depth already exists, just
+ *   add a reference to that cache.
+ *
+ ****************************************************************************/
+
+FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
+                         nxgl_mxpixel_t fgcolor, nxgl_mxpixel_t bgcolor,
+                         int bpp, int maxglyphs)
+{
+  FAR struct nxfonts_fcache_s *priv;
+  int errcode;
+
+  DEBUGASSERT(maxglyphs > 0);
+  if (maxglyphs > UINT8_MAX)
+    {
+      maxglyphs = UINT8_MAX;
+    }
+
+  /* Get exclusive access to the font cache list */
+
+  nxf_list_lock();
+
+  /* Find a font cache with the matching font characteristics */
+
+  priv = nxf_findcache(fontid, fgcolor, bgcolor, bpp);
+  if (priv == NULL)
+    {
+      /* There isn't one... we will have to create a new font cache for this
+       * client.
+       */
+
+      priv = (FAR struct nxfonts_fcache_s *)
+        lib_zalloc(sizeof(struct nxfonts_fcache_s));
+
+      if (priv == NULL)
+        {
+          errcode = ENOMEM;
+          goto errout_with_lock;
+        }
+
+      /* Initialize the font cache */
+
+      priv->maxglyphs = maxglyphs;
+      priv->fontid    = fontid;
+      priv->fgcolor   = fgcolor;
+      priv->bgcolor   = bgcolor;
+      priv->bpp       = bpp;
+
+      /* Select the rendering function */
+
+      priv->renderer  = nxf_getrenderer(bpp);
+      if (priv->renderer == NULL)
+        {
+          gdbg("ERROR: Unsupported pixel depth: %d\n", bpp);
+          errcode = ENOSYS;
+          goto errout_with_fcache;
+        }
+
+      /* Select the font */
+
+      priv->font = nxf_getfonthandle(fontid);
+      if (priv->font == NULL)
+        {
+          errcode = get_errno();
+          gdbg("ERROR: Failed to get font ID %d: %d\n", fontid, errcode);
+          goto errout_with_fcache;
+        }
+
+      sem_init(&priv->fsem, 0, 1);
+
+      /* Add the new font cache to the list of font caches */
+
+      priv->flink = g_fcaches;
+      g_fcaches   = priv;
+    }
+
+  /* A larger cache may be requested by a client that joins later */
+
+  else if (priv->maxglyphs < maxglyphs)
+    {
+      priv->maxglyphs = maxglyphs;
+    }
+
+  /* Add the reference on behalf of this client */
+
+  priv->fclients++;
+  nxf_list_unlock();
+  return (FCACHE)priv;
+
+errout_with_fcache:
+  lib_free(priv);
+errout_with_lock:
+  nxf_list_unlock();
+  set_errno(errcode);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nxf_cache_disconnect
+ *
+ * Description:
+ *   Decrement the reference count on the font cache and, if the reference
+ *   count goes to zero, free all resources used by the font cache.
+ *
+ ****************************************************************************/
+
+void nxf_cache_disconnect(FCACHE fhandle)
+{
+  FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
+  FAR struct nxfonts_fcache_s *fcache;
+  FAR struct nxfonts_fcache_s *prev;
+  FAR struct nxfonts_glyph_s *glyph;
+  FAR struct nxfonts_glyph_s *next;
+
+  DEBUGASSERT(priv != NULL && priv->fclients > 0);
+
+  nxf_list_lock();
+
+  /* Is this the last client of the font cache? */
+
+  if (priv->fclients <= 1)
+    {
+      /* Yes.. remove the font cache from the list of font caches */
+
+      for (prev = NULL, fcache = g_fcaches;
+           fcache != NULL && fcache != priv;
+           prev = fcache, fcache = fcache->flink);
+
+      DEBUGASSERT(fcache == priv);
+      if (prev != NULL)
+        {
+          prev->flink = priv->flink;
+        }
+      else
+        {
+          g_fcaches = priv->flink;
+        }
+
+      /* Free all allocated glyph memory */
+
+      for (glyph = priv->head; glyph != NULL; glyph = next)
+        {
+          next = glyph->flink;
+          lib_free(glyph);
+        }
+
+      /* Destroy the serializing semaphore and free the font cache */
+
+      sem_destroy(&priv->fsem);
+      lib_free(priv);
+    }
+  else
+    {
+      /* No.. just decrement the number of clients connected to the cache */
+
+      priv->fclients--;
+    }
+
+  nxf_list_unlock();
+}
+
+/****************************************************************************
+ * Name: nxf_cache_getfonthandle
+ *
+ * Description:
+ *   Return the handle to the font set used by this instance of the font
+ *   cache.
+ *
+ ****************************************************************************/
+
+NXHANDLE nxf_cache_getfonthandle(FCACHE fhandle)
+{
+  FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
+
+  DEBUGASSERT(priv != NULL && priv->font != NULL);
+  return priv->font;
+}
+
+/****************************************************************************
+ * Name: nxf_cache_getglyph
+ *
+ * Description:
+ *   Find the glyph for the specific character 'ch' in the list of pre-
+ *   rendered fonts in the font cache.  If it is not there, render the glyph
+ *   and add it to the cache.
+ *
+ ****************************************************************************/
+
+FAR const struct nxfonts_glyph_s *nxf_cache_getglyph(FCACHE fhandle,
+                                                     uint8_t ch)
+{
+  FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
+  FAR struct nxfonts_glyph_s *glyph;
+  FAR struct nxfonts_glyph_s *prev;
+  FAR const struct nx_fontbitmap_s *fbm;
+
+  DEBUGASSERT(priv != NULL);
+  nxf_cache_lock(priv);
+
+  /* First, try to find the glyph in the cache of pre-rendered glyphs */
+
+  for (prev = NULL, glyph = priv->head;
+       glyph != NULL && glyph->code != ch;
+       prev = glyph, glyph = glyph->flink);
+
+  if (glyph != NULL)
+    {
+      /* We found it in the cache.  Move it to the head of the list so that
+       * it will be the last one to be evicted.
+       */
+
+      if (prev != NULL)
+        {
+          prev->flink  = glyph->flink;
+          glyph->flink = priv->head;
+          priv->head   = glyph;
+        }
+
+      priv->hits++;
+    }
+  else
+    {
+      /* No, it is not cached... Does the code map to a font? */
+
+      priv->misses++;
+
+      fbm = nxf_getbitmap(priv->font, ch);
+      if (fbm != NULL)
+        {
+          /* Yes.. make space for the new glyph and render it */
+
+          /* Glyphs still held by other clients cannot be evicted.  If all
+           * of them are held, the cache temporarily grows beyond maxglyphs
+           * and is trimmed again on a later miss.
+           */
+
+          while (priv->nglyphs >= priv->maxglyphs && nxf_evictglyph(priv));
+
+          glyph = nxf_renderglyph(priv, fbm, ch);
+          if (glyph != NULL)
+            {
+              glyph->flink = priv->head;
+              priv->head   = glyph;
+              priv->nglyphs++;
+            }
+        }
+    }
+
+  /* Hold the glyph until the caller releases it */
+
+  if (glyph != NULL)
+    {
+      glyph->refs++;
+    }
+
+  nxf_cache_unlock(priv);
+  return glyph;
+}
+
+/****************************************************************************
+ * Name: nxf_cache_putglyph
+ *
+ * Description:
+ *   Release a glyph obtained with nxf_cache_getglyph().
+ *
+ ****************************************************************************/
+
+void nxf_cache_putglyph(FCACHE fhandle,
+                        FAR const struct nxfonts_glyph_s *glyph)
+{
+  FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
+
+  DEBUGASSERT(priv != NULL && glyph != NULL && glyph->refs > 0);
+
+  nxf_cache_lock(priv);
+  ((FAR struct nxfonts_glyph_s *)glyph)->refs--;
+  nxf_cache_unlock(priv);
+}
+
+/****************************************************************************
+ * Name: nxf_cache_getstats
+ *
+ * Description:
+ *   Return the hit, miss, and eviction counts of the font cache.
+ *
+ ****************************************************************************/
+
+int nxf_cache_getstats(FCACHE fhandle,
+                       FAR struct nxfonts_cachestats_s *stats)
+{
+  FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
+
+  if (priv == NULL || stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+  nxf_cache_lock(priv);
+  stats->hits      = priv->hits;
+  stats->misses    = priv->misses;
+  stats->evictions = priv->evictions;
+  stats->nglyphs   = priv->nglyphs;
+  stats->maxglyphs = priv->maxglyphs;
+  stats->nclients  = priv->fclients > UINT8_MAX ? UINT8_MAX : priv->fclients;
+  nxf_cache_unlock(priv);
+
+  return OK;
+}
@@ -260,6 +260,38 @@ int NXF_FUNCNAME(nxf_convert,NXFONTS_SUFFIX)
         {
           bmbyte = *sptr++;
 
+          /* Handle runs of eight transparent or eight set pixels without
+           * examining each bit.  These are very common in glyph bitmaps.
+           */
+
+          if (col + 8 <= width)
+            {
+              if (bmbyte == 0x00)
+                {
+                  /* Skip over eight transparent pixels */
+
+                  dptr += 8;
+                  col  += 8;
+                  continue;
+                }
+              else if (bmbyte == 0xff)
+                {
+                  /* Set eight pixels to 'color' */
+
+                  dptr[0] = color;
+                  dptr[1] = color;
+                  dptr[2] = color;
+                  dptr[3] = color;
+                  dptr[4] = color;
+                  dptr[5] = color;
+                  dptr[6] = color;
+                  dptr[7] = color;
+                  dptr   += 8;
+                  col    += 8;
+                  continue;
+                }
+            }
+
           /* Process each bit in the byte */
 
           for (bmbit = 7; bmbit >= 0 && col < width; bmbit--, col++)
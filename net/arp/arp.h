@@ -53,12 +53,15 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
 #include <netinet/in.h>
 
 #include <nuttx/net/netdev.h>
 
+#include "neighbor/neighbor.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -172,6 +175,12 @@ struct arp_notify_s
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_ARP
+/* The ARP table.  The network must be locked when accessing the table. */
+
+extern struct neighbor_cache_s g_arp_cache;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -187,34 +196,13 @@ struct arp_notify_s
 
 void arp_reset(void);
 
-/****************************************************************************
- * Function: arp_timer_initialize
- *
- * Description:
- *   Initialized the 10 second timer that is need by the ARP logic in order
- *   to age ARP address associations
- *
- * Parameters:
- *   None
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   Called once at system initialization time
- *
- ****************************************************************************/
-
-void arp_timer_initialize(void);
-
 /****************************************************************************
  * Name: arp_timer
  *
  * Description:
- *   This function performs periodic timer processing in the ARP module
- *   and should be called at regular intervals.  The recommended interval
- *   is 10 seconds between the calls.  It is responsible for flushing old
- *   entries in the ARP table.
+ *   This function performs periodic timer processing in the ARP module.
+ *   It is called from the network device timer poll.  It is responsible
+ *   for flushing old entries in the ARP table.
  *
  ****************************************************************************/
 
@@ -380,13 +368,17 @@ void arp_notify(in_addr_t ipaddr);
  * Input parameters:
  *   ipaddr - Refers to an IP address in network order
  *
+ * Returned Value:
+ *   The ARP table entry or NULL if the address is not resolved.  The
+ *   Ethernet address is in ne_lladdr.eth.
+ *
  * Assumptions
- *   Interrupts are disabled; Returned value will become unstable when
- *   interrupts are re-enabled or if any other uIP APIs are called.
+ *   The network is locked; Returned value will become unstable when the
+ *   network is unlocked or if any other uIP APIs are called.
  *
  ****************************************************************************/
 
-FAR struct arp_entry *arp_find(in_addr_t ipaddr);
+FAR struct neighbor_entry_s *arp_find(in_addr_t ipaddr);
 
 /****************************************************************************
  * Name: arp_delete
@@ -398,19 +390,60 @@ FAR struct arp_entry *arp_find(in_addr_t ipaddr);
  *   ipaddr - Refers to an IP address in network order
  *
  * Assumptions
- *   Interrupts are disabled to assure exclusive access to the ARP table
- *   (and because arp_find() is called).
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_delete(in_addr_t ipaddr);
+
+/****************************************************************************
+ * Name: arp_enqueue
+ *
+ * Description:
+ *   Called by arp_out() when the outgoing IPv4 packet in d_buf is about to
+ *   be replaced with an ARP request.  The ARP table entry for the address
+ *   is marked as INCOMPLETE and a copy of the packet is retained.
+ *
+ * Input parameters:
+ *   dev    - The device with the outgoing IPv4 packet in d_buf
+ *   ipaddr - The IP address being resolved, in network order
+ *
+ * Assumptions
+ *   The network is locked.
  *
  ****************************************************************************/
 
-#define arp_delete(ipaddr) \
-{ \
-  struct arp_entry *tabptr = arp_find(ipaddr); \
-  if (tabptr) \
-    { \
-      tabptr->at_ipaddr = 0; \
-    } \
-}
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+void arp_enqueue(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#else
+#  define arp_enqueue(d,i)
+#endif
+
+/****************************************************************************
+ * Name: arp_dequeue
+ *
+ * Description:
+ *   Called by arp_arpin() when an ARP reply has been received.  If a
+ *   packet was queued awaiting resolution of the IP address, it is copied
+ *   into d_buf (after the Ethernet header) and d_len is set to its length.
+ *
+ * Input parameters:
+ *   dev    - The device that received the ARP reply
+ *   ipaddr - The IP address that has been resolved, in network order
+ *
+ * Returned Value:
+ *   true if a queued packet was placed in d_buf.
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+bool arp_dequeue(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#else
+#  define arp_dequeue(d,i) (false)
+#endif
 
 /****************************************************************************
  * Name: arp_update
@@ -424,7 +457,7 @@ FAR struct arp_entry *arp_find(in_addr_t ipaddr);
  *   ethaddr - Refers to a HW address uint8_t[IFHWADDRLEN]
  *
  * Assumptions
- *   Interrupts are disabled to assure exclusive access to the ARP table.
+ *   The network is locked.
  *
  ****************************************************************************/
 
@@ -455,7 +488,6 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 /* If ARP is disabled, stub out all ARP interfaces */
 
 #  define arp_reset()
-#  define arp_timer_initialize()
 #  define arp_timer()
 #  define arp_format(d,i);
 #  define arp_send(i) (0)
@@ -466,6 +498,8 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_notify(i)
 #  define arp_find(i) (NULL)
 #  define arp_delete(i)
+#  define arp_enqueue(d,i)
+#  define arp_dequeue(d,i) (false)
 #  define arp_update(i,m);
 #  define arp_dump(arp)
 
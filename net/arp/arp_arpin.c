@@ -99,6 +99,10 @@
  *   is zero, no packet should be sent; If d_len is non-zero, it contains the
  *   length of the outbound packet that is present in the d_buf[] buffer.
  *
+ *   If CONFIG_NET_NEIGHBOR_QUEUE is selected and an IP packet was waiting
+ *   for the address in an ARP reply, that packet (with its Ethernet header)
+ *   is returned in d_buf[] to be sent.
+ *
  ****************************************************************************/
 
 void arp_arpin(FAR struct net_driver_s *dev)
@@ -166,6 +170,15 @@ void arp_arpin(FAR struct net_driver_s *dev)
             /* Then notify any logic waiting for the ARP result */
 
             arp_notify(net_ip4addr_conv32(arp->ah_sipaddr));
+
+            /* If an IP packet was waiting for this address, it replaces
+             * the ARP reply in d_buf and is sent now.
+             */
+
+            if (arp_dequeue(dev, net_ip4addr_conv32(arp->ah_sipaddr)))
+              {
+                arp_out(dev);
+              }
           }
         break;
     }
@@ -123,7 +123,8 @@ static const uint8_t g_multicast_ethaddr[3] = {0x01, 0x00, 0x5e};
  *   packet in the d_buf[] is replaced by an ARP request packet for the
  *   IP address. The IP packet is dropped and it is assumed that the
  *   higher level protocols (e.g., TCP) eventually will retransmit the
- *   dropped packet.
+ *   dropped packet (unless CONFIG_NET_NEIGHBOR_QUEUE is selected, in which
+ *   case it is sent when the ARP reply is received).
  *
  *   Upon return in either the case, a packet to be sent is present in the
  *   d_buf[] buffer and the d_len field holds the length of the Ethernet
@@ -133,7 +134,7 @@ static const uint8_t g_multicast_ethaddr[3] = {0x01, 0x00, 0x5e};
 
 void arp_out(FAR struct net_driver_s *dev)
 {
-  FAR const struct arp_entry *tabptr = NULL;
+  FAR struct neighbor_entry_s *tabptr = NULL;
   FAR struct eth_hdr_s       *peth   = ETHBUF;
   FAR struct arp_iphdr_s     *pip    = IPBUF;
   in_addr_t                   ipaddr;
@@ -230,6 +231,12 @@ void arp_out(FAR struct net_driver_s *dev)
         {
            nllvdbg("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
+          /* Keep a copy of the IP packet so that it can be sent when the
+           * ARP reply is received (if CONFIG_NET_NEIGHBOR_QUEUE).
+           */
+
+          arp_enqueue(dev, ipaddr);
+
           /* The destination address was not in our ARP table, so we
            * overwrite the IP packet with an ARP request.
            */
@@ -241,7 +248,8 @@ void arp_out(FAR struct net_driver_s *dev)
 
       /* Build an Ethernet header. */
 
-      memcpy(peth->dest, tabptr->at_ethaddr.ether_addr_octet, ETHER_ADDR_LEN);
+      memcpy(peth->dest, tabptr->ne_lladdr.eth.ether_addr_octet,
+             ETHER_ADDR_LEN);
     }
 
   /* Finish populating the Ethernet header */
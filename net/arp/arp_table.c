@@ -47,18 +47,21 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
 #include <netinet/in.h>
 #include <net/ethernet.h>
+#include <net/if.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/ip.h>
 
-#include <arp/arp.h>
+#include "neighbor/neighbor.h"
+#include "arp/arp.h"
 
 #ifdef CONFIG_NET_ARP
 
@@ -66,23 +69,29 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/****************************************************************************
- * Private Types
- ****************************************************************************/
+/* CONFIG_NET_ARP_MAXAGE is in units of 10 seconds */
+
+#define ARP_MAXAGE_SEC (10 * CONFIG_NET_ARP_MAXAGE)
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* The table of known address mappings */
+/* Storage for the ARP table entries and hash chains */
 
-static struct arp_entry g_arptable[CONFIG_NET_ARPTAB_SIZE];
-static uint8_t g_arptime;
+static struct neighbor_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static FAR struct neighbor_entry_s *g_arphash[CONFIG_NET_ARPTAB_SIZE];
 
 /****************************************************************************
- * Private Functions
+ * Public Data
  ****************************************************************************/
 
+/* The table of known address mappings.  The network must be locked when
+ * accessing the table.
+ */
+
+struct neighbor_cache_s g_arp_cache;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -97,41 +106,24 @@ static uint8_t g_arptime;
 
 void arp_reset(void)
 {
-  int i;
-
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-    {
-      memset(&g_arptable[i].at_ipaddr, 0, sizeof(in_addr_t));
-    }
+  neighbor_cache_initialize(&g_arp_cache, g_arptable, g_arphash,
+                            CONFIG_NET_ARPTAB_SIZE, sizeof(in_addr_t),
+                            ARP_MAXAGE_SEC);
 }
 
 /****************************************************************************
  * Name: arp_timer
  *
  * Description:
- *   This function performs periodic timer processing in the ARP module
- *   and should be called at regular intervals. The recommended interval
- *   is 10 seconds between the calls.  It is responsible for flushing old
- *   entries in the ARP table.
+ *   This function performs periodic timer processing in the ARP module.
+ *   It is called from the network device timer poll.  It is responsible
+ *   for flushing old entries in the ARP table.
  *
  ****************************************************************************/
 
 void arp_timer(void)
 {
-  FAR struct arp_entry *tabptr;
-  int i;
-
-  ++g_arptime;
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-    {
-      tabptr = &g_arptable[i];
-
-      if (tabptr->at_ipaddr != 0 &&
-          g_arptime - tabptr->at_time >= CONFIG_NET_ARP_MAXAGE)
-        {
-          tabptr->at_ipaddr = 0;
-        }
-    }
+  neighbor_cache_age(&g_arp_cache);
 }
 
 /****************************************************************************
@@ -146,120 +138,143 @@ void arp_timer(void)
  *   ethaddr - Refers to a HW address uint8_t[IFHWADDRLEN]
  *
  * Assumptions
- *   Interrupts are disabled
+ *   The network is locked.
  *
  ****************************************************************************/
 
 void arp_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 {
-  struct arp_entry *tabptr = NULL;
-  in_addr_t         ipaddr = net_ip4addr_conv32(pipaddr);
-  int               i;
-
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  in_addr_t ipaddr = net_ip4addr_conv32(pipaddr);
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-    {
-      tabptr = &g_arptable[i];
-
-      /* Only check those entries that are actually in use. */
-
-      if (tabptr->at_ipaddr != 0)
-        {
-          /* Check if the source IP address of the incoming packet matches
-           * the IP address in this ARP table entry.
-           */
+  (void)neighbor_cache_update(&g_arp_cache, &ipaddr, ethaddr,
+                              ETHER_ADDR_LEN);
+}
 
-          if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-            {
-              /* An old entry found, update this and return. */
+/****************************************************************************
+ * Name: arp_find
+ *
+ * Description:
+ *   Find the ARP entry corresponding to this IP address.
+ *
+ * Input parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Returned Value:
+ *   The ARP table entry or NULL if the address is not resolved.  The
+ *   Ethernet address is in ne_lladdr.eth.
+ *
+ * Assumptions
+ *   The network is locked; Returned value will become unstable when the
+ *   network is unlocked or if any other uIP APIs are called.
+ *
+ ****************************************************************************/
 
-              memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-              tabptr->at_time = g_arptime;
-              return;
-            }
-        }
-    }
+FAR struct neighbor_entry_s *arp_find(in_addr_t ipaddr)
+{
+  return neighbor_cache_lookup(&g_arp_cache, &ipaddr);
+}
 
-  /* If we get here, no existing ARP table entry was found, so we create one. */
+/****************************************************************************
+ * Name: arp_delete
+ *
+ * Description:
+ *   Remove an IP association from the ARP table
+ *
+ * Input parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-  /* First, we try to find an unused entry in the ARP table. */
+void arp_delete(in_addr_t ipaddr)
+{
+  FAR struct neighbor_entry_s *entry;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  entry = neighbor_cache_find(&g_arp_cache, &ipaddr);
+  if (entry != NULL)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr == 0)
-        {
-          break;
-        }
+      neighbor_cache_delete(&g_arp_cache, entry);
     }
+}
 
-  /* If no unused entry is found, we try to find the oldest entry and
-   * throw it away.
-   */
-
-  if (i == CONFIG_NET_ARPTAB_SIZE)
-    {
-      uint8_t tmpage = 0;
-      int j = 0;
-
-      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-        {
-          tabptr = &g_arptable[i];
-          if (g_arptime - tabptr->at_time > tmpage)
-            {
-              tmpage = g_arptime - tabptr->at_time;
-              j = i;
-            }
-        }
-
-      i = j;
-      tabptr = &g_arptable[i];
-    }
+/****************************************************************************
+ * Name: arp_enqueue
+ *
+ * Description:
+ *   Called by arp_out() when the outgoing IPv4 packet in d_buf is about to
+ *   be replaced with an ARP request.  The ARP table entry for the address
+ *   is marked as INCOMPLETE and a copy of the packet is retained.
+ *
+ * Input parameters:
+ *   dev    - The device with the outgoing IPv4 packet in d_buf
+ *   ipaddr - The IP address being resolved, in network order
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-  /* Now, i is the ARP table entry which we will fill with the new
-   * information.
-   */
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+void arp_enqueue(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct neighbor_entry_s *entry;
 
-  tabptr->at_ipaddr = ipaddr;
-  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_time = g_arptime;
+  entry = neighbor_cache_incomplete(&g_arp_cache, &ipaddr);
+  neighbor_cache_enqueue(&g_arp_cache, entry, &dev->d_buf[ETH_HDRLEN],
+                         dev->d_len);
 }
+#endif
 
 /****************************************************************************
- * Name: arp_find
+ * Name: arp_dequeue
  *
  * Description:
- *   Find the ARP entry corresponding to this IP address.
+ *   Called by arp_arpin() when an ARP reply has been received.  If a
+ *   packet was queued awaiting resolution of the IP address, it is copied
+ *   into d_buf (after the Ethernet header) and d_len is set to its length.
  *
  * Input parameters:
- *   ipaddr - Refers to an IP address in network order
+ *   dev    - The device that received the ARP reply
+ *   ipaddr - The IP address that has been resolved, in network order
+ *
+ * Returned Value:
+ *   true if a queued packet was placed in d_buf.
  *
  * Assumptions
- *   Interrupts are disabled; Returned value will become unstable when
- *   interrupts are re-enabled or if any other uIP APIs are called.
+ *   The network is locked.
  *
  ****************************************************************************/
 
-FAR struct arp_entry *arp_find(in_addr_t ipaddr)
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+bool arp_dequeue(FAR struct net_driver_s *dev, in_addr_t ipaddr)
 {
-  FAR struct arp_entry *tabptr;
-  int i;
+  FAR struct neighbor_entry_s *entry;
+  unsigned int len;
+
+  entry = neighbor_cache_find(&g_arp_cache, &ipaddr);
+  if (entry == NULL)
+    {
+      return false;
+    }
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  /* The packet buffer size (the MTU) includes the Ethernet header */
+
+  len = neighbor_cache_dequeue(&g_arp_cache, entry, &dev->d_buf[ETH_HDRLEN],
+                               NET_DEV_MTU(dev) - ETH_HDRLEN);
+  if (len == 0)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-        {
-          return tabptr;
-        }
+      return false;
     }
 
-  return NULL;
+  nllvdbg("Sending queued IPv4 packet: %u bytes\n", len);
+
+  IFF_SET_IPv4(dev->d_flags);
+  dev->d_len = len;
+  return true;
 }
+#endif
 
 #endif /* CONFIG_NET_ARP */
 #endif /* CONFIG_NET */
@@ -429,6 +429,12 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback,
     }
 #endif
 
+#ifdef CONFIG_NET_ARP
+  /* Perform ageing on the entries in the ARP table */
+
+  arp_timer();
+#endif
+
 #ifdef CONFIG_NET_IPv6
   /* Perform ageing on the entries in the Neighbor Table */
 
@@ -176,6 +176,15 @@ void icmpv6_input(FAR struct net_driver_s *dev)
                 icmpv6_notify(icmp->srcipaddr);
 #endif
 
+                /* If a packet was waiting for this address, it replaces
+                 * the Neighbor Advertisement in d_buf and is sent now.
+                 */
+
+                if (neighbor_dequeue(dev, icmp->srcipaddr))
+                  {
+                    return;
+                  }
+
                 /* We consumed the packet but we don't send anything in
                  * response.
                  */
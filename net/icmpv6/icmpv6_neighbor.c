@@ -56,6 +56,7 @@
 #include "netdev/netdev.h"
 #include "devif/devif.h"
 #include "neighbor/neighbor.h"
+#include "route/route.h"
 #include "icmpv6/icmpv6.h"
 
 #ifdef CONFIG_NET_ICMPv6_NEIGHBOR
@@ -51,6 +51,10 @@
 #include <stdint.h>
 #include <poll.h>
 
+#ifdef CONFIG_NET_LOCAL_SCM
+#  include <nuttx/fs/fs.h>
+#endif
+
 #ifdef CONFIG_NET_LOCAL
 
 /****************************************************************************
@@ -74,9 +78,82 @@
 #define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
 #define LOCAL_END_BYTE    0xbd     /* End of sync seqence */
 
+/* Ring buffer transport.  The ring buffer size must be a power of two so
+ * that the free-running head and tail counts remain valid when they wrap.
+ */
+
+#ifdef CONFIG_NET_LOCAL_RING
+#  ifndef CONFIG_NET_LOCAL_RING_SIZE
+#    define CONFIG_NET_LOCAL_RING_SIZE 1024
+#  endif
+
+#  if (CONFIG_NET_LOCAL_RING_SIZE & (CONFIG_NET_LOCAL_RING_SIZE - 1)) != 0
+#    error "CONFIG_NET_LOCAL_RING_SIZE must be a power of two"
+#  endif
+
+#  define LOCAL_RING_NPOLLWAITERS 2
+
+/* Ring buffer flags */
+
+#  define LOCAL_RING_RDCLOSED (1 << 0) /* The receiving side is closed */
+#  define LOCAL_RING_WRCLOSED (1 << 1) /* The sending side is closed */
+
+/* Each datagram is preceded by its 16-bit length (in host order) */
+
+#  define LOCAL_DGRAM_HDRLEN  sizeof(uint16_t)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+/* File descriptors passed with SCM_RIGHTS.  The open files are held in
+ * the ring buffer until the data byte that they were sent with is
+ * received.
+ */
+
+struct local_scm_s
+{
+  sq_entry_t ls_node;          /* Supports a singly linked list */
+  uint32_t ls_offset;          /* Stream offset of the accompanying data */
+  uint8_t ls_nfds;             /* Number of open files in ls_files[] */
+  struct file ls_files[CONFIG_NET_LOCAL_SCM_MAXFD];
+};
+#endif
+
+#ifdef CONFIG_NET_LOCAL_RING
+/* A ring buffer that carries data in one direction between sockets.  The
+ * structure is shared directly by the sending and receiving sockets and is
+ * protected by the network lock.
+ */
+
+struct local_ring_s
+{
+  uint8_t lr_crefs;            /* Reference counts on this instance */
+  uint8_t lr_flags;            /* See LOCAL_RING_* definitions */
+  uint8_t lr_nrdwait;          /* Number of threads waiting for data */
+  uint8_t lr_nwrwait;          /* Number of threads waiting for space */
+  uint32_t lr_head;            /* Number of bytes written (free-running) */
+  uint32_t lr_tail;            /* Number of bytes read (free-running) */
+  sem_t lr_rdsem;              /* Used to wait for data */
+  sem_t lr_wrsem;              /* Used to wait for space */
+
+#ifdef HAVE_LOCAL_POLL
+  /* Poll structures of threads waiting for data and for space */
+
+  FAR struct pollfd *lr_rdfds[LOCAL_RING_NPOLLWAITERS];
+  FAR struct pollfd *lr_wrfds[LOCAL_RING_NPOLLWAITERS];
+#endif
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  sq_queue_t lr_scm;           /* Passed files in stream order */
+#endif
+
+  uint8_t lr_buffer[CONFIG_NET_LOCAL_RING_SIZE];
+};
+#endif
+
 /* Local, Unix domain socket types */
 
 enum local_type_e
@@ -146,6 +223,15 @@ struct local_conn_s
   int32_t lc_instance_id;      /* Connection instance ID for stream
                                 * server<->client connection pair */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Ring buffers used in place of the FIFOs.  Connected SOCK_STREAM peers
+   * use both; a bound SOCK_DGRAM socket receives through lc_rxring.
+   */
+
+  FAR struct local_ring_s *lc_rxring; /* Incoming data */
+  FAR struct local_ring_s *lc_txring; /* Outgoing data (SOCK_STREAM only) */
+#endif
+
 #ifdef CONFIG_NET_LOCAL_STREAM
   /* SOCK_STREAM fields common to both client and server */
 
@@ -210,6 +296,12 @@ extern "C"
 EXTERN dq_queue_t g_local_listeners;
 #endif
 
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_RING)
+/* A list of all bound SOCK_DGRAM connections */
+
+EXTERN dq_queue_t g_local_dgrams;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -370,6 +462,30 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags);
 #endif
 
+/****************************************************************************
+ * Name: psock_local_sendmsg
+ *
+ * Description:
+ *   Send stream data together with the open files named by SCM_RIGHTS
+ *   control messages.  The files are received with the first byte of the
+ *   data.
+ *
+ * Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msg      The message to send
+ *   flags    Send flags
+ *
+ * Return:
+ *   On success, returns the number of characters sent.  On error, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+ssize_t psock_local_sendmsg(FAR struct socket *psock,
+                            FAR const struct msghdr *msg, int flags);
+#endif
+
 /****************************************************************************
  * Function: psock_local_sendto
  *
@@ -452,6 +568,31 @@ ssize_t psock_local_recvfrom(FAR struct socket *psock, FAR void *buf,
                              size_t len, int flags, FAR struct sockaddr *from,
                              FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Function: psock_local_recvmsg
+ *
+ * Description:
+ *   Receive stream data and any open files that were sent with it.  The
+ *   files are returned as new file descriptors in an SCM_RIGHTS control
+ *   message.  Files that do not fit into the control buffer are closed and
+ *   MSG_CTRUNC is reported.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to receive
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On error, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+ssize_t psock_local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                            int flags);
+#endif
+
 /****************************************************************************
  * Name: local_fifo_read
  *
@@ -633,6 +774,170 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
                       bool nonblock);
 #endif
 
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate a new, empty ring buffer with one reference.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+FAR struct local_ring_s *local_ring_alloc(void);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Mark one side of a ring buffer as closed (if flags is non-zero),
+ *   awaken any waiting threads, and release one reference.  The ring
+ *   buffer is freed when the last reference is released.
+ *
+ * Parameters:
+ *   ring  - The ring buffer
+ *   flags - LOCAL_RING_RDCLOSED, LOCAL_RING_WRCLOSED or zero
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+void local_ring_release(FAR struct local_ring_s *ring, uint8_t flags);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_write
+ *
+ * Description:
+ *   Copy stream data into the ring buffer, waiting for space as necessary.
+ *
+ * Parameters:
+ *   ring     - The ring buffer
+ *   buf      - Data to send
+ *   len      - Length of data to send
+ *   nonblock - Return -EAGAIN instead of waiting
+ *
+ * Return:
+ *   The number of bytes written, which is less than len only if the wait
+ *   for space was interrupted or would block.  A negated errno value is
+ *   returned if nothing was written.  -EPIPE is returned if the receiving
+ *   side has been closed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+ssize_t local_ring_write(FAR struct local_ring_s *ring,
+                         FAR const uint8_t *buf, size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_read
+ *
+ * Description:
+ *   Copy stream data out of the ring buffer, waiting for data if the ring
+ *   buffer is empty.
+ *
+ *   If scm is not NULL, then files passed with the first byte to be read
+ *   are returned in *scm and the read stops before the next byte that has
+ *   files attached.  Otherwise, any files passed with the data are closed.
+ *
+ * Parameters:
+ *   ring     - The ring buffer
+ *   buf      - Location to return the data
+ *   len      - Size of buf
+ *   nonblock - Return -EAGAIN instead of waiting
+ *   scm      - Location to return passed files (may be NULL)
+ *
+ * Return:
+ *   The number of bytes read.  Zero is returned if the ring buffer is empty
+ *   and the sending side has been closed.  A negated errno value is
+ *   returned on any failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+#ifdef CONFIG_NET_LOCAL_SCM
+ssize_t local_ring_read(FAR struct local_ring_s *ring, FAR uint8_t *buf,
+                        size_t len, bool nonblock,
+                        FAR struct local_scm_s **scm);
+#else
+ssize_t local_ring_read(FAR struct local_ring_s *ring, FAR uint8_t *buf,
+                        size_t len, bool nonblock);
+#endif
+#endif
+
+/****************************************************************************
+ * Name: local_ring_senddgram and local_ring_recvdgram
+ *
+ * Description:
+ *   Queue a whole datagram in the ring buffer or remove one.  Datagrams
+ *   are never split.  If the receive buffer is too small, the remainder
+ *   of the datagram is discarded.
+ *
+ * Return:
+ *   The number of bytes sent or received.  A negated errno value is
+ *   returned on any failure.  -EMSGSIZE is returned if the datagram can
+ *   never fit in the ring buffer.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_RING) && defined(CONFIG_NET_LOCAL_DGRAM)
+ssize_t local_ring_senddgram(FAR struct local_ring_s *ring,
+                             FAR const uint8_t *buf, size_t len,
+                             bool nonblock);
+ssize_t local_ring_recvdgram(FAR struct local_ring_s *ring,
+                             FAR uint8_t *buf, size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown monitoring of POLLIN (if the receiving side) or
+ *   POLLOUT events on a ring buffer.
+ *
+ * Parameters:
+ *   ring   - The ring buffer
+ *   fds    - The structure describing the events to be monitored
+ *   events - POLLIN or POLLOUT
+ *   setup  - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_RING) && defined(HAVE_LOCAL_POLL)
+int local_ring_pollsetup(FAR struct local_ring_s *ring,
+                         FAR struct pollfd *fds, pollevent_t events,
+                         bool setup);
+#endif
+
+/****************************************************************************
+ * Name: local_scm_free
+ *
+ * Description:
+ *   Close the files held by a list of passed file sets and free them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+void local_scm_free(FAR struct local_scm_s *scm);
+#endif
 
 /****************************************************************************
  * Name: local_accept_pollnotify
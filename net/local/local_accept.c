@@ -117,6 +117,9 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
   FAR struct local_conn_s *server;
   FAR struct local_conn_s *client;
   FAR struct local_conn_s *conn;
+#ifdef CONFIG_NET_LOCAL_RING
+  net_lock_t state;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -172,6 +175,19 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               conn->lc_path[UNIX_PATH_MAX-1] = '\0';
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_RING
+              /* Share the client's ring buffers:  What the client sends,
+               * we receive and vice versa.
+               */
+
+              state = net_lock();
+              conn->lc_rxring = client->lc_txring;
+              conn->lc_txring = client->lc_rxring;
+              conn->lc_rxring->lr_crefs++;
+              conn->lc_txring->lr_crefs++;
+              net_unlock(state);
+              ret = OK;
+#else
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -210,6 +226,7 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
           if (ret == OK)
             {
               DEBUGASSERT(conn->lc_infd >= 0);
+#endif /* CONFIG_NET_LOCAL_RING */
 
               /* Return the address family */
 
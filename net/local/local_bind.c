@@ -42,12 +42,86 @@
 
 #include <sys/socket.h>
 #include <string.h>
+#include <queue.h>
+#include <errno.h>
 #include <assert.h>
 
 #include <nuttx/net/net.h>
 
 #include "local/local.h"
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_RING)
+/* A list of all bound SOCK_DGRAM connections */
+
+dq_queue_t g_local_dgrams;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_dgram_bind
+ *
+ * Description:
+ *   Allocate the ring buffer that receives the datagrams sent to a bound
+ *   SOCK_DGRAM socket.  If the socket is bound to a path, also make it
+ *   visible to the senders.  Unnamed and abstract sockets cannot be
+ *   addressed by sendto() but still need the ring buffer for recvfrom().
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_RING)
+static int local_dgram_bind(FAR struct local_conn_s *conn,
+                            FAR const char *path)
+{
+  FAR struct local_conn_s *peer;
+  net_lock_t state;
+  int ret = OK;
+
+  state = net_lock();
+
+  if (conn->lc_rxring != NULL)
+    {
+      ret = -EINVAL;
+      goto errout_with_lock;
+    }
+
+  /* The path may be bound to only one receiver */
+
+  for (peer = (FAR struct local_conn_s *)g_local_dgrams.head;
+       path != NULL && peer != NULL;
+       peer = (FAR struct local_conn_s *)dq_next(&peer->lc_node))
+    {
+      if (strncmp(peer->lc_path, path, UNIX_PATH_MAX - 1) == 0)
+        {
+          ret = -EADDRINUSE;
+          goto errout_with_lock;
+        }
+    }
+
+  conn->lc_rxring = local_ring_alloc();
+  if (conn->lc_rxring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  if (path != NULL)
+    {
+      dq_addlast(&conn->lc_node, &g_local_dgrams);
+    }
+
+errout_with_lock:
+  net_unlock(state);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -83,6 +157,28 @@ int psock_local_bind(FAR struct socket *psock,
    * of the address description.
    */
 
+  namelen = 0;
+  if (addrlen > sizeof(sa_family_t))
+    {
+      namelen = strnlen(unaddr->sun_path, UNIX_PATH_MAX-1);
+    }
+
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_RING)
+  /* Every bound datagram socket needs a ring buffer to receive into.  Only
+   * pathname sockets can be found by the senders.
+   */
+
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      int ret = local_dgram_bind(conn,
+                                 namelen > 0 ? unaddr->sun_path : NULL);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   if (addrlen == sizeof(sa_family_t))
     {
       /* No sun_path... This is an un-named Unix domain socket */
@@ -91,7 +187,6 @@ int psock_local_bind(FAR struct socket *psock,
     }
   else
     {
-      namelen = strnlen(unaddr->sun_path, UNIX_PATH_MAX-1);
       if (namelen <= 0)
         {
           /* Zero-length sun_path... This is an abstract Unix domain socket */
@@ -69,6 +69,9 @@
 #ifdef CONFIG_NET_LOCAL_STREAM
   dq_init(&g_local_listeners);
 #endif
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_RING)
+  dq_init(&g_local_dgrams);
+#endif
 }
 
 /****************************************************************************
@@ -132,10 +135,28 @@ void local_free(FAR struct local_conn_s *conn)
       conn->lc_outfd = -1;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Release the ring buffers, telling the peers that we are gone */
+
+  if (conn->lc_rxring != NULL)
+    {
+      local_ring_release(conn->lc_rxring, LOCAL_RING_RDCLOSED);
+      conn->lc_rxring = NULL;
+    }
+
+  if (conn->lc_txring != NULL)
+    {
+      local_ring_release(conn->lc_txring, LOCAL_RING_WRCLOSED);
+      conn->lc_txring = NULL;
+    }
+#endif
+
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifndef CONFIG_NET_LOCAL_RING
   /* Destroy all FIFOs associted with the connection */
 
   local_release_fifos(conn);
+#endif
   sem_destroy(&conn->lc_waitsem);
 #endif
 
@@ -148,6 +148,23 @@ int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Allocate the ring buffers needed for the connection.  The server side
+   * will take a reference to each when the connection is accepted.
+   */
+
+  client->lc_txring = local_ring_alloc();
+  client->lc_rxring = local_ring_alloc();
+  if (client->lc_txring == NULL || client->lc_rxring == NULL)
+    {
+      ndbg("ERROR: Failed to allocate ring buffers for %s\n",
+           client->lc_path);
+
+      ret = -ENOMEM;
+      goto errout_with_rings;
+    }
+
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -175,6 +192,7 @@ int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfd >= 0);
+#endif /* CONFIG_NET_LOCAL_RING */
 
   /* Add ourself to the list of waiting connections and notify the server. */
 
@@ -199,9 +217,43 @@ int inline local_stream_connect(FAR struct local_conn_s *client,
   if (ret < 0)
     {
       ndbg("ERROR: Failed to connect: %d\n", ret);
+#ifdef CONFIG_NET_LOCAL_RING
+      state = net_lock();
+      goto errout_with_rings;
+#else
       goto errout_with_outfd;
+#endif
+    }
+
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Yes.. the server now shares the ring buffers */
+
+  client->lc_state = LOCAL_STATE_CONNECTED;
+  return OK;
+
+errout_with_rings:
+  /* The server may already hold references to the rings if the wait was
+   * interrupted after the accept.  Close our ends so that it sees the
+   * hang-up.
+   */
+
+  if (client->lc_txring != NULL)
+    {
+      local_ring_release(client->lc_txring, LOCAL_RING_WRCLOSED);
+      client->lc_txring = NULL;
     }
 
+  if (client->lc_rxring != NULL)
+    {
+      local_ring_release(client->lc_rxring, LOCAL_RING_RDCLOSED);
+      client->lc_rxring = NULL;
+    }
+
+  client->lc_state = LOCAL_STATE_BOUND;
+  net_unlock(state);
+  return ret;
+
+#else
   /* Yes.. open the read-only FIFO */
 
   ret = local_open_client_rx(client, nonblock);
@@ -224,6 +276,7 @@ errout_with_fifos:
   (void)local_release_fifos(client);
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
+#endif /* CONFIG_NET_LOCAL_RING */
 }
 
 /****************************************************************************
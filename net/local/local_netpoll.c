@@ -130,6 +130,52 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Function: local_ring_poll
+ *
+ * Description:
+ *   Setup or teardown monitoring of the ring buffers of a connected stream
+ *   socket or of a datagram socket.  Datagram sockets are always writable.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+static int local_ring_poll(FAR struct local_conn_s *conn,
+                           FAR struct pollfd *fds, bool setup)
+{
+  net_lock_t state;
+  int ret = OK;
+
+  state = net_lock();
+  if (conn->lc_rxring != NULL && (fds->events & POLLIN) != 0)
+    {
+      ret = local_ring_pollsetup(conn->lc_rxring, fds, POLLIN, setup);
+    }
+
+  if (ret >= 0 && (fds->events & POLLOUT) != 0)
+    {
+      if (conn->lc_txring != NULL)
+        {
+          ret = local_ring_pollsetup(conn->lc_txring, fds, POLLOUT, setup);
+          if (ret < 0 && setup && conn->lc_rxring != NULL &&
+              (fds->events & POLLIN) != 0)
+            {
+              (void)local_ring_pollsetup(conn->lc_rxring, fds, POLLIN,
+                                         false);
+            }
+        }
+      else if (setup && conn->lc_proto == SOCK_DGRAM)
+        {
+          fds->revents |= POLLOUT;
+          sem_post(fds->sem);
+        }
+    }
+
+  net_unlock(state);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -183,6 +229,14 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
   conn = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_proto == SOCK_DGRAM ||
+      conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      return local_ring_poll(conn, fds, true);
+    }
+#endif
+
   if (conn->lc_proto == SOCK_DGRAM)
     {
       return ret;
@@ -323,6 +377,14 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 
   conn = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_proto == SOCK_DGRAM ||
+      conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      return local_ring_poll(conn, fds, false);
+    }
+#endif
+
   if (conn->lc_proto == SOCK_DGRAM)
     {
       return ret;
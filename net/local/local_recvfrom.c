@@ -47,6 +47,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -60,6 +61,11 @@
 #  define MIN(a,b) ((a) < (b) ? (a) : (b))
 #endif
 
+/* Receive without waiting if the socket is non-blocking or MSG_DONTWAIT */
+
+#define RECVFROM_NONBLOCK(p,f) \
+  (_SS_ISNONBLOCK((p)->s_flags) || ((f) & MSG_DONTWAIT) != 0)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -73,6 +79,7 @@
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_LOCAL_RING
 static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
                            FAR size_t *readlen)
 {
@@ -118,6 +125,7 @@ static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
  
   return OK;
 }
+#endif /* CONFIG_NET_LOCAL_RING */
 
 /****************************************************************************
  * Function: psock_stream_recvfrom
@@ -148,7 +156,12 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       FAR socklen_t *fromlen)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+#ifdef CONFIG_NET_LOCAL_RING
+  net_lock_t state;
+  ssize_t readlen;
+#else
   size_t readlen;
+#endif
   int ret;
 
   /* Verify that this is a connected peer socket */
@@ -159,6 +172,26 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Copy the data directly out of the ring buffer shared with the peer */
+
+  DEBUGASSERT(conn->lc_rxring != NULL);
+
+  state = net_lock();
+#ifdef CONFIG_NET_LOCAL_SCM
+  readlen = local_ring_read(conn->lc_rxring, buf, len,
+                            RECVFROM_NONBLOCK(psock, flags), NULL);
+#else
+  readlen = local_ring_read(conn->lc_rxring, buf, len,
+                            RECVFROM_NONBLOCK(psock, flags));
+#endif
+  net_unlock(state);
+
+  if (readlen < 0)
+    {
+      return readlen;
+    }
+#else
   /* The incoming FIFO should be open */
 
   DEBUGASSERT(conn->lc_infd >= 0);
@@ -199,6 +232,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   DEBUGASSERT(readlen <= conn->u.peer.lc_remaining);
   conn->u.peer.lc_remaining -= readlen;
+#endif /* CONFIG_NET_LOCAL_RING */
 
   /* Return the address family */
 
@@ -243,8 +277,13 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                      FAR socklen_t *fromlen)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+#ifdef CONFIG_NET_LOCAL_RING
+  net_lock_t state;
+  ssize_t readlen;
+#else
   uint16_t pktlen;
   size_t readlen;
+#endif
   int ret;
 
   /* We keep packet sizes in a uint16_t, so there is a upper limit to the
@@ -263,6 +302,25 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -EISCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Remove the next datagram from our ring buffer */
+
+  if (conn->lc_rxring == NULL)
+    {
+      ndbg("ERROR: No receive buffer\n");
+      return -ENOTCONN;
+    }
+
+  state = net_lock();
+  readlen = local_ring_recvdgram(conn->lc_rxring, buf, len,
+                                 RECVFROM_NONBLOCK(psock, flags));
+  net_unlock(state);
+
+  if (readlen < 0)
+    {
+      return readlen;
+    }
+#else
   /* The incoming FIFO should not be open */
 
   DEBUGASSERT(conn->lc_infd < 0);
@@ -354,6 +412,7 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
   /* Release our reference to the half duplex FIFO*/
 
   (void)local_release_halfduplex(conn);
+#endif /* CONFIG_NET_LOCAL_RING */
 
   /* Return the address family */
 
@@ -368,6 +427,7 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   return readlen;
 
+#ifndef CONFIG_NET_LOCAL_RING
 errout_with_infd:
   /* Close the read-only file descriptor */
 
@@ -379,8 +439,9 @@ errout_with_halfduplex:
 
   (void)local_release_halfduplex(conn);
   return ret;
+#endif /* CONFIG_NET_LOCAL_RING */
 }
-#endif /* CONFIG_NET_LOCAL_STREAM */
+#endif /* CONFIG_NET_LOCAL_DGRAM */
 
 /****************************************************************************
  * Public Functions
@@ -420,6 +481,18 @@ ssize_t psock_local_recvfrom(FAR struct socket *psock, FAR void *buf,
 {
   DEBUGASSERT(psock && psock->s_conn && buf);
 
+#ifndef CONFIG_NET_LOCAL_RING
+  /* The FIFO transport reads framed packets with blocking reads and cannot
+   * tell whether a whole packet is available without waiting.  Reject
+   * MSG_DONTWAIT rather than silently blocking.
+   */
+
+  if ((flags & MSG_DONTWAIT) != 0)
+    {
+      return -EOPNOTSUPP;
+    }
+#endif
+
   /* Check for a stream socket */
 
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -444,4 +517,122 @@ ssize_t psock_local_recvfrom(FAR struct socket *psock, FAR void *buf,
     }
 }
 
+/****************************************************************************
+ * Function: psock_local_recvmsg
+ *
+ * Description:
+ *   Receive stream data and any open files that were sent with it.  The
+ *   files are returned as new file descriptors in an SCM_RIGHTS control
+ *   message.  Files that do not fit into the control buffer are closed and
+ *   MSG_CTRUNC is reported.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to receive
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On error, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+ssize_t psock_local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                            int flags)
+{
+  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+  FAR struct local_scm_s *scm = NULL;
+  FAR struct cmsghdr *cmsg;
+  FAR int *fds = NULL;
+  FAR void *buf = NULL;
+  size_t len = 0;
+  net_lock_t state;
+  ssize_t readlen;
+  int maxfds = 0;
+  int nfds = 0;
+  int ret;
+  int i;
+
+  if (conn->lc_state != LOCAL_STATE_CONNECTED)
+    {
+      ndbg("ERROR: not connected\n");
+      return -ENOTCONN;
+    }
+
+  if (msg->msg_iovlen > 0)
+    {
+      buf = msg->msg_iov[0].iov_base;
+      len = msg->msg_iov[0].iov_len;
+    }
+
+  DEBUGASSERT(conn->lc_rxring != NULL);
+
+  state = net_lock();
+  readlen = local_ring_read(conn->lc_rxring, buf, len,
+                            RECVFROM_NONBLOCK(psock, flags), &scm);
+  net_unlock(state);
+
+  if (readlen < 0)
+    {
+      return readlen;
+    }
+
+  /* Install the passed files in our list of open files */
+
+  msg->msg_flags = 0;
+  cmsg = CMSG_FIRSTHDR(msg);
+  if (cmsg != NULL && msg->msg_controllen >= CMSG_LEN(sizeof(int)))
+    {
+      fds    = (FAR int *)CMSG_DATA(cmsg);
+      maxfds = (msg->msg_controllen - CMSG_LEN(0)) / sizeof(int);
+    }
+
+  if (scm != NULL)
+    {
+      for (i = 0; i < scm->ls_nfds; i++)
+        {
+          ret = nfds < maxfds ? file_attach(&scm->ls_files[i], 0) : -EMFILE;
+          if (ret < 0)
+            {
+              msg->msg_flags |= MSG_CTRUNC;
+              break;
+            }
+
+          fds[nfds++] = ret;
+        }
+
+      /* Close any files that were not installed */
+
+      local_scm_free(scm);
+    }
+
+  if (nfds > 0)
+    {
+      cmsg->cmsg_len      = CMSG_LEN(nfds * sizeof(int));
+      cmsg->cmsg_level    = SOL_SOCKET;
+      cmsg->cmsg_type     = SCM_RIGHTS;
+      msg->msg_controllen = cmsg->cmsg_len;
+    }
+  else
+    {
+      msg->msg_controllen = 0;
+    }
+
+  /* Return the address family */
+
+  if (msg->msg_name != NULL)
+    {
+      ret = local_getaddr(conn, (FAR struct sockaddr *)msg->msg_name,
+                          &msg->msg_namelen);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return readlen;
+}
+#endif /* CONFIG_NET_LOCAL_SCM */
+
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL */
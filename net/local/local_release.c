@@ -119,6 +119,16 @@ int local_release(FAR struct local_conn_s *conn)
     }
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_RING)
+  /* Remove a datagram socket bound to a path from the list of receivers */
+
+  if (conn->lc_proto == SOCK_DGRAM && conn->lc_type == LOCAL_TYPE_PATHNAME &&
+      conn->lc_rxring != NULL)
+    {
+      dq_rem(&conn->lc_node, &g_local_dgrams);
+    }
+#endif
+
   /* For the remaining states (LOCAL_STATE_UNBOUND and LOCAL_STATE_UNBOUND),
    * we simply free the connection structure.
    */
@@ -0,0 +1,733 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_RING)
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RING_SIZE   CONFIG_NET_LOCAL_RING_SIZE
+#define RING_MASK   (CONFIG_NET_LOCAL_RING_SIZE - 1)
+
+/* The number of bytes in the ring buffer and the free space */
+
+#define RING_USED(r)  ((size_t)((r)->lr_head - (r)->lr_tail))
+#define RING_SPACE(r) (RING_SIZE - RING_USED(r))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_copyin
+ *
+ * Description:
+ *   Append data at the head of the ring buffer.  The caller has verified
+ *   that there is space for the data.
+ *
+ ****************************************************************************/
+
+static void local_ring_copyin(FAR struct local_ring_s *ring,
+                              FAR const uint8_t *buf, size_t len)
+{
+  uint32_t offset = ring->lr_head & RING_MASK;
+  size_t ncopy    = RING_SIZE - offset;
+
+  if (ncopy > len)
+    {
+      ncopy = len;
+    }
+
+  /* Copy up to the end of the buffer, then wrap to the beginning */
+
+  memcpy(&ring->lr_buffer[offset], buf, ncopy);
+  memcpy(ring->lr_buffer, buf + ncopy, len - ncopy);
+  ring->lr_head += len;
+}
+
+/****************************************************************************
+ * Name: local_ring_copyout
+ *
+ * Description:
+ *   Remove data from the tail of the ring buffer.  The data is discarded if
+ *   buf is NULL.  The caller has verified that the data is present.
+ *
+ ****************************************************************************/
+
+static void local_ring_copyout(FAR struct local_ring_s *ring,
+                               FAR uint8_t *buf, size_t len)
+{
+  uint32_t offset = ring->lr_tail & RING_MASK;
+  size_t ncopy    = RING_SIZE - offset;
+
+  if (buf != NULL)
+    {
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      memcpy(buf, &ring->lr_buffer[offset], ncopy);
+      memcpy(buf + ncopy, ring->lr_buffer, len - ncopy);
+    }
+
+  ring->lr_tail += len;
+}
+
+/****************************************************************************
+ * Name: local_ring_notify
+ *
+ * Description:
+ *   Wake up the threads that wait on the ring buffer and report the events
+ *   to the threads that poll it.  POLLIN wakes up the receiving side,
+ *   POLLOUT the sending side and POLLHUP both sides.
+ *
+ ****************************************************************************/
+
+static void local_ring_notify(FAR struct local_ring_s *ring,
+                              pollevent_t eventset)
+{
+#ifdef HAVE_LOCAL_POLL
+  FAR struct pollfd *fds;
+  int i;
+#endif
+
+  if ((eventset & (POLLIN | POLLHUP)) != 0)
+    {
+      for (; ring->lr_nrdwait > 0; ring->lr_nrdwait--)
+        {
+          sem_post(&ring->lr_rdsem);
+        }
+    }
+
+  if ((eventset & (POLLOUT | POLLHUP)) != 0)
+    {
+      for (; ring->lr_nwrwait > 0; ring->lr_nwrwait--)
+        {
+          sem_post(&ring->lr_wrsem);
+        }
+    }
+
+#ifdef HAVE_LOCAL_POLL
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      fds = ring->lr_rdfds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset & POLLIN) |
+                          (eventset & POLLHUP);
+          if (fds->revents != 0)
+            {
+              sem_post(fds->sem);
+            }
+        }
+
+      fds = ring->lr_wrfds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset & POLLOUT) |
+                          (eventset & POLLHUP);
+          if (fds->revents != 0)
+            {
+              sem_post(fds->sem);
+            }
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Wait for local_ring_notify().  The network lock is released while
+ *   waiting.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR sem_t *sem, FAR uint8_t *nwait)
+{
+  int ret;
+
+  (*nwait)++;
+  ret = net_lockedwait(sem);
+  if (ret < 0)
+    {
+      /* Interrupted by a signal.  Give up our place in the count of
+       * waiters unless local_ring_notify() has already taken it.
+       */
+
+      ret = -get_errno();
+      if (*nwait > 0)
+        {
+          (*nwait)--;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate a new, empty ring buffer with one reference.
+ *
+ ****************************************************************************/
+
+FAR struct local_ring_s *local_ring_alloc(void)
+{
+  FAR struct local_ring_s *ring;
+
+  /* Only the header needs to be zeroed */
+
+  ring = (FAR struct local_ring_s *)kmm_malloc(sizeof(struct local_ring_s));
+  if (ring != NULL)
+    {
+      memset(ring, 0, offsetof(struct local_ring_s, lr_buffer));
+      ring->lr_crefs = 1;
+      sem_init(&ring->lr_rdsem, 0, 0);
+      sem_init(&ring->lr_wrsem, 0, 0);
+#ifdef CONFIG_NET_LOCAL_SCM
+      sq_init(&ring->lr_scm);
+#endif
+    }
+
+  return ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Mark one side of a ring buffer as closed (if flags is non-zero),
+ *   awaken any waiting threads, and release one reference.  The ring
+ *   buffer is freed when the last reference is released.
+ *
+ * Parameters:
+ *   ring  - The ring buffer
+ *   flags - LOCAL_RING_RDCLOSED, LOCAL_RING_WRCLOSED or zero
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_ring_s *ring, uint8_t flags)
+{
+  DEBUGASSERT(ring != NULL && ring->lr_crefs > 0);
+
+  if (flags != 0)
+    {
+      ring->lr_flags |= flags;
+      local_ring_notify(ring, POLLHUP);
+    }
+
+  if (--ring->lr_crefs == 0)
+    {
+#ifdef CONFIG_NET_LOCAL_SCM
+      /* Close any files that were never received */
+
+      local_scm_free((FAR struct local_scm_s *)sq_peek(&ring->lr_scm));
+#endif
+
+      sem_destroy(&ring->lr_rdsem);
+      sem_destroy(&ring->lr_wrsem);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_write
+ *
+ * Description:
+ *   Copy stream data into the ring buffer, waiting for space as necessary.
+ *
+ * Parameters:
+ *   ring     - The ring buffer
+ *   buf      - Data to send
+ *   len      - Length of data to send
+ *   nonblock - Return -EAGAIN instead of waiting
+ *
+ * Return:
+ *   The number of bytes written, which is less than len only if the wait
+ *   for space was interrupted or would block.  A negated errno value is
+ *   returned if nothing was written.  -EPIPE is returned if the receiving
+ *   side has been closed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_write(FAR struct local_ring_s *ring,
+                         FAR const uint8_t *buf, size_t len, bool nonblock)
+{
+  size_t nwritten = 0;
+  size_t ncopy;
+  int ret;
+
+  while (nwritten < len)
+    {
+      if ((ring->lr_flags & LOCAL_RING_RDCLOSED) != 0)
+        {
+          ret = -EPIPE;
+          goto errout;
+        }
+
+      ncopy = RING_SPACE(ring);
+      if (ncopy == 0)
+        {
+          if (nonblock)
+            {
+              ret = -EAGAIN;
+              goto errout;
+            }
+
+          ret = local_ring_wait(&ring->lr_wrsem, &ring->lr_nwrwait);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          continue;
+        }
+
+      if (ncopy > len - nwritten)
+        {
+          ncopy = len - nwritten;
+        }
+
+      local_ring_copyin(ring, buf + nwritten, ncopy);
+      nwritten += ncopy;
+
+      local_ring_notify(ring, POLLIN);
+    }
+
+  return nwritten;
+
+errout:
+  return nwritten > 0 ? (ssize_t)nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_read
+ *
+ * Description:
+ *   Copy stream data out of the ring buffer, waiting for data if the ring
+ *   buffer is empty.
+ *
+ *   If scm is not NULL, then files passed with the first byte to be read
+ *   are returned in *scm and the read stops before the next byte that has
+ *   files attached.  Otherwise, any files passed with the data are closed.
+ *
+ * Parameters:
+ *   ring     - The ring buffer
+ *   buf      - Location to return the data
+ *   len      - Size of buf
+ *   nonblock - Return -EAGAIN instead of waiting
+ *   scm      - Location to return passed files (may be NULL)
+ *
+ * Return:
+ *   The number of bytes read.  Zero is returned if the ring buffer is empty
+ *   and the sending side has been closed.  A negated errno value is
+ *   returned on any failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+ssize_t local_ring_read(FAR struct local_ring_s *ring, FAR uint8_t *buf,
+                        size_t len, bool nonblock,
+                        FAR struct local_scm_s **scm)
+#else
+ssize_t local_ring_read(FAR struct local_ring_s *ring, FAR uint8_t *buf,
+                        size_t len, bool nonblock)
+#endif
+{
+#ifdef CONFIG_NET_LOCAL_SCM
+  FAR struct local_scm_s *entry;
+  FAR struct local_scm_s *passed = NULL;
+#endif
+  size_t ncopy;
+  int ret;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  while ((ncopy = RING_USED(ring)) == 0)
+    {
+      /* Report end-of-file once all data from a closed sender was read */
+
+      if ((ring->lr_flags & LOCAL_RING_WRCLOSED) != 0)
+        {
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = local_ring_wait(&ring->lr_rdsem, &ring->lr_nrdwait);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  entry = (FAR struct local_scm_s *)sq_peek(&ring->lr_scm);
+  if (scm != NULL)
+    {
+      /* Return the files that were sent with the first byte */
+
+      *scm = NULL;
+      if (entry != NULL && entry->ls_offset == ring->lr_tail)
+        {
+          *scm  = (FAR struct local_scm_s *)sq_remfirst(&ring->lr_scm);
+          entry = (FAR struct local_scm_s *)sq_peek(&ring->lr_scm);
+        }
+
+      /* And do not read into the data that the next files were sent with */
+
+      if (entry != NULL && ncopy > entry->ls_offset - ring->lr_tail)
+        {
+          ncopy = entry->ls_offset - ring->lr_tail;
+        }
+    }
+#endif
+
+  if (ncopy > len)
+    {
+      ncopy = len;
+    }
+
+  local_ring_copyout(ring, buf, ncopy);
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  /* Discard the files sent with any of the data that was just read */
+
+  while (scm == NULL && entry != NULL &&
+         (int32_t)(entry->ls_offset - ring->lr_tail) < 0)
+    {
+      (void)sq_remfirst(&ring->lr_scm);
+      entry->ls_node.flink = (FAR sq_entry_t *)passed;
+      passed = entry;
+      entry  = (FAR struct local_scm_s *)sq_peek(&ring->lr_scm);
+    }
+
+  local_scm_free(passed);
+#endif
+
+  local_ring_notify(ring, POLLOUT);
+  return ncopy;
+}
+
+/****************************************************************************
+ * Name: local_ring_senddgram
+ *
+ * Description:
+ *   Queue a whole datagram in the ring buffer, waiting for space as
+ *   necessary.
+ *
+ * Return:
+ *   The number of bytes sent.  A negated errno value is returned on any
+ *   failure.  -EMSGSIZE is returned if the datagram can never fit in the
+ *   ring buffer.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+ssize_t local_ring_senddgram(FAR struct local_ring_s *ring,
+                             FAR const uint8_t *buf, size_t len,
+                             bool nonblock)
+{
+  uint16_t len16;
+  int ret;
+
+  if (len > UINT16_MAX || len + LOCAL_DGRAM_HDRLEN > RING_SIZE)
+    {
+      return -EMSGSIZE;
+    }
+
+  /* Wait until the whole datagram fits */
+
+  for (; ; )
+    {
+      if ((ring->lr_flags & LOCAL_RING_RDCLOSED) != 0)
+        {
+          return -ECONNREFUSED;
+        }
+
+      if (RING_SPACE(ring) >= len + LOCAL_DGRAM_HDRLEN)
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = local_ring_wait(&ring->lr_wrsem, &ring->lr_nwrwait);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  len16 = len;
+  local_ring_copyin(ring, (FAR const uint8_t *)&len16, LOCAL_DGRAM_HDRLEN);
+  local_ring_copyin(ring, buf, len);
+
+  local_ring_notify(ring, POLLIN);
+  return len;
+}
+
+/****************************************************************************
+ * Name: local_ring_recvdgram
+ *
+ * Description:
+ *   Remove one whole datagram from the ring buffer, waiting for a datagram
+ *   if the ring buffer is empty.  If the receive buffer is too small, the
+ *   remainder of the datagram is discarded.
+ *
+ * Return:
+ *   The number of bytes received.  A negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recvdgram(FAR struct local_ring_s *ring,
+                             FAR uint8_t *buf, size_t len, bool nonblock)
+{
+  uint16_t len16;
+  int ret;
+
+  while (RING_USED(ring) == 0)
+    {
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = local_ring_wait(&ring->lr_rdsem, &ring->lr_nrdwait);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  DEBUGASSERT(RING_USED(ring) >= LOCAL_DGRAM_HDRLEN);
+  local_ring_copyout(ring, (FAR uint8_t *)&len16, LOCAL_DGRAM_HDRLEN);
+  DEBUGASSERT(RING_USED(ring) >= len16);
+
+  if (len > len16)
+    {
+      len = len16;
+    }
+
+  local_ring_copyout(ring, buf, len);
+  local_ring_copyout(ring, NULL, len16 - len);
+
+  local_ring_notify(ring, POLLOUT);
+  return len;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown monitoring of POLLIN (if the receiving side) or
+ *   POLLOUT events on a ring buffer.
+ *
+ * Parameters:
+ *   ring   - The ring buffer
+ *   fds    - The structure describing the events to be monitored
+ *   events - POLLIN or POLLOUT
+ *   setup  - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_ring_pollsetup(FAR struct local_ring_s *ring,
+                         FAR struct pollfd *fds, pollevent_t events,
+                         bool setup)
+{
+  FAR struct pollfd **slots;
+  pollevent_t eventset = 0;
+  int i;
+
+  DEBUGASSERT(events == POLLIN || events == POLLOUT);
+  slots = events == POLLIN ? ring->lr_rdfds : ring->lr_wrfds;
+
+  if (!setup)
+    {
+      /* Remove all memory of the poll setup */
+
+      for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+        {
+          if (slots[i] == fds)
+            {
+              slots[i] = NULL;
+            }
+        }
+
+      return OK;
+    }
+
+  /* Find an available slot for the poll structure reference */
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS && slots[i] != NULL; i++);
+
+  if (i >= LOCAL_RING_NPOLLWAITERS)
+    {
+      return -EBUSY;
+    }
+
+  slots[i] = fds;
+
+  /* Check if the requested event is already available */
+
+  if (events == POLLIN)
+    {
+      if (RING_USED(ring) > 0)
+        {
+          eventset |= POLLIN;
+        }
+
+      if ((ring->lr_flags & LOCAL_RING_WRCLOSED) != 0)
+        {
+          eventset |= POLLHUP;
+        }
+    }
+  else
+    {
+      if (RING_SPACE(ring) > 0)
+        {
+          eventset |= POLLOUT;
+        }
+
+      if ((ring->lr_flags & LOCAL_RING_RDCLOSED) != 0)
+        {
+          eventset |= POLLHUP;
+        }
+    }
+
+  fds->revents |= (fds->events & eventset) | (eventset & POLLHUP);
+  if (fds->revents != 0)
+    {
+      sem_post(fds->sem);
+    }
+
+  return OK;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+/****************************************************************************
+ * Name: local_scm_free
+ *
+ * Description:
+ *   Close the files held by a list of passed file sets and free them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+void local_scm_free(FAR struct local_scm_s *scm)
+{
+  FAR struct local_scm_s *next;
+  int i;
+
+  for (; scm != NULL; scm = next)
+    {
+      next = (FAR struct local_scm_s *)scm->ls_node.flink;
+
+      for (i = 0; i < scm->ls_nfds; i++)
+        {
+          (void)file_close_detached(&scm->ls_files[i]);
+        }
+
+      kmm_free(scm);
+    }
+}
+#endif /* CONFIG_NET_LOCAL_SCM */
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_RING */
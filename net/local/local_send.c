@@ -41,12 +41,18 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_STREAM)
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <queue.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
+#include "socket/socket.h"
 #include "local/local.h"
 
 /****************************************************************************
@@ -76,11 +82,34 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags)
 {
   FAR struct local_conn_s *peer;
+#ifdef CONFIG_NET_LOCAL_RING
+  net_lock_t state;
+  bool nonblock;
+#endif
   int ret;
 
   DEBUGASSERT(psock && psock->s_conn && buf);
   peer = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Verify that this is a connected peer socket */
+
+  if (peer->lc_state != LOCAL_STATE_CONNECTED || peer->lc_txring == NULL)
+    {
+      ndbg("ERROR: not connected\n");
+      return -ENOTCONN;
+    }
+
+  /* Copy the data directly into the ring buffer shared with the peer */
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  state = net_lock();
+  ret = local_ring_write(peer->lc_txring, (FAR const uint8_t *)buf, len,
+                         nonblock);
+  net_unlock(state);
+  return ret;
+#else
   /* Verify that this is a connected peer socket and that it has opened the
    * outgoing FIFO for write-only access.
    */
@@ -99,6 +128,166 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
   /* If the send was successful, then the full packet will have been sent */
 
   return ret < 0 ? ret : len;
+#endif
+}
+
+/****************************************************************************
+ * Name: psock_local_sendmsg
+ *
+ * Description:
+ *   Send stream data together with the open files named by SCM_RIGHTS
+ *   control messages.  The files are received with the first byte of the
+ *   data.
+ *
+ * Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msg      The message to send
+ *   flags    Send flags
+ *
+ * Return:
+ *   On success, returns the number of characters sent.  On error, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+ssize_t psock_local_sendmsg(FAR struct socket *psock,
+                            FAR const struct msghdr *msg, int flags)
+{
+  FAR struct local_conn_s *peer;
+  FAR struct local_ring_s *ring;
+  FAR struct local_scm_s *scm;
+  FAR struct cmsghdr *cmsg;
+  FAR struct file *filep;
+  FAR const int *fds;
+  FAR const void *buf = NULL;
+  size_t len = 0;
+  net_lock_t state;
+  ssize_t ret;
+  int nfds;
+  int i;
+
+  DEBUGASSERT(psock && psock->s_conn && msg);
+  peer = (FAR struct local_conn_s *)psock->s_conn;
+
+  if (peer->lc_state != LOCAL_STATE_CONNECTED || peer->lc_txring == NULL)
+    {
+      ndbg("ERROR: not connected\n");
+      return -ENOTCONN;
+    }
+
+  if (msg->msg_iovlen > 0)
+    {
+      buf = msg->msg_iov[0].iov_base;
+      len = msg->msg_iov[0].iov_len;
+    }
+
+  /* The files are attached to the first byte so there must be one */
+
+  if (len == 0)
+    {
+      return -EINVAL;
+    }
+
+  scm = (FAR struct local_scm_s *)kmm_zalloc(sizeof(struct local_scm_s));
+  if (scm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Open a new reference to each of the files.  These stay open while the
+   * data is in transit, even if the sender closes its descriptors.
+   */
+
+  for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg))
+    {
+      /* A header shorter than itself or running past the end of the control
+       * buffer is malformed.  Walking on from it could loop forever.
+       */
+
+      if (cmsg->cmsg_len < CMSG_LEN(0) ||
+          cmsg->cmsg_len > (FAR char *)msg->msg_control +
+                           msg->msg_controllen - (FAR char *)cmsg)
+        {
+          ret = -EINVAL;
+          goto errout_with_scm;
+        }
+
+      if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+        {
+          ret = -EINVAL;
+          goto errout_with_scm;
+        }
+
+      fds  = (FAR const int *)CMSG_DATA(cmsg);
+      nfds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+      for (i = 0; i < nfds; i++)
+        {
+          if (scm->ls_nfds >= CONFIG_NET_LOCAL_SCM_MAXFD)
+            {
+              ret = -ETOOMANYREFS;
+              goto errout_with_scm;
+            }
+
+          /* Socket descriptors cannot be passed */
+
+          if (fds[i] >= CONFIG_NFILE_DESCRIPTORS)
+            {
+              ret = -EOPNOTSUPP;
+              goto errout_with_scm;
+            }
+
+          filep = fs_getfilep(fds[i]);
+          if (filep == NULL ||
+              file_dup2(filep, &scm->ls_files[scm->ls_nfds]) < 0)
+            {
+              ret = -EBADF;
+              goto errout_with_scm;
+            }
+
+          scm->ls_nfds++;
+        }
+    }
+
+  /* Queue the files at the current end of the stream, then the data */
+
+  ring = peer->lc_txring;
+  state = net_lock();
+
+  if (scm->ls_nfds > 0)
+    {
+      scm->ls_offset = ring->lr_head;
+      sq_addlast(&scm->ls_node, &ring->lr_scm);
+    }
+
+  ret = local_ring_write(ring, (FAR const uint8_t *)buf, len,
+                         _SS_ISNONBLOCK(psock->s_flags) ||
+                         (flags & MSG_DONTWAIT) != 0);
+
+  if (ret >= 0 || scm->ls_nfds == 0)
+    {
+      /* The files are now owned by the ring buffer */
+
+      net_unlock(state);
+      if (scm->ls_nfds == 0)
+        {
+          kmm_free(scm);
+        }
+
+      return ret;
+    }
+
+  /* Nothing was sent */
+
+  sq_rem(&scm->ls_node, &ring->lr_scm);
+  scm->ls_node.flink = NULL;
+  net_unlock(state);
+
+errout_with_scm:
+  local_scm_free(scm);
+  return ret;
 }
+#endif /* CONFIG_NET_LOCAL_SCM */
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL_STREAM */
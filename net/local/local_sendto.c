@@ -43,6 +43,8 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <string.h>
+#include <queue.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -87,8 +89,14 @@ ssize_t psock_local_sendto(FAR struct socket *psock, FAR const void *buf,
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
   FAR struct sockaddr_un *unaddr = (FAR struct sockaddr_un *)to;
-  ssize_t nsent;
+#ifdef CONFIG_NET_LOCAL_RING
+  FAR struct local_conn_s *peer;
+  FAR struct local_ring_s *ring;
+  net_lock_t state;
+#else
   int ret;
+#endif
+  ssize_t nsent;
 
   /* We keep packet sizes in a uint16_t, so there is a upper limit to the
    * 'len' that can be supported.
@@ -123,6 +131,41 @@ ssize_t psock_local_sendto(FAR struct socket *psock, FAR const void *buf,
      return -EFAULT;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Find the bound receiver and queue the datagram directly in its ring
+   * buffer.  Hold a reference to the ring buffer in case that the receiver
+   * is closed while we wait for space.
+   */
+
+  state = net_lock();
+  for (peer = (FAR struct local_conn_s *)g_local_dgrams.head;
+       peer != NULL;
+       peer = (FAR struct local_conn_s *)dq_next(&peer->lc_node))
+    {
+      if (strncmp(peer->lc_path, unaddr->sun_path, UNIX_PATH_MAX - 1) == 0)
+        {
+          break;
+        }
+    }
+
+  if (peer == NULL)
+    {
+      ndbg("ERROR: No socket bound to %s\n", unaddr->sun_path);
+      net_unlock(state);
+      return -ECONNREFUSED;
+    }
+
+  ring = peer->lc_rxring;
+  ring->lr_crefs++;
+
+  nsent = local_ring_senddgram(ring, (FAR const uint8_t *)buf, len,
+                               _SS_ISNONBLOCK(psock->s_flags) ||
+                               (flags & MSG_DONTWAIT) != 0);
+
+  local_ring_release(ring, 0);
+  net_unlock(state);
+  return nsent;
+#else
   /* Make sure that half duplex FIFO has been created.
    * REVISIT:  Or should be just make sure that it already exists?
    */
@@ -172,6 +215,7 @@ errout_with_halfduplex:
 
   (void)local_release_halfduplex(conn);
   return nsent;
+#endif /* CONFIG_NET_LOCAL_RING */
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL_DGRAM */
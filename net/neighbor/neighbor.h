@@ -1,7 +1,7 @@
 /****************************************************************************
  * net/neighbor/neighbor.h
- * Header file for database of link-local neighbors, used by IPv6 code and
- * to be used by future ARP code.
+ * Header file for the database of link-local neighbors, used by the ARP
+ * and the IPv6 code.
  *
  *   Copyright (C) 2007-2009, 2015 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
@@ -45,13 +45,22 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
 
 #include <net/ethernet.h>
+#include <netinet/in.h>
 
 #include <nuttx/net/ip.h>
 
-#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+#  include <nuttx/net/iob.h>
+#endif
+
+#if defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -61,11 +70,39 @@
 #  define CONFIG_NET_IPv6_NCONF_ENTRIES 8
 #endif
 
-#define NEIGHBOR_MAXTIME 128
+#ifndef CONFIG_NET_IPv6_NEIGHBOR_MAXAGE
+#  define CONFIG_NET_IPv6_NEIGHBOR_MAXAGE 60
+#endif
+
+#ifndef CONFIG_NET_NEIGHBOR_REACHABLE
+#  define CONFIG_NET_NEIGHBOR_REACHABLE 30
+#endif
+
+/* Neighbor cache entry states.  An INCOMPLETE entry is waiting for the
+ * answer to an address resolution request.  A REACHABLE entry was
+ * confirmed within the last CONFIG_NET_NEIGHBOR_REACHABLE seconds; after
+ * that it becomes STALE.  STALE entries are still used but are the first
+ * to be replaced when the cache is full.
+ */
+
+#define NEIGHBOR_FREE       0
+#define NEIGHBOR_INCOMPLETE 1
+#define NEIGHBOR_REACHABLE  2
+#define NEIGHBOR_STALE      3
+
+/* Neighbor cache statistics */
+
+#ifdef CONFIG_NET_STATISTICS
+#  define NEIGHBOR_STAT(c,f) ((c)->nc_stats.f++)
+#else
+#  define NEIGHBOR_STAT(c,f)
+#endif
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
 /* Describes the link layer address */
 
 struct neighbor_addr_s
@@ -76,64 +113,247 @@ struct neighbor_addr_s
   struct ether_addr na_addr;
 #endif
 };
+#endif
+
+/* This structure describes one entry in a neighbor cache.  This is
+ * intended for internal use within the ARP and Neighbor implementations.
+ */
+
+struct neighbor_entry_s
+{
+  dq_entry_t ne_node;                    /* LRU or free list (first) */
+  FAR struct neighbor_entry_s *ne_hnext; /* Next entry in the hash chain */
+  union
+  {
+#ifdef CONFIG_NET_IPv4
+    in_addr_t              ipv4;         /* IPv4 address of the neighbor */
+#endif
+#ifdef CONFIG_NET_IPv6
+    net_ipv6addr_t         ipv6;         /* IPv6 address of the neighbor */
+#endif
+  } ne_ipaddr;
+  union
+  {
+    struct ether_addr      eth;          /* ARP: Ethernet MAC address */
+#ifdef CONFIG_NET_IPv6
+    struct neighbor_addr_s nd;           /* IPv6: Link layer address */
+#endif
+  } ne_lladdr;
+  uint32_t ne_time;                      /* Time last confirmed (ticks) */
+  uint8_t  ne_state;                     /* See NEIGHBOR_* definitions */
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+  FAR struct iob_s *ne_pending;          /* Packet awaiting resolution */
+#endif
+};
+
+#ifdef CONFIG_NET_STATISTICS
+/* Neighbor cache statistics */
+
+struct neighbor_stats_s
+{
+  uint32_t ns_lookups;   /* Number of look-ups */
+  uint32_t ns_misses;    /* Look-ups that found no usable entry */
+  uint32_t ns_evicted;   /* Entries replaced while still valid */
+  uint32_t ns_expired;   /* Entries removed because of age */
+  uint32_t ns_queued;    /* Packets queued awaiting address resolution */
+  uint32_t ns_sent;      /* Queued packets sent after resolution */
+  uint32_t ns_dropped;   /* Queued packets discarded */
+};
+#endif
 
-/* This structure describes on entry in the neighbor table.  This is intended
- * for internal use within the Neighbor implementation.
+/* A neighbor cache.  The entries in use are kept in a hash table keyed by
+ * the protocol address and in a list in least recently used order.
  */
 
-struct neighbor_entry
+struct neighbor_cache_s
 {
-  net_ipv6addr_t         ne_ipaddr;  /* IPv6 address of the Neighbor */
-  struct neighbor_addr_s ne_addr;    /* Link layer address of the Neighbor */
-  uint8_t                ne_time;    /* For aging, units of half seconds */
+  FAR struct neighbor_entry_s *nc_table;  /* The array of entries */
+  FAR struct neighbor_entry_s **nc_hash;  /* Hash chain heads */
+  dq_queue_t nc_lru;                      /* Entries in use, LRU first */
+  dq_queue_t nc_free;                     /* Unused entries */
+  uint32_t   nc_maxage;                   /* Lifetime of entries (ticks) */
+  uint16_t   nc_nentries;                 /* Number of entries and chains */
+  uint8_t    nc_addrlen;                  /* Size of the protocol address */
+#ifdef CONFIG_NET_STATISTICS
+  struct neighbor_stats_s nc_stats;       /* Cache statistics */
+#endif
 };
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* This is the Neighbor table.  The network should be locked when accessing
- * this table.
+#ifdef CONFIG_NET_IPv6
+/* This is the IPv6 Neighbor cache.  The network should be locked when
+ * accessing this cache.
  */
 
-extern struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
-
-/* This is the time, in clock ticks, of the last poll */
-
-extern uint32_t g_neighbor_polltime;
+extern struct neighbor_cache_s g_neighbor_cache;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+struct net_driver_s;  /* Forward reference */
+
 /****************************************************************************
- * Name: neighbor_setup
+ * Name: neighbor_cache_initialize
  *
  * Description:
- *   Initialize Neighbor table data structures.  This function is called
- *   prior to platform-specific driver initialization so that the networking
- *   subsystem is prepared to deal with network driver initialization
- *   actions.
+ *   Initialize (or empty) a neighbor cache.
  *
  * Input Parameters:
- *   None
+ *   cache    - The neighbor cache to initialize
+ *   table    - The storage for the cache entries
+ *   hash     - The storage for the hash chain heads (one per entry)
+ *   nentries - The number of entries in 'table'
+ *   addrlen  - The size of the protocol address (4 or 16)
+ *   maxage   - The lifetime of unconfirmed entries in seconds
+ *
+ ****************************************************************************/
+
+void neighbor_cache_initialize(FAR struct neighbor_cache_s *cache,
+                               FAR struct neighbor_entry_s *table,
+                               FAR struct neighbor_entry_s **hash,
+                               unsigned int nentries, unsigned int addrlen,
+                               unsigned int maxage);
+
+/****************************************************************************
+ * Name: neighbor_cache_find
+ *
+ * Description:
+ *   Find the cache entry for a protocol address, whatever its state.
  *
  * Returned Value:
- *   None
+ *   The cache entry or NULL if there is none.
  *
  ****************************************************************************/
 
-void neighbor_setup(void);
+FAR struct neighbor_entry_s *
+  neighbor_cache_find(FAR struct neighbor_cache_s *cache,
+                      FAR const void *ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_cache_lookup
+ *
+ * Description:
+ *   Find the link layer address of a protocol address.  Expired entries
+ *   are removed.  The entry found becomes the most recently used.
+ *
+ * Returned Value:
+ *   A REACHABLE or STALE cache entry, or NULL if the address is not
+ *   resolved.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *
+  neighbor_cache_lookup(FAR struct neighbor_cache_s *cache,
+                        FAR const void *ipaddr);
 
 /****************************************************************************
- * Name: neighbor_initialize
+ * Name: neighbor_cache_update
  *
  * Description:
- *  Initialize Neighbor ageing.  This function is called from the OS
- *  initialization logic at power-up reset AFTER initialization of hardware
- *  facilities such as timers and interrupts.  This logic completes the
- *  initialization started by neighbor_setup.
+ *   Add or confirm the mapping of a protocol address to a link layer
+ *   address.  The entry becomes REACHABLE and the most recently used.
  *
+ * Returned Value:
+ *   The updated cache entry.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *
+  neighbor_cache_update(FAR struct neighbor_cache_s *cache,
+                        FAR const void *ipaddr, FAR const void *lladdr,
+                        unsigned int lladdrlen);
+
+/****************************************************************************
+ * Name: neighbor_cache_incomplete
+ *
+ * Description:
+ *   Return the entry for an address that is being resolved, creating an
+ *   INCOMPLETE entry if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *
+  neighbor_cache_incomplete(FAR struct neighbor_cache_s *cache,
+                            FAR const void *ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_cache_delete
+ *
+ * Description:
+ *   Remove an entry from the cache, discarding any queued packet.
+ *
+ ****************************************************************************/
+
+void neighbor_cache_delete(FAR struct neighbor_cache_s *cache,
+                           FAR struct neighbor_entry_s *entry);
+
+/****************************************************************************
+ * Name: neighbor_cache_age
+ *
+ * Description:
+ *   Remove expired entries and update the state of REACHABLE entries.
+ *   This is called periodically.
+ *
+ ****************************************************************************/
+
+void neighbor_cache_age(FAR struct neighbor_cache_s *cache);
+
+/****************************************************************************
+ * Name: neighbor_cache_enqueue
+ *
+ * Description:
+ *   Retain a copy of the packet awaiting resolution of the entry's address,
+ *   replacing any packet queued earlier.
+ *
+ * Input Parameters:
+ *   cache - The neighbor cache
+ *   entry - An INCOMPLETE cache entry
+ *   buf   - The packet to be queued (without link layer header)
+ *   len   - The length of the packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+void neighbor_cache_enqueue(FAR struct neighbor_cache_s *cache,
+                            FAR struct neighbor_entry_s *entry,
+                            FAR const uint8_t *buf, unsigned int len);
+#else
+#  define neighbor_cache_enqueue(c,e,b,l)
+#endif
+
+/****************************************************************************
+ * Name: neighbor_cache_dequeue
+ *
+ * Description:
+ *   Copy the packet queued on an entry into 'buf' and release it.
+ *
+ * Returned Value:
+ *   The length of the packet, or zero if no packet was queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+unsigned int neighbor_cache_dequeue(FAR struct neighbor_cache_s *cache,
+                                    FAR struct neighbor_entry_s *entry,
+                                    FAR uint8_t *buf, unsigned int buflen);
+#else
+#  define neighbor_cache_dequeue(c,e,b,l) (0)
+#endif
+
+#ifdef CONFIG_NET_IPv6
+/****************************************************************************
+ * Name: neighbor_setup
+ *
+ * Description:
+ *   Initialize Neighbor table data structures.  This function is called
+ *   prior to platform-specific driver initialization so that the networking
+ *   subsystem is prepared to deal with network driver initialization
+ *   actions.
  *
  * Input Parameters:
  *   None
@@ -143,7 +363,7 @@ void neighbor_setup(void);
  *
  ****************************************************************************/
 
-void neighbor_initialize(void);
+void neighbor_setup(void);
 
 /****************************************************************************
  * Name: neighbor_findentry
@@ -157,11 +377,11 @@ void neighbor_initialize(void);
  *
  * Returned Value:
  *   The Neighbor Table entry corresponding to the IPv6 address;  NULL is
- *   returned if there is no matching entry in the Neighbor Table.
+ *   returned if the address is not resolved.
  *
  ****************************************************************************/
 
-FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr);
+FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
 /****************************************************************************
  * Name: neighbor_add
@@ -217,6 +437,27 @@ FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr);
 
 void neighbor_update(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_dequeue
+ *
+ * Description:
+ *   Called when a Neighbor Advertisement has been received.  If a packet
+ *   was queued awaiting resolution of the IPv6 address, it is copied into
+ *   d_buf and d_len is set to its length so that the driver sends it in
+ *   place of a response.
+ *
+ * Returned Value:
+ *   true if a queued packet was placed in d_buf.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+bool neighbor_dequeue(FAR struct net_driver_s *dev,
+                      const net_ipv6addr_t ipaddr);
+#else
+#  define neighbor_dequeue(d,i) (false)
+#endif
+
 /****************************************************************************
  * Name: neighbor_periodic
  *
@@ -235,5 +476,5 @@ void neighbor_update(const net_ipv6addr_t ipaddr);
 void neighbor_periodic(void);
 
 #endif /* CONFIG_NET_IPv6 */
+#endif /* CONFIG_NET_ARP || CONFIG_NET_IPv6 */
 #endif /* __NET_NEIGHBOR_NEIGHBOR_H */
-
@@ -43,7 +43,6 @@
 
 #include <nuttx/config.h>
 
-#include <string.h>
 #include <debug.h>
 
 #include <nuttx/net/ip.h>
@@ -72,10 +71,6 @@
 
 void neighbor_add(FAR net_ipv6addr_t ipaddr, FAR struct neighbor_addr_s *addr)
 {
-  uint8_t oldest_time;
-  int     oldest_ndx;
-  int     i;
-
   nllvdbg("Add neighbor: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
           ntohs(ipaddr[0]), ntohs(ipaddr[1]), ntohs(ipaddr[2]),
           ntohs(ipaddr[3]), ntohs(ipaddr[4]), ntohs(ipaddr[5]),
@@ -88,37 +83,8 @@ void neighbor_add(FAR net_ipv6addr_t ipaddr, FAR struct neighbor_addr_s *addr)
           addr->na_addr.ether_addr_octet[4],
           addr->na_addr.ether_addr_octet[5]);
 
-  /* Find the first unused entry or the oldest used entry. */
-
-  oldest_time = 0;
-  oldest_ndx  = 0;
-
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
-    {
-      if (g_neighbors[i].ne_time == NEIGHBOR_MAXTIME)
-        {
-          oldest_ndx = i;
-          break;
-        }
-
-      if (net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          break;
-        }
-
-      if (g_neighbors[i].ne_time > oldest_time)
-        {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
-        }
-    }
-
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  /* Add the mapping or update an existing one */
 
-  g_neighbors[oldest_ndx].ne_time = 0;
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
-  memcpy(&g_neighbors[oldest_ndx].ne_addr, addr, sizeof(struct neighbor_addr_s));
+  (void)neighbor_cache_update(&g_neighbor_cache, ipaddr, addr,
+                              sizeof(struct neighbor_addr_s));
 }
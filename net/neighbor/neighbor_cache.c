@@ -0,0 +1,580 @@
+/****************************************************************************
+ * net/neighbor/neighbor_cache.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+#  include <nuttx/net/iob.h>
+#  include "iob/iob.h"
+#endif
+
+#include "neighbor/neighbor.h"
+
+#if defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* An INCOMPLETE entry is removed if no response is received within this
+ * time after the last address resolution request.
+ */
+
+#define NEIGHBOR_INCOMPLETE_TICKS SEC2TICK(3)
+
+/* A REACHABLE entry becomes STALE after this time */
+
+#define NEIGHBOR_REACHABLE_TICKS  SEC2TICK(CONFIG_NET_NEIGHBOR_REACHABLE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the index of the hash chain for a protocol address.
+ *
+ ****************************************************************************/
+
+static unsigned int neighbor_hash(FAR struct neighbor_cache_s *cache,
+                                  FAR const void *ipaddr)
+{
+  FAR const uint16_t *addr = (FAR const uint16_t *)ipaddr;
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < cache->nc_addrlen / sizeof(uint16_t); i++)
+    {
+      hash = hash * 31 + addr[i];
+    }
+
+  return hash % cache->nc_nentries;
+}
+
+/****************************************************************************
+ * Name: neighbor_expired
+ *
+ * Description:
+ *   Check if an entry has expired.  A REACHABLE entry that has not been
+ *   confirmed recently becomes STALE.
+ *
+ ****************************************************************************/
+
+static bool neighbor_expired(FAR struct neighbor_cache_s *cache,
+                             FAR struct neighbor_entry_s *entry,
+                             uint32_t now)
+{
+  uint32_t age = now - entry->ne_time;
+
+  if (entry->ne_state == NEIGHBOR_INCOMPLETE)
+    {
+      return age >= NEIGHBOR_INCOMPLETE_TICKS;
+    }
+
+  if (age >= cache->nc_maxage)
+    {
+      return true;
+    }
+
+  if (entry->ne_state == NEIGHBOR_REACHABLE &&
+      age >= NEIGHBOR_REACHABLE_TICKS)
+    {
+      entry->ne_state = NEIGHBOR_STALE;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make an entry the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void neighbor_touch(FAR struct neighbor_cache_s *cache,
+                                  FAR struct neighbor_entry_s *entry)
+{
+  dq_rem(&entry->ne_node, &cache->nc_lru);
+  dq_addlast(&entry->ne_node, &cache->nc_lru);
+}
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Allocate an entry for a new protocol address.  If there is no free
+ *   entry, the least recently used entry that is not REACHABLE is replaced
+ *   or, if all entries are REACHABLE, the least recently used entry.
+ *
+ ****************************************************************************/
+
+static FAR struct neighbor_entry_s *
+  neighbor_alloc(FAR struct neighbor_cache_s *cache, FAR const void *ipaddr)
+{
+  FAR struct neighbor_entry_s *entry;
+  unsigned int hash;
+
+  entry = (FAR struct neighbor_entry_s *)dq_peek(&cache->nc_free);
+  if (entry == NULL)
+    {
+      FAR dq_entry_t *node;
+
+      for (node = dq_peek(&cache->nc_lru); node != NULL; node = dq_next(node))
+        {
+          if (((FAR struct neighbor_entry_s *)node)->ne_state !=
+              NEIGHBOR_REACHABLE)
+            {
+              break;
+            }
+        }
+
+      if (node == NULL)
+        {
+          node = dq_peek(&cache->nc_lru);
+        }
+
+      entry = (FAR struct neighbor_entry_s *)node;
+      DEBUGASSERT(entry != NULL);
+
+      NEIGHBOR_STAT(cache, ns_evicted);
+      neighbor_cache_delete(cache, entry);
+    }
+
+  dq_rem(&entry->ne_node, &cache->nc_free);
+  dq_addlast(&entry->ne_node, &cache->nc_lru);
+
+  memcpy(&entry->ne_ipaddr, ipaddr, cache->nc_addrlen);
+  hash                 = neighbor_hash(cache, ipaddr);
+  entry->ne_hnext      = cache->nc_hash[hash];
+  cache->nc_hash[hash] = entry;
+  return entry;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_cache_initialize
+ *
+ * Description:
+ *   Initialize (or empty) a neighbor cache.
+ *
+ * Input Parameters:
+ *   cache    - The neighbor cache to initialize
+ *   table    - The storage for the cache entries
+ *   hash     - The storage for the hash chain heads (one per entry)
+ *   nentries - The number of entries in 'table'
+ *   addrlen  - The size of the protocol address (4 or 16)
+ *   maxage   - The lifetime of unconfirmed entries in seconds
+ *
+ ****************************************************************************/
+
+void neighbor_cache_initialize(FAR struct neighbor_cache_s *cache,
+                               FAR struct neighbor_entry_s *table,
+                               FAR struct neighbor_entry_s **hash,
+                               unsigned int nentries, unsigned int addrlen,
+                               unsigned int maxage)
+{
+  unsigned int i;
+
+  DEBUGASSERT(cache != NULL && table != NULL && hash != NULL &&
+              nentries > 0 && addrlen <= sizeof(table->ne_ipaddr));
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+  /* Release any packets still queued in a cache that is re-initialized */
+
+  if (cache->nc_table == table)
+    {
+      for (i = 0; i < nentries; i++)
+        {
+          if (table[i].ne_pending != NULL)
+            {
+              iob_free_chain(table[i].ne_pending);
+            }
+        }
+    }
+#endif
+
+  memset(cache, 0, sizeof(struct neighbor_cache_s));
+  memset(table, 0, nentries * sizeof(struct neighbor_entry_s));
+  memset(hash, 0, nentries * sizeof(FAR struct neighbor_entry_s *));
+
+  cache->nc_table    = table;
+  cache->nc_hash     = hash;
+  cache->nc_maxage   = SEC2TICK(maxage);
+  cache->nc_nentries = nentries;
+  cache->nc_addrlen  = addrlen;
+
+  for (i = 0; i < nentries; i++)
+    {
+      dq_addlast(&table[i].ne_node, &cache->nc_free);
+    }
+}
+
+/****************************************************************************
+ * Name: neighbor_cache_find
+ *
+ * Description:
+ *   Find the cache entry for a protocol address, whatever its state.
+ *
+ * Returned Value:
+ *   The cache entry or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *
+  neighbor_cache_find(FAR struct neighbor_cache_s *cache,
+                      FAR const void *ipaddr)
+{
+  FAR struct neighbor_entry_s *entry;
+
+  for (entry = cache->nc_hash[neighbor_hash(cache, ipaddr)];
+       entry != NULL;
+       entry = entry->ne_hnext)
+    {
+      if (memcmp(&entry->ne_ipaddr, ipaddr, cache->nc_addrlen) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: neighbor_cache_lookup
+ *
+ * Description:
+ *   Find the link layer address of a protocol address.  Expired entries
+ *   are removed.  The entry found becomes the most recently used.
+ *
+ * Returned Value:
+ *   A REACHABLE or STALE cache entry, or NULL if the address is not
+ *   resolved.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *
+  neighbor_cache_lookup(FAR struct neighbor_cache_s *cache,
+                        FAR const void *ipaddr)
+{
+  FAR struct neighbor_entry_s *entry;
+
+  NEIGHBOR_STAT(cache, ns_lookups);
+
+  entry = neighbor_cache_find(cache, ipaddr);
+  if (entry != NULL && neighbor_expired(cache, entry, clock_systimer()))
+    {
+      NEIGHBOR_STAT(cache, ns_expired);
+      neighbor_cache_delete(cache, entry);
+      entry = NULL;
+    }
+
+  if (entry == NULL || entry->ne_state == NEIGHBOR_INCOMPLETE)
+    {
+      NEIGHBOR_STAT(cache, ns_misses);
+      return NULL;
+    }
+
+  neighbor_touch(cache, entry);
+  return entry;
+}
+
+/****************************************************************************
+ * Name: neighbor_cache_update
+ *
+ * Description:
+ *   Add or confirm the mapping of a protocol address to a link layer
+ *   address.  The entry becomes REACHABLE and the most recently used.
+ *
+ * Returned Value:
+ *   The updated cache entry.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *
+  neighbor_cache_update(FAR struct neighbor_cache_s *cache,
+                        FAR const void *ipaddr, FAR const void *lladdr,
+                        unsigned int lladdrlen)
+{
+  FAR struct neighbor_entry_s *entry;
+
+  DEBUGASSERT(lladdrlen <= sizeof(entry->ne_lladdr));
+
+  entry = neighbor_cache_find(cache, ipaddr);
+  if (entry == NULL)
+    {
+      entry = neighbor_alloc(cache, ipaddr);
+    }
+  else
+    {
+      neighbor_touch(cache, entry);
+    }
+
+  memcpy(&entry->ne_lladdr, lladdr, lladdrlen);
+  entry->ne_state = NEIGHBOR_REACHABLE;
+  entry->ne_time  = clock_systimer();
+  return entry;
+}
+
+/****************************************************************************
+ * Name: neighbor_cache_incomplete
+ *
+ * Description:
+ *   Return the entry for an address that is being resolved, creating an
+ *   INCOMPLETE entry if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *
+  neighbor_cache_incomplete(FAR struct neighbor_cache_s *cache,
+                            FAR const void *ipaddr)
+{
+  FAR struct neighbor_entry_s *entry;
+
+  entry = neighbor_cache_find(cache, ipaddr);
+  if (entry == NULL)
+    {
+      entry = neighbor_alloc(cache, ipaddr);
+      entry->ne_state = NEIGHBOR_INCOMPLETE;
+    }
+
+  /* Each new request restarts the wait for the response */
+
+  if (entry->ne_state == NEIGHBOR_INCOMPLETE)
+    {
+      entry->ne_time = clock_systimer();
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: neighbor_cache_delete
+ *
+ * Description:
+ *   Remove an entry from the cache, discarding any queued packet.
+ *
+ ****************************************************************************/
+
+void neighbor_cache_delete(FAR struct neighbor_cache_s *cache,
+                           FAR struct neighbor_entry_s *entry)
+{
+  FAR struct neighbor_entry_s **pprev;
+
+  DEBUGASSERT(entry->ne_state != NEIGHBOR_FREE);
+
+  /* Remove the entry from its hash chain */
+
+  for (pprev = &cache->nc_hash[neighbor_hash(cache, &entry->ne_ipaddr)];
+       *pprev != NULL;
+       pprev = &(*pprev)->ne_hnext)
+    {
+      if (*pprev == entry)
+        {
+          *pprev = entry->ne_hnext;
+          break;
+        }
+    }
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+  if (entry->ne_pending != NULL)
+    {
+      iob_free_chain(entry->ne_pending);
+      entry->ne_pending = NULL;
+      NEIGHBOR_STAT(cache, ns_dropped);
+    }
+#endif
+
+  dq_rem(&entry->ne_node, &cache->nc_lru);
+  dq_addlast(&entry->ne_node, &cache->nc_free);
+
+  entry->ne_hnext = NULL;
+  entry->ne_state = NEIGHBOR_FREE;
+}
+
+/****************************************************************************
+ * Name: neighbor_cache_age
+ *
+ * Description:
+ *   Remove expired entries and update the state of REACHABLE entries.
+ *   This is called periodically.
+ *
+ ****************************************************************************/
+
+void neighbor_cache_age(FAR struct neighbor_cache_s *cache)
+{
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  uint32_t now = clock_systimer();
+
+  for (node = dq_peek(&cache->nc_lru); node != NULL; node = next)
+    {
+      FAR struct neighbor_entry_s *entry =
+        (FAR struct neighbor_entry_s *)node;
+
+      next = dq_next(node);
+      if (neighbor_expired(cache, entry, now))
+        {
+          NEIGHBOR_STAT(cache, ns_expired);
+          neighbor_cache_delete(cache, entry);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: neighbor_cache_enqueue
+ *
+ * Description:
+ *   Retain a copy of the packet awaiting resolution of the entry's address,
+ *   replacing any packet queued earlier.
+ *
+ * Input Parameters:
+ *   cache - The neighbor cache
+ *   entry - An INCOMPLETE cache entry
+ *   buf   - The packet to be queued (without link layer header)
+ *   len   - The length of the packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+void neighbor_cache_enqueue(FAR struct neighbor_cache_s *cache,
+                            FAR struct neighbor_entry_s *entry,
+                            FAR const uint8_t *buf, unsigned int len)
+{
+  FAR struct iob_s *iob;
+
+  /* Only the most recent packet is kept.  Higher level protocols will
+   * retransmit the others.
+   */
+
+  if (entry->ne_pending != NULL)
+    {
+      iob_free_chain(entry->ne_pending);
+      entry->ne_pending = NULL;
+      NEIGHBOR_STAT(cache, ns_dropped);
+    }
+
+  /* We are running in the driver's context and must not wait for I/O
+   * buffers to become available.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      nllvdbg("No I/O buffer for queued packet\n");
+      NEIGHBOR_STAT(cache, ns_dropped);
+      return;
+    }
+
+  if (iob_trycopyin(iob, buf, len, 0, true) < 0)
+    {
+      nllvdbg("Failed to queue packet\n");
+      iob_free_chain(iob);
+      NEIGHBOR_STAT(cache, ns_dropped);
+      return;
+    }
+
+  entry->ne_pending = iob;
+  NEIGHBOR_STAT(cache, ns_queued);
+}
+#endif
+
+/****************************************************************************
+ * Name: neighbor_cache_dequeue
+ *
+ * Description:
+ *   Copy the packet queued on an entry into 'buf' and release it.
+ *
+ * Returned Value:
+ *   The length of the packet, or zero if no packet was queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+unsigned int neighbor_cache_dequeue(FAR struct neighbor_cache_s *cache,
+                                    FAR struct neighbor_entry_s *entry,
+                                    FAR uint8_t *buf, unsigned int buflen)
+{
+  FAR struct iob_s *iob = entry->ne_pending;
+  int ret;
+
+  if (iob == NULL)
+    {
+      return 0;
+    }
+
+  entry->ne_pending = NULL;
+
+  if (iob->io_pktlen > buflen)
+    {
+      iob_free_chain(iob);
+      NEIGHBOR_STAT(cache, ns_dropped);
+      return 0;
+    }
+
+  ret = iob_copyout(buf, iob, iob->io_pktlen, 0);
+  iob_free_chain(iob);
+
+  if (ret <= 0)
+    {
+      NEIGHBOR_STAT(cache, ns_dropped);
+      return 0;
+    }
+
+  NEIGHBOR_STAT(cache, ns_sent);
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_NET_ARP || CONFIG_NET_IPv6 */
@@ -0,0 +1,113 @@
+/****************************************************************************
+ * net/neighbor/neighbor_dequeue.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <debug.h>
+
+#include <net/if.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#include "neighbor/neighbor.h"
+
+#if defined(CONFIG_NET_IPv6) && defined(CONFIG_NET_NEIGHBOR_QUEUE)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_dequeue
+ *
+ * Description:
+ *   Called when a Neighbor Advertisement has been received.  If a packet
+ *   was queued awaiting resolution of the IPv6 address, it is copied into
+ *   d_buf and d_len is set to its length so that the driver sends it in
+ *   place of a response.
+ *
+ * Input Parameters:
+ *   dev    - The device that received the Neighbor Advertisement
+ *   ipaddr - The IPv6 address that has been resolved
+ *
+ * Returned Value:
+ *   true if a queued packet was placed in d_buf.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool neighbor_dequeue(FAR struct net_driver_s *dev,
+                      const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_entry_s *neighbor;
+  unsigned int hdrlen = NET_LL_HDRLEN(dev);
+  unsigned int len;
+
+  neighbor = neighbor_cache_find(&g_neighbor_cache, ipaddr);
+  if (neighbor == NULL)
+    {
+      return false;
+    }
+
+  /* The packet buffer size (the MTU) includes the link layer header */
+
+  len = neighbor_cache_dequeue(&g_neighbor_cache, neighbor,
+                               &dev->d_buf[hdrlen],
+                               NET_DEV_MTU(dev) - hdrlen);
+  if (len == 0)
+    {
+      return false;
+    }
+
+  nllvdbg("Sending queued IPv6 packet: %u bytes\n", len);
+
+  /* The packet is an IPv6 packet without link layer header.  The driver
+   * will add the header when it calls neighbor_out().
+   */
+
+  IFF_SET_IPv6(dev->d_flags);
+  dev->d_len = len;
+  return true;
+}
+
+#endif /* CONFIG_NET_IPv6 && CONFIG_NET_NEIGHBOR_QUEUE */
@@ -43,13 +43,12 @@
 
 #include <nuttx/config.h>
 
-#include <string.h>
 #include <debug.h>
 
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
@@ -64,35 +63,31 @@
  *
  * Returned Value:
  *   The Neighbor Table entry corresponding to the IPv6 address;  NULL is
- *   returned if there is no matching entry in the Neighbor Table.
+ *   returned if the address is not resolved.
  *
  ****************************************************************************/
 
-FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
+FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry_s *neighbor;
 
   nllvdbg("Find neighbor: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
           ntohs(ipaddr[0]), ntohs(ipaddr[1]), ntohs(ipaddr[2]),
           ntohs(ipaddr[3]), ntohs(ipaddr[4]), ntohs(ipaddr[5]),
           ntohs(ipaddr[6]), ntohs(ipaddr[7]));
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  neighbor = neighbor_cache_lookup(&g_neighbor_cache, ipaddr);
+  if (neighbor != NULL)
     {
-      FAR struct neighbor_entry *neighbor = &g_neighbors[i];
+      nllvdbg("  at: %02x:%02x:%02x:%02x:%02x:%02x\n",
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[0],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[1],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[2],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[3],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[4],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[5]);
 
-      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
-        {
-          nllvdbg("  at: %02x:%02x:%02x:%02x:%02x:%02x\n",
-                  neighbor->ne_addr.na_addr.ether_addr_octet[0],
-                  neighbor->ne_addr.na_addr.ether_addr_octet[1],
-                  neighbor->ne_addr.na_addr.ether_addr_octet[2],
-                  neighbor->ne_addr.na_addr.ether_addr_octet[3],
-                  neighbor->ne_addr.na_addr.ether_addr_octet[4],
-                  neighbor->ne_addr.na_addr.ether_addr_octet[5]);
-
-          return &g_neighbors[i];
-        }
+      return neighbor;
     }
 
   nllvdbg("  Not found\n");
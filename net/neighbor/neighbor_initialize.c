@@ -42,10 +42,19 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
-#include <nuttx/clock.h>
 
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Storage for the Neighbor Table entries and hash chains */
+
+static struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+static FAR struct neighbor_entry_s *
+  g_neighbor_hash[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -54,11 +63,7 @@
  * this table.
  */
 
-struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
-
-/* This is the time, in clock ticks, of the last poll */
-
-uint32_t g_neighbor_polltime;
+struct neighbor_cache_s g_neighbor_cache;
 
 /****************************************************************************
  * Public Functions
@@ -83,35 +88,8 @@ uint32_t g_neighbor_polltime;
 
 void neighbor_setup(void)
 {
-  int i;
-
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
-    {
-      g_neighbors[i].ne_time = NEIGHBOR_MAXTIME;
-    }
-}
-
-/****************************************************************************
- * Name: neighbor_initialize
- *
- * Description:
- *  Initialize Neighbor ageing.  This function is called from the OS
- *  initialization logic at power-up reset AFTER initialization of hardware
- *  facilities such as timers and interrupts.  This logic completes the
- *  initialization started by neighbor_setup.
- *
- *
- * Input Parameters:
- *   None
- *
- * Returned Value:
- *   None
- *
- ****************************************************************************/
-
-void neighbor_initialize(void)
-{
-  /* Initialize the time of the last poll */
-
-   g_neighbor_polltime = clock_systimer();
+  neighbor_cache_initialize(&g_neighbor_cache, g_neighbors, g_neighbor_hash,
+                            CONFIG_NET_IPv6_NCONF_ENTRIES,
+                            sizeof(net_ipv6addr_t),
+                            CONFIG_NET_IPv6_NEIGHBOR_MAXAGE);
 }
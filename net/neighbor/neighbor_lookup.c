@@ -71,20 +71,20 @@
 
 FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr)
 {
-  FAR struct neighbor_entry *neighbor;
+  FAR struct neighbor_entry_s *neighbor;
 
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
       nllvdbg("Lookup neighbor: %02x:%02x:%02x:%02x:%02x:%02x\n",
-              neighbor->ne_addr.na_addr.ether_addr_octet[0],
-              neighbor->ne_addr.na_addr.ether_addr_octet[1],
-              neighbor->ne_addr.na_addr.ether_addr_octet[2],
-              neighbor->ne_addr.na_addr.ether_addr_octet[3],
-              neighbor->ne_addr.na_addr.ether_addr_octet[4],
-              neighbor->ne_addr.na_addr.ether_addr_octet[5]);
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[0],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[1],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[2],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[3],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[4],
+              neighbor->ne_lladdr.nd.na_addr.ether_addr_octet[5]);
 
-      return &neighbor->ne_addr;
+      return &neighbor->ne_lladdr.nd;
     }
 
   return NULL;
@@ -116,7 +116,9 @@ static const uint8_t g_multicast_ethaddr[3] = {0x01, 0x00, 0x5e};
  *   the packet in the d_buf[] is replaced by an ICMPv6 Neighbor Solicit
  *   request packet for the IPv6 address. The IPv6 packet is dropped and 
  *   it is assumed that the higher level protocols (e.g., TCP) eventually
- *   will retransmit the dropped packet.
+ *   will retransmit the dropped packet (unless CONFIG_NET_NEIGHBOR_QUEUE
+ *   is selected, in which case it is sent when the Neighbor Advertisement
+ *   is received).
  *
  *   Upon return in either the case, a packet to be sent is present in the
  *   d_buf[] buffer and the d_len field holds the length of the Ethernet
@@ -127,6 +129,9 @@ static const uint8_t g_multicast_ethaddr[3] = {0x01, 0x00, 0x5e};
 void neighbor_out(FAR struct net_driver_s *dev)
 {
   FAR const struct neighbor_addr_s *naddr;
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+  FAR struct neighbor_entry_s *entry;
+#endif
   FAR struct eth_hdr_s *eth = ETHBUF;
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   net_ipv6addr_t ipaddr;
@@ -222,6 +227,17 @@ void neighbor_out(FAR struct net_driver_s *dev)
         {
            nllvdbg("IPv6 Neighbor solicitation for IPv6\n");
 
+#ifdef CONFIG_NET_NEIGHBOR_QUEUE
+          /* Keep a copy of the IPv6 packet so that it can be sent when
+           * the Neighbor Advertisement is received.
+           */
+
+          entry = neighbor_cache_incomplete(&g_neighbor_cache, ipaddr);
+          neighbor_cache_enqueue(&g_neighbor_cache, entry,
+                                 &dev->d_buf[NET_LL_HDRLEN(dev)],
+                                 dev->d_len);
+#endif
+
           /* The destination address was not in our Neighbor Table, so we
            * overwrite the IPv6 packet with an ICMDv6 Neighbor Solicitation
            * message.
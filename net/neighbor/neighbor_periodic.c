@@ -42,18 +42,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
-#include <nuttx/clock.h>
 
 #include "neighbor/neighbor.h"
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-#define USEC_PER_HSEC    500000
-#define TICK_PER_HSEC    (USEC_PER_HSEC / USEC_PER_TICK)   /* Truncates! */
-#define TICK2HSEC(tick)  (((tick)+(TICK_PER_HSEC/2))/TICK_PER_HSEC) /* Rounds */
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -75,33 +66,5 @@
 
 void neighbor_periodic(void)
 {
-  uint32_t now;
-  uint32_t ticks;
-  uint32_t hsecs;
-  int i;
-
-  /* Get the elapsed time in units of half seconds */
-
-  now   = clock_systimer();
-  ticks = now - g_neighbor_polltime;
-  hsecs = TICK2HSEC(ticks);
-
-  /* Reset the time of the last poll */
-
-  g_neighbor_polltime = now;
-
-  /* Add the elapsed half seconds from each activate entry in the
-   * Neighbor table.
-   */
-
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
-    {
-      uint32_t newtime = g_neighbors[i].ne_time + hsecs;
-      if (newtime > NEIGHBOR_MAXTIME)
-        {
-          newtime = NEIGHBOR_MAXTIME;
-        }
-
-      g_neighbors[i].ne_time = newtime;
-    }
+  neighbor_cache_age(&g_neighbor_cache);
 }
@@ -0,0 +1,539 @@
+/****************************************************************************
+ * net/neighbor/neighbor_procfs.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/net/net.h>
+
+#include "neighbor/neighbor.h"
+#include "arp/arp.h"
+
+#if (defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)) && \
+    defined(CONFIG_FS_PROCFS) && !defined(CONFIG_DISABLE_MOUNTPOINT) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define NEIGHBOR_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct neighbor_file_s
+{
+  struct procfs_file_s base;   /* Base open file structure */
+  unsigned int index;          /* Index of the next line */
+  unsigned int linesize;       /* Number of valid characters in line[] */
+  unsigned int lineoffset;     /* Number of characters already returned */
+  char line[NEIGHBOR_LINELEN]; /* Buffer for the formatted line */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     neighbor_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     neighbor_close(FAR struct file *filep);
+static ssize_t neighbor_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     neighbor_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     neighbor_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Neighbor cache state names, indexed by ne_state */
+
+static FAR const char *g_neighbor_states[] =
+{
+  "FREE",
+  "INCOMPLETE",
+  "REACHABLE",
+  "STALE"
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs/procfs/fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations neighbor_procfsoperations =
+{
+  neighbor_open,     /* open */
+  neighbor_close,    /* close */
+  neighbor_read,     /* read */
+  NULL,              /* write */
+
+  neighbor_dup,      /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  neighbor_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_nth
+ *
+ * Description:
+ *   Return the n'th entry of a cache in least recently used order.  If
+ *   there are fewer entries, 'index' is reduced by the number of entries.
+ *
+ ****************************************************************************/
+
+static FAR struct neighbor_entry_s *
+  neighbor_nth(FAR struct neighbor_cache_s *cache, FAR unsigned int *index)
+{
+  FAR dq_entry_t *node;
+
+  for (node = dq_peek(&cache->nc_lru);
+       node != NULL && *index > 0;
+       node = dq_next(node))
+    {
+      (*index)--;
+    }
+
+  return (FAR struct neighbor_entry_s *)node;
+}
+
+/****************************************************************************
+ * Name: neighbor_lladdr
+ *
+ * Description:
+ *   Format the columns common to ARP and IPv6 entries.
+ *
+ ****************************************************************************/
+
+static int neighbor_lladdr(FAR struct neighbor_entry_s *entry,
+                           FAR const char *ipaddr, FAR char *line)
+{
+  FAR const uint8_t *mac = entry->ne_lladdr.eth.ether_addr_octet;
+  uint32_t age = clock_systimer() - entry->ne_time;
+
+  if (entry->ne_state == NEIGHBOR_INCOMPLETE)
+    {
+      return snprintf(line, NEIGHBOR_LINELEN, "%-39s %-17s %-10s %6lu\n",
+                      ipaddr, "-", g_neighbor_states[entry->ne_state],
+                      (unsigned long)(TICK2MSEC(age) / 1000));
+    }
+
+  return snprintf(line, NEIGHBOR_LINELEN,
+                  "%-39s %02x:%02x:%02x:%02x:%02x:%02x %-10s %6lu\n",
+                  ipaddr, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+                  g_neighbor_states[entry->ne_state],
+                  (unsigned long)(TICK2MSEC(age) / 1000));
+}
+
+/****************************************************************************
+ * Name: neighbor_arpline
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP
+static int neighbor_arpline(FAR struct neighbor_entry_s *entry,
+                            FAR char *line)
+{
+  FAR const uint8_t *ip = (FAR const uint8_t *)&entry->ne_ipaddr.ipv4;
+  char ipaddr[16];
+
+  snprintf(ipaddr, sizeof(ipaddr), "%u.%u.%u.%u",
+           ip[0], ip[1], ip[2], ip[3]);
+  return neighbor_lladdr(entry, ipaddr, line);
+}
+#endif
+
+/****************************************************************************
+ * Name: neighbor_ipv6line
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static int neighbor_ipv6line(FAR struct neighbor_entry_s *entry,
+                             FAR char *line)
+{
+  FAR const uint16_t *ip = entry->ne_ipaddr.ipv6;
+  char ipaddr[40];
+
+  snprintf(ipaddr, sizeof(ipaddr), "%x:%x:%x:%x:%x:%x:%x:%x",
+           ntohs(ip[0]), ntohs(ip[1]), ntohs(ip[2]), ntohs(ip[3]),
+           ntohs(ip[4]), ntohs(ip[5]), ntohs(ip[6]), ntohs(ip[7]));
+  return neighbor_lladdr(entry, ipaddr, line);
+}
+#endif
+
+/****************************************************************************
+ * Name: neighbor_statsline
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS
+static int neighbor_statsline(FAR struct neighbor_cache_s *cache,
+                              FAR const char *name, FAR char *line)
+{
+  FAR struct neighbor_stats_s *stats = &cache->nc_stats;
+
+  return snprintf(line, NEIGHBOR_LINELEN,
+                  "%s: lookups %lu misses %lu evicted %lu expired %lu "
+                  "queued %lu sent %lu dropped %lu\n", name,
+                  (unsigned long)stats->ns_lookups,
+                  (unsigned long)stats->ns_misses,
+                  (unsigned long)stats->ns_evicted,
+                  (unsigned long)stats->ns_expired,
+                  (unsigned long)stats->ns_queued,
+                  (unsigned long)stats->ns_sent,
+                  (unsigned long)stats->ns_dropped);
+}
+#endif
+
+/****************************************************************************
+ * Name: neighbor_nextline
+ *
+ * Description:
+ *   Format the next line of output into the line buffer.  Line zero is the
+ *   heading, followed by the ARP table entries, the IPv6 Neighbor Table
+ *   entries and, with CONFIG_NET_STATISTICS, the statistics of each table.
+ *
+ * Returned Value:
+ *   false if there is no further output.
+ *
+ ****************************************************************************/
+
+static bool neighbor_nextline(FAR struct neighbor_file_s *priv)
+{
+  FAR struct neighbor_entry_s *entry;
+  net_lock_t state;
+  unsigned int index;
+
+  priv->linesize   = 0;
+  priv->lineoffset = 0;
+
+  if (priv->index == 0)
+    {
+      priv->linesize = snprintf(priv->line, NEIGHBOR_LINELEN,
+                                "%-39s %-17s %-10s %6s\n", "Address",
+                                "HWaddr", "State", "Age");
+      priv->index++;
+      return true;
+    }
+
+  /* The tables may change between reads.  Just find the index'th line
+   * now.
+   */
+
+  index = priv->index - 1;
+  state = net_lock();
+
+#ifdef CONFIG_NET_ARP
+  entry = neighbor_nth(&g_arp_cache, &index);
+  if (entry != NULL)
+    {
+      priv->linesize = neighbor_arpline(entry, priv->line);
+      goto done;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  entry = neighbor_nth(&g_neighbor_cache, &index);
+  if (entry != NULL)
+    {
+      priv->linesize = neighbor_ipv6line(entry, priv->line);
+      goto done;
+    }
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+#ifdef CONFIG_NET_ARP
+  if (index-- == 0)
+    {
+      priv->linesize = neighbor_statsline(&g_arp_cache, "ARP",
+                                          priv->line);
+      goto done;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (index-- == 0)
+    {
+      priv->linesize = neighbor_statsline(&g_neighbor_cache, "IPv6",
+                                          priv->line);
+      goto done;
+    }
+#endif
+#endif
+
+  UNUSED(entry);
+
+done:
+  net_unlock(state);
+
+  if (priv->linesize == 0)
+    {
+      return false;
+    }
+
+  if (priv->linesize >= NEIGHBOR_LINELEN)
+    {
+      priv->linesize = NEIGHBOR_LINELEN - 1;
+    }
+
+  priv->index++;
+  return true;
+}
+
+/****************************************************************************
+ * Name: neighbor_open
+ ****************************************************************************/
+
+static int neighbor_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct neighbor_file_s *priv;
+
+  fvdbg("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      fdbg("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "net/neighbor" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "net/neighbor") != 0)
+    {
+      fdbg("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  priv = (FAR struct neighbor_file_s *)
+    kmm_zalloc(sizeof(struct neighbor_file_s));
+
+  if (!priv)
+    {
+      fdbg("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: neighbor_close
+ ****************************************************************************/
+
+static int neighbor_close(FAR struct file *filep)
+{
+  FAR struct neighbor_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct neighbor_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the file attributes structure */
+
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: neighbor_read
+ ****************************************************************************/
+
+static ssize_t neighbor_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct neighbor_file_s *priv;
+  size_t total = 0;
+  size_t ncopy;
+
+  fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct neighbor_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Return whole lines while there is space in the user buffer */
+
+  while (total < buflen)
+    {
+      if (priv->lineoffset >= priv->linesize && !neighbor_nextline(priv))
+        {
+          break;
+        }
+
+      ncopy = priv->linesize - priv->lineoffset;
+      if (ncopy > buflen - total)
+        {
+          ncopy = buflen - total;
+        }
+
+      memcpy(&buffer[total], &priv->line[priv->lineoffset], ncopy);
+      priv->lineoffset += ncopy;
+      total            += ncopy;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += total;
+  return total;
+}
+
+/****************************************************************************
+ * Name: neighbor_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int neighbor_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct neighbor_file_s *oldpriv;
+  FAR struct neighbor_file_s *newpriv;
+
+  fvdbg("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = (FAR struct neighbor_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newpriv = (FAR struct neighbor_file_s *)
+    kmm_malloc(sizeof(struct neighbor_file_s));
+
+  if (!newpriv)
+    {
+      fdbg("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newpriv, oldpriv, sizeof(struct neighbor_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: neighbor_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int neighbor_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "net/neighbor" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "net/neighbor") != 0)
+    {
+      fdbg("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "net/neighbor" is the name for a read-only file */
+
+  buf->st_mode    = S_IFREG|S_IROTH|S_IRGRP|S_IRUSR;
+  buf->st_size    = 0;
+  buf->st_blksize = 0;
+  buf->st_blocks  = 0;
+  return OK;
+}
+
+#endif /* (CONFIG_NET_ARP || CONFIG_NET_IPv6) && CONFIG_FS_PROCFS &&
+        * !CONFIG_DISABLE_MOUNTPOINT && !CONFIG_FS_PROCFS_EXCLUDE_NET */
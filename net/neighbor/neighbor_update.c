@@ -67,11 +67,13 @@
 
 void neighbor_update(const net_ipv6addr_t ipaddr)
 {
-  struct neighbor_entry *neighbor;
+  FAR struct neighbor_entry_s *neighbor;
 
-  neighbor = neighbor_findentry(ipaddr);
-  if (neighbor != NULL)
+  neighbor = neighbor_cache_find(&g_neighbor_cache, ipaddr);
+  if (neighbor != NULL && neighbor->ne_state != NEIGHBOR_INCOMPLETE)
     {
-      neighbor->ne_time = 0;
+      (void)neighbor_cache_update(&g_neighbor_cache, ipaddr,
+                                  &neighbor->ne_lladdr.nd,
+                                  sizeof(struct neighbor_addr_s));
     }
 }
@@ -197,15 +197,9 @@ void net_setup(void)
 
 void net_initialize(void)
 {
-#ifdef CONFIG_NET_IPv6
-  /* Configure Neighbor Table ageing */
-
-  neighbor_initialize();
-#endif
-
-  /* Initialize the periodic ARP timer */
-
-  arp_timer_initialize();
+  /* Nothing to do at present.  Ageing of the ARP table and of the IPv6
+   * Neighbor Table is performed by the network device timer poll.
+   */
 }
 
 #endif /* CONFIG_NET */
@@ -126,7 +126,7 @@ static int ioctl_addipv4route(FAR struct rtentry *rtentry)
       router = 0;
     }
 
-  return net_addroute(target, netmask, router);
+  return net_addroute(target, netmask, router, rtentry->rt_metric);
 }
 #endif /* CONFIG_NET_ROUTE && CONFIG_NET_IPv4 */
 
@@ -164,7 +164,9 @@ static int ioctl_addipv6route(FAR struct rtentry *rtentry)
       net_ipv6addr_copy(router, in6addr_any.s6_addr16);
     }
 
-  return net_addroute_ipv6(target->sin6_addr.s6_addr16, netmask->sin6_addr.s6_addr16, router);
+  return net_addroute_ipv6(target->sin6_addr.s6_addr16,
+                           netmask->sin6_addr.s6_addr16, router,
+                           rtentry->rt_metric);
 }
 #endif /* CONFIG_NET_ROUTE && CONFIG_NET_IPv6 */
 
@@ -716,6 +718,20 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
         break;;
     }
 
+#if defined(CONFIG_NET_ROUTE) && CONFIG_NET_ROUTE_CACHE > 0
+  /* Cached route look-ups for a device depend on its address and netmask */
+
+  if (ret == OK &&
+      (cmd == SIOCSIFADDR || cmd == SIOCSIFNETMASK ||
+       cmd == SIOCSLIFADDR || cmd == SIOCSLIFNETMASK ||
+       cmd == SIOCDIFADDR))
+    {
+      net_lock_t save = net_lock();
+      net_routecache_flush();
+      net_unlock(save);
+    }
+#endif
+
   return ret;
 }
 
@@ -0,0 +1,216 @@
+/****************************************************************************
+ * net/netdev/netdev_napi.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: netdev_napi_initialize
+ *
+ * Description:
+ *   Initialize the budgeted receive polling state of a device.  The device
+ *   starts in interrupt mode with all statistics cleared.
+ *
+ * Parameters:
+ *   napi   - The polling state to be initialized
+ *   budget - The maximum number of packets to receive per poll
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_napi_initialize(FAR struct netdev_napi_s *napi,
+                            unsigned int budget)
+{
+  DEBUGASSERT(napi != NULL && budget > 0 && budget <= UINT16_MAX);
+
+  memset(napi, 0, sizeof(struct netdev_napi_s));
+  napi->nn_budget = budget;
+}
+
+/****************************************************************************
+ * Function: netdev_napi_begin
+ *
+ * Description:
+ *   Start a new poll:  Refill the receive budget.  If the device is not in
+ *   polling mode, then the poll was started by an RX interrupt.
+ *
+ * Parameters:
+ *   napi - The polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the device lock.
+ *
+ ****************************************************************************/
+
+void netdev_napi_begin(FAR struct netdev_napi_s *napi)
+{
+  napi->nn_quota = napi->nn_budget;
+  napi->nn_polls++;
+
+  if (!napi->nn_polling)
+    {
+      napi->nn_interrupts++;
+    }
+}
+
+/****************************************************************************
+ * Function: netdev_napi_poll
+ *
+ * Description:
+ *   Receive packets by calling the driver's rxpoll function until it
+ *   reports that there are no further packets or until the budget of the
+ *   current poll has been used up.  This may be called several times
+ *   between netdev_napi_begin() and netdev_napi_complete(), for example
+ *   while other interrupt sources are also being serviced.
+ *
+ * Parameters:
+ *   dev    - The network device
+ *   napi   - The polling state of the device
+ *   rxpoll - Receives and dispatches a single packet
+ *
+ * Returned Value:
+ *   The number of packets received or, if the first call to rxpoll fails,
+ *   the negated errno value that it returned.
+ *
+ * Assumptions:
+ *   The caller holds the device lock.
+ *
+ ****************************************************************************/
+
+int netdev_napi_poll(FAR struct net_driver_s *dev,
+                     FAR struct netdev_napi_s *napi, netdev_rxpoll_t rxpoll)
+{
+  int npackets = 0;
+  int ret;
+
+  DEBUGASSERT(dev != NULL && napi != NULL && rxpoll != NULL);
+
+  while (napi->nn_quota > 0)
+    {
+      ret = rxpoll(dev);
+      if (ret <= 0)
+        {
+          if (npackets == 0)
+            {
+              npackets = ret;
+            }
+
+          break;
+        }
+
+      napi->nn_quota--;
+      napi->nn_burst++;
+      napi->nn_packets++;
+      npackets++;
+    }
+
+  return npackets;
+}
+
+/****************************************************************************
+ * Function: netdev_napi_complete
+ *
+ * Description:
+ *   End the current poll and select the mode of the device for the next
+ *   one.  If the budget was used up, more packets are probably waiting and
+ *   the device enters (or stays in) polling mode.  Otherwise, the receive
+ *   burst that began with the last interrupt has ended and the device
+ *   returns to interrupt mode.
+ *
+ * Parameters:
+ *   napi - The polling state of the device
+ *
+ * Returned Value:
+ *   True if the device is in polling mode:  The caller should leave the RX
+ *   interrupt disabled and schedule another poll.  False if the caller
+ *   should re-enable the RX interrupt.
+ *
+ * Assumptions:
+ *   The caller holds the device lock.
+ *
+ ****************************************************************************/
+
+bool netdev_napi_complete(FAR struct netdev_napi_s *napi)
+{
+  if (napi->nn_quota == 0)
+    {
+      if (!napi->nn_polling)
+        {
+          napi->nn_polling = true;
+          napi->nn_switches++;
+        }
+
+      /* Saturate the burst count; the maximum is only informative */
+
+      if (napi->nn_burst > UINT16_MAX - napi->nn_budget)
+        {
+          napi->nn_burst = UINT16_MAX - napi->nn_budget;
+        }
+
+      return true;
+    }
+
+  if (napi->nn_burst > napi->nn_maxburst)
+    {
+      napi->nn_maxburst = napi->nn_burst;
+    }
+
+  napi->nn_burst   = 0;
+  napi->nn_polling = false;
+  return false;
+}
+
+#endif /* CONFIG_NET */
@@ -257,6 +257,12 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb = NULL;
       dev->d_devcb = NULL;
 
+#ifdef CONFIG_NET_NOINTS
+      /* Initialize the device lock */
+
+      net_mutex_initialize(&dev->d_lock, NET_LOCKLEVEL_DEVICE);
+#endif
+
       /* Get the next available device number and assign a device name to
        * the interface
        */
@@ -139,6 +139,12 @@ int netdev_unregister(FAR struct net_driver_s *dev)
             }
 
           curr->flink = NULL;
+
+#ifdef CONFIG_NET_NOINTS
+          /* The driver no longer uses the device lock */
+
+          net_mutex_destroy(&curr->d_lock);
+#endif
         }
 
       net_unlock(save);
@@ -61,6 +61,50 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Function: net_insertroute
+ *
+ * Description:
+ *   Insert a route into the list of routes of a trie node so that the list
+ *   remains ordered by metric.  A new route follows existing routes with
+ *   the same metric.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static void net_insertroute(FAR struct route_node_s *node,
+                            FAR struct net_route_s *route)
+{
+  FAR struct net_route_s **pprev =
+    (FAR struct net_route_s **)&node->rn_routes;
+
+  while (*pprev != NULL && (*pprev)->metric <= route->metric)
+    {
+      pprev = &(*pprev)->mlink;
+    }
+
+  route->mlink = *pprev;
+  *pprev       = route;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static void net_insertroute_ipv6(FAR struct route_node_s *node,
+                                 FAR struct net_route_ipv6_s *route)
+{
+  FAR struct net_route_ipv6_s **pprev =
+    (FAR struct net_route_ipv6_s **)&node->rn_routes;
+
+  while (*pprev != NULL && (*pprev)->metric <= route->metric)
+    {
+      pprev = &(*pprev)->mlink;
+    }
+
+  route->mlink = *pprev;
+  *pprev       = route;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -72,6 +116,13 @@
  *   Add a new route to the routing table
  *
  * Parameters:
+ *   target   - The destination IP address on the destination network
+ *   netmask  - The mask defining the destination sub-net.  The one bits
+ *              must be contiguous.
+ *   router   - The IP address on one of our networks that provides the
+ *              router to the external network
+ *   metric   - Among routes for the same sub-net, the route with the
+ *              lowest metric is used.
  *
  * Returned Value:
  *   OK on success; Negated errno on failure.
@@ -79,10 +130,22 @@
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
+int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router,
+                 unsigned int metric)
 {
   FAR struct net_route_s *route;
+  FAR struct route_node_s *node;
   net_lock_t save;
+  int prefixlen;
+
+  /* Only contiguous network masks can be held in the routing trie */
+
+  prefixlen = route_prefixlen(&netmask, sizeof(in_addr_t));
+  if (prefixlen < 0)
+    {
+      ndbg("ERROR:  Invalid netmask: %08lx\n", (unsigned long)netmask);
+      return prefixlen;
+    }
 
   /* Allocate a route entry */
 
@@ -95,27 +158,57 @@ int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   /* Format the new route table entry */
 
-  net_ipv4addr_copy(route->target, target);
+  net_ipv4addr_copy(route->target, target & netmask);
   net_ipv4addr_copy(route->netmask, netmask);
   net_ipv4addr_copy(route->router, router);
+  route->metric    = metric > UINT16_MAX ? UINT16_MAX : metric;
+  route->prefixlen = prefixlen;
 
   /* Get exclusive address to the networking data structures */
 
   save = net_lock();
 
+  /* Find or create the trie node for the sub-net */
+
+  node = route_trie_insert(&g_routetrie, &route->target, prefixlen);
+  if (!node)
+    {
+      net_unlock(save);
+      net_freeroute(route);
+
+      ndbg("ERROR:  Failed to allocate a trie node\n");
+      return -ENOMEM;
+    }
+
   /* Then add the new entry to the table */
 
+  net_insertroute(node, route);
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes);
+
+  net_routecache_flush();
   net_unlock(save);
   return OK;
 }
 #endif
 
 #ifdef CONFIG_NET_IPv6
-int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask, net_ipv6addr_t router)
+int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
+                      net_ipv6addr_t router, unsigned int metric)
 {
   FAR struct net_route_ipv6_s *route;
+  FAR struct route_node_s *node;
   net_lock_t save;
+  int prefixlen;
+  int i;
+
+  /* Only contiguous network masks can be held in the routing trie */
+
+  prefixlen = route_prefixlen(netmask, sizeof(net_ipv6addr_t));
+  if (prefixlen < 0)
+    {
+      ndbg("ERROR:  Invalid netmask\n");
+      return prefixlen;
+    }
 
   /* Allocate a route entry */
 
@@ -128,17 +221,38 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask, net_ipv6add
 
   /* Format the new route table entry */
 
-  net_ipv6addr_copy(route->target, target);
+  for (i = 0; i < 8; i++)
+    {
+      route->target[i] = target[i] & netmask[i];
+    }
+
   net_ipv6addr_copy(route->netmask, netmask);
   net_ipv6addr_copy(route->router, router);
+  route->metric    = metric > UINT16_MAX ? UINT16_MAX : metric;
+  route->prefixlen = prefixlen;
 
   /* Get exclusive address to the networking data structures */
 
   save = net_lock();
 
+  /* Find or create the trie node for the sub-net */
+
+  node = route_trie_insert(&g_routetrie_ipv6, route->target, prefixlen);
+  if (!node)
+    {
+      net_unlock(save);
+      net_freeroute_ipv6(route);
+
+      ndbg("ERROR:  Failed to allocate a trie node\n");
+      return -ENOMEM;
+    }
+
   /* Then add the new entry to the table */
 
+  net_insertroute_ipv6(node, route);
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes_ipv6);
+
+  net_routecache_flush();
   net_unlock(save);
   return OK;
 }
@@ -64,6 +64,16 @@ sq_queue_t g_routes;
 sq_queue_t g_routes_ipv6;
 #endif
 
+/* These are the tries that index the routing table by prefix */
+
+#ifdef CONFIG_NET_IPv4
+struct route_trie_s g_routetrie;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct route_trie_s g_routetrie_ipv6;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -88,6 +98,16 @@ static struct net_route_s g_preallocroutes[CONFIG_NET_MAXROUTES];
 static struct net_route_ipv6_s g_preallocroutes_ipv6[CONFIG_NET_MAXROUTES];
 #endif
 
+/* These are the pre-allocated nodes of the routing tries */
+
+#ifdef CONFIG_NET_IPv4
+static struct route_node_s g_routenodes[ROUTE_NNODES];
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct route_node_s g_routenodes_ipv6[ROUTE_NNODES];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -126,6 +146,8 @@ void net_initroute(void)
       sq_addlast((FAR sq_entry_t *)&g_preallocroutes[i],
                  (FAR sq_queue_t *)&g_freeroutes);
     }
+
+  route_trie_initialize(&g_routetrie, g_routenodes, ROUTE_NNODES, 32);
 #endif
 
 #ifdef CONFIG_NET_IPv6
@@ -139,6 +161,9 @@ void net_initroute(void)
       sq_addlast((FAR sq_entry_t *)&g_preallocroutes_ipv6[i],
                  (FAR sq_queue_t *)&g_freeroutes_ipv6);
     }
+
+  route_trie_initialize(&g_routetrie_ipv6, g_routenodes_ipv6,
+                        ROUTE_NNODES, 128);
 #endif
 }
 
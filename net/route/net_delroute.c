@@ -43,6 +43,7 @@
 #include <string.h>
 #include <errno.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "route/route.h"
@@ -50,174 +51,132 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
 
 /****************************************************************************
- * Public Types
- ****************************************************************************/
-
-#ifdef CONFIG_NET_IPv4
-struct route_match_s
-{
-  FAR struct net_route_s *prev;     /* Predecessor in the list */
-  in_addr_t               target;   /* The target IP address to match */
-  in_addr_t               netmask;  /* The network mask to match */
-};
-#endif
-
-#ifdef CONFIG_NET_IPv6
-struct route_match_ipv6_s
-{
-  FAR struct net_route_ipv6_s *prev;     /* Predecessor in the list */
-  net_ipv6addr_t               target;   /* The target IP address to match */
-  net_ipv6addr_t               netmask;  /* The network mask to match */
-};
-#endif
-
-/****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Function: net_match
+ * Function: net_delroute
  *
  * Description:
- *   Return 1 if the route is available
+ *   Remove an existing route from the routing table.  If there are several
+ *   routes for the sub-net, the route with the lowest metric is removed.
  *
  * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
+ *   target   - The destination IP address on the destination network
+ *   netmask  - The mask defining the destination sub-net
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   OK on success; Negated errno on failure.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static int net_match(FAR struct net_route_s *route, FAR void *arg)
+int net_delroute(in_addr_t target, in_addr_t netmask)
 {
-  FAR struct route_match_s *match = ( FAR struct route_match_s *)arg;
-
-  /* To match, the masked target address must be the same, and the masks
-   * must be the same.
-   */
-
-  if (net_ipv4addr_maskcmp(route->target, match->target, match->netmask) &&
-      net_ipv4addr_cmp(route->netmask, match->netmask))
+  FAR struct net_route_s *route;
+  FAR struct route_node_s *node;
+  net_lock_t save;
+  in_addr_t key;
+  int prefixlen;
+
+  prefixlen = route_prefixlen(&netmask, sizeof(in_addr_t));
+  if (prefixlen < 0)
     {
-      /* They match.. Remove the entry from the routing table */
-
-      if (match->prev)
-        {
-          (void)sq_remafter((FAR sq_entry_t *)match->prev,
-                            (FAR sq_queue_t *)&g_routes);
-        }
-      else
-        {
-          (void)sq_remfirst((FAR sq_queue_t *)&g_routes);
-        }
-
-      /* And free the routing table entry by adding it to the free list */
-
-      net_freeroute(route);
-
-      /* Return a non-zero value to terminate the traversal */
-
-      return 1;
+      return -ENOENT;
     }
 
-  /* Next time we are here, this will be the previous entry */
+  key = target & netmask;
 
-  match->prev = route;
-  return 0;
-}
-#endif
+  /* Get exclusive address to the networking data structures */
 
-#ifdef CONFIG_NET_IPv6
-static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
-{
-  FAR struct route_match_ipv6_s *match = ( FAR struct route_match_ipv6_s *)arg;
+  save = net_lock();
 
-  /* To match, the masked target address must be the same, and the masks
-   * must be the same.
-   */
+  /* Find the trie node for exactly this sub-net */
 
-  if (net_ipv6addr_maskcmp(route->target, match->target, match->netmask) &&
-      net_ipv6addr_cmp(route->netmask, match->netmask))
+  node = route_trie_find(&g_routetrie, &key, prefixlen);
+  if (node == NULL || node->rn_routes == NULL)
     {
-      /* They match.. Remove the entry from the routing table */
-
-      if (match->prev)
-        {
-          (void)sq_remafter((FAR sq_entry_t *)match->prev,
-                            (FAR sq_queue_t *)&g_routes_ipv6);
-        }
-      else
-        {
-          (void)sq_remfirst((FAR sq_queue_t *)&g_routes_ipv6);
-        }
+      net_unlock(save);
+      return -ENOENT;
+    }
 
-      /* And free the routing table entry by adding it to the free list */
+  /* Remove the first route from the node and from the routing table */
 
-      net_freeroute_ipv6(route);
+  route           = (FAR struct net_route_s *)node->rn_routes;
+  node->rn_routes = route->mlink;
+  sq_rem((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes);
 
-      /* Return a non-zero value to terminate the traversal */
+  /* Release the node if it is no longer needed */
 
-      return 1;
+  if (node->rn_routes == NULL)
+    {
+      route_trie_remove(&g_routetrie, node);
     }
 
-  /* Next time we are here, this will be the previous entry */
+  net_routecache_flush();
+  net_unlock(save);
+
+  /* And free the routing table entry by adding it to the free list */
 
-  match->prev = route;
-  return 0;
+  net_freeroute(route);
+  return OK;
 }
 #endif
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+#ifdef CONFIG_NET_IPv6
+int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
+{
+  FAR struct net_route_ipv6_s *route;
+  FAR struct route_node_s *node;
+  net_ipv6addr_t key;
+  net_lock_t save;
+  int prefixlen;
+  int i;
+
+  prefixlen = route_prefixlen(netmask, sizeof(net_ipv6addr_t));
+  if (prefixlen < 0)
+    {
+      return -ENOENT;
+    }
 
-/****************************************************************************
- * Function: net_delroute
- *
- * Description:
- *   Remove an existing route from the routing table
- *
- * Parameters:
- *
- * Returned Value:
- *   OK on success; Negated errno on failure.
- *
- ****************************************************************************/
+  for (i = 0; i < 8; i++)
+    {
+      key[i] = target[i] & netmask[i];
+    }
 
-#ifdef CONFIG_NET_IPv4
-int net_delroute(in_addr_t target, in_addr_t netmask)
-{
-  struct route_match_s match;
+  /* Get exclusive address to the networking data structures */
 
-  /* Set up the comparison structure */
+  save = net_lock();
 
-  match.prev = NULL;
-  net_ipv4addr_copy(match.target, target);
-  net_ipv4addr_copy(match.netmask, netmask);
+  /* Find the trie node for exactly this sub-net */
+
+  node = route_trie_find(&g_routetrie_ipv6, key, prefixlen);
+  if (node == NULL || node->rn_routes == NULL)
+    {
+      net_unlock(save);
+      return -ENOENT;
+    }
 
-  /* Then remove the entry from the routing table */
+  /* Remove the first route from the node and from the routing table */
 
-  return net_foreachroute(net_match, &match) ? OK : -ENOENT;
-}
-#endif
+  route           = (FAR struct net_route_ipv6_s *)node->rn_routes;
+  node->rn_routes = route->mlink;
+  sq_rem((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes_ipv6);
 
-#ifdef CONFIG_NET_IPv6
-int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
-{
-  struct route_match_ipv6_s match;
+  /* Release the node if it is no longer needed */
 
-  /* Set up the comparison structure */
+  if (node->rn_routes == NULL)
+    {
+      route_trie_remove(&g_routetrie_ipv6, node);
+    }
 
-  match.prev = NULL;
-  net_ipv6addr_copy(match.target, target);
-  net_ipv6addr_copy(match.netmask, netmask);
+  net_routecache_flush();
+  net_unlock(save);
 
-  /* Then remove the entry from the routing table */
+  /* And free the routing table entry by adding it to the free list */
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  net_freeroute_ipv6(route);
+  return OK;
 }
 #endif
 
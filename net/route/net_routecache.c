@@ -0,0 +1,279 @@
+/****************************************************************************
+ * net/route/net_routecache.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/net/ip.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE) && \
+    CONFIG_NET_ROUTE_CACHE > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached route look-up.  An entry is valid only if its generation
+ * matches the current generation of the cache.
+ */
+
+#ifdef CONFIG_NET_IPv4
+struct route_cache_s
+{
+  FAR struct net_driver_s *dev;  /* Look-up constrained to this device */
+  uint32_t gen;                  /* Generation of the cache entry */
+  in_addr_t target;              /* The destination address */
+  in_addr_t router;              /* The router to use (if result is OK) */
+  int16_t result;                /* OK or -ENOENT */
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct route_cache_ipv6_s
+{
+  FAR struct net_driver_s *dev;  /* Look-up constrained to this device */
+  uint32_t gen;                  /* Generation of the cache entry */
+  net_ipv6addr_t target;         /* The destination address */
+  net_ipv6addr_t router;         /* The router to use (if result is OK) */
+  int16_t result;                /* OK or -ENOENT */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The current generation.  Incrementing it invalidates all entries.  It
+ * never is zero so that the zeroed entries are invalid initially.
+ */
+
+static uint32_t g_routecache_gen = 1;
+
+/* The direct-mapped caches */
+
+#ifdef CONFIG_NET_IPv4
+static struct route_cache_s g_routecache[CONFIG_NET_ROUTE_CACHE];
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct route_cache_ipv6_s g_routecache_ipv6[CONFIG_NET_ROUTE_CACHE];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_routecache_hash
+ *
+ * Description:
+ *   Select the cache entry for a destination address and device.
+ *
+ ****************************************************************************/
+
+static inline unsigned int net_routecache_hash(FAR struct net_driver_s *dev,
+                                               uint32_t addr)
+{
+  addr ^= (uint32_t)((uintptr_t)dev >> 4);
+  addr ^= addr >> 16;
+  addr ^= addr >> 8;
+  return addr % CONFIG_NET_ROUTE_CACHE;
+}
+
+#ifdef CONFIG_NET_IPv6
+static inline unsigned int
+  net_routecache_hash_ipv6(FAR struct net_driver_s *dev,
+                           FAR const net_ipv6addr_t addr)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      hash ^= ((uint32_t)addr[i] << 16) | addr[i + 1];
+    }
+
+  return net_routecache_hash(dev, hash);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_routecache_flush
+ *
+ * Description:
+ *   Invalidate all cached route look-ups.  Called whenever the routing
+ *   table changes.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void net_routecache_flush(void)
+{
+  if (++g_routecache_gen == 0)
+    {
+      /* The generation wrapped around.  Entries of generation 1 may still
+       * be present so they must really be cleared.
+       */
+
+#ifdef CONFIG_NET_IPv4
+      memset(g_routecache, 0, sizeof(g_routecache));
+#endif
+#ifdef CONFIG_NET_IPv6
+      memset(g_routecache_ipv6, 0, sizeof(g_routecache_ipv6));
+#endif
+      g_routecache_gen = 1;
+    }
+}
+
+/****************************************************************************
+ * Function: net_routecache_ipv4 and net_routecache_addipv4
+ *
+ * Description:
+ *   Look up, or remember, the result of a route look-up for an IPv4
+ *   address.  'dev' is NULL for look-ups that are not constrained to a
+ *   device.
+ *
+ * Returned Value:
+ *   net_routecache_ipv4() returns -EAGAIN if the look-up is not cached;
+ *   otherwise it returns the cached result (OK with 'router' set, or
+ *   -ENOENT).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_routecache_ipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                        FAR in_addr_t *router)
+{
+  FAR struct route_cache_s *entry =
+    &g_routecache[net_routecache_hash(dev, target)];
+
+  if (entry->gen != g_routecache_gen || entry->dev != dev ||
+      !net_ipv4addr_cmp(entry->target, target))
+    {
+      return -EAGAIN;
+    }
+
+  if (entry->result == OK)
+    {
+      net_ipv4addr_copy(*router, entry->router);
+    }
+
+  return entry->result;
+}
+
+void net_routecache_addipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                            in_addr_t router, int result)
+{
+  FAR struct route_cache_s *entry =
+    &g_routecache[net_routecache_hash(dev, target)];
+
+  entry->dev    = dev;
+  entry->gen    = g_routecache_gen;
+  entry->result = result;
+  net_ipv4addr_copy(entry->target, target);
+  net_ipv4addr_copy(entry->router, result == OK ? router : 0);
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Function: net_routecache_ipv6 and net_routecache_addipv6
+ *
+ * Description:
+ *   Look up, or remember, the result of a route look-up for an IPv6
+ *   address.  See net_routecache_ipv4().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int net_routecache_ipv6(FAR struct net_driver_s *dev,
+                        FAR const net_ipv6addr_t target,
+                        FAR net_ipv6addr_t router)
+{
+  FAR struct route_cache_ipv6_s *entry =
+    &g_routecache_ipv6[net_routecache_hash_ipv6(dev, target)];
+
+  if (entry->gen != g_routecache_gen || entry->dev != dev ||
+      !net_ipv6addr_cmp(entry->target, target))
+    {
+      return -EAGAIN;
+    }
+
+  if (entry->result == OK)
+    {
+      net_ipv6addr_copy(router, entry->router);
+    }
+
+  return entry->result;
+}
+
+void net_routecache_addipv6(FAR struct net_driver_s *dev,
+                            FAR const net_ipv6addr_t target,
+                            FAR const net_ipv6addr_t router, int result)
+{
+  FAR struct route_cache_ipv6_s *entry =
+    &g_routecache_ipv6[net_routecache_hash_ipv6(dev, target)];
+
+  entry->dev    = dev;
+  entry->gen    = g_routecache_gen;
+  entry->result = result;
+  net_ipv6addr_copy(entry->target, target);
+
+  if (result == OK)
+    {
+      net_ipv6addr_copy(entry->router, router);
+    }
+}
+#endif /* CONFIG_NET_IPv6 */
+
+#endif /* CONFIG_NET && CONFIG_NET_ROUTE && CONFIG_NET_ROUTE_CACHE > 0 */
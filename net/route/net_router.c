@@ -45,6 +45,7 @@
 
 #include <netinet/in.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "devif/devif.h"
@@ -59,16 +60,14 @@
 #ifdef CONFIG_NET_IPv4
 struct route_ipv4_match_s
 {
-  in_addr_t target;       /* Target IPv4 address on an external network to match */
-  in_addr_t router;       /* IPv4 address of the router on one of our networks*/
+  FAR struct net_route_s *route; /* The route for the longest prefix */
 };
 #endif
 
 #ifdef CONFIG_NET_IPv6
 struct route_ipv6_match_s
 {
-  net_ipv6addr_t target;  /* Target IPv6 address on an external network to match */
-  net_ipv6addr_t router;  /* IPv6 address of the router on one of our networks*/
+  FAR struct net_route_ipv6_s *route; /* The route for the longest prefix */
 };
 #endif
 
@@ -80,36 +79,28 @@ struct route_ipv6_match_s
  * Function: net_ipv4_match
  *
  * Description:
- *   Return 1 if the IPv4 route is available
+ *   Called by route_trie_match() for each sub-net that contains the target
+ *   address, from the shortest to the longest prefix.
  *
  * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
+ *   node - The trie node holding the routes for the sub-net
+ *   arg  - The match values (cast to void*)
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   None
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static int net_ipv4_match(FAR struct net_route_s *route, FAR void *arg)
+static void net_ipv4_match(FAR struct route_node_s *node, FAR void *arg)
 {
   FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
 
-  /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+  /* The routes are ordered by metric so the first is preferred.  A longer
+   * prefix is visited later and takes precedence.
    */
 
-  if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask))
-    {
-      /* They match.. Copy the router address */
-
-      net_ipv4addr_copy(match->router, route->router);
-      return 1;
-    }
-
-  return 0;
+  match->route = (FAR struct net_route_s *)node->rn_routes;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -117,36 +108,28 @@ static int net_ipv4_match(FAR struct net_route_s *route, FAR void *arg)
  * Function: net_ipv6_match
  *
  * Description:
- *   Return 1 if the IPv6 route is available
+ *   Called by route_trie_match() for each sub-net that contains the target
+ *   address, from the shortest to the longest prefix.
  *
  * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
+ *   node - The trie node holding the routes for the sub-net
+ *   arg  - The match values (cast to void*)
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   None
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv6
-static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
+static void net_ipv6_match(FAR struct route_node_s *node, FAR void *arg)
 {
   FAR struct route_ipv6_match_s *match = (FAR struct route_ipv6_match_s *)arg;
 
-  /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+  /* The routes are ordered by metric so the first is preferred.  A longer
+   * prefix is visited later and takes precedence.
    */
 
-  if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask))
-    {
-      /* They match.. Copy the router address */
-
-      net_ipv6addr_copy(match->router, route->router);
-      return 1;
-    }
-
-  return 0;
+  match->route = (FAR struct net_route_ipv6_s *)node->rn_routes;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -160,6 +143,7 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
  * Description:
  *   Given an IPv4 address on a external network, return the address of the
  *   router on a local network that can forward to the external network.
+ *   The route for the longest matching prefix is used.
  *
  * Parameters:
  *   target - An IPv4 address on a remote network to use in the lookup.
@@ -175,6 +159,7 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 {
   struct route_ipv4_match_s match;
+  net_lock_t save;
   int ret;
 
   /* Do not route the special broadcast IP address */
@@ -184,30 +169,40 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
       return -ENOENT;
     }
 
-  /* Set up the comparison structure */
+  /* Prevent concurrent access to the routing table */
 
-  memset(&match, 0, sizeof(struct route_ipv4_match_s));
-  net_ipv4addr_copy(match.target, target);
+  save = net_lock();
 
-  /* Find an router entry with the routing table that can forward to this
-   * address
-   */
+  /* The result of a previous look-up may be cached */
 
-  ret = net_foreachroute(net_ipv4_match, &match);
-  if (ret > 0)
+  ret = net_routecache_ipv4(NULL, target, router);
+  if (ret == -EAGAIN)
     {
-      /* We found a route.  Return the router address. */
+      /* Find the router entry with the longest prefix that can forward to
+       * this address
+       */
 
-      net_ipv4addr_copy(*router, match.router);
-      ret = OK;
-    }
-  else
-    {
-      /* There is no route for this address */
+      match.route = NULL;
+      route_trie_match(&g_routetrie, &target, net_ipv4_match, &match);
+
+      if (match.route != NULL)
+        {
+          /* We found a route.  Return the router address. */
+
+          net_ipv4addr_copy(*router, match.route->router);
+          ret = OK;
+        }
+      else
+        {
+          /* There is no route for this address */
 
-      ret = -ENOENT;
+          ret = -ENOENT;
+        }
+
+      net_routecache_addipv4(NULL, target, *router, ret);
     }
 
+  net_unlock(save);
   return ret;
 }
 #endif /* CONFIG_NET_IPv4 */
@@ -218,6 +213,7 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
  * Description:
  *   Given an IPv6 address on a external network, return the address of the
  *   router on a local network that can forward to the external network.
+ *   The route for the longest matching prefix is used.
  *
  * Parameters:
  *   target - An IPv6 address on a remote network to use in the lookup.
@@ -230,9 +226,10 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv6
-int net_ipv6_router(net_ipv6addr_t target, net_ipv6addr_t router)
+int net_ipv6_router(FAR const net_ipv6addr_t target, net_ipv6addr_t router)
 {
   struct route_ipv6_match_s match;
+  net_lock_t save;
   int ret;
 
   /* Do not route the special broadcast IP address */
@@ -242,30 +239,40 @@ int net_ipv6_router(net_ipv6addr_t target, net_ipv6addr_t router)
       return -ENOENT;
     }
 
-  /* Set up the comparison structure */
+  /* Prevent concurrent access to the routing table */
 
-  memset(&match, 0, sizeof(struct route_ipv6_match_s));
-  net_ipv6addr_copy(match.target, target);
+  save = net_lock();
 
-  /* Find an router entry with the routing table that can forward to this
-   * address
-   */
+  /* The result of a previous look-up may be cached */
 
-  ret = net_foreachroute_ipv6(net_ipv6_match, &match);
-  if (ret > 0)
+  ret = net_routecache_ipv6(NULL, target, router);
+  if (ret == -EAGAIN)
     {
-      /* We found a route.  Return the router address. */
+      /* Find the router entry with the longest prefix that can forward to
+       * this address
+       */
 
-      net_ipv6addr_copy(router, match.router);
-      ret = OK;
-    }
-  else
-    {
-      /* There is no route for this address */
+      match.route = NULL;
+      route_trie_match(&g_routetrie_ipv6, target, net_ipv6_match, &match);
+
+      if (match.route != NULL)
+        {
+          /* We found a route.  Return the router address. */
+
+          net_ipv6addr_copy(router, match.route->router);
+          ret = OK;
+        }
+      else
+        {
+          /* There is no route for this address */
+
+          ret = -ENOENT;
+        }
 
-      ret = -ENOENT;
+      net_routecache_addipv6(NULL, target, router, ret);
     }
 
+  net_unlock(save);
   return ret;
 }
 #endif /* CONFIG_NET_IPv6 */
@@ -0,0 +1,467 @@
+/****************************************************************************
+ * net/route/net_routetrie.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: route_bit
+ *
+ * Description:
+ *   Return bit 'n' of a key, counting from the most significant bit of the
+ *   first byte.
+ *
+ ****************************************************************************/
+
+static inline int route_bit(FAR const uint8_t *key, unsigned int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Function: route_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'maxbits', that two keys have
+ *   in common.
+ *
+ ****************************************************************************/
+
+static unsigned int route_common(FAR const uint8_t *key1,
+                                 FAR const uint8_t *key2,
+                                 unsigned int maxbits)
+{
+  unsigned int nbits = 0;
+  uint8_t diff;
+
+  while (nbits < maxbits)
+    {
+      diff = key1[nbits >> 3] ^ key2[nbits >> 3];
+      if (diff != 0)
+        {
+          /* Count the equal bits before the first difference */
+
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          break;
+        }
+
+      nbits += 8;
+    }
+
+  return nbits < maxbits ? nbits : maxbits;
+}
+
+/****************************************************************************
+ * Function: route_allocnode
+ *
+ * Description:
+ *   Allocate a node and set its prefix.  Bits of the key beyond the prefix
+ *   length are cleared.
+ *
+ ****************************************************************************/
+
+static FAR struct route_node_s *
+  route_allocnode(FAR struct route_trie_s *trie, FAR const uint8_t *key,
+                  unsigned int prefixlen)
+{
+  FAR struct route_node_s *node = trie->rt_free;
+  unsigned int nbytes = (prefixlen + 7) >> 3;
+
+  DEBUGASSERT(node != NULL);
+  trie->rt_free = node->rn_parent;
+  trie->rt_nfree--;
+
+  memset(node, 0, sizeof(struct route_node_s));
+  memcpy(node->rn_key, key, nbytes);
+  if ((prefixlen & 7) != 0)
+    {
+      node->rn_key[nbytes - 1] &= (uint8_t)(0xff << (8 - (prefixlen & 7)));
+    }
+
+  node->rn_prefixlen = prefixlen;
+  return node;
+}
+
+/****************************************************************************
+ * Function: route_freenode
+ ****************************************************************************/
+
+static void route_freenode(FAR struct route_trie_s *trie,
+                           FAR struct route_node_s *node)
+{
+  node->rn_parent = trie->rt_free;
+  trie->rt_free   = node;
+  trie->rt_nfree++;
+}
+
+/****************************************************************************
+ * Function: route_replace
+ *
+ * Description:
+ *   Replace 'node' by 'newnode' in the parent of 'node'.
+ *
+ ****************************************************************************/
+
+static void route_replace(FAR struct route_trie_s *trie,
+                          FAR struct route_node_s *node,
+                          FAR struct route_node_s *newnode)
+{
+  FAR struct route_node_s *parent = node->rn_parent;
+
+  if (parent == NULL)
+    {
+      trie->rt_root = newnode;
+    }
+  else if (parent->rn_child[0] == node)
+    {
+      parent->rn_child[0] = newnode;
+    }
+  else
+    {
+      parent->rn_child[1] = newnode;
+    }
+
+  if (newnode != NULL)
+    {
+      newnode->rn_parent = parent;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: route_prefixlen
+ *
+ * Description:
+ *   Return the number of leading one bits in a network mask.
+ *
+ * Parameters:
+ *   netmask - The network mask in network order
+ *   nbytes  - The size of the network mask
+ *
+ * Returned Value:
+ *   The prefix length; -EINVAL if the one bits are not contiguous.
+ *
+ ****************************************************************************/
+
+int route_prefixlen(FAR const void *netmask, unsigned int nbytes)
+{
+  FAR const uint8_t *mask = (FAR const uint8_t *)netmask;
+  unsigned int prefixlen = 0;
+  unsigned int i;
+  uint8_t byte;
+
+  for (i = 0; i < nbytes && mask[i] == 0xff; i++)
+    {
+      prefixlen += 8;
+    }
+
+  if (i < nbytes)
+    {
+      /* The remaining one bits must be the leading bits of this byte */
+
+      for (byte = mask[i++]; (byte & 0x80) != 0; byte <<= 1)
+        {
+          prefixlen++;
+        }
+
+      if (byte != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (; i < nbytes; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return prefixlen;
+}
+
+/****************************************************************************
+ * Function: route_trie_initialize
+ *
+ * Description:
+ *   Initialize an empty routing trie using the provided node storage.
+ *
+ ****************************************************************************/
+
+void route_trie_initialize(FAR struct route_trie_s *trie,
+                           FAR struct route_node_s *nodes,
+                           unsigned int nnodes, unsigned int keybits)
+{
+  unsigned int i;
+
+  DEBUGASSERT(keybits <= 8 * ROUTE_KEYSIZE);
+
+  trie->rt_root    = NULL;
+  trie->rt_free    = NULL;
+  trie->rt_nfree   = 0;
+  trie->rt_keybits = keybits;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      route_freenode(trie, &nodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Function: route_trie_insert
+ *
+ * Description:
+ *   Return the node for a prefix, creating it if necessary.
+ *
+ * Returned Value:
+ *   The node or NULL if no node is available.
+ *
+ ****************************************************************************/
+
+FAR struct route_node_s *route_trie_insert(FAR struct route_trie_s *trie,
+                                           FAR const void *key,
+                                           unsigned int prefixlen)
+{
+  FAR const uint8_t *addr = (FAR const uint8_t *)key;
+  FAR struct route_node_s *parent = NULL;
+  FAR struct route_node_s *node;
+  FAR struct route_node_s *newnode;
+  FAR struct route_node_s *branch;
+  unsigned int common = 0;
+
+  DEBUGASSERT(prefixlen <= trie->rt_keybits);
+
+  /* Descend while the prefix of the node is a prefix of the new prefix */
+
+  for (node = trie->rt_root; node != NULL; )
+    {
+      common = route_common(node->rn_key, addr,
+                            node->rn_prefixlen < prefixlen ?
+                            node->rn_prefixlen : prefixlen);
+
+      if (common < node->rn_prefixlen)
+        {
+          break;
+        }
+
+      if (node->rn_prefixlen == prefixlen)
+        {
+          /* The prefix is already in the trie */
+
+          return node;
+        }
+
+      parent = node;
+      node   = node->rn_child[route_bit(addr, node->rn_prefixlen)];
+    }
+
+  /* Two nodes are needed in the worst case */
+
+  if (trie->rt_nfree < 2)
+    {
+      return NULL;
+    }
+
+  newnode = route_allocnode(trie, addr, prefixlen);
+
+  if (node == NULL)
+    {
+      /* Add the new prefix as a leaf */
+
+      newnode->rn_parent = parent;
+      if (parent == NULL)
+        {
+          trie->rt_root = newnode;
+        }
+      else
+        {
+          parent->rn_child[route_bit(addr, parent->rn_prefixlen)] = newnode;
+        }
+    }
+  else if (common == prefixlen)
+    {
+      /* The new prefix is a prefix of the node.  It is inserted above the
+       * node.
+       */
+
+      route_replace(trie, node, newnode);
+      newnode->rn_child[route_bit(node->rn_key, prefixlen)] = node;
+      node->rn_parent = newnode;
+    }
+  else
+    {
+      /* The prefixes differ at bit 'common'.  A branch node with the common
+       * prefix replaces the node and holds both.
+       */
+
+      branch = route_allocnode(trie, addr, common);
+      route_replace(trie, node, branch);
+
+      branch->rn_child[route_bit(addr, common)]         = newnode;
+      branch->rn_child[route_bit(node->rn_key, common)] = node;
+      newnode->rn_parent = branch;
+      node->rn_parent    = branch;
+    }
+
+  return newnode;
+}
+
+/****************************************************************************
+ * Function: route_trie_find
+ *
+ * Description:
+ *   Return the node for exactly this prefix or NULL.
+ *
+ ****************************************************************************/
+
+FAR struct route_node_s *route_trie_find(FAR struct route_trie_s *trie,
+                                         FAR const void *key,
+                                         unsigned int prefixlen)
+{
+  FAR const uint8_t *addr = (FAR const uint8_t *)key;
+  FAR struct route_node_s *node = trie->rt_root;
+
+  while (node != NULL && node->rn_prefixlen <= prefixlen &&
+         route_common(node->rn_key, addr, node->rn_prefixlen) ==
+         node->rn_prefixlen)
+    {
+      if (node->rn_prefixlen == prefixlen)
+        {
+          return node;
+        }
+
+      node = node->rn_child[route_bit(addr, node->rn_prefixlen)];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Function: route_trie_remove
+ *
+ * Description:
+ *   Called after the last route was removed from a node.  The node and any
+ *   branch nodes that are no longer needed are freed.
+ *
+ ****************************************************************************/
+
+void route_trie_remove(FAR struct route_trie_s *trie,
+                       FAR struct route_node_s *node)
+{
+  FAR struct route_node_s *parent;
+  FAR struct route_node_s *child;
+
+  /* A node without routes is needed only if it has two children */
+
+  while (node != NULL && node->rn_routes == NULL &&
+         (node->rn_child[0] == NULL || node->rn_child[1] == NULL))
+    {
+      child  = node->rn_child[0] != NULL ? node->rn_child[0] :
+                                           node->rn_child[1];
+      parent = node->rn_parent;
+
+      route_replace(trie, node, child);
+      route_freenode(trie, node);
+
+      /* If the node had no child, the parent lost one child and may now be
+       * an unneeded branch node.
+       */
+
+      node = child == NULL ? parent : NULL;
+    }
+}
+
+/****************************************************************************
+ * Function: route_trie_match
+ *
+ * Description:
+ *   Call 'handler' for each node with routes whose prefix matches the
+ *   address, from the shortest to the longest prefix.  The handler called
+ *   last is for the longest matching prefix.
+ *
+ ****************************************************************************/
+
+void route_trie_match(FAR struct route_trie_s *trie, FAR const void *addr,
+                      route_match_t handler, FAR void *arg)
+{
+  FAR const uint8_t *key = (FAR const uint8_t *)addr;
+  FAR struct route_node_s *node = trie->rt_root;
+
+  while (node != NULL &&
+         route_common(node->rn_key, key, node->rn_prefixlen) ==
+         node->rn_prefixlen)
+    {
+      if (node->rn_routes != NULL)
+        {
+          handler(node, arg);
+        }
+
+      if (node->rn_prefixlen >= trie->rt_keybits)
+        {
+          break;
+        }
+
+      node = node->rn_child[route_bit(key, node->rn_prefixlen)];
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_ROUTE */
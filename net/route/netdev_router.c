@@ -43,6 +43,7 @@
 #include <string.h>
 #include <errno.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 
@@ -58,18 +59,16 @@
 #ifdef CONFIG_NET_IPv4
 struct route_ipv4_devmatch_s
 {
-  FAR struct net_driver_s *dev; /* The route must use this device */
-  in_addr_t target;             /* Target IPv4 address on an external network to match */
-  in_addr_t router;             /* IPv6 address of the router on one of our networks*/
+  FAR struct net_driver_s *dev;  /* The route must use this device */
+  FAR struct net_route_s *route; /* The route for the longest prefix */
 };
 #endif
 
 #ifdef CONFIG_NET_IPv6
 struct route_ipv6_devmatch_s
 {
-  FAR struct net_driver_s *dev; /* The route must use this device */
-  net_ipv6addr_t target;        /* Target IPv4 address on an external network to match */
-  net_ipv6addr_t router;        /* IPv6 address of the router on one of our networks*/
+  FAR struct net_driver_s *dev;       /* The route must use this device */
+  FAR struct net_route_ipv6_s *route; /* The route for the longest prefix */
 };
 #endif
 
@@ -81,40 +80,43 @@ struct route_ipv6_devmatch_s
  * Function: net_ipv4_devmatch
  *
  * Description:
- *   Return 1 if the IPv4 route is available on the device's network.
+ *   Called by route_trie_match() for each sub-net that contains the target
+ *   address, from the shortest to the longest prefix.  Remembers the
+ *   preferred route of the sub-net that is available on the device's
+ *   network.
  *
  * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
+ *   node - The trie node holding the routes for the sub-net
+ *   arg  - The match values (cast to void*)
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   None
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static int net_ipv4_devmatch(FAR struct net_route_s *route, FAR void *arg)
+static void net_ipv4_devmatch(FAR struct route_node_s *node, FAR void *arg)
 {
-  FAR struct route_ipv4_devmatch_s *match = (FAR struct route_ipv4_devmatch_s *)arg;
+  FAR struct route_ipv4_devmatch_s *match =
+    (FAR struct route_ipv4_devmatch_s *)arg;
   FAR struct net_driver_s *dev = match->dev;
+  FAR struct net_route_s *route;
 
-  /* To match, (1) the masked target addresses must be the same, and (2) the
-   * router address must like on the network provided by the device.
-   *
-   * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
+  /* The routes are ordered by metric.  Use the first one whose router lies
+   * on the network provided by the device.
    */
 
-  if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask) &&
-      net_ipv4addr_maskcmp(route->router, dev->d_ipaddr, dev->d_netmask))
+  for (route = (FAR struct net_route_s *)node->rn_routes;
+       route != NULL;
+       route = route->mlink)
     {
-      /* They match.. Copy the router address */
-
-      net_ipv4addr_copy(match->router, route->router);
-      return 1;
+      if (net_ipv4addr_maskcmp(route->router, dev->d_ipaddr,
+                               dev->d_netmask))
+        {
+          match->route = route;
+          break;
+        }
     }
-
-  return 0;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -122,40 +124,43 @@ static int net_ipv4_devmatch(FAR struct net_route_s *route, FAR void *arg)
  * Function: net_ipv6_devmatch
  *
  * Description:
- *   Return 1 if the IPv6 route is available on the device's network.
+ *   Called by route_trie_match() for each sub-net that contains the target
+ *   address, from the shortest to the longest prefix.  Remembers the
+ *   preferred route of the sub-net that is available on the device's
+ *   network.
  *
  * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
+ *   node - The trie node holding the routes for the sub-net
+ *   arg  - The match values (cast to void*)
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   None
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv6
-static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route, FAR void *arg)
+static void net_ipv6_devmatch(FAR struct route_node_s *node, FAR void *arg)
 {
-  FAR struct route_ipv6_devmatch_s *match = (FAR struct route_ipv6_devmatch_s *)arg;
+  FAR struct route_ipv6_devmatch_s *match =
+    (FAR struct route_ipv6_devmatch_s *)arg;
   FAR struct net_driver_s *dev = match->dev;
+  FAR struct net_route_ipv6_s *route;
 
-  /* To match, (1) the masked target addresses must be the same, and (2) the
-   * router address must like on the network provided by the device.
-   *
-   * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
+  /* The routes are ordered by metric.  Use the first one whose router lies
+   * on the network provided by the device.
    */
 
-  if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask) &&
-      net_ipv6addr_maskcmp(route->router, dev->d_ipv6addr, dev->d_ipv6netmask))
+  for (route = (FAR struct net_route_ipv6_s *)node->rn_routes;
+       route != NULL;
+       route = route->mlink)
     {
-      /* They match.. Copy the router address */
-
-      net_ipv6addr_copy(match->router, route->router);
-      return 1;
+      if (net_ipv6addr_maskcmp(route->router, dev->d_ipv6addr,
+                               dev->d_ipv6netmask))
+        {
+          match->route = route;
+          break;
+        }
     }
-
-  return 0;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -189,26 +194,44 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
                         FAR in_addr_t *router)
 {
   struct route_ipv4_devmatch_s match;
+  net_lock_t save;
   int ret;
 
-  /* Set up the comparison structure */
+  /* Prevent concurrent access to the routing table */
 
-  memset(&match, 0, sizeof(struct route_ipv4_devmatch_s));
-  match.dev = dev;
-  net_ipv4addr_copy(match.target, target);
+  save = net_lock();
 
-  /* Find an router entry with the routing table that can forward to this
-   * address using this device.
-   */
+  /* The result of a previous look-up may be cached */
 
-  ret = net_foreachroute(net_ipv4_devmatch, &match);
-  if (ret > 0)
+  ret = net_routecache_ipv4(dev, target, router);
+  if (ret == -EAGAIN)
     {
-      /* We found a route.  Return the router address. */
+      /* Find the router entry with the longest prefix that can forward to
+       * this address using this device.
+       */
+
+      match.dev   = dev;
+      match.route = NULL;
+      route_trie_match(&g_routetrie, &target, net_ipv4_devmatch, &match);
+
+      if (match.route != NULL)
+        {
+          /* We found a route.  Return the router address. */
+
+          net_ipv4addr_copy(*router, match.route->router);
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
 
-      net_ipv4addr_copy(*router, match.target);
+      net_routecache_addipv4(dev, target, *router, ret);
     }
-  else
+
+  net_unlock(save);
+
+  if (ret < 0)
     {
       /* There isn't a matching route.. fallback and use the default router
        * of the device.
@@ -246,26 +269,45 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR net_ipv6addr_t router)
 {
   struct route_ipv6_devmatch_s match;
+  net_lock_t save;
   int ret;
 
-  /* Set up the comparison structure */
+  /* Prevent concurrent access to the routing table */
 
-  memset(&match, 0, sizeof(struct route_ipv6_devmatch_s));
-  match.dev = dev;
-  net_ipv6addr_copy(match.target, target);
+  save = net_lock();
 
-  /* Find an router entry with the routing table that can forward to this
-   * address using this device.
-   */
+  /* The result of a previous look-up may be cached */
 
-  ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
-  if (ret > 0)
+  ret = net_routecache_ipv6(dev, target, router);
+  if (ret == -EAGAIN)
     {
-      /* We found a route.  Return the router address. */
+      /* Find the router entry with the longest prefix that can forward to
+       * this address using this device.
+       */
+
+      match.dev   = dev;
+      match.route = NULL;
+      route_trie_match(&g_routetrie_ipv6, target, net_ipv6_devmatch,
+                       &match);
 
-      net_ipv6addr_copy(router, match.target);
+      if (match.route != NULL)
+        {
+          /* We found a route.  Return the router address. */
+
+          net_ipv6addr_copy(router, match.route->router);
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
+
+      net_routecache_addipv6(dev, target, router, ret);
     }
-  else
+
+  net_unlock(save);
+
+  if (ret < 0)
     {
       /* There isn't a matching route.. fallback and use the default router
        * of the device.
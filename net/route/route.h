@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <queue.h>
 
 #include <net/if.h>
@@ -59,18 +60,68 @@
 #  define CONFIG_NET_MAXROUTES 4
 #endif
 
+#ifndef CONFIG_NET_ROUTE_CACHE
+#  define CONFIG_NET_ROUTE_CACHE 0
+#endif
+
+/* A path-compressed trie holding N prefixes needs at most N prefix nodes
+ * and N-1 branch nodes.
+ */
+
+#define ROUTE_NNODES (2 * CONFIG_NET_MAXROUTES)
+
+/* Size of the largest key (address) held in a routing trie */
+
+#ifdef CONFIG_NET_IPv6
+#  define ROUTE_KEYSIZE 16
+#else
+#  define ROUTE_KEYSIZE 4
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+/* One node of a routing trie.  The trie is a binary trie of address
+ * prefixes in which chains of nodes with a single child are compressed
+ * into one node.  A node with routes holds all routes for exactly its
+ * prefix; a node without routes is a branch point.
+ */
+
+struct route_node_s
+{
+  FAR struct route_node_s *rn_parent;   /* Parent node (or free list link) */
+  FAR struct route_node_s *rn_child[2]; /* Children by the next prefix bit */
+  FAR void *rn_routes;                  /* Routes, lowest metric first */
+  uint8_t rn_prefixlen;                 /* Length of the prefix in bits */
+  uint8_t rn_key[ROUTE_KEYSIZE];        /* The prefix in network order */
+};
+
+/* A routing trie for one address family */
+
+struct route_trie_s
+{
+  FAR struct route_node_s *rt_root;     /* Root of the trie */
+  FAR struct route_node_s *rt_free;     /* List of free nodes */
+  uint16_t rt_nfree;                    /* Number of free nodes */
+  uint8_t rt_keybits;                   /* Address size in bits */
+};
+
+/* Type of the call out function provided to route_trie_match() */
+
+typedef void (*route_match_t)(FAR struct route_node_s *node, FAR void *arg);
+
 /* This structure describes one entry in the routing table */
 
 #ifdef CONFIG_NET_IPv4
 struct net_route_s
 {
   FAR struct net_route_s *flink; /* Supports a singly linked list */
+  FAR struct net_route_s *mlink; /* Next route with the same prefix */
   in_addr_t target;              /* The destination network */
   in_addr_t netmask;             /* The network address mask */
   in_addr_t router;              /* Route packets via this router */
+  uint16_t metric;               /* Lower metrics are preferred */
+  uint8_t prefixlen;             /* Number of one bits in netmask */
 };
 
 /* Type of the call out function pointer provided to net_foreachroute() */
@@ -82,9 +133,12 @@ typedef int (*route_handler_t)(FAR struct net_route_s *route, FAR void *arg);
 struct net_route_ipv6_s
 {
   FAR struct net_route_ipv6_s *flink; /* Supports a singly linked list */
+  FAR struct net_route_ipv6_s *mlink; /* Next route with the same prefix */
   net_ipv6addr_t target;              /* The destination network */
   net_ipv6addr_t netmask;             /* The network address mask */
   net_ipv6addr_t router;              /* Route packets via this router */
+  uint16_t metric;                    /* Lower metrics are preferred */
+  uint8_t prefixlen;                  /* Number of one bits in netmask */
 };
 
 /* Type of the call out function pointer provided to net_foreachroute() */
@@ -107,10 +161,12 @@ extern "C"
 /* This is the routing table */
 #ifdef CONFIG_NET_IPv4
 EXTERN sq_queue_t g_routes;
+EXTERN struct route_trie_s g_routetrie;
 #endif
 
 #ifdef CONFIG_NET_IPv6
 EXTERN sq_queue_t g_routes_ipv6;
+EXTERN struct route_trie_s g_routetrie_ipv6;
 #endif
 
 /****************************************************************************
@@ -186,9 +242,12 @@ void net_freeroute_ipv6(FAR struct net_route_ipv6_s *route);
  *
  * Parameters:
  *   target   - The destination IP address on the destination network
- *   netmask  - The mask defining the destination sub-net
+ *   netmask  - The mask defining the destination sub-net.  The one bits
+ *              must be contiguous.
  *   router   - The IP address on one of our networks that provides the
  *              router to the external network
+ *   metric   - Among routes for the same sub-net, the route with the
+ *              lowest metric is used.
  *
  * Returned Value:
  *   OK on success; Negated errno on failure.
@@ -197,12 +256,12 @@ void net_freeroute_ipv6(FAR struct net_route_ipv6_s *route);
 
 #ifdef CONFIG_NET_IPv4
 int net_addroute(in_addr_t target, in_addr_t netmask,
-                 in_addr_t router);
+                 in_addr_t router, unsigned int metric);
 #endif
 
 #ifdef CONFIG_NET_IPv6
 int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
-                 net_ipv6addr_t router);
+                 net_ipv6addr_t router, unsigned int metric);
 #endif
 
 /****************************************************************************
@@ -265,7 +324,7 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router);
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv6
-int net_ipv6_router(net_ipv6addr_t target, net_ipv6addr_t router);
+int net_ipv6_router(FAR const net_ipv6addr_t target, net_ipv6addr_t router);
 #endif
 
 /****************************************************************************
@@ -323,6 +382,150 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR net_ipv6addr_t router);
 #endif
 
+/****************************************************************************
+ * Function: route_prefixlen
+ *
+ * Description:
+ *   Return the number of leading one bits in a network mask.
+ *
+ * Parameters:
+ *   netmask - The network mask in network order
+ *   nbytes  - The size of the network mask
+ *
+ * Returned Value:
+ *   The prefix length; -EINVAL if the one bits are not contiguous.
+ *
+ ****************************************************************************/
+
+int route_prefixlen(FAR const void *netmask, unsigned int nbytes);
+
+/****************************************************************************
+ * Function: route_trie_initialize
+ *
+ * Description:
+ *   Initialize an empty routing trie using the provided node storage.
+ *
+ ****************************************************************************/
+
+void route_trie_initialize(FAR struct route_trie_s *trie,
+                           FAR struct route_node_s *nodes,
+                           unsigned int nnodes, unsigned int keybits);
+
+/****************************************************************************
+ * Function: route_trie_insert
+ *
+ * Description:
+ *   Return the node for a prefix, creating it if necessary.
+ *
+ * Returned Value:
+ *   The node or NULL if no node is available.
+ *
+ ****************************************************************************/
+
+FAR struct route_node_s *route_trie_insert(FAR struct route_trie_s *trie,
+                                           FAR const void *key,
+                                           unsigned int prefixlen);
+
+/****************************************************************************
+ * Function: route_trie_find
+ *
+ * Description:
+ *   Return the node for exactly this prefix or NULL.
+ *
+ ****************************************************************************/
+
+FAR struct route_node_s *route_trie_find(FAR struct route_trie_s *trie,
+                                         FAR const void *key,
+                                         unsigned int prefixlen);
+
+/****************************************************************************
+ * Function: route_trie_remove
+ *
+ * Description:
+ *   Called after the last route was removed from a node.  The node and any
+ *   branch nodes that are no longer needed are freed.
+ *
+ ****************************************************************************/
+
+void route_trie_remove(FAR struct route_trie_s *trie,
+                       FAR struct route_node_s *node);
+
+/****************************************************************************
+ * Function: route_trie_match
+ *
+ * Description:
+ *   Call 'handler' for each node with routes whose prefix matches the
+ *   address, from the shortest to the longest prefix.  The handler called
+ *   last is for the longest matching prefix.
+ *
+ ****************************************************************************/
+
+void route_trie_match(FAR struct route_trie_s *trie, FAR const void *addr,
+                      route_match_t handler, FAR void *arg);
+
+/****************************************************************************
+ * Function: net_routecache_flush
+ *
+ * Description:
+ *   Invalidate all cached route look-ups.  Called whenever the routing
+ *   table changes.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ROUTE_CACHE > 0
+void net_routecache_flush(void);
+#else
+#  define net_routecache_flush()
+#endif
+
+/****************************************************************************
+ * Function: net_routecache_ipv4 and net_routecache_addipv4
+ *
+ * Description:
+ *   Look up, or remember, the result of a route look-up for an IPv4
+ *   address.  'dev' is NULL for look-ups that are not constrained to a
+ *   device.
+ *
+ * Returned Value:
+ *   net_routecache_ipv4() returns -EAGAIN if the look-up is not cached;
+ *   otherwise it returns the cached result (OK with 'router' set, or
+ *   -ENOENT).
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) && CONFIG_NET_ROUTE_CACHE > 0
+struct net_driver_s;
+int net_routecache_ipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                        FAR in_addr_t *router);
+void net_routecache_addipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                            in_addr_t router, int result);
+#else
+#  define net_routecache_ipv4(d,t,r)       (-EAGAIN)
+#  define net_routecache_addipv4(d,t,r,s)
+#endif
+
+/****************************************************************************
+ * Function: net_routecache_ipv6 and net_routecache_addipv6
+ *
+ * Description:
+ *   Look up, or remember, the result of a route look-up for an IPv6
+ *   address.  See net_routecache_ipv4().
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv6) && CONFIG_NET_ROUTE_CACHE > 0
+struct net_driver_s;
+int net_routecache_ipv6(FAR struct net_driver_s *dev,
+                        FAR const net_ipv6addr_t target,
+                        FAR net_ipv6addr_t router);
+void net_routecache_addipv6(FAR struct net_driver_s *dev,
+                            FAR const net_ipv6addr_t target,
+                            FAR const net_ipv6addr_t router, int result);
+#else
+#  define net_routecache_ipv6(d,t,r)       (-EAGAIN)
+#  define net_routecache_addipv6(d,t,r,s)
+#endif
+
 /****************************************************************************
  * Function: net_foreachroute
  *
@@ -332,7 +535,8 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
  * Parameters:
  *
  * Returned Value:
- *   OK on success; Negated errno on failure.
+ *   The first non-zero value returned by the handler, which terminates the
+ *   traversal; zero if all entries were visited.
  *
  ****************************************************************************/
 
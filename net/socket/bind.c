@@ -278,9 +278,18 @@ int psock_bind(FAR struct socket *psock, const struct sockaddr *addr,
           else
 #endif
             {
+              FAR struct udp_conn_s *conn =
+                (FAR struct udp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_SOCKOPTS
+              /* Share the port with other sockets if so requested */
+
+              conn->reuseport = _SO_GETOPT(psock->s_options, SO_REUSEPORT);
+#endif
+
               /* Bind the UDPP/IP connection structure */
 
-              ret = udp_bind(psock->s_conn, addr);
+              ret = udp_bind(conn, addr);
             }
 #endif /* CONFIG_NET_UDP */
 
@@ -52,12 +52,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <arch/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -96,6 +98,7 @@ struct sendfile_s
   FAR struct devif_callback_s *snd_datacb; /* Data callback */
   FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
   FAR struct file   *snd_file;    /* File structure of the input file */
+  FAR const uint8_t *snd_xipbase; /* Data at snd_foffset if mapped */
   sem_t              snd_sem;     /* Used to wake up the waiting thread */
   off_t              snd_foffset; /* Input file offset */
   size_t             snd_flen;    /* File length */
@@ -381,23 +384,37 @@ static uint16_t sendfile_interrupt(FAR struct net_driver_s *dev, FAR void *pvcon
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+          if (pstate->snd_xipbase)
             {
-              int errcode = get_errno();
-              nlldbg("failed to lseek: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
-            }
+              /* The file data is directly addressable.  Copy it straight
+               * into the packet buffer.
+               */
 
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+              memcpy(dev->d_appdata, pstate->snd_xipbase + pstate->snd_sent,
+                     sndlen);
+              ret = sndlen;
+            }
+          else
             {
-              int errcode = get_errno();
-              nlldbg("failed to read from input file: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  int errcode = get_errno();
+                  nlldbg("failed to lseek: %d\n", errcode);
+                  pstate->snd_sent = -errcode;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+              if (ret < 0)
+                {
+                  int errcode = get_errno();
+                  nlldbg("failed to read from input file: %d\n", errcode);
+                  pstate->snd_sent = -errcode;
+                  goto end_wait;
+                }
             }
 
           dev->d_sndlen = sndlen;
@@ -529,6 +546,69 @@ static inline void sendfile_txnotify(FAR struct socket *psock,
 #endif /* CONFIG_NET_IPv6 */
 }
 
+/****************************************************************************
+ * Function: sendfile_mmap
+ *
+ * Description:
+ *   If the input file is directly addressable (for example, a file on an
+ *   XIP ROMFS volume), return the address of the data at 'offset' and
+ *   truncate *count so that the transfer does not extend past the end of
+ *   the file.  Otherwise, return NULL; the data will then be obtained with
+ *   file_seek() and file_read() as each packet is sent.
+ *
+ * Parameters:
+ *   infile - The input file
+ *   offset - The file offset of the first byte to send
+ *   count  - The number of bytes to send
+ *
+ * Returned Value:
+ *   The address of the first byte to send or NULL.
+ *
+ * Assumptions:
+ *   Called from normal user mode, before the network is locked.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *sendfile_mmap(FAR struct file *infile,
+                                        off_t offset, FAR size_t *count)
+{
+  FAR struct inode *inode = infile->f_inode;
+  FAR void *addr = NULL;
+  off_t pos;
+  off_t end;
+  int ret;
+
+  if (!inode || !inode->u.i_ops || !inode->u.i_ops->ioctl)
+    {
+      return NULL;
+    }
+
+  ret = inode->u.i_ops->ioctl(infile, FIOC_MMAP,
+                              (unsigned long)((uintptr_t)&addr));
+  if (ret < 0 || addr == NULL)
+    {
+      return NULL;
+    }
+
+  /* Get the size of the file, leaving the file position unchanged */
+
+  pos = infile->f_pos;
+  end = file_seek(infile, 0, SEEK_END);
+  (void)file_seek(infile, pos, SEEK_SET);
+
+  if (end < 0 || offset >= end)
+    {
+      return NULL;
+    }
+
+  if (*count > end - offset)
+    {
+      *count = end - offset;
+    }
+
+  return (FAR const uint8_t *)addr + offset;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -602,9 +682,13 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
 {
   FAR struct socket *psock = sockfd_socket(outfd);
   FAR struct tcp_conn_s *conn;
+  FAR const uint8_t *xipbase;
   struct sendfile_s state;
   net_lock_t save;
-  int err;
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
+  int ret;
+#endif
+  int err = OK;
 
   /* Verify that the sockfd corresponds to valid, allocated socket */
 
@@ -663,6 +747,10 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* Check if the input file data can be sent without reading it */
+
+  xipbase = sendfile_mmap(infile, offset ? *offset : 0, &count);
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -680,6 +768,7 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
   state.snd_foffset = offset ? *offset : 0; /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+  state.snd_xipbase = xipbase;              /* Or NULL */
 
   /* Allocate resources to receive a callback */
 
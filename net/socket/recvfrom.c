@@ -1372,6 +1372,12 @@ static inline void recvfrom_udp_rxnotify(FAR struct socket *psock,
  *   Perform the recvfrom operation for packet socket
  *
  * Parameters:
+ *   psock  Pointer to the socket structure for the SOCK_RAW socket
+ *   buf    Buffer to receive data
+ *   len    Length of buffer
+ *   flags  Receive flags.  Packets are not buffered, so with MSG_DONTWAIT
+ *          EAGAIN is returned without waiting.
+ *   from   Address of source (may be NULL)
  *
  * Returned Value:
  *
@@ -1381,7 +1387,8 @@ static inline void recvfrom_udp_rxnotify(FAR struct socket *psock,
 
 #ifdef CONFIG_NET_PKT
 static ssize_t pkt_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                            FAR struct sockaddr *from, FAR socklen_t *fromlen)
+                            int flags, FAR struct sockaddr *from,
+                            FAR socklen_t *fromlen)
 {
   FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
   FAR struct net_driver_s *dev;
@@ -1389,6 +1396,15 @@ static ssize_t pkt_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
   net_lock_t save;
   int ret;
 
+  /* Packets are only received while a receiver is waiting for them, so
+   * there is never anything to return without waiting.
+   */
+
+  if ((flags & MSG_DONTWAIT) != 0)
+    {
+      return -EAGAIN;
+    }
+
   /* Perform the packet recvfrom() operation */
 
   /* Initialize the state structure.  This is done with interrupts
@@ -1470,6 +1486,9 @@ errout_with_state:
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
  *   buf    Buffer to receive data
  *   len    Length of buffer
+ *   flags  Receive flags.  With MSG_DONTWAIT, only a datagram already in
+ *          the read-ahead buffers is returned;  EAGAIN is returned if
+ *          there is none (always, if read-ahead buffering is disabled).
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1482,7 +1501,8 @@ errout_with_state:
 
 #ifdef CONFIG_NET_UDP
 static ssize_t udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                            FAR struct sockaddr *from, FAR socklen_t *fromlen)
+                            int flags, FAR struct sockaddr *from,
+                            FAR socklen_t *fromlen)
 {
   FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
   FAR struct net_driver_s *dev;
@@ -1528,7 +1548,7 @@ static ssize_t udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #endif
 
 #ifdef CONFIG_NET_UDP_READAHEAD
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1541,6 +1561,16 @@ static ssize_t udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
           ret = -EAGAIN;
         }
     }
+#else
+  /* Without read-ahead buffering, datagrams are only received while a
+   * receiver is waiting for them.
+   */
+
+  if ((flags & MSG_DONTWAIT) != 0)
+    {
+      ret = -EAGAIN;
+    }
+#endif
 
   /* It is okay to block if we need to.  If there is space to receive anything
    * more, then we will wait to receive the data.  Otherwise return the number
@@ -1549,7 +1579,10 @@ static ssize_t udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
    * NOTE: that recvfrom_udpreadahead() may set state.rf_recvlen == -1.
    */
 
+#ifdef CONFIG_NET_UDP_READAHEAD
   else if (state.rf_recvlen <= 0)
+#else
+  else
 #endif
     {
       /* Get the device that will handle the packet transfers.  This may be
@@ -1611,6 +1644,9 @@ errout_with_state:
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
  *   buf    Buffer to receive data
  *   len    Length of buffer
+ *   flags  Receive flags.  With MSG_DONTWAIT, only data already in the
+ *          read-ahead buffers is returned;  EAGAIN is returned if there is
+ *          none (always, if read-ahead buffering is disabled).
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1623,7 +1659,8 @@ errout_with_state:
 
 #ifdef CONFIG_NET_TCP
 static ssize_t tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                            FAR struct sockaddr *from, FAR socklen_t *fromlen)
+                            int flags, FAR struct sockaddr *from,
+                            FAR socklen_t *fromlen)
 {
   struct recvfrom_s       state;
   net_lock_t              save;
@@ -1699,7 +1736,7 @@ static ssize_t tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   else
 #ifdef CONFIG_NET_TCP_READAHEAD
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1719,6 +1756,16 @@ static ssize_t tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
    */
 
   else
+#else
+  /* Without read-ahead buffering, data is only received while a receiver
+   * is waiting for it.
+   */
+
+  if ((flags & MSG_DONTWAIT) != 0)
+    {
+      ret = -EAGAIN;
+    }
+  else
 #endif
 
   /* We get here when we we decide that we need to setup the wait for incoming
@@ -1930,7 +1977,7 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #ifdef CONFIG_NET_PKT
     case SOCK_RAW:
       {
-        ret = pkt_recvfrom(psock, buf, len, from, fromlen);
+        ret = pkt_recvfrom(psock, buf, len, flags, from, fromlen);
       }
       break;
 #endif /* CONFIG_NET_PKT */
@@ -1953,7 +2000,7 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         else
 #endif
           {
-            ret = tcp_recvfrom(psock, buf, len, from, fromlen);
+            ret = tcp_recvfrom(psock, buf, len, flags, from, fromlen);
           }
 #endif /* CONFIG_NET_TCP */
       }
@@ -1978,7 +2025,7 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         else
 #endif
           {
-            ret = udp_recvfrom(psock, buf, len, from, fromlen);
+            ret = udp_recvfrom(psock, buf, len, flags, from, fromlen);
           }
 #endif /* CONFIG_NET_UDP */
       }
@@ -0,0 +1,200 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   Receive several messages from a socket with one call.  Each message is
+ *   received as by recvfrom() into the single buffer described by the
+ *   message header; the length of each message is returned in its msg_len
+ *   field.
+ *
+ *   If MSG_WAITFORONE is included in the flags, only the first receive may
+ *   block:  The remaining messages are taken only if they are already
+ *   buffered, as if MSG_DONTWAIT were given.  Sockets that cannot receive
+ *   without blocking (Unix domain sockets without CONFIG_NET_LOCAL_RING)
+ *   return only the first message in that case.  If 'timeout' is not NULL,
+ *   no further message is received once it has expired.  As with Linux,
+ *   the time-out is only checked after a message has been received.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The vector of messages to receive
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *   timeout  Time limit for receiving further messages (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On error, -1 is
+ *   returned and errno is set appropriately (see recvfrom).  If an error
+ *   occurs after at least one message was received, the number of messages
+ *   received is returned.
+ *
+ *   EINVAL
+ *     A message header describes more than one I/O vector, or 'timeout'
+ *     is negative or its tv_nsec field is not less than one second.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct msghdr *msg;
+  FAR void *buf;
+  size_t len;
+  ssize_t ret;
+  bool waitforone;
+  uint32_t deadline = 0;
+  uint64_t msec;
+  uint64_t ticks;
+  unsigned int i;
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* MSG_WAITFORONE is only meaningful here.  Its value may be shared with
+   * a flag that has another meaning to recvfrom().
+   */
+
+  waitforone = (flags & MSG_WAITFORONE) != 0;
+  flags     &= ~MSG_WAITFORONE;
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+          timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          set_errno(EINVAL);
+          return ERROR;
+        }
+
+      /* Convert in 64 bits.  The deadline is compared with the 32-bit
+       * system timer so longer time-outs are clipped to the largest
+       * interval that the comparison can represent.
+       */
+
+      msec  = (uint64_t)timeout->tv_sec * MSEC_PER_SEC +
+              timeout->tv_nsec / NSEC_PER_MSEC;
+      ticks = MSEC2TICK(msec);
+      if (ticks > INT32_MAX)
+        {
+          ticks = INT32_MAX;
+        }
+
+      deadline = clock_systimer() + (uint32_t)ticks;
+    }
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_iovlen > 1)
+        {
+          if (i == 0)
+            {
+              set_errno(EINVAL);
+              return ERROR;
+            }
+
+          break;
+        }
+
+      buf = NULL;
+      len = 0;
+
+      if (msg->msg_iovlen > 0)
+        {
+          buf = msg->msg_iov[0].iov_base;
+          len = msg->msg_iov[0].iov_len;
+        }
+
+      ret = psock_recvfrom(psock, buf, len, flags,
+                           (FAR struct sockaddr *)msg->msg_name,
+                           msg->msg_name != NULL ? &msg->msg_namelen : NULL);
+      if (ret < 0)
+        {
+          /* Report the error only if nothing was received */
+
+          return i > 0 ? (int)i : ERROR;
+        }
+
+      msgvec[i].msg_len = (unsigned int)ret;
+      msg->msg_flags    = 0;
+
+      /* Do not wait for any further messages if so requested */
+
+      if (waitforone)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && (int32_t)(clock_systimer() - deadline) >= 0)
+        {
+          i++;
+          break;
+        }
+    }
+
+  return (int)i;
+}
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,144 @@
+/****************************************************************************
+ * net/socket/recvmsg.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: recvmsg
+ *
+ * Description:
+ *   Receive a message from a socket.  The data is received as by
+ *   recvfrom() into the single buffer described by the message header.
+ *
+ *   Ancillary data is returned only on connected Unix domain stream
+ *   sockets when CONFIG_NET_LOCAL_SCM is selected:  Open files that were
+ *   passed with the data are then returned in an SCM_RIGHTS control
+ *   message.  Otherwise, msg_controllen is set to zero.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msg      The message to receive
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On error, -1
+ *   is returned and errno is set appropriately (see recvfrom).
+ *
+ *   EINVAL
+ *     The message header describes more than one I/O vector.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  FAR struct socket *psock;
+  FAR void *buf = NULL;
+  size_t len = 0;
+  ssize_t ret;
+  int err;
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      err = EBADF;
+      goto errout;
+    }
+
+  if (msg->msg_iovlen > 1)
+    {
+      err = EINVAL;
+      goto errout;
+    }
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  if (psock->s_domain == PF_LOCAL && psock->s_type == SOCK_STREAM)
+    {
+      ret = psock_local_recvmsg(psock, msg, flags);
+      if (ret < 0)
+        {
+          err = -ret;
+          goto errout;
+        }
+
+      return ret;
+    }
+#endif
+
+  if (msg->msg_iovlen > 0)
+    {
+      buf = msg->msg_iov[0].iov_base;
+      len = msg->msg_iov[0].iov_len;
+    }
+
+  ret = psock_recvfrom(psock, buf, len, flags,
+                       (FAR struct sockaddr *)msg->msg_name,
+                       msg->msg_name != NULL ? &msg->msg_namelen : NULL);
+  if (ret >= 0)
+    {
+      msg->msg_controllen = 0;
+      msg->msg_flags      = 0;
+    }
+
+  return ret;
+
+errout:
+  set_errno(err);
+  return ERROR;
+}
+
+#endif /* CONFIG_NET */
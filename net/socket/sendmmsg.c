@@ -0,0 +1,137 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *   Send several messages on a socket with one call.  Each message is sent
+ *   as by sendto() from the single buffer described by the message header
+ *   to the address in msg_name (or to the connected peer if msg_name is
+ *   NULL).  The number of bytes sent is returned in the msg_len field of
+ *   each message.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The vector of messages to send
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  On error, -1 is
+ *   returned and errno is set appropriately (see sendto).  If an error
+ *   occurs after at least one message was sent, the number of messages
+ *   sent is returned.
+ *
+ *   EINVAL
+ *     A message header describes more than one I/O vector.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  FAR struct msghdr *msg;
+  FAR const void *buf;
+  size_t len;
+  ssize_t ret;
+  unsigned int i;
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_iovlen > 1)
+        {
+          if (i == 0)
+            {
+              set_errno(EINVAL);
+              return ERROR;
+            }
+
+          break;
+        }
+
+      buf = NULL;
+      len = 0;
+
+      if (msg->msg_iovlen > 0)
+        {
+          buf = msg->msg_iov[0].iov_base;
+          len = msg->msg_iov[0].iov_len;
+        }
+
+      ret = psock_sendto(psock, buf, len, flags,
+                         (FAR const struct sockaddr *)msg->msg_name,
+                         msg->msg_namelen);
+      if (ret < 0)
+        {
+          /* Report the error only if nothing was sent */
+
+          return i > 0 ? (int)i : ERROR;
+        }
+
+      msgvec[i].msg_len = (unsigned int)ret;
+    }
+
+  return (int)i;
+}
+
+#endif /* CONFIG_NET */
@@ -128,6 +128,7 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
       case SO_DEBUG:      /* Enables recording of debugging information */
       case SO_BROADCAST:  /* Permits sending of broadcast messages */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_REUSEPORT:  /* Allow sharing of the local port */
       case SO_KEEPALIVE:  /* Keeps connections active by enabling the
                            * periodic transmission */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
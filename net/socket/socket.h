@@ -90,7 +90,7 @@
 
 /* This macro converts a socket option value into a bit setting */
 
-#define _SO_BIT(o)       (1 << (o))
+#define _SO_BIT(o)       ((sockopt_t)1 << (o))
 
 /* These define bit positions for each socket option (see sys/socket.h) */
 
@@ -110,10 +110,11 @@
 #define _SO_RCVTIMEO     _SO_BIT(SO_RCVTIMEO)
 #define _SO_SNDLOWAT     _SO_BIT(SO_SNDLOWAT)
 #define _SO_SNDTIMEO     _SO_BIT(SO_SNDTIMEO)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
 
 /* This is the larget option value */
 
-#define _SO_MAXOPT       (15)
+#define _SO_MAXOPT       (16)
 
 /* Macros to set, test, clear options */
 
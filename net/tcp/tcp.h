@@ -123,6 +123,67 @@
 #endif
 #endif
 
+/* Modular (RFC 1982) comparison of TCP sequence numbers */
+
+#define TCP_SEQ_LT(a,b)   ((int32_t)((a) - (b)) < 0)
+#define TCP_SEQ_LTE(a,b)  ((int32_t)((a) - (b)) <= 0)
+
+/* Round-trip time measurement state (see conn->rttflags) */
+
+#define TCP_RTT_PENDING   (1 << 0) /* A segment is being timed */
+#define TCP_RTT_VALID     (1 << 1) /* srtt and rttvar have been initialized */
+#define TCP_RTT_KARN      (1 << 2) /* A retransmission time-out occurred;
+                                    * do not time data ending at or before
+                                    * rttseq (Karn's algorithm) */
+
+/* TCP options in effect for a connection (see conn->optflags).  These are
+ * negotiated in the SYN exchange.
+ */
+
+#define TCP_OPTF_WS       (1 << 0) /* Window scaling (RFC 7323) */
+#define TCP_OPTF_TS       (1 << 1) /* Timestamps (RFC 7323) */
+#define TCP_OPTF_SACK     (1 << 2) /* Selective acknowledgement (RFC 2018) */
+
+/* Options that may be carried in every segment, not only in SYNs */
+
+#if defined(CONFIG_NET_TCP_TIMESTAMPS) || defined(CONFIG_NET_TCP_SACK)
+#  define TCP_HAVE_SEGOPTS 1
+#endif
+
+/* The space taken by the timestamps option (with two NOPs for alignment)
+ * in each segment.  The MSS is reduced by this much when timestamps are in
+ * effect.
+ */
+
+#define TCP_OPT_TS_SPACE  12
+
+/* The largest number of SACK blocks that fit into one segment */
+
+#define TCP_SACK_MAXBLOCKS 4
+
+/* The timestamp clock is the system timer.  RFC 7323 recommends a clock
+ * rate between one tick per millisecond and one tick per second.
+ */
+
+#define TCP_TSCLOCK()     ((uint32_t)clock_systimer())
+
+/* Congestion control state (see conn->ccflags) */
+
+#ifdef CONFIG_NET_TCP_CC
+#  define TCP_CC_RECOVERY (1 << 0) /* In fast recovery */
+#  define TCP_CC_FASTRTX  (1 << 1) /* Retransmit the first unACKed segment */
+
+/* The number of duplicate ACKs that are taken as a sign of a lost segment */
+
+#  define TCP_CC_DUPTHRESH 3
+
+/* The algorithm that will be used for new connections */
+
+#  if defined(CONFIG_NET_TCP_CC_NEWRENO)
+#    define TCP_CC_DEFAULT (&g_tcp_newreno)
+#  endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -139,6 +200,46 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_cc_ops_s;      /* Forward reference */
+
+/* This structure describes one SACK block:  A range of sequence numbers
+ * that has been received beyond the cumulative acknowledgement.
+ */
+
+#ifdef CONFIG_NET_TCP_SACK
+struct tcp_sackblk_s
+{
+  uint32_t left;          /* Sequence number of the first byte */
+  uint32_t right;         /* Sequence number that follows the last byte */
+};
+#endif
+
+/* The options found in a segment other than a SYN */
+
+#ifdef TCP_HAVE_SEGOPTS
+struct tcp_segopts_s
+{
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  bool     ts;            /* True:  A timestamps option is present */
+  uint32_t tsval;         /* The timestamp of the sender */
+  uint32_t tsecr;         /* The timestamp echoed by the sender */
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+  uint8_t  nsack;         /* The number of SACK blocks in sack[] */
+  struct tcp_sackblk_s sack[TCP_SACK_MAXBLOCKS];
+#endif
+};
+#endif
+
+/* This structure holds one range of out-of-order data */
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+struct tcp_ofoseg_s
+{
+  uint32_t seqno;         /* Sequence number of the first byte */
+  FAR struct iob_s *data; /* I/O buffer chain holding the data */
+};
+#endif
 
 struct tcp_conn_s
 {
@@ -151,26 +252,65 @@ struct tcp_conn_s
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
 #endif
-  uint8_t  sa;            /* Retransmission time-out calculation state
-                           * variable */
-  uint8_t  sv;            /* Retransmission time-out calculation state
-                           * variable */
-  uint8_t  rto;           /* Retransmission time-out */
   uint8_t  tcpstateflags; /* TCP state and flags */
-  uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
+  uint8_t  timer;         /* The TIME_WAIT timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
                            * segment sent */
+  uint8_t  rttflags;      /* Round-trip time measurement state.  See
+                           * TCP_RTT_* definitions */
+  uint8_t  optflags;      /* TCP options in effect.  See TCP_OPTF_*
+                           * definitions */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint8_t  snd_wscale;    /* Window scale shift of the peer's window */
+  uint8_t  rcv_wscale;    /* Window scale shift of our window */
+#endif
   uint16_t lport;         /* The local TCP port, in network byte order */
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
   uint16_t unacked;       /* Number bytes sent but not yet ACKed */
 #endif
 
+  /* Round-trip time estimation and retransmission time-out (RFC 6298).
+   *
+   *   srtt    - Smoothed round-trip time (units: 1/8 msec)
+   *   rttvar  - Round-trip time variation (units: 1/4 msec)
+   *   rto     - Retransmission time-out (units: msec), not including
+   *             exponential backoff
+   *   rtxtime - System time when the retransmission timer expires
+   *   rttseq  - The sequence number whose acknowledgement completes the
+   *             round-trip time measurement in progress
+   *   rtttime - System time when the timed segment was sent
+   */
+
+  uint32_t srtt;
+  uint32_t rttvar;
+  uint32_t rto;
+  uint32_t rtxtime;
+  uint32_t rttseq;
+  uint32_t rtttime;
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t tsrecent;      /* The timestamp to be echoed to the peer */
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+  /* Round-trip time statistics (units: msec) */
+
+  uint32_t rttmin;        /* Smallest round-trip time measured */
+  uint32_t rttmax;        /* Largest round-trip time measured */
+  uint32_t nrtt;          /* Number of round-trip time measurements */
+  uint32_t nrexmit;       /* Number of retransmission time-outs */
+#endif
+
 #ifdef CONFIG_NETDEV_MULTINIC
   /* If the TCP socket is bound to a local address, then this is
    * a reference to the device that routes traffic on the corresponding
@@ -190,6 +330,18 @@ struct tcp_conn_s
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 #endif
 
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  /* Out-of-order segments.
+   *
+   *   ofosegs  - Received data that lies beyond rcvseq.  The ranges are
+   *              discontiguous and are ordered by sequence number.
+   *   nofosegs - The number of ranges in ofosegs[].
+   */
+
+  struct tcp_ofoseg_s ofosegs[CONFIG_NET_TCP_OUT_OF_ORDER_SEGS];
+  uint8_t nofosegs;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Write buffering
    *
@@ -207,6 +359,48 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control (RFC 5681, RFC 6582)
+   *
+   *   cc       - The congestion control algorithm
+   *   cwnd     - Congestion window:  The number of bytes that may be in
+   *              flight
+   *   ssthresh - Slow start threshold:  Slow start is used while cwnd is
+   *              below this value, congestion avoidance above it
+   *   recover  - The next sequence number to be sent when loss recovery
+   *              started.  Recovery ends when this has been ACKed.
+   *   dupacks  - The number of consecutive duplicate ACKs received
+   *   ccflags  - See TCP_CC_* definitions
+   */
+
+  FAR const struct tcp_cc_ops_s *cc;
+  uint32_t   cwnd;
+  uint32_t   ssthresh;
+  uint32_t   recover;
+  uint8_t    dupacks;
+  uint8_t    ccflags;
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Selective acknowledgement (RFC 2018)
+   *
+   *   sacks   - The scoreboard:  Ranges of sent data beyond the cumulative
+   *             ACK that the peer has reported as received.  The ranges
+   *             are discontiguous and are ordered by sequence number.
+   *   nsacks  - The number of ranges in sacks[]
+   *   rtxnext - The next sequence number that may be retransmitted during
+   *             fast recovery
+   *   ofolast - The sequence number of the most recently received
+   *             out-of-order segment.  The SACK block holding it is
+   *             reported first.
+   */
+
+  struct tcp_sackblk_s sacks[CONFIG_NET_TCP_SACK_BLOCKS];
+  uint8_t    nsacks;
+  uint32_t   rtxnext;
+  uint32_t   ofolast;
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -292,6 +486,28 @@ struct tcp_wrbuffer_s
 };
 #endif
 
+/* A congestion control algorithm.  Loss detection and fast recovery are
+ * common to all algorithms (see tcp_cc.c); the algorithm decides only how
+ * the window is sized.
+ *
+ *   init     - Set the initial cwnd and ssthresh of a new connection.
+ *              conn->mss is valid.
+ *   ack      - 'acked' bytes of new data have been acknowledged outside of
+ *              loss recovery.  Open the congestion window.
+ *   ssthresh - A loss has been detected.  Return the new slow start
+ *              threshold.  conn->unacked still holds the amount of data in
+ *              flight.
+ */
+
+#ifdef CONFIG_NET_TCP_CC
+struct tcp_cc_ops_s
+{
+  CODE void     (*init)(FAR struct tcp_conn_s *conn);
+  CODE void     (*ack)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+#endif
+
 /* Support for listen backlog:
  *
  *   struct tcp_blcontainer_s describes one backlogged connection
@@ -335,6 +551,12 @@ extern "C"
 EXTERN struct net_driver_s *g_netdevices;
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* NewReno congestion control (RFC 5681, RFC 6582) */
+
+EXTERN const struct tcp_cc_ops_s g_tcp_newreno;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -533,10 +755,11 @@ int tcp_bind(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr);
  *   This function is used to start a new connection to the specified
  *   port on the specified host. It uses the connection structure that was
  *   allocated by a preceding socket() call.  It sets the connection to
- *   the SYN_SENT state and sets the retransmission timer to 0. This will
+ *   the SYN_SENT state and expires the retransmission timer. This will
  *   cause a TCP SYN segment to be sent out the next time this connection
- *   is periodically processed, which usually is done within 0.5 seconds
- *   after the call to tcp_connect().
+ *   is processed.  That is immediately if CONFIG_NET_TCP_RTO_TIMER is
+ *   selected or, otherwise, usually within 0.5 seconds after the call to
+ *   tcp_connect().
  *
  * Assumptions:
  *   This function is called from normal user level code.
@@ -664,7 +887,9 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
  * Parameters:
  *   dev  - The device driver structure to use in the send operation
  *   conn - The TCP "connection" to poll for TX data
- *   hsed - The polling interval in halves of a second
+ *   hsec - The polling interval in halves of a second.  This is used
+ *          only for the TIME_WAIT timer;  the retransmission timer is
+ *          based on the system clock.
  *
  * Return:
  *   None
@@ -677,6 +902,134 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                int hsec);
 
+/****************************************************************************
+ * Name: tcp_timer_start
+ *
+ * Description:
+ *   (Re-)start the retransmission timer of the connection.  The timer will
+ *   expire after the current retransmission time-out, including the
+ *   exponential backoff for any retransmissions of the last segment sent.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_timer_start(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_timer_expire
+ *
+ * Description:
+ *   Force the retransmission timer of the connection to expire now so that
+ *   the connection is serviced at the next poll.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_timer_expire(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_timer_expired
+ *
+ * Description:
+ *   Return true if the connection has outstanding data that may be
+ *   retransmitted and its retransmission timer has expired.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   True if the connection requires retransmission
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool tcp_timer_expired(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_rtt_start
+ *
+ * Description:
+ *   Called when a segment is sent.  If no round-trip time measurement is in
+ *   progress, start timing the segment.  Per Karn's algorithm, data that may
+ *   have been retransmitted is not timed.
+ *
+ * Parameters:
+ *   conn  - The TCP connection structure holding connection information
+ *   seqno - The sequence number that follows the last byte of the segment
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_rtt_start(FAR struct tcp_conn_s *conn, uint32_t seqno);
+
+/****************************************************************************
+ * Name: tcp_rtt_ack
+ *
+ * Description:
+ *   Called when an ACK is received.  If the ACK completes the round-trip
+ *   time measurement in progress, update the smoothed round-trip time and
+ *   variation and recompute the retransmission time-out as described in
+ *   RFC 6298.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure holding connection information
+ *   ackseq - The acknowledged sequence number
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_rtt_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq);
+
+/****************************************************************************
+ * Name: tcp_rtt_sample
+ *
+ * Description:
+ *   Update the smoothed round-trip time and variation with one round-trip
+ *   time measurement and recompute the retransmission time-out as described
+ *   in RFC 6298.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *   rtt  - The measured round-trip time (units: msec)
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_rtt_sample(FAR struct tcp_conn_s *conn, uint32_t rtt);
+
 /****************************************************************************
  * Function: tcp_listen_initialize
  *
@@ -941,6 +1294,299 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t nbytes);
 #endif
 
+/****************************************************************************
+ * Function: tcp_ofoseg_add
+ *
+ * Description:
+ *   Retain a segment whose data begins beyond the next expected sequence
+ *   number (conn->rcvseq) in the connection's out-of-order queue.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the TCP connection structure
+ *   seqno  - The sequence number of the first byte of data
+ *   buffer - A pointer to the segment data
+ *   buflen - The number of bytes of segment data
+ *   wndsize - The receive window that was advertised to the peer.  Data
+ *     beyond the window is not retained.
+ *
+ * Returned value:
+ *   The number of bytes retained.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+uint16_t tcp_ofoseg_add(FAR struct tcp_conn_s *conn, uint32_t seqno,
+                        FAR const uint8_t *buffer, uint16_t buflen,
+                        uint32_t wndsize);
+#endif
+
+/****************************************************************************
+ * Function: tcp_ofoseg_deliver
+ *
+ * Description:
+ *   Move any out-of-order data that has become contiguous with rcvseq to the
+ *   read-ahead buffers and advance rcvseq past it.
+ *
+ * Returned value:
+ *   The number of bytes moved to the read-ahead buffers.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+uint32_t tcp_ofoseg_deliver(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Function: tcp_ofoseg_free
+ *
+ * Description:
+ *   Discard all out-of-order data retained for the connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+void tcp_ofoseg_free(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Function: tcp_synopts_parse
+ *
+ * Description:
+ *   Parse the options of a received SYN or SYNACK:  Clip the MSS of the
+ *   connection to the one advertised by the peer and record which of the
+ *   configured options will be in effect.
+ *
+ * Parameters:
+ *   dev   - The device driver structure containing the received segment
+ *   conn  - The TCP connection structure
+ *   iplen - The length of the IP header
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_synopts_parse(FAR struct net_driver_s *dev,
+                       FAR struct tcp_conn_s *conn, unsigned int iplen);
+
+/****************************************************************************
+ * Function: tcp_synopts_build
+ *
+ * Description:
+ *   Write the options of an outgoing SYN or SYNACK.  A SYN offers all of
+ *   the configured options; a SYNACK only those that the peer offered.
+ *
+ * Parameters:
+ *   dev   - The device driver structure to use in the send operation
+ *   conn  - The TCP connection structure
+ *   flags - The TCP flags of the segment
+ *   mss   - The MSS to advertise
+ *   opt   - The location of the options in the TCP header
+ *
+ * Returned value:
+ *   The length of the options, a multiple of four bytes.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+unsigned int tcp_synopts_build(FAR struct net_driver_s *dev,
+                               FAR struct tcp_conn_s *conn, uint8_t flags,
+                               uint16_t mss, FAR uint8_t *opt);
+
+/****************************************************************************
+ * Function: tcp_segopts_parse
+ *
+ * Description:
+ *   Parse the timestamps and SACK options of a received segment.
+ *
+ * Parameters:
+ *   dev   - The device driver structure containing the received segment
+ *   iplen - The length of the IP header
+ *   opts  - The location to return the options found
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef TCP_HAVE_SEGOPTS
+void tcp_segopts_parse(FAR struct net_driver_s *dev, unsigned int iplen,
+                       FAR struct tcp_segopts_s *opts);
+#endif
+
+/****************************************************************************
+ * Function: tcp_segopts_build
+ *
+ * Description:
+ *   Write the options of an outgoing segment other than a SYN:  The
+ *   timestamps option if timestamps are in effect and, on an ACK, SACK
+ *   blocks for any out-of-order data that is queued.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure
+ *   flags  - The TCP flags of the segment
+ *   opt    - The location to write the options
+ *   maxlen - The space available for options
+ *
+ * Returned value:
+ *   The length of the options, a multiple of four bytes.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef TCP_HAVE_SEGOPTS
+unsigned int tcp_segopts_build(FAR struct tcp_conn_s *conn, uint8_t flags,
+                               FAR uint8_t *opt, unsigned int maxlen);
+#endif
+
+/****************************************************************************
+ * Function: tcp_sack_blocks
+ *
+ * Description:
+ *   Describe the out-of-order data queued for the connection as SACK
+ *   blocks.  The block holding the most recently received segment is
+ *   reported first (RFC 2018, section 4).
+ *
+ * Parameters:
+ *   conn      - The TCP connection structure
+ *   blocks    - The location to return the SACK blocks
+ *   maxblocks - The maximum number of blocks to return
+ *
+ * Returned value:
+ *   The number of blocks returned
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+unsigned int tcp_sack_blocks(FAR struct tcp_conn_s *conn,
+                             FAR struct tcp_sackblk_s *blocks,
+                             unsigned int maxblocks);
+#endif
+
+/****************************************************************************
+ * Function: tcp_sack_update
+ *
+ * Description:
+ *   Update the scoreboard with the cumulative acknowledgement and the SACK
+ *   blocks of a received ACK.
+ *
+ * Parameters:
+ *   conn    - The TCP connection structure
+ *   ackseq  - The acknowledgement number of the segment
+ *   blocks  - The SACK blocks of the segment
+ *   nblocks - The number of SACK blocks
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+void tcp_sack_update(FAR struct tcp_conn_s *conn, uint32_t ackseq,
+                     FAR const struct tcp_sackblk_s *blocks,
+                     unsigned int nblocks);
+#endif
+
+/****************************************************************************
+ * Function: tcp_sack_nextrtx
+ *
+ * Description:
+ *   Select the next data to retransmit during fast recovery:  The first
+ *   data at or after conn->rtxnext that has not been SACKed but that lies
+ *   below data that has been.  conn->rtxnext is advanced past it.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure
+ *   snduna - The oldest unacknowledged sequence number
+ *   seqno  - The location to return the first sequence number to resend
+ *   len    - The location to return the number of bytes to resend (at
+ *            most one MSS)
+ *
+ * Returned value:
+ *   True if there is data to retransmit
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+bool tcp_sack_nextrtx(FAR struct tcp_conn_s *conn, uint32_t snduna,
+                      FAR uint32_t *seqno, FAR uint32_t *len);
+#endif
+
+/****************************************************************************
+ * Function: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   been established.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Function: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state for an incoming ACK.  This must be
+ *   called before conn->unacked is updated for the ACK.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure
+ *   ackseq - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment qualifies as a duplicate ACK if it does
+ *            not acknowledge new data:  It carries no data, no SYN or FIN
+ *            and it does not change the advertised window.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq, bool dupack);
+#endif
+
+/****************************************************************************
+ * Function: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control state when the retransmission timer
+ *   expires.  This must be called before the un-ACKed data is queued for
+ *   retransmission.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Function: tcp_backlogcreate
  *
@@ -161,6 +161,7 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       conn->tcpstateflags = TCP_FIN_WAIT_1;
       conn->unacked  = 1;
       conn->nrtx     = 0;
+      tcp_timer_start(conn);
       nllvdbg("TCP state: TCP_FIN_WAIT_1\n");
 
       dev->d_sndlen  = 0;
@@ -173,11 +174,38 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     {
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
       DEBUGASSERT(dev->d_sndlen <= conn->mss);
+
+      /* If d_sndlen > 0, the write buffer logic has sent a segment starting
+       * at sndseq and has already accounted for it in unacked.
+       */
+
+      if (dev->d_sndlen > 0)
+        {
+          /* Start the retransmission timer if it is not running (RFC 6298,
+           * 5.1) and time the segment if no measurement is in progress.
+           */
+
+          if (conn->unacked == dev->d_sndlen)
+            {
+              tcp_timer_start(conn);
+            }
+
+          tcp_rtt_start(conn, tcp_addsequence(conn->sndseq, dev->d_sndlen));
+        }
 #else
       /* If d_sndlen > 0, the application has data to be sent. */
 
       if (dev->d_sndlen > 0)
         {
+          /* Start the retransmission timer if it is not running (RFC 6298,
+           * 5.1).
+           */
+
+          if (conn->unacked == 0)
+            {
+              tcp_timer_start(conn);
+            }
+
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment the amount
            * of data sent.  This will be needed in sequence number calculations
@@ -192,6 +220,10 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
            */
 
           DEBUGASSERT(dev->d_sndlen <= conn->mss);
+
+          /* Time the segment if no measurement is in progress */
+
+          tcp_rtt_start(conn, tcp_addsequence(conn->sndseq, conn->unacked));
         }
 
       conn->nrtx = 0;
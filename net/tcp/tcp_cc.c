@@ -0,0 +1,275 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_CC)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   been established.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cc      = TCP_CC_DEFAULT;
+  conn->recover = conn->isn;
+  conn->dupacks = 0;
+  conn->ccflags = 0;
+
+  conn->cc->init(conn);
+
+  nllvdbg("cwnd: %lu ssthresh: %lu\n",
+          (unsigned long)conn->cwnd, (unsigned long)conn->ssthresh);
+}
+
+/****************************************************************************
+ * Function: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state for an incoming ACK.  This must be
+ *   called before conn->unacked is updated for the ACK.
+ *
+ *   The third duplicate ACK starts fast retransmit and fast recovery as
+ *   described in RFC 6582.  The TCP_CC_FASTRTX flag asks the write buffer
+ *   logic to resend the first unacknowledged segment; it does this the next
+ *   time that it is able to send.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure
+ *   ackseq - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment qualifies as a duplicate ACK if it does
+ *            not acknowledge new data:  It carries no data, no SYN or FIN
+ *            and it does not change the advertised window.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq, bool dupack)
+{
+  uint32_t snduna;
+  uint32_t acked;
+  uint32_t flight;
+
+  /* The oldest unacknowledged sequence number */
+
+  snduna = conn->isn + conn->sent - conn->unacked;
+  if (TCP_SEQ_LT(ackseq, snduna))
+    {
+      /* An old ACK, re-ordered in the network */
+
+      return;
+    }
+
+  acked = ackseq - snduna;
+  if (acked == 0)
+    {
+      if (!dupack)
+        {
+          return;
+        }
+
+      if (conn->dupacks < UINT8_MAX)
+        {
+          conn->dupacks++;
+        }
+
+      if ((conn->ccflags & TCP_CC_RECOVERY) != 0)
+        {
+          /* Each further duplicate ACK means that another segment has
+           * left the network:  Inflate the window so that new data may be
+           * sent in its place.
+           */
+
+          conn->cwnd += conn->mss;
+
+#ifdef CONFIG_NET_TCP_SACK
+          /* If the peer reports what it holds, fill the next hole */
+
+          if (conn->nsacks > 0)
+            {
+              conn->ccflags |= TCP_CC_FASTRTX;
+            }
+#endif
+        }
+      else if (conn->dupacks == TCP_CC_DUPTHRESH &&
+               TCP_SEQ_LT(conn->recover, ackseq))
+        {
+          /* Fast retransmit.  Losses within data that was outstanding when
+           * the last recovery started (ackseq <= recover) are left to that
+           * recovery.
+           */
+
+          conn->ssthresh = conn->cc->ssthresh(conn);
+          conn->cwnd     = conn->ssthresh + TCP_CC_DUPTHRESH * conn->mss;
+          conn->recover  = conn->isn + conn->sent;
+          conn->ccflags |= (TCP_CC_RECOVERY | TCP_CC_FASTRTX);
+#ifdef CONFIG_NET_TCP_SACK
+          conn->rtxnext  = snduna;
+#endif
+
+          /* Do not time the retransmitted data (Karn's algorithm) */
+
+          conn->rttseq    = conn->recover;
+          conn->rttflags &= ~TCP_RTT_PENDING;
+          conn->rttflags |= TCP_RTT_KARN;
+
+          nllvdbg("Fast retransmit: seqno=%08lx cwnd=%lu ssthresh=%lu\n",
+                  (unsigned long)snduna, (unsigned long)conn->cwnd,
+                  (unsigned long)conn->ssthresh);
+        }
+
+      return;
+    }
+
+  conn->dupacks = 0;
+
+  if ((conn->ccflags & TCP_CC_RECOVERY) != 0)
+    {
+      if (TCP_SEQ_LT(ackseq, conn->recover))
+        {
+          /* A partial ACK:  The segment that follows is lost too.
+           * Retransmit it and deflate the window by the amount of new data
+           * acknowledged, adding back one segment if at least that much was
+           * ACKed (RFC 6582, 3.2 step 5).
+           */
+
+          conn->cwnd = conn->cwnd > acked ? conn->cwnd - acked : 0;
+          if (acked >= conn->mss || conn->cwnd < conn->mss)
+            {
+              conn->cwnd += conn->mss;
+            }
+
+          conn->ccflags |= TCP_CC_FASTRTX;
+          return;
+        }
+
+      /* A full ACK ends the recovery.  Deflate the window, but not so far
+       * that a burst would follow (RFC 6582, 3.2 step 6, option 1):
+       *
+       *   cwnd = min(ssthresh, max(FlightSize, SMSS) + SMSS)
+       */
+
+      flight = conn->unacked - acked;
+      if (flight < conn->mss)
+        {
+          flight = conn->mss;
+        }
+
+      flight += conn->mss;
+      conn->cwnd = flight < conn->ssthresh ? flight : conn->ssthresh;
+      conn->ccflags &= ~(TCP_CC_RECOVERY | TCP_CC_FASTRTX);
+
+      nllvdbg("Recovered: cwnd=%lu\n", (unsigned long)conn->cwnd);
+      return;
+    }
+
+  /* Let the algorithm open the window */
+
+  conn->cc->ack(conn, acked);
+}
+
+/****************************************************************************
+ * Function: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control state when the retransmission timer
+ *   expires.  This must be called before the un-ACKed data is queued for
+ *   retransmission.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* The slow start threshold is held constant if the same data is timed
+   * out again (RFC 5681, 3.1).
+   */
+
+  if (conn->nrtx <= 1)
+    {
+      conn->ssthresh = conn->cc->ssthresh(conn);
+    }
+
+  /* Restart from the loss window of one segment.  Duplicate ACKs caused by
+   * the retransmission of data sent before the time-out must not start a
+   * fast retransmit (RFC 6582, 4.1).
+   */
+
+  conn->cwnd     = conn->mss;
+  conn->recover  = conn->isn + conn->sent;
+  conn->dupacks  = 0;
+  conn->ccflags  = 0;
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* The peer may renege on data that it reported (RFC 2018, 8) */
+
+  conn->nsacks   = 0;
+#endif
+
+  nllvdbg("cwnd: %lu ssthresh: %lu\n",
+          (unsigned long)conn->cwnd, (unsigned long)conn->ssthresh);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
@@ -1,7 +1,7 @@
 /****************************************************************************
- * net/arp/arp_timer.c
+ * net/tcp/tcp_cc_newreno.c
  *
- *   Copyright (C) 2007-2009, 2011, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -33,101 +33,127 @@
  *
  ****************************************************************************/
 
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
 
 #include <nuttx/config.h>
-#ifdef CONFIG_NET
-
-#include <stdint.h>
-#include <time.h>
-#include <debug.h>
 
-#include <nuttx/wdog.h>
-#include <nuttx/net/netconfig.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_CC_NEWRENO)
 
-#include <arp/arp.h>
+#include <stdint.h>
 
-#ifdef CONFIG_NET_ARP
+#include "tcp/tcp.h"
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Function Prototypes
  ****************************************************************************/
 
-/* ARP timer interval = 10 seconds. CLK_TCK is the number of clock ticks
- * per second
- */
-
-#define ARPTIMER_WDINTERVAL (10*CLK_TCK)
+static void newreno_init(FAR struct tcp_conn_s *conn);
+static void newreno_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
 
 /****************************************************************************
- * Private Data
+ * Public Data
  ****************************************************************************/
 
-static WDOG_ID g_arptimer;           /* ARP timer */
+const struct tcp_cc_ops_s g_tcp_newreno =
+{
+  newreno_init,                 /* init */
+  newreno_ack,                  /* ack */
+  newreno_ssthresh              /* ssthresh */
+};
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Function: arptimer_poll
+ * Function: newreno_init
  *
  * Description:
- *   Periodic timer handler.  Called from the timer interrupt handler.
- *
- * Parameters:
- *   argc - The number of available arguments
- *   arg  - The first argument
+ *   Set the initial window (RFC 5681, 3.1):
  *
- * Returned Value:
- *   None
+ *     IW = min(4 * SMSS, max(2 * SMSS, 4380 bytes))
  *
- * Assumptions:
+ *   The slow start threshold starts out arbitrarily high so that slow
+ *   start continues until the first loss.
  *
  ****************************************************************************/
 
-static void arptimer_poll(int argc, uint32_t arg, ...)
+static void newreno_init(FAR struct tcp_conn_s *conn)
 {
-  /* Call the ARP timer function every 10 seconds. */
-
-  arp_timer();
-
-  /* Setup the watchdog timer again */
-
-  (void)wd_start(g_arptimer, ARPTIMER_WDINTERVAL, arptimer_poll, 0);
+  if (conn->mss > 2190)
+    {
+      conn->cwnd = 2 * conn->mss;
+    }
+  else if (conn->mss > 1095)
+    {
+      conn->cwnd = 3 * conn->mss;
+    }
+  else
+    {
+      conn->cwnd = 4 * conn->mss;
+    }
+
+  conn->ssthresh = UINT32_MAX;
 }
 
 /****************************************************************************
- * Public Functions
+ * Function: newreno_ack
+ *
+ * Description:
+ *   Open the window for acknowledged data.  Below ssthresh, slow start
+ *   grows the window by at most one segment per ACK; above it, congestion
+ *   avoidance grows it by about one segment per round trip (RFC 5681, 3.1).
+ *
  ****************************************************************************/
 
+static void newreno_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t incr;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      incr = acked < conn->mss ? acked : conn->mss;
+    }
+  else
+    {
+      incr = ((uint32_t)conn->mss * conn->mss) / conn->cwnd;
+      if (incr == 0)
+        {
+          incr = 1;
+        }
+    }
+
+  if (conn->cwnd + incr > conn->cwnd)
+    {
+      conn->cwnd += incr;
+    }
+}
+
 /****************************************************************************
- * Function: arp_timer_initialize
+ * Function: newreno_ssthresh
  *
  * Description:
- *   Initialized the 10 second timer that is need by the ARP logic in order
- *   to age ARP address associations
- *
- * Parameters:
- *   None
+ *   Halve the amount of data in flight (RFC 5681, equation 4):
  *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   Called once at system initialization time
+ *     ssthresh = max(FlightSize / 2, 2 * SMSS)
  *
  ****************************************************************************/
 
-void arp_timer_initialize(void)
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
 {
-  /* Create and start the ARP timer */
+  uint32_t ssthresh = conn->unacked >> 1;
+
+  if (ssthresh < 2 * (uint32_t)conn->mss)
+    {
+      ssthresh = 2 * (uint32_t)conn->mss;
+    }
 
-  g_arptimer = wd_create();
- (void)wd_start(g_arptimer, ARPTIMER_WDINTERVAL, arptimer_poll, 0);
+  return ssthresh;
 }
 
-#endif /* CONFIG_NET_ARP */
-#endif /* CONFIG_NET */
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC_NEWRENO */
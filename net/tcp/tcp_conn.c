@@ -853,6 +853,12 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   iob_free_queue(&conn->readahead);
 #endif
 
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  /* Release any out-of-order segments */
+
+  tcp_ofoseg_free(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -1074,9 +1080,20 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       /* Fill in the necessary fields for the new connection. */
 
       conn->rto           = TCP_RTO;
-      conn->timer         = TCP_RTO;
-      conn->sa            = 0;
-      conn->sv            = 4;
+      conn->srtt          = 0;
+      conn->rttvar        = 0;
+      conn->rttflags      = 0;
+      conn->optflags      = 0;
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      conn->snd_wscale    = 0;
+      conn->rcv_wscale    = 0;
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      conn->tsrecent      = 0;
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+      conn->nsacks        = 0;
+#endif
       conn->nrtx          = 0;
       conn->lport         = tcp->destport;
       conn->rport         = tcp->srcport;
@@ -1084,6 +1101,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 
       tcp_initsequence(conn->sndseq);
       conn->unacked = 1;
+      tcp_timer_start(conn);
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
       conn->expired = 0;
       conn->isn     = 0;
@@ -1100,6 +1118,12 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       IOB_QINIT(&conn->readahead);
 #endif
 
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+      /* No out-of-order segments have been received */
+
+      conn->nofosegs = 0;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
       /* Initialize the write buffer lists */
 
@@ -1169,10 +1193,11 @@ int tcp_bind(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
  *   This function is used to start a new connection to the specified
  *   port on the specified host. It uses the connection structure that was
  *   allocated by a preceding socket() call.  It sets the connection to
- *   the SYN_SENT state and sets the retransmission timer to 0. This will
+ *   the SYN_SENT state and expires the retransmission timer. This will
  *   cause a TCP SYN segment to be sent out the next time this connection
- *   is periodically processed, which usually is done within 0.5 seconds
- *   after the call to tcp_connect().
+ *   is processed.  That is immediately if CONFIG_NET_TCP_RTO_TIMER is
+ *   selected or, otherwise, usually within 0.5 seconds after the call to
+ *   tcp_connect().
  *
  * Assumptions:
  *   This function is called from normal user level code.
@@ -1335,10 +1360,21 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   conn->unacked    = 1;    /* TCP length of the SYN is one. */
   conn->nrtx       = 0;
-  conn->timer      = 1;    /* Send the SYN next time around. */
   conn->rto        = TCP_RTO;
-  conn->sa         = 0;
-  conn->sv         = 16;   /* Initial value of the RTT variance. */
+  conn->srtt       = 0;
+  conn->rttvar     = 0;
+  conn->rttflags   = 0;
+  conn->optflags   = 0;
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  conn->snd_wscale = 0;
+  conn->rcv_wscale = 0;
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  conn->tsrecent   = 0;
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+  conn->nsacks     = 0;
+#endif
   conn->lport      = htons((uint16_t)port);
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
@@ -1352,6 +1388,12 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   IOB_QINIT(&conn->readahead);
 #endif
 
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  /* No out-of-order segments have been received */
+
+  conn->nofosegs = 0;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Initialize the TCP write buffer lists */
 
@@ -1359,9 +1401,12 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   sq_init(&conn->unacked_q);
 #endif
 
-  /* And, finally, put the connection structure into the active list. */
+  /* And, finally, put the connection structure into the active list.
+   * The SYN will be sent when the connection is next polled.
+   */
 
   dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_timer_expire(conn);
   ret = OK;
 
 errout_with_lock:
@@ -97,9 +97,18 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 {
   uint16_t result;
 
+  /* Perform any retransmission that is due now rather than waiting for the
+   * next periodic timer poll.
+   */
+
+  if (tcp_timer_expired(conn))
+    {
+      tcp_timer(dev, conn, 0);
+    }
+
   /* Verify that the connection is established */
 
-  if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
+  else if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
     {
       /* Set up for the callback.  We can't know in advance if the application
        * is going to send a IPv4 or an IPv6 packet, so this setup may not
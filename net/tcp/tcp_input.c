@@ -50,6 +50,7 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -100,13 +101,16 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   FAR struct tcp_hdr_s *tcp;
   FAR struct tcp_conn_s *conn = NULL;
   unsigned int tcpiplen;
-  unsigned int hdrlen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
+#ifdef CONFIG_NET_TCP_CC
+  uint32_t oldwnd;
+#endif
+#ifdef TCP_HAVE_SEGOPTS
+  struct tcp_segopts_s opts;
+#endif
   int      len;
-  int      i;
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -124,10 +128,6 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
   tcpiplen = iplen + TCP_HDRLEN;
 
-  /* Get the size of the link layer header, the IP header, and the TCP header */
-
-  hdrlen = tcpiplen + NET_LL_HDRLEN(dev);
-
   /* Start of TCP input header processing code. */
 
   if (tcp_chksum(dev) != 0xffff)
@@ -224,58 +224,11 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP MSS option and any other options offered by the
+           * peer.
+           */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ;)
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we easily
-                       * can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are malformed
-                           * and we don't process them further.
-                           */
-
-                          break;
-                        }
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_synopts_parse(dev, conn, iplen);
 
           /* Our response will be a SYNACK. */
 
@@ -307,8 +260,20 @@ found:
 
   /* Update the connection's window size */
 
+#ifdef CONFIG_NET_TCP_CC
+  oldwnd = conn->winsize;
+#endif
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window field of a SYN is never scaled */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_wscale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -339,6 +304,10 @@ found:
 
   dev->d_len -= (len + iplen);
 
+  /* The data follows the TCP options, if any */
+
+  dev->d_appdata = &dev->d_buf[NET_LL_HDRLEN(dev) + iplen + len];
+
   /* First, check if the sequence number of the incoming packet is
    * what we're expecting next. If not, we send out an ACK with the
    * correct numbers in, unless we are in the SYN_RCVD state and
@@ -354,11 +323,52 @@ found:
       if ((dev->d_len > 0 || ((tcp->flags & (TCP_SYN | TCP_FIN)) != 0)) &&
           memcmp(tcp->seqno, conn->rcvseq, 4) != 0)
         {
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+          /* Retain data that arrived ahead of a missing segment so that it
+           * need not be retransmitted.  The duplicate ACK is still sent to
+           * inform the peer of the hole.
+           */
+
+          if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+              (conn->tcpstateflags & TCP_STOPPED) == 0 &&
+              (tcp->flags & (TCP_SYN | TCP_FIN | TCP_URG)) == 0 &&
+              dev->d_len > 0)
+            {
+              (void)tcp_ofoseg_add(conn, tcp_getsequence(tcp->seqno),
+                                   &dev->d_buf[NET_LL_HDRLEN(dev) + iplen + len],
+                                   dev->d_len, NET_DEV_RCVWNDO(dev));
+
+#ifdef CONFIG_NET_TCP_SACK
+              /* Report the block holding this segment first */
+
+              conn->ofolast = tcp_getsequence(tcp->seqno);
+#endif
+            }
+#endif
+
           tcp_send(dev, conn, TCP_ACK, tcpiplen);
           return;
         }
     }
 
+#ifdef TCP_HAVE_SEGOPTS
+  /* Get the timestamps and SACK options of the segment */
+
+  tcp_segopts_parse(dev, iplen, &opts);
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Remember the timestamp to be echoed to the peer.  Only in-sequence
+   * segments get here (RFC 7323, 4.3).
+   */
+
+  if ((conn->optflags & TCP_OPTF_TS) != 0 && opts.ts &&
+      TCP_SEQ_LTE(conn->tsrecent, opts.tsval))
+    {
+      conn->tsrecent = opts.tsval;
+    }
+#endif
+
   /* Next, check if the incoming segment acknowledges any outstanding
    * data. If so, we update the sequence number, reset the length of
    * the outstanding data, calculate RTT estimations, and reset the
@@ -369,6 +379,7 @@ found:
     {
       uint32_t unackseq;
       uint32_t ackseq;
+      uint32_t snduna;
 
       /* The next sequence number is equal to the current sequence
        * number (sndseq) plus the size of the outstanding, unacknowledged
@@ -387,6 +398,10 @@ found:
 
       ackseq = tcp_getsequence(tcp->ackno);
 
+      /* The oldest unacknowledged sequence number before this ACK */
+
+      snduna = unackseq - conn->unacked;
+
       /* Check how many of the outstanding bytes have been acknowledged. For
        * a most uIP send operation, this should always be true.  However,
        * the send() API sends data ahead when it can without waiting for
@@ -396,6 +411,28 @@ found:
 
       if (ackseq <= unackseq)
         {
+#ifdef CONFIG_NET_TCP_SACK
+          /* Update the record of data that the peer holds */
+
+          if ((conn->optflags & TCP_OPTF_SACK) != 0 &&
+              (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
+            {
+              tcp_sack_update(conn, ackseq, opts.sack, opts.nsack);
+            }
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+          /* Count duplicate ACKs and open or close the congestion window */
+
+          if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
+            {
+              tcp_cc_ack(conn, ackseq,
+                         dev->d_len == 0 &&
+                         (tcp->flags & (TCP_SYN | TCP_FIN)) == 0 &&
+                         conn->winsize == oldwnd);
+            }
+#endif
+
           /* Calculate the new number of outstanding, unacknowledged bytes */
 
           conn->unacked = unackseq - ackseq;
@@ -425,34 +462,43 @@ found:
               conn->sndseq, ackseq, unackseq, conn->unacked);
       tcp_setsequence(conn->sndseq, ackseq);
 
-      /* Do RTT estimation, unless we have done retransmissions. */
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      /* With timestamps, every ACK of new data gives a valid round-trip
+       * time measurement, even for retransmitted data (RFC 7323, 4.1).
+       */
 
-      if (conn->nrtx == 0)
+      if ((conn->optflags & TCP_OPTF_TS) != 0 && opts.ts && opts.tsecr != 0)
         {
-          signed char m;
-          m = conn->rto - conn->timer;
-
-          /* This is taken directly from VJs original code in his paper */
-
-          m = m - (conn->sa >> 3);
-          conn->sa += m;
-          if (m < 0)
+          if (ackseq != snduna)
             {
-              m = -m;
+              tcp_rtt_sample(conn, TICK2MSEC(TCP_TSCLOCK() - opts.tsecr));
             }
+        }
+      else
+#endif
+        {
+          /* Do RTT estimation.  Segments that were retransmitted are not
+           * timed so the measurement is valid (Karn's algorithm).
+           */
 
-          m = m - (conn->sv >> 2);
-          conn->sv += m;
-          conn->rto = (conn->sa >> 3) + conn->sv;
+          tcp_rtt_ack(conn, ackseq);
         }
 
-        /* Set the acknowledged flag. */
+      /* Set the acknowledged flag. */
 
-       flags |= TCP_ACKDATA;
+      flags |= TCP_ACKDATA;
 
-       /* Reset the retransmission timer. */
+      /* Restart the retransmission timer only if this ACK acknowledges new
+       * data and there is still data outstanding (RFC 6298, 5.3).  Duplicate
+       * ACKs must not postpone the retransmission.  When everything has
+       * been acknowledged, the timer is stopped (5.2):  it does not run
+       * while unacked is zero.
+       */
 
-       conn->timer = conn->rto;
+      if (conn->unacked > 0 && TCP_SEQ_LT(snduna, ackseq))
+        {
+          tcp_timer_start(conn);
+        }
     }
 
   /* Do different things depending on in what state the connection is. */
@@ -480,6 +526,9 @@ found:
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
             conn->sent          = 0;
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
 #endif
             conn->unacked       = 0;
             flags               = TCP_CONNECTED;
@@ -516,59 +565,11 @@ found:
 
         if ((flags & TCP_ACKDATA) != 0 && (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP MSS option and find out which of the options
+             * that we offered will be in effect.
+             */
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
-              {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ;)
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
-              }
+            tcp_synopts_parse(dev, conn, iplen);
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -579,6 +580,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -652,6 +656,7 @@ found:
             conn->tcpstateflags = TCP_LAST_ACK;
             conn->unacked       = 1;
             conn->nrtx          = 0;
+            tcp_timer_start(conn);
             nllvdbg("TCP state: TCP_LAST_ACK\n");
 
             tcp_send(dev, conn, TCP_FIN | TCP_ACK, tcpiplen);
@@ -741,7 +746,29 @@ found:
                 /* Update the sequence number using the saved length */
 
                 net_incr32(conn->rcvseq, len);
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+                /* The new data may have closed the hole before data that
+                 * was received out of order.
+                 */
+
+                if (len > 0 && conn->nofosegs > 0)
+                  {
+                    (void)tcp_ofoseg_deliver(conn);
+                  }
+#endif
               }
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+            else if (len > 0 && conn->nofosegs > 0)
+              {
+                /* The in-order data could not be buffered.  The I/O
+                 * buffers may all be held by out-of-order data that can
+                 * never be delivered without it:  Release them.
+                 */
+
+                tcp_ofoseg_free(conn);
+              }
+#endif
 
             /* Send the response, ACKing the data or not, as appropriate */
 
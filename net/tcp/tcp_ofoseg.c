@@ -0,0 +1,382 @@
+/****************************************************************************
+ * net/tcp/tcp_ofoseg.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_OUT_OF_ORDER)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/iob.h>
+
+#include "iob/iob.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The sequence number that follows the last byte of a range */
+
+#define OFOSEG_END(s)     ((s)->seqno + (s)->data->io_pktlen)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_ofoseg_remove
+ *
+ * Description:
+ *   Remove one entry from the out-of-order table, closing the gap.  The
+ *   I/O buffer chain of the entry is not freed.
+ *
+ ****************************************************************************/
+
+static void tcp_ofoseg_remove(FAR struct tcp_conn_s *conn, int index)
+{
+  conn->nofosegs--;
+  if (index < conn->nofosegs)
+    {
+      memmove(&conn->ofosegs[index], &conn->ofosegs[index + 1],
+              (conn->nofosegs - index) * sizeof(struct tcp_ofoseg_s));
+    }
+}
+
+/****************************************************************************
+ * Function: tcp_ofoseg_merge
+ *
+ * Description:
+ *   Merge the range 'hi' into the range 'lo' if the two ranges are adjacent
+ *   or overlap.  lo->seqno must not follow hi->seqno.  On success, the data
+ *   of 'hi' has been consumed (or freed) and hi->data is set to NULL.
+ *
+ * Returned value:
+ *   true if the ranges were merged.
+ *
+ ****************************************************************************/
+
+static bool tcp_ofoseg_merge(FAR struct tcp_ofoseg_s *lo,
+                             FAR struct tcp_ofoseg_s *hi)
+{
+  uint32_t loend = OFOSEG_END(lo);
+  uint32_t hiend = OFOSEG_END(hi);
+
+  /* Is there a hole between the two ranges? */
+
+  if (TCP_SEQ_LT(loend, hi->seqno))
+    {
+      return false;
+    }
+
+  /* Is 'hi' completely covered by 'lo'? */
+
+  if (TCP_SEQ_LTE(hiend, loend))
+    {
+      iob_free_chain(hi->data);
+      hi->data = NULL;
+      return true;
+    }
+
+  /* The packet length of an I/O buffer chain is limited to 16-bits */
+
+  if ((uint32_t)lo->data->io_pktlen + (hiend - loend) > UINT16_MAX)
+    {
+      return false;
+    }
+
+  /* Discard the overlapping head of 'hi' and append the remainder */
+
+  hi->data = iob_trimhead(hi->data, loend - hi->seqno);
+  iob_concat(lo->data, hi->data);
+  hi->data = NULL;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_ofoseg_add
+ *
+ * Description:
+ *   Retain a segment whose data begins beyond the next expected sequence
+ *   number (conn->rcvseq) in the connection's out-of-order queue.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the TCP connection structure
+ *   seqno  - The sequence number of the first byte of data
+ *   buffer - A pointer to the segment data
+ *   buflen - The number of bytes of segment data
+ *   wndsize - The receive window that was advertised to the peer.  Data
+ *     beyond the window is not retained.
+ *
+ * Returned value:
+ *   The number of bytes retained.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+uint16_t tcp_ofoseg_add(FAR struct tcp_conn_s *conn, uint32_t seqno,
+                        FAR const uint8_t *buffer, uint16_t buflen,
+                        uint32_t wndsize)
+{
+  struct tcp_ofoseg_s newseg;
+  FAR struct iob_s *iob;
+  uint32_t offset;
+  int nsegs;
+  int ret;
+  int i;
+
+  /* Only data that lies beyond rcvseq and within the receive window is
+   * retained.  Retransmitted, old data wraps to a large offset.
+   */
+
+  offset = seqno - tcp_getsequence(conn->rcvseq);
+  if (buflen == 0 || offset == 0 || offset >= wndsize)
+    {
+      return 0;
+    }
+
+  if (offset + buflen > wndsize)
+    {
+      buflen = wndsize - offset;
+    }
+
+  /* Find the first range that begins after the new data */
+
+  nsegs = conn->nofosegs;
+  i     = 0;
+
+  while (i < nsegs && TCP_SEQ_LTE(conn->ofosegs[i].seqno, seqno))
+    {
+      i++;
+    }
+
+  /* Is all of the new data already held in the preceding range?  This is
+   * the usual case for a retransmission after a lost ACK.
+   */
+
+  if (i > 0 &&
+      TCP_SEQ_LTE(seqno + buflen, OFOSEG_END(&conn->ofosegs[i - 1])))
+    {
+      return buflen;
+    }
+
+  /* Copy the data into a new I/O buffer chain (without waiting and
+   * throttling as necessary).
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      nlldbg("ERROR: Failed to create new I/O buffer chain\n");
+      return 0;
+    }
+
+  ret = iob_trycopyin(iob, buffer, buflen, 0, true);
+  if (ret < 0)
+    {
+      nlldbg("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
+      (void)iob_free_chain(iob);
+      return 0;
+    }
+
+  newseg.seqno = seqno;
+  newseg.data  = iob;
+
+  /* Extend the preceding range if the new data is adjacent to it */
+
+  if (i > 0 && tcp_ofoseg_merge(&conn->ofosegs[i - 1], &newseg))
+    {
+      i--;
+    }
+  else
+    {
+      if (nsegs >= CONFIG_NET_TCP_OUT_OF_ORDER_SEGS)
+        {
+          /* The table is full.  The ranges nearest rcvseq are the most
+           * valuable:  Drop the new data if it would be the last range,
+           * otherwise discard the last range to make space.
+           */
+
+          if (i >= nsegs)
+            {
+              nllvdbg("Table full, dropping seqno %08lx\n",
+                      (unsigned long)seqno);
+              (void)iob_free_chain(iob);
+              return 0;
+            }
+
+          nsegs--;
+          (void)iob_free_chain(conn->ofosegs[nsegs].data);
+        }
+
+      memmove(&conn->ofosegs[i + 1], &conn->ofosegs[i],
+              (nsegs - i) * sizeof(struct tcp_ofoseg_s));
+
+      conn->ofosegs[i] = newseg;
+      conn->nofosegs   = nsegs + 1;
+    }
+
+  /* The new data may also have filled the hole(s) to the following
+   * range(s).
+   */
+
+  while (i + 1 < conn->nofosegs &&
+         tcp_ofoseg_merge(&conn->ofosegs[i], &conn->ofosegs[i + 1]))
+    {
+      tcp_ofoseg_remove(conn, i + 1);
+    }
+
+  nllvdbg("Retained %d bytes at offset %lu, %d ranges\n",
+          buflen, (unsigned long)offset, conn->nofosegs);
+  return buflen;
+}
+
+/****************************************************************************
+ * Function: tcp_ofoseg_deliver
+ *
+ * Description:
+ *   Move any out-of-order data that has become contiguous with rcvseq to the
+ *   read-ahead buffers and advance rcvseq past it.
+ *
+ * Returned value:
+ *   The number of bytes moved to the read-ahead buffers.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+uint32_t tcp_ofoseg_deliver(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  uint32_t rcvseq = tcp_getsequence(conn->rcvseq);
+  uint32_t delivered = 0;
+  uint16_t pktlen;
+
+  while (conn->nofosegs > 0)
+    {
+      /* Is there still a hole before the first range? */
+
+      seg = &conn->ofosegs[0];
+      if (TCP_SEQ_LT(rcvseq, seg->seqno))
+        {
+          break;
+        }
+
+      /* Discard a range that has been completely superseded by in-order
+       * data.
+       */
+
+      if (TCP_SEQ_LTE(OFOSEG_END(seg), rcvseq))
+        {
+          (void)iob_free_chain(seg->data);
+          tcp_ofoseg_remove(conn, 0);
+          continue;
+        }
+
+      /* Discard any data that has already been received in order */
+
+      if (seg->seqno != rcvseq)
+        {
+          seg->data  = iob_trimhead(seg->data, rcvseq - seg->seqno);
+          seg->seqno = rcvseq;
+        }
+
+      /* Add the I/O buffer chain to the tail of the read-ahead queue.  On
+       * failure, the range is retained and delivery is retried when the
+       * next in-order segment arrives.
+       */
+
+      pktlen = seg->data->io_pktlen;
+      if (iob_tryadd_queue(seg->data, &conn->readahead) < 0)
+        {
+          nlldbg("ERROR: Failed to queue the I/O buffer chain\n");
+          break;
+        }
+
+      tcp_ofoseg_remove(conn, 0);
+      rcvseq    += pktlen;
+      delivered += pktlen;
+    }
+
+  if (delivered > 0)
+    {
+      nllvdbg("Delivered %lu bytes\n", (unsigned long)delivered);
+      tcp_setsequence(conn->rcvseq, rcvseq);
+    }
+
+  return delivered;
+}
+
+/****************************************************************************
+ * Function: tcp_ofoseg_free
+ *
+ * Description:
+ *   Discard all out-of-order data retained for the connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_ofoseg_free(FAR struct tcp_conn_s *conn)
+{
+  int i;
+
+  for (i = 0; i < conn->nofosegs; i++)
+    {
+      (void)iob_free_chain(conn->ofosegs[i].data);
+    }
+
+  conn->nofosegs = 0;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_OUT_OF_ORDER */
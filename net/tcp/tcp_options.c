@@ -0,0 +1,534 @@
+/****************************************************************************
+ * net/tcp/tcp_options.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_options
+ *
+ * Description:
+ *   Return the location and length of the options of a received segment.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tcp_options(FAR struct net_driver_s *dev,
+                                unsigned int iplen, FAR unsigned int *optlen)
+{
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int hdrlen;
+
+  tcp    = (FAR struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + iplen];
+  hdrlen = (tcp->tcpoffset >> 4) << 2;
+
+  *optlen = hdrlen > TCP_HDRLEN ? hdrlen - TCP_HDRLEN : 0;
+  return (FAR uint8_t *)tcp + TCP_HDRLEN;
+}
+
+/****************************************************************************
+ * Function: tcp_nextopt
+ *
+ * Description:
+ *   Return the length of the option at offset i, or zero if there are no
+ *   further options (or the options are malformed).  NOPs have length one.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_nextopt(FAR const uint8_t *opt, unsigned int i,
+                                unsigned int optlen)
+{
+  if (i >= optlen || opt[i] == TCP_OPT_END)
+    {
+      return 0;
+    }
+
+  if (opt[i] == TCP_OPT_NOOP)
+    {
+      return 1;
+    }
+
+  /* All other options have a length field.  An option that has a length
+   * less than two or that extends beyond the header means that the options
+   * are malformed and we don't process them further.
+   */
+
+  if (i + 1 >= optlen || opt[i + 1] < 2 || i + opt[i + 1] > optlen)
+    {
+      return 0;
+    }
+
+  return opt[i + 1];
+}
+
+/****************************************************************************
+ * Function: tcp_putu32
+ *
+ * Description:
+ *   Write a 32-bit value in network order.
+ *
+ ****************************************************************************/
+
+#ifdef TCP_HAVE_SEGOPTS
+static void tcp_putu32(FAR uint8_t *ptr, uint32_t value)
+{
+  ptr[0] = (uint8_t)(value >> 24);
+  ptr[1] = (uint8_t)(value >> 16);
+  ptr[2] = (uint8_t)(value >> 8);
+  ptr[3] = (uint8_t)value;
+}
+#endif
+
+/****************************************************************************
+ * Function: tcp_rcvwscale
+ *
+ * Description:
+ *   Return the smallest window scale shift that allows the receive window
+ *   of the device to be advertised.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+static uint8_t tcp_rcvwscale(FAR struct net_driver_s *dev)
+{
+  uint32_t wndsize = NET_DEV_RCVWNDO(dev);
+  uint8_t shift = 0;
+
+  while (shift < TCP_WS_MAXSHIFT && (wndsize >> shift) > 0xffff)
+    {
+      shift++;
+    }
+
+  return shift;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_synopts_parse
+ *
+ * Description:
+ *   Parse the options of a received SYN or SYNACK:  Clip the MSS of the
+ *   connection to the one advertised by the peer and record which of the
+ *   configured options will be in effect.
+ *
+ * Parameters:
+ *   dev   - The device driver structure containing the received segment
+ *   conn  - The TCP connection structure
+ *   iplen - The length of the IP header
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_synopts_parse(FAR struct net_driver_s *dev,
+                       FAR struct tcp_conn_s *conn, unsigned int iplen)
+{
+  FAR uint8_t *opt;
+  unsigned int optlen;
+  unsigned int len;
+  unsigned int i;
+  uint8_t optflags = 0;
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint8_t wscale = 0;
+#endif
+
+  opt = tcp_options(dev, iplen, &optlen);
+  for (i = 0; (len = tcp_nextopt(opt, i, optlen)) > 0; i += len)
+    {
+      switch (opt[i])
+        {
+          case TCP_OPT_MSS:
+            if (len == TCP_OPT_MSS_LEN)
+              {
+                uint16_t tcp_mss = TCP_MSS(dev, iplen);
+                uint16_t tmp16;
+
+                tmp16     = ((uint16_t)opt[i + 2] << 8) |
+                             (uint16_t)opt[i + 3];
+                conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+              }
+            break;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+          case TCP_OPT_WS:
+            if (len == TCP_OPT_WS_LEN)
+              {
+                /* A shift larger than 14 is treated as 14 (RFC 7323,
+                 * section 2.3).
+                 */
+
+                wscale    = opt[i + 2];
+                if (wscale > TCP_WS_MAXSHIFT)
+                  {
+                    wscale = TCP_WS_MAXSHIFT;
+                  }
+
+                optflags |= TCP_OPTF_WS;
+              }
+            break;
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+          case TCP_OPT_TS:
+            if (len == TCP_OPT_TS_LEN)
+              {
+                conn->tsrecent = tcp_getsequence(&opt[i + 2]);
+                optflags      |= TCP_OPTF_TS;
+              }
+            break;
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+          case TCP_OPT_SACK_PERM:
+            if (len == TCP_OPT_SACK_PERM_LEN)
+              {
+                optflags |= TCP_OPTF_SACK;
+              }
+            break;
+#endif
+
+          default:
+            break;
+        }
+    }
+
+  conn->optflags = optflags;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Window scaling is only in effect if both ends sent the option */
+
+  if ((optflags & TCP_OPTF_WS) != 0)
+    {
+      conn->snd_wscale = wscale;
+      conn->rcv_wscale = tcp_rcvwscale(dev);
+    }
+  else
+    {
+      conn->snd_wscale = 0;
+      conn->rcv_wscale = 0;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The timestamps option is sent in every segment.  Leave room for it. */
+
+  if ((optflags & TCP_OPTF_TS) != 0)
+    {
+      conn->mss -= TCP_OPT_TS_SPACE;
+    }
+#endif
+
+  nllvdbg("mss: %u optflags: %02x\n", conn->mss, optflags);
+}
+
+/****************************************************************************
+ * Function: tcp_synopts_build
+ *
+ * Description:
+ *   Write the options of an outgoing SYN or SYNACK.  A SYN offers all of
+ *   the configured options; a SYNACK only those that the peer offered.
+ *
+ * Parameters:
+ *   dev   - The device driver structure to use in the send operation
+ *   conn  - The TCP connection structure
+ *   flags - The TCP flags of the segment
+ *   mss   - The MSS to advertise
+ *   opt   - The location of the options in the TCP header
+ *
+ * Returned value:
+ *   The length of the options, a multiple of four bytes.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+unsigned int tcp_synopts_build(FAR struct net_driver_s *dev,
+                               FAR struct tcp_conn_s *conn, uint8_t flags,
+                               uint16_t mss, FAR uint8_t *opt)
+{
+  unsigned int len = 0;
+  uint8_t optflags;
+
+  /* A SYN offers everything that is configured */
+
+  if ((flags & TCP_ACK) == 0)
+    {
+      optflags = TCP_OPTF_WS | TCP_OPTF_TS | TCP_OPTF_SACK;
+    }
+  else
+    {
+      optflags = conn->optflags;
+    }
+
+  /* We always send out the TCP Maximum Segment Size option */
+
+  opt[len++] = TCP_OPT_MSS;
+  opt[len++] = TCP_OPT_MSS_LEN;
+  opt[len++] = mss >> 8;
+  opt[len++] = mss & 0xff;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if ((optflags & TCP_OPTF_WS) != 0)
+    {
+      opt[len++] = TCP_OPT_NOOP;
+      opt[len++] = TCP_OPT_WS;
+      opt[len++] = TCP_OPT_WS_LEN;
+      opt[len++] = tcp_rcvwscale(dev);
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  if ((optflags & TCP_OPTF_TS) != 0)
+    {
+#ifdef CONFIG_NET_TCP_SACK
+      /* SACK permitted takes the place of the NOPs before the timestamp */
+
+      if ((optflags & TCP_OPTF_SACK) != 0)
+        {
+          opt[len++] = TCP_OPT_SACK_PERM;
+          opt[len++] = TCP_OPT_SACK_PERM_LEN;
+          optflags  &= ~TCP_OPTF_SACK;
+        }
+      else
+#endif
+        {
+          opt[len++] = TCP_OPT_NOOP;
+          opt[len++] = TCP_OPT_NOOP;
+        }
+
+      /* The echo reply is zero in a SYN */
+
+      opt[len++] = TCP_OPT_TS;
+      opt[len++] = TCP_OPT_TS_LEN;
+      tcp_putu32(&opt[len], TCP_TSCLOCK());
+      tcp_putu32(&opt[len + 4],
+                 (flags & TCP_ACK) != 0 ? conn->tsrecent : 0);
+      len += 8;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  if ((optflags & TCP_OPTF_SACK) != 0)
+    {
+      opt[len++] = TCP_OPT_NOOP;
+      opt[len++] = TCP_OPT_NOOP;
+      opt[len++] = TCP_OPT_SACK_PERM;
+      opt[len++] = TCP_OPT_SACK_PERM_LEN;
+    }
+#endif
+
+  UNUSED(dev);
+  UNUSED(conn);
+  UNUSED(optflags);
+  return len;
+}
+
+/****************************************************************************
+ * Function: tcp_segopts_parse
+ *
+ * Description:
+ *   Parse the timestamps and SACK options of a received segment.
+ *
+ * Parameters:
+ *   dev   - The device driver structure containing the received segment
+ *   iplen - The length of the IP header
+ *   opts  - The location to return the options found
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef TCP_HAVE_SEGOPTS
+void tcp_segopts_parse(FAR struct net_driver_s *dev, unsigned int iplen,
+                       FAR struct tcp_segopts_s *opts)
+{
+  FAR uint8_t *opt;
+  unsigned int optlen;
+  unsigned int len;
+  unsigned int i;
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  opts->ts    = false;
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+  opts->nsack = 0;
+#endif
+
+  opt = tcp_options(dev, iplen, &optlen);
+  for (i = 0; (len = tcp_nextopt(opt, i, optlen)) > 0; i += len)
+    {
+      switch (opt[i])
+        {
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+          case TCP_OPT_TS:
+            if (len == TCP_OPT_TS_LEN)
+              {
+                opts->ts    = true;
+                opts->tsval = tcp_getsequence(&opt[i + 2]);
+                opts->tsecr = tcp_getsequence(&opt[i + 6]);
+              }
+            break;
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+          case TCP_OPT_SACK:
+            {
+              unsigned int j;
+
+              for (j = i + 2;
+                   j + 8 <= i + len && opts->nsack < TCP_SACK_MAXBLOCKS;
+                   j += 8)
+                {
+                  opts->sack[opts->nsack].left  = tcp_getsequence(&opt[j]);
+                  opts->sack[opts->nsack].right =
+                    tcp_getsequence(&opt[j + 4]);
+                  opts->nsack++;
+                }
+            }
+            break;
+#endif
+
+          default:
+            break;
+        }
+    }
+}
+#endif /* TCP_HAVE_SEGOPTS */
+
+/****************************************************************************
+ * Function: tcp_segopts_build
+ *
+ * Description:
+ *   Write the options of an outgoing segment other than a SYN:  The
+ *   timestamps option if timestamps are in effect and, on an ACK, SACK
+ *   blocks for any out-of-order data that is queued.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure
+ *   flags  - The TCP flags of the segment
+ *   opt    - The location to write the options
+ *   maxlen - The space available for options
+ *
+ * Returned value:
+ *   The length of the options, a multiple of four bytes.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef TCP_HAVE_SEGOPTS
+unsigned int tcp_segopts_build(FAR struct tcp_conn_s *conn, uint8_t flags,
+                               FAR uint8_t *opt, unsigned int maxlen)
+{
+  unsigned int len = 0;
+
+  if (maxlen > TCP_OPT_MAXLEN)
+    {
+      maxlen = TCP_OPT_MAXLEN;
+    }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  if ((conn->optflags & TCP_OPTF_TS) != 0 && maxlen >= TCP_OPT_TS_SPACE)
+    {
+      opt[len++] = TCP_OPT_NOOP;
+      opt[len++] = TCP_OPT_NOOP;
+      opt[len++] = TCP_OPT_TS;
+      opt[len++] = TCP_OPT_TS_LEN;
+      tcp_putu32(&opt[len], TCP_TSCLOCK());
+      tcp_putu32(&opt[len + 4], conn->tsrecent);
+      len += 8;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  if ((conn->optflags & TCP_OPTF_SACK) != 0 && (flags & TCP_ACK) != 0 &&
+      conn->nofosegs > 0 && maxlen >= len + 12)
+    {
+      struct tcp_sackblk_s blocks[TCP_SACK_MAXBLOCKS];
+      unsigned int nblocks;
+      unsigned int i;
+
+      /* Two NOPs, the kind and length, then eight bytes per block */
+
+      nblocks = (maxlen - len - 4) >> 3;
+      nblocks = tcp_sack_blocks(conn, blocks, nblocks);
+
+      opt[len++] = TCP_OPT_NOOP;
+      opt[len++] = TCP_OPT_NOOP;
+      opt[len++] = TCP_OPT_SACK;
+      opt[len++] = 2 + (nblocks << 3);
+
+      for (i = 0; i < nblocks; i++)
+        {
+          tcp_putu32(&opt[len], blocks[i].left);
+          tcp_putu32(&opt[len + 4], blocks[i].right);
+          len += 8;
+        }
+    }
+#endif
+
+  UNUSED(flags);
+  return len;
+}
+#endif /* TCP_HAVE_SEGOPTS */
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP */
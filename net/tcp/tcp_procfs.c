@@ -0,0 +1,460 @@
+/****************************************************************************
+ * net/tcp/tcp_procfs.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#if defined(CONFIG_NET_TCP) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_DISABLE_MOUNTPOINT) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define TCPSTATS_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct tcpstats_file_s
+{
+  struct procfs_file_s base;   /* Base open file structure */
+  unsigned int index;          /* Index of the next line */
+  unsigned int linesize;       /* Number of valid characters in line[] */
+  unsigned int lineoffset;     /* Number of characters already returned */
+  char line[TCPSTATS_LINELEN]; /* Buffer for the formatted line */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     tcpstats_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     tcpstats_close(FAR struct file *filep);
+static ssize_t tcpstats_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     tcpstats_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     tcpstats_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* TCP state names, indexed by (tcpstateflags & TCP_STATE_MASK) */
+
+static FAR const char *g_tcpstates[] =
+{
+  "CLOSED",
+  "ALLOCATED",
+  "SYN_RCVD",
+  "SYN_SENT",
+  "ESTABLISHED",
+  "FIN_WAIT_1",
+  "FIN_WAIT_2",
+  "CLOSING",
+  "TIME_WAIT",
+  "LAST_ACK"
+};
+
+#define NTCPSTATES (sizeof(g_tcpstates) / sizeof(g_tcpstates[0]))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs/procfs/fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations tcp_procfsoperations =
+{
+  tcpstats_open,     /* open */
+  tcpstats_close,    /* close */
+  tcpstats_read,     /* read */
+  NULL,              /* write */
+
+  tcpstats_dup,      /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  tcpstats_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcpstats_header
+ *
+ * Description:
+ *   Format the column headings.
+ *
+ ****************************************************************************/
+
+static int tcpstats_header(FAR char *line)
+{
+#ifdef CONFIG_NET_STATISTICS
+  return snprintf(line, TCPSTATS_LINELEN,
+                  "%-5s %-5s %-11s %6s %6s %6s %4s %8s %6s %6s %6s\n",
+                  "LPort", "RPort", "State", "SRTT", "RTTVAR", "RTO",
+                  "NRTX", "Samples", "MinRTT", "MaxRTT", "Rexmit");
+#else
+  return snprintf(line, TCPSTATS_LINELEN,
+                  "%-5s %-5s %-11s %6s %6s %6s %4s\n",
+                  "LPort", "RPort", "State", "SRTT", "RTTVAR", "RTO",
+                  "NRTX");
+#endif
+}
+
+/****************************************************************************
+ * Name: tcpstats_line
+ *
+ * Description:
+ *   Format the statistics of one connection.  Times are in milliseconds.
+ *
+ ****************************************************************************/
+
+static int tcpstats_line(FAR struct tcp_conn_s *conn, FAR char *line)
+{
+  unsigned int state = conn->tcpstateflags & TCP_STATE_MASK;
+
+#ifdef CONFIG_NET_STATISTICS
+  return snprintf(line, TCPSTATS_LINELEN,
+                  "%-5u %-5u %-11s %6lu %6lu %6lu %4u %8lu %6lu %6lu %6lu\n",
+                  ntohs(conn->lport), ntohs(conn->rport),
+                  state < NTCPSTATES ? g_tcpstates[state] : "?",
+                  (unsigned long)(conn->srtt >> 3),
+                  (unsigned long)(conn->rttvar >> 2),
+                  (unsigned long)conn->rto, conn->nrtx,
+                  (unsigned long)conn->nrtt, (unsigned long)conn->rttmin,
+                  (unsigned long)conn->rttmax,
+                  (unsigned long)conn->nrexmit);
+#else
+  return snprintf(line, TCPSTATS_LINELEN,
+                  "%-5u %-5u %-11s %6lu %6lu %6lu %4u\n",
+                  ntohs(conn->lport), ntohs(conn->rport),
+                  state < NTCPSTATES ? g_tcpstates[state] : "?",
+                  (unsigned long)(conn->srtt >> 3),
+                  (unsigned long)(conn->rttvar >> 2),
+                  (unsigned long)conn->rto, conn->nrtx);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcpstats_nextline
+ *
+ * Description:
+ *   Format the next line of output into the line buffer.  Line zero is the
+ *   heading;  line n is the n'th active connection.
+ *
+ * Returned Value:
+ *   false if there is no further output.
+ *
+ ****************************************************************************/
+
+static bool tcpstats_nextline(FAR struct tcpstats_file_s *priv)
+{
+  FAR struct tcp_conn_s *conn;
+  net_lock_t state;
+  unsigned int index;
+
+  priv->linesize   = 0;
+  priv->lineoffset = 0;
+
+  if (priv->index == 0)
+    {
+      priv->linesize = tcpstats_header(priv->line);
+    }
+  else
+    {
+      /* The list of active connections may change between reads.  Just find
+       * the index'th connection now.
+       */
+
+      state = net_lock();
+      for (conn = tcp_nextconn(NULL), index = 1;
+           conn != NULL && index < priv->index;
+           conn = tcp_nextconn(conn), index++)
+        {
+        }
+
+      if (conn != NULL)
+        {
+          priv->linesize = tcpstats_line(conn, priv->line);
+        }
+
+      net_unlock(state);
+    }
+
+  if (priv->linesize == 0)
+    {
+      return false;
+    }
+
+  if (priv->linesize >= TCPSTATS_LINELEN)
+    {
+      priv->linesize = TCPSTATS_LINELEN - 1;
+    }
+
+  priv->index++;
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcpstats_open
+ ****************************************************************************/
+
+static int tcpstats_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct tcpstats_file_s *priv;
+
+  fvdbg("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      fdbg("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "net/tcp" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "net/tcp") != 0)
+    {
+      fdbg("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  priv = (FAR struct tcpstats_file_s *)
+    kmm_zalloc(sizeof(struct tcpstats_file_s));
+
+  if (!priv)
+    {
+      fdbg("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcpstats_close
+ ****************************************************************************/
+
+static int tcpstats_close(FAR struct file *filep)
+{
+  FAR struct tcpstats_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct tcpstats_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the file attributes structure */
+
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcpstats_read
+ ****************************************************************************/
+
+static ssize_t tcpstats_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct tcpstats_file_s *priv;
+  size_t total = 0;
+  size_t ncopy;
+
+  fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct tcpstats_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Return whole lines while there is space in the user buffer.  Lines
+   * are formatted one at a time so that a reader with a small buffer
+   * still sees consistent lines.
+   */
+
+  while (total < buflen)
+    {
+      if (priv->lineoffset >= priv->linesize && !tcpstats_nextline(priv))
+        {
+          break;
+        }
+
+      ncopy = priv->linesize - priv->lineoffset;
+      if (ncopy > buflen - total)
+        {
+          ncopy = buflen - total;
+        }
+
+      memcpy(&buffer[total], &priv->line[priv->lineoffset], ncopy);
+      priv->lineoffset += ncopy;
+      total            += ncopy;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += total;
+  return total;
+}
+
+/****************************************************************************
+ * Name: tcpstats_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int tcpstats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct tcpstats_file_s *oldpriv;
+  FAR struct tcpstats_file_s *newpriv;
+
+  fvdbg("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = (FAR struct tcpstats_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newpriv = (FAR struct tcpstats_file_s *)
+    kmm_malloc(sizeof(struct tcpstats_file_s));
+
+  if (!newpriv)
+    {
+      fdbg("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newpriv, oldpriv, sizeof(struct tcpstats_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcpstats_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int tcpstats_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "net/tcp" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "net/tcp") != 0)
+    {
+      fdbg("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "net/tcp" is the name for a read-only file */
+
+  buf->st_mode    = S_IFREG|S_IROTH|S_IRGRP|S_IRUSR;
+  buf->st_size    = 0;
+  buf->st_blksize = 0;
+  buf->st_blocks  = 0;
+  return OK;
+}
+
+#endif /* CONFIG_NET_TCP && CONFIG_FS_PROCFS && !CONFIG_DISABLE_MOUNTPOINT &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET */
@@ -0,0 +1,344 @@
+/****************************************************************************
+ * net/tcp/tcp_sack.c
+ *
+ *   Copyright (C) 2026 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_SACK)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/iob.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_sack_remove
+ *
+ * Description:
+ *   Remove one range from the scoreboard, closing the gap.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_remove(FAR struct tcp_conn_s *conn, int index)
+{
+  conn->nsacks--;
+  memmove(&conn->sacks[index], &conn->sacks[index + 1],
+          (conn->nsacks - index) * sizeof(struct tcp_sackblk_s));
+}
+
+/****************************************************************************
+ * Function: tcp_sack_insert
+ *
+ * Description:
+ *   Add one range to the scoreboard, merging it with any ranges that it
+ *   overlaps or adjoins.  If the scoreboard is full, the highest range is
+ *   forgotten:  The lowest holes are the ones to be repaired first.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_insert(FAR struct tcp_conn_s *conn, uint32_t left,
+                            uint32_t right)
+{
+  int i;
+
+  /* Absorb every range that overlaps or adjoins the new one */
+
+  for (i = 0; i < conn->nsacks; )
+    {
+      FAR struct tcp_sackblk_s *sack = &conn->sacks[i];
+
+      if (TCP_SEQ_LTE(sack->left, right) && TCP_SEQ_LTE(left, sack->right))
+        {
+          if (TCP_SEQ_LT(sack->left, left))
+            {
+              left = sack->left;
+            }
+
+          if (TCP_SEQ_LT(right, sack->right))
+            {
+              right = sack->right;
+            }
+
+          tcp_sack_remove(conn, i);
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  /* Find the position of the new range */
+
+  for (i = 0; i < conn->nsacks; i++)
+    {
+      if (TCP_SEQ_LT(left, conn->sacks[i].left))
+        {
+          break;
+        }
+    }
+
+  if (conn->nsacks >= CONFIG_NET_TCP_SACK_BLOCKS)
+    {
+      if (i >= conn->nsacks)
+        {
+          return;
+        }
+
+      conn->nsacks--;
+    }
+
+  memmove(&conn->sacks[i + 1], &conn->sacks[i],
+          (conn->nsacks - i) * sizeof(struct tcp_sackblk_s));
+
+  conn->sacks[i].left  = left;
+  conn->sacks[i].right = right;
+  conn->nsacks++;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_sack_blocks
+ *
+ * Description:
+ *   Describe the out-of-order data queued for the connection as SACK
+ *   blocks.  The block holding the most recently received segment is
+ *   reported first (RFC 2018, section 4).
+ *
+ * Parameters:
+ *   conn      - The TCP connection structure
+ *   blocks    - The location to return the SACK blocks
+ *   maxblocks - The maximum number of blocks to return
+ *
+ * Returned value:
+ *   The number of blocks returned
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+unsigned int tcp_sack_blocks(FAR struct tcp_conn_s *conn,
+                             FAR struct tcp_sackblk_s *blocks,
+                             unsigned int maxblocks)
+{
+  unsigned int nblocks = 0;
+  int first = -1;
+  int i;
+
+  for (i = 0; i < conn->nofosegs; i++)
+    {
+      FAR struct tcp_ofoseg_s *seg = &conn->ofosegs[i];
+
+      if (TCP_SEQ_LTE(seg->seqno, conn->ofolast) &&
+          TCP_SEQ_LT(conn->ofolast, seg->seqno + seg->data->io_pktlen))
+        {
+          first = i;
+          break;
+        }
+    }
+
+  if (first >= 0 && maxblocks > 0)
+    {
+      blocks[0].left  = conn->ofosegs[first].seqno;
+      blocks[0].right = blocks[0].left +
+                        conn->ofosegs[first].data->io_pktlen;
+      nblocks         = 1;
+    }
+
+  for (i = 0; i < conn->nofosegs && nblocks < maxblocks; i++)
+    {
+      if (i != first)
+        {
+          blocks[nblocks].left  = conn->ofosegs[i].seqno;
+          blocks[nblocks].right = blocks[nblocks].left +
+                                  conn->ofosegs[i].data->io_pktlen;
+          nblocks++;
+        }
+    }
+
+  return nblocks;
+}
+
+/****************************************************************************
+ * Function: tcp_sack_update
+ *
+ * Description:
+ *   Update the scoreboard with the cumulative acknowledgement and the SACK
+ *   blocks of a received ACK.
+ *
+ * Parameters:
+ *   conn    - The TCP connection structure
+ *   ackseq  - The acknowledgement number of the segment
+ *   blocks  - The SACK blocks of the segment
+ *   nblocks - The number of SACK blocks
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_sack_update(FAR struct tcp_conn_s *conn, uint32_t ackseq,
+                     FAR const struct tcp_sackblk_s *blocks,
+                     unsigned int nblocks)
+{
+  uint32_t sndnxt = conn->isn + conn->sent;
+  uint32_t left;
+  unsigned int i;
+  int j;
+
+  /* Forget whatever is now covered by the cumulative ACK */
+
+  for (j = 0; j < conn->nsacks; )
+    {
+      FAR struct tcp_sackblk_s *sack = &conn->sacks[j];
+
+      if (TCP_SEQ_LTE(sack->right, ackseq))
+        {
+          tcp_sack_remove(conn, j);
+        }
+      else
+        {
+          if (TCP_SEQ_LT(sack->left, ackseq))
+            {
+              sack->left = ackseq;
+            }
+
+          j++;
+        }
+    }
+
+  /* Add the new blocks.  Blocks at or below the cumulative ACK (D-SACKs)
+   * and blocks that describe data that was never sent are ignored.
+   */
+
+  for (i = 0; i < nblocks; i++)
+    {
+      left = blocks[i].left;
+      if (!TCP_SEQ_LT(left, blocks[i].right) ||
+          TCP_SEQ_LTE(blocks[i].right, ackseq) ||
+          TCP_SEQ_LT(sndnxt, blocks[i].right))
+        {
+          continue;
+        }
+
+      if (TCP_SEQ_LT(left, ackseq))
+        {
+          left = ackseq;
+        }
+
+      tcp_sack_insert(conn, left, blocks[i].right);
+    }
+}
+
+/****************************************************************************
+ * Function: tcp_sack_nextrtx
+ *
+ * Description:
+ *   Select the next data to retransmit during fast recovery:  The first
+ *   data at or after conn->rtxnext that has not been SACKed but that lies
+ *   below data that has been.  conn->rtxnext is advanced past it.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure
+ *   snduna - The oldest unacknowledged sequence number
+ *   seqno  - The location to return the first sequence number to resend
+ *   len    - The location to return the number of bytes to resend (at
+ *            most one MSS)
+ *
+ * Returned value:
+ *   True if there is data to retransmit
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool tcp_sack_nextrtx(FAR struct tcp_conn_s *conn, uint32_t snduna,
+                      FAR uint32_t *seqno, FAR uint32_t *len)
+{
+  uint32_t seq;
+  uint32_t n;
+  int i;
+
+  seq = TCP_SEQ_LT(conn->rtxnext, snduna) ? snduna : conn->rtxnext;
+
+  for (i = 0; i < conn->nsacks; i++)
+    {
+      FAR struct tcp_sackblk_s *sack = &conn->sacks[i];
+
+      if (TCP_SEQ_LT(seq, sack->left))
+        {
+          /* A hole below SACKed data */
+
+          n = sack->left - seq;
+          if (n > conn->mss)
+            {
+              n = conn->mss;
+            }
+
+          *seqno        = seq;
+          *len          = n;
+          conn->rtxnext = seq + n;
+          return true;
+        }
+
+      if (TCP_SEQ_LT(seq, sack->right))
+        {
+          seq = sack->right;
+        }
+    }
+
+  conn->rtxnext = seq;
+  return false;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_SACK */
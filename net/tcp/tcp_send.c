@@ -361,8 +361,24 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      tcp->wnd[0] = ((NET_DEV_RCVWNDO(dev)) >> 8);
-      tcp->wnd[1] = ((NET_DEV_RCVWNDO(dev)) & 0xff);
+      uint32_t wndsize = NET_DEV_RCVWNDO(dev);
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      /* The window field of a SYN is never scaled (RFC 7323, 2.2) */
+
+      if ((tcp->flags & TCP_SYN) == 0)
+        {
+          wndsize >>= conn->rcv_wscale;
+        }
+#endif
+
+      if (wndsize > 0xffff)
+        {
+          wndsize = 0xffff;
+        }
+
+      tcp->wnd[0] = (wndsize >> 8);
+      tcp->wnd[1] = (wndsize & 0xff);
     }
 
   /* Finish the IP portion of the message and calculate checksums */
@@ -399,10 +415,39 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
               uint16_t flags, uint16_t len)
 {
   FAR struct tcp_hdr_s *tcp = tcp_header(dev);
+  FAR uint8_t *payload = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  unsigned int paylen;
+  unsigned int optlen = 0;
+#ifdef TCP_HAVE_SEGOPTS
+  uint8_t opts[TCP_OPT_MAXLEN];
+#endif
+
+  /* The length of the payload which was placed at d_appdata.  That is
+   * normally just after the TCP header but may follow the options of a
+   * received segment.
+   */
+
+  paylen = len - (payload - &dev->d_buf[NET_LL_HDRLEN(dev)]);
+
+#ifdef TCP_HAVE_SEGOPTS
+  /* Options must fit into the MTU along with the payload */
+
+  optlen = tcp_segopts_build(conn, flags, opts,
+                             NET_DEV_MTU(dev) - NET_LL_HDRLEN(dev) - len);
+#endif
+
+  if (paylen > 0 && dev->d_appdata != payload + optlen)
+    {
+      memmove(payload + optlen, dev->d_appdata, paylen);
+    }
+
+#ifdef TCP_HAVE_SEGOPTS
+  memcpy(payload, opts, optlen);
+#endif
 
   tcp->flags     = flags;
-  dev->d_len     = len;
-  tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
+  dev->d_len     = len + optlen;
+  tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
   tcp_sendcommon(dev, conn, tcp);
 }
 
@@ -545,6 +590,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 {
   struct tcp_hdr_s *tcp;
   uint16_t tcp_mss;
+  unsigned int optlen;
 
   /* Get values that vary with the underlying IP domain */
 
@@ -558,9 +604,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp     = TCPIPv6BUF;
       tcp_mss = TCP_IPv6_MSS(dev);
 
-      /* Set the the packet length for the TCP Maximum Segment Size */
+      /* Set the the packet length without the TCP options */
 
-      dev->d_len  = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv6TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -574,9 +620,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp     = TCPIPv4BUF;
       tcp_mss = TCP_IPv4_MSS(dev);
 
-      /* Set the the packet length for the TCP Maximum Segment Size */
+      /* Set the the packet length without the TCP options */
 
-      dev->d_len  = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv4TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -584,13 +630,14 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   tcp->flags      = ack;
 
-  /* We send out the TCP Maximum Segment Size option with our ack. */
+  /* We send out the TCP Maximum Segment Size option with our ack, along
+   * with any other options that are offered or have been negotiated.
+   */
 
-  tcp->optdata[0] = TCP_OPT_MSS;
-  tcp->optdata[1] = TCP_OPT_MSS_LEN;
-  tcp->optdata[2] = tcp_mss >> 8;
-  tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  optlen          = tcp_synopts_build(dev, conn, ack, tcp_mss,
+                                      (FAR uint8_t *)tcp + TCP_HDRLEN);
+  dev->d_len     += optlen;
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
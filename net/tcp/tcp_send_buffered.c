@@ -66,6 +66,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/iob.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/tcp.h>
 
@@ -91,6 +92,17 @@
 #define TCPIPv4BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
 #define TCPIPv6BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
 
+/* With congestion control, new data is also sent in response to an ACK
+ * that opens the window (ACK clocking).  This is not possible if the ACK
+ * carried data:  That data is still in d_buf.
+ */
+
+#ifdef CONFIG_NET_TCP_CC
+#  define TCP_ACKSEND(f)  (((f) & (TCP_ACKDATA | TCP_NEWDATA)) == TCP_ACKDATA)
+#else
+#  define TCP_ACKSEND(f)  (false)
+#endif
+
 /* Debug */
 
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
@@ -311,6 +323,126 @@ static inline bool psock_send_addrchck(FAR struct tcp_conn_s *conn)
 #  define psock_send_addrchck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Function: psock_send_fastrtx
+ *
+ * Description:
+ *   Resend the first unacknowledged segment for fast retransmit.  Unlike a
+ *   time-out, this does not move the un-ACKed write buffers back to the
+ *   write_q:  Only the missing segment is resent and the accounting of data
+ *   in flight is unchanged.  If the peer has reported selective
+ *   acknowledgements, the next hole in the data that it holds is resent
+ *   instead.
+ *
+ * Parameters:
+ *   dev      The structure of the network driver that caused the interrupt
+ *   psock    The socket structure
+ *   conn     The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   true if a segment was set up for retransmission
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+static bool psock_send_fastrtx(FAR struct net_driver_s *dev,
+                               FAR struct socket *psock,
+                               FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t seqno;
+  size_t offset;
+  size_t sndlen;
+
+  /* The unacked_q is in sequence number order, and anything in it was sent
+   * before the partially sent write buffer at the head of the write_q.
+   */
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+  if (wrb == NULL)
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb == NULL || WRB_SENT(wrb) == 0)
+        {
+          return false;
+        }
+    }
+
+  seqno  = WRB_SEQNO(wrb);
+  offset = 0;
+  sndlen = WRB_SENT(wrb);
+  if (sndlen > conn->mss)
+    {
+      sndlen = conn->mss;
+    }
+
+#ifdef CONFIG_NET_TCP_SACK
+  if (conn->nsacks > 0)
+    {
+      uint32_t len;
+
+      /* Find the next hole below the data that the peer holds */
+
+      if (!tcp_sack_nextrtx(conn, conn->isn + conn->sent - conn->unacked,
+                            &seqno, &len))
+        {
+          return false;
+        }
+
+      /* Find the write buffer holding that sequence number.  If it is not
+       * in the unacked_q, it must be in the sent part of the write_q head.
+       */
+
+      for (wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+           wrb != NULL;
+           wrb = (FAR struct tcp_wrbuffer_s *)sq_next(&wrb->wb_node))
+        {
+          if (!TCP_SEQ_LT(seqno, WRB_SEQNO(wrb)) &&
+              TCP_SEQ_LT(seqno, WRB_SEQNO(wrb) + WRB_SENT(wrb)))
+            {
+              break;
+            }
+        }
+
+      if (wrb == NULL)
+        {
+          wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+          if (wrb == NULL || TCP_SEQ_LT(seqno, WRB_SEQNO(wrb)) ||
+              !TCP_SEQ_LT(seqno, WRB_SEQNO(wrb) + WRB_SENT(wrb)))
+            {
+              return false;
+            }
+        }
+
+      offset = seqno - WRB_SEQNO(wrb);
+      sndlen = WRB_SENT(wrb) - offset;
+      if (sndlen > len)
+        {
+          sndlen = len;
+        }
+    }
+#endif
+
+  nllvdbg("FASTRTX: wrb=%p seqno=%u sndlen=%u\n", wrb, seqno, sndlen);
+
+  tcp_setsequence(conn->sndseq, seqno);
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  send_ipselect(dev, psock);
+#endif
+
+  devif_iob_send(dev, WRB_IOB(wrb), sndlen, offset);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rexmit++;
+#endif
+  return true;
+}
+#endif /* CONFIG_NET_TCP_CC */
+
 /****************************************************************************
  * Function: psock_send_interrupt
  *
@@ -680,8 +812,25 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
    * next polling cycle.
    */
 
+#ifdef CONFIG_NET_TCP_CC
+  /* A fast retransmit takes precedence over new data */
+
+  if ((conn->ccflags & TCP_CC_FASTRTX) != 0 &&
+      (conn->tcpstateflags & TCP_ESTABLISHED) &&
+      ((flags & TCP_POLL) != 0 || TCP_ACKSEND(flags)) &&
+      psock_send_addrchck(conn))
+    {
+      conn->ccflags &= ~TCP_CC_FASTRTX;
+      if (psock_send_fastrtx(dev, psock, conn))
+        {
+          flags &= ~TCP_POLL;
+          return flags;
+        }
+    }
+#endif
+
   if ((conn->tcpstateflags & TCP_ESTABLISHED) &&
-      (flags & (TCP_POLL | TCP_REXMIT)) &&
+      ((flags & (TCP_POLL | TCP_REXMIT)) != 0 || TCP_ACKSEND(flags)) &&
       !(sq_empty(&conn->write_q)))
     {
       /* Check if the destination IP address is in the ARP  or Neighbor
@@ -719,6 +868,20 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
               sndlen = conn->winsize;
             }
 
+#ifdef CONFIG_NET_TCP_CC
+          /* Do not put more in flight than both the congestion window and
+           * the peer's window allow.  While data is outstanding, wait for
+           * the ACKs rather than send a runt segment.
+           */
+
+          if (conn->unacked > 0 &&
+              (conn->unacked + sndlen > conn->cwnd ||
+               conn->unacked + sndlen > conn->winsize))
+            {
+              return flags;
+            }
+#endif
+
           nllvdbg("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
                   wrb, WRB_PKTLEN(wrb), WRB_SENT(wrb), sndlen);
 
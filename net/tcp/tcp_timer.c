@@ -46,8 +46,13 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <debug.h>
 
+#include <arch/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -60,6 +65,38 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The clock granularity G of RFC 6298 in milliseconds */
+
+#if MSEC_PER_TICK > 0
+#  define TCP_RTT_G        MSEC_PER_TICK
+#else
+#  define TCP_RTT_G        1
+#endif
+
+/* Limit on the exponential backoff shift.  The backed-off time-out is
+ * clipped to CONFIG_NET_TCP_RTO_MAX in any event.
+ */
+
+#define TCP_RTO_MAXSHIFT   6
+
+/* True if the retransmission timer of the connection is running:  There
+ * is outstanding data in a state in which it may be retransmitted.
+ */
+
+#define TCP_RTX_RUNNING(conn) \
+  ((conn)->unacked > 0 && \
+   (conn)->tcpstateflags != TCP_CLOSED && \
+   (conn)->tcpstateflags != TCP_TIME_WAIT && \
+   (conn)->tcpstateflags != TCP_FIN_WAIT_2)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RTO_TIMER
+static void tcp_timer_work(FAR void *arg);
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -68,10 +105,119 @@
  * Private Variables
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_RTO_TIMER
+/* The retransmission timer is a single work queue entry that is scheduled
+ * for the earliest retransmission time-out of all connections.
+ */
+
+static struct work_s g_tcp_rtxwork;
+static uint32_t g_tcp_rtxexpiry;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_timer_txnotify
+ *
+ * Description:
+ *   netdev_foreach() callback:  Ask the network device to poll for TX data.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RTO_TIMER
+static int tcp_timer_txnotify(FAR struct net_driver_s *dev, FAR void *arg)
+{
+  if (dev->d_txavail != NULL)
+    {
+      (void)dev->d_txavail(dev);
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_timer_arm
+ *
+ * Description:
+ *   Schedule the retransmission timer work for the provided expiry time
+ *   unless it is already scheduled to run earlier.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RTO_TIMER
+static void tcp_timer_arm(uint32_t expiry)
+{
+  irqstate_t flags;
+  int32_t delay;
+
+  flags = irqsave();
+  if (work_available(&g_tcp_rtxwork) ||
+      TCP_SEQ_LT(expiry, g_tcp_rtxexpiry))
+    {
+      delay = (int32_t)(expiry - (uint32_t)clock_systimer());
+      if (delay < 0)
+        {
+          delay = 0;
+        }
+
+      (void)work_cancel(LPWORK, &g_tcp_rtxwork);
+      (void)work_queue(LPWORK, &g_tcp_rtxwork, tcp_timer_work, NULL,
+                       (uint32_t)delay);
+      g_tcp_rtxexpiry = expiry;
+    }
+
+  irqrestore(flags);
+}
+#else
+#  define tcp_timer_arm(e)
+#endif
+
+/****************************************************************************
+ * Name: tcp_timer_work
+ *
+ * Description:
+ *   Runs on the low priority work queue when the earliest retransmission
+ *   time-out expires.  Re-arm the timer for connections that have not yet
+ *   expired and ask all network devices to poll;  tcp_poll() will then
+ *   perform the retransmissions.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RTO_TIMER
+static void tcp_timer_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+  net_lock_t state;
+  bool expired = false;
+
+  state = net_lock();
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (TCP_RTX_RUNNING(conn))
+        {
+          if (tcp_timer_expired(conn))
+            {
+              expired = true;
+            }
+          else
+            {
+              tcp_timer_arm(conn->rtxtime);
+            }
+        }
+    }
+
+  net_unlock(state);
+
+  if (expired)
+    {
+      (void)netdev_foreach(tcp_timer_txnotify, NULL);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,7 +231,9 @@
  * Parameters:
  *   dev  - The device driver structure to use in the send operation
  *   conn - The TCP "connection" to poll for TX data
- *   hsed - The polling interval in halves of a second
+ *   hsec - The polling interval in halves of a second.  This is used
+ *          only for the TIME_WAIT timer;  the retransmission timer is
+ *          based on the system clock.
  *
  * Return:
  *   None
@@ -170,20 +318,12 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       if (conn->unacked > 0)
         {
-          /* The connection has outstanding data */
+          /* The connection has outstanding data.  Has the retransmission
+           * timer expired?
+           */
 
-          if (conn->timer > hsec)
+          if (tcp_timer_expired(conn))
             {
-              /* Will not yet decrement to zero */
-
-              conn->timer -= hsec;
-            }
-          else
-            {
-              /* Will decrement to zero */
-
-              conn->timer = 0;
-
               /* Should we close the connection? */
 
               if (
@@ -213,10 +353,21 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                   goto done;
                 }
 
-             /* Exponential backoff. */
+              /* Exponential backoff (RFC 6298, 5.5).  The round-trip time
+               * measurement in progress (if any) is abandoned and no data
+               * sent so far will be timed (Karn's algorithm).
+               */
 
-              conn->timer = TCP_RTO << (conn->nrtx > 4 ? 4: conn->nrtx);
               (conn->nrtx)++;
+              tcp_timer_start(conn);
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+              conn->rttseq    = conn->isn + conn->sent;
+#else
+              conn->rttseq    = tcp_addsequence(conn->sndseq, conn->unacked);
+#endif
+              conn->rttflags &= ~TCP_RTT_PENDING;
+              conn->rttflags |= TCP_RTT_KARN;
 
               /* Ok, so we need to retransmit. We do this differently
                * depending on which state we are in. In ESTABLISHED, we
@@ -228,6 +379,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
 #ifdef CONFIG_NET_STATISTICS
               g_netstats.tcp.rexmit++;
+              conn->nrexmit++;
 #endif
               switch (conn->tcpstateflags & TCP_STATE_MASK)
                 {
@@ -251,6 +403,11 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                      * the code for sending out the packet.
                      */
 
+#ifdef CONFIG_NET_TCP_CC
+                    /* Restart from slow start */
+
+                    tcp_cc_timeout(conn);
+#endif
                     result = tcp_callback(dev, conn, TCP_REXMIT);
                     tcp_rexmit(dev, conn, result);
                     goto done;
@@ -288,4 +445,243 @@ done:
   return;
 }
 
+/****************************************************************************
+ * Name: tcp_timer_start
+ *
+ * Description:
+ *   (Re-)start the retransmission timer of the connection.  The timer will
+ *   expire after the current retransmission time-out, including the
+ *   exponential backoff for any retransmissions of the last segment sent.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_timer_start(FAR struct tcp_conn_s *conn)
+{
+  uint32_t rto;
+
+  rto = conn->rto << (conn->nrtx > TCP_RTO_MAXSHIFT ?
+                      TCP_RTO_MAXSHIFT : conn->nrtx);
+  if (rto > CONFIG_NET_TCP_RTO_MAX)
+    {
+      rto = CONFIG_NET_TCP_RTO_MAX;
+    }
+
+  conn->rtxtime = (uint32_t)clock_systimer() + MSEC2TICK(rto);
+  tcp_timer_arm(conn->rtxtime);
+}
+
+/****************************************************************************
+ * Name: tcp_timer_expire
+ *
+ * Description:
+ *   Force the retransmission timer of the connection to expire now so that
+ *   the connection is serviced at the next poll.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_timer_expire(FAR struct tcp_conn_s *conn)
+{
+  conn->rtxtime = (uint32_t)clock_systimer();
+  tcp_timer_arm(conn->rtxtime);
+}
+
+/****************************************************************************
+ * Name: tcp_timer_expired
+ *
+ * Description:
+ *   Return true if the connection has outstanding data that may be
+ *   retransmitted and its retransmission timer has expired.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   True if the connection requires retransmission
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool tcp_timer_expired(FAR struct tcp_conn_s *conn)
+{
+  return TCP_RTX_RUNNING(conn) &&
+         TCP_SEQ_LTE(conn->rtxtime, (uint32_t)clock_systimer());
+}
+
+/****************************************************************************
+ * Name: tcp_rtt_start
+ *
+ * Description:
+ *   Called when a segment is sent.  If no round-trip time measurement is in
+ *   progress, start timing the segment.  Per Karn's algorithm, data that may
+ *   have been retransmitted is not timed.
+ *
+ * Parameters:
+ *   conn  - The TCP connection structure holding connection information
+ *   seqno - The sequence number that follows the last byte of the segment
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_rtt_start(FAR struct tcp_conn_s *conn, uint32_t seqno)
+{
+  if ((conn->rttflags & TCP_RTT_PENDING) == 0 &&
+      ((conn->rttflags & TCP_RTT_KARN) == 0 ||
+       TCP_SEQ_LT(conn->rttseq, seqno)))
+    {
+      conn->rttseq    = seqno;
+      conn->rtttime   = (uint32_t)clock_systimer();
+      conn->rttflags &= ~TCP_RTT_KARN;
+      conn->rttflags |= TCP_RTT_PENDING;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rtt_ack
+ *
+ * Description:
+ *   Called when an ACK is received.  If the ACK completes the round-trip
+ *   time measurement in progress, update the smoothed round-trip time and
+ *   variation and recompute the retransmission time-out as described in
+ *   RFC 6298.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure holding connection information
+ *   ackseq - The acknowledged sequence number
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_rtt_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq)
+{
+  if ((conn->rttflags & TCP_RTT_PENDING) == 0 ||
+      TCP_SEQ_LT(ackseq, conn->rttseq))
+    {
+      return;
+    }
+
+  conn->rttflags &= ~TCP_RTT_PENDING;
+  tcp_rtt_sample(conn, TICK2MSEC((uint32_t)clock_systimer() - conn->rtttime));
+}
+
+/****************************************************************************
+ * Name: tcp_rtt_sample
+ *
+ * Description:
+ *   Update the smoothed round-trip time and variation with one round-trip
+ *   time measurement and recompute the retransmission time-out as described
+ *   in RFC 6298.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *   rtt  - The measured round-trip time (units: msec)
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_rtt_sample(FAR struct tcp_conn_s *conn, uint32_t rtt)
+{
+  int32_t delta;
+
+  if ((conn->rttflags & TCP_RTT_VALID) == 0)
+    {
+      /* First measurement (RFC 6298, 2.2):  SRTT = R, RTTVAR = R/2 */
+
+      conn->srtt      = rtt << 3;
+      conn->rttvar    = rtt << 1;
+      conn->rttflags |= TCP_RTT_VALID;
+    }
+  else
+    {
+      /* Subsequent measurements (RFC 6298, 2.3), as in Van Jacobson's
+       * scaled integer implementation:
+       *
+       *   RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|
+       *   SRTT   = 7/8 SRTT   + 1/8 R
+       */
+
+      delta       = (int32_t)rtt - (int32_t)(conn->srtt >> 3);
+      conn->srtt += delta;
+      if (delta < 0)
+        {
+          delta = -delta;
+        }
+
+      delta         -= (int32_t)(conn->rttvar >> 2);
+      conn->rttvar  += delta;
+    }
+
+  /* RTO = SRTT + max(G, 4 * RTTVAR), clipped to the configured limits */
+
+  conn->rto = (conn->srtt >> 3) +
+              (conn->rttvar > TCP_RTT_G ? conn->rttvar : TCP_RTT_G);
+
+  if (conn->rto < CONFIG_NET_TCP_RTO_MIN)
+    {
+      conn->rto = CONFIG_NET_TCP_RTO_MIN;
+    }
+  else if (conn->rto > CONFIG_NET_TCP_RTO_MAX)
+    {
+      conn->rto = CONFIG_NET_TCP_RTO_MAX;
+    }
+
+  /* A valid measurement means that the retransmitted data has been
+   * acknowledged:  Collapse the exponential backoff.
+   */
+
+  conn->nrtx = 0;
+
+#ifdef CONFIG_NET_STATISTICS
+  if (conn->nrtt == 0 || rtt < conn->rttmin)
+    {
+      conn->rttmin = rtt;
+    }
+
+  if (rtt > conn->rttmax)
+    {
+      conn->rttmax = rtt;
+    }
+
+  conn->nrtt++;
+#endif
+
+  nllvdbg("rtt: %lu srtt: %lu rttvar: %lu rto: %lu\n",
+          (unsigned long)rtt, (unsigned long)(conn->srtt >> 3),
+          (unsigned long)(conn->rttvar >> 2), (unsigned long)conn->rto);
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #include <nuttx/net/ip.h>
@@ -82,12 +83,14 @@ struct udp_hdr_s;         /* Forward reference */
 struct udp_conn_s
 {
   dq_entry_t node;        /* Supports a doubly linked list */
+  FAR struct udp_conn_s *hnext; /* Next connection in the port hash chain */
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  ttl;           /* Default time-to-live */
   uint8_t  crefs;         /* Reference counts on this instance */
+  bool     reuseport;     /* Bound with SO_REUSEPORT */
 
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Read-ahead buffering.
@@ -44,6 +44,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <semaphore.h>
 #include <assert.h>
@@ -72,6 +73,10 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Bound connections are kept in a hash table keyed by local port number */
+
+#define UDP_HASH(p) (NTOHS(p) % CONFIG_NET_UDP_NHASH)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -89,6 +94,10 @@ static sem_t g_free_sem;
 
 static dq_queue_t g_active_udp_connections;
 
+/* Bound UDP connections, hashed by local port number */
+
+static FAR struct udp_conn_s *g_udp_hash[CONFIG_NET_UDP_NHASH];
+
 /* Last port used by a UDP connection connection. */
 
 static uint16_t g_last_udp_port;
@@ -121,31 +130,104 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 #define _udp_semgive(sem) sem_post(sem)
 
+/****************************************************************************
+ * Name: udp_hash_add and udp_hash_remove
+ *
+ * Description:
+ *   Add a connection to or remove a connection from the local port hash
+ *   table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void udp_hash_add(FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_conn_s **head = &g_udp_hash[UDP_HASH(conn->lport)];
+
+  conn->hnext = *head;
+  *head       = conn;
+}
+
+static void udp_hash_remove(FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_conn_s **curr;
+
+  for (curr = &g_udp_hash[UDP_HASH(conn->lport)];
+       *curr != NULL;
+       curr = &(*curr)->hnext)
+    {
+      if (*curr == conn)
+        {
+          *curr = conn->hnext;
+          break;
+        }
+    }
+
+  conn->hnext = NULL;
+}
+
+/****************************************************************************
+ * Name: udp_set_lport
+ *
+ * Description:
+ *   Change the local port number of a connection, moving it to the
+ *   corresponding hash chain.  A port number of zero leaves the connection
+ *   unbound.
+ *
+ ****************************************************************************/
+
+static void udp_set_lport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  net_lock_t flags = net_lock();
+
+  if (conn->lport != 0)
+    {
+      udp_hash_remove(conn);
+    }
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      udp_hash_add(conn);
+    }
+
+  net_unlock(flags);
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
  * Description:
- *   Find the UDP connection that uses this local port number.  Called only
- *   from user user level code, but with interrupts disabled.
+ *   Find the UDP connection that uses this local port number.  Connections
+ *   that share the port under SO_REUSEPORT are not reported if 'reuseport'
+ *   is true.  Called only from user user level code, but with interrupts
+ *   disabled.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NETDEV_MULTINIC
 static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
-                                            uint16_t portno)
+                                            uint16_t portno, bool reuseport)
 #else
-static FAR struct udp_conn_s *udp_find_conn(uint16_t portno)
+static FAR struct udp_conn_s *udp_find_conn(uint16_t portno, bool reuseport)
 #endif
 {
   FAR struct udp_conn_s *conn;
-  int i;
 
-  /* Now search each connection structure.*/
+  /* Now search each connection structure bound to a port with the same
+   * hash.
+   */
 
-  for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
+  for (conn = g_udp_hash[UDP_HASH(portno)]; conn != NULL; conn = conn->hnext)
     {
-      conn = &g_udp_connections[i];
+      if (conn->lport != portno || (reuseport && conn->reuseport))
+        {
+          continue;
+        }
 
 #ifdef CONFIG_NETDEV_MULTINIC
       /* If the port local port number assigned to the connections matches
@@ -159,9 +241,8 @@ static FAR struct udp_conn_s *udp_find_conn(uint16_t portno)
       if (domain == PF_INET)
 #endif
         {
-          if (conn->lport == portno &&
-              (net_ipv4addr_cmp(conn->u.ipv4.laddr, ipaddr->ipv4.laddr) ||
-               net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY)))
+          if (net_ipv4addr_cmp(conn->u.ipv4.laddr, ipaddr->ipv4.laddr) ||
+              net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY))
             {
               return conn;
             }
@@ -173,9 +254,8 @@ static FAR struct udp_conn_s *udp_find_conn(uint16_t portno)
       else
 #endif
         {
-          if (conn->lport == portno &&
-              (net_ipv6addr_cmp(conn->u.ipv6.laddr, ipaddr->ipv6.laddr) ||
-               net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr)))
+          if (net_ipv6addr_cmp(conn->u.ipv6.laddr, ipaddr->ipv6.laddr) ||
+              net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr))
             {
               return conn;
             }
@@ -187,10 +267,7 @@ static FAR struct udp_conn_s *udp_find_conn(uint16_t portno)
        * then return a reference to the connection structure.
        */
 
-      if (conn->lport == portno)
-        {
-          return conn;
-        }
+      return conn;
 #endif /* CONFIG_NETDEV_MULTINIC */
     }
 
@@ -246,9 +323,9 @@ static uint16_t udp_select_port(void)
         }
     }
 #ifdef CONFIG_NETDEV_MULTINIC
-  while (udp_find_conn(domain, u, htons(g_last_udp_port)));
+  while (udp_find_conn(domain, u, htons(g_last_udp_port), false));
 #else
-  while (udp_find_conn(htons(g_last_udp_port)));
+  while (udp_find_conn(htons(g_last_udp_port), false));
 #endif
 
   /* Initialize and return the connection structure, bind it to the
@@ -261,6 +338,102 @@ static uint16_t udp_select_port(void)
   return portno;
 }
 
+/****************************************************************************
+ * Name: udp_ipv4_match
+ *
+ * Description:
+ *   Return true if the connection is an appropriate recipient of the
+ *   UDP/IPv4 packet in the device buffer.
+ *
+ *   If the local UDP port is non-zero, the connection is considered to be
+ *   used. If so, then the following checks are performed:
+ *
+ *   - The local port number is checked against the destination port
+ *     number in the received packet.
+ *   - The remote port number is checked if the connection is bound
+ *     to a remote port.
+ *   - If multiple network interfaces are supported, then the local
+ *     IP address is available and we will insist that the
+ *     destination IP matches the bound address (or the destination
+ *     IP address is a broadcast address). If a socket is bound to
+ *     INADDRY_ANY (laddr), then it should receive all packets
+ *     directed to the port.
+ *   - Finally, if the connection is bound to a remote IP address,
+ *     the source IP address of the packet is checked. Broadcast
+ *     addresses are also accepted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline bool udp_ipv4_match(FAR struct udp_conn_s *conn,
+                                  FAR struct ipv4_hdr_s *ip,
+                                  FAR struct udp_hdr_s *udp)
+{
+  return (conn->lport != 0 && udp->destport == conn->lport &&
+          (conn->rport == 0 || udp->srcport == conn->rport) &&
+#ifdef CONFIG_NETDEV_MULTINIC
+          (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
+           net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_BROADCAST) ||
+           net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr)) &&
+#endif
+          (net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY) ||
+           net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_BROADCAST) ||
+           net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)));
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Name: udp_ipv6_match
+ *
+ * Description:
+ *   Return true if the connection is an appropriate recipient of the
+ *   UDP/IPv6 packet in the device buffer.  The checks are the same as for
+ *   udp_ipv4_match().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline bool udp_ipv6_match(FAR struct udp_conn_s *conn,
+                                  FAR struct ipv6_hdr_s *ip,
+                                  FAR struct udp_hdr_s *udp)
+{
+  return (conn->lport != 0 && udp->destport == conn->lport &&
+          (conn->rport == 0 || udp->srcport == conn->rport) &&
+#ifdef CONFIG_NETDEV_MULTINIC
+          (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr) ||
+           net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_alloneaddr) ||
+           net_ipv6addr_hdrcmp(ip->destipaddr, conn->u.ipv6.laddr)) &&
+#endif
+          (net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_allzeroaddr) ||
+           net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_alloneaddr) ||
+           net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)));
+}
+#endif /* CONFIG_NET_IPv6 */
+
+/****************************************************************************
+ * Name: udp_flowhash
+ *
+ * Description:
+ *   Hash the source address and port of a received packet.  This is used
+ *   to spread the traffic to a port over the sockets that share it with
+ *   SO_REUSEPORT while keeping the packets of each flow on one socket.
+ *
+ ****************************************************************************/
+
+static unsigned int udp_flowhash(FAR const uint16_t *srcipaddr, int nwords,
+                                 uint16_t srcport)
+{
+  unsigned int hash = srcport;
+  int i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash = (hash * 31) + srcipaddr[i];
+    }
+
+  return hash ^ (hash >> 16);
+}
+
 /****************************************************************************
  * Name: udp_ipv4_active
  *
@@ -278,51 +451,41 @@ static inline FAR struct udp_conn_s *
   udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
+  FAR struct udp_conn_s *head = g_udp_hash[UDP_HASH(udp->destport)];
   FAR struct udp_conn_s *conn;
+  unsigned int nmatch = 0;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn)
+  for (conn = head; conn != NULL; conn = conn->hnext)
     {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, then the following checks are performed:
-       *
-       * - The local port number is checked against the destination port
-       *   number in the received packet.
-       * - The remote port number is checked if the connection is bound
-       *   to a remote port.
-       * - If multiple network interfaces are supported, then the local
-       *   IP address is available and we will insist that the
-       *   destination IP matches the bound address (or the destination
-       *   IP address is a broadcast address). If a socket is bound to
-       *   INADDRY_ANY (laddr), then it should receive all packets
-       *   directed to the port.
-       * - Finally, if the connection is bound to a remote IP address,
-       *   the source IP address of the packet is checked. Broadcast
-       *   addresses are also accepted.
-       *
-       * If all of the above are true then the newly received UDP packet
-       * is destined for this UDP connection.
-       */
-
-      if (conn->lport != 0 && udp->destport == conn->lport &&
-          (conn->rport == 0 || udp->srcport == conn->rport) &&
-#ifdef CONFIG_NETDEV_MULTINIC
-          (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
-           net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_BROADCAST) ||
-           net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr)) &&
-#endif
-          (net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY) ||
-           net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_BROADCAST) ||
-           net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
+      if (udp_ipv4_match(conn, ip, udp))
         {
-          /* Matching connection found.. return a reference to it */
+          /* Matching connection found.. return a reference to it unless
+           * the port is shared by other connections.
+           */
 
-          break;
+          if (!conn->reuseport)
+            {
+              return conn;
+            }
+
+          nmatch++;
         }
+    }
+
+  if (nmatch == 0)
+    {
+      return NULL;
+    }
 
-      /* Look at the next active connection */
+  /* Select one of the connections that share the port */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+  nmatch = udp_flowhash(ip->srcipaddr, 2, udp->srcport) % nmatch;
+  for (conn = head; conn != NULL; conn = conn->hnext)
+    {
+      if (udp_ipv4_match(conn, ip, udp) && nmatch-- == 0)
+        {
+          break;
+        }
     }
 
   return conn;
@@ -346,51 +509,41 @@ static inline FAR struct udp_conn_s *
   udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  FAR struct udp_conn_s *head = g_udp_hash[UDP_HASH(udp->destport)];
   FAR struct udp_conn_s *conn;
+  unsigned int nmatch = 0;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn)
+  for (conn = head; conn != NULL; conn = conn->hnext)
     {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, then the following checks are performed:
-       *
-       * - The local port number is checked against the destination port
-       *   number in the received packet.
-       * - The remote port number is checked if the connection is bound
-       *   to a remote port.
-       * - If multiple network interfaces are supported, then the local
-       *   IP address is available and we will insist that the
-       *   destination IP matches the bound address (or the destination
-       *   IP address is a broadcast address). If a socket is bound to
-       *   INADDRY_ANY (laddr), then it should receive all packets
-       *   directed to the port.
-       * - Finally, if the connection is bound to a remote IP address,
-       *   the source IP address of the packet is checked. Broadcast
-       *   addresses are also accepted.
-       *
-       * If all of the above are true then the newly received UDP packet
-       * is destined for this UDP connection.
-       */
-
-      if (conn->lport != 0 && udp->destport == conn->lport &&
-          (conn->rport == 0 || udp->srcport == conn->rport) &&
-#ifdef CONFIG_NETDEV_MULTINIC
-          (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr) ||
-           net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_alloneaddr) ||
-           net_ipv6addr_hdrcmp(ip->destipaddr, conn->u.ipv6.laddr)) &&
-#endif
-          (net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_allzeroaddr) ||
-           net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_alloneaddr) ||
-           net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
+      if (udp_ipv6_match(conn, ip, udp))
         {
-          /* Matching connection found.. return a reference to it */
+          /* Matching connection found.. return a reference to it unless
+           * the port is shared by other connections.
+           */
 
-          break;
+          if (!conn->reuseport)
+            {
+              return conn;
+            }
+
+          nmatch++;
         }
+    }
 
-      /* Look at the next active connection */
+  if (nmatch == 0)
+    {
+      return NULL;
+    }
+
+  /* Select one of the connections that share the port */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+  nmatch = udp_flowhash(ip->srcipaddr, 8, udp->srcport) % nmatch;
+  for (conn = head; conn != NULL; conn = conn->hnext)
+    {
+      if (udp_ipv6_match(conn, ip, udp) && nmatch-- == 0)
+        {
+          break;
+        }
     }
 
   return conn;
@@ -425,9 +578,11 @@ void udp_initialize(void)
       /* Mark the connection closed and move it to the free list */
 
       g_udp_connections[i].lport = 0;
+      g_udp_connections[i].hnext = NULL;
       dq_addlast(&g_udp_connections[i].node, &g_free_udp_connections);
     }
 
+  memset(g_udp_hash, 0, sizeof(g_udp_hash));
   g_last_udp_port = 1024;
 }
 
@@ -457,7 +612,8 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain = domain;
 #endif
-      conn->lport  = 0;
+      conn->lport     = 0;
+      conn->reuseport = false;
 
       /* Enqueue the connection into the active list */
 
@@ -486,7 +642,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+  udp_set_lport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -632,12 +788,14 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
+      flags = net_lock();
 #ifdef CONFIG_NETDEV_MULTINIC
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_set_lport(conn, htons(udp_select_port(conn->domain, &conn->u)));
 #else
-      conn->lport = htons(udp_select_port());
+      udp_set_lport(conn, htons(udp_select_port()));
 #endif
-      ret         = OK;
+      net_unlock(flags);
+      ret = OK;
     }
   else
     {
@@ -645,18 +803,24 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
       flags = net_lock();
 
-      /* Is any other UDP connection already bound to this address and port? */
+      /* Is any other UDP connection already bound to this address and
+       * port?  Sockets that all set SO_REUSEPORT may share the port.
+       */
 
 #ifdef CONFIG_NETDEV_MULTINIC
-      if (!udp_find_conn(conn->domain, &conn->u, portno))
+      if (!udp_find_conn(conn->domain, &conn->u, portno, conn->reuseport))
 #else
-      if (!udp_find_conn(portno))
+      if (!udp_find_conn(portno, conn->reuseport))
 #endif
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
-          ret         = OK;
+          udp_set_lport(conn, portno);
+          ret = OK;
+        }
+      else
+        {
+          ret = -EADDRINUSE;
         }
 
       net_unlock(flags);
@@ -702,11 +866,13 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
+      net_lock_t flags = net_lock();
 #ifdef CONFIG_NETDEV_MULTINIC
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_set_lport(conn, htons(udp_select_port(conn->domain, &conn->u)));
 #else
-      conn->lport = htons(udp_select_port());
+      udp_set_lport(conn, htons(udp_select_port()));
 #endif
+      net_unlock(flags);
     }
 
   /* Is there a remote port (rport)? */
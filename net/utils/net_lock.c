@@ -33,6 +33,7 @@
  *
  ****************************************************************************/
 
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
@@ -40,6 +41,7 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <sched.h>
 #include <semaphore.h>
 #include <assert.h>
 #include <errno.h>
@@ -62,9 +64,18 @@
  * Private Data
  ****************************************************************************/
 
-static sem_t        g_netlock;
-static pid_t        g_holder  = NO_HOLDER;
-static unsigned int g_count   = 0;
+/* The stack lock.  This is the one global lock that protects all sockets,
+ * connections, and protocol state.  Only the work of network drivers is
+ * moved out from under it, by the per-device locks.
+ */
+
+static struct net_mutex_s g_netlock;
+
+#ifdef CONFIG_NET_LOCK_DEBUG
+/* The list of all initialized network locks */
+
+static FAR struct net_mutex_s *g_netmutexes;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -78,9 +89,9 @@ static unsigned int g_count   = 0;
  *
  ****************************************************************************/
 
-static void _net_takesem(void)
+static void _net_takesem(FAR struct net_mutex_s *mutex)
 {
-  while (sem_wait(&g_netlock) != 0)
+  while (sem_wait(&mutex->nm_sem) != 0)
     {
       /* The only case that an error should occur here is if the wait was
        * awakened by a signal.
@@ -90,6 +101,41 @@ static void _net_takesem(void)
     }
 }
 
+/****************************************************************************
+ * Function: net_lockcheck
+ *
+ * Description:
+ *   Verify that the calling thread holds no network lock with a level
+ *   greater than or equal to 'level', other than 'mutex' itself.  Locks
+ *   must be taken in the order of increasing level; taking them in any
+ *   other order could deadlock with a thread that follows the rule.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_DEBUG
+static void net_lockcheck(FAR struct net_mutex_s *mutex, int level,
+                          pid_t me)
+{
+  FAR struct net_mutex_s *held;
+
+  sched_lock();
+  for (held = g_netmutexes; held; held = held->nm_flink)
+    {
+      if (held != mutex && held->nm_holder == me &&
+          held->nm_level >= level)
+        {
+          nlldbg("ERROR: pid %d takes a level %d lock holding level %d\n",
+                 me, level, held->nm_level);
+          PANIC();
+        }
+    }
+
+  sched_unlock();
+}
+#else
+#  define net_lockcheck(m,l,p)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -104,74 +150,159 @@ static void _net_takesem(void)
 
 void net_lockinitialize(void)
 {
-  sem_init(&g_netlock, 0, 1);
+  net_mutex_initialize(&g_netlock, NET_LOCKLEVEL_STACK);
 }
 
 /****************************************************************************
- * Function: net_lock
+ * Function: net_mutex_initialize
  *
  * Description:
- *   Take the lock
+ *   Initialize a re-entrant network lock.
+ *
+ * Input Parameters:
+ *   mutex - The lock to be initialized
+ *   level - The level of the lock (NET_LOCKLEVEL_*)
  *
  ****************************************************************************/
 
-net_lock_t net_lock(void)
+void net_mutex_initialize(FAR struct net_mutex_s *mutex, int level)
+{
+  sem_init(&mutex->nm_sem, 0, 1);
+  mutex->nm_holder = NO_HOLDER;
+  mutex->nm_count  = 0;
+
+#ifdef CONFIG_NET_LOCK_DEBUG
+  mutex->nm_level  = level;
+
+  sched_lock();
+  mutex->nm_flink  = g_netmutexes;
+  g_netmutexes     = mutex;
+  sched_unlock();
+#endif
+}
+
+/****************************************************************************
+ * Function: net_mutex_destroy
+ *
+ * Description:
+ *   Release the resources of a network lock that is not held.
+ *
+ ****************************************************************************/
+
+void net_mutex_destroy(FAR struct net_mutex_s *mutex)
+{
+#ifdef CONFIG_NET_LOCK_DEBUG
+  FAR struct net_mutex_s **pprev;
+
+  sched_lock();
+  for (pprev = &g_netmutexes; *pprev; pprev = &(*pprev)->nm_flink)
+    {
+      if (*pprev == mutex)
+        {
+          *pprev = mutex->nm_flink;
+          break;
+        }
+    }
+
+  sched_unlock();
+#endif
+
+  DEBUGASSERT(mutex->nm_holder == NO_HOLDER);
+  sem_destroy(&mutex->nm_sem);
+}
+
+/****************************************************************************
+ * Function: net_mutex_lock
+ *
+ * Description:
+ *   Take a network lock.  The lock is re-entrant.
+ *
+ ****************************************************************************/
+
+net_lock_t net_mutex_lock(FAR struct net_mutex_s *mutex)
 {
   pid_t me = getpid();
 
   /* Does this thread already hold the semaphore? */
 
-  if (g_holder == me)
+  if (mutex->nm_holder == me)
     {
       /* Yes.. just increment the reference count */
 
-      g_count++;
+      mutex->nm_count++;
     }
   else
     {
       /* No.. take the semaphore (perhaps waiting) */
 
-      _net_takesem();
+      net_lockcheck(mutex, mutex->nm_level, me);
+      _net_takesem(mutex);
 
       /* Now this thread holds the semaphore */
 
-      g_holder = me;
-      g_count  = 1;
+      mutex->nm_holder = me;
+      mutex->nm_count  = 1;
     }
 
   return 0;
 }
 
 /****************************************************************************
- * Function: net_unlock
+ * Function: net_mutex_unlock
  *
  * Description:
- *   Release the lock.
+ *   Release a network lock.
  *
  ****************************************************************************/
 
-void net_unlock(net_lock_t flags)
+void net_mutex_unlock(FAR struct net_mutex_s *mutex)
 {
-  DEBUGASSERT(g_holder == getpid() && g_count > 0);
+  DEBUGASSERT(mutex->nm_holder == getpid() && mutex->nm_count > 0);
 
   /* If the count would go to zero, then release the semaphore */
 
-  if (g_count == 1)
+  if (mutex->nm_count == 1)
     {
       /* We no longer hold the semaphore */
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      sem_post(&g_netlock);
+      mutex->nm_holder = NO_HOLDER;
+      mutex->nm_count  = 0;
+      sem_post(&mutex->nm_sem);
     }
   else
     {
       /* We still hold the semaphore. Just decrement the count */
 
-      g_count--;
+      mutex->nm_count--;
     }
 }
 
+/****************************************************************************
+ * Function: net_lock
+ *
+ * Description:
+ *   Take the stack lock
+ *
+ ****************************************************************************/
+
+net_lock_t net_lock(void)
+{
+  return net_mutex_lock(&g_netlock);
+}
+
+/****************************************************************************
+ * Function: net_unlock
+ *
+ * Description:
+ *   Release the stack lock.
+ *
+ ****************************************************************************/
+
+void net_unlock(net_lock_t flags)
+{
+  net_mutex_unlock(&g_netlock);
+}
+
 /****************************************************************************
  * Function: net_timedwait
  *
@@ -197,16 +328,20 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
   irqstate_t   flags;
   int          ret;
 
+  /* Sleeping while holding a device lock would stall the device */
+
+  net_lockcheck(&g_netlock, NET_LOCKLEVEL_DEVICE, me);
+
   flags = irqsave(); /* No interrupts */
   sched_lock();      /* No context switches */
-  if (g_holder == me)
+  if (g_netlock.nm_holder == me)
     {
       /* Release the network lock, remembering my count */
 
-      count    = g_count;
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      sem_post(&g_netlock);
+      count               = g_netlock.nm_count;
+      g_netlock.nm_holder = NO_HOLDER;
+      g_netlock.nm_count  = 0;
+      sem_post(&g_netlock.nm_sem);
 
       /* Now take the semaphore, waiting if so requested. */
 
@@ -225,9 +360,9 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
       /* Recover the network lock at the proper count */
 
-      _net_takesem();
-      g_holder = me;
-      g_count  = count;
+      _net_takesem(&g_netlock);
+      g_netlock.nm_holder = me;
+      g_netlock.nm_count  = count;
     }
   else
     {
@@ -321,6 +321,10 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(sendto,                  6, STUB_sendto)
   SYSCALL_LOOKUP(setsockopt,              5, STUB_setsockopt)
   SYSCALL_LOOKUP(socket,                  3, STUB_socket)
+  SYSCALL_LOOKUP(recvmmsg,                5, STUB_recvmmsg)
+  SYSCALL_LOOKUP(sendmmsg,                4, STUB_sendmmsg)
+  SYSCALL_LOOKUP(recvmsg,                 3, STUB_recvmsg)
+  SYSCALL_LOOKUP(sendmsg,                 3, STUB_sendmsg)
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
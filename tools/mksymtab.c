@@ -53,10 +53,29 @@
 #define MAX_HEADER_FILES 500
 #define SYMTAB_NAME      "g_symtab"
 
+/* These must agree with include/nuttx/binfmt/symtab.h */
+
+#define SYMTAB_HASH_BASIS 2166136261u
+#define SYMTAB_HASH_PRIME 16777619u
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+enum symtab_order_e
+{
+  ORDER_NONE = 0,  /* Keep the order of the CSV file */
+  ORDER_NAME,      /* Order by name (CONFIG_SYMTAB_ORDEREDBYNAME) */
+  ORDER_HASH       /* Order by hash (CONFIG_SYMTAB_HASHED) */
+};
+
+struct symbol_s
+{
+  char *name;        /* Symbol name */
+  char *cond;        /* Conditional compilation expression (or NULL) */
+  unsigned int hash; /* Hash of the symbol name */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -64,20 +83,83 @@
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
 
+static struct symbol_s *g_symbols;
+static int nsymbols;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 static void show_usage(const char *progname)
 {
-  fprintf(stderr, "USAGE: %s <cvs-file> <symtab-file>\n\n", progname);
+  fprintf(stderr, "USAGE: %s [-d] [-s|-h] <cvs-file> <symtab-file>\n\n", progname);
   fprintf(stderr, "Where:\n\n");
   fprintf(stderr, "  <cvs-file>   : The path to the input CSV file\n");
   fprintf(stderr, "  <symtab-file>: The path to the output symbol table file\n");
   fprintf(stderr, "  -d           : Enable debug output\n");
+  fprintf(stderr, "  -s           : Order the symbol table by name\n");
+  fprintf(stderr, "                 (for CONFIG_SYMTAB_ORDEREDBYNAME)\n");
+  fprintf(stderr, "  -h           : Add name hashes and order the symbol table by hash\n");
+  fprintf(stderr, "                 (for CONFIG_SYMTAB_HASHED)\n");
   exit(EXIT_FAILURE);
 }
 
+static unsigned int symbol_hash(const char *name)
+{
+  unsigned int hash = SYMTAB_HASH_BASIS;
+
+  while (*name != '\0')
+    {
+      hash ^= (unsigned char)*name++;
+      hash  = (hash * SYMTAB_HASH_PRIME) & 0xffffffff;
+    }
+
+  return hash;
+}
+
+static int compare_name(const void *a, const void *b)
+{
+  const struct symbol_s *sa = (const struct symbol_s *)a;
+  const struct symbol_s *sb = (const struct symbol_s *)b;
+
+  return strcmp(sa->name, sb->name);
+}
+
+static int compare_hash(const void *a, const void *b)
+{
+  const struct symbol_s *sa = (const struct symbol_s *)a;
+  const struct symbol_s *sb = (const struct symbol_s *)b;
+
+  if (sa->hash < sb->hash)
+    {
+      return -1;
+    }
+  else if (sa->hash > sb->hash)
+    {
+      return 1;
+    }
+
+  return strcmp(sa->name, sb->name);
+}
+
+static void add_symbol(const char *name, const char *cond)
+{
+  struct symbol_s *sym;
+
+  g_symbols = realloc(g_symbols, (nsymbols + 1) * sizeof(struct symbol_s));
+  if (!g_symbols)
+    {
+      fprintf(stderr, "ERROR:  Failed to allocate symbol table\n");
+      exit(EXIT_FAILURE);
+    }
+
+  sym       = &g_symbols[nsymbols];
+  sym->name = strdup(name);
+  sym->cond = (cond && strlen(cond) > 0) ? strdup(cond) : NULL;
+  sym->hash = symbol_hash(name);
+  nsymbols++;
+}
+
 static bool check_hdrfile(const char *hdrfile)
 {
   int i;
@@ -125,14 +207,16 @@ int main(int argc, char **argv, char **envp)
   bool cond;
   FILE *instream;
   FILE *outstream;
+  enum symtab_order_e order;
   int ch;
   int i;
 
   /* Parse command line options */
 
   g_debug = false;
+  order   = ORDER_NONE;
 
-  while ((ch = getopt(argc, argv, ":d")) > 0)
+  while ((ch = getopt(argc, argv, ":dsh")) > 0)
     {
       switch (ch)
         {
@@ -140,6 +224,14 @@ int main(int argc, char **argv, char **envp)
             g_debug = true;
             break;
 
+          case 's' :
+            order = ORDER_NAME;
+            break;
+
+          case 'h' :
+            order = ORDER_HASH;
+            break;
+
           case '?' :
             fprintf(stderr, "Unrecognized option: %c\n", optopt);
             show_usage(argv[0]);
@@ -212,11 +304,25 @@ int main(int argc, char **argv, char **envp)
       /* Add the header file to the list of header files we need to include */
 
       add_hdrfile(g_parm[HEADER_INDEX]);
+
+      /* And add the symbol to the list of symbols */
+
+      add_symbol(g_parm[NAME_INDEX], g_parm[COND_INDEX]);
     }
 
-  /* Back to the beginning */
+  /* Put the symbols in the requested order.  Each entry carries its own
+   * conditional compilation so the order of the entries does not matter
+   * to the preprocessor.
+   */
 
-  rewind(instream);
+  if (order == ORDER_NAME)
+    {
+      qsort(g_symbols, nsymbols, sizeof(struct symbol_s), compare_name);
+    }
+  else if (order == ORDER_HASH)
+    {
+      qsort(g_symbols, nsymbols, sizeof(struct symbol_s), compare_hash);
+    }
 
   /* Output up-front file boilerplate */
 
@@ -225,6 +331,21 @@ int main(int argc, char **argv, char **envp)
   fprintf(outstream, "#include <nuttx/compiler.h>\n");
   fprintf(outstream, "#include <nuttx/binfmt/symtab.h>\n\n");
 
+  if (order == ORDER_NAME)
+    {
+      fprintf(outstream, "#ifndef CONFIG_SYMTAB_ORDEREDBYNAME\n");
+      fprintf(outstream, "#  warning This symbol table is ordered by name "
+                         "but CONFIG_SYMTAB_ORDEREDBYNAME is not set\n");
+      fprintf(outstream, "#endif\n\n");
+    }
+  else if (order == ORDER_HASH)
+    {
+      fprintf(outstream, "#ifndef CONFIG_SYMTAB_HASHED\n");
+      fprintf(outstream, "#  error This symbol table requires "
+                         "CONFIG_SYMTAB_HASHED\n");
+      fprintf(outstream, "#endif\n\n");
+    }
+
   /* Output all of the require header files */
 
   for (i = 0; i < nhdrfiles; i++)
@@ -237,35 +358,35 @@ int main(int argc, char **argv, char **envp)
   fprintf(outstream, "\nconst struct symtab_s %s[] =\n", SYMTAB_NAME);
   fprintf(outstream, "{\n");
 
-  /* Parse each line in the CVS file */
+  /* Output each symbol */
 
   nextterm  = "";
   finalterm = "";
 
-  while ((ptr = read_line(instream)) != NULL)
+  for (i = 0; i < nsymbols; i++)
     {
-      /* Parse the line from the CVS file */
-
-      int nargs = parse_csvline(ptr);
-      if (nargs < PARM1_INDEX)
-        {
-          fprintf(stderr, "Only %d arguments found: %s\n", nargs, g_line);
-          exit(EXIT_FAILURE);
-        }
-
       /* Output any conditional compilation */
 
-      cond = (g_parm[COND_INDEX] && strlen(g_parm[COND_INDEX]) > 0);
+      cond = (g_symbols[i].cond != NULL);
       if (cond)
         {
-          fprintf(outstream, "%s#if %s\n", nextterm, g_parm[COND_INDEX]);
+          fprintf(outstream, "%s#if %s\n", nextterm, g_symbols[i].cond);
           nextterm  = "";
         }
 
       /* Output the symbol table entry */
 
-      fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s }",
-              nextterm, g_parm[NAME_INDEX], g_parm[NAME_INDEX]);
+      if (order == ORDER_HASH)
+        {
+          fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s, 0x%08xu }",
+                  nextterm, g_symbols[i].name, g_symbols[i].name,
+                  g_symbols[i].hash);
+        }
+      else
+        {
+          fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s }",
+                  nextterm, g_symbols[i].name, g_symbols[i].name);
+        }
 
       if (cond)
         {